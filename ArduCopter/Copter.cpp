@@ -224,11 +224,18 @@ void Copter::fast_loop()
     // update INS immediately to get current gyro data populated
     ins.update();
 
-    // run low level rate controllers that only require IMU data
-    attitude_control->rate_controller_run();
+    const bool rate_thread_running = using_rate_thread();
+    if (!rate_thread_running) {
+#if RATE_THREAD_ENABLED == ENABLED
+        WITH_SEMAPHORE(rate_controller_sem);
+#endif
+        // run low level rate controllers that only require IMU data
+        attitude_control->rate_controller_run();
 
-    // send outputs to the motors library immediately
-    motors_output();
+        // send outputs to the motors library immediately
+        motors_output();
+        scheduler.output_sent();
+    }
 
     // run EKF state estimator (expensive)
     // --------------------
@@ -251,6 +258,13 @@ void Copter::fast_loop()
     // run the attitude controllers
     update_flight_mode();
 
+#if RATE_THREAD_ENABLED == ENABLED
+    if (rate_thread_running) {
+        // hand the new rate targets to the rate thread
+        attitude_control->rate_controller_target_publish();
+    }
+#endif
+
     // update home from EKF if necessary
     update_home_from_EKF();
 
@@ -252,6 +252,7 @@ private:
         bool alt_healthy:1; // true if we can trust the altitude from the rangefinder
         int16_t alt_cm;     // tilt compensated altitude (in cm) from rangefinder
         float inertial_alt_cm; // inertial alt at time of last rangefinder sample
+        uint32_t last_reading_ms; // system time of last rangefinder sample used
         uint32_t last_healthy_ms;
         LowPassFilterFloat alt_cm_filt; // altitude filter
         int16_t alt_cm_glitch_protected;    // last glitch protected altitude
@@ -575,6 +576,15 @@ private:
 
     bool standby_active;
 
+#if RATE_THREAD_ENABLED == ENABLED
+    // set by the rate thread while it is running the rate controller
+    // and motor output from gyro samples
+    volatile bool rate_thread_active;
+    // held while running the rate controller and motor output, so the
+    // main loop and the rate thread don't overlap while handing over
+    HAL_Semaphore rate_controller_sem;
+#endif
+
     static const AP_Scheduler::Task scheduler_tasks[];
     static const AP_Param::Info var_info[];
     static const struct LogStructure log_structure[];
@@ -838,6 +848,11 @@ private:
     void init_precland();
     void update_precland();
 
+    // rate_thread.cpp
+    void rate_thread_init();
+    void rate_thread();
+    bool using_rate_thread() const;
+
     // radio.cpp
     void default_dead_zones();
     void init_rc_in();
@@ -553,6 +553,7 @@ void Copter::Log_Write_Vehicle_Startup_Messages()
     logger.Write_Mode((uint8_t)flightmode->mode_number(), control_mode_reason);
     ahrs.Log_Write_Home_And_Origin();
     gps.Write_AP_Logger_Log_Startup_messages();
+    write_boot_log_messages();
 }
 
 void Copter::log_init(void)
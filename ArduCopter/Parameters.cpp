@@ -1069,6 +1069,25 @@ const AP_Param::GroupInfo ParametersG2::var_info[] = {
     AP_GROUPINFO("RNGFND_FILT", 45, ParametersG2, rangefinder_filt, RANGEFINDER_FILT_DEFAULT),
 #endif
 
+#if RATE_THREAD_ENABLED == ENABLED
+    // @Param: FSTRATE_ENABLE
+    // @DisplayName: Enable the rate thread
+    // @Description: Enable running the rate controller and motor output in their own thread, woken by each gyro sample, instead of in the main loop. Attitude and position control stay on the main loop
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("FSTRATE_ENABLE", 46, ParametersG2, fstrate_enable, 0),
+
+    // @Param: FSTRATE_MAX
+    // @DisplayName: Maximum rate thread rate
+    // @Description: Maximum rate at which the rate thread runs. Gyro samples are decimated to no more than this rate
+    // @Units: Hz
+    // @Range: 400 4000
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("FSTRATE_MAX", 47, ParametersG2, fstrate_max, 1000),
+#endif
+
     AP_GROUPEND
 };
 
@@ -649,6 +649,11 @@ public:
     AP_Float rangefinder_filt;
 #endif
 
+#if RATE_THREAD_ENABLED == ENABLED
+    AP_Int8 fstrate_enable;
+    AP_Int16 fstrate_max;
+#endif
+
 };
 
 extern const AP_Param::Info        var_info[];
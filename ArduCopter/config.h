@@ -338,6 +338,12 @@
 # define MODE_ZIGZAG_ENABLED !HAL_MINIMIZE_FEATURES
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+// Rate thread - run the rate controller and motor output on every gyro sample
+#ifndef RATE_THREAD_ENABLED
+# define RATE_THREAD_ENABLED (AP_INERTIALSENSOR_RATE_LOOP_ENABLED && FRAME_CONFIG != HELI_FRAME)
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 
 //////////////////////////////////////////////////////////////////////////////
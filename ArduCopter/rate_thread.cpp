@@ -0,0 +1,64 @@
+#include "Copter.h"
+
+/*
+  optional thread running the rate controller and motor output on
+  every gyro sample. Attitude and position control stay on the main
+  loop, which publishes new rate targets after each update. If gyro
+  samples stop arriving the main loop takes the rate controller back.
+ */
+
+#if RATE_THREAD_ENABLED == ENABLED
+
+// start the rate thread if enabled, should be called once during init
+void Copter::rate_thread_init()
+{
+    if (g2.fstrate_enable == 0) {
+        return;
+    }
+    if (!ins.enable_rate_loop_samples(g2.fstrate_max)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Rate thread: no gyro samples");
+        return;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Copter::rate_thread, void),
+                                      "rate", 2048, AP_HAL::Scheduler::PRIORITY_BOOST, 1)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Rate thread: failed to start");
+    }
+}
+
+void Copter::rate_thread()
+{
+    const float dt = ins.get_rate_loop_dt();
+    // give the rate controller back to the main loop if we miss two of its loops worth of samples
+    const uint32_t timeout_us = 2 * scheduler.get_loop_period_us();
+
+    while (true) {
+        Vector3f gyro;
+        if (!ins.get_next_rate_loop_sample(gyro, timeout_us)) {
+            rate_thread_active = false;
+            continue;
+        }
+
+        // correct for gyro drift as in get_gyro_latest(). Copter's
+        // view of the AHRS is not rotated
+        gyro += ahrs.get_gyro_drift();
+
+        WITH_SEMAPHORE(rate_controller_sem);
+        rate_thread_active = true;
+        attitude_control->rate_controller_run_dt(gyro, dt);
+        motors_output();
+    }
+}
+
+// true when the main loop should leave the rate controller and motor output to the rate thread
+bool Copter::using_rate_thread() const
+{
+    return rate_thread_active;
+}
+
+#else
+
+void Copter::rate_thread_init() {}
+void Copter::rate_thread() {}
+bool Copter::using_rate_thread() const { return false; }
+
+#endif // RATE_THREAD_ENABLED
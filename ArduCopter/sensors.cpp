@@ -51,41 +51,52 @@ void Copter::read_rangefinder(void)
         rf_state.alt_healthy = ((rangefinder.status_orient(rf_orient) == RangeFinder::Status::Good) &&
                                 (rangefinder.range_valid_count_orient(rf_orient) >= RANGEFINDER_HEALTH_MAX));
 
-        // tilt corrected but unfiltered, not glitch protected alt
-        rf_state.alt_cm = tilt_correction * rangefinder.distance_cm_orient(rf_orient);
-
-        // remember inertial alt to allow us to interpolate rangefinder
-        rf_state.inertial_alt_cm = inertial_nav.get_altitude();
-
-        // glitch handling.  rangefinder readings more than RANGEFINDER_GLITCH_ALT_CM from the last good reading
-        // are considered a glitch and glitch_count becomes non-zero
-        // glitches clear after RANGEFINDER_GLITCH_NUM_SAMPLES samples in a row.
-        // glitch_cleared_ms is set so surface tracking (or other consumers) can trigger a target reset
-        const int32_t glitch_cm = rf_state.alt_cm - rf_state.alt_cm_glitch_protected;
-        if (glitch_cm >= RANGEFINDER_GLITCH_ALT_CM) {
-            rf_state.glitch_count = MAX(rf_state.glitch_count+1, 1);
-        } else if (glitch_cm <= -RANGEFINDER_GLITCH_ALT_CM) {
-            rf_state.glitch_count = MIN(rf_state.glitch_count-1, -1);
-        } else {
-            rf_state.glitch_count = 0;
-            rf_state.alt_cm_glitch_protected = rf_state.alt_cm;
-        }
-        if (abs(rf_state.glitch_count) >= RANGEFINDER_GLITCH_NUM_SAMPLES) {
-            // clear glitch and record time so consumers (i.e. surface tracking) can reset their target altitudes
-            rf_state.glitch_count = 0;
-            rf_state.alt_cm_glitch_protected = rf_state.alt_cm;
-            rf_state.glitch_cleared_ms = AP_HAL::millis();
+        // only use each reading once, so the glitch counts and the
+        // filter see samples rather than calls to this function
+        uint32_t now = AP_HAL::millis();
+        const uint32_t reading_ms = rangefinder.last_reading_ms(rf_orient);
+        const bool new_reading = reading_ms != rf_state.last_reading_ms;
+        const float reading_dt = (reading_ms - rf_state.last_reading_ms) * 0.001f;
+        rf_state.last_reading_ms = reading_ms;
+        if (new_reading) {
+            // tilt corrected but unfiltered, not glitch protected alt
+            rf_state.alt_cm = tilt_correction * rangefinder.distance_cm_orient(rf_orient);
+
+            // remember inertial alt at the time of the reading to allow us
+            // to interpolate rangefinder, taking off the climb since then so
+            // the time the reading took to arrive is compensated for
+            const float reading_age_s = MIN(now - reading_ms, (uint32_t)RANGEFINDER_TIMEOUT_MS) * 0.001f;
+            rf_state.inertial_alt_cm = inertial_nav.get_altitude() - inertial_nav.get_velocity_z() * reading_age_s;
+
+            // glitch handling.  rangefinder readings more than RANGEFINDER_GLITCH_ALT_CM from the last good reading
+            // are considered a glitch and glitch_count becomes non-zero
+            // glitches clear after RANGEFINDER_GLITCH_NUM_SAMPLES samples in a row.
+            // glitch_cleared_ms is set so surface tracking (or other consumers) can trigger a target reset
+            const int32_t glitch_cm = rf_state.alt_cm - rf_state.alt_cm_glitch_protected;
+            if (glitch_cm >= RANGEFINDER_GLITCH_ALT_CM) {
+                rf_state.glitch_count = MAX(rf_state.glitch_count+1, 1);
+            } else if (glitch_cm <= -RANGEFINDER_GLITCH_ALT_CM) {
+                rf_state.glitch_count = MIN(rf_state.glitch_count-1, -1);
+            } else {
+                rf_state.glitch_count = 0;
+                rf_state.alt_cm_glitch_protected = rf_state.alt_cm;
+            }
+            if (abs(rf_state.glitch_count) >= RANGEFINDER_GLITCH_NUM_SAMPLES) {
+                // clear glitch and record time so consumers (i.e. surface tracking) can reset their target altitudes
+                rf_state.glitch_count = 0;
+                rf_state.alt_cm_glitch_protected = rf_state.alt_cm;
+                rf_state.glitch_cleared_ms = AP_HAL::millis();
+            }
         }
 
-        // filter rangefinder altitude
-        uint32_t now = AP_HAL::millis();
+        // filter rangefinder altitude over the time between readings
         const bool timed_out = now - rf_state.last_healthy_ms > RANGEFINDER_TIMEOUT_MS;
         if (rf_state.alt_healthy) {
             if (timed_out) {
                 // reset filter if we haven't used it within the last second
                 rf_state.alt_cm_filt.reset(rf_state.alt_cm);
-            } else {
-                rf_state.alt_cm_filt.apply(rf_state.alt_cm, 0.05f);
+            } else if (new_reading) {
+                rf_state.alt_cm_filt.apply(rf_state.alt_cm, constrain_float(reading_dt, 0.0f, 0.5f));
             }
             rf_state.last_healthy_ms = now;
         }
@@ -20,6 +20,11 @@ float Copter::SurfaceTracking::adjust_climb_rate(float target_rate)
     RangeFinderState &rf_state = (surface == Surface::GROUND) ? copter.rangefinder_state : copter.rangefinder_up_state;
     const float dir = (surface == Surface::GROUND) ? 1.0f : -1.0f;
 
+    // bring the rangefinder distance forward from the time of the reading
+    // using the inertial climb since then, so it doesn't step at the
+    // rangefinder rate and its delay is compensated for
+    const float rf_dist_cm = rf_state.alt_cm + dir * (copter.inertial_nav.get_altitude() - rf_state.inertial_alt_cm);
+
     // reset target altitude if this controller has just been engaged
     // target has been changed between upwards vs downwards
     // or glitch has cleared
@@ -27,7 +32,7 @@ float Copter::SurfaceTracking::adjust_climb_rate(float target_rate)
     if ((now - last_update_ms > SURFACE_TRACKING_TIMEOUT_MS) ||
         reset_target ||
         (last_glitch_cleared_ms != rf_state.glitch_cleared_ms)) {
-        target_dist_cm = rf_state.alt_cm + (dir * current_alt_error);
+        target_dist_cm = rf_dist_cm + (dir * current_alt_error);
         reset_target = false;
         last_glitch_cleared_ms = rf_state.glitch_cleared_ms;\
     }
@@ -48,7 +53,7 @@ float Copter::SurfaceTracking::adjust_climb_rate(float target_rate)
 #endif
 
     // calc desired velocity correction from target rangefinder alt vs actual rangefinder alt (remove the error already passed to Altitude controller to avoid oscillations)
-    const float distance_error = (target_dist_cm - rf_state.alt_cm) - (dir * current_alt_error);
+    const float distance_error = (target_dist_cm - rf_dist_cm) - (dir * current_alt_error);
     float velocity_correction = dir * distance_error * copter.g.rangefinder_gain;
     velocity_correction = constrain_float(velocity_correction, -SURFACE_TRACKING_VELZ_MAX, SURFACE_TRACKING_VELZ_MAX);
 
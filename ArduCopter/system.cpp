@@ -25,6 +25,7 @@ void Copter::init_ardupilot()
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     can_mgr.init();
 #endif
+    boot_step("board");
 
     // init cargo gripper
 #if GRIPPER_ENABLED == ENABLED
@@ -51,6 +52,7 @@ void Copter::init_ardupilot()
     rssi.init();
     
     barometer.init();
+    boot_step("baro");
 
     // setup telem slots with serial ports
     gcs().setup_uarts();
@@ -62,6 +64,7 @@ void Copter::init_ardupilot()
 #if LOGGING_ENABLED == ENABLED
     log_init();
 #endif
+    boot_step("logger");
 
     // update motor interlock state
     update_using_interlock();
@@ -92,6 +95,7 @@ void Copter::init_ardupilot()
     ap.initialised_params = true;
 
     relay.init();
+    boot_step("rc and motors");
 
     /*
      *  setup the 'main loop is dead' check. Note that this relies on
@@ -102,9 +106,11 @@ void Copter::init_ardupilot()
     // Do GPS init
     gps.set_log_gps_bit(MASK_LOG_GPS);
     gps.init(serial_manager);
+    boot_step("GPS");
 
     AP::compass().set_log_bit(MASK_LOG_COMPASS);
     AP::compass().init();
+    boot_step("compass");
 
     // init Location class
 #if AP_TERRAIN_AVAILABLE && AC_TERRAIN
@@ -141,11 +147,13 @@ void Copter::init_ardupilot()
 #ifdef USERHOOK_INIT
     USERHOOK_INIT
 #endif
+    boot_step("peripherals");
 
     // read Baro pressure at ground
     //-----------------------------
     barometer.set_log_baro_bit(MASK_LOG_IMU);
     barometer.calibrate();
+    boot_step("baro calibrate");
 
     // initialise rangefinder
     init_rangefinder();
@@ -162,6 +170,7 @@ void Copter::init_ardupilot()
     // initialise AP_RPM library
     rpm_sensor.init();
 #endif
+    boot_step("rangefinder");
 
 #if MODE_AUTO_ENABLED == ENABLED
     // initialise mission library
@@ -177,9 +186,11 @@ void Copter::init_ardupilot()
     logger.setVehicle_Startup_Writer(FUNCTOR_BIND(&copter, &Copter::Log_Write_Vehicle_Startup_Messages, void));
 
     startup_INS_ground();
+    boot_step("INS");
 
 #ifdef ENABLE_SCRIPTING
     g2.scripting.init();
+    boot_step("scripting");
 #endif // ENABLE_SCRIPTING
 
     // set landed flags
@@ -201,6 +212,9 @@ void Copter::init_ardupilot()
         enable_motor_output();
     }
 
+    // hand the rate controller to its own thread if enabled
+    rate_thread_init();
+
     // attempt to set the intial_mode, else set to STABILIZE
     if (!set_mode((enum Mode::Number)g.initial_mode.get(), ModeReason::INITIALISED)) {
         // set mode to STABILIZE will trigger mode change notification to pilot
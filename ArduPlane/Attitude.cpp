@@ -510,6 +510,9 @@ void Plane::calc_throttle()
     }
 
     int32_t commanded_throttle = SpdHgt_Controller->get_throttle_demand();
+    if (g2.nav_interp) {
+        commanded_throttle = throttle_interp.apply(commanded_throttle, millis());
+    }
 
     // Received an external msg that guides throttle in the last 3 seconds?
     if (control_mode->is_guided_mode() &&
@@ -614,6 +617,29 @@ void Plane::calc_nav_yaw_ground(void)
 }
 
 
+/*
+  interpolate an outer loop demand. A change in the demand starts a
+  new ramp from the current output. If we have not been called for
+  more than a period (eg. after a mode change) the demand is used
+  directly
+ */
+float Plane::DemandInterp::apply(float demand, uint32_t now_ms)
+{
+    if (_last_ms == 0 || now_ms - _last_ms > _period_ms) {
+        _demand = demand;
+        _from = demand;
+        _start_ms = now_ms - _period_ms;
+    } else if (!is_equal(demand, _demand)) {
+        const float ratio = MIN(float(now_ms - _start_ms) / _period_ms, 1.0f);
+        _from += (_demand - _from) * ratio;
+        _demand = demand;
+        _start_ms = now_ms;
+    }
+    _last_ms = now_ms;
+    const float ratio = MIN(float(now_ms - _start_ms) / _period_ms, 1.0f);
+    return _from + (_demand - _from) * ratio;
+}
+
 /*
   calculate a new nav_pitch_cd from the speed height controller
  */
@@ -622,6 +648,9 @@ void Plane::calc_nav_pitch()
     // Calculate the Pitch of the plane
     // --------------------------------
     int32_t commanded_pitch = SpdHgt_Controller->get_pitch_demand();
+    if (g2.nav_interp) {
+        commanded_pitch = nav_pitch_interp.apply(commanded_pitch, millis());
+    }
 
     // Received an external msg that guides roll in the last 3 seconds?
     if (control_mode->is_guided_mode() &&
@@ -640,6 +669,9 @@ void Plane::calc_nav_pitch()
 void Plane::calc_nav_roll()
 {
     int32_t commanded_roll = nav_controller->nav_roll_cd();
+    if (g2.nav_interp) {
+        commanded_roll = nav_roll_interp.apply(commanded_roll, millis());
+    }
 
     // Received an external msg that guides roll in the last 3 seconds?
     if (control_mode->is_guided_mode() &&
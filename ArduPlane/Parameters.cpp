@@ -1225,6 +1225,13 @@ const AP_Param::GroupInfo ParametersG2::var_info[] = {
     AP_SUBGROUPINFO(guidedHeading, "GUIDED_", 28, ParametersG2, AC_PID),
 #endif // OFFBOARD_GUIDED == ENABLED
 
+    // @Param: NAV_INTERP
+    // @DisplayName: Navigation demand interpolation
+    // @Description: When enabled the roll demand from the navigation controller and the pitch and throttle demands from TECS are linearly interpolated between outer loop updates, so the attitude controllers see a smooth demand rather than a step at each update. This adds up to one outer loop period of lag, and is mostly useful when the outer loops are run slower than the default 10Hz.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("NAV_INTERP", 29, ParametersG2, nav_interp, 0),
+
     AP_GROUPEND
 };
 
@@ -569,6 +569,9 @@ public:
 
     // min initial climb in RTL
     AP_Int16        rtl_climb_min;
+
+    // interpolate outer loop demands
+    AP_Int8         nav_interp;
 };
 
 extern const AP_Param::Info var_info[];
@@ -549,6 +549,27 @@ private:
 #endif // OFFBOARD_GUIDED == ENABLED
     } guided_state;
 
+    /*
+      linear interpolation of a demand from an outer loop running at a
+      lower rate than its consumer. Each new demand is reached one
+      outer loop period after it is first seen, starting from the
+      current output so there is no step
+     */
+    class DemandInterp {
+    public:
+        DemandInterp(uint16_t period_ms) : _period_ms(period_ms) {}
+        float apply(float demand, uint32_t now_ms);
+    private:
+        const uint16_t _period_ms;
+        float _demand;
+        float _from;
+        uint32_t _start_ms;
+        uint32_t _last_ms;
+    };
+    DemandInterp nav_roll_interp{1000 / PLANE_NAV_RATE_HZ};
+    DemandInterp nav_pitch_interp{1000 / PLANE_ALT_RATE_HZ};
+    DemandInterp throttle_interp{1000 / PLANE_ALT_RATE_HZ};
+
 #if LANDING_GEAR_ENABLED == ENABLED
     // landing gear state
     struct {
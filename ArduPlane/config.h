@@ -285,6 +285,17 @@
  #define LANDING_GEAR_ENABLED !HAL_MINIMIZE_FEATURES
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+//  Outer loop rates. The navigation (L1) and altitude (TECS pitch and
+//  throttle) updates can be run slower on heavily loaded boards, with
+//  NAV_INTERP set to smooth their demands at the main loop rate
+#ifndef PLANE_NAV_RATE_HZ
+ # define PLANE_NAV_RATE_HZ             10
+#endif
+#ifndef PLANE_ALT_RATE_HZ
+ # define PLANE_ALT_RATE_HZ             10
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 //  EKF Failsafe
 #ifndef FS_EKF_THRESHOLD_DEFAULT
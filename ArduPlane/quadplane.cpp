@@ -2040,6 +2040,9 @@ void QuadPlane::update(void)
         attitude_control->reset_rate_controller_I_terms();
     }
 
+    const uint32_t update_start_us = AP_HAL::micros();
+    uint32_t section_start_us = update_start_us;
+
     if (!hal.util->get_soft_armed()) {
         /*
           make sure we don't have any residual control from previous flight stages
@@ -2056,7 +2059,8 @@ void QuadPlane::update(void)
     }
 
     const uint32_t now = AP_HAL::millis();
-    if (!in_vtol_mode()) {
+    const bool vtol_mode = in_vtol_mode();
+    if (!vtol_mode) {
         // we're in a fixed wing mode, cope with transitions and check
         // for assistance needed
         update_transition();
@@ -2066,6 +2070,7 @@ void QuadPlane::update(void)
 
         // output to motors
         motors_output();
+        profile_section(ProfileSection::MOTORS, section_start_us);
 
         if (now - last_vtol_mode_ms > 1000 && is_tailsitter()) {
             /*
@@ -2129,12 +2134,16 @@ void QuadPlane::update(void)
         throttle_wait = false;
     }
 
+    profile_section(ProfileSection::TRANSITION, section_start_us);
+
     tiltrotor_update();
+    profile_section(ProfileSection::TILT, section_start_us);
 
     // motors logging
     if (motors->armed()) {
-        const bool motors_active = in_vtol_mode() || assisted_flight;
-        if (motors_active && (motors->get_spool_state() != AP_Motors::SpoolState::SHUT_DOWN)) {
+        const bool motors_active = vtol_mode || assisted_flight;
+        if (motors_active && (motors->get_spool_state() != AP_Motors::SpoolState::SHUT_DOWN) &&
+            plane.should_log(MASK_LOG_ATTITUDE_FAST)) {
             // log RATE at main loop rate
             ahrs_view->Write_Rate(*motors, *attitude_control, *pos_control);
 
@@ -2150,7 +2159,62 @@ void QuadPlane::update(void)
             Log_Write_QControl_Tuning();
         }
     }
+    profile_section(ProfileSection::LOGGING, section_start_us);
+
+    profile_log(update_start_us);
+}
+
+/*
+  add the time since start_us to a profile section and start timing
+  the next one
+ */
+void QuadPlane::profile_section(ProfileSection section, uint32_t &start_us)
+{
+    const uint32_t now_us = AP_HAL::micros();
+    profile.section_us[uint8_t(section)] += now_us - start_us;
+    start_us = now_us;
+}
 
+/*
+  log the average time per update() of each section once a second
+ */
+void QuadPlane::profile_log(uint32_t update_start_us)
+{
+    profile.update_max_us = MAX(profile.update_max_us, AP_HAL::micros() - update_start_us);
+    profile.update_count++;
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - profile.last_log_ms < 1000) {
+        return;
+    }
+    profile.last_log_ms = now_ms;
+
+    if (plane.should_log(MASK_LOG_PM)) {
+        const float count = profile.update_count;
+        // @LoggerMessage: QPRF
+        // @Description: QuadPlane update timing
+        // @Field: TimeUS: Time since system startup
+        // @Field: N: number of updates since the last message
+        // @Field: Tran: average time per update in transition and VTOL state handling
+        // @Field: Mot: average time per update in VTOL motor output
+        // @Field: Tilt: average time per update in tiltrotor handling
+        // @Field: Log: average time per update in RATE, CTRL and QTUN logging
+        // @Field: Ctrl: average time per update in VTOL mode controllers
+        // @Field: Max: longest update, not including the VTOL mode controllers
+        AP::logger().Write("QPRF", "TimeUS,N,Tran,Mot,Tilt,Log,Ctrl,Max", "s-ssssss", "F-FFFFFF", "QHfffffI",
+                           AP_HAL::micros64(),
+                           profile.update_count,
+                           profile.section_us[uint8_t(ProfileSection::TRANSITION)] / count,
+                           profile.section_us[uint8_t(ProfileSection::MOTORS)] / count,
+                           profile.section_us[uint8_t(ProfileSection::TILT)] / count,
+                           profile.section_us[uint8_t(ProfileSection::LOGGING)] / count,
+                           profile.section_us[uint8_t(ProfileSection::CONTROL)] / count,
+                           profile.update_max_us);
+    }
+
+    memset(profile.section_us, 0, sizeof(profile.section_us));
+    profile.update_max_us = 0;
+    profile.update_count = 0;
 }
 
 /*
@@ -2320,6 +2384,8 @@ void QuadPlane::control_run(void)
         return;
     }
 
+    uint32_t start_us = AP_HAL::micros();
+
     switch (plane.control_mode->mode_number()) {
     case Mode::Number::QACRO:
         control_qacro();
@@ -2354,6 +2420,8 @@ void QuadPlane::control_run(void)
         plane.stabilize_roll(speed_scaler);
         plane.stabilize_pitch(speed_scaler);
     }
+
+    profile_section(ProfileSection::CONTROL, start_us);
 }
 
 /*
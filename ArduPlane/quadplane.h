@@ -507,6 +507,25 @@ private:
     // time of last QTUN log message
     uint32_t last_qtun_log_ms;
 
+    // timing of the sections of update() and control_run(), logged as
+    // QPRF once a second when the PM log bit is set
+    enum class ProfileSection : uint8_t {
+        TRANSITION = 0,     // transition and VTOL state handling
+        MOTORS,             // motors_output() in VTOL modes
+        TILT,               // tiltrotor_update()
+        LOGGING,            // RATE, CTRL and QTUN logging
+        CONTROL,            // VTOL mode controllers from control_run()
+        NUM_SECTIONS
+    };
+    struct {
+        uint32_t section_us[uint8_t(ProfileSection::NUM_SECTIONS)];    // total time in each section since last log
+        uint32_t update_max_us;     // longest update() since last log
+        uint16_t update_count;      // calls to update() since last log
+        uint32_t last_log_ms;       // system time of last QPRF message
+    } profile;
+    void profile_section(ProfileSection section, uint32_t &start_us);
+    void profile_log(uint32_t update_start_us);
+
     // types of tilt mechanisms
     enum {TILT_TYPE_CONTINUOUS    =0,
           TILT_TYPE_BINARY        =1,
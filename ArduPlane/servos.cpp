@@ -930,6 +930,11 @@ void Plane::servos_output(void)
 
     SRV_Channels::push();
 
+    // the failsafe also calls this from the timer thread
+    if (hal.scheduler->in_main_thread()) {
+        scheduler.output_sent();
+    }
+
     if (g2.servo_channels.auto_trim_enabled()) {
         servos_auto_trim();
     }
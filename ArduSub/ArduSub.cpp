@@ -106,6 +106,7 @@ void Sub::fast_loop()
 
     // send outputs to the motors library
     motors_output();
+    scheduler.output_sent();
 
     // run EKF state estimator (expensive)
     // --------------------
@@ -262,6 +262,7 @@ void Rover::Log_Write_Vehicle_Startup_Messages()
     logger.Write_Mode(control_mode->mode_number(), control_mode_reason);
     ahrs.Log_Write_Home_And_Origin();
     gps.Write_AP_Logger_Log_Startup_messages();
+    write_boot_log_messages();
 }
 
 // type and unit information can be found in
@@ -53,6 +53,12 @@
 
 #include "Parameters.h"
 
+// minimum interval between sensor messages for sensors that don't
+// report when they have a new sample, bounding the CAN bus load
+#ifndef AP_PERIPH_SENSOR_MIN_SEND_MS
+#define AP_PERIPH_SENSOR_MIN_SEND_MS 10
+#endif
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 void stm32_watchdog_init();
 void stm32_watchdog_pat();
@@ -226,6 +232,9 @@ public:
     uint32_t last_gps_update_ms;
     uint32_t last_baro_update_ms;
     uint32_t last_airspeed_update_ms;
+    float last_airspeed_pressure;
+    uint32_t last_rangefinder_update_ms;
+    uint32_t last_rangefinder_reading_ms;
 
     static AP_Periph_FW *_singleton;
 
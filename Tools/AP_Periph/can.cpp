@@ -1415,6 +1415,8 @@ void AP_Periph_FW::can_update()
     can_baro_update();
     can_airspeed_update();
     can_rangefinder_update();
+    // send the sensor messages now rather than after the slower tasks below
+    processTx();
 #if defined(HAL_PERIPH_ENABLE_BUZZER_WITHOUT_NOTIFY) || defined (HAL_PERIPH_ENABLE_NOTIFY)
     can_buzzer_update();
 #endif
@@ -1885,17 +1887,22 @@ void AP_Periph_FW::can_airspeed_update(void)
     }
 #endif
     uint32_t now = AP_HAL::native_millis();
-    if (now - last_airspeed_update_ms < 50) {
-        // max 20Hz data
+    if (now - last_airspeed_update_ms < AP_PERIPH_SENSOR_MIN_SEND_MS) {
         return;
     }
-    last_airspeed_update_ms = now;
     airspeed.update(false);
     if (!airspeed.healthy()) {
         // don't send any data
         return;
     }
+    // the backends give the mean of the samples since the last read,
+    // so only send when that has changed
     const float press = airspeed.get_corrected_pressure();
+    if (is_equal(press, last_airspeed_pressure)) {
+        return;
+    }
+    last_airspeed_pressure = press;
+    last_airspeed_update_ms = now;
     float temp;
     if (!airspeed.get_temperature(temp)) {
         temp = nanf("");
@@ -1949,13 +1956,17 @@ void AP_Periph_FW::can_rangefinder_update(void)
     }
 #endif
     uint32_t now = AP_HAL::native_millis();
-    static uint32_t last_update_ms;
-    if (now - last_update_ms < 20) {
-        // max 50Hz data
+    if (now - last_rangefinder_update_ms < AP_PERIPH_SENSOR_MIN_SEND_MS) {
         return;
     }
-    last_update_ms = now;
     rangefinder.update();
+    // send as soon as there is a new reading
+    const uint32_t reading_ms = rangefinder.last_reading_ms(ROTATION_NONE);
+    if (reading_ms == last_rangefinder_reading_ms) {
+        return;
+    }
+    last_rangefinder_reading_ms = reading_ms;
+    last_rangefinder_update_ms = now;
     RangeFinder::Status status = rangefinder.status_orient(ROTATION_NONE);
     if (status <= RangeFinder::Status::NoData) {
         // don't send any data
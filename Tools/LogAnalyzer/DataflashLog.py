@@ -10,6 +10,7 @@ import numpy
 import bisect
 import sys
 import ctypes
+import mmap
 
 from VehicleType import VehicleType, VehicleTypeString
 
@@ -397,20 +398,26 @@ class DataflashLogHelper:
     @staticmethod
     def isLogEmpty(logdata):
         '''returns an human readable error string if the log is essentially empty, otherwise returns None'''
-        # naive check for now, see if the throttle output was ever above 20%
-        throttleThreshold = 20
-        if logdata.vehicleType == VehicleType.Copter:
-            throttleThreshold = 200 # copter uses 0-1000, plane+rover use 0-100
         if "CTUN" in logdata.channels:
             try:
-                maxThrottle = logdata.channels["CTUN"]["ThrOut"].max()
+                return DataflashLogHelper.checkMaxThrottle(logdata, "ThrOut", logdata.channels["CTUN"]["ThrOut"].max())
             except KeyError as e:
                 # ThrOut was shorted to ThO at some stage...
-                maxThrottle = logdata.channels["CTUN"]["ThO"].max()
-                # at roughly the same time ThO became a range from 0 to 1
-                throttleThreshold = 0.2
-            if maxThrottle < throttleThreshold:
-                return "Throttle never above 20%"
+                return DataflashLogHelper.checkMaxThrottle(logdata, "ThO", logdata.channels["CTUN"]["ThO"].max())
+        return None
+
+    @staticmethod
+    def checkMaxThrottle(logdata, throttleLabel, maxThrottle):
+        '''returns an human readable error string if the maximum of CTUN.throttleLabel shows an essentially empty log, otherwise returns None'''
+        # naive check for now, see if the throttle output was ever above 20%
+        throttleThreshold = 20
+        if logdata.vehicleType == VehicleType.Copter:
+            throttleThreshold = 200 # copter uses 0-1000, plane+rover use 0-100
+        if throttleLabel == "ThO":
+            # at roughly the same time ThO became a range from 0 to 1
+            throttleThreshold = 0.2
+        if maxThrottle < throttleThreshold:
+            return "Throttle never above 20%"
         return None
 
 
@@ -516,15 +523,11 @@ class DataflashLog(object):
         self.lineCount  = lineNumber
         self.filesizeKB = numBytes / 1024.0
         # TODO: switch duration calculation to use TimeMS values rather than GPS timestemp
-        if "GPS" in self.channels:
-            # the GPS time label changed at some point, need to handle both
-            timeLabel = None
-            for i in 'TimeMS','TimeUS','Time':
-                if i in self.channels["GPS"]:
-                    timeLabel = i
-                    break
-            firstTimeGPS = int(self.channels["GPS"][timeLabel].listData[0][1])
-            lastTimeGPS  = int(self.channels["GPS"][timeLabel].listData[-1][1])
+        gpsTimes = self.getGPSTimeRange()
+        if gpsTimes is not None:
+            (timeLabel, firstTimeGPS, lastTimeGPS) = gpsTimes
+            firstTimeGPS = int(firstTimeGPS)
+            lastTimeGPS  = int(lastTimeGPS)
             if timeLabel == 'TimeUS':
                 firstTimeGPS /= 1000
                 lastTimeGPS /= 1000
@@ -533,6 +536,22 @@ class DataflashLog(object):
         # TODO: calculate logging rate based on timestamps
         # ...
 
+    @staticmethod
+    def getGPSTimeLabel(labels):
+        '''the GPS time label changed at some point, need to handle both'''
+        for i in 'TimeMS','TimeUS','Time':
+            if i in labels:
+                return i
+        return None
+
+    def getGPSTimeRange(self):
+        '''returns (timeLabel,firstTime,lastTime) of the GPS data, or None if there is none'''
+        if "GPS" not in self.channels:
+            return None
+        timeLabel = self.getGPSTimeLabel(self.channels["GPS"])
+        listData = self.channels["GPS"][timeLabel].listData
+        return (timeLabel, listData[0][1], listData[-1][1])
+
     msg_vehicle_to_vehicle_map = {
         "ArduCopter": VehicleType.Copter,
         "APM:Copter": VehicleType.Copter,
@@ -641,20 +660,23 @@ class DataflashLog(object):
                 self.handleModeChange(lineNumber, e)
         # anything else must be the log data
         else:
-            groupName = e.NAME
+            self.processData(lineNumber, e)
 
-            # first time seeing this type of log line, create the channel storage
-            if not groupName in self.channels:
-                self.channels[groupName] = {}
-                for label in e.labels:
-                    self.channels[groupName][label] = Channel()
+    def processData(self, lineNumber, e):
+        groupName = e.NAME
 
-            # store each token in its relevant channel
+        # first time seeing this type of log line, create the channel storage
+        if not groupName in self.channels:
+            self.channels[groupName] = {}
             for label in e.labels:
-                value = getattr(e, label)
-                channel = self.channels[groupName][label]
-                channel.dictData[lineNumber] = value
-                channel.listData.append((lineNumber, value))
+                self.channels[groupName][label] = Channel()
+
+        # store each token in its relevant channel
+        for label in e.labels:
+            value = getattr(e, label)
+            channel = self.channels[groupName][label]
+            channel.dictData[lineNumber] = value
+            channel.listData.append((lineNumber, value))
 
 
     def read_text(self, f, ignoreBadlines):
@@ -667,6 +689,8 @@ class DataflashLog(object):
             numBytes += len(line) + 1
             try:
                 #print("Reading line: %d" % lineNumber)
+                if isinstance(line, bytes):
+                    line = line.decode('ascii', 'replace')
                 line = line.strip('\n\r')
                 tokens = line.split(', ')
                 # first handle the log header lines
@@ -724,10 +748,17 @@ class DataflashLog(object):
 
     def _read_binary(self, f, ignoreBadlines):
         self._formats = {128:BinaryFormat}
-        data = bytearray(f.read())
+        # map the file rather than reading it all in, so the OS only
+        # keeps the part we are working through in memory. Messages are
+        # copied out so none of them hold a reference to the map
+        try:
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except Exception:
+            # stdin, or an empty file
+            data = bytearray(f.read())
         offset = 0
         while len(data) > offset + ctypes.sizeof(logheader):
-            h = logheader.from_buffer(data, offset)
+            h = logheader.from_buffer_copy(data, offset)
             if not (h.head1 == 0xa3 and h.head2 == 0x95):
                 if ignoreBadlines == False:
                     raise ValueError(h)
@@ -743,7 +774,7 @@ class DataflashLog(object):
                 if len(data) <= offset + typ.SIZE:
                     break
                 try:
-                    e = typ.from_buffer(data, offset)
+                    e = typ.from_buffer_copy(data, offset)
                 except:
                     print("data:{} offset:{} size:{} sizeof:{} sum:{}".format(len(data),offset,typ.SIZE,ctypes.sizeof(typ),offset+typ.SIZE))
                     raise
@@ -751,3 +782,35 @@ class DataflashLog(object):
             else:
                 raise ValueError(str(h) + "unknown type")
             yield e
+
+
+class StreamingDataflashLog(DataflashLog):
+    '''Log reader which passes each data message to listeners as it is read rather than storing it in channels, so a log of any size can be checked in one pass. The header info, parameters, messages and mode changes are kept as for DataflashLog'''
+
+    def __init__(self, logfile=None, format="auto", ignoreBadlines=False, listeners={}):
+        self.listeners    = {} # lineLabel -> [function(lineNumber, message)], '*' for every message
+        self.gpsTimeRange = None
+        for (lineLabel, functions) in listeners.items():
+            self.listeners[lineLabel] = list(functions)
+        DataflashLog.__init__(self, logfile, format, ignoreBadlines)
+
+    def addListener(self, lineLabel, function):
+        '''call function(lineNumber, message) for each lineLabel message read, or all of them for '*' '''
+        self.listeners.setdefault(lineLabel, []).append(function)
+
+    def getGPSTimeRange(self):
+        return self.gpsTimeRange
+
+    def processData(self, lineNumber, e):
+        if e.NAME == "GPS":
+            timeLabel = self.getGPSTimeLabel(e.labels)
+            if timeLabel is not None:
+                t = getattr(e, timeLabel)
+                if self.gpsTimeRange is None:
+                    self.gpsTimeRange = (timeLabel, t, t)
+                else:
+                    self.gpsTimeRange = (timeLabel, self.gpsTimeRange[1], t)
+        for function in self.listeners.get(e.NAME, []):
+            function(lineNumber, e)
+        for function in self.listeners.get('*', []):
+            function(lineNumber, e)
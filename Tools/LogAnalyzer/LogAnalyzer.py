@@ -53,6 +53,26 @@ class Test(object):
     def run(self, logdata, verbose=False):
         pass
 
+    # tests which can be run in a single pass over a log, without it
+    # all being loaded into memory, return the names of the log
+    # messages they need from streamMessages() and implement the
+    # stream methods below. '*' asks for every message
+    def streamMessages(self):
+        '''names of the log messages to pass to processMessage when streaming, None if the test needs the whole log loaded'''
+        return None
+
+    def startStream(self):
+        '''called before the log is streamed'''
+        pass
+
+    def processMessage(self, lineNumber, e):
+        '''called for each message named by streamMessages, in log order'''
+        pass
+
+    def finishStream(self, logdata, verbose=False):
+        '''called once the log has been streamed, to set self.result. logdata has no channels'''
+        pass
+
 
 class TestSuite(object):
     '''registers test classes, loading using a basic plugin architecture, and can run them all in one run() operation'''
@@ -92,6 +112,35 @@ class TestSuite(object):
                 endTime = time.time()
                 test.execTime = 1000 * (endTime-startTime)
 
+    def runStreaming(self, logfile, format="auto", ignoreBadlines=False, verbose=False):
+        '''read the log in one pass, running the tests which support streaming as it is read. Returns the StreamingDataflashLog'''
+        listeners = {}
+        streamTests = []
+        for test in self.tests:
+            if not test.enable:
+                continue
+            lineLabels = test.streamMessages()
+            if lineLabels is None:
+                # needs the whole log, so not applicable here
+                test.result = TestResult()
+                test.result.status = TestResult.StatusType.NA
+                test.execTime = 0
+                continue
+            test.startStream()
+            streamTests.append(test)
+            for lineLabel in lineLabels:
+                listeners.setdefault(lineLabel, []).append(test.processMessage)
+
+        self.logdata = DataflashLog.StreamingDataflashLog(logfile, format=format, ignoreBadlines=ignoreBadlines, listeners=listeners)
+        self.logfile = self.logdata.filename
+        # the time spent in processMessage is part of the log read time
+        for test in streamTests:
+            startTime = time.time()
+            test.finishStream(self.logdata, verbose)
+            endTime = time.time()
+            test.execTime = 1000 * (endTime-startTime)
+        return self.logdata
+
     def outputPlainText(self, outputStats):
         '''output test results in plain text'''
         print('Dataflash log analysis report for file: ' + self.logfile)
@@ -211,12 +260,79 @@ class TestSuite(object):
         xml.close()
 
 
+def analyze(logfile, args):
+    '''analyze a single log, returning the exit status'''
+    testSuite = TestSuite()
+
+    if args.stream:
+        # read the log and run the tests in one pass
+        startTime = time.time()
+        logdata = testSuite.runStreaming(logfile, format=args.format, ignoreBadlines=args.skip_bad, verbose=args.verbose)
+        endTime = time.time()
+        if args.profile:
+            print("Log file stream time: %.2f seconds" % (endTime-startTime))
+
+        # the empty check can only be made once the log has been read
+        if args.empty:
+            for test in testSuite.tests:
+                if test.name == "Empty" and test.enable and test.result.status == TestResult.StatusType.FAIL:
+                    sys.stderr.write("Empty log file: %s, %s" % (logdata.filename, test.result.statusMessage))
+                    return 1
+    else:
+        # load the log
+        startTime = time.time()
+        logdata = DataflashLog.DataflashLog(logfile, format=args.format, ignoreBadlines=args.skip_bad) # read log
+        endTime = time.time()
+        if args.profile:
+            print("Log file read time: %.2f seconds" % (endTime-startTime))
+
+        # check for empty log if requested
+        if args.empty:
+            emptyErr = DataflashLog.DataflashLogHelper.isLogEmpty(logdata)
+            if emptyErr:
+                sys.stderr.write("Empty log file: %s, %s" % (logdata.filename, emptyErr))
+                return 1
+
+        #run the tests, and gather timings
+        startTime = time.time()
+        testSuite.run(logdata, args.verbose)  # run tests
+        endTime = time.time()
+        if args.profile:
+            print("Test suite run time: %.2f seconds" % (endTime-startTime))
+
+    # deal with output
+    if not args.quiet:
+        testSuite.outputPlainText(args.profile)
+    if args.xml:
+        testSuite.outputXML(args.xml)
+        if not args.quiet:
+            print("XML output written to file: %s\n" % args.xml)
+    return 0
+
+
+def analyzeCapturingOutput(job):
+    '''analyze a log in a worker process, returning its exit status and output so the reports of logs analyzed in parallel are not interleaved'''
+    (logfile, args) = job
+    from io import StringIO
+    output = StringIO()
+    stdout = sys.stdout
+    sys.stdout = output
+    try:
+        status = analyze(logfile, args)
+    except Exception as e:
+        sys.stderr.write("Error analyzing %s: %s\n" % (logfile, str(e)))
+        status = 1
+    finally:
+        sys.stdout = stdout
+    return (status, output.getvalue())
+
+
 def main():
     dirName = os.path.dirname(os.path.abspath(__file__))
 
     # deal with command line arguments
     parser = argparse.ArgumentParser(description='Analyze an APM Dataflash log for known issues')
-    parser.add_argument('logfile', type=argparse.FileType('r'), help='path to Dataflash log file (or - for stdin)')
+    parser.add_argument('logfile', type=str, nargs='+', help='path to Dataflash log file (or - for stdin)')
     parser.add_argument('-f', '--format',  metavar='', type=str, action='store', choices=['bin','log','auto'], default='auto', help='log file format: \'bin\',\'log\' or \'auto\'')
     parser.add_argument('-q', '--quiet',  metavar='', action='store_const', const=True, help='quiet mode, do not print results')
     parser.add_argument('-p', '--profile', metavar='', action='store_const', const=True, help='output performance profiling data')
@@ -224,39 +340,31 @@ def main():
     parser.add_argument('-e', '--empty',  metavar='', action='store_const', const=True, help='run an initial check for an empty log')
     parser.add_argument('-x', '--xml', type=str, metavar='XML file', nargs='?', const='', default='', help='write output to specified XML file (or - for stdout)')
     parser.add_argument('-v', '--verbose', metavar='', action='store_const', const=True, help='verbose output')
+    parser.add_argument('-S', '--stream', metavar='', action='store_const', const=True, help='check the log in a single pass without loading it into memory, running only the tests which support it')
+    parser.add_argument('-j', '--jobs', type=int, metavar='N', default=1, help='number of logs to analyze in parallel')
     args = parser.parse_args()
 
-    # load the log
-    startTime = time.time()
-    logdata = DataflashLog.DataflashLog(args.logfile.name, format=args.format, ignoreBadlines=args.skip_bad) # read log
-    endTime = time.time()
-    if args.profile:
-        print("Log file read time: %.2f seconds" % (endTime-startTime))
-
-    # check for empty log if requested
-    if args.empty:
-        emptyErr = DataflashLog.DataflashLogHelper.isLogEmpty(logdata)
-        if emptyErr:
-            sys.stderr.write("Empty log file: %s, %s" % (logdata.filename, emptyErr))
-            sys.exit(1)
+    # argparse.FileType used to give stdin this name
+    logfiles = ['<stdin>' if f == '-' else f for f in args.logfile]
+    if len(logfiles) > 1 and args.xml:
+        parser.error("XML output needs a single log file")
 
-    #run the tests, and gather timings
-    testSuite = TestSuite()
-    startTime = time.time()
-    testSuite.run(logdata, args.verbose)  # run tests
-    endTime = time.time()
-    if args.profile:
-        print("Test suite run time: %.2f seconds" % (endTime-startTime))
+    if args.jobs <= 1 or len(logfiles) == 1:
+        status = 0
+        for logfile in logfiles:
+            status = max(status, analyze(logfile, args))
+        sys.exit(status)
 
-    # deal with output
-    if not args.quiet:
-        testSuite.outputPlainText(args.profile)
-    if args.xml:
-        testSuite.outputXML(args.xml)
-        if not args.quiet:
-            print("XML output written to file: %s\n" % args.xml)
+    import multiprocessing
+    pool = multiprocessing.Pool(args.jobs)
+    status = 0
+    for (logStatus, output) in pool.imap(analyzeCapturingOutput, [(f, args) for f in logfiles]):
+        sys.stdout.write(output)
+        status = max(status, logStatus)
+    pool.close()
+    pool.join()
+    sys.exit(status)
 
 
 if __name__ == "__main__":
     main()
-
@@ -38,6 +38,38 @@ class TestBrownout(Test):
 		# check for relative altitude at end
 		(finalAlt,finalAltLine) = logdata.channels["CTUN"][self.ctun_baralt_att].getNearestValue(logdata.lineCount, lookForwards=False)
 
+		self.__checkFinalAlt(isArmed, finalAlt)
+
+	def streamMessages(self):
+		return ["EV", "CTUN"]
+
+	def startStream(self):
+		self.isArmed = False
+		self.finalAlt = None
+
+	def processMessage(self, lineNumber, e):
+		if e.NAME == "EV":
+			if e.Id == 10:
+				self.isArmed = True
+			elif e.Id == 11:
+				self.isArmed = False
+		elif "BarAlt" in e.labels:
+			self.finalAlt = e.BarAlt
+		else:
+			self.finalAlt = e.BAlt
+
+	def finishStream(self, logdata, verbose):
+		self.result = TestResult()
+		self.result.status = TestResult.StatusType.GOOD
+
+		if self.finalAlt is None:
+			self.result.status = TestResult.StatusType.UNKNOWN
+			self.result.statusMessage = "No CTUN log data"
+			return
+
+		self.__checkFinalAlt(self.isArmed, self.finalAlt)
+
+	def __checkFinalAlt(self, isArmed, finalAlt):
 		finalAltMax = 3.0   # max alt offset that we'll still consider to be on the ground
 		if isArmed and finalAlt > finalAltMax:
 			self.result.status = TestResult.StatusType.FAIL
@@ -18,3 +18,29 @@ class TestEmpty(Test):
 		if emptyErr:
 			self.result.status = TestResult.StatusType.FAIL
 			self.result.statusMessage = "Empty log? " + emptyErr
+
+	def streamMessages(self):
+		return ["CTUN"]
+
+	def startStream(self):
+		self.throttleLabel = None
+		self.maxThrottle = None
+
+	def processMessage(self, lineNumber, e):
+		if self.throttleLabel is None:
+			# ThrOut was shorted to ThO at some stage...
+			self.throttleLabel = "ThrOut" if "ThrOut" in e.labels else "ThO"
+		throttle = getattr(e, self.throttleLabel)
+		if self.maxThrottle is None or throttle > self.maxThrottle:
+			self.maxThrottle = throttle
+
+	def finishStream(self, logdata, verbose):
+		self.result = TestResult()
+		self.result.status = TestResult.StatusType.GOOD
+
+		if self.maxThrottle is None:
+			return
+		emptyErr = DataflashLog.DataflashLogHelper.checkMaxThrottle(logdata, self.throttleLabel, self.maxThrottle)
+		if emptyErr:
+			self.result.status = TestResult.StatusType.FAIL
+			self.result.statusMessage = "Empty log? " + emptyErr
@@ -21,27 +21,52 @@ class TestEvents(Test):
 			for i in range(len(logdata.channels["ERR"]["Subsys"].listData)):
 				subSys = logdata.channels["ERR"]["Subsys"].listData[i][1]
 				eCode  = logdata.channels["ERR"]["ECode"].listData[i][1]
-				if subSys == 2 and (eCode == 1):
-			 		errors.add("PPM")
-				elif subSys == 3 and (eCode == 1 or eCode == 2):
-			 		errors.add("COMPASS")
-				elif subSys == 5 and (eCode == 1):
-			 		errors.add("FS_THR")
-				elif subSys == 6 and (eCode == 1):
-			 		errors.add("FS_BATT")
-				elif subSys == 7 and (eCode == 1):
-			 		errors.add("GPS")
-				elif subSys == 8 and (eCode == 1):
-			 		errors.add("GCS")
-				elif subSys == 9 and (eCode == 1 or eCode == 2):
-			 		errors.add("FENCE")
-				elif subSys == 10:
-			 		errors.add("FLT_MODE")
-				elif subSys == 11 and (eCode == 2):
-			 		errors.add("GPS_GLITCH")
-				elif subSys == 12 and (eCode == 1):
-			 		errors.add("CRASH")
+				error = self.__errorName(subSys, eCode)
+				if error is not None:
+					errors.add(error)
 
+		self.__reportErrors(errors)
+
+	def streamMessages(self):
+		return ["ERR"]
+
+	def startStream(self):
+		self.errors = set()
+
+	def processMessage(self, lineNumber, e):
+		error = self.__errorName(e.Subsys, e.ECode)
+		if error is not None:
+			self.errors.add(error)
+
+	def finishStream(self, logdata, verbose):
+		self.result = TestResult()
+		self.result.status = TestResult.StatusType.GOOD
+		self.__reportErrors(self.errors)
+
+	def __errorName(self, subSys, eCode):
+		if subSys == 2 and (eCode == 1):
+			return "PPM"
+		elif subSys == 3 and (eCode == 1 or eCode == 2):
+			return "COMPASS"
+		elif subSys == 5 and (eCode == 1):
+			return "FS_THR"
+		elif subSys == 6 and (eCode == 1):
+			return "FS_BATT"
+		elif subSys == 7 and (eCode == 1):
+			return "GPS"
+		elif subSys == 8 and (eCode == 1):
+			return "GCS"
+		elif subSys == 9 and (eCode == 1 or eCode == 2):
+			return "FENCE"
+		elif subSys == 10:
+			return "FLT_MODE"
+		elif subSys == 11 and (eCode == 2):
+			return "GPS_GLITCH"
+		elif subSys == 12 and (eCode == 1):
+			return "CRASH"
+		return None
+
+	def __reportErrors(self, errors):
 		if errors:
 			if len(errors) == 1 and "FENCE" in errors:
 				self.result.status = TestResult.StatusType.WARN
@@ -53,4 +78,3 @@ class TestEvents(Test):
 					self.result.statusMessage = "ERRs found: "
 			for err in errors:
 				self.result.statusMessage = self.result.statusMessage + err + " "
-
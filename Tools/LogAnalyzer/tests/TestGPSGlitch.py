@@ -8,15 +8,21 @@ class TestGPSGlitch(Test):
         Test.__init__(self)
         self.name = "GPS"
 
-    def findSatsChan(self, channels):
+    def findSatsLabel(self, labels):
         for chan in "NSats", "NSat", "numSV":
-            if chan in channels:
-                return channels[chan]
+            if chan in labels:
+                return chan
 
-    def findHDopChan(self, channels):
+    def findHDopLabel(self, labels):
         for chan in "HDop", "HDp", "EPH":
-            if chan in channels:
-                return channels[chan]
+            if chan in labels:
+                return chan
+
+    def findSatsChan(self, channels):
+        return channels[self.findSatsLabel(channels)]
+
+    def findHDopChan(self, channels):
+        return channels[self.findHDopLabel(channels)]
 
     def run(self, logdata, verbose):
         self.result = TestResult()
@@ -39,6 +45,42 @@ class TestGPSGlitch(Test):
                 eCode = logdata.channels["ERR"]["ECode"].listData[i][1]
                 if subSys == 11 and (eCode == 2):
                     gpsGlitchCount += 1
+
+        satsChan = self.findSatsChan(logdata.channels["GPS"])
+        hdopChan = self.findHDopChan(logdata.channels["GPS"])
+        self.__checkGPS(gpsGlitchCount, satsChan.min(), hdopChan.max())
+
+    def streamMessages(self):
+        return ["GPS", "GPS2", "ERR"]
+
+    def startStream(self):
+        self.gpsGlitchCount = 0
+        self.minSats = {} # lineLabel -> min satellites
+        self.maxHDop = {} # lineLabel -> max HDop
+
+    def processMessage(self, lineNumber, e):
+        if e.NAME == "ERR":
+            if e.Subsys == 11 and (e.ECode == 2):
+                self.gpsGlitchCount += 1
+            return
+        sats = getattr(e, self.findSatsLabel(e.labels))
+        hdop = getattr(e, self.findHDopLabel(e.labels))
+        self.minSats[e.NAME] = min(self.minSats.get(e.NAME, sats), sats)
+        self.maxHDop[e.NAME] = max(self.maxHDop.get(e.NAME, hdop), hdop)
+
+    def finishStream(self, logdata, verbose):
+        self.result = TestResult()
+        self.result.status = TestResult.StatusType.GOOD
+
+        # as for the loaded log, GPS2 is used if there is no GPS
+        for lineLabel in "GPS", "GPS2":
+            if lineLabel in self.minSats:
+                self.__checkGPS(self.gpsGlitchCount, self.minSats[lineLabel], self.maxHDop[lineLabel])
+                return
+        self.result.status = TestResult.StatusType.UNKNOWN
+        self.result.statusMessage = "No GPS log data"
+
+    def __checkGPS(self, gpsGlitchCount, minSats, maxHDop):
         if gpsGlitchCount:
             self.result.status = TestResult.StatusType.FAIL
             self.result.statusMessage = ("GPS glitch errors found (%d)" %
@@ -52,14 +94,12 @@ class TestGPSGlitch(Test):
         minSatsFAIL = 5
         maxHDopWARN = 3.0
         maxHDopFAIL = 10.0
-        satsChan = self.findSatsChan(logdata.channels["GPS"])
-        hdopChan = self.findHDopChan(logdata.channels["GPS"])
-        foundBadSatsWarn = satsChan.min() < minSatsWARN
-        foundBadHDopWarn = hdopChan.max() > maxHDopWARN
-        foundBadSatsFail = satsChan.min() < minSatsFAIL
-        foundBadHDopFail = hdopChan.max() > maxHDopFAIL
+        foundBadSatsWarn = minSats < minSatsWARN
+        foundBadHDopWarn = maxHDop > maxHDopWARN
+        foundBadSatsFail = minSats < minSatsFAIL
+        foundBadHDopFail = maxHDop > maxHDopFAIL
         satsMsg = ("Min satellites: %s, Max HDop: %s" %
-                   (satsChan.min(), hdopChan.max()))
+                   (minSats, maxHDop))
         if gpsGlitchCount:
             self.result.statusMessage = "\n".join([self.result.statusMessage,
                                                    satsMsg])
@@ -8,6 +8,11 @@ class TestNaN(Test):
         Test.__init__(self)
         self.name = "NaNs"
 
+    nans_ok = {
+        "CTUN": [ "DSAlt", "TAlt" ],
+        "POS": [ "RelOriginAlt"],
+    }
+
     def run(self, logdata, verbose):
         self.result = TestResult()
         self.result.status = TestResult.StatusType.GOOD
@@ -15,14 +20,9 @@ class TestNaN(Test):
         def FAIL():
             self.result.status = TestResult.StatusType.FAIL
 
-        nans_ok = {
-            "CTUN": [ "DSAlt", "TAlt" ],
-            "POS": [ "RelOriginAlt"],
-        }
-
         for channel in logdata.channels.keys():
             for field in logdata.channels[channel].keys():
-                if channel in nans_ok and field in nans_ok[channel]:
+                if channel in self.nans_ok and field in self.nans_ok[channel]:
                     continue
                 try:
                     for tupe in logdata.channels[channel][field].listData:
@@ -33,3 +33,26 @@ class TestNaN(Test):
                             raise ValueError()
                 except ValueError as e:
                     continue
+
+    def streamMessages(self):
+        return ['*']
+
+    def startStream(self):
+        self.nanFields = [] # (channel,field) in the order first seen
+
+    def processMessage(self, lineNumber, e):
+        for field in e.labels:
+            val = getattr(e, field)
+            if isinstance(val, float) and math.isnan(val):
+                if e.NAME in self.nans_ok and field in self.nans_ok[e.NAME]:
+                    continue
+                if (e.NAME, field) not in self.nanFields:
+                    self.nanFields.append((e.NAME, field))
+
+    def finishStream(self, logdata, verbose):
+        self.result = TestResult()
+        self.result.status = TestResult.StatusType.GOOD
+
+        for (channel, field) in self.nanFields:
+            self.result.status = TestResult.StatusType.FAIL
+            self.result.statusMessage += "Found NaN in %s.%s\n" % (channel, field,)
@@ -63,3 +63,10 @@ class TestParams(Test):
         except KeyError as e:
             self.result.status = TestResult.StatusType.FAIL
             self.result.statusMessage = str(e) + ' not found'
+
+    # the parameters are kept when streaming, so no messages are needed
+    def streamMessages(self):
+        return []
+
+    def finishStream(self, logdata, verbose):
+        self.run(logdata, verbose)
@@ -30,6 +30,43 @@ class TestVCC(Test):
             vccMin *= 1000
             vccMax *= 1000
 
+        self.__checkVcc(vccMin, vccMax)
+
+    def streamMessages(self):
+        return ["CURR", "POWR"]
+
+    def startStream(self):
+        self.vccRange = {} # lineLabel -> [min,max]
+
+    def processMessage(self, lineNumber, e):
+        if "Vcc" not in e.labels:
+            return
+        vcc = e.Vcc
+        if e.NAME not in self.vccRange:
+            self.vccRange[e.NAME] = [vcc, vcc]
+        else:
+            vccRange = self.vccRange[e.NAME]
+            vccRange[0] = min(vccRange[0], vcc)
+            vccRange[1] = max(vccRange[1], vcc)
+
+    def finishStream(self, logdata, verbose):
+        self.result = TestResult()
+        self.result.status = TestResult.StatusType.GOOD
+
+        if "CURR" in self.vccRange:
+            (vccMin, vccMax) = self.vccRange["CURR"]
+        elif "POWR" in self.vccRange:
+            (vccMin, vccMax) = self.vccRange["POWR"]
+            vccMin *= 1000
+            vccMax *= 1000
+        else:
+            self.result.status = TestResult.StatusType.UNKNOWN
+            self.result.statusMessage = "No CURR log data"
+            return
+
+        self.__checkVcc(vccMin, vccMax)
+
+    def __checkVcc(self, vccMin, vccMax):
         vccDiff = vccMax - vccMin;
         vccMinThreshold = 4.6 * 1000;
         vccMaxDiff      = 0.3 * 1000;
@@ -8,6 +8,11 @@
 #include <unistd.h>
 #include <time.h>
 #include <cinttypes>
+#if AP_LOGREADER_MMAP_ENABLED
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #ifndef PRIu64
 #define PRIu64 "llu"
@@ -19,10 +24,26 @@ AP_LoggerFileReader::AP_LoggerFileReader()
 AP_LoggerFileReader::~AP_LoggerFileReader()
 {
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
+#if AP_LOGREADER_MMAP_ENABLED
+    free_index();
+    if (map != nullptr) {
+        munmap(map, map_size);
+    }
+#endif
 }
 
 bool AP_LoggerFileReader::open_log(const char *logfile)
 {
+#if AP_LOGREADER_MMAP_ENABLED
+    const int map_fd = ::open(logfile, O_RDONLY);
+    if (map_fd != -1) {
+        const bool mapped = map_log(map_fd);
+        ::close(map_fd);
+        if (mapped) {
+            return true;
+        }
+    }
+#endif
     fd = AP::FS().open(logfile, O_RDONLY);
     if (fd == -1) {
         return false;
@@ -30,9 +51,91 @@ bool AP_LoggerFileReader::open_log(const char *logfile)
     return true;
 }
 
+/*
+  refill the read buffer, returning false at end of file
+ */
+bool AP_LoggerFileReader::fill_buffer()
+{
+    const int32_t n = AP::FS().read(fd, readbuf, sizeof(readbuf));
+    if (n <= 0) {
+        return false;
+    }
+    readbuf_ofs = 0;
+    readbuf_len = n;
+    return true;
+}
+
+#if AP_LOGREADER_MMAP_ENABLED
+/*
+  map the whole log. The mapping is private and writable so message
+  handlers can be given pointers straight into it
+ */
+bool AP_LoggerFileReader::map_log(int map_fd)
+{
+    struct stat st;
+    if (fstat(map_fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, map_fd, 0);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    madvise(p, st.st_size, MADV_SEQUENTIAL);
+    map = (uint8_t *)p;
+    map_size = st.st_size;
+    map_ofs = 0;
+    return true;
+}
+#endif
+
 ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
 {
-    uint64_t ret = AP::FS().read(fd, buffer, count);
+#if AP_LOGREADER_MMAP_ENABLED
+    if (map != nullptr) {
+        const size_t n = MIN(uint64_t(count), map_size - map_ofs);
+        memcpy(buffer, &map[map_ofs], n);
+        map_ofs += n;
+        bytes_read += n;
+        return n;
+    }
+#endif
+    uint8_t *b = (uint8_t *)buffer;
+    size_t ret = 0;
+    while (ret < count) {
+        if (readbuf_ofs == readbuf_len && !fill_buffer()) {
+            break;
+        }
+        const size_t n = MIN(count - ret, size_t(readbuf_len - readbuf_ofs));
+        memcpy(&b[ret], &readbuf[readbuf_ofs], n);
+        readbuf_ofs += n;
+        ret += n;
+    }
+    bytes_read += ret;
+    return ret;
+}
+
+/*
+  consume count bytes without copying them out
+ */
+ssize_t AP_LoggerFileReader::skip_input(const size_t count)
+{
+#if AP_LOGREADER_MMAP_ENABLED
+    if (map != nullptr) {
+        const size_t n = MIN(uint64_t(count), map_size - map_ofs);
+        map_ofs += n;
+        bytes_read += n;
+        return n;
+    }
+#endif
+    size_t ret = 0;
+    while (ret < count) {
+        if (readbuf_ofs == readbuf_len && !fill_buffer()) {
+            break;
+        }
+        const size_t n = MIN(count - ret, size_t(readbuf_len - readbuf_ofs));
+        readbuf_ofs += n;
+        ret += n;
+    }
     bytes_read += ret;
     return ret;
 }
@@ -77,6 +180,11 @@ bool AP_LoggerFileReader::update()
             return false;
         }
         memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
+#if AP_LOGREADER_MMAP_ENABLED
+        if (map != nullptr) {
+            index.formats_seen_ofs = MAX(index.formats_seen_ofs, map_ofs);
+        }
+#endif
 
         message_count++;
         return handle_log_format_msg(f);
@@ -90,6 +198,23 @@ bool AP_LoggerFileReader::update()
         exit(1);
     }
 
+    if (skip_msg(f)) {
+        return skip_input(f.length-3) == f.length-3;
+    }
+
+#if AP_LOGREADER_MMAP_ENABLED
+    if (map != nullptr) {
+        // hand over the message in place rather than copying it
+        uint8_t *msg = &map[map_ofs-3];
+        if (skip_input(f.length-3) != f.length-3) {
+            return false;
+        }
+        index.formats_seen_ofs = MAX(index.formats_seen_ofs, map_ofs);
+        message_count++;
+        return handle_msg(f, msg);
+    }
+#endif
+
     uint8_t msg[f.length];
 
     memcpy(msg, hdr, 3);
@@ -100,3 +225,193 @@ bool AP_LoggerFileReader::update()
     message_count++;
     return handle_msg(f, msg);
 }
+
+#if AP_LOGREADER_MMAP_ENABLED
+void AP_LoggerFileReader::free_index()
+{
+    for (auto &m : index.msgs) {
+        free(m.offsets);
+    }
+    free(index.times);
+    delete[] index.formats;
+    index = {};
+}
+
+/*
+  append to a growable array, doubling its size as needed
+ */
+static bool name_in_list(const char *name, const char *list[])
+{
+    for (uint8_t i=0; list[i] != nullptr; i++) {
+        if (strcmp(name, list[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+static bool index_append(T *&array, uint32_t &count, uint32_t &space, const T &v)
+{
+    if (count == space) {
+        const uint32_t new_space = MAX(space * 2, 1024U);
+        T *a = (T *)realloc(array, new_space * sizeof(T));
+        if (a == nullptr) {
+            return false;
+        }
+        array = a;
+        space = new_space;
+    }
+    array[count++] = v;
+    return true;
+}
+
+bool AP_LoggerFileReader::build_index(const char *types[])
+{
+    if (map == nullptr) {
+        return false;
+    }
+    free_index();
+    index.formats = new log_Format[LOGREADER_MAX_FORMATS]{};
+    if (index.formats == nullptr) {
+        return false;
+    }
+
+    bool want[LOGREADER_MAX_FORMATS] {};
+    // formats whose first field is a TimeUS timestamp
+    bool timed[LOGREADER_MAX_FORMATS] {};
+    uint64_t next_time_us = 0;
+    uint32_t resyncs = 0;
+
+    uint64_t ofs = 0;
+    while (ofs + 3 <= map_size) {
+        const uint8_t *p = &map[ofs];
+        const uint8_t type = p[2];
+        if (p[0] != HEAD_BYTE1 || p[1] != HEAD_BYTE2 || type >= LOGREADER_MAX_FORMATS ||
+            (type != LOG_FORMAT_MSG && index.formats[type].length == 0)) {
+            // corrupt data, step forward until we find a header again
+            ofs++;
+            resyncs++;
+            continue;
+        }
+        const uint8_t length = type == LOG_FORMAT_MSG ? sizeof(log_Format) : index.formats[type].length;
+        if (ofs + length > map_size) {
+            break;
+        }
+        if (type == LOG_FORMAT_MSG) {
+            const log_Format &fmt = *(const log_Format *)p;
+            if (fmt.type < LOGREADER_MAX_FORMATS) {
+                index.formats[fmt.type] = fmt;
+                char name[5] {};
+                memcpy(name, fmt.name, 4);
+                want[fmt.type] = types == nullptr || name_in_list(name, types);
+                timed[fmt.type] = fmt.format[0] == 'Q' && strncmp(fmt.labels, "TimeUS,", 7) == 0;
+            }
+        }
+        if ((want[type] || type == LOG_FORMAT_MSG) &&
+            !index_append(index.msgs[type].offsets, index.msgs[type].count, index.msgs[type].space, ofs)) {
+            return false;
+        }
+        if (timed[type]) {
+            uint64_t time_us;
+            memcpy(&time_us, &p[3], sizeof(time_us));
+            if (time_us >= next_time_us) {
+                const time_offset t { time_us, ofs };
+                if (!index_append(index.times, index.time_count, index.time_space, t)) {
+                    return false;
+                }
+                next_time_us = time_us + LOGREADER_TIME_INDEX_INTERVAL_US;
+            }
+        }
+        ofs += length;
+    }
+    if (resyncs != 0) {
+        ::printf("Log index: skipped %u corrupt bytes\n", unsigned(resyncs));
+    }
+    index.built = true;
+    return true;
+}
+
+int16_t AP_LoggerFileReader::index_type(const char *name) const
+{
+    if (!index.built) {
+        return -1;
+    }
+    for (uint16_t i=0; i<LOGREADER_MAX_FORMATS; i++) {
+        const log_Format &f = index.formats[i];
+        if (f.length != 0 && strncmp(f.name, name, 4) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t AP_LoggerFileReader::index_count(uint8_t type) const
+{
+    if (type >= LOGREADER_MAX_FORMATS) {
+        return 0;
+    }
+    return index.msgs[type].count;
+}
+
+const uint8_t *AP_LoggerFileReader::index_message(uint8_t type, uint32_t n) const
+{
+    if (n >= index_count(type)) {
+        return nullptr;
+    }
+    return &map[index.msgs[type].offsets[n]];
+}
+
+/*
+  move the read position, first passing on any formats defined
+  between where we have read to and the new position
+ */
+bool AP_LoggerFileReader::seek_offset(uint64_t ofs)
+{
+    if (!index.built || ofs > map_size) {
+        return false;
+    }
+    const msg_offsets &fmts = index.msgs[LOG_FORMAT_MSG];
+    for (uint32_t i=0; i<fmts.count && fmts.offsets[i] < ofs; i++) {
+        if (fmts.offsets[i] < index.formats_seen_ofs) {
+            continue;
+        }
+        const log_Format &f = *(const log_Format *)&map[fmts.offsets[i]];
+        memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
+        handle_log_format_msg(f);
+    }
+    index.formats_seen_ofs = MAX(index.formats_seen_ofs, ofs);
+    map_ofs = ofs;
+    return true;
+}
+
+bool AP_LoggerFileReader::seek_message(uint8_t type, uint32_t n)
+{
+    if (n >= index_count(type)) {
+        return false;
+    }
+    return seek_offset(index.msgs[type].offsets[n]);
+}
+
+bool AP_LoggerFileReader::seek_time(uint64_t time_us)
+{
+    if (!index.built || index.time_count == 0) {
+        return false;
+    }
+    // the log clock is monotonic, the index entries are in time order
+    uint32_t lo = 0, hi = index.time_count;
+    while (lo < hi) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (index.times[mid].time_us < time_us) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo > 0) {
+        // start from the entry before so nothing at time_us is missed
+        lo--;
+    }
+    return seek_offset(index.times[lo].offset);
+}
+#endif // AP_LOGREADER_MMAP_ENABLED
@@ -4,6 +4,18 @@
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
+#ifndef LOGREADER_READ_BUFFER_SIZE
+#define LOGREADER_READ_BUFFER_SIZE 16384
+#endif
+
+// map the whole log into memory where the OS allows it
+#ifndef AP_LOGREADER_MMAP_ENABLED
+#define AP_LOGREADER_MMAP_ENABLED HAL_OS_POSIX_IO
+#endif
+
+// spacing of entries in the time index
+#define LOGREADER_TIME_INDEX_INTERVAL_US 100000
+
 class AP_LoggerFileReader
 {
 public:
@@ -17,9 +29,38 @@ public:
     virtual bool handle_log_format_msg(const struct log_Format &f) = 0;
     virtual bool handle_msg(const struct log_Format &f, uint8_t *msg) = 0;
 
+    // return true if messages of this format can be skipped unparsed
+    virtual bool skip_msg(const struct log_Format &f) { return false; }
+
     void format_type(uint16_t type, char dest[5]);
     void get_packet_counts(uint64_t dest[]);
 
+#if AP_LOGREADER_MMAP_ENABLED
+    /*
+      scan the mapped log once, recording the offset of every message
+      whose name is in types (all messages if types is nullptr) and a
+      coarse time index. Only available when the log is mapped
+     */
+    bool build_index(const char *types[] = nullptr);
+
+    // message type id of a format name in the index, -1 if not present
+    int16_t index_type(const char *name) const;
+
+    // number of indexed messages of a type
+    uint32_t index_count(uint8_t type) const;
+
+    // raw bytes of the n'th indexed message of a type, including header
+    const uint8_t *index_message(uint8_t type, uint32_t n) const;
+
+    /*
+      continue update() from the n'th message of a type, or from the
+      first message at or after time_us. Formats defined before that
+      point are passed to handle_log_format_msg() first
+     */
+    bool seek_message(uint8_t type, uint32_t n);
+    bool seek_time(uint64_t time_us);
+#endif
+
 protected:
     int fd = -1;
 
@@ -27,10 +68,50 @@ protected:
 
 private:
     ssize_t read_input(void *buf, size_t count);
+    ssize_t skip_input(size_t count);
+    bool fill_buffer();
+#if AP_LOGREADER_MMAP_ENABLED
+    bool map_log(int map_fd);
+    bool seek_offset(uint64_t ofs);
+    void free_index();
+#endif
 
     uint64_t bytes_read = 0;
     uint32_t message_count = 0;
     uint64_t start_micros;
 
     uint64_t packet_counts[LOGREADER_MAX_FORMATS] = {};
+
+    // reading a message at a time costs two system calls per
+    // message, so read the log in large blocks
+    uint8_t readbuf[LOGREADER_READ_BUFFER_SIZE];
+    uint16_t readbuf_ofs;
+    uint16_t readbuf_len;
+
+#if AP_LOGREADER_MMAP_ENABLED
+    uint8_t *map = nullptr;
+    uint64_t map_size;
+    uint64_t map_ofs;
+
+    struct msg_offsets {
+        uint64_t *offsets;
+        uint32_t count;
+        uint32_t space;
+    };
+    struct time_offset {
+        uint64_t time_us;
+        uint64_t offset;
+    };
+    struct {
+        bool built;
+        struct log_Format *formats;
+        struct msg_offsets msgs[LOGREADER_MAX_FORMATS];
+        struct time_offset *times;
+        uint32_t time_count;
+        uint32_t time_space;
+        // formats before this offset have been handed to
+        // handle_log_format_msg()
+        uint64_t formats_seen_ofs;
+    } index {};
+#endif
 };
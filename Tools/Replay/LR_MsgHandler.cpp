@@ -20,6 +20,12 @@ void LR_MsgHandler_RFRH::process_message(uint8_t *msgbytes)
     AP::dal().handle_message(msg);
 }
 
+void LR_MsgHandler_RFRD::process_message(uint8_t *msgbytes)
+{
+    MSG_CREATE(RFRD, msgbytes);
+    AP::dal().handle_message(msg);
+}
+
 void LR_MsgHandler_RFRF::process_message(uint8_t *msgbytes)
 {
     MSG_CREATE(RFRF, msgbytes);
@@ -38,9 +44,48 @@ void LR_MsgHandler_RFRF::process_message(uint8_t *msgbytes)
         MAP_FLAG(AP_DAL::FrameType::LogWriteEKF2, AP_DAL::FrameType::LogWriteEKF3);
     }
 #undef MAP_FLAG
+    if (replay_fast_forward && ekf3.statesInitialised()) {
+        // leave EKF3 idle until it can resume from a checkpoint
+        msg.frame_types &= ~uint8_t(AP_DAL::FrameType::UpdateFilterEKF3);
+        msg.frame_types &= ~uint8_t(AP_DAL::FrameType::LogWriteEKF3);
+    }
     AP::dal().handle_message(msg, ekf2, ekf3);
 }
 
+void LR_MsgHandler_XKCP::process_message(uint8_t *msgbytes)
+{
+    MSG_CREATE(XKCP, msgbytes);
+    if (!replay_fast_forward || msg.core >= MAX_EKF_CORES ||
+        msg.time_us < replay_start_time_us || msg.seq >= num_parts) {
+        // replayed cores are logged with core numbers from 100
+        return;
+    }
+    auto &cp = checkpoint[msg.core];
+    if (msg.seq == 0 || msg.time_us != cp.time_us) {
+        cp.time_us = msg.time_us;
+        cp.parts_received = 0;
+    }
+    if (msg.seq != cp.parts_received) {
+        // a part is missing, wait for the next checkpoint
+        return;
+    }
+    memcpy(&cp.data[msg.seq * part_size], msg.data, part_size);
+    if (++cp.parts_received < num_parts) {
+        return;
+    }
+    cp.restored = ekf3.restoreCheckpoint(msg.core, cp.data, sizeof(cp.data));
+    if (!cp.restored) {
+        return;
+    }
+    for (uint8_t i=0; i<ekf3.activeCores(); i++) {
+        if (!checkpoint[i].restored || checkpoint[i].time_us != msg.time_us) {
+            return;
+        }
+    }
+    ::printf("Resumed EKF3 from checkpoint at %.1fs\n", msg.time_us * 1.0e-6);
+    replay_fast_forward = false;
+}
+
 void LR_MsgHandler_RFRN::process_message(uint8_t *msgbytes)
 {
     MSG_CREATE(RFRN, msgbytes);
@@ -176,6 +221,11 @@ void LR_MsgHandler_RISI::process_message(uint8_t *msgbytes)
     MSG_CREATE(RISI, msgbytes);
     AP::dal().handle_message(msg);
 }
+void LR_MsgHandler_RISJ::process_message(uint8_t *msgbytes)
+{
+    MSG_CREATE(RISJ, msgbytes);
+    AP::dal().handle_message(msg);
+}
 
 void LR_MsgHandler_RASH::process_message(uint8_t *msgbytes)
 {
@@ -5,6 +5,7 @@
 #include <AP_GPS/AP_GPS.h>
 #include <AP_NavEKF2/AP_NavEKF2.h>
 #include <AP_NavEKF3/AP_NavEKF3.h>
+#include <AP_NavEKF3/AP_NavEKF3_core.h>
 
 class LR_MsgHandler : public MsgHandler {
 public:
@@ -25,6 +26,13 @@ public:
     void process_message(uint8_t *msg) override;
 };
 
+class LR_MsgHandler_RFRD : public LR_MsgHandler
+{
+public:
+    using LR_MsgHandler::LR_MsgHandler;
+    void process_message(uint8_t *msg) override;
+};
+
 class LR_MsgHandler_EKF : public LR_MsgHandler
 {
 public:
@@ -75,6 +83,26 @@ class LR_MsgHandler_RBOH : public LR_MsgHandler_EKF
     void process_message(uint8_t *msg) override;
 };
 
+/*
+  gather EKF3 checkpoints and restore them when resuming part way
+  through a log
+ */
+class LR_MsgHandler_XKCP : public LR_MsgHandler_EKF
+{
+public:
+    using LR_MsgHandler_EKF::LR_MsgHandler_EKF;
+    void process_message(uint8_t *msg) override;
+private:
+    static const uint8_t part_size = sizeof(log_XKCP::data);
+    static const uint8_t num_parts = (sizeof(NavEKF3_core::checkpoint_elements) + part_size - 1) / part_size;
+    struct {
+        uint64_t time_us;
+        uint8_t parts_received;
+        bool restored;
+        uint8_t data[num_parts * part_size];
+    } checkpoint[MAX_EKF_CORES];
+};
+
 class LR_MsgHandler_RFRN : public LR_MsgHandler
 {
 public:
@@ -144,6 +172,12 @@ public:
     using LR_MsgHandler::LR_MsgHandler;
     void process_message(uint8_t *msg) override;
 };
+class LR_MsgHandler_RISJ : public LR_MsgHandler
+{
+public:
+    using LR_MsgHandler::LR_MsgHandler;
+    void process_message(uint8_t *msg) override;
+};
 class LR_MsgHandler_RASH : public LR_MsgHandler
 {
 public:
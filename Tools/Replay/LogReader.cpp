@@ -64,6 +64,8 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
         msgparser[f.type] = new LR_MsgHandler_PARM(formats[f.type]);
     } else if (streq(name, "RFRH")) {
         msgparser[f.type] = new LR_MsgHandler_RFRH(formats[f.type]);
+    } else if (streq(name, "RFRD")) {
+        msgparser[f.type] = new LR_MsgHandler_RFRD(formats[f.type]);
     } else if (streq(name, "RFRF")) {
         msgparser[f.type] = new LR_MsgHandler_RFRF(formats[f.type], ekf2, ekf3);
     } else if (streq(name, "RFRN")) {
@@ -86,6 +88,8 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
 	    msgparser[f.type] = new LR_MsgHandler_RISH(formats[f.type]);
 	} else if (streq(name, "RISI")) {
 	    msgparser[f.type] = new LR_MsgHandler_RISI(formats[f.type]);
+	} else if (streq(name, "RISJ")) {
+	    msgparser[f.type] = new LR_MsgHandler_RISJ(formats[f.type]);
     } else if (streq(name, "RASH")) {
 	    msgparser[f.type] = new LR_MsgHandler_RASH(formats[f.type]);
 	} else if (streq(name, "RASI")) {
@@ -124,6 +128,8 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
         msgparser[f.type] = new LR_MsgHandler_RWOH(formats[f.type], ekf2, ekf3);
     } else if (streq(name, "RBOH")) {
         msgparser[f.type] = new LR_MsgHandler_RBOH(formats[f.type], ekf2, ekf3);
+    } else if (streq(name, "XKCP")) {
+        msgparser[f.type] = new LR_MsgHandler_XKCP(formats[f.type], ekf2, ekf3);
 	} else {
         // debug("  No parser for (%s)\n", name);
     }
@@ -145,6 +151,15 @@ bool LogReader::handle_msg(const struct log_Format &f, uint8_t *msg) {
     return true;
 }
 
+/*
+  with --dal-only, messages which don't feed the replayed EKFs are
+  neither parsed nor copied to the output log
+ */
+bool LogReader::skip_msg(const struct log_Format &f)
+{
+    return replay_dal_only && msgparser[f.type] == NULL;
+}
+
 /*
   see if a user parameter is set
  */
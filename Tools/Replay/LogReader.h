@@ -17,6 +17,7 @@ public:
 
     bool handle_log_format_msg(const struct log_Format &f) override;
     bool handle_msg(const struct log_Format &f, uint8_t *msg) override;
+    bool skip_msg(const struct log_Format &f) override;
 
     static bool in_list(const char *type, const char *list[]);
 
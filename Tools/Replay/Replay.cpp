@@ -38,6 +38,10 @@ static ReplayVehicle replayvehicle;
 user_parameter *user_parameters;
 bool replay_force_ekf2;
 bool replay_force_ekf3;
+bool replay_ekf_timing;
+bool replay_dal_only;
+uint64_t replay_start_time_us;
+bool replay_fast_forward;
 
 #define GSCALAR(v, name, def) { replayvehicle.g.v.vtype, name, Parameters::k_param_ ## v, &replayvehicle.g.v, {def_value : def} }
 #define GOBJECT(v, name, class) { AP_PARAM_GROUP, name, Parameters::k_param_ ## v, &replayvehicle.v, {group_info : class::var_info} }
@@ -131,11 +135,19 @@ void Replay::usage(void)
     ::printf("\t--param-file FILENAME  load parameters from a file\n");
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
+    ::printf("\t--start-time SECONDS resume EKF3 from the first checkpoint (EK3_CKPT_INT) at or after SECONDS\n");
+    ::printf("\t--dal-only only parse replay (DAL) messages, other messages are not copied to the output log\n");
+#if HAL_NAVEKF_TIMING_ENABLED
+    ::printf("\t--ekf-timing print per-call timing of the main EKF steps at exit\n");
+#endif
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    EKF_TIMING,
+    DAL_ONLY,
+    START_TIME,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -147,6 +159,9 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"param-file",      true,   0, 'F'},
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
+        {"ekf-timing",      false,  0, param_key::EKF_TIMING},
+        {"dal-only",        false,  0, param_key::DAL_ONLY},
+        {"start-time",      true,   0, param_key::START_TIME},
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -182,6 +197,19 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             replay_force_ekf3 = true;
             break;
 
+        case param_key::EKF_TIMING:
+            replay_ekf_timing = true;
+            break;
+
+        case param_key::DAL_ONLY:
+            replay_dal_only = true;
+            break;
+
+        case param_key::START_TIME:
+            replay_start_time_us = atof(gopt.optarg) * 1.0e6;
+            replay_fast_forward = true;
+            break;
+
         case 'h':
         default:
             usage();
@@ -245,6 +273,15 @@ void Replay::setup()
 void Replay::loop()
 {
     if (!reader.update()) {
+        if (replay_fast_forward) {
+            ::printf("No EKF3 checkpoint found at or after start time, is EK3_CKPT_INT set?\n");
+        }
+#if HAL_NAVEKF_TIMING_ENABLED
+        if (replay_ekf_timing) {
+            _vehicle.ekf2.print_call_timing();
+            _vehicle.ekf3.print_call_timing();
+        }
+#endif
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // If we don't tear down the threads then they continue to access
     // global state during object destruction.
@@ -26,6 +26,10 @@ struct user_parameter {
 extern user_parameter *user_parameters;
 extern bool replay_force_ekf2;
 extern bool replay_force_ekf3;
+extern bool replay_ekf_timing;
+extern bool replay_dal_only;
+extern uint64_t replay_start_time_us;
+extern bool replay_fast_forward;
 
 class ReplayVehicle : public AP_Vehicle {
 public:
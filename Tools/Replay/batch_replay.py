@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+
+'''
+replay a directory of logs in parallel and summarise the EKF
+innovations of the replayed cores
+
+Replay holds its vehicle, EKFs and logger as process-wide singletons,
+so each log is run by its own Replay process in its own working
+directory
+
+example:
+  ./Tools/Replay/batch_replay.py --jobs 8 --parm EK3_MAG_M_NSE=0.1 logs/fleet
+'''
+
+from __future__ import print_function
+
+import csv
+import glob
+import math
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# innovations and test ratios to summarise, per EKF message type
+ek2_fields = {
+    'NKF3': ['IVN', 'IVE', 'IVD', 'IPN', 'IPE', 'IPD', 'IMX', 'IMY', 'IMZ', 'IYAW', 'IVT'],
+    'NKF4': ['SV', 'SP', 'SH', 'SM', 'SVT'],
+}
+ek3_fields = {
+    'XKF3': ['IVN', 'IVE', 'IVD', 'IPN', 'IPE', 'IPD', 'IMX', 'IMY', 'IMZ', 'IYAW', 'IVT'],
+    'XKF4': ['SV', 'SP', 'SH', 'SM', 'SVT'],
+}
+
+
+class FieldStats(object):
+    '''running statistics of one field'''
+    def __init__(self):
+        self.count = 0
+        self.sum_abs = 0.0
+        self.sum_sq = 0.0
+        self.max_abs = 0.0
+
+    def add(self, v):
+        a = abs(v)
+        self.count += 1
+        self.sum_abs += a
+        self.sum_sq += v*v
+        self.max_abs = max(self.max_abs, a)
+
+    def mean_abs(self):
+        if self.count == 0:
+            return 0.0
+        return self.sum_abs / self.count
+
+    def rms(self):
+        if self.count == 0:
+            return 0.0
+        return math.sqrt(self.sum_sq / self.count)
+
+
+def find_logs(paths):
+    '''expand directories into the logs they contain'''
+    ret = []
+    for p in paths:
+        if os.path.isdir(p):
+            for ext in ['*.bin', '*.BIN']:
+                ret.extend(glob.glob(os.path.join(p, '**', ext), recursive=True))
+        else:
+            ret.append(p)
+    return sorted(set([os.path.abspath(p) for p in ret]))
+
+
+def innovation_stats(logfile, fields):
+    '''gather stats of the replayed cores (C >= 100) in a Replay output log'''
+    from pymavlink import mavutil
+    stats = {}
+    mlog = mavutil.mavlink_connection(logfile)
+    while True:
+        m = mlog.recv_match(type=list(fields.keys()))
+        if m is None:
+            break
+        core = getattr(m, 'C', None)
+        if core is None or core < 100:
+            continue
+        mtype = m.get_type()
+        for f in fields[mtype]:
+            key = "%s[%u].%s" % (mtype, core-100, f)
+            if key not in stats:
+                stats[key] = FieldStats()
+            stats[key].add(getattr(m, f))
+    return stats
+
+
+def replay_one(job):
+    '''replay a single log, returning a summary dictionary'''
+    (logfile, opts) = job
+    ret = {'log': logfile, 'ok': False, 'error': '', 'time': 0.0, 'stats': {}}
+    workdir = tempfile.mkdtemp(prefix='replay_')
+    cmd = [opts.replay]
+    for p in opts.parm:
+        cmd.extend(['--parm', p])
+    if opts.param_file is not None:
+        cmd.extend(['--param-file', opts.param_file])
+    if opts.force_ekf2:
+        cmd.append('--force-ekf2')
+    if opts.force_ekf3:
+        cmd.append('--force-ekf3')
+    if opts.dal_only:
+        cmd.append('--dal-only')
+    cmd.append(logfile)
+    t0 = time.time()
+    try:
+        with open(os.path.join(workdir, 'replay.txt'), 'w') as out:
+            rc = subprocess.call(cmd, cwd=workdir, stdout=out, stderr=subprocess.STDOUT)
+        ret['time'] = time.time() - t0
+        if rc != 0:
+            ret['error'] = 'Replay exited with %d' % rc
+            return ret
+        outlogs = sorted(glob.glob(os.path.join(workdir, 'logs', '*.BIN')))
+        if len(outlogs) == 0:
+            ret['error'] = 'no output log'
+            return ret
+        fields = {}
+        if not opts.ekf3_only:
+            fields.update(ek2_fields)
+        if not opts.ekf2_only:
+            fields.update(ek3_fields)
+        ret['stats'] = innovation_stats(outlogs[-1], fields)
+        ret['ok'] = True
+        if opts.keep is not None:
+            dest = os.path.join(opts.keep, os.path.splitext(os.path.basename(logfile))[0] + '-replay.bin')
+            shutil.copy(outlogs[-1], dest)
+    except Exception as ex:
+        ret['error'] = str(ex)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+    return ret
+
+
+def write_csv(filename, results):
+    '''one row per log, mean abs, rms and max abs for each field'''
+    keys = sorted(set([k for r in results for k in r['stats'].keys()]))
+    with open(filename, 'w') as f:
+        w = csv.writer(f)
+        header = ['log', 'ok', 'error', 'time']
+        for k in keys:
+            header.extend([k + '.mean', k + '.rms', k + '.max'])
+        w.writerow(header)
+        for r in results:
+            row = [r['log'], int(r['ok']), r['error'], "%.1f" % r['time']]
+            for k in keys:
+                s = r['stats'].get(k, None)
+                if s is None:
+                    row.extend(['', '', ''])
+                else:
+                    row.extend(["%.4f" % s.mean_abs(), "%.4f" % s.rms(), "%.4f" % s.max_abs])
+            w.writerow(row)
+
+
+def print_summary(results):
+    '''print the worst test ratios of each log'''
+    for r in results:
+        if not r['ok']:
+            print("%s: FAILED (%s)" % (r['log'], r['error']))
+            continue
+        worst = []
+        for (k, s) in r['stats'].items():
+            if k.split('.')[-1] in ['SV', 'SP', 'SH', 'SM', 'SVT']:
+                worst.append((s.max_abs, k))
+        worst = sorted(worst, reverse=True)[:3]
+        print("%s: %.1fs %s" % (r['log'], r['time'],
+                                " ".join(["%s=%.2f" % (k, v) for (v, k) in worst])))
+
+
+if __name__ == '__main__':
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--replay", default="build/sitl/tools/Replay", help="path to Replay binary")
+    parser.add_argument("--jobs", "-j", type=int, default=multiprocessing.cpu_count(), help="number of parallel replays")
+    parser.add_argument("--parm", action='append', default=[], help="set parameter NAME=VALUE for all replays")
+    parser.add_argument("--param-file", default=None, help="load parameters from a file for all replays")
+    parser.add_argument("--force-ekf2", action='store_true', help="force enable EKF2")
+    parser.add_argument("--force-ekf3", action='store_true', help="force enable EKF3")
+    parser.add_argument("--ekf2-only", action='store_true', help="only summarise EKF2")
+    parser.add_argument("--ekf3-only", action='store_true', help="only summarise EKF3")
+    parser.add_argument("--dal-only", action='store_true', help="only parse DAL messages, for speed")
+    parser.add_argument("--csv", default="replay_summary.csv", help="summary output file")
+    parser.add_argument("--keep", default=None, help="directory to keep replay output logs in")
+    parser.add_argument("logs", metavar="LOG", nargs="+", help="logs or directories of logs")
+    args = parser.parse_args()
+
+    args.replay = os.path.abspath(args.replay)
+    if args.param_file is not None:
+        args.param_file = os.path.abspath(args.param_file)
+    if args.keep is not None:
+        args.keep = os.path.abspath(args.keep)
+        if not os.path.isdir(args.keep):
+            os.makedirs(args.keep)
+
+    logs = find_logs(args.logs)
+    if len(logs) == 0:
+        print("No logs found")
+        sys.exit(1)
+    print("Replaying %u logs with %u jobs" % (len(logs), args.jobs))
+
+    pool = multiprocessing.Pool(max(1, args.jobs))
+    results = []
+    for r in pool.imap_unordered(replay_one, [(log, args) for log in logs]):
+        print("%s: %s" % (r['log'], "OK" if r['ok'] else r['error']))
+        results.append(r)
+    pool.close()
+    pool.join()
+
+    results = sorted(results, key=lambda r: r['log'])
+    write_csv(args.csv, results)
+    print_summary(results)
+    print("Summary written to %s" % args.csv)
+
+    failed = len([r for r in results if not r['ok']])
+    if failed > 0:
+        print("%u of %u replays failed" % (failed, len(results)))
+        sys.exit(1)
@@ -0,0 +1,103 @@
+#!/usr/bin/env python
+
+'''
+run Replay with --ekf-timing over a set of logs and check the mean
+time of each EKF step against a baseline, to catch EKF performance
+regressions off-target
+
+create a baseline with:
+  check_ekf_timing.py --save baseline.txt LOG...
+then check against it with:
+  check_ekf_timing.py --baseline baseline.txt LOG...
+'''
+
+from __future__ import print_function
+
+import re
+import subprocess
+
+timing_re = re.compile(r'^(EKF[23]) (\w+) count=(\d+) mean_ns=(\d+) min_ns=(\d+) max_ns=(\d+)$')
+
+
+def run_replay(replay, logfile, progress=print):
+    '''run replay on one log, returning a dict of (ekf,step) -> (count,mean_ns)'''
+    progress("Replaying %s" % logfile)
+    output = subprocess.check_output([replay, '--ekf-timing', logfile], universal_newlines=True)
+    ret = {}
+    for line in output.splitlines():
+        m = timing_re.match(line.strip())
+        if m is None:
+            continue
+        count = int(m.group(3))
+        if count == 0:
+            continue
+        ret[(m.group(1), m.group(2))] = (count, int(m.group(4)))
+    return ret
+
+
+def combine(results):
+    '''combine per-log results weighting each mean by its call count'''
+    total = {}
+    for r in results:
+        for k, (count, mean_ns) in r.items():
+            (c, t) = total.get(k, (0, 0))
+            total[k] = (c + count, t + count * mean_ns)
+    return {k: (c, t // c) for k, (c, t) in total.items()}
+
+
+def load_baseline(filename):
+    ret = {}
+    with open(filename) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) != 3 or line.startswith('#'):
+                continue
+            ret[(fields[0], fields[1])] = int(fields[2])
+    return ret
+
+
+def save_baseline(filename, timings):
+    with open(filename, 'w') as f:
+        f.write("# EKF step mean_ns\n")
+        for (ekf, step) in sorted(timings.keys()):
+            f.write("%s %s %u\n" % (ekf, step, timings[(ekf, step)][1]))
+
+
+if __name__ == '__main__':
+    import sys
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--replay", default="build/sitl/tool/Replay", help="path to Replay binary")
+    parser.add_argument("--baseline", default=None, help="baseline file to check against")
+    parser.add_argument("--save", default=None, help="save results as a new baseline")
+    parser.add_argument("--tolerance", type=float, default=10.0, help="allowed slowdown in percent")
+    parser.add_argument("logs", metavar="LOG", nargs="+")
+
+    args = parser.parse_args()
+
+    timings = combine([run_replay(args.replay, f) for f in args.logs])
+    for (ekf, step) in sorted(timings.keys()):
+        (count, mean_ns) = timings[(ekf, step)]
+        print("%s %-28s %8u calls %8u ns" % (ekf, step, count, mean_ns))
+
+    if args.save is not None:
+        save_baseline(args.save, timings)
+
+    if args.baseline is None:
+        sys.exit(0)
+
+    failed = False
+    for k, base_ns in sorted(load_baseline(args.baseline).items()):
+        if k not in timings:
+            continue
+        mean_ns = timings[k][1]
+        change = 100.0 * (mean_ns - base_ns) / base_ns
+        if change > args.tolerance:
+            print("%s %s regressed by %.1f%% (%u ns -> %u ns)" % (k[0], k[1], change, base_ns, mean_ns))
+            failed = True
+
+    if failed:
+        print("FAILED")
+        sys.exit(1)
+    print("Passed")
+    sys.exit(0)
@@ -20,7 +20,7 @@ def check_log(logfile, progress=print, ekf2_only=False, ekf3_only=False, verbose
     mlog = mavutil.mavlink_connection(logfile)
 
     ek2_list = ['NKF1','NKF2','NKF3','NKF4','NKF5','NKF0','NKQ', 'NKY0', 'NKY1']
-    ek3_list = ['XKF1','XKF2','XKF3','XKF4','XKF0','XKFS','XKQ','XKFD','XKV1','XKV2','XKY0','XKY1']
+    ek3_list = ['XKF1','XKF2','XKF3','XKF4','XKF0','XKFS','XKQ','XKFD','XKV1','XKV2','XKY0','XKY1','XKCP']
     
     if ekf2_only:
         mlist = ek2_list
@@ -44,12 +44,14 @@ def check_log(logfile, progress=print, ekf2_only=False, ekf3_only=False, verbose
             counts[mtype] = 0
             base_counts[mtype] = 0
         core = m.C
+        # checkpoints are split over several messages
+        part = getattr(m, 'Seq', 0) if mtype == 'XKCP' else 0
         if core < 100:
-            base[mtype][core] = m
+            base[mtype][(core, part)] = m
             base_count += 1
             base_counts[mtype] += 1
             continue
-        mb = base[mtype][core-100]
+        mb = base[mtype][(core-100, part)]
         count += 1
         counts[mtype] += 1
         mismatch = False
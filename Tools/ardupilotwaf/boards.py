@@ -510,7 +510,7 @@ class sitl(Board):
         # embed any scripts from ROMFS/scripts
         if os.path.exists('ROMFS/scripts'):
             for f in os.listdir('ROMFS/scripts'):
-                if fnmatch.fnmatch(f, "*.lua"):
+                if fnmatch.fnmatch(f, "*.lua") or fnmatch.fnmatch(f, "*.luac"):
                     env.ROMFS_FILES += [('scripts/'+f,'ROMFS/scripts/'+f)]
 
         if len(env.ROMFS_FILES) > 0:
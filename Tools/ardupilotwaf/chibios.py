@@ -81,6 +81,7 @@ class set_default_parameters(Task.Task):
         from apj_tool import embedded_defaults
         defaults = embedded_defaults(self.inputs[0].abspath())
         if defaults.find():
+            defaults.binary = bool(self.env.DEFAULT_PARAMETERS_BINARY)
             defaults.set_file(abs_default_parameters)
             defaults.save()
 
@@ -355,6 +356,7 @@ def configure(cfg):
     if cfg.options.default_parameters:
         cfg.msg('Default parameters', cfg.options.default_parameters, color='YELLOW')
         env.DEFAULT_PARAMETERS = cfg.options.default_parameters
+    env.DEFAULT_PARAMETERS_BINARY = cfg.options.default_parameters_binary
 
     try:
         ret = generate_hwdef_h(env)
@@ -31,6 +31,7 @@ import balancebot
 import sailboat
 
 import examples
+import parallel
 from pysim import util
 from pymavlink import mavutil
 from pymavlink.generator import mavtemplate
@@ -39,6 +40,9 @@ from common import Test
 
 tester = None
 
+# (suite name, [parallel.TestCaseResult]) for each vehicle test step run
+junit_suites = []
+
 
 def buildlogs_dirpath():
     """Return BUILDLOGS directory path."""
@@ -395,7 +399,7 @@ suplementary_test_binary_map = {
 
 
 def run_specific_test(step, *args, **kwargs):
-    """Run a specific test."""
+    """Run a specific test, or a comma separated list of tests."""
     t = split_specific_test_step(step)
     if t is None:
         return []
@@ -406,14 +410,78 @@ def run_specific_test(step, *args, **kwargs):
     tester = tester_class(*args, **kwargs)
 
     print("Got %s" % str(tester))
+    available = {}
     for a in tester.tests():
         if not hasattr(a, 'name'):
             a = Test(a[0], a[1], a[2])
         print("Got %s" % (a.name))
-        if a.name == test:
-            return tester.run_tests([a])
-    print("Failed to find test %s on %s" % (test, testname))
-    sys.exit(1)
+        available[a.name] = a
+    to_run = []
+    for name in test.split(","):
+        if name not in available:
+            print("Failed to find test %s on %s" % (name, testname))
+            sys.exit(1)
+        to_run.append(available[name])
+    return tester.run_tests(to_run)
+
+
+def test_names(step):
+    """Return the names of the tests run by a vehicle test step."""
+    tester_class = tester_class_map[step]
+    ret = []
+    for a in tester_class("/bin/true", None).tests():
+        if hasattr(a, 'name'):
+            ret.append(a.name)
+        else:
+            ret.append(a[0])
+    return ret
+
+
+def test_timings_filepath():
+    """Where the duration of each test is kept between runs."""
+    return buildlogs_path("test-timings.json")
+
+
+def junit_suite_name(step):
+    """Suite name for a step, test.Copter.A,B is part of test.Copter."""
+    t = split_specific_test_step(step)
+    if t is None:
+        return step
+    return t[0]
+
+
+def shard_autotest_args():
+    """Options passed on to the autotest.py run of each shard."""
+    ret = []
+    if opts.speedup is not None:
+        ret.append("--speedup=%u" % opts.speedup)
+    if opts.frame is not None:
+        ret.append("--frame=%s" % opts.frame)
+    if opts.debug:
+        ret.append("--debug")
+    if opts.valgrind:
+        ret.append("--valgrind")
+    if opts.force_ahrs_type is not None:
+        ret.append("--force-ahrs-type=%s" % opts.force_ahrs_type)
+    if opts.show_test_timings:
+        ret.append("--show-test-timings")
+    if opts.sitl_snapshot:
+        ret.append("--sitl-snapshot")
+    if opts.timeout is not None:
+        ret.append("--timeout=%u" % opts.timeout)
+    return ret
+
+
+def run_sharded_step(step):
+    """Run the tests of a vehicle test step over several SITL instances."""
+    (passed, suites) = parallel.run_sharded(step,
+                                            test_names(step),
+                                            opts.parallel,
+                                            buildlogs_dirpath(),
+                                            test_timings_filepath(),
+                                            shard_autotest_args())
+    junit_suites.extend(suites)
+    return passed
 
 
 def run_step(step):
@@ -495,6 +563,8 @@ def run_step(step):
         opts.speedup = 1.0
     else:
         supplementary_binaries = []
+        if opts.parallel > 1 and step in tester_class_map:
+            return run_sharded_step(step)
     fly_opts = {
         "viewerip": opts.viewerip,
         "use_map": opts.map,
@@ -510,6 +580,8 @@ def run_step(step):
         "force_ahrs_type": opts.force_ahrs_type,
         "logs_dir": buildlogs_dirpath(),
         "sup_binaries": supplementary_binaries,
+        "instance": opts.instance,
+        "sitl_snapshot": opts.sitl_snapshot,
     }
     if opts.speedup is not None:
         fly_opts["speedup"] = opts.speedup
@@ -691,6 +763,7 @@ def write_fullresults():
 def run_tests(steps):
     """Run a list of steps."""
     global results
+    global tester
 
     corefiles = glob.glob("core*")
     if corefiles:
@@ -706,8 +779,12 @@ def run_tests(steps):
 
         t1 = time.time()
         print(">>>> RUNNING STEP: %s at %s" % (step, time.asctime()))
+        tester = None
         try:
             success = run_step(step)
+            if tester is not None:
+                junit_suites.append((junit_suite_name(step),
+                                     parallel.results_from_tester(tester)))
             testinstance = None
             if type(success) == tuple:
                 (success, testinstance) = success
@@ -735,7 +812,6 @@ def run_tests(steps):
                         '<span class="failed-text">FAILED</span>',
                         time.time() - t1)
 
-        global tester
         if tester is not None and tester.rc_thread is not None:
             if passed:
                 print("BAD: RC Thread still alive after run_step")
@@ -760,6 +836,14 @@ def run_tests(steps):
 
     write_fullresults()
 
+    if len(junit_suites):
+        parallel.update_test_timings(test_timings_filepath(), junit_suites)
+        junit_filepath = opts.junit
+        if junit_filepath is None and opts.parallel > 1:
+            junit_filepath = buildlogs_path("junit.xml")
+        if junit_filepath is not None:
+            parallel.write_junit(junit_filepath, junit_suites)
+
     return passed
 
 
@@ -830,6 +914,7 @@ if __name__ == "__main__":
         "e.g. autotest.py --debug --valgrind build.Rover test.Rover # test Rover under Valgrind\n"
         "e.g. autotest.py --debug --gdb build.Tracker test.Tracker # run Tracker under gdb\n"
         "e.g. autotest.py --debug --gdb build.Sub test.Sub.DiveManual # do specific Sub test\n"
+        "e.g. autotest.py --parallel=8 build.Copter test.Copter # test Copter on 8 SITL instances\n"
     )
     parser.add_option("--autotest-server",
                       action='store_true',
@@ -878,6 +963,10 @@ if __name__ == "__main__":
                       action='store_true',
                       default=False,
                       help='configure with --Werror')
+    parser.add_option("--junit",
+                      type='string',
+                      default=None,
+                      help='write junit xml results of vehicle tests to this file')
 
     group_build = optparse.OptionGroup(parser, "Build options")
     group_build.add_option("--no-configure",
@@ -917,6 +1006,18 @@ if __name__ == "__main__":
                          default=None,
                          type='int',
                          help='speedup to run the simulations at')
+    group_sim.add_option("--instance",
+                         default=0,
+                         type='int',
+                         help='SITL instance number; moves the SITL ports up by 10 per instance')
+    group_sim.add_option("--parallel",
+                         default=1,
+                         type='int',
+                         help='run the tests of each vehicle test step over this many SITL instances at once')
+    group_sim.add_option("--sitl-snapshot",
+                         default=False,
+                         action='store_true',
+                         help='start each test from a snapshot of SITL taken when first ready to arm')
     group_sim.add_option("--valgrind",
                          default=False,
                          action='store_true',
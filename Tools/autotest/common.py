@@ -14,6 +14,7 @@ import math
 import os
 import re
 import shutil
+import signal
 import sys
 import time
 import traceback
@@ -1209,7 +1210,9 @@ class AutoTest(ABC):
                  _show_test_timings=False,
                  logs_dir=None,
                  force_ahrs_type=None,
-                 sup_binaries=[]):
+                 sup_binaries=[],
+                 instance=0,
+                 sitl_snapshot=False):
 
         self.start_time = time.time()
         global __autotest__ # FIXME; make progress a non-staticmethod
@@ -1232,6 +1235,14 @@ class AutoTest(ABC):
         if self.speedup is None:
             self.speedup = self.default_speedup()
         self.sup_binaries = sup_binaries
+        # SITL instance number, so several testers can run at once
+        self.instance = instance
+        # start each test from a snapshot of the vehicle taken once it
+        # was ready to arm, rather than from where the last test left it
+        self.use_sitl_snapshot = sitl_snapshot
+        if self.valgrind or self.gdb or self.lldb or self.gdbserver:
+            self.use_sitl_snapshot = False
+        self.sitl_snapshot_taken = False
 
         self.mavproxy = None
         self._mavproxy = None  # for auto-cleanup on failed tests
@@ -1250,6 +1261,8 @@ class AutoTest(ABC):
         self.run_tests_called = False
         self._show_test_timings = _show_test_timings
         self.test_timings = dict()
+        # (name, description, passed, elapsed, exception, output filename)
+        self.test_results = []
         self.total_waiting_to_arm_time = 0
         self.waiting_to_arm_count = 0
         self.force_ahrs_type = force_ahrs_type
@@ -1341,13 +1354,18 @@ class AutoTest(ABC):
         """Allow subclasses to override SITL streamrate."""
         return 10
 
+    def adjust_ardupilot_port(self, port):
+        '''return the port SITL is using for port given our instance
+        number; SITL moves all its default ports up by 10 per instance'''
+        return port + 10 * self.instance
+
     def autotest_connection_string_to_ardupilot(self):
-        return "tcp:127.0.0.1:5760"
+        return "tcp:127.0.0.1:%u" % self.adjust_ardupilot_port(5760)
 
     def mavproxy_options(self):
         """Returns options to be passed to MAVProxy."""
         ret = [
-            '--sitl=127.0.0.1:5502',
+            '--sitl=127.0.0.1:%u' % self.adjust_ardupilot_port(5502),
             '--streamrate=%u' % self.sitl_streamrate(),
             '--target-system=%u' % self.sysid_thismav(),
             '--target-component=1',
@@ -2069,7 +2087,7 @@ class AutoTest(ABC):
 
         # we allow for no docs for replay messages, as these are not for end-users. They are
         # effectively binary blobs for replay
-        REPLAY_MSGS = ['RFRH', 'RFRF', 'REV2', 'RSO2', 'RWA2', 'REV3', 'RSO3', 'RWA3', 'RMGI',
+        REPLAY_MSGS = ['RFRH', 'RFRD', 'RFRF', 'REV2', 'RSO2', 'RWA2', 'REV3', 'RSO3', 'RWA3', 'RMGI',
                        'REY3', 'RFRN', 'RISH', 'RISI', 'RISJ', 'RBRH', 'RBRI', 'RRNH', 'RRNI',
                        'RGPH', 'RGPI', 'RGPJ', 'RASH', 'RASI', 'RBCH', 'RBCI', 'RVOH', 'RMGH',
                        'ROFH', 'REPH', 'REVH', 'RWOH', 'RBOH']
@@ -2197,6 +2215,35 @@ class AutoTest(ABC):
         self.expect_list_remove(self.sitl)
         util.pexpect_close(self.sitl)
         self.sitl = None
+        self.sitl_snapshot_taken = False
+
+    def sitl_snapshot(self):
+        '''have SITL keep a copy of the whole vehicle as it is now, for
+        sitl_restore_snapshot to return to'''
+        self.progress("Taking SITL snapshot")
+        os.kill(self.sitl.pid, signal.SIGUSR1)
+        self.sitl.expect("Snapshot taken", timeout=30)
+        self.sitl_snapshot_taken = True
+
+    def sitl_restore_snapshot(self):
+        '''return the vehicle to the state saved by sitl_snapshot. The
+        MAVLink connection stays up but the vehicle's clock goes back'''
+        self.progress("Restoring SITL snapshot")
+        os.kill(self.sitl.pid, signal.SIGUSR2)
+        self.sitl.expect("Snapshot restored", timeout=30)
+        self.last_heartbeat_time_ms = None
+        # empty mav to avoid getting timestamps from before the restore:
+        self.do_timesync_roundtrip(timeout_in_wallclock=True)
+        self.do_heartbeats(force=True)
+
+    def start_test_from_snapshot(self):
+        '''restore the snapshot, taking it first if this is the first
+        test run on this SITL'''
+        if self.sitl_snapshot_taken:
+            self.sitl_restore_snapshot()
+            return
+        self.wait_ready_to_arm()
+        self.sitl_snapshot()
 
     def close(self):
         """Tidy up after running all tests."""
@@ -3488,7 +3535,7 @@ class AutoTest(ABC):
     def rc_thread_main(self):
         chan16 = [1000] * 16
 
-        sitl_output = mavutil.mavudp("127.0.0.1:5501", input=False)
+        sitl_output = mavutil.mavudp("127.0.0.1:%u" % self.adjust_ardupilot_port(5501), input=False)
         buf = None
 
         while True:
@@ -5786,6 +5833,9 @@ Also, ignores heartbeats not from our target system'''
 
         tee = TeeBoth(test_output_filename, 'w', self.mavproxy_logfile)
 
+        if self.use_sitl_snapshot:
+            self.start_test_from_snapshot()
+
         start_num_message_hooks = len(self.mav.message_hooks)
 
         prettyname = "%s (%s)" % (name, desc)
@@ -5881,6 +5931,9 @@ Also, ignores heartbeats not from our target system'''
                           (prettyname, repr(ex), test_output_filename))
             if do_fail_list:
                 self.fail_list.append((prettyname, ex, test_output_filename))
+        if passed or do_fail_list:
+            # retried attempts which failed are not the final result
+            self.test_results.append((name, desc, passed, time.time() - start_time, ex, test_output_filename))
             if interact:
                 self.progress("Starting MAVProxy interaction as directed")
                 self.mavproxy.interact()
@@ -5933,6 +5986,7 @@ Also, ignores heartbeats not from our target system'''
         mavproxy = util.start_MAVProxy_SITL(
             self.vehicleinfo_key(),
             logfile=self.mavproxy_logfile,
+            master='tcp:127.0.0.1:%u' % self.adjust_ardupilot_port(5762),
             options=self.mavproxy_options(),
             pexpect_timeout=pexpect_timeout)
         mavproxy.expect(r'Telemetry log: (\S+)\r\n')
@@ -5965,6 +6019,7 @@ Also, ignores heartbeats not from our target system'''
             "speedup": self.speedup,
             "valgrind": self.valgrind,
             "wipe": True,
+            "instance": self.instance,
         }
         start_sitl_args.update(**sitl_args)
         if ("defaults_filepath" not in start_sitl_args or
@@ -0,0 +1,198 @@
+#!/usr/bin/env python
+
+'''
+Run the tests of a vehicle test suite spread over several SITL
+instances at once. Also reads and writes junit results of autotest
+runs.
+
+Each shard is a separate autotest.py run with its own SITL instance
+number (so its own TCP, RC and simulator ports) and its own working
+and buildlogs directory (so its own eeprom.bin, logs and terrain).
+Tests are given to shards longest first using how long each test took
+the last time it was run, and the junit results of the shards are
+merged into one testsuite for the step.
+
+AP_FLAKE8_CLEAN
+'''
+
+from __future__ import print_function
+import json
+import os
+import subprocess
+import sys
+import time
+import xml.etree.ElementTree as ET
+
+# how long to assume a test takes if it has never been timed
+DEFAULT_TEST_DURATION = 60.0
+
+
+class TestCaseResult(object):
+    '''result of one test within a suite'''
+
+    def __init__(self, name, elapsed, failure=None, output_filepath=None):
+        self.name = name
+        self.elapsed = elapsed
+        self.failure = failure
+        self.output_filepath = output_filepath
+
+
+def results_from_tester(tester):
+    '''convert the results recorded by an AutoTest to TestCaseResults'''
+    ret = []
+    for (name, desc, passed, elapsed, ex, output_filepath) in tester.test_results:
+        failure = None
+        if not passed:
+            failure = "%s (%s)" % (desc, repr(ex))
+        ret.append(TestCaseResult(name, elapsed, failure, output_filepath))
+    return ret
+
+
+def write_junit(filepath, suites):
+    '''write junit xml for suites, a list of (suite name, [TestCaseResult])'''
+    root = ET.Element('testsuites')
+    for (suite_name, cases) in suites:
+        suite = ET.SubElement(root, 'testsuite', {
+            'name': suite_name,
+            'tests': str(len(cases)),
+            'failures': str(len([c for c in cases if c.failure is not None])),
+            'time': "%.1f" % sum([c.elapsed for c in cases]),
+        })
+        for c in cases:
+            case = ET.SubElement(suite, 'testcase', {
+                'classname': suite_name,
+                'name': c.name,
+                'time': "%.1f" % c.elapsed,
+            })
+            if c.failure is not None:
+                failure = ET.SubElement(case, 'failure', {'message': c.failure})
+                if c.output_filepath is not None:
+                    failure.text = "see %s" % c.output_filepath
+    ET.ElementTree(root).write(filepath)
+
+
+def read_junit(filepath):
+    '''read back junit xml written by write_junit'''
+    suites = []
+    for suite in ET.parse(filepath).getroot().findall('testsuite'):
+        cases = []
+        for case in suite.findall('testcase'):
+            failure = case.find('failure')
+            message = None
+            output_filepath = None
+            if failure is not None:
+                message = failure.get('message')
+                if failure.text is not None and failure.text.startswith("see "):
+                    output_filepath = failure.text[4:]
+            cases.append(TestCaseResult(case.get('name'),
+                                        float(case.get('time')),
+                                        message,
+                                        output_filepath))
+        suites.append((suite.get('name'), cases))
+    return suites
+
+
+def load_test_timings(filepath):
+    '''return {suite name: {test name: seconds}} from a previous run'''
+    try:
+        with open(filepath) as f:
+            return json.load(f)
+    except (IOError, OSError, ValueError):
+        return {}
+
+
+def update_test_timings(filepath, suites):
+    '''record how long the tests in suites took for the next run'''
+    timings = load_test_timings(filepath)
+    for (suite_name, cases) in suites:
+        suite_timings = timings.setdefault(suite_name, {})
+        for c in cases:
+            suite_timings[c.name] = c.elapsed
+    with open(filepath, 'w') as f:
+        json.dump(timings, f, indent=1, sort_keys=True)
+
+
+def shard_tests(tests, timings, count):
+    '''split the test names in tests into count lists of about equal
+    total duration. Longest tests are placed first, each on the shard
+    with least work so far. Each shard keeps the suite's test order'''
+    known = [timings[t] for t in tests if t in timings]
+    if len(known):
+        default = sum(known) / len(known)
+    else:
+        default = DEFAULT_TEST_DURATION
+    durations = dict([(t, timings.get(t, default)) for t in tests])
+
+    shards = [[] for i in range(count)]
+    totals = [0.0] * count
+    for t in sorted(tests, key=lambda t: durations[t], reverse=True):
+        i = totals.index(min(totals))
+        shards[i].append(t)
+        totals[i] += durations[t]
+
+    order = dict([(tests[i], i) for i in range(len(tests))])
+    ret = []
+    for i in range(count):
+        if len(shards[i]):
+            ret.append((sorted(shards[i], key=lambda t: order[t]), totals[i]))
+    return ret
+
+
+def run_sharded(step, tests, jobs, buildlogs_dirpath, timings_filepath, autotest_args):
+    '''run the named tests of step spread over jobs SITL instances.
+    autotest_args are passed to each autotest.py shard. Returns
+    (passed, [(step, [TestCaseResult])])'''
+    timings = load_test_timings(timings_filepath).get(step, {})
+    shards = shard_tests(tests, timings, jobs)
+
+    autotest = os.path.join(os.path.dirname(os.path.realpath(__file__)), 'autotest.py')
+    procs = []
+    for i in range(len(shards)):
+        (shard, expected_time) = shards[i]
+        instance = i + 1
+        shard_dir = os.path.join(buildlogs_dirpath, "%s-shard%u" % (step, instance))
+        if not os.path.exists(shard_dir):
+            os.makedirs(shard_dir)
+        junit_filepath = os.path.join(shard_dir, "junit.xml")
+        if os.path.exists(junit_filepath):
+            os.unlink(junit_filepath)
+        output_filepath = os.path.join(shard_dir, "autotest-output.txt")
+        cmd = [sys.executable, autotest,
+               "--instance=%u" % instance,
+               "--junit=%s" % junit_filepath]
+        cmd.extend(autotest_args)
+        cmd.append("%s.%s" % (step, ",".join(shard)))
+        env = dict(os.environ)
+        env["BUILDLOGS"] = shard_dir
+        print("Shard %u: %u tests, about %.0fs, output in %s" %
+              (instance, len(shard), expected_time, output_filepath))
+        output = open(output_filepath, 'w')
+        p = subprocess.Popen(cmd, cwd=shard_dir, env=env, stdout=output, stderr=subprocess.STDOUT)
+        procs.append((instance, shard, p, output, junit_filepath, output_filepath))
+
+    passed = True
+    cases = {}
+    for (instance, shard, p, output, junit_filepath, output_filepath) in procs:
+        tstart = time.time()
+        p.wait()
+        output.close()
+        print("Shard %u finished with exit code %d (waited %.0fs)" %
+              (instance, p.returncode, time.time() - tstart))
+        if p.returncode != 0:
+            passed = False
+        if os.path.exists(junit_filepath):
+            for (suite_name, suite_cases) in read_junit(junit_filepath):
+                for c in suite_cases:
+                    cases[c.name] = c
+        # a shard which died part way through leaves tests unreported
+        for t in shard:
+            if t not in cases:
+                passed = False
+                cases[t] = TestCaseResult(t, 0, "no result from shard %u" % instance, output_filepath)
+
+    for c in cases.values():
+        if c.failure is not None:
+            passed = False
+            print("  FAILED %s: %s" % (c.name, c.failure))
+
+    return (passed, [(step, [cases[t] for t in tests])])
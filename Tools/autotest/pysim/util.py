@@ -291,7 +291,8 @@ def start_SITL(binary,
                disable_breakpoints=False,
                customisations=[],
                lldb=False,
-               supplementary=False):
+               supplementary=False,
+               instance=0):
 
     if model is None and not supplementary:
         raise ValueError("model must not be None")
@@ -365,6 +366,10 @@ def start_SITL(binary,
             raise RuntimeError("DISPLAY was not set")
 
     cmd.append(binary)
+    if instance != 0:
+        # offsets the TCP, RC and simulator ports by 10 per instance;
+        # must come before any explicit port options
+        cmd.extend(['-I', str(instance)])
     if not supplementary:
         if wipe:
             cmd.append('-w')
@@ -616,7 +616,7 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
 
     def test_setting_modes_via_mavproxy_switch(self):
         self.customise_SITL_commandline([
-            "--rc-in-port", "5502",
+            "--rc-in-port", str(self.adjust_ardupilot_port(5502)),
         ])
         ex = None
         try:
@@ -3058,7 +3058,7 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
             self.progress("ensure a mavlink1 connection can't do anything useful with new item types")
             self.set_parameter("SERIAL2_PROTOCOL", 1)
             self.reboot_sitl()
-            mav2 = mavutil.mavlink_connection("tcp:localhost:5763",
+            mav2 = mavutil.mavlink_connection("tcp:localhost:%u" % self.adjust_ardupilot_port(5763),
                                               robust_parsing=True,
                                               source_system=7,
                                               source_component=7)
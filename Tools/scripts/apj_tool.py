@@ -14,6 +14,14 @@ def to_ascii(s):
     else:
         return str(s)
 
+# the binary form of the defaults from AP_Param.h: a header, then
+# entries of name, value and flags sorted by name
+BIN_MARKER = b'\x00PDB'
+BIN_HEADER = '<4sH'
+BIN_ENTRY = '<16sfB'
+BIN_READONLY = 1
+MAX_NAME_SIZE = 16
+
 def to_bytes(s):
     '''get bytes string'''
     if sys.version_info.major >= 3:
@@ -31,6 +39,7 @@ class embedded_defaults(object):
         self.filename = filename
         self.offset = 0
         self.max_len = 0
+        self.binary = False
         self.extension = os.path.splitext(filename)[1]
         if self.extension.lower() in ['.apj', '.px4']:
             self.load_apj()
@@ -125,17 +134,67 @@ class embedded_defaults(object):
                 continue
             self.offset += i
             self.max_len, self.length = struct.unpack("<HH", self.firmware[self.offset+16:self.offset+20])
+            self.binary = self.raw_contents().startswith(BIN_MARKER)
             return True
-    
+
+    def raw_contents(self):
+        '''return current contents as stored in the firmware'''
+        return self.firmware[self.offset+20:self.offset+20+self.length]
+
     def contents(self):
         '''return current contents'''
-        contents = self.firmware[self.offset+20:self.offset+20+self.length]
+        contents = self.raw_contents()
+        if contents.startswith(BIN_MARKER):
+            return self.decode_binary(contents)
         # remove carriage returns
         contents = contents.replace(b'\r',b'')
         return contents
 
+    def encode_binary(self, contents):
+        '''convert defaults text to the binary table'''
+        defaults = {}
+        for line in to_bytes(contents).split(b'\n'):
+            if line.startswith(b'#'):
+                continue
+            a = self.split_multi(line, b", =\t\r")
+            if len(a) < 2:
+                continue
+            name = a[0].upper()
+            if len(name) > MAX_NAME_SIZE:
+                print("Warning: Ignoring long param name %s" % to_ascii(name))
+                continue
+            flags = BIN_READONLY if len(a) > 2 and a[2] == b'@READONLY' else 0
+            # later lines win, as they do when the text is loaded
+            try:
+                value = float(a[1])
+            except ValueError:
+                value = float(int(a[1], 0))
+            defaults[name] = (value, flags)
+        ret = struct.pack(BIN_HEADER, BIN_MARKER, len(defaults))
+        for name in sorted(defaults.keys()):
+            (value, flags) = defaults[name]
+            ret += struct.pack(BIN_ENTRY, name, value, flags)
+        return ret
+
+    def decode_binary(self, contents):
+        '''convert the binary table to defaults text'''
+        (marker, count) = struct.unpack(BIN_HEADER, contents[:6])
+        hdr_len = struct.calcsize(BIN_HEADER)
+        entry_len = struct.calcsize(BIN_ENTRY)
+        lines = []
+        for i in range(count):
+            ofs = hdr_len + i * entry_len
+            (name, value, flags) = struct.unpack(BIN_ENTRY, contents[ofs:ofs+entry_len])
+            line = b'%s=%s' % (name.rstrip(b'\x00'), to_bytes('%.8g' % value))
+            if flags & BIN_READONLY:
+                line += b' @READONLY'
+            lines.append(line)
+        return b'\n'.join(lines) + b'\n'
+
     def set_contents(self, contents):
         '''set new defaults as a string'''
+        if self.binary:
+            contents = self.encode_binary(contents)
         length = len(contents)
         if length > self.max_len:
             print("Error: Length %u larger than maximum %u" % (length, self.max_len))
@@ -224,6 +283,7 @@ if __name__ == '__main__':
     parser.add_argument('--set', type=str, default=None, help='replace one parameter default, in form NAME=VALUE')
     parser.add_argument('--show', action='store_true', default=False, help='show current parameter defaults')
     parser.add_argument('--extract', action='store_true', default=False, help='extract firmware image to *.bin')
+    parser.add_argument('--binary', action='store_true', default=False, help='store parameter defaults as a binary table, which is faster to load at boot')
 
     args = parser.parse_args()
 
@@ -233,7 +293,14 @@ if __name__ == '__main__':
         print("Error: Param defaults support not found in firmware")
         sys.exit(1)
     
-    print("Found param defaults max_length=%u length=%u" % (defaults.max_len, defaults.length))
+    print("Found param defaults max_length=%u length=%u binary=%s" % (defaults.max_len, defaults.length, defaults.binary))
+
+    if args.binary and not defaults.binary:
+        # convert the current defaults, and store any new ones as binary
+        defaults.binary = True
+        if not args.set_file and not args.set:
+            defaults.set_contents(defaults.contents())
+            defaults.save()
 
     if args.set_file:
         # load new defaults from a file
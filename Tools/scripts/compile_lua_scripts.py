@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+
+"""
+precompile Lua scripts to bytecode for AP_Scripting
+
+Builds a host luac from the Lua sources in libraries/AP_Scripting with
+the same number configuration as the firmware (LUA_32BITS) and uses it
+to compile each script to a .luac alongside it, or into --outdir.
+Precompiled scripts skip the parser at boot, which saves both startup
+time and the parser's heap use.
+
+Bytecode is only accepted by a build with the same sizes as the luac
+that made it. Flight controllers are 32 bit, so by default luac is
+built with -m32, which needs a multilib host compiler. Use --native
+for scripts to be run in SITL on the build machine.
+
+example:
+  ./Tools/scripts/compile_lua_scripts.py --outdir ROMFS/scripts myscripts/*.lua
+
+AP_FLAKE8_CLEAN
+"""
+
+import glob
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from argparse import ArgumentParser
+
+lua_src = os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                       '..', '..', 'libraries', 'AP_Scripting', 'lua', 'src')
+
+# the firmware replaces luaL_newstate with its own allocator, luac
+# needs one from the C library
+newstate_shim = '''
+#include <stdlib.h>
+#include "lauxlib.h"
+
+static void *l_alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+    (void)ud; (void)osize;
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, nsize);
+}
+
+lua_State *luaL_newstate(void) {
+    return lua_newstate(l_alloc, NULL);
+}
+'''
+
+
+def build_luac(builddir, cc, native):
+    '''build luac in builddir, returning its path'''
+    # the firmware Lua reads files through AP_Filesystem, luac uses stdio
+    incdir = os.path.join(builddir, 'include')
+    os.makedirs(os.path.join(incdir, 'AP_Filesystem'))
+    open(os.path.join(incdir, 'AP_Filesystem', 'posix_compat.h'), 'w').close()
+    shim = os.path.join(builddir, 'newstate.c')
+    with open(shim, 'w') as f:
+        f.write(newstate_shim)
+
+    sources = [s for s in glob.glob(os.path.join(lua_src, '*.c')) if os.path.basename(s) != 'lua.c']
+    luac = os.path.join(builddir, 'luac')
+    cmd = [cc, '-std=gnu99', '-O2', '-DLUA_32BITS', '-I', incdir, '-I', lua_src, '-o', luac, shim]
+    if not native:
+        cmd.append('-m32')
+    cmd.extend(sorted(sources))
+    cmd.append('-lm')
+    if subprocess.call(cmd) != 0:
+        print("Failed to build luac: %s" % ' '.join(cmd))
+        if not native:
+            print("A 32 bit host compiler is needed, eg. gcc-multilib, or use --native for SITL")
+        sys.exit(1)
+    return luac
+
+
+def compile_script(luac, script, outdir, strip):
+    '''compile one script, returning the output file name'''
+    base = os.path.splitext(os.path.basename(script))[0] + '.luac'
+    out = os.path.join(outdir if outdir is not None else os.path.dirname(script), base)
+    cmd = [luac, '-o', out]
+    if strip:
+        cmd.append('-s')
+    cmd.append(script)
+    if subprocess.call(cmd) != 0:
+        print("Failed to compile %s" % script)
+        sys.exit(1)
+    return out
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--outdir", default=None, help="directory to write .luac files to, default is alongside the scripts")
+    parser.add_argument("--native", action='store_true', help="build for SITL on this machine rather than a 32 bit flight controller")
+    parser.add_argument("--no-strip", action='store_true', help="keep debug information, for line numbers in errors")
+    parser.add_argument("--cc", default="gcc", help="host C compiler")
+    parser.add_argument("scripts", metavar="SCRIPT", nargs="+", help="Lua scripts to compile")
+    args = parser.parse_args()
+
+    if args.outdir is not None and not os.path.isdir(args.outdir):
+        os.makedirs(args.outdir)
+
+    builddir = tempfile.mkdtemp(prefix='luac_')
+    try:
+        luac = build_luac(builddir, args.cc, args.native)
+        for script in args.scripts:
+            out = compile_script(luac, script, args.outdir, not args.no_strip)
+            print("%s -> %s (%u bytes)" % (script, out, os.path.getsize(out)))
+    finally:
+        shutil.rmtree(builddir, ignore_errors=True)
@@ -0,0 +1,197 @@
+#!/usr/bin/env python
+
+'''
+Build a ChibiOS board once as normal and then once with each optional
+feature turned off, and report what each feature costs in flash and
+RAM, in total and per library.
+
+Features are the HAL_*_ENABLED and AP_*_ENABLED defines that libraries
+guard with #ifndef, or a list given with --feature. Each one is turned
+off with an extra hwdef file containing "undef X" and "define X 0", so
+this only works for boards built from hwdef.dat.
+
+Example:
+  ./Tools/scripts/feature_costs.py --board MatekF405 --vehicle copter \
+      --feature HAL_MOUNT_ENABLED --feature HAL_PROXIMITY_ENABLED
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.realpath(os.path.join(os.path.dirname(os.path.realpath(__file__)), '../..'))
+
+# waf target -> binary name
+VEHICLES = {
+    'copter': 'arducopter',
+    'heli': 'arducopter-heli',
+    'plane': 'arduplane',
+    'rover': 'ardurover',
+    'sub': 'ardusub',
+    'antennatracker': 'antennatracker',
+    'AP_Periph': 'AP_Periph',
+}
+
+FEATURE_RE = re.compile(r'^\s*#\s*ifndef\s+((?:HAL|AP)_\w+_ENABLED)\s*$')
+LIBRARY_RE = re.compile(r'libraries/(\w+)/')
+
+
+def progress(msg):
+    print("feature_costs: %s" % msg)
+    sys.stdout.flush()
+
+
+def find_features():
+    '''find the features libraries allow to be turned off'''
+    features = set()
+    for dirpath, dirnames, filenames in os.walk(os.path.join(ROOT, 'libraries')):
+        if 'AP_HAL_ChibiOS' in dirpath or '/tests' in dirpath or '/examples' in dirpath:
+            continue
+        for f in filenames:
+            if not f.endswith('.h'):
+                continue
+            with open(os.path.join(dirpath, f), errors='ignore') as h:
+                for line in h:
+                    m = FEATURE_RE.match(line)
+                    if m is not None:
+                        features.add(m.group(1))
+    return sorted(features)
+
+
+def run(cmd):
+    progress("Running (%s)" % " ".join(cmd))
+    return subprocess.call(cmd, cwd=ROOT) == 0
+
+
+def build(board, vehicle, extra_hwdef, jobs):
+    '''configure and build, returning True on success'''
+    cmd = ['./waf', 'configure', '--board', board]
+    if extra_hwdef is not None:
+        cmd.extend(['--extra-hwdef', extra_hwdef])
+    if not run(cmd):
+        return False
+    cmd = ['./waf', vehicle]
+    if jobs is not None:
+        cmd.extend(['-j', str(jobs)])
+    return run(cmd)
+
+
+def elf_path(board, vehicle):
+    return os.path.join(ROOT, 'build', board, 'bin', VEHICLES[vehicle])
+
+
+def total_sizes(elf):
+    '''return (flash, ram) in bytes'''
+    out = subprocess.check_output(['arm-none-eabi-size', elf], universal_newlines=True)
+    (text, data, bss) = [int(x) for x in out.splitlines()[1].split()[0:3]]
+    return (text + data, data + bss)
+
+
+def library_sizes(elf):
+    '''return {library: [flash, ram]} from the symbol sizes and their source file'''
+    out = subprocess.check_output(['arm-none-eabi-nm', '--size-sort', '-S', '-l', elf],
+                                  universal_newlines=True)
+    ret = {}
+    for line in out.splitlines():
+        a = line.split()
+        if len(a) < 4:
+            continue
+        size = int(a[1], 16)
+        stype = a[2].lower()
+        m = LIBRARY_RE.search(a[-1]) if len(a) > 4 else None
+        lib = m.group(1) if m is not None else 'other'
+        if lib not in ret:
+            ret[lib] = [0, 0]
+        if stype in ('t', 'r', 'w'):
+            ret[lib][0] += size
+        elif stype == 'd':
+            ret[lib][0] += size
+            ret[lib][1] += size
+        elif stype == 'b':
+            ret[lib][1] += size
+    return ret
+
+
+def measure(board, vehicle):
+    elf = elf_path(board, vehicle)
+    return (total_sizes(elf), library_sizes(elf))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='report the flash and RAM cost of optional features')
+    parser.add_argument('--board', required=True, help='ChibiOS board to build')
+    parser.add_argument('--vehicle', default='copter', choices=sorted(VEHICLES.keys()), help='vehicle to build')
+    parser.add_argument('--feature', action='append', default=[], help='feature define to test, default all')
+    parser.add_argument('--jobs', type=int, default=None, help='parallel build jobs')
+    parser.add_argument('--min-delta', type=int, default=64,
+                        help='smallest per library change in bytes to report')
+    parser.add_argument('--csv', default='feature_costs.csv', help='CSV output file')
+    args = parser.parse_args()
+
+    features = args.feature if len(args.feature) else find_features()
+    progress("Testing %u features on %s %s" % (len(features), args.board, args.vehicle))
+
+    if not build(args.board, args.vehicle, None, args.jobs):
+        progress("Baseline build failed")
+        sys.exit(1)
+    (base_total, base_libs) = measure(args.board, args.vehicle)
+
+    results = []
+    for feature in features:
+        with tempfile.NamedTemporaryFile(mode='w', suffix='.dat', delete=False) as f:
+            f.write("undef %s\ndefine %s 0\n" % (feature, feature))
+            extra_hwdef = f.name
+        try:
+            ok = build(args.board, args.vehicle, extra_hwdef, args.jobs)
+        finally:
+            os.unlink(extra_hwdef)
+        if not ok:
+            progress("Build without %s failed" % feature)
+            results.append((feature, None, None, {}))
+            continue
+        (total, libs) = measure(args.board, args.vehicle)
+        lib_deltas = {}
+        for lib in set(base_libs.keys()) | set(libs.keys()):
+            (bflash, bram) = base_libs.get(lib, [0, 0])
+            (flash, ram) = libs.get(lib, [0, 0])
+            if abs(bflash - flash) >= args.min_delta or abs(bram - ram) >= args.min_delta:
+                lib_deltas[lib] = (bflash - flash, bram - ram)
+        results.append((feature, base_total[0] - total[0], base_total[1] - total[1], lib_deltas))
+
+    # restore the normal configuration
+    run(['./waf', 'configure', '--board', args.board])
+
+    results.sort(key=lambda r: -1 if r[1] is None else r[1], reverse=True)
+    with open(args.csv, 'w') as f:
+        writer = csv.writer(f)
+        writer.writerow(['feature', 'library', 'flash', 'ram'])
+        for (feature, flash, ram, lib_deltas) in results:
+            if flash is None:
+                writer.writerow([feature, 'BUILD_FAILED', '', ''])
+                continue
+            writer.writerow([feature, 'TOTAL', flash, ram])
+            for lib in sorted(lib_deltas.keys(), key=lambda x: -lib_deltas[x][0]):
+                writer.writerow([feature, lib, lib_deltas[lib][0], lib_deltas[lib][1]])
+
+    print("")
+    print("Saving by turning off each feature on %s %s (flash %u RAM %u)" % (
+        args.board, args.vehicle, base_total[0], base_total[1]))
+    print("%-45s %8s %8s  %s" % ("Feature", "Flash", "RAM", "Largest libraries"))
+    for (feature, flash, ram, lib_deltas) in results:
+        if flash is None:
+            print("%-45s %8s %8s" % (feature, "FAILED", ""))
+            continue
+        libs = sorted(lib_deltas.keys(), key=lambda x: -lib_deltas[x][0])[:3]
+        print("%-45s %8d %8d  %s" % (feature, flash, ram,
+                                       " ".join(["%s:%d" % (x, lib_deltas[x][0]) for x in libs])))
+    progress("Wrote %s" % args.csv)
+
+
+if __name__ == '__main__':
+    main()
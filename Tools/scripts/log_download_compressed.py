@@ -0,0 +1,128 @@
+#!/usr/bin/env python
+'''
+download a log over MAVLink using compressed log transfer
+
+the vehicle sends LZ4 compressed blocks when the log id in
+LOG_REQUEST_DATA has the top bit set. See AP_Logger.h for the format
+'''
+
+import struct
+import sys
+import time
+
+from argparse import ArgumentParser
+parser = ArgumentParser(description=__doc__)
+parser.add_argument("--device", default="udp:127.0.0.1:14550", help="MAVLink connection")
+parser.add_argument("--timeout", type=float, default=2.0, help="retry timeout in seconds")
+parser.add_argument("log_id", type=int, help="log number to download")
+parser.add_argument("output", help="output filename")
+
+args = parser.parse_args()
+
+from pymavlink import mavutil
+
+COMPRESSED_FLAG = 0x8000
+BLOCK_STORED = 0x8000
+
+
+def lz4_block_decompress(src, raw_len):
+    '''decode one LZ4 block'''
+    out = bytearray()
+    i = 0
+    while i < len(src):
+        token = src[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = src[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        out += src[i:i+lit]
+        i += lit
+        if i >= len(src):
+            break
+        offset = src[i] | (src[i+1] << 8)
+        i += 2
+        match_len = token & 0xF
+        if match_len == 15:
+            while True:
+                b = src[i]
+                i += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += 4
+        start = len(out) - offset
+        for k in range(match_len):
+            out.append(out[start+k])
+    if len(out) != raw_len:
+        raise ValueError("bad block length %u expected %u" % (len(out), raw_len))
+    return out
+
+
+def decode_block(block):
+    '''decode a block, returning the raw data'''
+    (header,) = struct.unpack("<H", block[0:2])
+    raw_len = header & ~BLOCK_STORED
+    if header & BLOCK_STORED:
+        return bytearray(block[2:2+raw_len])
+    return lz4_block_decompress(block[2:], raw_len)
+
+
+mav = mavutil.mavlink_connection(args.device)
+mav.wait_heartbeat()
+
+out = bytearray()
+compressed_bytes = 0
+block = bytearray()
+next_chunk = 0
+t_start = time.time()
+
+
+def request(ofs):
+    mav.mav.log_request_data_send(mav.target_system, mav.target_component,
+                                  args.log_id | COMPRESSED_FLAG, ofs, 0xFFFFFFFF)
+
+
+request(0)
+last_rx = time.time()
+done = False
+while not done:
+    m = mav.recv_match(type='LOG_DATA', blocking=True, timeout=0.5)
+    if m is None:
+        if time.time() - last_rx > args.timeout:
+            # restart from the start of the block we were receiving
+            block = bytearray()
+            next_chunk = 0
+            request(len(out))
+            last_rx = time.time()
+        continue
+    if m.id != args.log_id | COMPRESSED_FLAG or m.ofs != len(out) or m.count == 0:
+        continue
+    last_rx = time.time()
+    data = bytearray(m.data[:m.count])
+    seq = data[0] & 0x7F
+    if seq != next_chunk:
+        # lost a chunk, ask for the block again
+        block = bytearray()
+        next_chunk = 0
+        request(len(out))
+        continue
+    block += data[1:]
+    compressed_bytes += len(data)
+    next_chunk += 1
+    if data[0] & 0x80:
+        raw = decode_block(block)
+        if len(raw) == 0:
+            done = True
+        out += raw
+        block = bytearray()
+        next_chunk = 0
+
+mav.mav.log_request_end_send(mav.target_system, mav.target_component)
+open(args.output, 'wb').write(out)
+dt = time.time() - t_start
+print("Downloaded %u bytes (%u compressed) in %.1fs" % (len(out), compressed_bytes, dt))
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+'''
+expand CMPT compact records in a dataflash log back into normal
+records, so the log can be read by tools that don't understand them
+'''
+
+import struct
+import sys
+
+from argparse import ArgumentParser
+parser = ArgumentParser(description=__doc__)
+parser.add_argument("input", metavar="LOG")
+parser.add_argument("output", metavar="OUTPUT")
+
+args = parser.parse_args()
+
+HEAD1 = 0xA3
+HEAD2 = 0x95
+FMT_TYPE = 0x80
+FMT_LEN = 89
+
+# field type to (length, signed, kind)
+field_info = {
+    'b': (1, True, 'int'), 'h': (2, True, 'int'), 'c': (2, True, 'int'),
+    'i': (4, True, 'int'), 'e': (4, True, 'int'), 'L': (4, True, 'int'),
+    'q': (8, True, 'int'),
+    'B': (1, False, 'int'), 'M': (1, False, 'int'), 'H': (2, False, 'int'),
+    'C': (2, False, 'int'), 'I': (4, False, 'int'), 'E': (4, False, 'int'),
+    'Q': (8, False, 'int'),
+    'f': (4, False, 'bits'), 'd': (8, False, 'bits'),
+    'n': (4, False, 'bytes'), 'N': (16, False, 'bytes'),
+    'Z': (64, False, 'bytes'), 'a': (64, False, 'bytes'),
+}
+
+
+def get_varint(data, ofs):
+    v = 0
+    shift = 0
+    while True:
+        b = data[ofs]
+        ofs += 1
+        v |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return v, ofs
+
+
+def to_signed(v, bits):
+    if v & (1 << (bits-1)):
+        v -= 1 << bits
+    return v
+
+
+def decode_records(fmt, msg_type, count, data):
+    '''decode count records of the given format, returning raw messages'''
+    prev = {}
+    ofs = 0
+    out = bytearray()
+    for _ in range(count):
+        rec = bytearray([HEAD1, HEAD2, msg_type])
+        for i, c in enumerate(fmt):
+            (flen, signed, kind) = field_info[c]
+            bits = flen * 8
+            mask = (1 << bits) - 1
+            if kind == 'bytes':
+                value = bytes(data[ofs:ofs+flen])
+                ofs += flen
+                rec += value
+            elif kind == 'bits':
+                v, ofs = get_varint(data, ofs)
+                value = v ^ prev.get(i, 0)
+                rec += struct.pack("<Q", value)[:flen]
+            else:
+                zz, ofs = get_varint(data, ofs)
+                delta = (zz >> 1) ^ -(zz & 1)
+                if signed:
+                    value = to_signed((to_signed(prev.get(i, 0) & mask, bits) + delta) & mask, bits)
+                else:
+                    value = (prev.get(i, 0) + delta) & mask
+                rec += struct.pack("<Q", value & mask)[:flen]
+            prev[i] = value
+        out += rec
+    return out
+
+
+data = open(args.input, 'rb').read()
+out = open(args.output, 'wb')
+# message type to (length, name, format)
+formats = {FMT_TYPE: (FMT_LEN, 'FMT', 'BBnNZ')}
+compact_type = None
+ofs = 0
+expanded = 0
+
+while ofs + 3 <= len(data):
+    if data[ofs] != HEAD1 or data[ofs+1] != HEAD2:
+        ofs += 1
+        continue
+    mtype = data[ofs+2]
+    if mtype not in formats:
+        ofs += 1
+        continue
+    (mlen, name, fmt) = formats[mtype]
+    msg = data[ofs:ofs+mlen]
+    if len(msg) < mlen:
+        break
+    ofs += mlen
+    if mtype == FMT_TYPE:
+        (ftype, flen, fname, fformat) = struct.unpack("<BB4s16s", msg[3:25])
+        fname = fname.rstrip(b'\0').decode('ascii')
+        fformat = fformat.rstrip(b'\0').decode('ascii')
+        formats[ftype] = (flen, fname, fformat)
+        if fname == 'CMPT':
+            compact_type = ftype
+    if mtype == compact_type:
+        (rtype, count, used) = struct.unpack("<BBB", msg[3:6])
+        if rtype in formats:
+            out.write(decode_records(formats[rtype][2], rtype, count, msg[6:6+used]))
+            expanded += count
+        continue
+    out.write(msg)
+
+out.close()
+print("Expanded %u compact records" % expanded)
@@ -15,15 +15,20 @@ data = open(args.file,'rb').read()
 last_name = ""
 
 magic = 0x671b
+magic_crc = 0x671c
 
-# header of 6 bytes
+# header of 6 bytes, or 10 with a crc for a since= download
 magic2,num_params,total_params = struct.unpack("<HHH", data[0:6])
-if magic != magic2:
+if magic2 == magic_crc:
+    crc, = struct.unpack("<I", data[6:10])
+    print("CRC %u" % crc)
+    data = data[10:]
+elif magic2 == magic:
+    data = data[6:]
+else:
     print("Bad magic 0x%x expected 0x%x" % (magic2, magic))
     sys.exit(1)
 
-data = data[6:]
-
 # mapping of data type to type length and format
 data_types = {
     1: (1, 'b'),
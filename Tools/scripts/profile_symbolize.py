@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+
+'''
+Turn a @SYS/profile.txt from a ChibiOS board built with
+HAL_PROFILER_ENABLED into a list of the functions the CPU spent its
+time in, using the ELF file of the firmware that was running.
+
+Fetch the profile over MAVLink FTP, for example from MAVProxy with
+  ftp get @SYS/profile.txt profile.txt
+and then run
+  ./Tools/scripts/profile_symbolize.py build/MatekH743/bin/arducopter profile.txt
+
+Several profile files can be given and are added together.
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import subprocess
+import sys
+
+
+def parse_profile(fname, samples, totals):
+    '''add the (pc, thread) counts in fname to samples'''
+    with open(fname) as f:
+        header = f.readline().split()
+        if len(header) == 0 or header[0] != 'ProfileV1':
+            print("%s is not a profile.txt file" % fname)
+            sys.exit(1)
+        for field in header[1:]:
+            (name, value) = field.split('=')
+            totals[name] = totals.get(name, 0) + int(value)
+        for line in f:
+            a = line.split(None, 2)
+            if len(a) != 3:
+                continue
+            key = (int(a[1], 16), a[2].strip())
+            samples[key] = samples.get(key, 0) + int(a[0])
+
+
+def symbolize(elf, addresses, addr2line):
+    '''return {address: (function, file:line)}'''
+    addresses = sorted(addresses)
+    proc = subprocess.run([addr2line, '-f', '-C', '-e', elf],
+                          input='\n'.join(['0x%08x' % a for a in addresses]) + '\n',
+                          stdout=subprocess.PIPE, universal_newlines=True, check=True)
+    lines = proc.stdout.splitlines()
+    ret = {}
+    for i in range(len(addresses)):
+        ret[addresses[i]] = (lines[2*i], lines[2*i+1])
+    return ret
+
+
+def main():
+    parser = argparse.ArgumentParser(description='symbolize a ChibiOS PC sampling profile')
+    parser.add_argument('elf', help='ELF file of the firmware that was profiled')
+    parser.add_argument('profile', nargs='+', help='profile.txt files')
+    parser.add_argument('--by', choices=['function', 'line', 'thread'], default='function',
+                        help='what to group the samples by')
+    parser.add_argument('--thread', default=None, help='only count samples from this thread')
+    parser.add_argument('--per-thread', action='store_true', help='keep each thread separate')
+    parser.add_argument('--top', type=int, default=40, help='number of entries to show, 0 for all')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line', help='addr2line to use')
+    args = parser.parse_args()
+
+    samples = {}
+    totals = {}
+    for fname in args.profile:
+        parse_profile(fname, samples, totals)
+    if args.thread is not None:
+        samples = {k: v for (k, v) in samples.items() if k[1] == args.thread}
+
+    symbols = symbolize(args.elf, set([k[0] for k in samples.keys()]), args.addr2line)
+
+    groups = {}
+    for ((pc, thread), count) in samples.items():
+        (function, line) = symbols[pc]
+        if args.by == 'function':
+            key = function
+        elif args.by == 'line':
+            key = "%s %s" % (function, line)
+        else:
+            key = thread
+        if args.per_thread and args.by != 'thread':
+            key = "%-14s %s" % (thread, key)
+        groups[key] = groups.get(key, 0) + count
+
+    total = totals.get('SAMPLES', 0)
+    if total == 0:
+        print("No samples")
+        return
+    print("%u samples over %.1fs, %.1f%% in other interrupts, %.1f%% dropped" % (
+        total, totals.get('TIME_MS', 0) * 0.001,
+        100.0 * totals.get('ISR', 0) / total,
+        100.0 * totals.get('DROPPED', 0) / total))
+    keys = sorted(groups.keys(), key=lambda k: groups[k], reverse=True)
+    if args.top > 0:
+        keys = keys[:args.top]
+    for k in keys:
+        print("%6.2f%% %7u  %s" % (100.0 * groups[k] / total, groups[k], k))
+
+
+if __name__ == '__main__':
+    main()
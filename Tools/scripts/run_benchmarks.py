@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+
+"""
+Runs the benchmark programs built by "./waf benchmarks" and merges
+their results into one JSON file, and compares two such files to find
+regressions.
+
+  ./waf configure --board sitl --enable-benchmarks
+  ./waf benchmarks
+  Tools/scripts/run_benchmarks.py --output before.json
+  (change things, rebuild)
+  Tools/scripts/run_benchmarks.py --output after.json --compare before.json
+
+Arguments after "--" are passed to each benchmark program, for example
+-- --benchmark_repetitions=5 --benchmark_filter=Quaternion
+
+ AP_FLAKE8_CLEAN
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+tools_dir = os.path.dirname(os.path.realpath(__file__))
+root_dir = os.path.realpath(os.path.join(tools_dir, '../..'))
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(
+            ['git', 'rev-parse', 'HEAD'],
+            cwd=root_dir,
+            universal_newlines=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def find_programs(board):
+    bench_dir = os.path.join(root_dir, 'build', board, 'benchmarks')
+    if not os.path.isdir(bench_dir):
+        raise RuntimeError("No benchmarks in %s, run ./waf benchmarks first" % bench_dir)
+    programs = []
+    for name in sorted(os.listdir(bench_dir)):
+        path = os.path.join(bench_dir, name)
+        if os.path.isfile(path) and os.access(path, os.X_OK):
+            programs.append(path)
+    return programs
+
+
+def run_program(path, extra_args):
+    output = subprocess.check_output(
+        [path, '--benchmark_format=json'] + extra_args,
+        universal_newlines=True)
+    return json.loads(output)
+
+
+def run_all(board, programs, extra_args):
+    results = {
+        'revision': git_revision(),
+        'board': board,
+        'context': None,
+        'benchmarks': [],
+    }
+    for path in programs:
+        program = os.path.basename(path)
+        print("Running %s" % program, file=sys.stderr)
+        data = run_program(path, extra_args)
+        if results['context'] is None:
+            results['context'] = data.get('context')
+        for b in data.get('benchmarks', []):
+            b['name'] = '%s/%s' % (program, b['name'])
+            results['benchmarks'].append(b)
+    return results
+
+
+def times_by_name(results):
+    '''cpu time of each benchmark, the mean where there are repetitions'''
+    times = {}
+    for b in results['benchmarks']:
+        if b.get('run_type') == 'aggregate' or 'cpu_time' not in b:
+            continue
+        times.setdefault(b['name'], []).append(float(b['cpu_time']))
+    return {name: sum(t) / len(t) for (name, t) in times.items()}
+
+
+def compare(old, new, threshold):
+    '''print the change of each benchmark and return the regressed ones'''
+    old_times = times_by_name(old)
+    new_times = times_by_name(new)
+    regressions = []
+    print("%-60s %12s %12s %8s" % ("Benchmark", "Old", "New", "Change"))
+    for name in sorted(new_times.keys()):
+        if name not in old_times:
+            print("%-60s %12s %12.1f %8s" % (name, "-", new_times[name], "new"))
+            continue
+        old_time = old_times[name]
+        new_time = new_times[name]
+        if old_time <= 0:
+            continue
+        change = 100.0 * (new_time - old_time) / old_time
+        flag = ""
+        if change > threshold:
+            flag = " REGRESSION"
+            regressions.append(name)
+        print("%-60s %12.1f %12.1f %+7.1f%%%s" % (name, old_time, new_time, change, flag))
+    for name in sorted(set(old_times.keys()) - set(new_times.keys())):
+        print("%-60s %12.1f %12s %8s" % (name, old_times[name], "-", "removed"))
+    return regressions
+
+
+def load(filename):
+    with open(filename) as f:
+        return json.load(f)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run benchmarks and compare results')
+    parser.add_argument('--board', default='sitl', help='board the benchmarks were built for')
+    parser.add_argument('--output', default=None, help='file to write the merged JSON results to')
+    parser.add_argument('--compare', default=None, metavar='OLD',
+                        help='JSON results to compare against')
+    parser.add_argument('--new', default=None,
+                        help='compare against these JSON results rather than running the benchmarks')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='percentage increase in cpu time counted as a regression')
+    parser.add_argument('extra_args', nargs='*', help='arguments passed to each benchmark program')
+    args = parser.parse_args()
+
+    if args.new is not None:
+        results = load(args.new)
+    else:
+        results = run_all(args.board, find_programs(args.board), args.extra_args)
+        if args.output is not None:
+            with open(args.output, 'w') as f:
+                json.dump(results, f, indent=2)
+        elif args.compare is None:
+            json.dump(results, sys.stdout, indent=2)
+
+    if args.compare is not None:
+        regressions = compare(load(args.compare), results, args.threshold)
+        if regressions:
+            print("%u benchmarks regressed by more than %.1f%%" % (len(regressions), args.threshold))
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
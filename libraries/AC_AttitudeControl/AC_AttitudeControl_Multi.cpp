@@ -325,7 +325,7 @@ void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
     _throttle_rpy_mix = constrain_float(_throttle_rpy_mix, 0.1f, AC_ATTITUDE_CONTROL_MAX);
 }
 
-void AC_AttitudeControl_Multi::rate_controller_run()
+__FASTRAMFUNC__ void AC_AttitudeControl_Multi::rate_controller_run()
 {
     // move throttle vs attitude mixing towards desired (called from here because this is conveniently called on every iteration)
     update_throttle_rpy_mix();
@@ -334,14 +334,37 @@ void AC_AttitudeControl_Multi::rate_controller_run()
 
     Vector3f gyro_latest = _ahrs.get_gyro_latest();
 
-    _motors.set_roll(get_rate_roll_pid().update_all(_ang_vel_body.x, gyro_latest.x, _motors.limit.roll) + _actuator_sysid.x);
-    _motors.set_roll_ff(get_rate_roll_pid().get_ff());
+    // the rate thread runs the PIDs at its own time step, so always
+    // pass ours in case it has handed the rate controller back
+    const bool limit[3] {_motors.limit.roll, _motors.limit.pitch, _motors.limit.yaw};
+    const Vector3f rate_out = _pid_rate.update_all(_ang_vel_body, gyro_latest, _dt, limit);
 
-    _motors.set_pitch(get_rate_pitch_pid().update_all(_ang_vel_body.y, gyro_latest.y, _motors.limit.pitch) + _actuator_sysid.y);
-    _motors.set_pitch_ff(get_rate_pitch_pid().get_ff());
+    _motors.set_roll(rate_out.x + _actuator_sysid.x);
+    _motors.set_roll_ff(_pid_rate_roll.get_ff());
 
-    _motors.set_yaw(get_rate_yaw_pid().update_all(_ang_vel_body.z, gyro_latest.z, _motors.limit.yaw) + _actuator_sysid.z);
-    _motors.set_yaw_ff(get_rate_yaw_pid().get_ff()*_feedforward_scalar);
+    _motors.set_pitch(rate_out.y + _actuator_sysid.y);
+    _motors.set_pitch_ff(_pid_rate_pitch.get_ff());
+
+    _motors.set_yaw(rate_out.z + _actuator_sysid.z);
+    _motors.set_yaw_ff(_pid_rate_yaw.get_ff()*_feedforward_scalar);
+
+    _sysid_ang_vel_body.zero();
+    _actuator_sysid.zero();
+
+    control_monitor_update();
+}
+
+// publish the body-frame rate targets for rate_controller_run_dt()
+void AC_AttitudeControl_Multi::rate_controller_target_publish()
+{
+    // move throttle vs attitude mixing towards desired (called from here because this is conveniently called on every iteration)
+    update_throttle_rpy_mix();
+
+    _ang_vel_body += _sysid_ang_vel_body;
+
+    // the rate thread empties the buffer every sample, so this can
+    // only fail if it has stopped running
+    IGNORE_RETURN(_rate_targets.push(RateTargets{_ang_vel_body, _actuator_sysid}));
 
     _sysid_ang_vel_body.zero();
     _actuator_sysid.zero();
@@ -349,6 +372,33 @@ void AC_AttitudeControl_Multi::rate_controller_run()
     control_monitor_update();
 }
 
+// run the body-frame rate controller on a gyro sample from the rate thread
+void AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro, float dt)
+{
+    RateTargets targets;
+    while (_rate_targets.pop(targets)) {
+        _rate_targets_run.ang_vel_body = targets.ang_vel_body;
+        // actuator sysid is applied once per published target
+        _rate_targets_run.actuator_sysid += targets.actuator_sysid;
+    }
+
+    const Vector3f &actuator_sysid = _rate_targets_run.actuator_sysid;
+
+    const bool limit[3] {_motors.limit.roll, _motors.limit.pitch, _motors.limit.yaw};
+    const Vector3f rate_out = _pid_rate.update_all(_rate_targets_run.ang_vel_body, gyro, dt, limit);
+
+    _motors.set_roll(rate_out.x + actuator_sysid.x);
+    _motors.set_roll_ff(_pid_rate_roll.get_ff());
+
+    _motors.set_pitch(rate_out.y + actuator_sysid.y);
+    _motors.set_pitch_ff(_pid_rate_pitch.get_ff());
+
+    _motors.set_yaw(rate_out.z + actuator_sysid.z);
+    _motors.set_yaw_ff(_pid_rate_yaw.get_ff()*_feedforward_scalar);
+
+    _rate_targets_run.actuator_sysid.zero();
+}
+
 // sanity check parameters.  should be called once before takeoff
 void AC_AttitudeControl_Multi::parameter_sanity_check()
 {
@@ -5,6 +5,8 @@
 
 #include "AC_AttitudeControl.h"
 #include <AP_Motors/AP_MotorsMulticopter.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <AC_PID/AC_PID_3Axis.h>
 
 // default rate controller PID gains
 #ifndef AC_ATC_MULTI_RATE_RP_P
@@ -75,6 +77,15 @@ public:
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run() override;
 
+    // publish the body-frame rate targets for rate_controller_run_dt().
+    // Called from the main loop in place of rate_controller_run() when
+    // the rate controller runs in its own thread
+    virtual void rate_controller_target_publish();
+
+    // run the body-frame rate controller on a gyro sample from the rate
+    // thread using the last published targets, and send outputs to the motors
+    void rate_controller_run_dt(const Vector3f& gyro, float dt);
+
     // sanity check parameters.  should be called once before take-off
     void parameter_sanity_check() override;
 
@@ -93,8 +104,22 @@ protected:
     AC_PID                _pid_rate_roll;
     AC_PID                _pid_rate_pitch;
     AC_PID                _pid_rate_yaw;
+    // the three rate PIDs run together by the rate controller
+    AC_PID_3Axis          _pid_rate{_pid_rate_roll, _pid_rate_pitch, _pid_rate_yaw};
 
     AP_Float              _thr_mix_man;     // throttle vs attitude control prioritisation used when using manual throttle (higher values mean we prioritise attitude control over throttle)
     AP_Float              _thr_mix_min;     // throttle vs attitude control prioritisation used when landing (higher values mean we prioritise attitude control over throttle)
     AP_Float              _thr_mix_max;     // throttle vs attitude control prioritisation used during active flight (higher values mean we prioritise attitude control over throttle)
+
+private:
+
+    // rate targets handed from the main loop to the rate thread
+    struct RateTargets {
+        Vector3f ang_vel_body;
+        Vector3f actuator_sysid;
+    };
+    // single producer, single consumer so no lock is needed
+    ObjectBuffer<RateTargets> _rate_targets{2};
+    // targets in use by the rate thread
+    RateTargets           _rate_targets_run;
 };
@@ -11,7 +11,23 @@
 // run lowest level body-frame rate controller and send outputs to the motors
 void AC_AttitudeControl_Multi_6DoF::rate_controller_run() {
 
-    // pass current offsets to motors and run baseclass controller
+    update_motor_offsets();
+
+    AC_AttitudeControl_Multi::rate_controller_run();
+}
+
+// publish the body-frame rate targets and motor offsets for the rate thread
+void AC_AttitudeControl_Multi_6DoF::rate_controller_target_publish() {
+
+    update_motor_offsets();
+
+    AC_AttitudeControl_Multi::rate_controller_target_publish();
+}
+
+// pass the current roll and pitch offsets to the motors
+void AC_AttitudeControl_Multi_6DoF::update_motor_offsets() {
+
+    // pass current offsets to motors
     // motors require the offsets to know which way is up
     float roll_deg = roll_offset_deg;
     float pitch_deg = pitch_offset_deg;
@@ -24,8 +40,6 @@ void AC_AttitudeControl_Multi_6DoF::rate_controller_run() {
         pitch_deg = degrees(AP::ahrs().get_pitch());
     }
     _motors.set_roll_pitch(roll_deg,pitch_deg);
-
-    AC_AttitudeControl_Multi::rate_controller_run();
 }
 
 /*
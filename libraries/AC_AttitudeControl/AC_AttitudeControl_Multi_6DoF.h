@@ -61,6 +61,9 @@ public:
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run() override;
 
+    // publish the body-frame rate targets and motor offsets for the rate thread
+    void rate_controller_target_publish() override;
+
     // limiting lean angle based on throttle makes no sense for 6DoF, always allow 90 deg, return in centi-degrees
     float get_althold_lean_angle_max() const override { return 9000.0f; }
 
@@ -84,6 +87,9 @@ private:
 
     void set_forward_lateral(float &euler_pitch_angle_cd, float &euler_roll_angle_cd);
 
+    // pass the current roll and pitch offsets to the motors
+    void update_motor_offsets();
+
     float roll_offset_deg;
     float pitch_offset_deg;
 
@@ -100,6 +100,14 @@
 
 #define AUTOTUNE_ANNOUNCE_INTERVAL_MS 2000
 
+// frequency sweep method
+#define AUTOTUNE_SWEEP_FREQ_MIN_HZ          3.0f    // start frequency of the chirp
+#define AUTOTUNE_SWEEP_FREQ_MAX_HZ         60.0f    // end frequency of the chirp, limited to a sixth of the loop rate
+#define AUTOTUNE_SWEEP_TIME_S              20.0f    // duration of the chirp on each axis
+#define AUTOTUNE_SWEEP_GAIN_MARGIN_DB       6.0f    // rate loop gain margin
+#define AUTOTUNE_SWEEP_PHASE_MARGIN_DEG    45.0f    // rate loop phase margin
+#define AUTOTUNE_SWEEP_SP_RATIO             4.0f    // ratio of rate loop crossover to angle P
+
 // second table of user settable parameters for quadplanes, this
 // allows us to go beyond the 64 parameter limit
 const AP_Param::GroupInfo AC_AutoTune::var_info[] = {
@@ -124,6 +132,20 @@ const AP_Param::GroupInfo AC_AutoTune::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("MIN_D", 3, AC_AutoTune, min_d,  0.001f),
 
+    // @Param: TYPE
+    // @DisplayName: AutoTune method
+    // @Description: How autotune finds the gains. Twitch repeatedly steps the rate and angle targets and adjusts the gains from the response. Sweep adds a frequency sweep to the motor outputs of each axis in turn, measures the frequency response and calculates the rate and angle gains for a 6dB gain margin and 45 degree phase margin in one sequence. Sweep does not change the acceleration limits
+    // @Values: 0:Twitch,1:Sweep
+    // @User: Standard
+    AP_GROUPINFO("TYPE", 4, AC_AutoTune, tune_method, TWITCH),
+
+    // @Param: SWP_MAG
+    // @DisplayName: AutoTune sweep magnitude
+    // @Description: Magnitude of the frequency sweep added to the motor outputs when AUTOTUNE_TYPE is Sweep, as a fraction of full roll, pitch or yaw output. It is halved if the vehicle leans too far during a sweep
+    // @Range: 0.01 0.2
+    // @User: Standard
+    AP_GROUPINFO("SWP_MAG", 5, AC_AutoTune, sweep_magnitude, 0.05f),
+
     AP_GROUPEND
 };
 
@@ -505,7 +527,9 @@ void AC_AutoTune::control_attitude()
         }
 
         // if we have been level for a sufficient amount of time (0.5 seconds) move onto tuning step
-        if (now - step_start_time_ms > AUTOTUNE_REQUIRED_LEVEL_TIME_MS) {
+        if (now - step_start_time_ms > AUTOTUNE_REQUIRED_LEVEL_TIME_MS && tune_method == SWEEP) {
+            sweep_start();
+        } else if (now - step_start_time_ms > AUTOTUNE_REQUIRED_LEVEL_TIME_MS) {
             gcs().send_text(MAV_SEVERITY_INFO, "AutoTune: Twitch");
             // initiate variables for next step
             step = TWITCHING;
@@ -674,6 +698,10 @@ void AC_AutoTune::control_attitude()
         break;
     }
 
+    case SWEEPING:
+        sweep_run();
+        break;
+
     case UPDATE_GAINS:
 
         // re-enable rate limits
@@ -831,49 +859,23 @@ void AC_AutoTune::control_attitude()
                 // we've reached the end of a D-up-down PI-up-down tune type cycle
                 tune_type = RD_UP;
 
-                // advance to the next axis
-                bool complete = false;
                 switch (axis) {
                 case ROLL:
-                    axes_completed |= AUTOTUNE_AXIS_BITMASK_ROLL;
                     tune_roll_sp = MAX(AUTOTUNE_SP_MIN, tune_roll_sp * AUTOTUNE_SP_BACKOFF);
                     tune_roll_accel = MAX(AUTOTUNE_RP_ACCEL_MIN, test_accel_max * AUTOTUNE_ACCEL_RP_BACKOFF);
-                    if (pitch_enabled()) {
-                        axis = PITCH;
-                    } else if (yaw_enabled()) {
-                        axis = YAW;
-                    } else {
-                        complete = true;
-                    }
                     break;
                 case PITCH:
-                    axes_completed |= AUTOTUNE_AXIS_BITMASK_PITCH;
                     tune_pitch_sp = MAX(AUTOTUNE_SP_MIN, tune_pitch_sp * AUTOTUNE_SP_BACKOFF);
                     tune_pitch_accel = MAX(AUTOTUNE_RP_ACCEL_MIN, test_accel_max * AUTOTUNE_ACCEL_RP_BACKOFF);
-                    if (yaw_enabled()) {
-                        axis = YAW;
-                    } else {
-                        complete = true;
-                    }
                     break;
                 case YAW:
-                    axes_completed |= AUTOTUNE_AXIS_BITMASK_YAW;
                     tune_yaw_sp = MAX(AUTOTUNE_SP_MIN, tune_yaw_sp * AUTOTUNE_SP_BACKOFF);
                     tune_yaw_accel = MAX(AUTOTUNE_Y_ACCEL_MIN, test_accel_max * AUTOTUNE_ACCEL_Y_BACKOFF);
-                    complete = true;
                     break;
                 }
 
-                // if we've just completed all axes we have successfully completed the autotune
-                // change to TESTING mode to allow user to fly with new gains
-                if (complete) {
-                    mode = SUCCESS;
-                    update_gcs(AUTOTUNE_MESSAGE_SUCCESS);
-                    AP::logger().Write_Event(LogEvent::AUTOTUNE_SUCCESS);
-                    AP_Notify::events.autotune_complete = true;
-                } else {
-                    AP_Notify::events.autotune_next_axis = true;
-                }
+                // advance to the next axis
+                next_axis();
                 break;
             }
         }
@@ -897,6 +899,216 @@ void AC_AutoTune::control_attitude()
     }
 }
 
+// next_axis - mark the current axis as complete and move to the next
+//  enabled one, or finish the autotune if there are none left
+void AC_AutoTune::next_axis()
+{
+    bool complete = false;
+    switch (axis) {
+    case ROLL:
+        axes_completed |= AUTOTUNE_AXIS_BITMASK_ROLL;
+        if (pitch_enabled()) {
+            axis = PITCH;
+        } else if (yaw_enabled()) {
+            axis = YAW;
+        } else {
+            complete = true;
+        }
+        break;
+    case PITCH:
+        axes_completed |= AUTOTUNE_AXIS_BITMASK_PITCH;
+        if (yaw_enabled()) {
+            axis = YAW;
+        } else {
+            complete = true;
+        }
+        break;
+    case YAW:
+        axes_completed |= AUTOTUNE_AXIS_BITMASK_YAW;
+        complete = true;
+        break;
+    }
+
+    // if we've just completed all axes we have successfully completed the autotune
+    // change to TESTING mode to allow user to fly with new gains
+    if (complete) {
+        mode = SUCCESS;
+        update_gcs(AUTOTUNE_MESSAGE_SUCCESS);
+        AP::logger().Write_Event(LogEvent::AUTOTUNE_SUCCESS);
+        AP_Notify::events.autotune_complete = true;
+    } else {
+        AP_Notify::events.autotune_next_axis = true;
+    }
+}
+
+// sweep_start - begin the frequency sweep of the current axis
+void AC_AutoTune::sweep_start()
+{
+    gcs().send_text(MAV_SEVERITY_INFO, "AutoTune: Sweep");
+    step = SWEEPING;
+    step_start_time_ms = AP_HAL::millis();
+    // keep the chirp well below the loop rate so each cycle has enough samples
+    const float freq_max = MIN(AUTOTUNE_SWEEP_FREQ_MAX_HZ, AP::scheduler().get_loop_rate_hz() / 6.0f);
+    sweep.start(AUTOTUNE_SWEEP_FREQ_MIN_HZ, freq_max, AUTOTUNE_SWEEP_TIME_S,
+                constrain_float(sweep_magnitude, 0.01f, 0.2f) * step_scaler);
+    switch (axis) {
+    case ROLL:
+        sweep_last_actuator = motors->get_roll();
+        start_angle = ahrs_view->roll_sensor;
+        abort_angle = AUTOTUNE_TARGET_ANGLE_RLLPIT_CD;
+        break;
+    case PITCH:
+        sweep_last_actuator = motors->get_pitch();
+        start_angle = ahrs_view->pitch_sensor;
+        abort_angle = AUTOTUNE_TARGET_ANGLE_RLLPIT_CD;
+        break;
+    case YAW:
+        sweep_last_actuator = motors->get_yaw();
+        start_angle = ahrs_view->yaw_sensor;
+        abort_angle = AUTOTUNE_TARGET_ANGLE_YAW_CD;
+        break;
+    }
+}
+
+/*
+  sweep_run - hold attitude on the intra-test gains while a chirp is
+  added to the actuator output of the axis being tuned, and record the
+  actuator command and the rate it produced
+ */
+void AC_AutoTune::sweep_run()
+{
+    load_gains(GAIN_INTRA_TEST);
+    attitude_control->use_sqrt_controller(true);
+    attitude_control->input_euler_angle_roll_pitch_yaw(roll_cd, pitch_cd, desired_yaw_cd, true);
+
+    // the rate seen now is the response to the actuator command of the
+    // previous loop, the rate controller has already run for this one
+    const Vector3f &gyro = ahrs_view->get_gyro();
+    const float excitation = sweep.update(AP::scheduler().get_loop_period_s());
+    float gyro_reading = 0;
+    switch (axis) {
+    case ROLL:
+        gyro_reading = gyro.x;
+        sweep.add_sample(sweep_last_actuator, gyro_reading);
+        sweep_last_actuator = motors->get_roll();
+        attitude_control->actuator_roll_sysid(excitation);
+        lean_angle = ahrs_view->roll_sensor - start_angle;
+        break;
+    case PITCH:
+        gyro_reading = gyro.y;
+        sweep.add_sample(sweep_last_actuator, gyro_reading);
+        sweep_last_actuator = motors->get_pitch();
+        attitude_control->actuator_pitch_sysid(excitation);
+        lean_angle = ahrs_view->pitch_sensor - start_angle;
+        break;
+    case YAW:
+        gyro_reading = gyro.z;
+        sweep.add_sample(sweep_last_actuator, gyro_reading);
+        sweep_last_actuator = motors->get_yaw();
+        attitude_control->actuator_yaw_sysid(excitation);
+        lean_angle = wrap_180_cd(ahrs_view->yaw_sensor - start_angle);
+        break;
+    }
+    rotation_rate = ToDeg(gyro_reading) * 100.0f;
+
+    Log_Write_AutoTuneDetails(lean_angle, rotation_rate);
+    ahrs_view->Write_Rate(*motors, *attitude_control, *pos_control);
+    log_pids();
+
+    const uint32_t now = AP_HAL::millis();
+    bool restart = false;
+    if (fabsf(lean_angle) > abort_angle) {
+        // the chirp is moving the vehicle too far, start again with less
+        step_scaler = MAX(step_scaler * 0.5f, 0.1f);
+        gcs().send_text(MAV_SEVERITY_WARNING, "AutoTune: Sweep too large, reducing");
+        restart = true;
+    } else if (sweep.finished()) {
+        restart = !sweep_update_gains();
+    }
+    if (restart || sweep.finished()) {
+        step = WAITING_FOR_LEVEL;
+        step_start_time_ms = now;
+        level_start_time_ms = now;
+        step_time_limit_ms = AUTOTUNE_REQUIRED_LEVEL_TIME_MS;
+    }
+}
+
+/*
+  sweep_update_gains - calculate the gains of the swept axis from its
+  frequency response and move on to the next axis. Returns false if
+  the response could not be used, so the axis should be swept again
+ */
+bool AC_AutoTune::sweep_update_gains()
+{
+    AC_PID *pid = nullptr;
+    switch (axis) {
+    case ROLL:
+        pid = &attitude_control->get_rate_roll_pid();
+        break;
+    case PITCH:
+        pid = &attitude_control->get_rate_pitch_pid();
+        break;
+    case YAW:
+        pid = &attitude_control->get_rate_yaw_pid();
+        break;
+    }
+
+    // log the measured response
+    const uint64_t now_us = AP_HAL::micros64();
+    for (uint8_t i = 0; i < AUTOTUNE_FREQRESP_BINS; i++) {
+        float freq_hz, gain, phase;
+        if (!sweep.get_point(i, freq_hz, gain, phase)) {
+            continue;
+        }
+// @LoggerMessage: ATFR
+// @Description: AutoTune sweep frequency response, from actuator command to rate
+// @Field: TimeUS: Time since system startup
+// @Field: Axis: which axis is being tuned
+// @Field: Freq: frequency
+// @Field: Gain: rate in radians/second per unit of actuator command
+// @Field: Phase: phase of the rate relative to the actuator command
+        AP::logger().Write("ATFR", "TimeUS,Axis,Freq,Gain,Phase", "s-z-d", "F-0-0", "QBfff",
+                           now_us, uint8_t(axis), freq_hz, gain, degrees(phase));
+    }
+
+    float kp, kd, crossover_hz;
+    const bool use_d = (axis != YAW);
+    if (!sweep.calc_rate_gains(AUTOTUNE_SWEEP_GAIN_MARGIN_DB, AUTOTUNE_SWEEP_PHASE_MARGIN_DEG,
+                               use_d ? AUTOTUNE_PI_RATIO_FINAL : AUTOTUNE_YAW_PI_RATIO_FINAL,
+                               pid->filt_E_hz(), pid->filt_D_hz(), use_d,
+                               kp, kd, crossover_hz)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "AutoTune: Sweep response unusable, retrying");
+        return false;
+    }
+    kp = constrain_float(kp, AUTOTUNE_RP_MIN, AUTOTUNE_RP_MAX);
+    kd = constrain_float(kd, min_d, AUTOTUNE_RD_MAX);
+    const float sp = constrain_float(M_2PI * crossover_hz / AUTOTUNE_SWEEP_SP_RATIO, AUTOTUNE_SP_MIN, AUTOTUNE_SP_MAX);
+
+    switch (axis) {
+    case ROLL:
+        tune_roll_rp = kp;
+        tune_roll_rd = kd;
+        tune_roll_sp = sp;
+        break;
+    case PITCH:
+        tune_pitch_rp = kp;
+        tune_pitch_rd = kd;
+        tune_pitch_sp = sp;
+        break;
+    case YAW:
+        // the yaw error filter is kept at its current value
+        tune_yaw_rp = kp;
+        tune_yaw_sp = sp;
+        kd = 0;
+        break;
+    }
+    Log_Write_AutoTuneSweep(crossover_hz, kp, kd, sp);
+
+    step_scaler = 1.0f;
+    next_axis();
+    return true;
+}
+
 // backup_gains_and_initialise - store current gains as originals
 //  called before tuning starts to backup original gains
 void AC_AutoTune::backup_gains_and_initialise()
@@ -1748,6 +1960,31 @@ void AC_AutoTune::Log_Write_AutoTune(uint8_t _axis, uint8_t tune_step, float mea
         new_ddt);
 }
 
+// Write an Autotune sweep result packet
+void AC_AutoTune::Log_Write_AutoTuneSweep(float crossover_hz, float new_gain_rp, float new_gain_rd, float new_gain_sp)
+{
+// @LoggerMessage: ATSW
+// @Description: AutoTune sweep result
+// @Field: TimeUS: Time since system startup
+// @Field: Axis: which axis is being tuned
+// @Field: Fc: rate loop crossover frequency with the new gains
+// @Field: RP: new rate gain P term
+// @Field: RD: new rate gain D term
+// @Field: SP: new angle P term
+    AP::logger().Write(
+        "ATSW",
+        "TimeUS,Axis,Fc,RP,RD,SP",
+        "s-z---",
+        "F-0---",
+        "QBffff",
+        AP_HAL::micros64(),
+        uint8_t(axis),
+        crossover_hz,
+        new_gain_rp,
+        new_gain_rd,
+        new_gain_sp);
+}
+
 // Write an Autotune data packet
 void AC_AutoTune::Log_Write_AutoTuneDetails(float angle_cd, float rate_cds)
 {
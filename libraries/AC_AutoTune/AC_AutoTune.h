@@ -22,6 +22,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AC_AttitudeControl/AC_AttitudeControl_Multi.h>
 #include <AC_AttitudeControl/AC_PosControl.h>
+#include "AC_AutoTune_FreqResp.h"
 
 class AC_AutoTune {
 public:
@@ -96,9 +97,14 @@ private:
     void updating_angle_p_down(float &tune_p, float tune_p_min, float tune_p_step_ratio, float angle_target, float meas_angle_max, float meas_rate_min, float meas_rate_max);
     void updating_angle_p_up(float &tune_p, float tune_p_max, float tune_p_step_ratio, float angle_target, float meas_angle_max, float meas_rate_min, float meas_rate_max);
     void get_poshold_attitude(float &roll_cd, float &pitch_cd, float &yaw_cd);
+    void next_axis();
+    void sweep_start();
+    void sweep_run();
+    bool sweep_update_gains();
 
     void Log_Write_AutoTune(uint8_t axis, uint8_t tune_step, float meas_target, float meas_min, float meas_max, float new_gain_rp, float new_gain_rd, float new_gain_sp, float new_ddt);
     void Log_Write_AutoTuneDetails(float angle_cd, float rate_cds);
+    void Log_Write_AutoTuneSweep(float crossover_hz, float new_gain_rp, float new_gain_rd, float new_gain_sp);
 
     void send_step_string();
     const char *level_issue_string() const;
@@ -130,7 +136,14 @@ private:
     enum StepType {
         WAITING_FOR_LEVEL = 0,    // autotune is waiting for vehicle to return to level before beginning the next twitch
         TWITCHING = 1,            // autotune has begun a twitch and is watching the resulting vehicle movement
-        UPDATE_GAINS = 2          // autotune has completed a twitch and is updating the gains based on the results
+        UPDATE_GAINS = 2,         // autotune has completed a twitch and is updating the gains based on the results
+        SWEEPING = 3              // autotune is measuring the frequency response of an axis with a chirp
+    };
+
+    // ways of tuning
+    enum TuneMethod {
+        TWITCH = 0,               // step the rate and angle targets and adjust gains from the response
+        SWEEP = 1,                // identify the rate response with a chirp and calculate the gains
     };
 
     // things that can be tuned
@@ -191,6 +204,10 @@ private:
 
     LowPassFilterFloat  rotation_rate_filt;         // filtered rotation rate in radians/second
 
+    // frequency response measurement for the sweep method
+    AC_AutoTune_FreqResp sweep;
+    float    sweep_last_actuator;                   // actuator command of the previous loop on the axis being swept
+
     // backup of currently being tuned parameter values
     float    orig_roll_rp, orig_roll_ri, orig_roll_rd, orig_roll_rff, orig_roll_fltt, orig_roll_sp, orig_roll_accel;
     float    orig_pitch_rp, orig_pitch_ri, orig_pitch_rd, orig_pitch_rff, orig_pitch_fltt, orig_pitch_sp, orig_pitch_accel;
@@ -218,6 +235,8 @@ private:
     AP_Int8  axis_bitmask;
     AP_Float aggressiveness;
     AP_Float min_d;
+    AP_Int8  tune_method;
+    AP_Float sweep_magnitude;
 
     // copies of object pointers to make code a bit clearer
     AC_AttitudeControl_Multi *attitude_control;
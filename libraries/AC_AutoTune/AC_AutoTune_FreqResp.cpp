@@ -0,0 +1,258 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AC_AutoTune_FreqResp.h"
+
+// minimum samples in a chirp cycle for it to be used
+#define FREQRESP_MIN_CYCLE_SAMPLES 4
+
+// number of D/P ratios tried by calc_rate_gains(), and their range in seconds
+#define FREQRESP_D_RATIOS 12
+#define FREQRESP_D_RATIO_MIN 0.002f
+#define FREQRESP_D_RATIO_MAX 0.05f
+
+namespace {
+
+struct Complex {
+    float re;
+    float im;
+};
+
+Complex cmul(const Complex &a, const Complex &b)
+{
+    return Complex{a.re*b.re - a.im*b.im, a.re*b.im + a.im*b.re};
+}
+
+// 1/(1 + jw/wc), or 1 if there is no filter
+Complex lowpass(float w, float filt_hz)
+{
+    if (filt_hz <= 0) {
+        return Complex{1, 0};
+    }
+    const float x = w / (M_2PI * filt_hz);
+    const float d = 1 + x*x;
+    return Complex{1/d, -x/d};
+}
+
+/*
+  find where y[] first falls to y_limit, interpolating between points.
+  Returns the fraction t along the segment ending at index i, with
+  i = n if it never does and i = 0 if it already has at the first point
+ */
+uint8_t first_crossing(const float y[], uint8_t n, float y_limit, float &t)
+{
+    for (uint8_t i = 0; i < n; i++) {
+        if (y[i] <= y_limit) {
+            t = (i == 0) ? 1 : (y[i-1] - y_limit) / (y[i-1] - y[i]);
+            return i;
+        }
+    }
+    t = 1;
+    return n;
+}
+
+// interpolate the log of x[] at a crossing
+float log_interp(const float x[], uint8_t i, float t)
+{
+    if (i == 0) {
+        return x[0];
+    }
+    return x[i-1] * powf(x[i] / x[i-1], t);
+}
+
+}
+
+void AC_AutoTune_FreqResp::start(float freq_min_hz, float freq_max_hz, float duration_s, float magnitude)
+{
+    memset(_bins, 0, sizeof(_bins));
+    _freq_min = freq_min_hz;
+    _freq_max = MAX(freq_max_hz, freq_min_hz * 1.1f);
+    _duration = duration_s;
+    _magnitude = magnitude;
+    _time = 0;
+    _freq_hz = _freq_min;
+    _phase = 0;
+    _cycle_done = false;
+    _u_re = _u_im = _g_re = _g_im = 0;
+    _u_sum = _g_sum = 0;
+    _cycle_samples = 0;
+    // no mean yet, so the first cycle is only used to find one
+    _u_mean = _g_mean = NAN;
+}
+
+/*
+  exponential chirp, spending the same time on each octave. The
+  magnitude is faded in and out to avoid a step
+ */
+float AC_AutoTune_FreqResp::update(float dt)
+{
+    _time += dt;
+    _freq_hz = _freq_min * expf(logf(_freq_max / _freq_min) * MIN(_time / _duration, 1.0f));
+    _phase += _freq_hz * dt;
+    if (_phase >= 1) {
+        _phase -= 1;
+        _cycle_done = true;
+    }
+    const float fade_s = MIN(1.0f, 0.1f * _duration);
+    const float window = constrain_float(MIN(_time, _duration - _time) / fade_s, 0, 1);
+    return window * _magnitude * sinf(M_2PI * _phase);
+}
+
+uint8_t AC_AutoTune_FreqResp::bin_index(float freq_hz) const
+{
+    const float x = logf(freq_hz / _freq_min) / logf(_freq_max / _freq_min);
+    return constrain_int16(int16_t(x * AUTOTUNE_FREQRESP_BINS), 0, AUTOTUNE_FREQRESP_BINS - 1);
+}
+
+void AC_AutoTune_FreqResp::add_sample(float input, float output)
+{
+    if (_cycle_done) {
+        _cycle_done = false;
+        if (_cycle_samples >= FREQRESP_MIN_CYCLE_SAMPLES) {
+            if (!isnan(_u_mean)) {
+                Bin &b = _bins[bin_index(_freq_hz)];
+                b.u_re += _u_re;
+                b.u_im += _u_im;
+                b.g_re += _g_re;
+                b.g_im += _g_im;
+                b.freq_sum += _freq_hz;
+                b.count++;
+            }
+            _u_mean = _u_sum / _cycle_samples;
+            _g_mean = _g_sum / _cycle_samples;
+        }
+        _u_re = _u_im = _g_re = _g_im = 0;
+        _u_sum = _g_sum = 0;
+        _cycle_samples = 0;
+    }
+
+    const float angle = M_2PI * _phase;
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+    const float u = isnan(_u_mean) ? input : input - _u_mean;
+    const float g = isnan(_g_mean) ? output : output - _g_mean;
+    _u_re += u * c;
+    _u_im -= u * s;
+    _g_re += g * c;
+    _g_im -= g * s;
+    _u_sum += input;
+    _g_sum += output;
+    _cycle_samples++;
+}
+
+// response G/U of a bin, false if it has no data
+bool AC_AutoTune_FreqResp::get_response(uint8_t bin, float &freq_hz, float &re, float &im) const
+{
+    const Bin &b = _bins[bin];
+    const float uu = sq(b.u_re) + sq(b.u_im);
+    if (b.count == 0 || !is_positive(uu)) {
+        return false;
+    }
+    freq_hz = b.freq_sum / b.count;
+    re = (b.g_re * b.u_re + b.g_im * b.u_im) / uu;
+    im = (b.g_im * b.u_re - b.g_re * b.u_im) / uu;
+    return true;
+}
+
+bool AC_AutoTune_FreqResp::get_point(uint8_t bin, float &freq_hz, float &gain, float &phase_rad) const
+{
+    float re, im;
+    if (bin >= AUTOTUNE_FREQRESP_BINS || !get_response(bin, freq_hz, re, im)) {
+        return false;
+    }
+    gain = safe_sqrt(sq(re) + sq(im));
+    phase_rad = atan2f(im, re);
+    return true;
+}
+
+uint8_t AC_AutoTune_FreqResp::get_points(float freq_hz[], float re[], float im[]) const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < AUTOTUNE_FREQRESP_BINS; i++) {
+        if (get_response(i, freq_hz[n], re[n], im[n])) {
+            n++;
+        }
+    }
+    return n;
+}
+
+bool AC_AutoTune_FreqResp::calc_rate_gains(float gain_margin_db, float phase_margin_deg, float ki_ratio,
+                                           float filt_E_hz, float filt_D_hz, bool use_d,
+                                           float &kp, float &kd, float &crossover_hz) const
+{
+    float freq[AUTOTUNE_FREQRESP_BINS];
+    float plant_re[AUTOTUNE_FREQRESP_BINS];
+    float plant_im[AUTOTUNE_FREQRESP_BINS];
+    const uint8_t n = get_points(freq, plant_re, plant_im);
+    if (n < 3) {
+        return false;
+    }
+
+    const float gain_margin = powf(10.0f, gain_margin_db / 20.0f);
+    const float phase_limit = radians(phase_margin_deg) - M_PI;
+    bool found = false;
+
+    for (uint8_t r = 0; r < (use_d ? FREQRESP_D_RATIOS + 1 : 1); r++) {
+        const float d_ratio = (r == 0) ? 0 :
+            FREQRESP_D_RATIO_MIN * powf(FREQRESP_D_RATIO_MAX / FREQRESP_D_RATIO_MIN, float(r - 1) / (FREQRESP_D_RATIOS - 1));
+
+        // open loop response with a P gain of 1, phase unwrapped from
+        // the lowest frequency
+        float mag[AUTOTUNE_FREQRESP_BINS];
+        float phase[AUTOTUNE_FREQRESP_BINS];
+        for (uint8_t i = 0; i < n; i++) {
+            const float w = M_2PI * freq[i];
+            const Complex d_term = cmul(Complex{0, d_ratio * w}, lowpass(w, filt_D_hz));
+            const Complex pid{1 + d_term.re, d_term.im - ki_ratio / w};
+            const Complex loop = cmul(cmul(lowpass(w, filt_E_hz), pid), Complex{plant_re[i], plant_im[i]});
+            mag[i] = safe_sqrt(sq(loop.re) + sq(loop.im));
+            phase[i] = atan2f(loop.im, loop.re);
+            if (i > 0) {
+                phase[i] = phase[i-1] + wrap_PI(phase[i] - phase[i-1]);
+            }
+        }
+
+        // the largest P gain meeting the gain margin, where the phase
+        // reaches -180, and the phase margin, assuming the gain falls
+        // with frequency. Past the measured range use the last point
+        float t;
+        uint8_t i = first_crossing(phase, n, -M_PI, t);
+        if (i == 0) {
+            continue;
+        }
+        float kp_try = 1.0f / (gain_margin * log_interp(mag, MIN(i, n-1), i < n ? t : 1));
+        i = first_crossing(phase, n, phase_limit, t);
+        if (i == 0) {
+            continue;
+        }
+        kp_try = MIN(kp_try, 1.0f / log_interp(mag, MIN(i, n-1), i < n ? t : 1));
+
+        // crossover frequency at that gain
+        float loop_mag[AUTOTUNE_FREQRESP_BINS];
+        for (uint8_t j = 0; j < n; j++) {
+            loop_mag[j] = kp_try * mag[j];
+        }
+        i = first_crossing(loop_mag, n, 1, t);
+        const float fc = log_interp(freq, MIN(i, n-1), i < n ? t : 1);
+
+        if (!found || fc > crossover_hz * 1.02f) {
+            found = true;
+            kp = kp_try;
+            kd = kp_try * d_ratio;
+            crossover_hz = fc;
+        }
+    }
+    return found;
+}
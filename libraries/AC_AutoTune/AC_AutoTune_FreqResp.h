@@ -0,0 +1,103 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  frequency response identification for autotune. An exponential chirp
+  is added to the actuator output of one axis and each cycle of the
+  actuator command and the measured rate is correlated with the chirp
+  phase, giving one DFT bin at the chirp frequency per cycle. The
+  cycles are summed into log spaced frequency bins, and the ratio of
+  the sums is the plant response. As both sums are correlated with the
+  chirp, feedback of sensor noise through the controller averages out
+  rather than biasing the result. Rate loop gains are then chosen for
+  a given gain and phase margin.
+ */
+
+#pragma once
+
+#include <AP_Math/AP_Math.h>
+
+// number of log spaced frequency bins
+#define AUTOTUNE_FREQRESP_BINS 20
+
+class AC_AutoTune_FreqResp {
+public:
+    // start a chirp from freq_min_hz to freq_max_hz lasting duration_s
+    // with an actuator magnitude of magnitude
+    void start(float freq_min_hz, float freq_max_hz, float duration_s, float magnitude);
+
+    // advance the chirp by dt and return the actuator excitation
+    float update(float dt);
+
+    // add the actuator command the plant was driven with and the rate
+    // it produced, after each call to update()
+    void add_sample(float input, float output);
+
+    // true once the chirp has finished
+    bool finished() const { return _time >= _duration; }
+
+    // current chirp frequency
+    float get_freq_hz() const { return _freq_hz; }
+
+    // plant response in a bin, returns false if the bin has no data
+    bool get_point(uint8_t bin, float &freq_hz, float &gain, float &phase_rad) const;
+
+    // plant response controller design. Find the rate P and D gains
+    // giving the highest crossover frequency with at least the given
+    // gain margin and phase margin, for a PID with I = ki_ratio * P
+    // and error and D filters at filt_E_hz and filt_D_hz (0 for none).
+    // With use_d false only P is chosen
+    bool calc_rate_gains(float gain_margin_db, float phase_margin_deg, float ki_ratio,
+                         float filt_E_hz, float filt_D_hz, bool use_d,
+                         float &kp, float &kd, float &crossover_hz) const;
+
+private:
+    struct Bin {
+        // sum of the input and output cycles, referenced to the chirp
+        float u_re;
+        float u_im;
+        float g_re;
+        float g_im;
+        float freq_sum;
+        uint16_t count;
+    };
+
+    uint8_t bin_index(float freq_hz) const;
+
+    bool get_response(uint8_t bin, float &freq_hz, float &re, float &im) const;
+
+    // copy out the bins with data, lowest frequency first
+    uint8_t get_points(float freq_hz[], float re[], float im[]) const;
+
+    Bin _bins[AUTOTUNE_FREQRESP_BINS];
+
+    float _freq_min;
+    float _freq_max;
+    float _duration;
+    float _magnitude;
+    float _time;
+    float _freq_hz;
+
+    // chirp phase in cycles, wrapped each cycle
+    float _phase;
+    bool _cycle_done;
+
+    // single bin DFT of the current cycle
+    float _u_re, _u_im, _g_re, _g_im;
+    float _u_sum, _g_sum;
+    uint16_t _cycle_samples;
+
+    // mean of the last cycle, removed from the next
+    float _u_mean, _g_mean;
+};
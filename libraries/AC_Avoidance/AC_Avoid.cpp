@@ -797,7 +797,7 @@ void AC_Avoid::adjust_velocity_inclusion_and_exclusion_polygons(float kP, float
         const Vector2f* boundary = fence->polyfence().get_inclusion_polygon(i, num_points);
         Vector2f backup_vel_inc;
         // adjust velocity
-        adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, backup_vel_inc, boundary, num_points, fence->get_margin(), dt, true);
+        adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, backup_vel_inc, boundary, num_points, fence->get_margin(), dt, true, fence->polyfence().get_inclusion_polygon_edge_index(i));
         find_max_quadrant_velocity(backup_vel_inc, quad_1_back_vel, quad_2_back_vel, quad_3_back_vel, quad_4_back_vel);
     }
 
@@ -808,7 +808,7 @@ void AC_Avoid::adjust_velocity_inclusion_and_exclusion_polygons(float kP, float
         const Vector2f* boundary = fence->polyfence().get_exclusion_polygon(i, num_points);
         Vector2f backup_vel_exc;
         // adjust velocity
-        adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, backup_vel_exc, boundary, num_points, fence->get_margin(), dt, false);
+        adjust_velocity_polygon(kP, accel_cmss, desired_vel_cms, backup_vel_exc, boundary, num_points, fence->get_margin(), dt, false, fence->polyfence().get_exclusion_polygon_edge_index(i));
         find_max_quadrant_velocity(backup_vel_exc, quad_1_back_vel, quad_2_back_vel, quad_3_back_vel, quad_4_back_vel);
     }
     // desired backup velocity is sum of maximum velocity component in each quadrant 
@@ -1253,7 +1253,7 @@ void AC_Avoid::adjust_velocity_proximity(float kP, float accel_cmss, Vector3f &d
 /*
  * Adjusts the desired velocity for the polygon fence.
  */
-void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside)
+void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside, const AC_PolygonEdgeIndex *edge_index)
 {
     // exit if there are no points
     if (boundary == nullptr || num_points == 0) {
@@ -1273,7 +1273,8 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
 
 
     // return if we have already breached polygon
-    const bool inside_polygon = !Polygon_outside(position_xy, boundary, num_points);
+    const bool inside_polygon = ((edge_index == nullptr) || !edge_index->outside_bbox(position_xy)) &&
+                                !Polygon_outside(position_xy, boundary, num_points);
     if (inside_polygon != stay_inside) {
         return;
     }
@@ -1296,8 +1297,22 @@ void AC_Avoid::adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &des
 
     // for backing away
     Vector2f quad_1_back_vel, quad_2_back_vel, quad_3_back_vel, quad_4_back_vel;
-   
-    for (uint16_t i=0; i<num_points; i++) {
+
+    // edges further away than the stopping point plus margin can not limit velocity or require backing away
+    // so only check the edges near the vehicle if we have an index and the sqrt controller agrees the edge is out of reach
+    uint8_t near_edges[UINT8_MAX];
+    uint16_t num_edges = num_points;
+    bool use_near_edges = false;
+    if ((edge_index != nullptr) && (num_points <= UINT8_MAX)) {
+        const float reach_cm = desired_vel_cms.is_zero() ? margin_cm : (2.0f + margin_cm + get_stopping_distance(kP, accel_cmss, speed));
+        if (desired_vel_cms.is_zero() || (get_max_speed(kP, accel_cmss, reach_cm - margin_cm, dt) >= speed)) {
+            num_edges = edge_index->edges_near(position_xy, reach_cm, near_edges);
+            use_near_edges = true;
+        }
+    }
+
+    for (uint16_t k=0; k<num_edges; k++) {
+        const uint16_t i = use_near_edges ? near_edges[k] : k;
         uint16_t j = i+1;
         if (j >= num_points) {
             j = 0;
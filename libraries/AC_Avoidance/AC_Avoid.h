@@ -5,6 +5,8 @@
 #include <AP_Math/AP_Math.h>
 #include <AC_AttitudeControl/AC_AttitudeControl.h> // Attitude controller library for sqrt controller
 
+class AC_PolygonEdgeIndex;
+
 #define AC_AVOID_ACCEL_CMSS_MAX         100.0f  // maximum acceleration/deceleration in cm/s/s used to avoid hitting fence
 
 // bit masks for enabled fence types.
@@ -156,8 +158,9 @@ private:
      * The boundary must be in Earth Frame
      * margin is the distance (in meters) that the vehicle should stop short of the polygon
      * stay_inside should be true for fences, false for exclusion polygons
+     * edge_index is optional and allows only edges near the vehicle to be checked
      */
-    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside);
+    void adjust_velocity_polygon(float kP, float accel_cmss, Vector2f &desired_vel_cms, Vector2f &backup_vel, const Vector2f* boundary, uint16_t num_points, float margin, float dt, bool stay_inside, const AC_PolygonEdgeIndex *edge_index = nullptr);
 
     /*
      * Computes distance required to stop, given current speed.
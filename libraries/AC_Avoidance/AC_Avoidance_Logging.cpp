@@ -24,7 +24,8 @@ void AP_OABendyRuler::Write_OABendyRuler(const uint8_t type, const bool active,
         final_alt   : got_final_dest ? final_alt : final_dest.alt,
         oa_lat      : oa_dest.lat,
         oa_lng      : oa_dest.lng,
-        oa_alt      : got_oa_dest ? oa_dest_alt : oa_dest.alt
+        oa_alt      : got_oa_dest ? oa_dest_alt : oa_dest.alt,
+        latency_ms  : (uint16_t)MIN(AP_HAL::millis() - _request_time_ms, UINT16_MAX)
     };
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
@@ -41,7 +42,8 @@ void AP_OADijkstra::Write_OADijkstra(const uint8_t state, const uint8_t error_id
         final_lat   : final_dest.lat,
         final_lng   : final_dest.lng,
         oa_lat      : oa_dest.lat,
-        oa_lng      : oa_dest.lng
+        oa_lng      : oa_dest.lng,
+        latency_ms  : (uint16_t)MIN(AP_HAL::millis() - _request_time_ms, UINT16_MAX)
     };
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
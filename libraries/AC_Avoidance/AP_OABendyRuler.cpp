@@ -26,11 +26,13 @@ const int16_t OA_BENDYRULER_ANGLE_DEFAULT = 75;
 const int16_t OA_BENDYRULER_TYPE_DEFAULT = 1;
 
 const int16_t OA_BENDYRULER_BEARING_INC_XY = 5;            // check every 5 degrees around vehicle
+const uint8_t OA_BENDYRULER_NUM_BEARINGS_XY = 1 + 2 * (170 / OA_BENDYRULER_BEARING_INC_XY);   // bearing to destination and each side out to 170 degrees
 const int16_t OA_BENDYRULER_BEARING_INC_VERTICAL = 90;
 const float OA_BENDYRULER_LOOKAHEAD_STEP2_RATIO = 1.0f; // step2's lookahead length as a ratio of step1's lookahead length
 const float OA_BENDYRULER_LOOKAHEAD_STEP2_MIN = 2.0f;   // step2 checks at least this many meters past step1's location
 const float OA_BENDYRULER_LOOKAHEAD_PAST_DEST = 2.0f;   // lookahead length will be at least this many meters past the destination
 const float OA_BENDYRULER_LOW_SPEED_SQUARED = (0.2f * 0.2f);    // when ground course is below this speed squared, vehicle's heading will be used
+const float OA_BENDYRULER_DB_SEARCH_MARGIN = 20.0f;    // object database items further than this many meters from a path are treated as being at this distance
 
 #define VERTICAL_ENABLED APM_BUILD_TYPE(APM_BUILD_ArduCopter)
 
@@ -139,68 +141,77 @@ bool AP_OABendyRuler::search_xy_path(const Location& current_loc, const Location
     float best_margin = -FLT_MAX;
     float best_margin_bearing = best_bearing;
 
-    for (uint8_t i = 0; i <= (170 / OA_BENDYRULER_BEARING_INC_XY); i++) {
-        for (uint8_t bdir = 0; bdir <= 1; bdir++) {
-            // skip duplicate check of bearing straight towards destination
-            if ((i==0) && (bdir > 0)) {
-                continue;
-            }
-            // bearing that we are probing
-            const float bearing_delta = i * OA_BENDYRULER_BEARING_INC_XY * (bdir == 0 ? -1.0f : 1.0f);
-            const float bearing_test = wrap_180(bearing_to_dest + bearing_delta);
+    // bearings to probe, straight towards the destination first. The first step of every
+    // probe starts at the current location so their margins are calculated together
+    float bearings[OA_BENDYRULER_NUM_BEARINGS_XY];
+    float margins[OA_BENDYRULER_NUM_BEARINGS_XY];
+    bearings[0] = wrap_180(bearing_to_dest);
+    for (uint8_t i = 1; i <= (170 / OA_BENDYRULER_BEARING_INC_XY); i++) {
+        bearings[i*2-1] = wrap_180(bearing_to_dest - i * OA_BENDYRULER_BEARING_INC_XY);
+        bearings[i*2] = wrap_180(bearing_to_dest + i * OA_BENDYRULER_BEARING_INC_XY);
+    }
+    calc_avoidance_margins_xy(current_loc, lookahead_step1_dist, bearings, margins, 1, proximity_only);
+
+    for (uint8_t i = 0; i < OA_BENDYRULER_NUM_BEARINGS_XY; i++) {
+        if (i == 1) {
+            // the direct path is blocked, check all other bearings in one pass
+            calc_avoidance_margins_xy(current_loc, lookahead_step1_dist, &bearings[1], &margins[1], OA_BENDYRULER_NUM_BEARINGS_XY-1, proximity_only);
+        }
 
-            // ToDo: add effective groundspeed calculations using airspeed
-            // ToDo: add prediction of vehicle's position change as part of turn to desired heading
+        // bearing that we are probing
+        const float bearing_test = bearings[i];
 
-            // test location is projected from current location at test bearing
-            Location test_loc = current_loc;
-            test_loc.offset_bearing(bearing_test, lookahead_step1_dist);
+        // ToDo: add effective groundspeed calculations using airspeed
+        // ToDo: add prediction of vehicle's position change as part of turn to desired heading
 
-            // calculate margin from obstacles for this scenario
-            float margin = calc_avoidance_margin(current_loc, test_loc, proximity_only);
-            if (margin > best_margin) {
-                best_margin_bearing = bearing_test;
-                best_margin = margin;
+        // margin from obstacles for this scenario
+        const float margin = margins[i];
+        if (margin > best_margin) {
+            best_margin_bearing = bearing_test;
+            best_margin = margin;
+        }
+        if (margin > _margin_max) {
+            // this bearing avoids obstacles out to the lookahead_step1_dist
+            // now check in there is a clear path in three directions towards the destination
+            if (!have_best_bearing) {
+                best_bearing = bearing_test;
+                have_best_bearing = true;
+            } else if (fabsf(wrap_180(ground_course_deg - bearing_test)) <
+                       fabsf(wrap_180(ground_course_deg - best_bearing))) {
+                // replace bearing with one that is closer to our current ground course
+                best_bearing = bearing_test;
             }
-            if (margin > _margin_max) {
-                // this bearing avoids obstacles out to the lookahead_step1_dist
-                // now check in there is a clear path in three directions towards the destination
-                if (!have_best_bearing) {
-                    best_bearing = bearing_test;
-                    have_best_bearing = true;
-                } else if (fabsf(wrap_180(ground_course_deg - bearing_test)) <
-                           fabsf(wrap_180(ground_course_deg - best_bearing))) {
-                    // replace bearing with one that is closer to our current ground course
-                    best_bearing = bearing_test;
-                }
-
-                // perform second stage test in three directions looking for obstacles
-                const float test_bearings[] { 0.0f, 45.0f, -45.0f };
-                const float bearing_to_dest2 = test_loc.get_bearing_to(destination) * 0.01f;
-                float distance2 = constrain_float(lookahead_step2_dist, OA_BENDYRULER_LOOKAHEAD_STEP2_MIN, test_loc.get_distance(destination));
-                for (uint8_t j = 0; j < ARRAY_SIZE(test_bearings); j++) {
-                    float bearing_test2 = wrap_180(bearing_to_dest2 + test_bearings[j]);
-                    Location test_loc2 = test_loc;
-                    test_loc2.offset_bearing(bearing_test2, distance2);
 
-                    // calculate minimum margin to fence and obstacles for this scenario
-                    float margin2 = calc_avoidance_margin(test_loc, test_loc2, proximity_only);
-                    if (margin2 > _margin_max) {
-                        // if the chosen direction is directly towards the destination avoidance can be turned off
-                        // i == 0 && j == 0 implies no deviation from bearing to destination 
-                        const bool active = (i != 0 || j != 0);
-                        float final_bearing = bearing_test;
-                        float final_margin = margin;
-                        // check if we need ignore test_bearing and continue on previous bearing
-                        const bool ignore_bearing_change = resist_bearing_change(destination, current_loc, active, bearing_test, lookahead_step1_dist, margin, _destination_prev,_bearing_prev, final_bearing, final_margin, proximity_only);
+            // test location is projected from current location at test bearing
+            Location test_loc = current_loc;
+            test_loc.offset_bearing(bearing_test, lookahead_step1_dist);
 
-                        // all good, now project in the chosen direction by the full distance
-                        destination_new = current_loc;
-                        destination_new.offset_bearing(final_bearing, distance_to_dest);
-                        _current_lookahead = MIN(_lookahead, _current_lookahead * 1.1f);
-                        Write_OABendyRuler((uint8_t)OABendyType::OA_BENDY_HORIZONTAL, active, bearing_to_dest, 0.0f, ignore_bearing_change, final_margin, destination, destination_new);
-                        return active;
-                    }
+            // perform second stage test in three directions looking for obstacles
+            const float test_bearings[] { 0.0f, 45.0f, -45.0f };
+            const float bearing_to_dest2 = test_loc.get_bearing_to(destination) * 0.01f;
+            float distance2 = constrain_float(lookahead_step2_dist, OA_BENDYRULER_LOOKAHEAD_STEP2_MIN, test_loc.get_distance(destination));
+            for (uint8_t j = 0; j < ARRAY_SIZE(test_bearings); j++) {
+                float bearing_test2 = wrap_180(bearing_to_dest2 + test_bearings[j]);
+                Location test_loc2 = test_loc;
+                test_loc2.offset_bearing(bearing_test2, distance2);
+
+                // calculate minimum margin to fence and obstacles for this scenario
+                float margin2 = calc_avoidance_margin(test_loc, test_loc2, proximity_only);
+                if (margin2 > _margin_max) {
+                    // if the chosen direction is directly towards the destination avoidance can be turned off
+                    // i == 0 && j == 0 implies no deviation from bearing to destination 
+                    const bool active = (i != 0 || j != 0);
+                    float final_bearing = bearing_test;
+                    float final_margin = margin;
+                    // check if we need ignore test_bearing and continue on previous bearing
+                    const bool ignore_bearing_change = resist_bearing_change(destination, current_loc, active, bearing_test, lookahead_step1_dist, margin, _destination_prev,_bearing_prev, final_bearing, final_margin, proximity_only);
+
+                    // all good, now project in the chosen direction by the full distance
+                    destination_new = current_loc;
+                    destination_new.offset_bearing(final_bearing, distance_to_dest);
+                    _current_lookahead = MIN(_lookahead, _current_lookahead * 1.1f);
+                    Write_OABendyRuler((uint8_t)OABendyType::OA_BENDY_HORIZONTAL, active, bearing_to_dest, 0.0f, ignore_bearing_change, final_margin, destination, destination_new);
+                    return active;
                 }
             }
         }
@@ -440,6 +451,225 @@ float AP_OABendyRuler::calc_avoidance_margin(const Location &start, const Locati
     return margin_min;
 }
 
+// calculate minimum distance between any obstacle and each of count horizontal segments
+// starting at start and running for length meters along bearings (in degrees).
+// This gives the same margins as calling calc_avoidance_margin for each segment but
+// loops over obstacles first so that work that only depends on the obstacle and the
+// shared start point is done once, rather than once per bearing
+void AP_OABendyRuler::calc_avoidance_margins_xy(const Location &start, float length, const float *bearings, float *margins, uint8_t count, bool proximity_only) const
+{
+    // segment directions as unit vectors, north-east
+    Vector2f dirs[OA_BENDYRULER_NUM_BEARINGS_XY];
+    count = MIN(count, OA_BENDYRULER_NUM_BEARINGS_XY);
+    for (uint8_t i = 0; i < count; i++) {
+        const float bearing_rad = radians(bearings[i]);
+        dirs[i] = Vector2f(cosf(bearing_rad), sinf(bearing_rad));
+        margins[i] = FLT_MAX;
+    }
+
+    calc_margins_from_object_database(start, length, dirs, margins, count);
+
+    if (proximity_only) {
+        // only need margin from proximity data
+        return;
+    }
+
+    calc_margins_from_circular_fence(start, length, dirs, margins, count);
+    calc_margins_from_inclusion_and_exclusion_polygons(start, length, dirs, margins, count);
+    calc_margins_from_inclusion_and_exclusion_circles(start, length, dirs, margins, count);
+}
+
+// batched calc_margin_from_circular_fence, lowers margins where the fence is closer
+void AP_OABendyRuler::calc_margins_from_circular_fence(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const
+{
+    // exit immediately if polygon fence is not enabled
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_CIRCLE) == 0) {
+        return;
+    }
+
+    // start point's offset from home
+    const Vector2f start_ofs = AP::ahrs().get_home().get_distance_NE(start);
+    const float start_dist_sq = start_ofs.length_squared();
+
+    // get circular fence radius + margin
+    const float fence_radius_plus_margin = fence->get_radius() - fence->get_margin();
+
+    for (uint8_t i = 0; i < count; i++) {
+        // margin is fence radius minus the longer of start or end distance
+        const float end_dist_sq = (start_ofs + dirs[i] * length).length_squared();
+        margins[i] = MIN(margins[i], fence_radius_plus_margin - sqrtf(MAX(start_dist_sq, end_dist_sq)));
+    }
+}
+
+// batched calc_margin_from_inclusion_and_exclusion_polygons, lowers margins where a polygon is closer
+void AP_OABendyRuler::calc_margins_from_inclusion_and_exclusion_polygons(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const
+{
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+
+    // exclusion polygons enabled along with polygon fences
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_POLYGON) == 0) {
+        return;
+    }
+
+    // return immediately if no inclusion nor exclusion polygons
+    const uint8_t num_inclusion_polygons = fence->polyfence().get_inclusion_polygon_count();
+    const uint8_t num_exclusion_polygons = fence->polyfence().get_exclusion_polygon_count();
+    if ((num_inclusion_polygons == 0) && (num_exclusion_polygons == 0)) {
+        return;
+    }
+
+    // convert start to offset (in cm) from EKF origin
+    Vector2f start_NE;
+    if (!start.get_vector_xy_from_origin_NE(start_NE)) {
+        return;
+    }
+    const float length_cm = length * 100.0f;
+
+    // get fence margin
+    const float fence_margin = fence->get_margin();
+
+    for (uint8_t p = 0; p < num_inclusion_polygons + num_exclusion_polygons; p++) {
+        const bool inclusion = p < num_inclusion_polygons;
+        uint16_t num_points;
+        const Vector2f* boundary = inclusion ? fence->polyfence().get_inclusion_polygon(p, num_points) :
+                                               fence->polyfence().get_exclusion_polygon(p - num_inclusion_polygons, num_points);
+        if (boundary == nullptr) {
+            continue;
+        }
+
+        // margin is negative if start is outside an inclusion polygon or inside an exclusion
+        // polygon. All segments share the start point so this only needs checking once
+        const bool outside = Polygon_outside(start_NE, boundary, num_points);
+        const float sign = (outside != inclusion) ? 1.0f : -1.0f;
+
+        for (uint8_t i = 0; i < count; i++) {
+            // calculate min distance (in meters) from line to polygon
+            const float dist_cm = Polygon_closest_distance_line(boundary, num_points, start_NE, start_NE + dirs[i] * length_cm);
+            margins[i] = MIN(margins[i], (sign * dist_cm * 0.01f) - fence_margin);
+        }
+    }
+}
+
+// batched calc_margin_from_inclusion_and_exclusion_circles, lowers margins where a circle is closer
+void AP_OABendyRuler::calc_margins_from_inclusion_and_exclusion_circles(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const
+{
+    // exit immediately if fence is not enabled
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+
+    // inclusion/exclusion circles enabled along with polygon fences
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_POLYGON) == 0) {
+        return;
+    }
+
+    // return immediately if no inclusion nor exclusion circles
+    const uint8_t num_inclusion_circles = fence->polyfence().get_inclusion_circle_count();
+    const uint8_t num_exclusion_circles = fence->polyfence().get_exclusion_circle_count();
+    if ((num_inclusion_circles == 0) && (num_exclusion_circles == 0)) {
+        return;
+    }
+
+    // convert start to offset (in cm) from EKF origin
+    Vector2f start_NE;
+    if (!start.get_vector_xy_from_origin_NE(start_NE)) {
+        return;
+    }
+    const float length_cm = length * 100.0f;
+
+    // get fence margin
+    const float fence_margin = fence->get_margin();
+
+    // inclusion circles, margin is fence radius minus the longer of start or end distance
+    for (uint8_t c = 0; c < num_inclusion_circles; c++) {
+        Vector2f center_pos_cm;
+        float radius;
+        if (!fence->polyfence().get_inclusion_circle(c, center_pos_cm, radius)) {
+            continue;
+        }
+        const Vector2f start_ofs = start_NE - center_pos_cm;
+        const float start_dist_sq = start_ofs.length_squared();
+        for (uint8_t i = 0; i < count; i++) {
+            const float end_dist_sq = (start_ofs + dirs[i] * length_cm).length_squared();
+            margins[i] = MIN(margins[i], (radius + fence_margin) - (sqrtf(MAX(start_dist_sq, end_dist_sq)) * 0.01f));
+        }
+    }
+
+    // exclusion circles, margin is distance from segment to the center minus the radius
+    for (uint8_t c = 0; c < num_exclusion_circles; c++) {
+        Vector2f center_pos_cm;
+        float radius;
+        if (!fence->polyfence().get_exclusion_circle(c, center_pos_cm, radius)) {
+            continue;
+        }
+        const Vector2f center_ofs = center_pos_cm - start_NE;
+        for (uint8_t i = 0; i < count; i++) {
+            const float dist_cm = segment_distance(center_ofs, dirs[i], length_cm);
+            margins[i] = MIN(margins[i], (dist_cm * 0.01f) - (radius + fence_margin));
+        }
+    }
+}
+
+// batched calc_margin_from_object_database, lowers margins where an obstacle is closer
+void AP_OABendyRuler::calc_margins_from_object_database(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const
+{
+    // exit immediately if db is empty
+    AP_OADatabase *oaDb = AP::oadatabase();
+    if (oaDb == nullptr || !oaDb->healthy() || !is_positive(length)) {
+        return;
+    }
+
+    // convert start to offset (in cm) from EKF origin
+    Vector3f start_NEU;
+    if (!start.get_vector_from_origin_NEU(start_NEU)) {
+        return;
+    }
+
+    if (oaDb->database_count() == 0) {
+        return;
+    }
+
+    // obstacles further away can only have a larger margin than OA_BENDYRULER_DB_SEARCH_MARGIN
+    for (uint8_t i = 0; i < count; i++) {
+        margins[i] = MIN(margins[i], OA_BENDYRULER_DB_SEARCH_MARGIN);
+    }
+
+    // every segment lies within length of start, so one query finds obstacles near any of them
+    const Vector2f start_NE = Vector2f(start_NEU.x, start_NEU.y) * 0.01f;
+    AP_OADatabase::NearbyQuery query;
+    oaDb->query_init(query, start_NE, length + OA_BENDYRULER_DB_SEARCH_MARGIN);
+    uint16_t idx;
+    while (oaDb->query_next(query, idx)) {
+        const AP_OADatabase::OA_DbItem& item = oaDb->get_item(idx);
+
+        // segments are level so the vertical offset to the obstacle is the same along all of them
+        const Vector2f ofs_NE = Vector2f(item.pos.x, item.pos.y) - start_NE;
+        const float ofs_up_sq = sq(item.pos.z - start_NEU.z * 0.01f);
+        for (uint8_t i = 0; i < count; i++) {
+            // margin is distance between line segment and obstacle minus obstacle's radius
+            const float dist_xy = segment_distance(ofs_NE, dirs[i], length);
+            const float m = sqrtf(sq(dist_xy) + ofs_up_sq) - item.radius;
+            margins[i] = MIN(margins[i], m);
+        }
+    }
+}
+
+// distance from a point (given as an offset from a segment's start) to a segment
+// running length along the unit vector dir
+float AP_OABendyRuler::segment_distance(const Vector2f &point_ofs, const Vector2f &dir, float length)
+{
+    const float along = constrain_float(point_ofs * dir, 0.0f, length);
+    return (point_ofs - dir * along).length();
+}
+
 // calculate minimum distance between a path and the circular fence (centered on home)
 // on success returns true and updates margin
 bool AP_OABendyRuler::calc_margin_from_circular_fence(const Location &start, const Location &end, float &margin) const
@@ -659,9 +889,19 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
         return false;
     }
 
-    // check each obstacle's distance from segment
-    float smallest_margin = FLT_MAX;
-    for (uint16_t i=0; i<oaDb->database_count(); i++) {
+    if (oaDb->database_count() == 0) {
+        return false;
+    }
+
+    // check distance from segment of each obstacle near the segment
+    // obstacles further away can only have a larger margin than OA_BENDYRULER_DB_SEARCH_MARGIN
+    float smallest_margin = OA_BENDYRULER_DB_SEARCH_MARGIN;
+    const Vector2f start_NE = Vector2f(start_NEU.x, start_NEU.y) * 0.01f;
+    const Vector2f end_NE = Vector2f(end_NEU.x, end_NEU.y) * 0.01f;
+    AP_OADatabase::NearbyQuery query;
+    oaDb->query_init(query, (start_NE + end_NE) * 0.5f, (end_NE - start_NE).length() * 0.5f + OA_BENDYRULER_DB_SEARCH_MARGIN);
+    uint16_t i;
+    while (oaDb->query_next(query, i)) {
         const AP_OADatabase::OA_DbItem& item = oaDb->get_item(i);
         const Vector3f point_cm = item.pos * 100.0f;
         // margin is distance between line segment and obstacle minus obstacle's radius
@@ -672,10 +912,6 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
     }
 
     // return smallest margin
-    if (smallest_margin < FLT_MAX) {
-        margin = smallest_margin;
-        return true;
-    }
-
-    return false;
+    margin = smallest_margin;
+    return true;
 }
@@ -19,6 +19,9 @@ public:
     // send configuration info stored in front end parameters
     void set_config(float margin_max) { _margin_max = MAX(margin_max, 0.0f); }
 
+    // set time the request being worked on was made, used to log request-to-result latency
+    void set_request_time_ms(uint32_t request_time_ms) { _request_time_ms = request_time_ms; }
+
     // run background task to find best path and update avoidance_results
     // returns true and populates origin_new and destination_new if OA is required.  returns false if OA is not required
     bool update(const Location& current_loc, const Location& destination, const Vector2f &ground_speed_vec, Location &origin_new, Location &destination_new, bool proximity_only);
@@ -45,6 +48,20 @@ private:
     // calculate minimum distance between a path and any obstacle
     float calc_avoidance_margin(const Location &start, const Location &end, bool proximity_only) const;
 
+    // calculate minimum distance between any obstacle and each of count horizontal segments starting
+    // at start and running length meters along bearings.  Results are returned in margins
+    void calc_avoidance_margins_xy(const Location &start, float length, const float *bearings, float *margins, uint8_t count, bool proximity_only) const;
+
+    // batched versions of the calc_margin_from_ functions for segments sharing a start point
+    // dirs holds each segment's direction as a unit vector.  margins are lowered where an obstacle is closer
+    void calc_margins_from_circular_fence(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const;
+    void calc_margins_from_inclusion_and_exclusion_polygons(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const;
+    void calc_margins_from_inclusion_and_exclusion_circles(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const;
+    void calc_margins_from_object_database(const Location &start, float length, const Vector2f *dirs, float *margins, uint8_t count) const;
+
+    // distance from a point (as an offset from a segment's start) to a segment running length along unit vector dir
+    static float segment_distance(const Vector2f &point_ofs, const Vector2f &dir, float length);
+
     // determine if BendyRuler should accept the new bearing or try and resist it. Returns true if bearing is not changed  
     bool resist_bearing_change(const Location &destination, const Location &current_loc, bool active, float bearing_test, float lookahead_step1_dist, float margin, Location &prev_dest, float &prev_bearing, float &final_bearing, float &final_margin, bool proximity_only) const;    
 
@@ -73,6 +90,7 @@ private:
 
     // OA common parameters
     float _margin_max;              // object avoidance will ignore objects more than this many meters from vehicle
+    uint32_t _request_time_ms;      // system time of the request currently being processed
     
     // BendyRuler parameters
     AP_Float _lookahead;            // object avoidance will look this many meters ahead of vehicle
@@ -12,6 +12,7 @@
 */
 
 #include "AP_OADatabase.h"
+#include <AP_Common/MemoryArena.h>
 
 #include <AP_AHRS/AP_AHRS.h>
 #include <GCS_MAVLink/GCS.h>
@@ -35,6 +36,13 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_DISTANCE_FROM_HOME 3
 #endif
 
+#ifndef AP_OADATABASE_GRID_CELL_SIZE
+    #define AP_OADATABASE_GRID_CELL_SIZE 4.0f   // horizontal size (in meters) of spatial index grid cells
+#endif
+
+#define AP_OADATABASE_GRID_NONE 0xFFFF          // index used to indicate the end of a spatial index bucket's list
+#define AP_OADATABASE_QUEUE_POP_MAX 16          // maximum number of items taken from the queue while holding its semaphore
+
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
     // @Param: SIZE
@@ -117,6 +125,7 @@ AP_OADatabase::AP_OADatabase()
 
 void AP_OADatabase::init()
 {
+    WITH_MEMORY_TAG(OADATABASE);
     init_database();
     init_queue();
 
@@ -126,7 +135,13 @@ void AP_OADatabase::init()
     if (!healthy()) {
         gcs().send_text(MAV_SEVERITY_INFO, "DB init failed . Sizes queue:%u, db:%u", (unsigned int)_queue.size, (unsigned int)_database.size);
         delete _queue.items;
-        delete[] _database.items;
+        MemoryArena::release(_database.items, _database.size * sizeof(OA_DbItem), MemoryTag::OADATABASE);
+        MemoryArena::release(_grid.heads, _grid.num_buckets * sizeof(uint16_t), MemoryTag::OADATABASE);
+        MemoryArena::release(_grid.next, _database.size * sizeof(uint16_t), MemoryTag::OADATABASE);
+        _queue.items = nullptr;
+        _database.items = nullptr;
+        _grid.heads = nullptr;
+        _grid.next = nullptr;
         return;
     }
 }
@@ -141,8 +156,8 @@ void AP_OADatabase::update()
     database_items_remove_all_expired();
 }
 
-// push a location into the database
-void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance)
+// push locations into the database
+void AP_OADatabase::queue_push(const Vector3f *pos, const float *distance, uint8_t count, uint32_t timestamp_ms)
 {
     if (!healthy()) {
         return;
@@ -168,15 +183,18 @@ void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float
     }
     #endif
     
-    // ignore objects that are far away
-    if ((_dist_max > 0.0f) && (distance > _dist_max)) {
-        return;
-    }
+    WITH_SEMAPHORE(_queue.sem);
+    for (uint8_t i = 0; i < count; i++) {
+        // ignore objects that are far away
+        if ((_dist_max > 0.0f) && (distance[i] > _dist_max)) {
+            continue;
+        }
 
-    const OA_DbItem item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
-    {
-        WITH_SEMAPHORE(_queue.sem);
-        _queue.items->push(item);
+        const OA_DbItem item = {pos[i], timestamp_ms, MAX(_radius_min, distance[i] * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
+        if (!_queue.items->push(item)) {
+            // queue is full
+            return;
+        }
     }
 }
 
@@ -197,7 +215,123 @@ void AP_OADatabase::init_database()
         return;
     }
 
-    _database.items = new OA_DbItem[_database.size];
+    _database.items = (OA_DbItem *)MemoryArena::allocate(_database.size * sizeof(OA_DbItem), MemoryTag::OADATABASE);
+
+    // spatial index has around two objects per bucket when database is full
+    _grid.num_buckets = 1;
+    while ((_grid.num_buckets < 8192) && (_grid.num_buckets * 2U < _database.size)) {
+        _grid.num_buckets *= 2;
+    }
+    _grid.next = (uint16_t *)MemoryArena::allocate(_database.size * sizeof(uint16_t), MemoryTag::OADATABASE);
+    _grid.heads = (uint16_t *)MemoryArena::allocate(_grid.num_buckets * sizeof(uint16_t), MemoryTag::OADATABASE);
+    if ((_grid.next == nullptr) || (_grid.heads == nullptr)) {
+        MemoryArena::release(_grid.heads, _grid.num_buckets * sizeof(uint16_t), MemoryTag::OADATABASE);
+        MemoryArena::release(_grid.next, _database.size * sizeof(uint16_t), MemoryTag::OADATABASE);
+        _grid.next = nullptr;
+        _grid.heads = nullptr;
+        return;
+    }
+    for (uint16_t i=0; i<_grid.num_buckets; i++) {
+        _grid.heads[i] = AP_OADATABASE_GRID_NONE;
+    }
+}
+
+// returns the spatial index grid cell holding a north or east position
+int32_t AP_OADatabase::grid_cell(float pos) const
+{
+    return (int32_t)floorf(pos * (1.0f / AP_OADATABASE_GRID_CELL_SIZE));
+}
+
+// returns the spatial index bucket for a grid cell
+uint16_t AP_OADatabase::grid_bucket(int32_t cell_x, int32_t cell_y) const
+{
+    const uint32_t hash = ((uint32_t)cell_x * 73856093U) ^ ((uint32_t)cell_y * 19349663U);
+    return hash & (_grid.num_buckets - 1);
+}
+
+// add database item "index" to the spatial index
+void AP_OADatabase::grid_link(const uint16_t index)
+{
+    const uint16_t bucket = grid_bucket(_database.items[index].pos);
+    _grid.next[index] = _grid.heads[bucket];
+    _grid.heads[bucket] = index;
+}
+
+// remove database item "index" from the spatial index
+void AP_OADatabase::grid_unlink(const uint16_t index)
+{
+    uint16_t *link = &_grid.heads[grid_bucket(_database.items[index].pos)];
+    while (*link != AP_OADATABASE_GRID_NONE) {
+        if (*link == index) {
+            *link = _grid.next[index];
+            return;
+        }
+        link = &_grid.next[*link];
+    }
+}
+
+// start a search for items whose edge may be within radius (in meters) of center horizontally
+void AP_OADatabase::query_init(NearbyQuery &query, const Vector2f &center, float radius) const
+{
+    query.center = center;
+    query.radius = radius + _database.radius_max;
+    query.cell_x_min = grid_cell(center.x - query.radius);
+    query.cell_x_max = grid_cell(center.x + query.radius);
+    query.cell_y_min = grid_cell(center.y - query.radius);
+    query.cell_y_max = grid_cell(center.y + query.radius);
+    query.cell_x = query.cell_x_min;
+    query.cell_y = query.cell_y_min;
+
+    // searching cells costs more than checking every item if there are more cells than items
+    const float num_cells = float(query.cell_x_max - query.cell_x_min + 1) * float(query.cell_y_max - query.cell_y_min + 1);
+    query.linear = !healthy() || (num_cells > _database.count);
+    if (query.linear) {
+        query.next_index = 0;
+    } else {
+        query.next_index = _grid.heads[grid_bucket(query.cell_x, query.cell_y)];
+    }
+}
+
+// get the index of the next item found by a search, returns false when the search is complete
+bool AP_OADatabase::query_next(NearbyQuery &query, uint16_t &index) const
+{
+    const float radius_sq = sq(query.radius);
+
+    if (query.linear) {
+        while (query.next_index < _database.count) {
+            const uint16_t i = query.next_index++;
+            if ((Vector2f(_database.items[i].pos.x, _database.items[i].pos.y) - query.center).length_squared() <= radius_sq) {
+                index = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    while (true) {
+        // walk the current cell's bucket.  Other cells may share the bucket so check each item is in the current cell
+        while (query.next_index != AP_OADATABASE_GRID_NONE) {
+            const uint16_t i = query.next_index;
+            query.next_index = _grid.next[i];
+            const Vector3f &pos = _database.items[i].pos;
+            if ((grid_cell(pos.x) == query.cell_x) && (grid_cell(pos.y) == query.cell_y) &&
+                ((Vector2f(pos.x, pos.y) - query.center).length_squared() <= radius_sq)) {
+                index = i;
+                return true;
+            }
+        }
+
+        // move to next cell
+        query.cell_y++;
+        if (query.cell_y > query.cell_y_max) {
+            query.cell_y = query.cell_y_min;
+            query.cell_x++;
+            if (query.cell_x > query.cell_x_max) {
+                return false;
+            }
+        }
+        query.next_index = _grid.heads[grid_bucket(query.cell_x, query.cell_y)];
+    }
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -243,23 +377,32 @@ bool AP_OADatabase::process_queue()
         return false;
     }
 
+    // items are taken from the queue a few at a time to reduce locking
+    OA_DbItem items[AP_OADATABASE_QUEUE_POP_MAX];
+    uint8_t items_count = 0;
+    uint8_t items_index = 0;
     for (uint16_t queue_index=0; queue_index<queue_available; queue_index++) {
-        OA_DbItem item;
-
-        bool pop_success;
-        {
+        if (items_index >= items_count) {
             WITH_SEMAPHORE(_queue.sem);
-            pop_success = _queue.items->pop(item);
+            items_count = _queue.items->peek(items, MIN(queue_available - queue_index, ARRAY_SIZE(items)));
+            for (uint8_t i = 0; i < items_count; i++) {
+                _queue.items->pop();
+            }
+            items_index = 0;
         }
-        if (!pop_success) {
+        if (items_index >= items_count) {
             return false;
         }
+        OA_DbItem &item = items[items_index++];
 
         item.send_to_gcs = get_send_to_gcs_flags(item.importance);
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
+        // compare item to nearby items in database. If found a similar item, update the existing, else add it as a new one
         bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
+        NearbyQuery query;
+        query_init(query, Vector2f(item.pos.x, item.pos.y), item.radius);
+        uint16_t i;
+        while (query_next(query, i)) {
             if (is_close_to_item_in_database(i, item)) {
                 database_item_refresh(i, item.timestamp_ms, item.radius);
                 found = true;
@@ -281,6 +424,8 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    grid_link(_database.count);
+    _database.radius_max = MAX(_database.radius_max, item.radius);
     _database.count++;
 }
 
@@ -294,6 +439,7 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+    grid_unlink(index);
 
     _database.count--;
     if (_database.count == 0) {
@@ -302,8 +448,10 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        grid_unlink(_database.count);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        grid_link(index);
     }
 }
 
@@ -324,6 +472,7 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        _database.radius_max = MAX(_database.radius_max, radius);
     }
 }
 
@@ -340,13 +489,18 @@ void AP_OADatabase::database_items_remove_all_expired()
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
     uint16_t index = 0;
+    float radius_max = 0;
     while (index < _database.count) {
         if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
             database_item_remove(index);
         } else {
+            radius_max = MAX(radius_max, _database.items[index].radius);
             index++;
         }
     }
+
+    // shrink largest radius used by nearby searches now that expired objects are gone
+    _database.radius_max = radius_max;
 }
 
 // returns true if a similar object already exists in database. When true, the object timer is also reset
@@ -35,10 +35,14 @@ public:
     void update();
 
     // push an object into the database.  Pos is the offset in meters from the EKF origin, angle is in degrees, distance in meters
-    void queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance);
+    void queue_push(const Vector3f &pos, uint32_t timestamp_ms, float distance) { queue_push(&pos, &distance, 1, timestamp_ms); }
+
+    // push count objects into the database in one operation, taking the queue semaphore once.  Used by
+    // proximity backends to publish a whole scan segment.  All objects share the same timestamp
+    void queue_push(const Vector3f *pos, const float *distance, uint8_t count, uint32_t timestamp_ms);
 
     // returns true if database is healthy
-    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr); }
+    bool healthy() const { return (_queue.items != nullptr) && (_database.items != nullptr) && (_grid.heads != nullptr); }
 
     // fetch an item in database. Undefined result when i >= _database.count.
     const OA_DbItem& get_item(uint32_t i) const { return _database.items[i]; }
@@ -49,6 +53,27 @@ public:
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
+    // state of a search for items near a horizontal position, see query_init and query_next
+    struct NearbyQuery {
+        Vector2f center;        // centre of search as an offset in meters from the EKF origin
+        float radius;           // search radius plus radius of largest item in meters
+        int32_t cell_x_min;     // range of grid cells being searched
+        int32_t cell_x_max;
+        int32_t cell_y_min;
+        int32_t cell_y_max;
+        int32_t cell_x;         // grid cell currently being searched
+        int32_t cell_y;
+        uint16_t next_index;    // next item to check in the current cell (or in the whole database if linear)
+        bool linear;            // true if searching every item is cheaper than searching grid cells
+    };
+
+    // start a search for items whose edge may be within radius (in meters) of center horizontally
+    void query_init(NearbyQuery &query, const Vector2f &center, float radius) const;
+
+    // get the index of the next item found by a search, returns false when the search is complete
+    // items may be further away than requested, so callers should still check each item's distance
+    bool query_next(NearbyQuery &query, uint16_t &index) const;
+
     // send ADSB_VEHICLE mavlink messages
     void send_adsb_vehicle(mavlink_channel_t chan, uint16_t interval_ms);
 
@@ -73,6 +98,13 @@ private:
     // returns true if database item "index" is close to "item"
     bool is_close_to_item_in_database(const uint16_t index, const OA_DbItem &item) const;
 
+    // spatial index management
+    int32_t grid_cell(float pos) const;
+    uint16_t grid_bucket(int32_t cell_x, int32_t cell_y) const;
+    uint16_t grid_bucket(const Vector3f &pos) const { return grid_bucket(grid_cell(pos.x), grid_cell(pos.y)); }
+    void grid_link(const uint16_t index);
+    void grid_unlink(const uint16_t index);
+
     // enum for use with _OUTPUT parameter
     enum class OA_DbOutputLevel {
         OUTPUT_LEVEL_DISABLED = 0,
@@ -102,8 +134,17 @@ private:
         OA_DbItem       *items;                             // array of objects in the database
         uint16_t        count;                              // number of objects in the items array
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
+        float           radius_max;                         // radius of largest object (may be larger than any object held after objects are removed)
     } _database;
 
+    // spatial index of objects in the database.  Objects are hashed into buckets by the horizontal grid cell they are in
+    // and each bucket holds a linked list of the objects in it
+    struct {
+        uint16_t        *heads;                             // index of first object in each bucket (or AP_OADATABASE_GRID_NONE if empty)
+        uint16_t        *next;                              // index of next object in same bucket for each object in _database
+        uint16_t        num_buckets;                        // number of buckets (always a power of two)
+    } _grid;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
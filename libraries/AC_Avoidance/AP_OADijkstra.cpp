@@ -28,7 +28,10 @@ AP_OADijkstra::AP_OADijkstra() :
         _inclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_circle_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_adj_start(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_adj_items(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _short_path_data(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _heap(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _path(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK)
 {
 }
@@ -630,6 +633,47 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         }
     }
 
+    if (!build_fence_adjacency()) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    return true;
+}
+
+// build index of fence visgraph items by fence point
+// returns false if out of memory
+bool AP_OADijkstra::build_fence_adjacency()
+{
+    const uint16_t numpoints = total_numpoints();
+    const uint16_t num_items = _fence_visgraph.num_items();
+    if (!_fence_adj_start.expand_to_hold(numpoints + 1) ||
+        !_fence_adj_items.expand_to_hold(num_items * 2)) {
+        return false;
+    }
+
+    // count items touching each point, offset by one so the running sum gives each point's start
+    for (uint16_t i = 0; i <= numpoints; i++) {
+        _fence_adj_start[i] = 0;
+    }
+    for (uint16_t i = 0; i < num_items; i++) {
+        _fence_adj_start[_fence_visgraph[i].id1.id_num + 1]++;
+        _fence_adj_start[_fence_visgraph[i].id2.id_num + 1]++;
+    }
+    for (uint16_t i = 1; i <= numpoints; i++) {
+        _fence_adj_start[i] += _fence_adj_start[i-1];
+    }
+
+    // fill in items, using each point's start as a cursor, then shift the starts back into place
+    for (uint16_t i = 0; i < num_items; i++) {
+        _fence_adj_items[_fence_adj_start[_fence_visgraph[i].id1.id_num]++] = i;
+        _fence_adj_items[_fence_adj_start[_fence_visgraph[i].id2.id_num]++] = i;
+    }
+    for (uint16_t i = numpoints; i > 0; i--) {
+        _fence_adj_start[i] = _fence_adj_start[i-1];
+    }
+    _fence_adj_start[0] = 0;
+
     return true;
 }
 
@@ -684,38 +728,43 @@ void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
     // get current node for convenience
     const ShortPathNode &curr_node = _short_path_data[curr_node_idx];
 
-    // for each visibility graph
-    const AP_OAVisGraph* visgraphs[] = {&_fence_visgraph, &_destination_visgraph};
-    for (uint8_t v=0; v<ARRAY_SIZE(visgraphs); v++) {
-
-        // skip if empty
-        const AP_OAVisGraph &curr_visgraph = *visgraphs[v];
-        if (curr_visgraph.num_items() == 0) {
-            continue;
-        }
-
-        // search visibility graph for items visible from current_node
-        for (uint16_t i = 0; i < curr_visgraph.num_items(); i++) {
-            const AP_OAVisGraph::VisGraphItem &item = curr_visgraph[i];
-            // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
-            if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
-                AP_OAVisGraph::OAItemID matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
-                // find item's id in node array
-                node_index item_node_idx;
-                if (find_node_from_id(matching_id, item_node_idx)) {
-                    // if current node's distance + distance to item is less than item's current distance, update item's distance
-                    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
-                    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
-                        // update item's distance and set "distance_from_idx" to current node's index
-                        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
-                        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
-                    }
-                }
-            }
+    // only fence points have neighbours in the fence visgraph
+    if (curr_node.id.id_type == AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT) {
+        const uint16_t adj_end = _fence_adj_start[curr_node.id.id_num + 1];
+        for (uint16_t a = _fence_adj_start[curr_node.id.id_num]; a < adj_end; a++) {
+            const AP_OAVisGraph::VisGraphItem &item = _fence_visgraph[_fence_adj_items[a]];
+            relax_node_distance(curr_node_idx, (curr_node.id == item.id1) ? item.id2 : item.id1, item.distance_cm);
+        }
+    }
+
+    // search destination visibility graph for items visible from current_node
+    for (uint16_t i = 0; i < _destination_visgraph.num_items(); i++) {
+        const AP_OAVisGraph::VisGraphItem &item = _destination_visgraph[i];
+        // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
+        if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
+            relax_node_distance(curr_node_idx, (curr_node.id == item.id1) ? item.id2 : item.id1, item.distance_cm);
         }
     }
 }
 
+// update a node's distance if reaching it via curr_node_idx is shorter
+void AP_OADijkstra::relax_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm)
+{
+    // find item's id in node array
+    node_index item_node_idx;
+    if (!find_node_from_id(id, item_node_idx) || _short_path_data[item_node_idx].visited) {
+        return;
+    }
+    // if current node's distance + distance to item is less than item's current distance, update item's distance
+    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + distance_cm;
+    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
+        // update item's distance and set "distance_from_idx" to current node's index
+        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
+        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
+        heap_update(item_node_idx);
+    }
+}
+
 // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
 // returns true if successful and node_idx is updated
 bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const
@@ -748,27 +797,72 @@ bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_in
     return false;
 }
 
-// find index of node with lowest tentative distance (ignore visited nodes)
+// find index of node with lowest tentative distance (ignore visited nodes) and remove it from the heap
 // returns true if successful and node_idx argument is updated
-bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
+bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx)
 {
-    node_index lowest_idx = 0;
-    float lowest_dist = FLT_MAX;
+    if (_heap_numpoints == 0) {
+        return false;
+    }
+
+    // lowest distance is at the top of the heap
+    node_idx = _heap[0];
+    _heap_numpoints--;
+    if (_heap_numpoints > 0) {
+        heap_swap(0, _heap_numpoints);
+    }
+    _short_path_data[node_idx].heap_pos = OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX;
 
-    // scan through all nodes looking for closest
-    for (node_index i=0; i<_short_path_data_numpoints; i++) {
-        const ShortPathNode &node = _short_path_data[i];
-        if (!node.visited && (node.distance_cm < lowest_dist)) {
-            lowest_idx = i;
-            lowest_dist = node.distance_cm;
+    // move new top of heap down to its place
+    node_index pos = 0;
+    while (true) {
+        const uint16_t left = 2 * pos + 1;
+        const uint16_t right = left + 1;
+        uint16_t smallest = pos;
+        if ((left < _heap_numpoints) && (_short_path_data[_heap[left]].distance_cm < _short_path_data[_heap[smallest]].distance_cm)) {
+            smallest = left;
         }
+        if ((right < _heap_numpoints) && (_short_path_data[_heap[right]].distance_cm < _short_path_data[_heap[smallest]].distance_cm)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heap_swap(pos, smallest);
+        pos = smallest;
     }
 
-    if (lowest_dist < FLT_MAX) {
-        node_idx = lowest_idx;
-        return true;
+    return true;
+}
+
+// add a node to the heap or move it up after its distance has been reduced
+void AP_OADijkstra::heap_update(node_index node_idx)
+{
+    node_index pos = _short_path_data[node_idx].heap_pos;
+    if (pos == OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX) {
+        // heap was sized to hold all nodes in calc_shortest_path
+        pos = _heap_numpoints++;
+        _heap[pos] = node_idx;
+        _short_path_data[node_idx].heap_pos = pos;
+    }
+    while (pos > 0) {
+        const node_index parent = (pos - 1) / 2;
+        if (_short_path_data[_heap[parent]].distance_cm <= _short_path_data[_heap[pos]].distance_cm) {
+            break;
+        }
+        heap_swap(pos, parent);
+        pos = parent;
     }
-    return false;
+}
+
+// swap two heap elements keeping the nodes' heap positions up to date
+void AP_OADijkstra::heap_swap(node_index pos1, node_index pos2)
+{
+    const node_index tmp = _heap[pos1];
+    _heap[pos1] = _heap[pos2];
+    _heap[pos2] = tmp;
+    _short_path_data[_heap[pos1]].heap_pos = pos1;
+    _short_path_data[_heap[pos2]].heap_pos = pos2;
 }
 
 // calculate shortest path from origin to destination
@@ -794,21 +888,22 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         return false;
     }
 
-    // expand _short_path_data if necessary
-    if (!_short_path_data.expand_to_hold(2 + total_numpoints())) {
+    // expand _short_path_data and _heap if necessary
+    if (!_short_path_data.expand_to_hold(2 + total_numpoints()) || !_heap.expand_to_hold(2 + total_numpoints())) {
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
 
-    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm, heap_pos) to short_path_data array
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     _short_path_data_numpoints = 2;
 
-    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
+    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm, heap_pos)
     for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX};
     }
+    _heap_numpoints = 0;
 
     // start algorithm from source point
     node_index current_node_idx = 0;
@@ -819,6 +914,7 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
             _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
             _short_path_data[node_idx].distance_from_idx = current_node_idx;
+            heap_update(node_idx);
         } else {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
             return false;
@@ -829,11 +925,16 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
 
     // move current_node_idx to node with lowest distance
     while (find_closest_node_idx(current_node_idx)) {
-        // update distances to all neighbours of current node
-        update_visible_node_distances(current_node_idx);
-
         // mark current node as visited
         _short_path_data[current_node_idx].visited = true;
+
+        // destination's distance is final once it is the closest node so no need to search further
+        if (_short_path_data[current_node_idx].id.id_type == AP_OAVisGraph::OATYPE_DESTINATION) {
+            break;
+        }
+
+        // update distances to all neighbours of current node
+        update_visible_node_distances(current_node_idx);
     }
 
     // extract path starting from destination
@@ -25,6 +25,9 @@ public:
     // trigger Dijkstra's to recalculate shortest path based on current location 
     void recalculate_path() { _shortest_path_ok = false; }
 
+    // set time the request being worked on was made, used to log request-to-result latency
+    void set_request_time_ms(uint32_t request_time_ms) { _request_time_ms = request_time_ms; }
+
     // update return status enum
     enum AP_OADijkstra_State : uint8_t {
         DIJKSTRA_STATE_NOT_REQUIRED = 0,
@@ -156,12 +159,22 @@ private:
     // returns true on success
     bool update_visgraph(AP_OAVisGraph& visgraph, const AP_OAVisGraph::OAItemID& oaid, const Vector2f &position, bool add_extra_position = false, Vector2f extra_position = Vector2f(0,0));
 
+    // index of fence visgraph items by fence point, so the neighbours of a point can be found
+    // without scanning the whole graph.  items touching fence point i are held in
+    // _fence_adj_items[_fence_adj_start[i]] to _fence_adj_items[_fence_adj_start[i+1]-1]
+    AP_ExpandingArray<uint16_t> _fence_adj_start;
+    AP_ExpandingArray<uint16_t> _fence_adj_items;
+
+    // build the index above from _fence_visgraph, returns false if out of memory
+    bool build_fence_adjacency();
+
     typedef uint8_t node_index;         // indices into short path data
     struct ShortPathNode {
         AP_OAVisGraph::OAItemID id;     // unique id for node (combination of type and id number)
         bool visited;                   // true if all this node's neighbour's distances have been updated
         node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        node_index heap_pos;            // position of node in _heap (or 255 if not in heap)
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
@@ -170,13 +183,24 @@ private:
     // curr_node_idx is an index into the _short_path_data array
     void update_visible_node_distances(node_index curr_node_idx);
 
+    // update a node's distance if reaching it via curr_node_idx is shorter
+    void relax_node_distance(node_index curr_node_idx, const AP_OAVisGraph::OAItemID &id, float distance_cm);
+
     // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
-    // find index of node with lowest tentative distance (ignore visited nodes)
+    // find index of node with lowest tentative distance (ignore visited nodes) and remove it from the heap
     // returns true if successful and node_idx argument is updated
-    bool find_closest_node_idx(node_index &node_idx) const;
+    bool find_closest_node_idx(node_index &node_idx);
+
+    // binary min-heap of unvisited nodes with a tentative distance, ordered by distance_cm
+    AP_ExpandingArray<node_index> _heap;
+    node_index _heap_numpoints;         // number of nodes held in _heap
+
+    // add a node to the heap or move it up after its distance has been reduced
+    void heap_update(node_index node_idx);
+    void heap_swap(node_index pos1, node_index pos2);
 
     // final path variables and functions
     AP_ExpandingArray<AP_OAVisGraph::OAItemID> _path;   // ids of points on return path in reverse order (i.e. destination is first element)
@@ -189,6 +213,7 @@ private:
 
     AP_OADijkstra_Error _error_last_id;                 // last error id sent to GCS
     uint32_t _error_last_report_ms;                     // last time an error message was sent to GCS
+    uint32_t _request_time_ms;                          // system time of the request currently being processed
 
     // Logging function
     void Write_OADijkstra(const uint8_t state, const uint8_t error_id, const uint8_t curr_point, const uint8_t tot_points, const Location &final_dest, const Location &oa_dest) const;
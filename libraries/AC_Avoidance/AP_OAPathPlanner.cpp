@@ -28,6 +28,7 @@ const float OA_MARGIN_MAX_DEFAULT = 5;
 const int16_t OA_OPTIONS_DEFAULT = 1;
 
 const int16_t OA_UPDATE_MS = 1000;      // path planning updates run at 1hz
+const int16_t OA_BENDYRULER_UPDATE_MS = 100;    // BendyRuler runs at 10hz when combined with Dijkstra's
 const int16_t OA_TIMEOUT_MS = 3000;     // results over 3 seconds old are ignored
 
 const AP_Param::GroupInfo AP_OAPathPlanner::var_info[] = {
@@ -170,6 +171,17 @@ bool AP_OAPathPlanner::start_thread()
         return false;
     }
     _thread_created = true;
+
+    // when combined with BendyRuler, Dijkstra's gets its own thread
+    if (_type == OA_PATHPLAN_DJIKSTRA_BENDYRULER) {
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_OAPathPlanner::dijkstra_thread, void),
+                                          "OA_dijkstra",
+                                          8192, AP_HAL::Scheduler::PRIORITY_IO, -1)) {
+            // avoidance_thread reports errors if Dijkstra's results never arrive
+            return false;
+        }
+        _dijkstra_thread_created = true;
+    }
     return true;
 }
 
@@ -219,10 +231,9 @@ AP_OAPathPlanner::OA_RetState AP_OAPathPlanner::mission_avoidance(const Location
     return OA_PROCESSING;
 }
 
-// avoidance thread that continually updates the avoidance_result structure based on avoidance_request
-void AP_OAPathPlanner::avoidance_thread()
+// wait for the EKF origin to be set
+void AP_OAPathPlanner::wait_for_ekf_origin() const
 {
-    // require ekf origin to have been set
     bool origin_set = false;
     while (!origin_set) {
         hal.scheduler->delay(500);
@@ -232,6 +243,30 @@ void AP_OAPathPlanner::avoidance_thread()
             origin_set = AP::ahrs().get_origin(ekf_origin);    
         }
     }
+}
+
+// run Dijkstra's for a request, returning the result as an OA_RetState
+AP_OAPathPlanner::OA_RetState AP_OAPathPlanner::run_dijkstra(const avoidance_info &request, Location &origin_new, Location &destination_new)
+{
+    _oadijkstra->set_fence_margin(_margin_max);
+    _oadijkstra->set_request_time_ms(request.request_time_ms);
+    const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(request.current_loc, request.destination, origin_new, destination_new);
+    switch (dijkstra_state) {
+    case AP_OADijkstra::DIJKSTRA_STATE_NOT_REQUIRED:
+        return OA_NOT_REQUIRED;
+    case AP_OADijkstra::DIJKSTRA_STATE_ERROR:
+        return OA_ERROR;
+    case AP_OADijkstra::DIJKSTRA_STATE_SUCCESS:
+        return OA_SUCCESS;
+    }
+    return OA_ERROR;
+}
+
+// avoidance thread that continually updates the avoidance_result structure based on avoidance_request
+void AP_OAPathPlanner::avoidance_thread()
+{
+    // require ekf origin to have been set
+    wait_for_ekf_origin();
 
     while (true) {
 
@@ -242,8 +277,11 @@ void AP_OAPathPlanner::avoidance_thread()
             hal.scheduler->delay(20);
         }
 
+        // BendyRuler runs faster when Dijkstra's is in its own thread so
+        // it reacts quickly to new proximity obstacles
+        const uint32_t update_ms = (_type == OA_PATHPLAN_DJIKSTRA_BENDYRULER) ? OA_BENDYRULER_UPDATE_MS : OA_UPDATE_MS;
         const uint32_t now = AP_HAL::millis();
-        if (now - avoidance_latest_ms < OA_UPDATE_MS) {
+        if (now - avoidance_latest_ms < update_ms) {
             continue;
         }
         avoidance_latest_ms = now;
@@ -277,61 +315,47 @@ void AP_OAPathPlanner::avoidance_thread()
                 continue;
             }
             _oabendyruler->set_config(_margin_max);
+            _oabendyruler->set_request_time_ms(avoidance_request2.request_time_ms);
             if (_oabendyruler->update(avoidance_request2.current_loc, avoidance_request2.destination, avoidance_request2.ground_speed_vec, origin_new, destination_new, false)) {
                 res = OA_SUCCESS;
             }
             break;
 
-        case OA_PATHPLAN_DIJKSTRA: {
+        case OA_PATHPLAN_DIJKSTRA:
             if (_oadijkstra == nullptr) {
                 continue;
             }
-            _oadijkstra->set_fence_margin(_margin_max);
-            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(avoidance_request2.current_loc, avoidance_request2.destination, origin_new, destination_new);
-            switch (dijkstra_state) {
-            case AP_OADijkstra::DIJKSTRA_STATE_NOT_REQUIRED:
-                res = OA_NOT_REQUIRED;
-                break;
-            case AP_OADijkstra::DIJKSTRA_STATE_ERROR:
-                res = OA_ERROR;
-                break;
-            case AP_OADijkstra::DIJKSTRA_STATE_SUCCESS:
-                res = OA_SUCCESS;
-                break;
-            }
+            res = run_dijkstra(avoidance_request2, origin_new, destination_new);
             break;
-        }
 
         case OA_PATHPLAN_DJIKSTRA_BENDYRULER: {
-            if ((_oabendyruler == nullptr) || _oadijkstra == nullptr) {
+            if ((_oabendyruler == nullptr) || _oadijkstra == nullptr || !_dijkstra_thread_created) {
                 continue;
             } 
             _oabendyruler->set_config(_margin_max);
+            _oabendyruler->set_request_time_ms(avoidance_request2.request_time_ms);
             if (_oabendyruler->update(avoidance_request2.current_loc, avoidance_request2.destination, avoidance_request2.ground_speed_vec, origin_new, destination_new, proximity_only)) {
                 // detected a obstacle by vehicle's proximity sensor. Switch avoidance to BendyRuler till obstacle is out of the way
                 proximity_only = false;
                 res = OA_SUCCESS;
                 break;
-            } else {
-                // cleared all obstacles, trigger Dijkstra's to calculate path based on current deviated position  
-                if (proximity_only == false) {
-                    _oadijkstra->recalculate_path();
-                }
-                // only use proximity avoidance now for BendyRuler
-                proximity_only = true;
             }
-            _oadijkstra->set_fence_margin(_margin_max);
-            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(avoidance_request2.current_loc, avoidance_request2.destination, origin_new, destination_new);
-            switch (dijkstra_state) {
-            case AP_OADijkstra::DIJKSTRA_STATE_NOT_REQUIRED:
-                res = OA_NOT_REQUIRED;
-                break;
-            case AP_OADijkstra::DIJKSTRA_STATE_ERROR:
-                res = OA_ERROR;
-                break;
-            case AP_OADijkstra::DIJKSTRA_STATE_SUCCESS:
-                res = OA_SUCCESS;
-                break;
+            WITH_SEMAPHORE(_rsem);
+            if (proximity_only == false) {
+                // cleared all obstacles, trigger Dijkstra's to calculate path based on current deviated position
+                _dijkstra_recalculate = true;
+            }
+            // only use proximity avoidance now for BendyRuler
+            proximity_only = true;
+
+            // follow Dijkstra's latest path if it is for this destination and is not about to be recalculated
+            const bool destination_matches = (avoidance_request2.destination.lat == dijkstra_result.destination.lat) && (avoidance_request2.destination.lng == dijkstra_result.destination.lng);
+            if (destination_matches && !_dijkstra_recalculate && (AP_HAL::millis() - dijkstra_result.result_time_ms <= OA_TIMEOUT_MS)) {
+                origin_new = dijkstra_result.origin_new;
+                destination_new = dijkstra_result.destination_new;
+                res = dijkstra_result.ret_state;
+            } else {
+                res = OA_PROCESSING;
             }
             break;
         }
@@ -350,6 +374,59 @@ void AP_OAPathPlanner::avoidance_thread()
     }
 }
 
+// Dijkstra's thread that updates dijkstra_result based on avoidance_request when combined with BendyRuler
+void AP_OAPathPlanner::dijkstra_thread()
+{
+    // require ekf origin to have been set
+    wait_for_ekf_origin();
+
+    while (true) {
+        hal.scheduler->delay(20);
+
+        if ((_type != OA_PATHPLAN_DJIKSTRA_BENDYRULER) || (_oadijkstra == nullptr)) {
+            continue;
+        }
+
+        const uint32_t now = AP_HAL::millis();
+        avoidance_info request;
+        bool recalculate;
+        {
+            WITH_SEMAPHORE(_rsem);
+            if (now - avoidance_request.request_time_ms > OA_TIMEOUT_MS) {
+                // this is a very old request, don't process it
+                continue;
+            }
+            // replan straight away for a new destination or once BendyRuler is done
+            const bool destination_changed = (avoidance_request.destination.lat != dijkstra_result.destination.lat) || (avoidance_request.destination.lng != dijkstra_result.destination.lng);
+            recalculate = _dijkstra_recalculate;
+            if (!recalculate && !destination_changed && (now - dijkstra_latest_ms < OA_UPDATE_MS)) {
+                continue;
+            }
+            request = avoidance_request;
+            _dijkstra_recalculate = false;
+        }
+        dijkstra_latest_ms = now;
+
+        if (recalculate) {
+            _oadijkstra->recalculate_path();
+        }
+
+        Location origin_new = request.origin;
+        Location destination_new = request.destination;
+        const OA_RetState res = run_dijkstra(request, origin_new, destination_new);
+
+        {
+            // give avoidance_thread the result
+            WITH_SEMAPHORE(_rsem);
+            dijkstra_result.destination = request.destination;
+            dijkstra_result.origin_new = origin_new;
+            dijkstra_result.destination_new = destination_new;
+            dijkstra_result.result_time_ms = AP_HAL::millis();
+            dijkstra_result.ret_state = res;
+        }
+    }
+}
+
 // singleton instance
 AP_OAPathPlanner *AP_OAPathPlanner::_singleton;
 
@@ -74,6 +74,13 @@ private:
     void avoidance_thread();
     bool start_thread();
 
+    // Dijkstra's thread used when Dijkstra's and BendyRuler are combined. This keeps
+    // global replans from holding up BendyRuler's reactive checks in avoidance_thread
+    void dijkstra_thread();
+
+    // wait for the EKF origin to be set, OA algorithms work relative to it
+    void wait_for_ekf_origin() const;
+
     // an avoidance request from the navigation code
     struct avoidance_info {
         Location current_loc;
@@ -83,6 +90,9 @@ private:
         uint32_t request_time_ms;
     } avoidance_request, avoidance_request2;
 
+    // run Dijkstra's for a request, returning the result as an OA_RetState
+    OA_RetState run_dijkstra(const avoidance_info &request, Location &origin_new, Location &destination_new);
+
     // an avoidance result from the avoidance thread
     struct {
         Location destination;       // destination vehicle is trying to get to (also used to verify the result matches a recent request)
@@ -92,6 +102,15 @@ private:
         OA_RetState ret_state;      // OA_SUCCESS if the vehicle should move along the path from origin_new to destination_new
     } avoidance_result;
 
+    // latest result from dijkstra_thread, protected by _rsem
+    struct {
+        Location destination;       // destination used for the calculation
+        Location origin_new;        // intermediate origin
+        Location destination_new;   // intermediate destination
+        uint32_t result_time_ms;    // system time the result was calculated
+        OA_RetState ret_state;      // Dijkstra's result state
+    } dijkstra_result;
+
     // parameters
     AP_Int8 _type;                  // avoidance algorithm to be used
     AP_Float _margin_max;           // object avoidance will ignore objects more than this many meters from vehicle
@@ -100,10 +119,13 @@ private:
     // internal variables used by front end
     HAL_Semaphore _rsem;            // semaphore for multi-thread use of avoidance_request and avoidance_result
     bool _thread_created;           // true once background thread has been created
+    bool _dijkstra_thread_created;  // true once the Dijkstra's thread has been created
+    bool _dijkstra_recalculate;     // true when BendyRuler has moved the vehicle off Dijkstra's path, protected by _rsem
     AP_OABendyRuler *_oabendyruler; // Bendy Ruler algorithm
     AP_OADijkstra *_oadijkstra;     // Dijkstra's algorithm
     AP_OADatabase _oadatabase;      // Database of dynamic objects to avoid
     uint32_t avoidance_latest_ms;   // last time Dijkstra's or BendyRuler algorithms ran
+    uint32_t dijkstra_latest_ms;    // last time Dijkstra's ran in dijkstra_thread
 
     bool proximity_only = true;
     static AP_OAPathPlanner *_singleton;
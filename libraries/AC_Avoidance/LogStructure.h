@@ -23,6 +23,7 @@
 // @Field: OLt: Intermediate location chosen for avoidance
 // @Field: OLg: Intermediate location chosen for avoidance
 // @Field: OAlt: Intermediate alt chosen for avoidance above EKF origin
+// @Field: Lat: Time from the path planner request to this result
 struct PACKED log_OABendyRuler {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -39,6 +40,7 @@ struct PACKED log_OABendyRuler {
     int32_t oa_lat;
     int32_t oa_lng;
     int32_t oa_alt;
+    uint16_t latency_ms;
 };
 
 // @LoggerMessage: OADJ
@@ -52,6 +54,7 @@ struct PACKED log_OABendyRuler {
 // @Field: DLng: Destination longitude
 // @Field: OALat: Object Avoidance chosen destination point latitude
 // @Field: OALng: Object Avoidance chosen destination point longitude
+// @Field: Lat: Time from the path planner request to this result
 struct PACKED log_OADijkstra {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -63,6 +66,7 @@ struct PACKED log_OADijkstra {
     int32_t final_lng;
     int32_t oa_lat;
     int32_t oa_lng;
+    uint16_t latency_ms;
 };
 
 // @LoggerMessage: SA
@@ -91,8 +95,8 @@ struct PACKED log_SimpleAvoid {
 
 #define LOG_STRUCTURE_FROM_AVOIDANCE \
     { LOG_OA_BENDYRULER_MSG, sizeof(log_OABendyRuler), \
-      "OABR","QBBHHHBfLLiLLi","TimeUS,Type,Act,DYaw,Yaw,DP,RChg,Mar,DLt,DLg,DAlt,OLt,OLg,OAlt", "s-bddd-mDUmDUm", "F-------GGBGGB" }, \
+      "OABR","QBBHHHBfLLiLLiH","TimeUS,Type,Act,DYaw,Yaw,DP,RChg,Mar,DLt,DLg,DAlt,OLt,OLg,OAlt,Lat", "s-bddd-mDUmDUms", "F-------GGBGGBC" }, \
     { LOG_OA_DIJKSTRA_MSG, sizeof(log_OADijkstra), \
-      "OADJ","QBBBBLLLL","TimeUS,State,Err,CurrPoint,TotPoints,DLat,DLng,OALat,OALng", "sbbbbDUDU", "F----GGGG" }, \
+      "OADJ","QBBBBLLLLH","TimeUS,State,Err,CurrPoint,TotPoints,DLat,DLng,OALat,OALng,Lat", "sbbbbDUDUs", "F----GGGGC" }, \
     { LOG_SIMPLE_AVOID_MSG, sizeof(log_SimpleAvoid), \
       "SA",  "QBffffffB","TimeUS,State,DVelX,DVelY,DVelZ,MVelX,MVelY,MVelZ,Back", "sbnnnnnnb", "F--------"},
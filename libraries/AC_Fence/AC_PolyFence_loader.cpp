@@ -171,10 +171,11 @@ bool AC_PolyFence_loader::write_latlon_to_storage(uint16_t &offset, const Vector
 
 bool AC_PolyFence_loader::read_latlon_from_storage(uint16_t &read_offset, Vector2l &ret) const
 {
-    ret.x = fence_storage.read_uint32(read_offset);
-    read_offset += 4;
-    ret.y = fence_storage.read_uint32(read_offset);
-    read_offset += 4;
+    static_assert(sizeof(ret) == 8, "latlon is stored as two 32 bit values");
+    if (!fence_storage.read_block(&ret, read_offset, sizeof(ret))) {
+        return false;
+    }
+    read_offset += sizeof(ret);
     return true;
 }
 
@@ -193,6 +194,24 @@ bool AC_PolyFence_loader::load_point_from_eeprom(uint16_t i, Vector2l& point) co
     return true;
 }
 
+// find the bounding box of a polygon's lat/lng points
+static void polygon_bbox_lla(const Vector2l *points, uint8_t count, Vector2l &bbox_min, Vector2l &bbox_max)
+{
+    bbox_min = bbox_max = points[0];
+    for (uint8_t i=1; i<count; i++) {
+        bbox_min.x = MIN(bbox_min.x, points[i].x);
+        bbox_min.y = MIN(bbox_min.y, points[i].y);
+        bbox_max.x = MAX(bbox_max.x, points[i].x);
+        bbox_max.y = MAX(bbox_max.y, points[i].y);
+    }
+}
+
+// returns true if a lat/lng position is outside a bounding box, and so outside the polygon it bounds
+static bool outside_bbox_lla(const Vector2l &pos, const Vector2l &bbox_min, const Vector2l &bbox_max)
+{
+    return (pos.x < bbox_min.x) || (pos.x > bbox_max.x) || (pos.y < bbox_min.y) || (pos.y > bbox_max.y);
+}
+
 bool AC_PolyFence_loader::breached() const
 {
     struct Location loc;
@@ -218,7 +237,8 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
-        if (Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (outside_bbox_lla(pos, boundary.bbox_min_lla, boundary.bbox_max_lla) ||
+            Polygon_outside(pos, boundary.points_lla, boundary.count)) {
             return true;
         }
     }
@@ -226,17 +246,19 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
-        if (!Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (!outside_bbox_lla(pos, boundary.bbox_min_lla, boundary.bbox_max_lla) &&
+            !Polygon_outside(pos, boundary.points_lla, boundary.count)) {
             return true;
         }
     }
 
+    const Location::DistanceFrom from_loc{loc};
     for (uint8_t i=0; i<_num_loaded_circle_exclusion_boundaries; i++) {
         const ExclusionCircle &circle = _loaded_circle_exclusion_boundary[i];
         Location circle_center;
         circle_center.lat = circle.point.x;
         circle_center.lng = circle.point.y;
-        const float diff_cm = loc.get_distance(circle_center)*100.0f;
+        const float diff_cm = from_loc.get_distance(circle_center)*100.0f;
         if (diff_cm < circle.radius * 100.0f) {
             return true;
         }
@@ -247,7 +269,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
         Location circle_center;
         circle_center.lat = circle.point.x;
         circle_center.lng = circle.point.y;
-        const float diff_cm = loc.get_distance(circle_center)*100.0f;
+        const float diff_cm = from_loc.get_distance(circle_center)*100.0f;
         if (diff_cm > circle.radius * 100.0f) {
             return true;
         }
@@ -358,11 +380,12 @@ bool AC_PolyFence_loader::scale_latlon_from_origin(const Location &origin, const
 
 bool AC_PolyFence_loader::read_polygon_from_storage(const Location &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point, Vector2l *&next_storage_point_lla)
 {
+    // read all lat/lon points in one go
+    if (!fence_storage.read_block(next_storage_point_lla, read_offset, vertex_count*sizeof(Vector2l))) {
+        return false;
+    }
+    read_offset += vertex_count*sizeof(Vector2l);
     for (uint8_t i=0; i<vertex_count; i++) {
-        // read from storage to lat/lon
-        if (!read_latlon_from_storage(read_offset, *next_storage_point_lla)) {
-            return false;
-        }
         // convert lat/lon to position in cm from origin
         if (!scale_latlon_from_origin(origin, *next_storage_point_lla, *next_storage_point)) {
             return false;
@@ -566,6 +589,7 @@ void AC_PolyFence_loader::unload()
 
     delete[] _loaded_points_lla;
     _loaded_points_lla = nullptr;
+    _num_loaded_points = 0;
 
     delete[] _loaded_inclusion_boundary;
     _loaded_inclusion_boundary = nullptr;
@@ -652,6 +676,8 @@ bool AC_PolyFence_loader::load_from_eeprom()
 
     unload();
 
+    _loaded_origin = ekf_origin;
+
     if (_eeprom_item_count == 0) {
         get_loaded_fence_semaphore().give();
         _load_time_ms = AP_HAL::millis();
@@ -669,6 +695,7 @@ bool AC_PolyFence_loader::load_from_eeprom()
             get_loaded_fence_semaphore().give();
             return false;
         }
+        _num_loaded_points = count;
     }
 
     // FIXME: find some way of factoring out all of these allocation routines.
@@ -759,6 +786,10 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // precompute data used for fast breach and avoidance checks
+            // the edge index is optional; without it all edges are checked
+            polygon_bbox_lla(boundary.points_lla, boundary.count, boundary.bbox_min_lla, boundary.bbox_max_lla);
+            boundary.edge_index.init(boundary.points, boundary.count);
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -778,6 +809,10 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // precompute data used for fast breach and avoidance checks
+            // the edge index is optional; without it all edges are checked
+            polygon_bbox_lla(boundary.points_lla, boundary.count, boundary.bbox_min_lla, boundary.bbox_max_lla);
+            boundary.edge_index.init(boundary.points, boundary.count);
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -877,6 +912,55 @@ bool AC_PolyFence_loader::load_from_eeprom()
     return true;
 }
 
+bool AC_PolyFence_loader::move_loaded_fence_origin(const Location &origin)
+{
+    if (!get_loaded_fence_semaphore().take_nonblocking()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (uint16_t i=0; i<_num_loaded_points; i++) {
+        if (!scale_latlon_from_origin(origin, _loaded_points_lla[i], _loaded_offsets_from_origin[i])) {
+            ok = false;
+        }
+    }
+    for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
+        InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
+        boundary.edge_index.init(boundary.points, boundary.count);
+    }
+    for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
+        ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
+        boundary.edge_index.init(boundary.points, boundary.count);
+    }
+    for (uint8_t i=0; i<_num_loaded_circle_inclusion_boundaries; i++) {
+        InclusionCircle &circle = _loaded_circle_inclusion_boundary[i];
+        if (!scale_latlon_from_origin(origin, circle.point, circle.pos_cm)) {
+            ok = false;
+        }
+    }
+    for (uint8_t i=0; i<_num_loaded_circle_exclusion_boundaries; i++) {
+        ExclusionCircle &circle = _loaded_circle_exclusion_boundary[i];
+        if (!scale_latlon_from_origin(origin, circle.point, circle.pos_cm)) {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        // fall back to a full load from storage
+        unload();
+        _load_attempted = false;
+        get_loaded_fence_semaphore().give();
+        return false;
+    }
+
+    _loaded_origin = origin;
+    // users of the loaded fence notice the change through the load time
+    _load_time_ms = AP_HAL::millis();
+
+    get_loaded_fence_semaphore().give();
+    return true;
+}
+
 /// returns pointer to array of exclusion polygon points and num_points is filled in with the number of points in the polygon
 /// points are offsets in cm from EKF origin in NE frame
 Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &num_points) const
@@ -891,6 +975,16 @@ Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+/// returns the edge index of an exclusion polygon, or nullptr if not available
+const AC_PolygonEdgeIndex* AC_PolyFence_loader::get_exclusion_polygon_edge_index(uint16_t index) const
+{
+    if (index >= _num_loaded_exclusion_boundaries) {
+        return nullptr;
+    }
+    const AC_PolygonEdgeIndex &edge_index = _loaded_exclusion_boundary[index].edge_index;
+    return edge_index.valid() ? &edge_index : nullptr;
+}
+
 /// returns pointer to array of inclusion polygon points and num_points is filled in with the number of points in the polygon
 /// points are offsets in cm from EKF origin in NE frame
 Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &num_points) const
@@ -905,6 +999,16 @@ Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+/// returns the edge index of an inclusion polygon, or nullptr if not available
+const AC_PolygonEdgeIndex* AC_PolyFence_loader::get_inclusion_polygon_edge_index(uint16_t index) const
+{
+    if (index >= _num_loaded_inclusion_boundaries) {
+        return nullptr;
+    }
+    const AC_PolygonEdgeIndex &edge_index = _loaded_inclusion_boundary[index].edge_index;
+    return edge_index.valid() ? &edge_index : nullptr;
+}
+
 /// returns the specified exclusion circle
 /// circle center offsets in cm from EKF origin in NE frame, radius is in meters
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const
@@ -1653,4 +1757,11 @@ void AC_PolyFence_loader::update()
     if (!load_from_eeprom()) {
         return;
     }
+
+    // if the EKF origin has moved then the loaded offsets are stale
+    Location ekf_origin;
+    if (AP::ahrs().get_origin(ekf_origin) &&
+        !ekf_origin.same_latlon_as(_loaded_origin)) {
+        IGNORE_RETURN(move_loaded_fence_origin(ekf_origin));
+    }
 }
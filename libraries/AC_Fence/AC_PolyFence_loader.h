@@ -4,6 +4,7 @@
 #include <AP_Common/Location.h>
 #include <AP_Math/AP_Math.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
+#include "AC_PolygonEdgeIndex.h"
 
 #define AC_POLYFENCE_FENCE_POINT_PROTOCOL_SUPPORT 1
 
@@ -67,6 +68,9 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_exclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns the edge index of an exclusion polygon, or nullptr if not available
+    const AC_PolygonEdgeIndex* get_exclusion_polygon_edge_index(uint16_t index) const;
+
     /// return system time of last update to the exclusion polygon points
     uint32_t get_exclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -84,6 +88,9 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_inclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns the edge index of an inclusion polygon, or nullptr if not available
+    const AC_PolygonEdgeIndex* get_inclusion_polygon_edge_index(uint16_t index) const;
+
     /// return system time of last update to the inclusion polygon points
     uint32_t get_inclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -281,6 +288,9 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla array
         uint8_t count; // count of points in the boundary
+        Vector2l bbox_min_lla; // bounding box of points_lla
+        Vector2l bbox_max_lla;
+        AC_PolygonEdgeIndex edge_index; // index of edges in points
     };
     InclusionBoundary *_loaded_inclusion_boundary;
 
@@ -291,6 +301,9 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla_lla array
         uint8_t count; // count of points in the boundary
+        Vector2l bbox_min_lla; // bounding box of points_lla
+        Vector2l bbox_max_lla;
+        AC_PolygonEdgeIndex edge_index; // index of edges in points
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
 
@@ -302,6 +315,10 @@ private:
     // example.
     Vector2f *_loaded_offsets_from_origin;
     Vector2l *_loaded_points_lla;
+    uint16_t _num_loaded_points;
+
+    // EKF origin the loaded offsets are relative to
+    Location _loaded_origin;
 
     class ExclusionCircle {
     public:
@@ -349,6 +366,11 @@ private:
                                    Vector2f *&next_storage_point,
                                    Vector2l *&next_storage_point_lla) WARN_IF_UNUSED;
 
+    // move_loaded_fence_origin - recalculates the loaded offsets and
+    // edge indexes for a new origin from the loaded latitude/longitude
+    // points, without reading storage or reallocating
+    bool move_loaded_fence_origin(const Location &origin) WARN_IF_UNUSED;
+
     /*
      * Upgrade functions - attempt to keep user's fences when
      * upgrading to new firmware
@@ -0,0 +1,145 @@
+#include "AC_PolygonEdgeIndex.h"
+
+// build the index for a polygon.  returns false on failure (e.g. out of memory)
+bool AC_PolygonEdgeIndex::init(const Vector2f *points, uint8_t count)
+{
+    clear();
+
+    if ((points == nullptr) || (count < 3)) {
+        return false;
+    }
+
+    // find bounding box
+    _bbox_min = _bbox_max = points[0];
+    for (uint8_t i=1; i<count; i++) {
+        _bbox_min.x = MIN(_bbox_min.x, points[i].x);
+        _bbox_min.y = MIN(_bbox_min.y, points[i].y);
+        _bbox_max.x = MAX(_bbox_max.x, points[i].x);
+        _bbox_max.y = MAX(_bbox_max.y, points[i].y);
+    }
+
+    // square cells sized so the longest side has AC_POLYGON_EDGE_INDEX_CELLS_MAX cells
+    const Vector2f extent = _bbox_max - _bbox_min;
+    _cell_size = MAX(MAX(extent.x, extent.y) / AC_POLYGON_EDGE_INDEX_CELLS_MAX, 1.0f);
+    _cells_x = constrain_int16(ceilf(extent.x / _cell_size), 1, AC_POLYGON_EDGE_INDEX_CELLS_MAX);
+    _cells_y = constrain_int16(ceilf(extent.y / _cell_size), 1, AC_POLYGON_EDGE_INDEX_CELLS_MAX);
+    const uint16_t num_cells = _cells_x * _cells_y;
+
+    // an edge passes through a cell if it is within half a cell diagonal of the cell's centre
+    // this may include a few extra cells around the edge, which is safe
+    const float half_diagonal = _cell_size * 0.5f * M_SQRT2;
+
+    // count edges in each cell, then fill them in.  first pass counts, second pass fills
+    _cell_start = new uint16_t[num_cells + 1];
+    if (_cell_start == nullptr) {
+        return false;
+    }
+    for (uint16_t c=0; c<=num_cells; c++) {
+        _cell_start[c] = 0;
+    }
+    for (uint8_t pass=0; pass<2; pass++) {
+        for (uint8_t i=0; i<count; i++) {
+            const Vector2f &start = points[i];
+            const Vector2f &end = points[(i+1 < count) ? i+1 : 0];
+            for (uint8_t cx=cell_x(MIN(start.x, end.x)); cx<=cell_x(MAX(start.x, end.x)); cx++) {
+                for (uint8_t cy=cell_y(MIN(start.y, end.y)); cy<=cell_y(MAX(start.y, end.y)); cy++) {
+                    const Vector2f centre = _bbox_min + Vector2f(cx + 0.5f, cy + 0.5f) * _cell_size;
+                    if (Vector2f::closest_distance_between_line_and_point(start, end, centre) > half_diagonal) {
+                        continue;
+                    }
+                    const uint16_t c = cx * _cells_y + cy;
+                    if (pass == 0) {
+                        _cell_start[c+1]++;
+                    } else {
+                        _cell_edges[_cell_start[c]++] = i;
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            // convert counts to start indices
+            for (uint16_t c=1; c<=num_cells; c++) {
+                _cell_start[c] += _cell_start[c-1];
+            }
+            _cell_edges = new uint8_t[MAX(_cell_start[num_cells], 1U)];
+            if (_cell_edges == nullptr) {
+                clear();
+                return false;
+            }
+        } else {
+            // filling advanced each start to the next cell's start, shift back
+            for (uint16_t c=num_cells; c>0; c--) {
+                _cell_start[c] = _cell_start[c-1];
+            }
+            _cell_start[0] = 0;
+        }
+    }
+
+    return true;
+}
+
+// free the index
+void AC_PolygonEdgeIndex::clear()
+{
+    delete[] _cell_start;
+    _cell_start = nullptr;
+    delete[] _cell_edges;
+    _cell_edges = nullptr;
+}
+
+// returns true if pos is outside the polygon's bounding box, and so outside the polygon
+bool AC_PolygonEdgeIndex::outside_bbox(const Vector2f &pos) const
+{
+    return (pos.x < _bbox_min.x) || (pos.x > _bbox_max.x) || (pos.y < _bbox_min.y) || (pos.y > _bbox_max.y);
+}
+
+// returns the cell index along one axis, limited to the grid
+uint8_t AC_PolygonEdgeIndex::cell_x(float x) const
+{
+    return constrain_float((x - _bbox_min.x) / _cell_size, 0, _cells_x - 1);
+}
+
+uint8_t AC_PolygonEdgeIndex::cell_y(float y) const
+{
+    return constrain_float((y - _bbox_min.y) / _cell_size, 0, _cells_y - 1);
+}
+
+// fills in edges with the edges that may be within radius of pos, in ascending order.  returns the number of edges
+uint16_t AC_PolygonEdgeIndex::edges_near(const Vector2f &pos, float radius, uint8_t *edges) const
+{
+    if (!valid()) {
+        return 0;
+    }
+
+    // nothing is near if the search area misses the bounding box
+    if ((pos.x + radius < _bbox_min.x) || (pos.x - radius > _bbox_max.x) ||
+        (pos.y + radius < _bbox_min.y) || (pos.y - radius > _bbox_max.y)) {
+        return 0;
+    }
+
+    // mark every edge in the cells overlapping the search area
+    uint32_t found[256/32] {};
+    const uint8_t cx_max = cell_x(pos.x + radius);
+    const uint8_t cy_max = cell_y(pos.y + radius);
+    for (uint8_t cx=cell_x(pos.x - radius); cx<=cx_max; cx++) {
+        for (uint8_t cy=cell_y(pos.y - radius); cy<=cy_max; cy++) {
+            const uint16_t c = cx * _cells_y + cy;
+            for (uint16_t e=_cell_start[c]; e<_cell_start[c+1]; e++) {
+                const uint8_t edge = _cell_edges[e];
+                found[edge / 32] |= (1U << (edge % 32));
+            }
+        }
+    }
+
+    // return marked edges in ascending order
+    uint16_t num_edges = 0;
+    for (uint8_t w=0; w<ARRAY_SIZE(found); w++) {
+        uint32_t bits = found[w];
+        while (bits != 0) {
+            const uint8_t b = __builtin_ctz(bits);
+            edges[num_edges++] = w * 32 + b;
+            bits &= bits - 1;
+        }
+    }
+    return num_edges;
+}
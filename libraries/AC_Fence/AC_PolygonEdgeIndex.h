@@ -0,0 +1,52 @@
+#pragma once
+
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+#define AC_POLYGON_EDGE_INDEX_CELLS_MAX 16     // maximum number of grid cells along each axis
+
+/*
+ * uniform grid over a polygon's bounding box, recording which edges pass
+ * through each cell.  Built once when a fence is loaded so per-loop
+ * checks only need to consider the edges near the vehicle.
+ * Edge i runs from point i to point i+1 (wrapping to point 0).
+ */
+class AC_PolygonEdgeIndex {
+public:
+    AC_PolygonEdgeIndex() {}
+    ~AC_PolygonEdgeIndex() { clear(); }
+
+    /* Do not allow copies */
+    AC_PolygonEdgeIndex(const AC_PolygonEdgeIndex &other) = delete;
+    AC_PolygonEdgeIndex &operator=(const AC_PolygonEdgeIndex&) = delete;
+
+    // build the index for a polygon.  returns false on failure (e.g. out of memory)
+    bool init(const Vector2f *points, uint8_t count);
+
+    // free the index
+    void clear();
+
+    // returns true if the index has been built
+    bool valid() const { return _cell_start != nullptr; }
+
+    // returns true if pos is outside the polygon's bounding box, and so outside the polygon
+    bool outside_bbox(const Vector2f &pos) const;
+
+    // fills in edges (which must have room for one entry per polygon point) with the edges
+    // that may be within radius of pos, in ascending order.  returns the number of edges
+    uint16_t edges_near(const Vector2f &pos, float radius, uint8_t *edges) const;
+
+private:
+
+    // returns the cell index along one axis, limited to the grid
+    uint8_t cell_x(float x) const;
+    uint8_t cell_y(float y) const;
+
+    Vector2f _bbox_min;     // bounding box of polygon
+    Vector2f _bbox_max;
+    float _cell_size;       // width and height of each cell
+    uint8_t _cells_x;       // number of cells along each axis
+    uint8_t _cells_y;
+    uint16_t *_cell_start;  // index into _cell_edges of first edge for each cell, plus one extra entry for the end
+    uint8_t *_cell_edges;   // edges passing through each cell
+};
@@ -126,6 +126,11 @@ void AC_PID::filt_D_hz(float hz)
 //  the derivative is then calculated and filtered
 //  the integral is then updated based on the setting of the limit flag
 float AC_PID::update_all(float target, float measurement, bool limit)
+{
+    return update_all(target, measurement, limit, FilterAlpha{get_filt_T_alpha(), get_filt_E_alpha(), get_filt_D_alpha()});
+}
+
+__FASTRAMFUNC__ float AC_PID::update_all(float target, float measurement, bool limit, const FilterAlpha &alpha)
 {
     // don't process inf or NaN
     if (!isfinite(target) || !isfinite(measurement)) {
@@ -140,13 +145,13 @@ float AC_PID::update_all(float target, float measurement, bool limit)
         _derivative = 0.0f;
     } else {
         float error_last = _error;
-        _target += get_filt_T_alpha() * (target - _target);
-        _error += get_filt_E_alpha() * ((_target - measurement) - _error);
+        _target += alpha.T * (target - _target);
+        _error += alpha.E * ((_target - measurement) - _error);
 
         // calculate and filter derivative
         if (_dt > 0.0f) {
             float derivative = (_error - error_last) / _dt;
-            _derivative += get_filt_D_alpha() * (derivative - _derivative);
+            _derivative += alpha.D * (derivative - _derivative);
         }
     }
 
@@ -129,6 +129,17 @@ public:
     AP_Float _slew_rate_tau;
     
 protected:
+    friend class AC_PID_3Axis;
+
+    // target, error and derivative filter alphas for the current dt
+    struct FilterAlpha {
+        float T;
+        float E;
+        float D;
+    };
+
+    // update_all with the filter alphas already calculated
+    float update_all(float target, float measurement, bool limit, const FilterAlpha &alpha);
 
     // parameters
     AP_Float _kp;
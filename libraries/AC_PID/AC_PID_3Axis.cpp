@@ -0,0 +1,43 @@
+/// @file	AC_PID_3Axis.cpp
+/// @brief	Roll, pitch and yaw rate PIDs run as one controller
+
+#include "AC_PID_3Axis.h"
+
+AC_PID_3Axis::AC_PID_3Axis(AC_PID &roll, AC_PID &pitch, AC_PID &yaw) :
+    _pid{&roll, &pitch, &yaw}
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        // force calculation on the first update
+        _alpha_dt[i] = -1.0f;
+    }
+}
+
+void AC_PID_3Axis::update_alpha(uint8_t axis)
+{
+    const AC_PID &pid = *_pid[axis];
+    const float T_hz = pid._filt_T_hz.get();
+    const float E_hz = pid._filt_E_hz.get();
+    const float D_hz = pid._filt_D_hz.get();
+    if (pid._dt == _alpha_dt[axis] && T_hz == _alpha_T_hz[axis] &&
+        E_hz == _alpha_E_hz[axis] && D_hz == _alpha_D_hz[axis]) {
+        return;
+    }
+    _alpha_dt[axis] = pid._dt;
+    _alpha_T_hz[axis] = T_hz;
+    _alpha_E_hz[axis] = E_hz;
+    _alpha_D_hz[axis] = D_hz;
+    _alpha[axis].T = pid.get_filt_alpha(T_hz);
+    _alpha[axis].E = pid.get_filt_alpha(E_hz);
+    _alpha[axis].D = pid.get_filt_alpha(D_hz);
+}
+
+__FASTRAMFUNC__ Vector3f AC_PID_3Axis::update_all(const Vector3f &target, const Vector3f &measurement, float dt, const bool limit[3])
+{
+    Vector3f out;
+    for (uint8_t i = 0; i < 3; i++) {
+        _pid[i]->_dt = dt;
+        update_alpha(i);
+        out[i] = _pid[i]->update_all(target[i], measurement[i], limit[i], _alpha[i]);
+    }
+    return out;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+/// @file	AC_PID_3Axis.h
+/// @brief	Roll, pitch and yaw rate PIDs run as one controller
+
+#include "AC_PID.h"
+#include <AP_Math/AP_Math.h>
+
+/// @class	AC_PID_3Axis
+/// @brief	Runs three AC_PID objects together for the body rate loop.
+/// The gains, state and logging stay in the AC_PID objects so parameters,
+/// tuning and autotune are unchanged. The filter alphas are only
+/// recalculated when the time step or a filter frequency changes.
+class AC_PID_3Axis {
+public:
+
+    AC_PID_3Axis(AC_PID &roll, AC_PID &pitch, AC_PID &yaw);
+
+    CLASS_NO_COPY(AC_PID_3Axis);
+
+    //  update_all - set time step, target and measured inputs of all three
+    //  controllers and return their P+I+D outputs.
+    //  limit is the roll, pitch and yaw integrator limit flags
+    Vector3f update_all(const Vector3f &target, const Vector3f &measurement, float dt, const bool limit[3]);
+
+private:
+
+    // recalculate an axis' filter alphas if dt or a filter frequency has changed
+    void update_alpha(uint8_t axis);
+
+    AC_PID *_pid[3];
+
+    // inputs the alphas were last calculated from
+    float _alpha_dt[3];
+    float _alpha_T_hz[3];
+    float _alpha_E_hz[3];
+    float _alpha_D_hz[3];
+
+    AC_PID::FilterAlpha _alpha[3];
+};
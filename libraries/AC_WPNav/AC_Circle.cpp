@@ -108,10 +108,11 @@ void AC_Circle::set_center(const Location& center)
 {
     if (center.get_alt_frame() == Location::AltFrame::ABOVE_TERRAIN) {
         // convert Location with terrain altitude
-        Vector2f center_xy;
+        Vector2p center_xy;
         int32_t terr_alt_cm;
         if (center.get_vector_xy_from_origin_NE(center_xy) && center.get_alt_cm(Location::AltFrame::ABOVE_TERRAIN, terr_alt_cm)) {
-            set_center(Vector3f(center_xy.x, center_xy.y, terr_alt_cm), true);
+            _center = Vector3p(center_xy.x, center_xy.y, terr_alt_cm);
+            _terrain_alt = true;
         } else {
             // failed to convert location so set to current position and log error
             set_center(_inav.get_position(), false);
@@ -119,13 +120,14 @@ void AC_Circle::set_center(const Location& center)
         }
     } else {
         // convert Location with alt-above-home, alt-above-origin or absolute alt
-        Vector3f circle_center_neu;
+        Vector3p circle_center_neu;
         if (!center.get_vector_from_origin_NEU(circle_center_neu)) {
             // default to current position and log error
-            circle_center_neu = _inav.get_position();
+            circle_center_neu = _inav.get_position().topostype();
             AP::logger().Write_Error(LogErrorSubsystem::NAVIGATION, LogErrorCode::FAILED_CIRCLE_INIT);
         }
-        set_center(circle_center_neu, false);
+        _center = circle_center_neu;
+        _terrain_alt = false;
     }
 }
 
@@ -149,9 +149,9 @@ void AC_WPNav::wp_and_spline_init(float speed_cms)
     }
     calc_scurve_jerk_and_jerk_time();
 
-    _scurve_prev_leg.init();
-    _scurve_this_leg.init();
-    _scurve_next_leg.init();
+    _scurve_prev_leg->init();
+    _scurve_this_leg->init();
+    _scurve_next_leg->init();
     _track_scalar_dt = 1.0f;
 
     // reset input shaped terrain offsets
@@ -254,7 +254,7 @@ bool AC_WPNav::set_wp_destination(const Vector3f& destination, bool terrain_alt)
         wp_and_spline_init(_wp_desired_speed_xy_cms);
     }
 
-    _scurve_prev_leg.init();
+    _scurve_prev_leg->init();
     float origin_speed = 0.0f;
 
     // use previous destination as origin
@@ -268,7 +268,9 @@ bool AC_WPNav::set_wp_destination(const Vector3f& destination, bool terrain_alt)
             origin_speed = curr_target_vel.length();
         } else {
             // store previous leg
+            SCurve *old_prev_leg = _scurve_prev_leg;
             _scurve_prev_leg = _scurve_this_leg;
+            _scurve_this_leg = old_prev_leg;
         }
     } else {
 
@@ -294,21 +296,23 @@ bool AC_WPNav::set_wp_destination(const Vector3f& destination, bool terrain_alt)
     _destination = destination;
     _terrain_alt = terrain_alt;
 
-    if (_flags.fast_waypoint && !_this_leg_is_spline && !_next_leg_is_spline && !_scurve_next_leg.finished()) {
+    if (_flags.fast_waypoint && !_this_leg_is_spline && !_next_leg_is_spline && !_scurve_next_leg->finished()) {
+        SCurve *old_this_leg = _scurve_this_leg;
         _scurve_this_leg = _scurve_next_leg;
+        _scurve_next_leg = old_this_leg;
     } else {
-        _scurve_this_leg.calculate_track(_origin, _destination,
-                                         _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                         _wp_accel_cmss, _wp_accel_z_cmss,
-                                         _scurve_jerk_time, _scurve_jerk * 100.0f);
+        _scurve_this_leg->calculate_track(_origin, _destination,
+                                          _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
+                                          _wp_accel_cmss, _wp_accel_z_cmss,
+                                          _scurve_jerk_time, _scurve_jerk * 100.0f);
         if (!is_zero(origin_speed)) {
             // rebuild start of scurve if we have a non-zero origin speed
-            _scurve_this_leg.set_origin_speed_max(origin_speed);
+            _scurve_this_leg->set_origin_speed_max(origin_speed);
         }
     }
 
     _this_leg_is_spline = false;
-    _scurve_next_leg.init();
+    _scurve_next_leg->init();
     _flags.fast_waypoint = false;   // default waypoint back to slow
     _flags.reached_destination = false;
 
@@ -325,13 +329,13 @@ bool AC_WPNav::set_wp_destination_next(const Vector3f& destination, bool terrain
         return true;
     }
 
-    _scurve_next_leg.calculate_track(_destination, destination,
-                                     _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
-                                     _wp_accel_cmss, _wp_accel_z_cmss,
-                                     _scurve_jerk_time, _scurve_jerk * 100.0f);
+    _scurve_next_leg->calculate_track(_destination, destination,
+                                      _pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
+                                      _wp_accel_cmss, _wp_accel_z_cmss,
+                                      _scurve_jerk_time, _scurve_jerk * 100.0f);
     if (_this_leg_is_spline) {
         const float this_leg_dest_speed_max = _spline_this_leg.get_destination_speed_max();
-        const float next_leg_origin_speed_max = _scurve_next_leg.set_origin_speed_max(this_leg_dest_speed_max);
+        const float next_leg_origin_speed_max = _scurve_next_leg->set_origin_speed_max(this_leg_dest_speed_max);
         _spline_this_leg.set_destination_speed_max(next_leg_origin_speed_max);
     }
     _next_leg_is_spline = false;
@@ -457,7 +461,7 @@ bool AC_WPNav::advance_wp_target_along_track(float dt)
     if (!_this_leg_is_spline) {
         // update target position, velocity and acceleration
         target_pos = _origin;
-        s_finished = _scurve_this_leg.advance_target_along_track(_scurve_prev_leg, _scurve_next_leg, _wp_radius_cm, _flags.fast_waypoint, _track_scalar_dt * dt, target_pos, target_vel, target_accel);
+        s_finished = _scurve_this_leg->advance_target_along_track(*_scurve_prev_leg, *_scurve_next_leg, _wp_radius_cm, _flags.fast_waypoint, _track_scalar_dt * dt, target_pos, target_vel, target_accel);
     } else {
         // splinetarget_vel
         target_vel = curr_target_vel;
@@ -509,7 +513,7 @@ void AC_WPNav::update_track_with_speed_accel_limits()
         _spline_this_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
                                          _wp_accel_cmss, _wp_accel_z_cmss);
     } else {
-        _scurve_this_leg.set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
+        _scurve_this_leg->set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
     }
 
     // update next leg
@@ -517,7 +521,7 @@ void AC_WPNav::update_track_with_speed_accel_limits()
         _spline_next_leg.set_speed_accel(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms(),
                                          _wp_accel_cmss, _wp_accel_z_cmss);
     } else {
-        _scurve_next_leg.set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
+        _scurve_next_leg->set_speed_max(_pos_control.get_max_speed_xy_cms(), _pos_control.get_max_speed_up_cms(), _pos_control.get_max_speed_down_cms());
     }
 }
 
@@ -765,7 +769,7 @@ bool AC_WPNav::set_spline_destination_next(const Vector3f& next_destination, boo
 
     // update this_leg's final velocity to match next spline leg
     if (!_this_leg_is_spline) {
-        _scurve_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
+        _scurve_this_leg->set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
     } else {
         _spline_this_leg.set_destination_speed_max(_spline_next_leg.get_origin_speed_max());
     }
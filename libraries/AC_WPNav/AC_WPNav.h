@@ -244,9 +244,11 @@ protected:
     AP_Float    _wp_jerk;               // maximum jerk used to generate scurve trajectories in m/s/s/s
 
     // scurve
-    SCurve _scurve_prev_leg;            // previous scurve trajectory used to blend with current scurve trajectory
-    SCurve _scurve_this_leg;            // current scurve trajectory
-    SCurve _scurve_next_leg;            // next scurve trajectory used to blend with current scurve trajectory
+    // scurve trajectories are rotated between these slots on each waypoint transition rather than copied
+    SCurve _scurve_legs[3];
+    SCurve *_scurve_prev_leg = &_scurve_legs[0];    // previous scurve trajectory used to blend with current scurve trajectory
+    SCurve *_scurve_this_leg = &_scurve_legs[1];    // current scurve trajectory
+    SCurve *_scurve_next_leg = &_scurve_legs[2];    // next scurve trajectory used to blend with current scurve trajectory
     float _scurve_jerk;                 // scurve jerk max in m/s/s/s
     float _scurve_jerk_time;            // scurve jerk time (time in seconds for jerk to increase from zero _scurve_jerk)
 
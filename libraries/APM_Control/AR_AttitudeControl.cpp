@@ -17,6 +17,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AR_AttitudeControl.h"
 #include <AP_GPS/AP_GPS.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -749,6 +750,21 @@ float AR_AttitudeControl::get_sail_out_from_heel(float desired_heel, float dt)
 
 // get forward speed in m/s (earth-frame horizontal velocity but only along vehicle x-axis).  returns true on success
 bool AR_AttitudeControl::get_forward_speed(float &speed) const
+{
+    // the AHRS only changes when there is a new INS sample so reuse
+    // the result from earlier in the same loop
+    const uint32_t sample_us = AP::ins().get_last_update_usec();
+    if (sample_us == 0 || sample_us != _forward_speed_sample_us) {
+        _forward_speed_ok = calc_forward_speed(_forward_speed);
+        _forward_speed_sample_us = sample_us;
+    }
+    if (_forward_speed_ok) {
+        speed = _forward_speed;
+    }
+    return _forward_speed_ok;
+}
+
+bool AR_AttitudeControl::calc_forward_speed(float &speed) const
 {
     Vector3f velocity;
     if (!_ahrs.get_velocity_NED(velocity)) {
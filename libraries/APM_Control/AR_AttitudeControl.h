@@ -157,6 +157,9 @@ public:
 
 private:
 
+    // calculate forward speed in m/s, uncached version of get_forward_speed
+    bool calc_forward_speed(float &speed) const;
+
     // external references
     const AP_AHRS &_ahrs;
 
@@ -181,6 +184,11 @@ private:
     float    _desired_lat_accel;    // desired lateral acceleration (in m/s/s) from latest call to get_steering_out_lat_accel (for reporting purposes)
     float    _desired_turn_rate;    // desired turn rate (in radians/sec) either from external caller or from lateral acceleration controller
 
+    // forward speed, cached per INS sample as the navigation, steering and throttle controllers all ask for it each loop
+    mutable uint32_t _forward_speed_sample_us;  // INS sample time the cached forward speed was calculated for
+    mutable float    _forward_speed;            // cached forward speed in m/s
+    mutable bool     _forward_speed_ok;         // cached return value of get_forward_speed
+
     // throttle control
     uint32_t _speed_last_ms;        // system time of last call to get_throttle_out_speed
     float    _desired_speed;        // last recorded desired speed
@@ -34,8 +34,12 @@
 #define ADSB_SQUAWK_OCTAL_DEFAULT       1200
 
 #ifndef ADSB_VEHICLE_LIST_SIZE_DEFAULT
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+    #define ADSB_VEHICLE_LIST_SIZE_DEFAULT  50
+#else
     #define ADSB_VEHICLE_LIST_SIZE_DEFAULT  25
 #endif
+#endif
 
 #ifndef ADSB_LIST_RADIUS_DEFAULT
     #if APM_BUILD_TYPE(APM_BUILD_ArduPlane)
@@ -64,7 +68,7 @@ const AP_Param::GroupInfo AP_ADSB::var_info[] = {
     // @Param: LIST_MAX
     // @DisplayName: ADSB vehicle list size
     // @Description: ADSB list size of nearest vehicles. Longer lists take longer to refresh with lower SRx_ADSB values.
-    // @Range: 1 100
+    // @Range: 1 250
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("LIST_MAX",   2, AP_ADSB, in_state.list_size_param, ADSB_VEHICLE_LIST_SIZE_DEFAULT),
@@ -375,7 +379,11 @@ void AP_ADSB::determine_furthest_aircraft(void)
         if (is_special_vehicle(in_state.vehicle_list[index].info.ICAO_address)) {
             continue;
         }
-        const float distance = _my_loc.get_distance(get_location(in_state.vehicle_list[index]));
+        // use the distance from when the vehicle was last refreshed
+        // rather than recalculating it for the whole list each time a
+        // vehicle gets bumped. Vehicles time out after a few seconds so
+        // it is never far out of date
+        const float distance = in_state.vehicle_list[index].distance_m;
         if (max_distance < distance || index == 0) {
             max_distance = distance;
             max_distance_index = index;
@@ -454,6 +462,7 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
     const Location vehicle_loc = AP_ADSB::get_location(vehicle);
     const bool my_loc_is_zero = _my_loc.is_zero();
     const float my_loc_distance_to_vehicle = _my_loc.get_distance(vehicle_loc);
+    const float vehicle_distance = my_loc_is_zero ? 0 : my_loc_distance_to_vehicle;
     const bool is_special = is_special_vehicle(vehicle.info.ICAO_address);
     const bool out_of_range = in_state.list_radius > 0 && !my_loc_is_zero && my_loc_distance_to_vehicle > in_state.list_radius && !is_special;
     const bool out_of_range_alt = in_state.list_altitude > 0 && !my_loc_is_zero && abs(vehicle_loc.alt - _my_loc.alt) > in_state.list_altitude*100 && !is_special;
@@ -480,12 +489,12 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
     } else if (is_tracked_in_list) {
 
         // found, update it
-        set_vehicle(index, vehicle);
+        set_vehicle(index, vehicle, vehicle_distance);
 
     } else if (in_state.vehicle_count < in_state.list_size_allocated) {
 
         // not found and there's room, add it to the end of the list
-        set_vehicle(in_state.vehicle_count, vehicle);
+        set_vehicle(in_state.vehicle_count, vehicle, vehicle_distance);
         in_state.vehicle_count++;
 
     } else {
@@ -504,7 +513,7 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
 
             if (my_loc_distance_to_vehicle < in_state.furthest_vehicle_distance) { // is closer than the furthest
                 // replace with the furthest vehicle
-                set_vehicle(in_state.furthest_vehicle_index, vehicle);
+                set_vehicle(in_state.furthest_vehicle_index, vehicle, vehicle_distance);
 
                 // in_state.furthest_vehicle_index is now invalid because the vehicle was overwritten, need
                 // to run determine_furthest_aircraft() to determine a new one next time
@@ -528,13 +537,14 @@ void AP_ADSB::handle_adsb_vehicle(const adsb_vehicle_t &vehicle)
 /*
  * Copy a vehicle's data into the list
  */
-void AP_ADSB::set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle)
+void AP_ADSB::set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle, const float distance_m)
 {
     if (index >= in_state.list_size_allocated) {
         // out of range
         return;
     }
     in_state.vehicle_list[index] = vehicle;
+    in_state.vehicle_list[index].distance_m = distance_m;
 
     write_log(vehicle);
 }
@@ -66,6 +66,7 @@ public:
     struct adsb_vehicle_t {
         mavlink_adsb_vehicle_t info; // the whole mavlink struct with all the juicy details. sizeof() == 38
         uint32_t last_update_ms; // last time this was refreshed, allows timeouts
+        float distance_m; // distance from us when last refreshed, zero if our position was unknown
     };
 
     // for holding parameters
@@ -158,7 +159,7 @@ private:
     // remove a vehicle from the list
     void delete_vehicle(const uint16_t index);
 
-    void set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle);
+    void set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle, const float distance_m);
 
     // Generates pseudorandom ICAO from gps time, lat, and lon
     uint32_t genICAO(const Location &loc) const;
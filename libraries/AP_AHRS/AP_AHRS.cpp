@@ -163,6 +163,15 @@ const AP_Param::GroupInfo AP_AHRS::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("CUSTOM_YAW", 17, AP_AHRS, _custom_yaw, 0),
 
+#if AP_AHRS_NAVEKF_AVAILABLE
+    // @Param: DCM_DIV
+    // @DisplayName: DCM update rate divider
+    // @Description: When an EKF is providing the attitude, the DCM fallback attitude estimate is only updated every DCM_DIV loops, with the IMU data from the loops in between accumulated so no rotation is lost. DCM is updated every loop whenever it is the active attitude source. A value of 1 updates DCM every loop. Larger values free up main loop time on slower boards.
+    // @Range: 1 8
+    // @User: Advanced
+    AP_GROUPINFO("DCM_DIV", 18, AP_AHRS, _dcm_divider, 1),
+#endif
+
     AP_GROUPEND
 };
 
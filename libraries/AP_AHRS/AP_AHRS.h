@@ -640,6 +640,7 @@ protected:
     AP_Float _custom_roll;
     AP_Float _custom_pitch;
     AP_Float _custom_yaw;
+    AP_Int8 _dcm_divider;
 
     Matrix3f _custom_rotation;
 
@@ -90,18 +90,27 @@ AP_AHRS_DCM::update(bool skip_ins_update)
     // in ArduCopter
     if (delta_t > 0.2f) {
         memset((void *)&_ra_sum[0], 0, sizeof(_ra_sum));
+        memset((void *)&_imu_accum, 0, sizeof(_imu_accum));
         _ra_deltat = 0;
         return;
     }
 
+    accumulate_imu(delta_t);
+    if (_imu_accum.count < _update_divider) {
+        // running at a reduced rate, catch up on a later call
+        return;
+    }
+
     // Integrate the DCM matrix using gyro inputs
-    matrix_update(delta_t);
+    matrix_update(_imu_accum.delta_t);
 
     // Normalize the DCM matrix
     normalize();
 
     // Perform drift correction
-    drift_correction(delta_t);
+    drift_correction(_imu_accum.delta_t);
+
+    memset((void *)&_imu_accum, 0, sizeof(_imu_accum));
 
     // paranoid check for bad values in the DCM matrix
     check_matrix();
@@ -132,17 +141,12 @@ void AP_AHRS_DCM::backup_attitude(void)
     pd.yaw_rad = yaw;
 }
 
-// update the DCM matrix using only the gyros
+/*
+  add the IMU data for this loop to the data for the next full update
+ */
 void
-AP_AHRS_DCM::matrix_update(float _G_Dt)
+AP_AHRS_DCM::accumulate_imu(float delta_t)
 {
-    // note that we do not include the P terms in _omega. This is
-    // because the spin_rate is calculated from _omega.length(),
-    // and including the P terms would give positive feedback into
-    // the _P_gain() calculation, which can lead to a very large P
-    // value
-    _omega.zero();
-
     // average across first two healthy gyros. This reduces noise on
     // systems with more than one gyro. We don't use the 3rd gyro
     // unless another is unhealthy as 3rd gyro on PH2 has a lot more
@@ -163,6 +167,32 @@ AP_AHRS_DCM::matrix_update(float _G_Dt)
     if (healthy_count > 1) {
         delta_angle /= healthy_count;
     }
+    _imu_accum.delta_angle += delta_angle;
+    _imu_accum.delta_t += delta_t;
+
+    for (uint8_t i=0; i<_ins.get_accel_count(); i++) {
+        Vector3f delta_velocity;
+        float delta_velocity_dt;
+        _ins.get_delta_velocity(i, delta_velocity, delta_velocity_dt);
+        _imu_accum.delta_velocity[i] += delta_velocity;
+        _imu_accum.delta_velocity_dt[i] += delta_velocity_dt;
+    }
+
+    _imu_accum.count++;
+}
+
+// update the DCM matrix using only the gyros
+void
+AP_AHRS_DCM::matrix_update(float _G_Dt)
+{
+    // note that we do not include the P terms in _omega. This is
+    // because the spin_rate is calculated from _omega.length(),
+    // and including the P terms would give positive feedback into
+    // the _P_gain() calculation, which can lead to a very large P
+    // value
+    _omega.zero();
+
+    const Vector3f &delta_angle = _imu_accum.delta_angle;
     if (_G_Dt > 0) {
         _omega = delta_angle / _G_Dt;
         _omega += _omega_I;
@@ -649,9 +679,8 @@ AP_AHRS_DCM::drift_correction(float deltat)
               accel value is sampled over the right time delta for
               each sensor, which prevents an aliasing effect
              */
-            Vector3f delta_velocity;
-            float delta_velocity_dt;
-            _ins.get_delta_velocity(i, delta_velocity, delta_velocity_dt);
+            const Vector3f &delta_velocity = _imu_accum.delta_velocity[i];
+            const float delta_velocity_dt = _imu_accum.delta_velocity_dt[i];
             if (delta_velocity_dt > 0) {
                 _accel_ef[i] = _dcm_matrix * (delta_velocity / delta_velocity_dt);
                 // integrate the accel vector in the earth frame between GPS readings
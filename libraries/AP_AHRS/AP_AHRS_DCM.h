@@ -121,11 +121,17 @@ public:
     // requires_position should be true if horizontal position configuration should be checked (not used)
     bool pre_arm_check(bool requires_position, char *failure_msg, uint8_t failure_msg_len) const override;
 
+protected:
+    // run the full update only on every this many calls, with the IMU
+    // data accumulated in between
+    uint8_t _update_divider = 1;
+
 private:
     float _ki;
     float _ki_yaw;
 
     // Methods
+    void            accumulate_imu(float delta_t);
     void            matrix_update(float _G_Dt);
     void            normalize(void);
     void            check_matrix(void);
@@ -139,6 +145,15 @@ private:
     void            load_watchdog_home();
     void            backup_attitude(void);
 
+    // IMU data accumulated since the last full update
+    struct {
+        Vector3f delta_angle;                           // averaged across the first two healthy gyros
+        float delta_t;
+        Vector3f delta_velocity[INS_MAX_INSTANCES];
+        float delta_velocity_dt[INS_MAX_INSTANCES];
+        uint8_t count;
+    } _imu_accum;
+
     // primary representation of attitude of board used for all inertial calculations
     Matrix3f _dcm_matrix;
 
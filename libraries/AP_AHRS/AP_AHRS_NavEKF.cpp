@@ -221,6 +221,11 @@ void AP_AHRS_NavEKF::update_DCM(bool skip_ins_update)
     yaw = _dcm_attitude.z;
     update_cd_values();
 
+    // DCM only needs to run every loop when it is providing the
+    // attitude. Otherwise it can run at a reduced rate as a fallback,
+    // catching up from its accumulated IMU data on the next update
+    _update_divider = active_EKF_type() == EKFType::NONE ? 1 : MAX(_dcm_divider.get(), 1);
+
     AP_AHRS_DCM::update(skip_ins_update);
 
     // keep DCM attitude available for get_secondary_attitude()
@@ -63,11 +63,28 @@ void AP_AHRS_View::update(bool skip_ins_update)
     rot_body_to_ned = ahrs.get_rotation_body_to_ned();
     gyro = ahrs.get_gyro();
 
-    if (!is_zero(y_angle + _pitch_trim_deg)) {
-        rot_body_to_ned = rot_body_to_ned * rot_view_T;
-        gyro = rot_view * gyro;
+    if (is_zero(y_angle + _pitch_trim_deg)) {
+        // the view is the same as the AHRS attitude, so reuse the
+        // euler angles and trig values it has already calculated for
+        // this loop rather than recomputing them
+        roll  = ahrs.roll;
+        pitch = ahrs.pitch;
+        yaw   = ahrs.yaw;
+        roll_sensor  = ahrs.roll_sensor;
+        pitch_sensor = ahrs.pitch_sensor;
+        yaw_sensor   = ahrs.yaw_sensor;
+        trig.cos_roll  = ahrs.cos_roll();
+        trig.cos_pitch = ahrs.cos_pitch();
+        trig.cos_yaw   = ahrs.cos_yaw();
+        trig.sin_roll  = ahrs.sin_roll();
+        trig.sin_pitch = ahrs.sin_pitch();
+        trig.sin_yaw   = ahrs.sin_yaw();
+        return;
     }
 
+    rot_body_to_ned = rot_body_to_ned * rot_view_T;
+    gyro = rot_view * gyro;
+
     rot_body_to_ned.to_euler(&roll, &pitch, &yaw);
 
     roll_sensor  = degrees(roll) * 100;
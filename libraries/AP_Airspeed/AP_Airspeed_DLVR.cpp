@@ -86,29 +86,28 @@ void AP_Airspeed_DLVR::timer()
     float press_h2o = 1.25f * 2.0f * range_inH2O * ((pres_raw - DLVR_OFFSET) / DLVR_SCALE);
     float temp = temp_raw * (200.0f / 2047.0f) - 50.0f;
 
-    WITH_SEMAPHORE(sem);
-
-    pressure_sum += INCH_OF_H2O_TO_PASCAL * press_h2o;
-    temperature_sum += temp;
-    press_count++;
-    temp_count++;
+    accum.accumulate(Vector2f(INCH_OF_H2O_TO_PASCAL * press_h2o, temp));
     last_sample_time_ms = AP_HAL::millis();
 }
 
+// take the mean of any new samples from the bus thread
+void AP_Airspeed_DLVR::update_mean()
+{
+    Vector2f mean;
+    if (accum.consume(mean)) {
+        pressure = mean.x;
+        temperature = mean.y;
+    }
+}
+
 // return the current differential_pressure in Pascal
 bool AP_Airspeed_DLVR::get_differential_pressure(float &_pressure)
 {
-    WITH_SEMAPHORE(sem);
-
     if ((AP_HAL::millis() - last_sample_time_ms) > 100) {
         return false;
     }
 
-    if (press_count > 0) {
-        pressure = pressure_sum / press_count;
-        press_count = 0;
-        pressure_sum = 0;
-    }
+    update_mean();
 
     _pressure = pressure;
     return true;
@@ -117,17 +116,11 @@ bool AP_Airspeed_DLVR::get_differential_pressure(float &_pressure)
 // return the current temperature in degrees C, if available
 bool AP_Airspeed_DLVR::get_temperature(float &_temperature)
 {
-    WITH_SEMAPHORE(sem);
-
     if ((AP_HAL::millis() - last_sample_time_ms) > 100) {
         return false;
     }
 
-    if (temp_count > 0) {
-        temperature = temperature_sum / temp_count;
-        temp_count = 0;
-        temperature_sum = 0;
-    }
+    update_mean();
 
     _temperature = temperature;
     return true;
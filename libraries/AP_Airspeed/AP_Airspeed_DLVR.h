@@ -20,6 +20,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/OwnPtr.h>
 #include <AP_HAL/I2CDevice.h>
+#include <AP_Common/SeqLock.h>
 #include <utility>
 
 #include "AP_Airspeed_Backend.h"
@@ -42,14 +43,14 @@ public:
 
 private:
     void timer();
+    void update_mean();
 
     float pressure;
     float temperature;
-    float temperature_sum;
-    float pressure_sum;
-    uint32_t temp_count;
-    uint32_t press_count;
-    
+
+    // mean pressure (x) and temperature (y) from the bus thread
+    SeqLockAccumulator<Vector2f> accum;
+
     uint32_t last_sample_time_ms;
     const float range_inH2O;
 
@@ -173,12 +173,8 @@ void AP_Airspeed_MS4525::_collect()
     _voltage_correction(press, temp);
     _voltage_correction(press2, temp2);
 
-    WITH_SEMAPHORE(sem);
-
-    _press_sum += press + press2;
-    _temp_sum += temp + temp2;
-    _press_count += 2;
-    _temp_count += 2;
+    _accum.accumulate(Vector2f(press, temp));
+    _accum.accumulate(Vector2f(press2, temp2));
 
     _last_sample_time_ms = AP_HAL::millis();
 }
@@ -220,20 +216,24 @@ void AP_Airspeed_MS4525::_timer()
     }
 }
 
+// take the mean of any new samples from the bus thread
+void AP_Airspeed_MS4525::_update_mean()
+{
+    Vector2f mean;
+    if (_accum.consume(mean)) {
+        _pressure = mean.x;
+        _temperature = mean.y;
+    }
+}
+
 // return the current differential_pressure in Pascal
 bool AP_Airspeed_MS4525::get_differential_pressure(float &pressure)
 {
-    WITH_SEMAPHORE(sem);
-
     if ((AP_HAL::millis() - _last_sample_time_ms) > 100) {
         return false;
     }
 
-    if (_press_count > 0) {
-        _pressure = _press_sum / _press_count;
-        _press_count = 0;
-        _press_sum = 0;
-    }
+    _update_mean();
 
     pressure = _pressure;
     return true;
@@ -242,17 +242,11 @@ bool AP_Airspeed_MS4525::get_differential_pressure(float &pressure)
 // return the current temperature in degrees C, if available
 bool AP_Airspeed_MS4525::get_temperature(float &temperature)
 {
-    WITH_SEMAPHORE(sem);
-
     if ((AP_HAL::millis() - _last_sample_time_ms) > 100) {
         return false;
     }
 
-    if (_temp_count > 0) {
-        _temperature = _temp_sum / _temp_count;
-        _temp_count = 0;
-        _temp_sum = 0;
-    }
+    _update_mean();
 
     temperature = _temperature;
     return true;
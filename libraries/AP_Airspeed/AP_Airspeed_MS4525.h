@@ -22,6 +22,7 @@
 #include <AP_Param/AP_Param.h>
 #include <AP_HAL/utility/OwnPtr.h>
 #include <AP_HAL/I2CDevice.h>
+#include <AP_Common/SeqLock.h>
 #include <utility>
 
 #include "AP_Airspeed_Backend.h"
@@ -48,11 +49,10 @@ private:
     void _voltage_correction(float &diff_press_pa, float &temperature);
     float _get_pressure(int16_t dp_raw) const;
     float _get_temperature(int16_t dT_raw) const;
+    void _update_mean();
 
-    float _temp_sum;
-    float _press_sum;
-    uint32_t _temp_count;
-    uint32_t _press_count;
+    // mean pressure (x) and temperature (y) from the bus thread
+    SeqLockAccumulator<Vector2f> _accum;
     float _temperature;
     float _pressure;
     uint32_t _last_sample_time_ms;
@@ -30,6 +30,14 @@ extern const AP_HAL::HAL& hal;
     #define AP_AVOIDANCE_FAIL_ACTION_DEFAULT            MAV_COLLISION_ACTION_REPORT
 #endif
 
+#ifndef AP_AVOIDANCE_OBS_MAX_DEFAULT
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+    #define AP_AVOIDANCE_OBS_MAX_DEFAULT                40
+#else
+    #define AP_AVOIDANCE_OBS_MAX_DEFAULT                20
+#endif
+#endif
+
 #if AVOIDANCE_DEBUGGING
 #include <stdio.h>
 #define debug(fmt, args ...)  do {::fprintf(stderr,"%s:%d: " fmt "\n", __FUNCTION__, __LINE__, ## args); } while(0)
@@ -71,8 +79,9 @@ const AP_Param::GroupInfo AP_Avoidance::var_info[] = {
     // @Param: OBS_MAX
     // @DisplayName: Maximum number of obstacles to track
     // @Description: Maximum number of obstacles to track
+    // @Range: 1 127
     // @User: Advanced
-    AP_GROUPINFO("OBS_MAX",     5, AP_Avoidance, _obstacles_max, 20),
+    AP_GROUPINFO("OBS_MAX",     5, AP_Avoidance, _obstacles_max, AP_AVOIDANCE_OBS_MAX_DEFAULT),
 
     // @Param: W_TIME
     // @DisplayName: Time Horizon Warn
@@ -331,6 +340,32 @@ float closest_approach_z(const Location &my_loc,
     return ret/100.0f;
 }
 
+/*
+  returns true if the obstacle can not get within the warn or fail
+  distances inside the time horizons. The closest approach can be no
+  less than the current separation less the distance covered at the
+  current relative speed, which is much cheaper than the full closest
+  approach calculation and rejects most far away traffic outright
+ */
+bool AP_Avoidance::obstacle_out_of_reach(const Vector2f &delta_pos_ne,
+                                         const Vector3f &delta_vel_ned,
+                                         const float delta_pos_d,
+                                         const uint8_t fail_time_horizon,
+                                         const uint8_t warn_time_horizon) const
+{
+    // vertical separation beyond the warn distance at the end of the
+    // warn horizon always clears the threat level
+    const float reach_z = fabsf(delta_vel_ned.z) * warn_time_horizon;
+    if (fabsf(delta_pos_d) - reach_z > _warn_distance_z) {
+        return true;
+    }
+
+    const float speed_xy = norm(delta_vel_ned.x, delta_vel_ned.y);
+    const float dist_xy = delta_pos_ne.length();
+    return (dist_xy - speed_xy * fail_time_horizon >= _fail_distance_xy) &&
+           (dist_xy - speed_xy * warn_time_horizon >= _warn_distance_xy);
+}
+
 void AP_Avoidance::update_threat_level(const Location &my_loc,
                                        const Vector3f &my_vel,
                                        AP_Avoidance::Obstacle &obstacle)
@@ -341,12 +376,37 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
 
     obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
 
+    // If we haven't heard from a vehicle then assume it is no threat,
+    // check_for_threats() ignores it so there is nothing more to fill in
     const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
-    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
+    if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
+        return;
+    }
+
+    const uint8_t fail_time_horizon = _fail_time_horizon + obstacle_age/1000;
+    const uint8_t warn_time_horizon = _warn_time_horizon + obstacle_age/1000;
+
+    const Vector2f delta_pos_ne = obstacle_loc.get_distance_NE(my_loc);
+    const Vector3f delta_vel_ned = obstacle_vel - my_vel;
+    const float delta_pos_d = (obstacle_loc.alt - my_loc.alt) * 0.01f;
+    if (obstacle_out_of_reach(delta_pos_ne, delta_vel_ned, delta_pos_d, fail_time_horizon, warn_time_horizon)) {
+        // fill in conservative values for the GCS: the separation
+        // can shrink by at most the relative speed over the horizon
+        const float speed_xy = norm(delta_vel_ned.x, delta_vel_ned.y);
+        const float current_distance = delta_pos_ne.length();
+        const float reach_xy = MIN(speed_xy * warn_time_horizon, current_distance);
+        obstacle.closest_approach_xy = current_distance - reach_xy;
+        obstacle.closest_approach_z = MAX(fabsf(delta_pos_d) - fabsf(delta_vel_ned.z) * warn_time_horizon, 0.0f);
+        obstacle.distance_to_closest_approach = reach_xy;
+        obstacle.time_to_closest_approach = is_positive(speed_xy) ? reach_xy / speed_xy : 0.0f;
+        return;
+    }
+
+    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, fail_time_horizon);
     if (closest_xy < _fail_distance_xy) {
         obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
     } else {
-        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
+        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, warn_time_horizon);
         if (closest_xy < _warn_distance_xy) {
             obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
         }
@@ -354,23 +414,18 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
 
     // check for vertical separation; our threat level is the minimum
     // of vertical and horizontal threat levels
-    float closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
+    float closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, warn_time_horizon);
     if (obstacle.threat_level != MAV_COLLISION_THREAT_LEVEL_NONE) {
         if (closest_z > _warn_distance_z) {
             obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
         } else {
-            closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
+            closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, fail_time_horizon);
             if (closest_z > _fail_distance_z) {
                 obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
             }
         }
     }
 
-    // If we haven't heard from a vehicle then assume it is no threat
-    if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
-        obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
-    }
-
     // could optimise this to not calculate a lot of this if threat
     // level is none - but only *once the GCS has been informed*!
     obstacle.closest_approach_xy = closest_xy;
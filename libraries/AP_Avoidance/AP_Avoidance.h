@@ -183,6 +183,14 @@ private:
     // threat than the current most serious threat
     bool obstacle_is_more_serious_threat(const AP_Avoidance::Obstacle &obstacle) const;
 
+    // returns true if the obstacle can't become a threat within the
+    // time horizons, before doing the full closest approach calculation
+    bool obstacle_out_of_reach(const Vector2f &delta_pos_ne,
+                               const Vector3f &delta_vel_ned,
+                               float delta_pos_d,
+                               uint8_t fail_time_horizon,
+                               uint8_t warn_time_horizon) const;
+
     // internal variables
     AP_Avoidance::Obstacle *_obstacles;
     uint8_t _obstacles_allocated;
@@ -140,15 +140,7 @@ void AP_Baro_BMP280::_timer(void)
 // transfer data to the frontend
 void AP_Baro_BMP280::update(void)
 {
-    WITH_SEMAPHORE(_sem);
-
-    if (_pressure_count == 0) {
-        return;
-    }
-
-    _copy_to_frontend(_instance, _pressure_sum/_pressure_count, _temperature);
-    _pressure_count = 0;
-    _pressure_sum = 0;
+    _copy_published_to_frontend(_instance);
 }
 
 // calculate temperature
@@ -162,11 +154,7 @@ void AP_Baro_BMP280::_update_temperature(int32_t temp_raw)
     _t_fine = var1 + var2;
     t = (_t_fine * 5 + 128) >> 8;
 
-    const float temp = ((float)t) / 100.0f;
-
-    WITH_SEMAPHORE(_sem);
-    
-    _temperature = temp;
+    _temperature = ((float)t) / 100.0f;
 }
 
 // calculate pressure
@@ -197,9 +185,6 @@ void AP_Baro_BMP280::_update_pressure(int32_t press_raw)
     if (!pressure_ok(press)) {
         return;
     }
-    
-    WITH_SEMAPHORE(_sem);
-    
-    _pressure_sum += press;
-    _pressure_count++;
+
+    _publish_sample(press, _temperature);
 }
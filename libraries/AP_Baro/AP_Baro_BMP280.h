@@ -34,8 +34,6 @@ private:
 
     uint8_t _instance;
     int32_t _t_fine;
-    float _pressure_sum;
-    uint32_t _pressure_count;
     float _temperature;
 
     // Internal calibration registers
@@ -141,18 +141,7 @@ void AP_Baro_BMP388::timer(void)
 // transfer data to the frontend
 void AP_Baro_BMP388::update(void)
 {
-    WITH_SEMAPHORE(_sem);
-
-    if (pressure_count == 0) {
-        return;
-    }
-
-    _copy_to_frontend(instance,
-                      pressure_sum/pressure_count,
-                      temperature);
-
-    pressure_sum = 0;
-    pressure_count = 0;
+    _copy_published_to_frontend(instance);
 }
 
 /*
@@ -187,7 +176,6 @@ void AP_Baro_BMP388::update_temperature(uint32_t data)
     float partial1 = data - calib.par_t1;
     float partial2 = partial1 * calib.par_t2;
 
-    WITH_SEMAPHORE(_sem);
     temperature = partial2 + sq(partial1) * calib.par_t3;
 }
 
@@ -212,10 +200,7 @@ void AP_Baro_BMP388::update_pressure(uint32_t data)
     float partial4 = partial3 + powf(data, 3) * calib.par_p11;
     float press = partial_out1 + partial_out2 + partial4;
 
-    WITH_SEMAPHORE(_sem);
-
-    pressure_sum += press;
-    pressure_count++;
+    _publish_sample(press, temperature);
 }
 
 /*
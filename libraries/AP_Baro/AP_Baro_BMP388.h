@@ -33,8 +33,6 @@ private:
     AP_HAL::OwnPtr<AP_HAL::Device> dev;
 
     uint8_t instance;
-    float pressure_sum;
-    uint32_t pressure_count;
     float temperature;
 
     // Internal calibration registers
@@ -14,7 +14,11 @@ void AP_Baro_Backend::update_healthy_flag(uint8_t instance)
     if (instance >= _frontend._num_sensors) {
         return;
     }
-    WITH_SEMAPHORE(_sem);
+    // backends publishing with _publish_sample() only touch the
+    // frontend from the main thread so don't need the semaphore
+    if (!_lock_free_publish) {
+        _sem.take_blocking();
+    }
 
     // consider a sensor as healthy if it has had an update in the
     // last 0.5 seconds and values are non-zero and have changed within the last 2 seconds
@@ -32,6 +36,10 @@ void AP_Baro_Backend::update_healthy_flag(uint8_t instance)
         // mark a sensor unhealthy
         _frontend.sensors[instance].healthy = false;
     }
+
+    if (!_lock_free_publish) {
+        _sem.give();
+    }
 }
 
 void AP_Baro_Backend::backend_update(uint8_t instance)
@@ -62,6 +70,28 @@ void AP_Baro_Backend::_copy_to_frontend(uint8_t instance, float pressure, float
     _frontend.sensors[instance].last_update_ms = now;
 }
 
+/*
+  add a sample to the mean published for update(). The mean restarts
+  once update() has copied it, and is limited to the last 32 samples
+  if update() isn't keeping up
+ */
+void AP_Baro_Backend::_publish_sample(float pressure, float temperature)
+{
+    _lock_free_publish = true;
+    _accum.accumulate(Vector2f(pressure, temperature), 32);
+}
+
+/*
+  copy the mean of the samples since the last call to the frontend
+ */
+void AP_Baro_Backend::_copy_published_to_frontend(uint8_t instance)
+{
+    Vector2f mean;
+    if (_accum.consume(mean)) {
+        _copy_to_frontend(instance, mean.x, mean.y);
+    }
+}
+
 static constexpr float FILTER_KOEF = 0.1f;
 
 /* Check that the baro value is valid by using a mean filter. If the
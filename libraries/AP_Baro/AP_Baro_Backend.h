@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AP_Baro.h"
+#include <AP_Common/SeqLock.h>
 
 class AP_Baro_Backend
 {
@@ -60,6 +61,14 @@ protected:
 
     void _copy_to_frontend(uint8_t instance, float pressure, float temperature);
 
+    // add a sample from the sensor thread to the running mean and
+    // publish it. Only one thread may call this
+    void _publish_sample(float pressure, float temperature);
+
+    // copy the mean published by _publish_sample() to the frontend if
+    // there have been new samples. Does not take _sem
+    void _copy_published_to_frontend(uint8_t instance);
+
     // semaphore for access to shared frontend data
     HAL_Semaphore _sem;
 
@@ -74,4 +83,11 @@ protected:
     void set_bus_id(uint8_t instance, uint32_t id) {
         _frontend.sensors[instance].bus_id.set(int32_t(id));
     }
+
+private:
+    // mean pressure (x) and temperature (y) from _publish_sample()
+    SeqLockAccumulator<Vector2f> _accum;
+
+    // true once the backend publishes with _publish_sample()
+    bool _lock_free_publish;
 };
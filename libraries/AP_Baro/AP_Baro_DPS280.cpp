@@ -283,25 +283,12 @@ void AP_Baro_DPS280::timer(void)
     if (fabsf(last_temperature) <= TEMPERATURE_LIMIT_C) {
         err_count = 0;
     }
-    
-    WITH_SEMAPHORE(_sem);
 
-    pressure_sum += pressure;
-    temperature_sum += temperature;
-    count++;
+    _publish_sample(pressure, temperature);
 }
 
 // transfer data to the frontend
 void AP_Baro_DPS280::update(void)
 {
-    if (count == 0) {
-        return;
-    }
-
-    WITH_SEMAPHORE(_sem);
-
-    _copy_to_frontend(instance, pressure_sum/count, temperature_sum/count);
-    pressure_sum = 0;
-    temperature_sum = 0;
-    count=0;
+    _copy_published_to_frontend(instance);
 }
@@ -37,10 +37,7 @@ protected:
 
     uint8_t instance;
 
-    uint32_t count;
     uint8_t err_count;
-    float pressure_sum;
-    float temperature_sum;
     float last_temperature;
     bool pending_reset;
     bool is_dps310;
@@ -205,27 +205,14 @@ void AP_Baro_SPL06::_timer(void)
 // transfer data to the frontend
 void AP_Baro_SPL06::update(void)
 {
-    WITH_SEMAPHORE(_sem);
-
-    if (_pressure_count == 0) {
-        return;
-    }
-
-    _copy_to_frontend(_instance, _pressure_sum/_pressure_count, _temperature);
-
-    _pressure_sum = 0;
-    _pressure_count = 0;
+    _copy_published_to_frontend(_instance);
 }
 
 // calculate temperature
 void AP_Baro_SPL06::_update_temperature(int32_t temp_raw)
 {
     _temp_raw = (float)temp_raw / raw_value_scale_factor(SPL06_TEMPERATURE_OVERSAMPLING);
-    const float temp_comp = (float)_c0 / 2 + _temp_raw * _c1;
-
-    WITH_SEMAPHORE(_sem);
-
-    _temperature = temp_comp;
+    _temperature = (float)_c0 / 2 + _temp_raw * _c1;
 }
 
 // calculate pressure
@@ -241,8 +228,5 @@ void AP_Baro_SPL06::_update_pressure(int32_t press_raw)
         return;
     }
 
-    WITH_SEMAPHORE(_sem);
-
-    _pressure_sum += press_comp;
-    _pressure_count++;
+    _publish_sample(press_comp, _temperature);
 }
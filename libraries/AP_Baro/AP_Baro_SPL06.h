@@ -37,8 +37,6 @@ private:
     int8_t _timer_counter;
     uint8_t _instance;
     float _temp_raw;
-    float _pressure_sum;
-    uint32_t _pressure_count;
     float _temperature;
 
     // Internal calibration registers
@@ -2,6 +2,8 @@
 
 #define AP_BATTMONITOR_SMBUS_PEC_POLYNOME 0x07 // Polynome for CRC generation
 
+uint8_t AP_BattMonitor_SMBus::_num_scheduled;
+
 AP_BattMonitor_SMBus::AP_BattMonitor_SMBus(AP_BattMonitor &mon,
                                            AP_BattMonitor::BattMonitor_State &mon_state,
                                            AP_BattMonitor_Params &params,
@@ -16,8 +18,30 @@ AP_BattMonitor_SMBus::AP_BattMonitor_SMBus(AP_BattMonitor &mon,
 void AP_BattMonitor_SMBus::init(void)
 {
     if (_dev) {
-        timer_handle = _dev->register_periodic_callback(100000, FUNCTOR_BIND_MEMBER(&AP_BattMonitor_SMBus::timer, void));
+        // batteries on one bus take turns, each starting a little after
+        // the one before so their reads don't all land on the bus together
+        const uint8_t slots = MAX(timer_period_us() / AP_BATTMONITOR_SMBUS_STAGGER_US, 1U);
+        const uint32_t start_delay_us = AP_BATTMONITOR_SMBUS_STAGGER_US * (1 + _num_scheduled++ % slots);
+        timer_handle = _dev->register_periodic_callback(start_delay_us, FUNCTOR_BIND_MEMBER(&AP_BattMonitor_SMBus::scheduled_timer, void));
+    }
+}
+
+void AP_BattMonitor_SMBus::scheduled_timer(void)
+{
+    // the period can only be changed from the bus thread
+    if (!_period_set) {
+        _period_set = _dev->adjust_periodic_callback(timer_handle, timer_period_us());
     }
+
+    // if the HAL can't change the period, skip calls to keep to it
+    const uint32_t now_us = AP_HAL::micros();
+    if (_last_timer_us != 0 &&
+        now_us - _last_timer_us < timer_period_us() - AP_BATTMONITOR_SMBUS_STAGGER_US/2) {
+        return;
+    }
+    _last_timer_us = now_us;
+
+    timer();
 }
 
 // return true if cycle count can be provided and fills in cycles argument
@@ -151,6 +175,39 @@ bool AP_BattMonitor_SMBus::read_word(uint8_t reg, uint16_t& data) const
     return true;
 }
 
+/*
+  read several word registers with one acquisition of the bus where the
+  HAL can, rather than setting up a transfer for each register
+ */
+uint8_t AP_BattMonitor_SMBus::read_words(const uint8_t regs[], uint16_t data[], bool ok[], uint8_t n) const
+{
+    n = MIN(n, AP_BATTMONITOR_SMBUS_MAX_BATCH);
+
+    // buffers to hold results (1 extra byte returned holding PEC)
+    const uint8_t read_size = 2 + (_pec_supported ? 1 : 0);
+    uint8_t buff[AP_BATTMONITOR_SMBUS_MAX_BATCH][3];
+    AP_HAL::I2CDevice::BatchRead reads[AP_BATTMONITOR_SMBUS_MAX_BATCH];
+    for (uint8_t i = 0; i < n; i++) {
+        reads[i] = { _dev.get(), regs[i], buff[i], read_size, false };
+    }
+    _dev->read_registers_batch(reads, n);
+
+    uint8_t nok = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        ok[i] = reads[i].ok;
+        // check PEC
+        if (ok[i] && _pec_supported) {
+            ok[i] = get_PEC(AP_BATTMONITOR_SMBUS_I2C_ADDR, regs[i], true, buff[i], 2) == buff[i][2];
+        }
+        if (ok[i]) {
+            // convert buffer to word
+            data[i] = (uint16_t)buff[i][1]<<8 | (uint16_t)buff[i][0];
+            nok++;
+        }
+    }
+    return nok;
+}
+
 /// get_PEC - calculate packet error correction code of buffer
 uint8_t AP_BattMonitor_SMBus::get_PEC(const uint8_t i2c_addr, uint8_t cmd, bool reading, const uint8_t buff[], uint8_t len) const
 {
@@ -11,6 +11,13 @@
 #define AP_BATTMONITOR_SMBUS_BUS_EXTERNAL           1
 #define AP_BATTMONITOR_SMBUS_I2C_ADDR               0x0B
 #define AP_BATTMONITOR_SMBUS_TIMEOUT_MICROS         5000000 // sensor becomes unhealthy if no successful readings for 5 seconds
+#define AP_BATTMONITOR_SMBUS_MAX_BATCH              16      // most registers read_words() can read at once
+
+// each SMBus battery starts reading this long after the one before it,
+// so batteries sharing a bus take turns rather than all reading at once
+#ifndef AP_BATTMONITOR_SMBUS_STAGGER_US
+#define AP_BATTMONITOR_SMBUS_STAGGER_US             10000
+#endif
 
 class AP_BattMonitor_SMBus : public AP_BattMonitor_Backend
 {
@@ -85,6 +92,10 @@ protected:
      // returns true if read was successful, false if failed
     bool read_word(uint8_t reg, uint16_t& data) const;
 
+    // read n word registers in one batch on the bus, setting ok[i] for
+    // each read which succeeded. Returns the number of successful reads
+    uint8_t read_words(const uint8_t regs[], uint16_t data[], bool ok[], uint8_t n) const;
+
     // get_PEC - calculate PEC for a read or write from the battery
     // buff is the data that was read or will be written
     uint8_t get_PEC(const uint8_t i2c_addr, uint8_t cmd, bool reading, const uint8_t buff[], uint8_t len) const;
@@ -101,5 +112,17 @@ protected:
 
     virtual void timer(void) = 0;   // timer function to read from the battery
 
+    // period of calls to timer()
+    virtual uint32_t timer_period_us(void) const { return 100000; }
+
     AP_HAL::Device::PeriodicHandle timer_handle;
+
+private:
+
+    // periodic callback which sets the timer period after the staggered start and calls timer()
+    void scheduled_timer(void);
+
+    static uint8_t _num_scheduled;  // number of SMBus batteries started, to stagger their reads
+    bool _period_set;               // true once the periodic callback has been set to timer_period_us()
+    uint32_t _last_timer_us;        // system time of the last call to timer()
 };
@@ -56,19 +56,31 @@ void AP_BattMonitor_SMBus_Generic::timer()
         return;
     }
 
-    uint16_t data;
     uint32_t tnow = AP_HAL::micros();
 
+    // assert that BATTMONITOR_SMBUS_NUM_CELLS_MAX must be no more than smbus_cell_ids
+    static_assert(BATTMONITOR_SMBUS_NUM_CELLS_MAX <= ARRAY_SIZE(smbus_cell_ids), "BATTMONITOR_SMBUS_NUM_CELLS_MAX must be no more than smbus_cell_ids");
+    static_assert(BATTMONITOR_SMBUS_NUM_CELLS_MAX + 2 <= AP_BATTMONITOR_SMBUS_MAX_BATCH, "BATTMONITOR_SMBUS_NUM_CELLS_MAX too large for one batch");
+
+    // read voltage, current and cell voltages in one batch
+    const uint8_t num_cells = _cell_count_fixed ? _cell_count : BATTMONITOR_SMBUS_NUM_CELLS_MAX;
+    uint8_t regs[BATTMONITOR_SMBUS_NUM_CELLS_MAX + 2];
+    uint16_t data[ARRAY_SIZE(regs)];
+    bool ok[ARRAY_SIZE(regs)];
+    regs[0] = BATTMONITOR_SMBUS_VOLTAGE;
+    regs[1] = BATTMONITOR_SMBUS_CURRENT;
+    for (uint8_t i = 0; i < num_cells; i++) {
+        regs[2 + i] = smbus_cell_ids[i];
+    }
+    read_words(regs, data, ok, num_cells + 2);
+
     // read voltage (V)
-    if (read_word(BATTMONITOR_SMBUS_VOLTAGE, data)) {
-        _state.voltage = (float)data / 1000.0f;
+    if (ok[0]) {
+        _state.voltage = (float)data[0] / 1000.0f;
         _state.last_time_micros = tnow;
         _state.healthy = true;
     }
 
-    // assert that BATTMONITOR_SMBUS_NUM_CELLS_MAX must be no more than smbus_cell_ids
-    static_assert(BATTMONITOR_SMBUS_NUM_CELLS_MAX <= ARRAY_SIZE(smbus_cell_ids), "BATTMONITOR_SMBUS_NUM_CELLS_MAX must be no more than smbus_cell_ids");
-
     // check cell count
     if (!_cell_count_fixed) {
         if (_state.healthy) {
@@ -93,10 +105,11 @@ void AP_BattMonitor_SMBus_Generic::timer()
     static_assert(BATTMONITOR_SMBUS_NUM_CELLS_MAX <= ARRAY_SIZE(_state.cell_voltages.cells), "BATTMONITOR_SMBUS_NUM_CELLS_MAX must be <= number of cells in state voltages");
 
     // read cell voltages
-    for (uint8_t i = 0; i < (_cell_count_fixed ? _cell_count : BATTMONITOR_SMBUS_NUM_CELLS_MAX); i++) {
-        if (read_word(smbus_cell_ids[i], data) && (data > 0) && (data < UINT16_MAX)) {
+    for (uint8_t i = 0; i < num_cells; i++) {
+        const uint16_t cell_mv = data[2 + i];
+        if (ok[2 + i] && (cell_mv > 0) && (cell_mv < UINT16_MAX)) {
             _has_cell_voltages = true;
-            _state.cell_voltages.cells[i] = data;
+            _state.cell_voltages.cells[i] = cell_mv;
             _last_cell_update_us[i] = tnow;
             if (!_cell_count_fixed) {
                 _cell_count = MAX(_cell_count, i + 1);
@@ -113,8 +126,8 @@ void AP_BattMonitor_SMBus_Generic::timer()
     }
 
     // read current (A)
-    if (read_word(BATTMONITOR_SMBUS_CURRENT, data)) {
-        _state.current_amps = -(float)((int16_t)data) / 1000.0f;
+    if (ok[1]) {
+        _state.current_amps = -(float)((int16_t)data[1]) / 1000.0f;
         _state.last_time_micros = tnow;
     }
 
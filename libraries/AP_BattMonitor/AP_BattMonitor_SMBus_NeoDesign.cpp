@@ -32,13 +32,19 @@ void AP_BattMonitor_SMBus_NeoDesign::timer()
         }
     }
 
-    bool read_all_cells = true;
+    // read the cells in one batch
+    static_assert(max_cell_count <= AP_BATTMONITOR_SMBUS_MAX_BATCH, "max_cell_count too large for one batch");
+    uint8_t regs[max_cell_count];
+    uint16_t cells[max_cell_count];
+    bool ok[max_cell_count];
     for(uint8_t i = 0; i < _cell_count; ++i) {
-        if(read_word(BATTMONITOR_ND_CELL_START + i, data)) {
-            _state.cell_voltages.cells[i] = data;
+        regs[i] = BATTMONITOR_ND_CELL_START + i;
+    }
+    const bool read_all_cells = read_words(regs, cells, ok, _cell_count) == _cell_count;
+    for(uint8_t i = 0; i < _cell_count; ++i) {
+        if (ok[i]) {
+            _state.cell_voltages.cells[i] = cells[i];
             _has_cell_voltages = true;
-        } else {
-            read_all_cells = false;
         }
     }
 
@@ -26,15 +26,6 @@ AP_BattMonitor_SMBus_SUI::AP_BattMonitor_SMBus_SUI(AP_BattMonitor &mon,
     _dev->set_retries(2);
 }
 
-void AP_BattMonitor_SMBus_SUI::init(void)
-{
-    AP_BattMonitor_SMBus::init();
-    if (_dev && timer_handle) {
-        // run twice as fast for two phases
-        _dev->adjust_periodic_callback(timer_handle, 50000);
-    }
-}
-
 void AP_BattMonitor_SMBus_SUI::timer()
 {
     uint32_t tnow = AP_HAL::micros();
@@ -15,10 +15,11 @@ public:
                              uint8_t cell_count
                             );
 
-    void init(void) override;
-
 private:
     void timer(void) override;
+
+    // run twice as fast for two phases
+    uint32_t timer_period_us(void) const override { return 50000; }
     void read_cell_voltages();
     void update_health();
 
@@ -10,6 +10,7 @@
 #include <SRV_Channel/SRV_Channel.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_GPS/AP_GPS.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
 #include "AP_Camera_SoloGimbal.h"
 
 // ------------------------------
@@ -321,26 +322,89 @@ void AP_Camera::control(float session, float zoom_pos, float zoom_step, float fo
 void AP_Camera::send_feedback(mavlink_channel_t chan) const
 {
     const AP_AHRS &ahrs = AP::ahrs();
+    const Location &loc = _feedback_state.loc;
 
     float altitude, altitude_rel;
-    if (current_loc.relative_alt) {
-        altitude = current_loc.alt+ahrs.get_home().alt;
-        altitude_rel = current_loc.alt;
+    if (loc.relative_alt) {
+        altitude = loc.alt+ahrs.get_home().alt;
+        altitude_rel = loc.alt;
     } else {
-        altitude = current_loc.alt;
-        altitude_rel = current_loc.alt - ahrs.get_home().alt;
+        altitude = loc.alt;
+        altitude_rel = loc.alt - ahrs.get_home().alt;
     }
 
     mavlink_msg_camera_feedback_send(
         chan,
         AP::gps().time_epoch_usec(),
         0, 0, _image_index,
-        current_loc.lat, current_loc.lng,
+        loc.lat, loc.lng,
         altitude*1e-2f, altitude_rel*1e-2f,
-        ahrs.roll_sensor*1e-2f, ahrs.pitch_sensor*1e-2f, ahrs.yaw_sensor*1e-2f,
+        _feedback_state.roll_cd*1e-2f, _feedback_state.pitch_cd*1e-2f, _feedback_state.yaw_cd*1e-2f,
         0.0f, CAMERA_FEEDBACK_PHOTO, _camera_trigger_logged);
 }
 
+/*
+  get the latest vehicle state. The time is that of the IMU sample the
+  AHRS last updated with, not the time we are called
+ */
+void AP_Camera::get_current_state(StateSample &state) const
+{
+    const AP_AHRS &ahrs = AP::ahrs();
+    state.time_us = AP::ins().get_last_update_usec();
+    state.loc = current_loc;
+    state.roll_cd = ahrs.roll_sensor;
+    state.pitch_cd = ahrs.pitch_sensor;
+    state.yaw_cd = ahrs.yaw_sensor;
+}
+
+void AP_Camera::record_state()
+{
+    get_current_state(_state_history[_state_history_next]);
+    _state_history_next = (_state_history_next + 1) % AP_CAMERA_STATE_HISTORY_SIZE;
+    if (_state_history_count < AP_CAMERA_STATE_HISTORY_SIZE) {
+        _state_history_count++;
+    }
+}
+
+/*
+  find the vehicle state at time_us by linear interpolation between
+  the history samples either side of it. Times outside the history
+  get the nearest sample
+ */
+void AP_Camera::get_state_at(uint32_t time_us, StateSample &state) const
+{
+    if (_state_history_count == 0) {
+        get_current_state(state);
+        return;
+    }
+    // walk back from the newest sample
+    uint8_t idx = (_state_history_next + AP_CAMERA_STATE_HISTORY_SIZE - 1) % AP_CAMERA_STATE_HISTORY_SIZE;
+    const StateSample *newer = &_state_history[idx];
+    if (int32_t(time_us - newer->time_us) >= 0) {
+        state = *newer;
+        return;
+    }
+    for (uint8_t i=1; i<_state_history_count; i++) {
+        idx = (idx + AP_CAMERA_STATE_HISTORY_SIZE - 1) % AP_CAMERA_STATE_HISTORY_SIZE;
+        const StateSample &older = _state_history[idx];
+        if (int32_t(time_us - older.time_us) >= 0) {
+            const uint32_t dt = newer->time_us - older.time_us;
+            const float p = dt > 0 ? float(time_us - older.time_us) / dt : 1.0f;
+            state = older;
+            state.time_us = time_us;
+            state.loc.lat += (newer->loc.lat - older.loc.lat) * p;
+            state.loc.lng += (newer->loc.lng - older.loc.lng) * p;
+            state.loc.alt += (newer->loc.alt - older.loc.alt) * p;
+            state.roll_cd += wrap_180_cd(newer->roll_cd - older.roll_cd) * p;
+            state.pitch_cd += (newer->pitch_cd - older.pitch_cd) * p;
+            state.yaw_cd = wrap_360_cd(state.yaw_cd + wrap_180_cd(newer->yaw_cd - older.yaw_cd) * p);
+            return;
+        }
+        newer = &older;
+    }
+    state = *newer;
+}
+
 
 /*
   update; triggers by distance moved and camera trigger
@@ -396,7 +460,7 @@ void AP_Camera::update()
  */
 void AP_Camera::feedback_pin_isr(uint8_t pin, bool high, uint32_t timestamp_us)
 {
-    _feedback_timestamp_us = timestamp_us;
+    _feedback_timestamp_us[_camera_trigger_count % AP_CAMERA_FEEDBACK_QUEUE_SIZE] = timestamp_us;
     _camera_trigger_count++;
 }
 
@@ -410,7 +474,7 @@ void AP_Camera::feedback_pin_timer(void)
     uint8_t trigger_polarity = _feedback_polarity==0?0:1;
     if (pin_state == trigger_polarity &&
         _last_pin_state != trigger_polarity) {
-        _feedback_timestamp_us = AP_HAL::micros();
+        _feedback_timestamp_us[_camera_trigger_count % AP_CAMERA_FEEDBACK_QUEUE_SIZE] = AP_HAL::micros();
         _camera_trigger_count++;
     }
     _last_pin_state = pin_state;
@@ -449,6 +513,7 @@ void AP_Camera::setup_feedback_callback(void)
 void AP_Camera::log_picture()
 {
     if (!using_feedback_pin()) {
+        get_current_state(_feedback_state);
         gcs().send_message(MSG_CAMERA_FEEDBACK);
     }
 
@@ -461,7 +526,7 @@ void AP_Camera::log_picture()
     }
 
     if (!using_feedback_pin()) {
-        Write_Camera();
+        Write_Camera(_feedback_state);
     } else {
         Write_Trigger();
     }
@@ -488,21 +553,37 @@ void AP_Camera::take_picture()
 void AP_Camera::update_trigger()
 {
     trigger_pic_cleanup();
-    
-    if (_camera_trigger_logged != _camera_trigger_count) {
-        uint32_t timestamp32 = _feedback_timestamp_us;
-        _camera_trigger_logged = _camera_trigger_count;
 
-        gcs().send_message(MSG_CAMERA_FEEDBACK);
-        AP_Logger *logger = AP_Logger::get_singleton();
-        if (logger != nullptr) {
-            if (logger->should_log(log_camera_bit)) {
-                uint32_t tdiff = AP_HAL::micros() - timestamp32;
-                uint64_t timestamp = AP_HAL::micros64();
-                Write_Camera(timestamp - tdiff);
-            }
+    if (!using_feedback_pin()) {
+        return;
+    }
+
+    // keep a short history of the vehicle state so that each pulse
+    // is logged with the state at the time it happened
+    record_state();
+
+    const uint32_t trigger_count = _camera_trigger_count;
+    if (_camera_trigger_logged == trigger_count) {
+        return;
+    }
+    if (trigger_count - _camera_trigger_logged > AP_CAMERA_FEEDBACK_QUEUE_SIZE) {
+        // the queue overflowed, the oldest pulses have been overwritten
+        _camera_trigger_logged = trigger_count - AP_CAMERA_FEEDBACK_QUEUE_SIZE;
+    }
+
+    AP_Logger *logger = AP_Logger::get_singleton();
+    const bool log = logger != nullptr && logger->should_log(log_camera_bit);
+    const uint32_t now_us = AP_HAL::micros();
+    const uint64_t now_us64 = AP_HAL::micros64();
+    while (_camera_trigger_logged != trigger_count) {
+        const uint32_t timestamp32 = _feedback_timestamp_us[_camera_trigger_logged % AP_CAMERA_FEEDBACK_QUEUE_SIZE];
+        _camera_trigger_logged++;
+        get_state_at(timestamp32, _feedback_state);
+        if (log) {
+            Write_Camera(_feedback_state, now_us64 - (now_us - timestamp32));
         }
     }
+    gcs().send_message(MSG_CAMERA_FEEDBACK);
 }
 
 AP_Camera::CamTrigType AP_Camera::get_trigger_type(void)
@@ -13,6 +13,9 @@
 
 #define AP_CAMERA_FEEDBACK_DEFAULT_FEEDBACK_PIN -1  // default is to not use camera feedback pin
 
+#define AP_CAMERA_FEEDBACK_QUEUE_SIZE       16      // feedback pulses that can be queued between updates, must be a power of 2
+#define AP_CAMERA_STATE_HISTORY_SIZE        4       // vehicle state samples kept to interpolate feedback pulses
+
 /// @class	Camera
 /// @brief	Object managing a Photo or video camera
 class AP_Camera {
@@ -117,17 +120,41 @@ private:
 
     uint32_t        _camera_trigger_count;
     uint32_t        _camera_trigger_logged;
-    uint32_t        _feedback_timestamp_us;
+    uint32_t        _feedback_timestamp_us[AP_CAMERA_FEEDBACK_QUEUE_SIZE];  // pulse times indexed by trigger count, written by the ISR
     bool            _timer_installed;
     bool            _isr_installed;
     uint8_t         _last_pin_state;
 
+    // vehicle position and attitude at a point in time
+    struct StateSample {
+        uint32_t time_us;
+        Location loc;
+        int32_t roll_cd;
+        int32_t pitch_cd;
+        int32_t yaw_cd;
+    };
+
+    // recent vehicle state, used to find the state at the time of a feedback pulse
+    StateSample     _state_history[AP_CAMERA_STATE_HISTORY_SIZE];
+    uint8_t         _state_history_count;
+    uint8_t         _state_history_next;
+    StateSample     _feedback_state;    // state reported in the last CAMERA_FEEDBACK
+
+    // get the latest vehicle state
+    void get_current_state(StateSample &state) const;
+
+    // add the latest vehicle state to the history
+    void record_state();
+
+    // interpolate the vehicle state at a time from the history
+    void get_state_at(uint32_t time_us, StateSample &state) const;
+
     void log_picture();
 
     // Logging Function
-    void Write_Camera(uint64_t timestamp_us=0);
+    void Write_Camera(const StateSample &state, uint64_t timestamp_us=0);
     void Write_Trigger(void);
-    void Write_CameraInfo(enum LogMessages msg, uint64_t timestamp_us=0);
+    void Write_CameraInfo(enum LogMessages msg, const StateSample &state, uint64_t timestamp_us=0);
 
     uint32_t log_camera_bit;
     const struct Location &current_loc;
@@ -2,17 +2,18 @@
 #include <AP_Logger/AP_Logger.h>
 
 // Write a Camera packet
-void AP_Camera::Write_CameraInfo(enum LogMessages msg, uint64_t timestamp_us)
+void AP_Camera::Write_CameraInfo(enum LogMessages msg, const StateSample &state, uint64_t timestamp_us)
 {
     const AP_AHRS &ahrs = AP::ahrs();
+    const Location &loc = state.loc;
 
     int32_t altitude, altitude_rel, altitude_gps;
-    if (current_loc.relative_alt) {
-        altitude = current_loc.alt+ahrs.get_home().alt;
-        altitude_rel = current_loc.alt;
+    if (loc.relative_alt) {
+        altitude = loc.alt+ahrs.get_home().alt;
+        altitude_rel = loc.alt;
     } else {
-        altitude = current_loc.alt;
-        altitude_rel = current_loc.alt - ahrs.get_home().alt;
+        altitude = loc.alt;
+        altitude_rel = loc.alt - ahrs.get_home().alt;
     }
     const AP_GPS &gps = AP::gps();
     if (gps.status() >= AP_GPS::GPS_OK_FIX_3D) {
@@ -26,26 +27,28 @@ void AP_Camera::Write_CameraInfo(enum LogMessages msg, uint64_t timestamp_us)
         time_us     : timestamp_us?timestamp_us:AP_HAL::micros64(),
         gps_time    : gps.time_week_ms(),
         gps_week    : gps.time_week(),
-        latitude    : current_loc.lat,
-        longitude   : current_loc.lng,
+        latitude    : loc.lat,
+        longitude   : loc.lng,
         altitude    : altitude,
         altitude_rel: altitude_rel,
         altitude_gps: altitude_gps,
-        roll        : (int16_t)ahrs.roll_sensor,
-        pitch       : (int16_t)ahrs.pitch_sensor,
-        yaw         : (uint16_t)ahrs.yaw_sensor
+        roll        : (int16_t)state.roll_cd,
+        pitch       : (int16_t)state.pitch_cd,
+        yaw         : (uint16_t)state.yaw_cd
     };
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
 // Write a Camera packet
-void AP_Camera::Write_Camera(uint64_t timestamp_us)
+void AP_Camera::Write_Camera(const StateSample &state, uint64_t timestamp_us)
 {
-    Write_CameraInfo(LOG_CAMERA_MSG, timestamp_us);
+    Write_CameraInfo(LOG_CAMERA_MSG, state, timestamp_us);
 }
 
 // Write a Trigger packet
 void AP_Camera::Write_Trigger(void)
 {
-    Write_CameraInfo(LOG_TRIGGER_MSG, 0);
+    StateSample state;
+    get_current_state(state);
+    Write_CameraInfo(LOG_TRIGGER_MSG, state, 0);
 }
\ No newline at end of file
@@ -187,21 +187,26 @@ bool Location::get_alt_cm(AltFrame desired_frame, int32_t &ret_alt_cm) const
     return false;  // LCOV_EXCL_LINE  - not reachable
 }
 
-bool Location::get_vector_xy_from_origin_NE(Vector2f &vec_ne) const
+template<typename T>
+bool Location::get_vector_xy_from_origin_NE(T &vec_ne) const
 {
     Location ekf_origin;
     if (!AP::ahrs().get_origin(ekf_origin)) {
         return false;
     }
-    vec_ne.x = (lat-ekf_origin.lat) * LATLON_TO_CM;
-    vec_ne.y = diff_longitude(lng,ekf_origin.lng) * LATLON_TO_CM * ekf_origin.longitude_scale();
+    // scale in the precision of the result so that double vectors
+    // are not limited to float precision
+    typedef decltype(vec_ne.x) elem_t;
+    vec_ne.x = (lat-ekf_origin.lat) * elem_t(LATLON_TO_CM);
+    vec_ne.y = diff_longitude(lng,ekf_origin.lng) * elem_t(LATLON_TO_CM) * ekf_origin.longitude_scale();
     return true;
 }
 
-bool Location::get_vector_from_origin_NEU(Vector3f &vec_neu) const
+template<typename T>
+bool Location::get_vector_from_origin_NEU(T &vec_neu) const
 {
     // convert lat, lon
-    Vector2f vec_ne;
+    Vector2<decltype(vec_neu.x)> vec_ne;
     if (!get_vector_xy_from_origin_NE(vec_ne)) {
         return false;
     }
@@ -218,6 +223,14 @@ bool Location::get_vector_from_origin_NEU(Vector3f &vec_neu) const
     return true;
 }
 
+// instantiate for float, and for double position types if enabled
+template bool Location::get_vector_xy_from_origin_NE<Vector2f>(Vector2f &vec_ne) const;
+template bool Location::get_vector_from_origin_NEU<Vector3f>(Vector3f &vec_neu) const;
+#if HAL_WITH_POSTYPE_DOUBLE
+template bool Location::get_vector_xy_from_origin_NE<Vector2d>(Vector2d &vec_ne) const;
+template bool Location::get_vector_from_origin_NEU<Vector3d>(Vector3d &vec_neu) const;
+#endif
+
 // return distance in meters between two locations
 float Location::get_distance(const struct Location &loc2) const
 {
@@ -237,6 +250,31 @@ Vector2f Location::get_distance_NE(const Location &loc2) const
                     diff_longitude(loc2.lng,lng) * LOCATION_SCALING_FACTOR * longitude_scale());
 }
 
+Location::DistanceFrom::DistanceFrom(const Location &origin) :
+    lat(origin.lat),
+    lng(origin.lng),
+    lng_scale(LOCATION_SCALING_FACTOR * origin.longitude_scale())
+{
+}
+
+Vector2f Location::DistanceFrom::get_distance_NE(const Location &loc) const
+{
+    return Vector2f((loc.lat - lat) * LOCATION_SCALING_FACTOR,
+                    diff_longitude(loc.lng,lng) * lng_scale);
+}
+
+void Location::DistanceFrom::get_distance_NE(const Location *locs, Vector2f *ofs_ne, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        ofs_ne[i] = get_distance_NE(locs[i]);
+    }
+}
+
+float Location::DistanceFrom::get_distance(const Location &loc) const
+{
+    return get_distance_NE(loc).length();
+}
+
 // return the distance in meters in North/East/Down plane as a N/E/D vector to loc2
 Vector3f Location::get_distance_NED(const Location &loc2) const
 {
@@ -56,8 +56,12 @@ public:
     // return false on failure to get the vector which can only
     // happen if the EKF origin has not been set yet
     // x, y and z are in centimetres
-    bool get_vector_xy_from_origin_NE(Vector2f &vec_ne) const WARN_IF_UNUSED;
-    bool get_vector_from_origin_NEU(Vector3f &vec_neu) const WARN_IF_UNUSED;
+    // available as Vector2f/Vector3f and as Vector2p/Vector3p, where
+    // the latter keep full precision far from the origin
+    template<typename T>
+    bool get_vector_xy_from_origin_NE(T &vec_ne) const WARN_IF_UNUSED;
+    template<typename T>
+    bool get_vector_from_origin_NEU(T &vec_neu) const WARN_IF_UNUSED;
 
     // return distance in meters between two locations
     float get_distance(const struct Location &loc2) const;
@@ -69,6 +73,31 @@ public:
     // return the distance in meters in North/East plane as a N/E vector to loc2
     Vector2f get_distance_NE(const Location &loc2) const;
 
+    /*
+      distances from one location to many others. The longitude scale
+      of the origin is computed once and shared by all of them, rather
+      than being recomputed for each location
+     */
+    class DistanceFrom {
+    public:
+        DistanceFrom(const Location &origin);
+
+        // return the distance in meters in North/East plane as a N/E vector to loc
+        Vector2f get_distance_NE(const Location &loc) const;
+
+        // fill in the N/E distances in meters to count locations
+        void get_distance_NE(const Location *locs, Vector2f *ofs_ne, uint16_t count) const;
+
+        // return distance in meters to loc
+        float get_distance(const Location &loc) const;
+
+    private:
+        const int32_t lat;
+        const int32_t lng;
+        // meters per unit of longitude at the origin
+        const float lng_scale;
+    };
+
     // extrapolate latitude/longitude given distances (in meters) north and east
     void offset(float ofs_north, float ofs_east);
     void offset_double(double ofs_north, double ofs_east);
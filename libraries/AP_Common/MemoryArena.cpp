@@ -0,0 +1,142 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  arena allocator for memory kept until reboot
+ */
+
+#include "MemoryArena.h"
+#include "ExpandingString.h"
+#include <AP_Math/AP_Math.h>
+
+#define ARENA_ALIGNMENT 8U
+#define ARENA_ALIGN(x) (((x) + (ARENA_ALIGNMENT-1)) & ~size_t(ARENA_ALIGNMENT-1))
+
+MemoryArena::Chunk *MemoryArena::chunks;
+uint32_t MemoryArena::num_chunks;
+HAL_Semaphore MemoryArena::sem;
+
+uint8_t *MemoryArena::chunk_data(Chunk *c)
+{
+    return ((uint8_t *)c) + ARENA_ALIGN(sizeof(Chunk));
+}
+
+// return the chunk holding ptr, or nullptr if it has its own allocation
+MemoryArena::Chunk *MemoryArena::find_chunk(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    for (Chunk *c = chunks; c != nullptr; c = c->next) {
+        const uint8_t *data = chunk_data(c);
+        if (p >= data && p < data + MEMORY_ARENA_CHUNK_SIZE) {
+            return c;
+        }
+    }
+    return nullptr;
+}
+
+void *MemoryArena::allocate(size_t size, MemoryTag owner)
+{
+    if (size == 0 || owner >= MemoryTag::NUM_TAGS) {
+        return nullptr;
+    }
+    size = ARENA_ALIGN(size);
+
+    WITH_SEMAPHORE(sem);
+
+    // we account for our own memory, so keep the heap hooks out of it
+    WITH_MEMORY_TAG(UNTAGGED);
+
+    void *ret = nullptr;
+    if (size <= MEMORY_ARENA_MAX_PACKED) {
+        Chunk *c;
+        for (c = chunks; c != nullptr; c = c->next) {
+            if (MEMORY_ARENA_CHUNK_SIZE - c->used >= size) {
+                break;
+            }
+        }
+        if (c == nullptr) {
+            c = (Chunk *)calloc(1, ARENA_ALIGN(sizeof(Chunk)) + MEMORY_ARENA_CHUNK_SIZE);
+            if (c != nullptr) {
+                c->next = chunks;
+                chunks = c;
+                num_chunks++;
+            }
+        }
+        if (c != nullptr) {
+            ret = chunk_data(c) + c->used;
+            c->used += size;
+            c->live += size;
+        }
+    }
+    if (ret == nullptr) {
+        // too big to pack, or no memory for a new chunk
+        ret = calloc(1, size);
+    }
+    if (ret != nullptr) {
+        MemoryTags::adjust(owner, size);
+    }
+    return ret;
+}
+
+void MemoryArena::release(void *ptr, size_t size, MemoryTag owner)
+{
+    if (ptr == nullptr || owner >= MemoryTag::NUM_TAGS) {
+        return;
+    }
+    size = ARENA_ALIGN(size);
+
+    WITH_SEMAPHORE(sem);
+    WITH_MEMORY_TAG(UNTAGGED);
+
+    MemoryTags::adjust(owner, -int32_t(size));
+
+    Chunk *c = find_chunk(ptr);
+    if (c == nullptr) {
+        free(ptr);
+        return;
+    }
+    c->live -= MIN(c->live, uint32_t(size));
+    if (c->live == 0) {
+        // nothing left in this chunk, give it back to the heap
+        Chunk **cp = &chunks;
+        while (*cp != c) {
+            cp = &(*cp)->next;
+        }
+        *cp = c->next;
+        num_chunks--;
+        free(c);
+        return;
+    }
+    if ((uint8_t *)ptr + size == chunk_data(c) + c->used) {
+        // latest allocation from this chunk, so it can be reused
+        memset(ptr, 0, size);
+        c->used -= size;
+    }
+}
+
+void MemoryArena::info(ExpandingString &str)
+{
+    WITH_SEMAPHORE(sem);
+
+    uint32_t used = 0;
+    uint32_t live = 0;
+    for (Chunk *c = chunks; c != nullptr; c = c->next) {
+        used += c->used;
+        live += c->live;
+    }
+    str.printf("ArenaV1\n");
+    str.printf("chunks=%u size=%u used=%u wasted=%u\n",
+               unsigned(num_chunks), unsigned(num_chunks*MEMORY_ARENA_CHUNK_SIZE),
+               unsigned(used), unsigned(used - live));
+}
@@ -0,0 +1,65 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  arena allocator for memory that is allocated at init and kept until
+  reboot. Small allocations are packed together into shared chunks so
+  they don't leave holes in the heap between short lived allocations.
+  All allocations are accounted against the MemoryTag of their owner
+ */
+
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include "MemoryTag.h"
+
+class ExpandingString;
+
+// size of each shared chunk
+#ifndef MEMORY_ARENA_CHUNK_SIZE
+#define MEMORY_ARENA_CHUNK_SIZE 2048
+#endif
+
+// allocations larger than this get their own heap allocation
+#ifndef MEMORY_ARENA_MAX_PACKED
+#define MEMORY_ARENA_MAX_PACKED (MEMORY_ARENA_CHUNK_SIZE/4)
+#endif
+
+class MemoryArena {
+public:
+    // allocate size bytes of zeroed memory, returning nullptr on failure
+    static void *allocate(size_t size, MemoryTag owner);
+
+    // give back memory from allocate(). Space in a shared chunk is only
+    // reused if it was the latest allocation from that chunk, or once
+    // the whole chunk is unused
+    static void release(void *ptr, size_t size, MemoryTag owner);
+
+    // report chunk usage
+    static void info(ExpandingString &str);
+
+private:
+    struct Chunk {
+        Chunk *next;
+        uint32_t used;      // bytes handed out from data
+        uint32_t live;      // bytes handed out and not released
+    };
+
+    static uint8_t *chunk_data(Chunk *c);
+    static Chunk *find_chunk(const void *ptr);
+
+    static Chunk *chunks;
+    static uint32_t num_chunks;
+    static HAL_Semaphore sem;
+};
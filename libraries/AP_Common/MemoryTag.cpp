@@ -0,0 +1,117 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  accounting of heap memory by subsystem
+ */
+
+#include "MemoryTag.h"
+#include "ExpandingString.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+#include <ch.h>
+#else
+#include <pthread.h>
+#endif
+
+static const char *tag_names[] = {
+    "UNTAGGED",
+    "LOGGER",
+    "SCRIPTING",
+    "TERRAIN",
+    "OADATABASE",
+};
+static_assert(ARRAY_SIZE(tag_names) == uint8_t(MemoryTag::NUM_TAGS), "tag_names must match MemoryTag");
+
+/*
+  the current tag and the thread it applies to. These are plain
+  variables as they are read on every allocation
+ */
+static volatile MemoryTag current_tag;
+static void *volatile current_thread;
+static uint32_t tag_bytes[uint8_t(MemoryTag::NUM_TAGS)];
+
+static void *this_thread(void)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+    return (void *)chThdGetSelfX();
+#else
+    return (void *)pthread_self();
+#endif
+}
+
+uint32_t MemoryTags::allocated(MemoryTag tag)
+{
+    if (tag >= MemoryTag::NUM_TAGS) {
+        return 0;
+    }
+    return tag_bytes[uint8_t(tag)];
+}
+
+void MemoryTags::adjust(MemoryTag tag, int32_t bytes)
+{
+    if (tag == MemoryTag::UNTAGGED || tag >= MemoryTag::NUM_TAGS) {
+        return;
+    }
+    uint32_t &b = tag_bytes[uint8_t(tag)];
+    if (bytes < 0 && uint32_t(-bytes) > b) {
+        b = 0;
+    } else {
+        b += bytes;
+    }
+}
+
+const char *MemoryTags::name(MemoryTag tag)
+{
+    if (tag >= MemoryTag::NUM_TAGS) {
+        return "?";
+    }
+    return tag_names[uint8_t(tag)];
+}
+
+void MemoryTags::info(ExpandingString &str)
+{
+    str.printf("MemTagsV1\n");
+    for (uint8_t i=1; i<uint8_t(MemoryTag::NUM_TAGS); i++) {
+        str.printf("%-10s %u\n", tag_names[i], unsigned(tag_bytes[i]));
+    }
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag) :
+    prev_tag(current_tag),
+    prev_thread(current_thread)
+{
+    current_thread = this_thread();
+    current_tag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    current_tag = prev_tag;
+    current_thread = prev_thread;
+}
+
+void memory_tag_allocated(size_t size)
+{
+    if (current_tag != MemoryTag::UNTAGGED && current_thread == this_thread()) {
+        MemoryTags::adjust(current_tag, size);
+    }
+}
+
+void memory_tag_freed(size_t size)
+{
+    if (current_tag != MemoryTag::UNTAGGED && current_thread == this_thread()) {
+        MemoryTags::adjust(current_tag, -int32_t(size));
+    }
+}
@@ -0,0 +1,77 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  accounting of heap memory by the subsystem that allocated it.
+
+  While a MemoryTagScope is alive, heap allocations made by the thread
+  that created it are added to the scope's tag. On ChibiOS frees made
+  in the scope are subtracted again; other boards only see allocations
+  made with new
+ */
+
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+
+class ExpandingString;
+
+// subsystems that memory is accounted against
+enum class MemoryTag : uint8_t {
+    UNTAGGED = 0,
+    LOGGER,
+    SCRIPTING,
+    TERRAIN,
+    OADATABASE,
+    NUM_TAGS
+};
+
+class MemoryTags {
+public:
+    // bytes currently accounted against tag
+    static uint32_t allocated(MemoryTag tag);
+
+    // add to or remove from a tag, for allocators that account for
+    // their own memory
+    static void adjust(MemoryTag tag, int32_t bytes);
+
+    // name of a tag for reporting
+    static const char *name(MemoryTag tag);
+
+    // report bytes by tag
+    static void info(ExpandingString &str);
+};
+
+// account heap allocations on this thread to tag while in scope
+class MemoryTagScope {
+public:
+    MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+
+    /* Do not allow copies */
+    MemoryTagScope(const MemoryTagScope &other) = delete;
+    MemoryTagScope &operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag prev_tag;
+    void *prev_thread;
+};
+
+#define WITH_MEMORY_TAG(tag) MemoryTagScope _memory_tag_scope(MemoryTag::tag)
+
+// hooks called by the allocators
+extern "C" {
+void memory_tag_allocated(size_t size);
+void memory_tag_freed(size_t size);
+}
@@ -0,0 +1,112 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  sequence locks for passing sensor data from a bus thread to the main
+  thread without a semaphore. There must be only one writer, which
+  never waits. Readers retry if a write happened while they copied
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+template <typename T>
+class SeqLock {
+public:
+    // publish a new value. Only one thread may call this
+    void write(const T &value) {
+        const uint32_t seq = __atomic_load_n(&_seq, __ATOMIC_RELAXED);
+        // an odd sequence marks the value as being written
+        __atomic_store_n(&_seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(&_value, &value, sizeof(T));
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        __atomic_store_n(&_seq, seq + 2, __ATOMIC_RELAXED);
+    }
+
+    // copy the latest value, returning false if the writer changed it
+    // during every attempt. On failure value may be a mix of two writes
+    bool read(T &value) const {
+        for (uint8_t tries = 0; tries < 4; tries++) {
+            const uint32_t seq = __atomic_load_n(&_seq, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            memcpy(&value, &_value, sizeof(T));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if ((seq & 1U) == 0 && seq == __atomic_load_n(&_seq, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    uint32_t _seq {};
+    T _value {};
+};
+
+/*
+  mean of the samples a bus thread has taken since the main thread last
+  asked for one. The writer restarts the sums once the reader has taken
+  the latest mean, so neither side takes a semaphore. T needs += and
+  multiplication by a float
+ */
+template <typename T>
+class SeqLockAccumulator {
+public:
+    // add a sample, only one thread may call this. If max_samples is
+    // non-zero the sums are halved when it is reached so the mean
+    // stays recent when the reader stops
+    void accumulate(const T &sample, uint32_t max_samples = 0) {
+        if (__atomic_load_n(&_consumed_count, __ATOMIC_RELAXED) == _sample_count) {
+            _sum = T{};
+            _count = 0;
+        }
+        _sum += sample;
+        _count++;
+        _sample_count++;
+        if (max_samples > 1 && _count >= max_samples) {
+            _sum = _sum * 0.5f;
+            _count /= 2;
+        }
+        _published.write(Mean{_sum * (1.0f / _count), _sample_count});
+    }
+
+    // get the mean of the samples since the last call, returns false
+    // if there are no new samples
+    bool consume(T &mean) {
+        Mean m;
+        if (!_published.read(m) || m.sample_count == _consumed_count) {
+            return false;
+        }
+        __atomic_store_n(&_consumed_count, m.sample_count, __ATOMIC_RELAXED);
+        mean = m.mean;
+        return true;
+    }
+
+private:
+    struct Mean {
+        T mean;
+        uint32_t sample_count;
+    };
+    SeqLock<Mean> _published;
+
+    // only touched by the writer
+    T _sum {};
+    uint32_t _count {};
+    uint32_t _sample_count {};
+
+    // sample_count of the last mean taken, only written by the reader
+    uint32_t _consumed_count {};
+};
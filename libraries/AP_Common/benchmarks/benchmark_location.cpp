@@ -0,0 +1,86 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Common/Location.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// points scattered over a few km around a home location
+#define NUM_LOCATIONS 64
+
+static const Location home{-353632610, 1491652300, 58400, Location::AltFrame::ABSOLUTE};
+static Location locations[NUM_LOCATIONS];
+
+static void setup_locations()
+{
+    for (uint8_t i = 0; i < NUM_LOCATIONS; i++) {
+        locations[i] = home;
+        locations[i].offset(1000 * sinf(i * 0.7f), 1500 * cosf(i * 1.3f));
+    }
+}
+
+static void BM_LocationGetDistance(benchmark::State& state)
+{
+    setup_locations();
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        float d = home.get_distance(locations[i++ % NUM_LOCATIONS]);
+        gbenchmark_escape(&d);
+    }
+}
+
+BENCHMARK(BM_LocationGetDistance);
+
+// the same using a precomputed origin, as for fence and avoidance checks
+static void BM_LocationDistanceFrom(benchmark::State& state)
+{
+    setup_locations();
+    const Location::DistanceFrom from_home{home};
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        float d = from_home.get_distance(locations[i++ % NUM_LOCATIONS]);
+        gbenchmark_escape(&d);
+    }
+}
+
+BENCHMARK(BM_LocationDistanceFrom);
+
+static void BM_LocationGetDistanceNED(benchmark::State& state)
+{
+    setup_locations();
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        Vector3f ned = home.get_distance_NED(locations[i++ % NUM_LOCATIONS]);
+        gbenchmark_escape(&ned);
+    }
+}
+
+BENCHMARK(BM_LocationGetDistanceNED);
+
+static void BM_LocationGetBearingTo(benchmark::State& state)
+{
+    setup_locations();
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        int32_t bearing = home.get_bearing_to(locations[i++ % NUM_LOCATIONS]);
+        gbenchmark_escape(&bearing);
+    }
+}
+
+BENCHMARK(BM_LocationGetBearingTo);
+
+static void BM_LocationOffset(benchmark::State& state)
+{
+    while (state.KeepRunning()) {
+        Location loc = home;
+        loc.offset(123.4f, -567.8f);
+        gbenchmark_escape(&loc);
+    }
+}
+
+BENCHMARK(BM_LocationOffset);
+
+BENCHMARK_MAIN();
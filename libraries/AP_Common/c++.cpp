@@ -6,6 +6,18 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <stdlib.h>
+#include "MemoryTag.h"
+
+/*
+  on ChibiOS the malloc wrappers do the memory tag accounting, so
+  we only need to account for new on other boards. The size of memory
+  given to delete isn't known, so frees are not accounted
+ */
+#if CONFIG_HAL_BOARD != HAL_BOARD_CHIBIOS
+#define NEW_MEMORY_TAG_ALLOCATED(size) memory_tag_allocated(size)
+#else
+#define NEW_MEMORY_TAG_ALLOCATED(size)
+#endif
 
 /*
   globally override new and delete to ensure that we always start with
@@ -16,6 +28,7 @@ void * operator new(size_t size)
     if (size < 1) {
         size = 1;
     }
+    NEW_MEMORY_TAG_ALLOCATED(size);
     return(calloc(size, 1));
 }
 
@@ -29,6 +42,7 @@ void * operator new[](size_t size)
     if (size < 1) {
         size = 1;
     }
+    NEW_MEMORY_TAG_ALLOCATED(size);
     return(calloc(size, 1));
 }
 
@@ -300,6 +300,17 @@ TEST(Location, Tests)
     EXPECT_VECTOR2F_NEAR(Vector2f(-200, -200), test_vec2, ACCURACY);
     EXPECT_TRUE(test_home.get_vector_from_origin_NEU(test_vec3));
     EXPECT_VECTOR2F_NEAR(Vector3f(-200, -200, 0), test_vec3, ACCURACY);
+#if HAL_WITH_POSTYPE_DOUBLE
+    // position types keep cm precision far from the origin
+    Location test_far = test_origin;
+    test_far.lat += 15000000;
+    test_far.lng += 15000000;
+    Vector3p test_vec3p;
+    EXPECT_TRUE(test_far.get_vector_from_origin_NEU(test_vec3p));
+    EXPECT_NEAR(15000000 * LATLON_TO_CM, test_vec3p.x, 0.01);
+    EXPECT_NEAR(15000000 * LATLON_TO_CM * test_origin.longitude_scale(), test_vec3p.y, 0.01);
+    EXPECT_NEAR(0, test_vec3p.z, 0.01);
+#endif
     vehicle.ahrs.unset_home();
     const Location test_location_empty{test_vect, Location::AltFrame::ABOVE_HOME};
     EXPECT_FALSE(test_location_empty.get_vector_from_origin_NEU(test_vec3));
@@ -349,6 +360,33 @@ TEST(Location, Distance)
 
 }
 
+TEST(Location, DistanceFrom)
+{
+    const Location test_home{-35362938, 149165085, 100, Location::AltFrame::ABSOLUTE};
+    const Location locs[] {
+        test_home,
+        Location(-35363938, 149165085, 0, Location::AltFrame::ABOVE_HOME),
+        Location(-35362938, 149166085, 0, Location::AltFrame::ABOVE_HOME),
+        Location(-35361938, 149164085, 0, Location::AltFrame::ABOVE_HOME),
+        Location(-35462938, 149265085, 0, Location::AltFrame::ABOVE_HOME),
+        Location(-35362938, -1799999999, 0, Location::AltFrame::ABOVE_HOME),
+    };
+    const Location::DistanceFrom from_home{test_home};
+    Vector2f ofs_ne[ARRAY_SIZE(locs)];
+    from_home.get_distance_NE(locs, ofs_ne, ARRAY_SIZE(locs));
+    for (uint8_t i=0; i<ARRAY_SIZE(locs); i++) {
+        const Vector2f expected = test_home.get_distance_NE(locs[i]);
+        EXPECT_FLOAT_EQ(expected.x, ofs_ne[i].x);
+        EXPECT_FLOAT_EQ(expected.y, ofs_ne[i].y);
+        EXPECT_FLOAT_EQ(expected.x, from_home.get_distance_NE(locs[i]).x);
+        EXPECT_FLOAT_EQ(expected.y, from_home.get_distance_NE(locs[i]).y);
+        // get_distance() uses the scale of the far location, so only
+        // agrees closely over short distances
+        EXPECT_NEAR(test_home.get_distance(locs[i]), from_home.get_distance(locs[i]),
+                    MAX(0.001f * expected.length(), 1e-4f));
+    }
+}
+
 TEST(Location, Sanitize)
 {
     const Location test_home{-35362938, 149165085, 100, Location::AltFrame::ABSOLUTE};
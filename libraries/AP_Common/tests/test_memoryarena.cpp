@@ -0,0 +1,69 @@
+#include <AP_gtest.h>
+#include <AP_Common/MemoryArena.h>
+#include <AP_Common/ExpandingString.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(MemoryArena, PackedAllocations)
+{
+    const uint32_t before = MemoryTags::allocated(MemoryTag::LOGGER);
+
+    uint8_t *a = (uint8_t *)MemoryArena::allocate(10, MemoryTag::LOGGER);
+    uint8_t *b = (uint8_t *)MemoryArena::allocate(20, MemoryTag::LOGGER);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    EXPECT_EQ(0u, uintptr_t(a) % 8);
+    EXPECT_EQ(0u, uintptr_t(b) % 8);
+    for (uint8_t i=0; i<10; i++) {
+        EXPECT_EQ(0, a[i]);
+    }
+    // small allocations are packed next to each other
+    EXPECT_EQ(a + 16, b);
+    EXPECT_EQ(before + 16 + 24, MemoryTags::allocated(MemoryTag::LOGGER));
+
+    // releasing the latest allocation lets its space be reused, zeroed
+    memset(b, 0x55, 20);
+    MemoryArena::release(b, 20, MemoryTag::LOGGER);
+    uint8_t *c = (uint8_t *)MemoryArena::allocate(20, MemoryTag::LOGGER);
+    EXPECT_EQ(b, c);
+    for (uint8_t i=0; i<20; i++) {
+        EXPECT_EQ(0, c[i]);
+    }
+
+    MemoryArena::release(a, 10, MemoryTag::LOGGER);
+    MemoryArena::release(c, 20, MemoryTag::LOGGER);
+    EXPECT_EQ(before, MemoryTags::allocated(MemoryTag::LOGGER));
+}
+
+TEST(MemoryArena, LargeAllocations)
+{
+    const size_t size = MEMORY_ARENA_MAX_PACKED + 1;
+    uint8_t *p = (uint8_t *)MemoryArena::allocate(size, MemoryTag::TERRAIN);
+    ASSERT_NE(nullptr, p);
+    for (size_t i=0; i<size; i++) {
+        EXPECT_EQ(0, p[i]);
+    }
+    EXPECT_LE(size, MemoryTags::allocated(MemoryTag::TERRAIN));
+    MemoryArena::release(p, size, MemoryTag::TERRAIN);
+    EXPECT_EQ(0u, MemoryTags::allocated(MemoryTag::TERRAIN));
+}
+
+TEST(MemoryArena, Info)
+{
+    void *p = MemoryArena::allocate(100, MemoryTag::OADATABASE);
+    ASSERT_NE(nullptr, p);
+    ExpandingString str;
+    MemoryArena::info(str);
+    EXPECT_NE(nullptr, strstr(str.get_string(), "ArenaV1\nchunks=1 size=2048 used=104 wasted=0\n"));
+    EXPECT_EQ(104u, MemoryTags::allocated(MemoryTag::OADATABASE));
+    MemoryArena::release(p, 100, MemoryTag::OADATABASE);
+}
+
+TEST(MemoryArena, Invalid)
+{
+    EXPECT_EQ(nullptr, MemoryArena::allocate(0, MemoryTag::LOGGER));
+    EXPECT_EQ(nullptr, MemoryArena::allocate(10, MemoryTag::NUM_TAGS));
+    MemoryArena::release(nullptr, 10, MemoryTag::LOGGER);
+}
+
+AP_GTEST_MAIN()
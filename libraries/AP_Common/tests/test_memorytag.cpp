@@ -0,0 +1,65 @@
+#include <AP_gtest.h>
+#include <AP_Common/MemoryTag.h>
+#include <AP_Common/ExpandingString.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(MemoryTag, Scope)
+{
+    const uint32_t before = MemoryTags::allocated(MemoryTag::SCRIPTING);
+    uint8_t *p;
+    {
+        WITH_MEMORY_TAG(SCRIPTING);
+        p = new uint8_t[100];
+    }
+    ASSERT_NE(nullptr, p);
+    EXPECT_LE(before + 100, MemoryTags::allocated(MemoryTag::SCRIPTING));
+
+    // nothing is accounted once the scope has gone
+    const uint32_t after = MemoryTags::allocated(MemoryTag::SCRIPTING);
+    uint8_t *q = new uint8_t[100];
+    EXPECT_EQ(after, MemoryTags::allocated(MemoryTag::SCRIPTING));
+    delete[] q;
+    delete[] p;
+}
+
+TEST(MemoryTag, Nesting)
+{
+    const uint32_t terrain = MemoryTags::allocated(MemoryTag::TERRAIN);
+    const uint32_t logger = MemoryTags::allocated(MemoryTag::LOGGER);
+    WITH_MEMORY_TAG(TERRAIN);
+    {
+        MemoryTagScope logger_scope(MemoryTag::LOGGER);
+        memory_tag_allocated(10);
+    }
+    memory_tag_allocated(20);
+    EXPECT_EQ(logger + 10, MemoryTags::allocated(MemoryTag::LOGGER));
+    EXPECT_EQ(terrain + 20, MemoryTags::allocated(MemoryTag::TERRAIN));
+    memory_tag_freed(20);
+    EXPECT_EQ(terrain, MemoryTags::allocated(MemoryTag::TERRAIN));
+}
+
+TEST(MemoryTag, Adjust)
+{
+    MemoryTags::adjust(MemoryTag::OADATABASE, 50);
+    EXPECT_EQ(50u, MemoryTags::allocated(MemoryTag::OADATABASE));
+    // never goes negative
+    MemoryTags::adjust(MemoryTag::OADATABASE, -100);
+    EXPECT_EQ(0u, MemoryTags::allocated(MemoryTag::OADATABASE));
+    // untagged memory isn't accounted
+    MemoryTags::adjust(MemoryTag::UNTAGGED, 50);
+    EXPECT_EQ(0u, MemoryTags::allocated(MemoryTag::UNTAGGED));
+}
+
+TEST(MemoryTag, Info)
+{
+    MemoryTags::adjust(MemoryTag::OADATABASE, 42);
+    ExpandingString str;
+    MemoryTags::info(str);
+    EXPECT_NE(nullptr, strstr(str.get_string(), "MemTagsV1\n"));
+    EXPECT_NE(nullptr, strstr(str.get_string(), "OADATABASE 42\n"));
+    EXPECT_EQ(nullptr, strstr(str.get_string(), "UNTAGGED"));
+    MemoryTags::adjust(MemoryTag::OADATABASE, -42);
+}
+
+AP_GTEST_MAIN()
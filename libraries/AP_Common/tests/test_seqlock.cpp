@@ -0,0 +1,59 @@
+#include <AP_gtest.h>
+
+#include <AP_Common/SeqLock.h>
+#include <AP_Math/AP_Math.h>
+
+TEST(SeqLock, ReadWrite)
+{
+    SeqLock<Vector3f> lock;
+    Vector3f v;
+    EXPECT_TRUE(lock.read(v));
+    EXPECT_TRUE(v.is_zero());
+
+    lock.write(Vector3f(1, 2, 3));
+    EXPECT_TRUE(lock.read(v));
+    EXPECT_EQ(Vector3f(1, 2, 3), v);
+
+    lock.write(Vector3f(4, 5, 6));
+    EXPECT_TRUE(lock.read(v));
+    EXPECT_EQ(Vector3f(4, 5, 6), v);
+}
+
+TEST(SeqLock, Accumulator)
+{
+    SeqLockAccumulator<float> accum;
+    float mean;
+
+    // nothing to take yet
+    EXPECT_FALSE(accum.consume(mean));
+
+    accum.accumulate(1);
+    accum.accumulate(2);
+    accum.accumulate(3);
+    EXPECT_TRUE(accum.consume(mean));
+    EXPECT_FLOAT_EQ(2, mean);
+
+    // each mean is only taken once
+    EXPECT_FALSE(accum.consume(mean));
+
+    // sums restart after the reader has taken the mean
+    accum.accumulate(10);
+    EXPECT_TRUE(accum.consume(mean));
+    EXPECT_FLOAT_EQ(10, mean);
+}
+
+TEST(SeqLock, AccumulatorMaxSamples)
+{
+    SeqLockAccumulator<float> accum;
+    for (uint8_t i = 0; i < 4; i++) {
+        accum.accumulate(0, 4);
+    }
+    // halved to two samples of weight zero, then two of 6
+    accum.accumulate(6, 4);
+    accum.accumulate(6, 4);
+    float mean;
+    EXPECT_TRUE(accum.consume(mean));
+    EXPECT_FLOAT_EQ(3, mean);
+}
+
+AP_GTEST_MAIN()
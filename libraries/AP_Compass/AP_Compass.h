@@ -3,6 +3,7 @@
 #include <inttypes.h>
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/SeqLock.h>
 #include <AP_Declination/AP_Declination.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
@@ -304,7 +305,8 @@ public:
         LEARN_NONE=0,
         LEARN_INTERNAL=1,
         LEARN_EKF=2,
-        LEARN_INFLIGHT=3
+        LEARN_INFLIGHT=3,
+        LEARN_INFLIGHT_FIT=4
     };
 
     // return the chosen learning type
@@ -379,6 +381,8 @@ private:
     uint8_t _get_cal_mask();
     bool _start_calibration(uint8_t i, bool retry=false, float delay_sec=0.0f);
     bool _start_calibration_mask(uint8_t mask, bool retry=false, bool autosave=false, float delay_sec=0.0f, bool autoreboot=false);
+    bool _start_cal_thread();
+    void _update_inflight_fit();
     bool _auto_reboot() const { return _compass_cal_autoreboot; }
     Priority next_cal_progress_idx[MAVLINK_COMM_NUM_BUFFERS];
     Priority next_cal_report_idx[MAVLINK_COMM_NUM_BUFFERS];
@@ -396,6 +400,8 @@ private:
     //keep track of which calibrators have been saved
     RestrictIDTypeArray<bool, COMPASS_MAX_INSTANCES, Priority> _cal_saved;
     bool _cal_autosave;
+    // true while background calibrations for LEARN_INFLIGHT_FIT are running
+    bool _inflight_fit_running;
 #endif
 
     //autoreboot after compass calibration
@@ -516,9 +522,9 @@ private:
         // board specific orientation
         enum Rotation rotation;
 
-        // accumulated samples, protected by _sem, used by AP_Compass_Backend
-        Vector3f accum;
-        uint32_t accum_count;
+        // mean of the accumulated samples, written by the backend's
+        // bus thread and taken by drain_accumulated_samples()
+        SeqLockAccumulator<Vector3f> accum;
         // We only copy persistent params
         void copy_from(const mag_state& state);
     };
@@ -136,37 +136,25 @@ void AP_Compass_Backend::accumulate_sample(Vector3f &field, uint8_t instance,
         return;
     }
 
-    WITH_SEMAPHORE(_sem);
-
     Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
-    state.accum += field;
-    state.accum_count++;
-    if (max_samples && state.accum_count >= max_samples) {
-        state.accum_count /= 2;
-        state.accum /= 2;
-    }
+    state.accum.accumulate(field, max_samples);
 }
 
 void AP_Compass_Backend::drain_accumulated_samples(uint8_t instance,
                                                    const Vector3f *scaling)
 {
-    WITH_SEMAPHORE(_sem);
-
     Compass::mag_state &state = _compass._state[Compass::StateIndex(instance)];
 
-    if (state.accum_count == 0) {
+    Vector3f field;
+    if (!state.accum.consume(field)) {
         return;
     }
 
     if (scaling) {
-        state.accum *= *scaling;
+        field *= *scaling;
     }
-    state.accum /= state.accum_count;
-
-    publish_filtered_field(state.accum, instance);
 
-    state.accum.zero();
-    state.accum_count = 0;
+    publish_filtered_field(field, instance);
 }
 
 /*
@@ -124,9 +124,6 @@ protected:
     // access to frontend
     Compass &_compass;
 
-    // semaphore for access to shared frontend data
-    HAL_Semaphore _sem;
-
     // Check that the compass field is valid by using a mean filter on the vector length
     bool field_ok(const Vector3f &field);
     
@@ -3,6 +3,7 @@
 #include <AP_GPS/AP_GPS.h>
 #include <GCS_MAVLink/GCS.h>
 #include <AP_AHRS/AP_AHRS.h>
+#include <AP_Vehicle/AP_Vehicle.h>
 
 #include "AP_Compass.h"
 
@@ -12,6 +13,8 @@ const extern AP_HAL::HAL& hal;
 
 void Compass::cal_update()
 {
+    _update_inflight_fit();
+
     if (hal.util->get_soft_armed()) {
         return;
     }
@@ -19,7 +22,7 @@ void Compass::cal_update()
     bool running = false;
 
     for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
-        if (_calibrator[i] == nullptr) {
+        if (_calibrator[i] == nullptr || _calibrator[i]->background()) {
             continue;
         }
         if (_calibrator[i]->failed()) {
@@ -96,11 +99,9 @@ bool Compass::_start_calibration(uint8_t i, bool retry, float delay)
     }
     if (!_cal_thread_started) {
         _cal_requires_reboot = true;
-        if (!hal.scheduler->thread_create(FUNCTOR_BIND(this, &Compass::_update_calibration_trampoline, void), "compasscal", 2048, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
-            gcs().send_text(MAV_SEVERITY_CRITICAL, "CompassCalibrator: Cannot start compass thread.");
-            return false;
-        }
-        _cal_thread_started = true;
+    }
+    if (!_start_cal_thread()) {
+        return false;
     }
 
     // disable compass learning both for calibration and after completion
@@ -109,6 +110,81 @@ bool Compass::_start_calibration(uint8_t i, bool retry, float delay)
     return true;
 }
 
+// start the thread that runs the calibration fits, if not already running
+bool Compass::_start_cal_thread()
+{
+    if (_cal_thread_started) {
+        return true;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND(this, &Compass::_update_calibration_trampoline, void), "compasscal", 2048, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
+        gcs().send_text(MAV_SEVERITY_CRITICAL, "CompassCalibrator: Cannot start compass thread.");
+        return false;
+    }
+    _cal_thread_started = true;
+    return true;
+}
+
+/*
+  with COMPASS_LEARN=4 run a background calibration of each compass
+  used for yaw while flying. The samples are kept in the calibrator's
+  fixed size buffer, spread over the sphere, and the fit runs on the
+  calibration thread. Offsets from a successful fit are saved on
+  disarm. Soft iron corrections are left alone as in-flight coverage
+  of the sphere is rarely good enough to fit them
+ */
+void Compass::_update_inflight_fit()
+{
+    if (!_inflight_fit_running) {
+        const AP_Vehicle *vehicle = AP::vehicle();
+        if (get_learn_type() != LEARN_INFLIGHT_FIT || !hal.util->get_soft_armed() ||
+            vehicle == nullptr || vehicle->get_time_flying_ms() < 3000 || is_calibrating()) {
+            return;
+        }
+        for (uint8_t i=0; i<get_count(); i++) {
+            if (!healthy(i) || !use_for_yaw(i)) {
+                continue;
+            }
+            const Priority prio = Priority(i);
+            if (_calibrator[prio] == nullptr) {
+                _calibrator[prio] = new CompassCalibrator();
+                if (_calibrator[prio] == nullptr) {
+                    continue;
+                }
+            }
+            const enum Rotation r = _get_state(prio).external?(enum Rotation)_get_state(prio).orientation.get():ROTATION_NONE;
+            _calibrator[prio]->set_orientation(r, _get_state(prio).external, false);
+            _calibrator[prio]->set_background(true);
+            _calibrator[prio]->start(true, 0, get_offsets_max(), i, _calibration_threshold*2);
+            _inflight_fit_running = true;
+        }
+        if (_inflight_fit_running && !_start_cal_thread()) {
+            _inflight_fit_running = false;
+        }
+        return;
+    }
+
+    if (hal.util->get_soft_armed()) {
+        return;
+    }
+
+    // landed and disarmed, keep the offsets of any good fit
+    _inflight_fit_running = false;
+    for (uint8_t i=0; i<COMPASS_MAX_INSTANCES; i++) {
+        const Priority prio = Priority(i);
+        CompassCalibrator *cal = _calibrator[prio];
+        if (cal == nullptr || !cal->background()) {
+            continue;
+        }
+        const CompassCalibrator::Report cal_report = cal->get_report();
+        if (cal_report.status == CompassCalibrator::Status::SUCCESS) {
+            set_and_save_offsets(i, cal_report.ofs);
+            gcs().send_text(MAV_SEVERITY_INFO, "Compass %u: saved in-flight offsets", unsigned(i));
+        }
+        cal->stop();
+        cal->set_background(false);
+    }
+}
+
 void Compass::_update_calibration_trampoline() {
     while(true) {
         for (Priority i(0); i<COMPASS_MAX_INSTANCES; i++) {
@@ -239,7 +315,7 @@ bool Compass::send_mag_cal_progress(const GCS_MAVLINK& link)
         const Priority compass_id = (next_cal_progress_idx[chan] + 1) % COMPASS_MAX_INSTANCES;
         
         auto& calibrator = _calibrator[compass_id];
-        if (calibrator == nullptr) {
+        if (calibrator == nullptr || calibrator->background()) {
             next_cal_progress_idx[chan] = compass_id;
             continue;
         }
@@ -277,7 +353,7 @@ bool Compass::send_mag_cal_report(const GCS_MAVLINK& link)
     for (uint8_t i = 0; i < COMPASS_MAX_INSTANCES; i++) {
         const Priority compass_id = (next_cal_report_idx[chan] + 1) % COMPASS_MAX_INSTANCES;
 
-        if (_calibrator[compass_id] == nullptr) {
+        if (_calibrator[compass_id] == nullptr || _calibrator[compass_id]->background()) {
             next_cal_report_idx[chan] = compass_id;
             continue;
         }
@@ -321,6 +397,9 @@ bool Compass::is_calibrating()
         if (_calibrator[i] == nullptr) {
             continue;
         }
+        if (_calibrator[i]->background()) {
+            continue;
+        }
         switch(_calibrator[i]->get_state().status) {
             case CompassCalibrator::Status::NOT_STARTED:
             case CompassCalibrator::Status::SUCCESS:
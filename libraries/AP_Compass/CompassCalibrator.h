@@ -29,6 +29,10 @@ public:
     // failed is true if either of the failure states are hit
     bool failed();
 
+    // background calibrations run in flight and are not reported as the compass calibrating
+    void set_background(bool background) { _background = background; }
+    bool background() const { return _background; }
+
 
     // update the state machine and calculate offsets, diagonals and offdiagonals
     void update();
@@ -204,6 +208,7 @@ private:
     // values provided by caller
     float _delay_start_sec;                 // seconds to delay start of calibration (provided by caller)
     bool _retry;                            // true if calibration should be restarted on failured (provided by caller)
+    bool _background;                       // true if this is an in-flight background calibration
     float _tolerance = 5.0;                 // worst acceptable RMS tolerance (aka fitness).  see set_tolerance()
     uint16_t _offset_max;                   // maximum acceptable offsets (provided by caller)
 
@@ -6,6 +6,7 @@
 #include <AP_Vehicle/AP_Vehicle.h>
 #include <AP_OpticalFlow/AP_OpticalFlow.h>
 #include <AP_WheelEncoder/AP_WheelEncoder.h>
+#include <AP_Scheduler/AP_Scheduler.h>
 
 #if APM_BUILD_TYPE(APM_BUILD_Replay)
 #include <AP_NavEKF2/AP_NavEKF2.h>
@@ -46,10 +47,26 @@ void AP_DAL::start_frame(AP_DAL::FrameType frametype)
     end_frame();
 
     _RFRF.frame_types = uint8_t(frametype);
+    _RFRF.cpu_load = uint8_t(constrain_float(AP::scheduler().load_average() * 100, 0, 255));
     
-    _RFRH.time_flying_ms = AP::vehicle()->get_time_flying_ms();
-    _RFRH.time_us = AP_HAL::micros64();
-    WRITE_REPLAY_BLOCK(RFRH, _RFRH);
+    const uint32_t time_flying_ms = AP::vehicle()->get_time_flying_ms();
+    const uint64_t time_us = AP_HAL::micros64();
+    const uint64_t dt_us = time_us - _RFRH.time_us;
+    const uint32_t dt_flying_ms = time_flying_ms - _RFRH.time_flying_ms;
+    _RFRH.time_flying_ms = time_flying_ms;
+    _RFRH.time_us = time_us;
+    if (!force_write && _RFRH._end == 0 && dt_us <= UINT16_MAX && dt_flying_ms <= UINT16_MAX) {
+        // the last header was written, so replay can rebuild this
+        // one from the change
+        struct log_RFRD pkt {
+            dt_us : uint16_t(dt_us),
+            dt_flying_ms : uint16_t(dt_flying_ms),
+        };
+        WRITE_REPLAY_BLOCK(RFRD, pkt);
+        _RFRH._end = pkt._end;
+    } else {
+        WRITE_REPLAY_BLOCK(RFRH, _RFRH);
+    }
 
     // update RFRN data
     const log_RFRN old = _RFRN;
@@ -257,6 +274,21 @@ void *AP_DAL::malloc_type(size_t size, Memory_Type mem_type) const
     return hal.util->malloc_type(size, AP_HAL::Util::Memory_Type(mem_type));
 }
 
+void AP_DAL::free_type(void *ptr, size_t size, Memory_Type mem_type) const
+{
+    hal.util->free_type(ptr, size, AP_HAL::Util::Memory_Type(mem_type));
+}
+
+bool AP_DAL::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size) const
+{
+    return hal.scheduler->thread_create(proc, name, stack_size, AP_HAL::Scheduler::PRIORITY_MAIN, 0);
+}
+
+void AP_DAL::delay_microseconds(uint16_t us) const
+{
+    hal.scheduler->delay_microseconds(us);
+}
+
 
 const AP_DAL_Compass *AP_DAL::get_compass() const
 {
@@ -400,6 +432,7 @@ void AP_DAL::writeBodyFrameOdom(float quality, const Vector3f &delPos, const Vec
 void AP_DAL::handle_message(const log_RFRF &msg, NavEKF2 &ekf2, NavEKF3 &ekf3)
 {
     _RFRF.core_slow = msg.core_slow;
+    _RFRF.cpu_load = msg.cpu_load;
 
     /*
       note that we need to handle the case of LOG_REPLAY=1 with
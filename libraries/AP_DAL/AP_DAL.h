@@ -11,6 +11,8 @@
 
 #include "LogStructure.h"
 
+#include <AP_HAL/AP_HAL_Namespace.h>
+
 #include <stdio.h>
 #include <stdint.h>
 #include <cstddef>
@@ -94,6 +96,9 @@ public:
 
     // check if we are low on CPU for this core
     bool ekf_low_time_remaining(EKFType etype, uint8_t core);
+
+    // scheduler load average at the start of the current frame, in percent
+    uint8_t get_cpu_load_pct() const { return _RFRF.cpu_load; }
     
     // returns armed state for the current frame
     bool get_armed() const { return _RFRN.armed; }
@@ -121,6 +126,14 @@ public:
         MEM_FAST
     };
     void *malloc_type(size_t size, enum Memory_Type mem_type) const;
+    void free_type(void *ptr, size_t size, enum Memory_Type mem_type) const;
+
+    // create a thread for running EKF lanes. Returns false if the HAL
+    // does not support threads
+    bool thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size) const;
+
+    // delay used by EKF worker threads while waiting for work
+    void delay_microseconds(uint16_t us) const;
 
     AP_DAL_InertialSensor &ins() { return _ins; }
     AP_DAL_Baro &baro() { return _baro; }
@@ -228,6 +241,12 @@ public:
         _micros = _RFRH.time_us;
         _millis = _RFRH.time_us / 1000UL;
     }
+    void handle_message(const log_RFRD &msg) {
+        _RFRH.time_us += msg.dt_us;
+        _RFRH.time_flying_ms += msg.dt_flying_ms;
+        _micros = _RFRH.time_us;
+        _millis = _RFRH.time_us / 1000UL;
+    }
     void handle_message(const log_RFRN &msg) {
         _RFRN = msg;
         _home.lat = msg.lat;
@@ -242,6 +261,9 @@ public:
     void handle_message(const log_RISI &msg) {
         _ins.handle_message(msg);
     }
+    void handle_message(const log_RISJ &msg) {
+        _ins.handle_message(msg);
+    }
 
     void handle_message(const log_RASH &msg) {
         if (_airspeed == nullptr) {
@@ -326,6 +348,9 @@ public:
     // only write if the content has changed
     static void WriteLogMessage(enum LogMessages msg_type, void *msg, const void *old_msg, uint8_t msg_size);
 
+    // true if all messages are being written whether changed or not
+    static bool forcing_write(void) { return force_write; }
+
 private:
 
     static AP_DAL *_singleton;
@@ -43,13 +43,40 @@ void AP_DAL_InertialSensor::start_frame()
 
         update_filtered(i);
 
-        WRITE_REPLAY_BLOCK_IFCHANGED(RISI, RISI, old_RISI);
+        write_RISI(RISI, old_RISI);
 
         // update sensor position
         pos[i] = ins.get_imu_pos_offset(i);
     }
 }
 
+/*
+  write RISI if it has changed. When only the deltas have changed, as
+  they do on every frame, the smaller RISJ is written instead, as long
+  as the last RISI for this instance made it into the log
+ */
+void AP_DAL_InertialSensor::write_RISI(log_RISI &RISI, const log_RISI &old_RISI)
+{
+    log_RISI unchanged = RISI;
+    unchanged.delta_velocity = old_RISI.delta_velocity;
+    unchanged.delta_angle = old_RISI.delta_angle;
+    if (AP_DAL::forcing_write() || RISI._end != 0 ||
+        memcmp(&unchanged, &old_RISI, offsetof(log_RISI, _end)) != 0) {
+        WRITE_REPLAY_BLOCK_IFCHANGED(RISI, RISI, old_RISI);
+        return;
+    }
+    if (memcmp(&RISI, &old_RISI, offsetof(log_RISI, _end)) == 0) {
+        return;
+    }
+    struct log_RISJ pkt {
+        delta_velocity : RISI.delta_velocity,
+        delta_angle : RISI.delta_angle,
+        instance : RISI.instance,
+    };
+    WRITE_REPLAY_BLOCK(RISJ, pkt);
+    RISI._end = pkt._end;
+}
+
 // update filtered gyro and accel
 void AP_DAL_InertialSensor::update_filtered(uint8_t i)
 {
@@ -59,6 +59,12 @@ public:
         pos[msg.instance] = AP::ins().get_imu_pos_offset(msg.instance);
         update_filtered(msg.instance);
     }
+    void handle_message(const log_RISJ &msg) {
+        log_RISI &RISI = _RISI[msg.instance];
+        RISI.delta_velocity = msg.delta_velocity;
+        RISI.delta_angle = msg.delta_angle;
+        update_filtered(msg.instance);
+    }
 
 private:
     struct log_RISH _RISH;
@@ -74,4 +80,5 @@ private:
     uint8_t _primary_gyro;
 
     void update_filtered(uint8_t i);
+    void write_RISI(log_RISI &RISI, const log_RISI &old_RISI);
 };
@@ -8,6 +8,7 @@
 
 #define LOG_IDS_FROM_DAL \
     LOG_RFRH_MSG, \
+    LOG_RFRD_MSG, \
     LOG_RFRF_MSG, \
     LOG_REV2_MSG, \
     LOG_RSO2_MSG, \
@@ -19,6 +20,7 @@
     LOG_RFRN_MSG, \
     LOG_RISH_MSG, \
     LOG_RISI_MSG, \
+    LOG_RISJ_MSG, \
     LOG_RBRH_MSG, \
     LOG_RBRI_MSG, \
     LOG_RRNH_MSG, \
@@ -46,9 +48,18 @@ struct log_RFRH {
     uint8_t _end;
 };
 
+// frame header as a change from the last RFRH or RFRD, written in
+// place of RFRH when the changes are small
+struct log_RFRD {
+    uint16_t dt_us;
+    uint16_t dt_flying_ms;
+    uint8_t _end;
+};
+
 struct log_RFRF {
     uint8_t frame_types;
     uint8_t core_slow;
+    uint8_t cpu_load;
     uint8_t _end;
 };
 
@@ -97,6 +108,15 @@ struct log_RISI {
     uint8_t _end;
 };
 
+// Replay Data Structure - Inertial Sensor instance deltas, written in
+// place of RISI when nothing else has changed
+struct log_RISJ {
+    Vector3f delta_velocity;
+    Vector3f delta_angle;
+    uint8_t instance;
+    uint8_t _end;
+};
+
 // @LoggerMessage: REV2
 // @Description: Replay Event
 struct log_REV2 {
@@ -360,8 +380,10 @@ struct log_RBOH {
 #define LOG_STRUCTURE_FROM_DAL        \
     { LOG_RFRH_MSG, RLOG_SIZE(RFRH),                          \
       "RFRH", "QI", "TimeUS,TF", "s-", "F-" }, \
+    { LOG_RFRD_MSG, RLOG_SIZE(RFRD),                          \
+      "RFRD", "HH", "DT,DTF", "--", "--" }, \
     { LOG_RFRF_MSG, RLOG_SIZE(RFRF),                          \
-      "RFRF", "BB", "FTypes,Slow", "--", "--" }, \
+      "RFRF", "BBB", "FTypes,Slow,Load", "--%", "--0" }, \
     { LOG_RFRN_MSG, RLOG_SIZE(RFRN),                            \
       "RFRN", "IIIfIfffBBB", "HLat,HLon,HAlt,E2T,AM,TX,TY,TZ,VC,EKT,Flags", "DUm????????", "GGB--------" }, \
     { LOG_REV2_MSG, RLOG_SIZE(REV2),                                   \
@@ -382,6 +404,8 @@ struct log_RBOH {
       "RISH", "HBBfBB", "LR,PG,PA,LD,AC,GC", "------", "------" }, \
     { LOG_RISI_MSG, RLOG_SIZE(RISI),                                   \
       "RISI", "ffffffffBB", "DVX,DVY,DVZ,DAX,DAY,DAZ,DVDT,DADT,Flags,I", "---------#", "----------" }, \
+    { LOG_RISJ_MSG, RLOG_SIZE(RISJ),                                   \
+      "RISJ", "ffffffB", "DVX,DVY,DVZ,DAX,DAY,DAZ,I", "------#", "-------" }, \
     { LOG_RASH_MSG, RLOG_SIZE(RASH),                                   \
       "RASH", "BB", "Primary,NumInst", "--", "--" },  \
     { LOG_RASI_MSG, RLOG_SIZE(RASI),                                   \
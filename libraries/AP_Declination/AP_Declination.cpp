@@ -34,86 +34,71 @@
 */
 bool AP_Declination::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
 {
-    bool valid_input_data = true;
-
-    /* round down to nearest sampling resolution */
-    int32_t min_lat = static_cast<int32_t>(static_cast<int32_t>(latitude_deg / SAMPLING_RES) * SAMPLING_RES);
-    int32_t min_lon = static_cast<int32_t>(static_cast<int32_t>(longitude_deg / SAMPLING_RES) * SAMPLING_RES);
-
-    /* for the rare case of hitting the bounds exactly
-     * the rounding logic wouldn't fit, so enforce it.
-     */
-
-    /* limit to table bounds - required for maxima even when table spans full globe range */
-    if (latitude_deg <= SAMPLING_MIN_LAT) {
-        min_lat = static_cast<int32_t>(SAMPLING_MIN_LAT);
-        valid_input_data = false;
-    }
-
-    if (latitude_deg >= SAMPLING_MAX_LAT) {
-        min_lat = static_cast<int32_t>(static_cast<int32_t>(latitude_deg / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES);
-        valid_input_data = false;
-    }
-
-    if (longitude_deg <= SAMPLING_MIN_LON) {
-        min_lon = static_cast<int32_t>(SAMPLING_MIN_LON);
-        valid_input_data = false;
-    }
+    FieldCache cache;
+    return cache.get_mag_field_ef(latitude_deg, longitude_deg, intensity_gauss, declination_deg, inclination_deg);
+}
 
-    if (longitude_deg >= SAMPLING_MAX_LON) {
-        min_lon = static_cast<int32_t>(static_cast<int32_t>(longitude_deg / SAMPLING_RES) * SAMPLING_RES - SAMPLING_RES);
-        valid_input_data = false;
-    }
+/*
+  calculate magnetic field intensity and orientation, only reading the
+  tables when the position moves to a new cell
+*/
+bool AP_Declination::FieldCache::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+{
+    // positions on or outside the table bounds are extrapolated from the edge cells
+    const bool valid_input_data =
+        latitude_deg > SAMPLING_MIN_LAT && latitude_deg < SAMPLING_MAX_LAT &&
+        longitude_deg > SAMPLING_MIN_LON && longitude_deg < SAMPLING_MAX_LON;
 
     /* find index of nearest low sampling point */
-    uint32_t min_lat_index = static_cast<uint32_t>((-(SAMPLING_MIN_LAT) + min_lat)  / SAMPLING_RES);
-    uint32_t min_lon_index = static_cast<uint32_t>((-(SAMPLING_MIN_LON) + min_lon) / SAMPLING_RES);
-
-    /* calculate intensity */
-
-    float data_sw = intensity_table[min_lat_index][min_lon_index];
-    float data_se = intensity_table[min_lat_index][min_lon_index + 1];;
-    float data_ne = intensity_table[min_lat_index + 1][min_lon_index + 1];
-    float data_nw = intensity_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    float data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    float data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    intensity_gauss = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
-
-    /* calculate declination */
-
-    data_sw = declination_table[min_lat_index][min_lon_index];
-    data_se = declination_table[min_lat_index][min_lon_index + 1];;
-    data_ne = declination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = declination_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    declination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
-
-    /* calculate inclination */
-
-    data_sw = inclination_table[min_lat_index][min_lon_index];
-    data_se = inclination_table[min_lat_index][min_lon_index + 1];;
-    data_ne = inclination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = inclination_table[min_lat_index + 1][min_lon_index];
+    const int16_t new_lat_index = constrain_int16(int16_t(floorf((latitude_deg - SAMPLING_MIN_LAT) / SAMPLING_RES)),
+                                                  0, AP_DECLINATION_NUM_LAT - 2);
+    const int16_t new_lon_index = constrain_int16(int16_t(floorf((longitude_deg - SAMPLING_MIN_LON) / SAMPLING_RES)),
+                                                  0, AP_DECLINATION_NUM_LON - 2);
+    if (new_lat_index != lat_index || new_lon_index != lon_index) {
+        load_cell(new_lat_index, new_lon_index);
+    }
 
     /* perform bilinear interpolation on the four grid corners */
+    const float x = (longitude_deg - cell_lon) / SAMPLING_RES;
+    const float y = (latitude_deg - cell_lat) / SAMPLING_RES;
 
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    inclination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
+    intensity_gauss = intensity.get(x, y);
+    declination_deg = declination.get(x, y);
+    inclination_deg = inclination.get(x, y);
 
     return valid_input_data;
 }
 
+/*
+  setup the interpolation coefficients for the cell with the given south west corner
+*/
+void AP_Declination::FieldCache::load_cell(int16_t new_lat_index, int16_t new_lon_index)
+{
+    lat_index = new_lat_index;
+    lon_index = new_lon_index;
+    cell_lat = SAMPLING_MIN_LAT + lat_index * SAMPLING_RES;
+    cell_lon = SAMPLING_MIN_LON + lon_index * SAMPLING_RES;
+
+    const struct {
+        Interp &interp;
+        const float (&table)[AP_DECLINATION_NUM_LAT][AP_DECLINATION_NUM_LON];
+    } tables[] {
+        { intensity, intensity_table },
+        { declination, declination_table },
+        { inclination, inclination_table },
+    };
+    for (const auto &t : tables) {
+        const float data_sw = t.table[lat_index][lon_index];
+        const float data_se = t.table[lat_index][lon_index + 1];
+        const float data_ne = t.table[lat_index + 1][lon_index + 1];
+        const float data_nw = t.table[lat_index + 1][lon_index];
+        t.interp.c0 = data_sw;
+        t.interp.c_lon = data_se - data_sw;
+        t.interp.c_lat = data_nw - data_sw;
+        t.interp.c_cross = data_ne - data_nw - data_se + data_sw;
+    }
+}
+
 
 /*
  calculate magnetic field intensity and orientation
@@ -2,6 +2,8 @@
 
 #include <AP_Common/Location.h>
 
+#include "tables.h"
+
 /*
   magnetic data derived from WMM
  */
@@ -27,7 +29,36 @@ public:
       get declination in degrees for a given latitude_deg and longitude_deg
      */
     static float get_declination(float latitude_deg, float longitude_deg);
-    
+
+    /*
+      field lookup that keeps the interpolation coefficients of the
+      table cell containing the last position, so repeated lookups
+      while the position moves slowly only cost a few multiplies. Each
+      caller owns its cache, so no locking is needed
+     */
+    class FieldCache {
+    public:
+        // same as AP_Declination::get_mag_field_ef()
+        bool get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg);
+
+    private:
+        void load_cell(int16_t lat_index, int16_t lon_index);
+
+        // value = c0 + c_lon * x + c_lat * y + c_cross * x * y, for x and
+        // y the offset in the cell as a fraction of SAMPLING_RES
+        struct Interp {
+            float c0, c_lon, c_lat, c_cross;
+            float get(float x, float y) const {
+                return c0 + c_lon * x + (c_lat + c_cross * x) * y;
+            }
+        } intensity, declination, inclination;
+
+        float cell_lat;
+        float cell_lon;
+        int16_t lat_index = -1;
+        int16_t lon_index = -1;
+    };
+
 private:
     static const float SAMPLING_RES;
     static const float SAMPLING_MIN_LAT;
@@ -35,7 +66,7 @@ private:
     static const float SAMPLING_MIN_LON;
     static const float SAMPLING_MAX_LON;
 
-    static const float declination_table[19][37];
-    static const float inclination_table[19][37];
-    static const float intensity_table[19][37];
+    static const float declination_table[AP_DECLINATION_NUM_LAT][AP_DECLINATION_NUM_LON];
+    static const float inclination_table[AP_DECLINATION_NUM_LAT][AP_DECLINATION_NUM_LON];
+    static const float intensity_table[AP_DECLINATION_NUM_LAT][AP_DECLINATION_NUM_LON];
 };
@@ -15,6 +15,7 @@ parser = argparse.ArgumentParser(description='generate mag tables')
 parser.add_argument('--sampling-res', type=int, default=10, help='sampling resolution, degrees')
 parser.add_argument('--check-error', action='store_true', help='check max error')
 parser.add_argument('--filename', type=str, default='tables.cpp', help='tables file')
+parser.add_argument('--header', type=str, default='tables.h', help='table sizes header file')
 
 args = parser.parse_args()
 
@@ -24,8 +25,7 @@ if not Path("AP_Declination.h").is_file():
 
 def write_table(f,name, table):
     '''write one table'''
-    f.write("const float AP_Declination::%s[%u][%u] = {\n" %
-                (name, NUM_LAT, NUM_LON))
+    f.write("const float AP_Declination::%s[AP_DECLINATION_NUM_LAT][AP_DECLINATION_NUM_LON] = {\n" % name)
     for i in range(NUM_LAT):
         f.write("    {")
         for j in range(NUM_LON):
@@ -181,6 +181,16 @@ const float AP_Declination::SAMPLING_MAX_LON = %u;
     write_table(f,'inclination_table', inclination_table)
     write_table(f,'intensity_table', intensity_table)
 
+with open(args.header, 'w') as f:
+    f.write('''// this is an auto-generated file from the IGRF tables. Do not edit
+// To re-generate run generate/generate.py
+
+#pragma once
+
+#define AP_DECLINATION_NUM_LAT %u
+#define AP_DECLINATION_NUM_LON %u
+''' % (NUM_LAT, NUM_LON))
+
 if args.check_error:
     print("Checking for maximum error")
     for lat in range(-60,60,1):
@@ -189,4 +199,4 @@ if args.check_error:
     print("Generated with max error %.2f %s at (%.2f,%.2f)" % (
         max_error, max_error_field, max_error_pos[0], max_error_pos[1]))
 
-print("Table generated in %s" % args.filename)
+print("Table generated in %s and %s" % (args.filename, args.header))
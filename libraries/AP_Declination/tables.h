@@ -0,0 +1,7 @@
+// this is an auto-generated file from the IGRF tables. Do not edit
+// To re-generate run generate/generate.py
+
+#pragma once
+
+#define AP_DECLINATION_NUM_LAT 19
+#define AP_DECLINATION_NUM_LON 37
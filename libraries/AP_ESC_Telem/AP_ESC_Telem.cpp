@@ -97,12 +97,52 @@ uint8_t AP_ESC_Telem::get_num_active_escs() const {
     return nmotors;
 }
 
+/*
+  copy an ESC's rpm data. The writer makes the sequence odd while it
+  updates the entry, so retry if the sequence is odd or changed while
+  copying. Updates are short and infrequent so this rarely loops
+ */
+void AP_ESC_Telem::read_rpm_data(uint8_t esc_index, AP_ESC_Telem_Backend::RpmData &rpmdata) const
+{
+    const volatile AP_ESC_Telem_Backend::RpmData &src = _rpm_data[esc_index];
+    for (uint8_t tries = 0; tries < 4; tries++) {
+        const uint32_t seq = src.seq;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        rpmdata.rpm = src.rpm;
+        rpmdata.prev_rpm = src.prev_rpm;
+        rpmdata.error_rate = src.error_rate;
+        rpmdata.last_update_us = src.last_update_us;
+        rpmdata.update_rate_hz = src.update_rate_hz;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        rpmdata.seq = src.seq;
+        if ((seq & 1U) == 0 && seq == rpmdata.seq) {
+            return;
+        }
+    }
+    // the writer must have been preempted mid update, the copy may
+    // mix two updates but each field is valid
+}
+
+// get the number of rpm updates received for an ESC
+uint32_t AP_ESC_Telem::get_rpm_update_count(uint8_t esc_index) const
+{
+    if (esc_index >= ESC_TELEM_MAX_ESCS) {
+        return 0;
+    }
+    return _rpm_data[esc_index].seq >> 1;
+}
+
 // get an individual ESC's slewed rpm if available, returns true on success
 bool AP_ESC_Telem::get_rpm(uint8_t esc_index, float& rpm) const
 {
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    if (esc_index >= ESC_TELEM_MAX_ESCS) {
+        return false;
+    }
 
-    if (esc_index > ESC_TELEM_MAX_ESCS || is_zero(rpmdata.update_rate_hz)) {
+    AP_ESC_Telem_Backend::RpmData rpmdata;
+    read_rpm_data(esc_index, rpmdata);
+
+    if (is_zero(rpmdata.update_rate_hz)) {
         return false;
     }
 
@@ -119,11 +159,16 @@ bool AP_ESC_Telem::get_rpm(uint8_t esc_index, float& rpm) const
 // get an individual ESC's raw rpm if available, returns true on success
 bool AP_ESC_Telem::get_raw_rpm(uint8_t esc_index, float& rpm) const
 {
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    if (esc_index >= ESC_TELEM_MAX_ESCS) {
+        return false;
+    }
+
+    AP_ESC_Telem_Backend::RpmData rpmdata;
+    read_rpm_data(esc_index, rpmdata);
 
     const uint32_t now = AP_HAL::micros();
 
-    if (esc_index >= ESC_TELEM_MAX_ESCS || now < rpmdata.last_update_us
+    if (now < rpmdata.last_update_us
         || now - rpmdata.last_update_us > ESC_RPM_DATA_TIMEOUT_US) {
         return false;
     }
@@ -317,7 +362,7 @@ void AP_ESC_Telem::update_telem_data(const uint8_t esc_index, const AP_ESC_Telem
 // this should be called by backends when new telemetry values are available
 void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const uint16_t new_rpm, const float error_rate)
 {
-    if (esc_index > ESC_TELEM_MAX_ESCS) {
+    if (esc_index >= ESC_TELEM_MAX_ESCS) {
         return;
     }
 
@@ -326,6 +371,10 @@ void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const uint16_t new_rpm, c
     const uint32_t now = AP_HAL::micros();
     volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
 
+    // mark the entry as being updated, see read_rpm_data()
+    rpmdata.seq++;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
     rpmdata.prev_rpm = rpmdata.rpm;
     rpmdata.rpm = new_rpm;
     if (now > rpmdata.last_update_us) { // cope with wrapping
@@ -334,6 +383,9 @@ void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const uint16_t new_rpm, c
     rpmdata.last_update_us = now;
     rpmdata.error_rate = error_rate;
 
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    rpmdata.seq++;
+
 #ifdef ESC_TELEM_DEBUG
     hal.console->printf("RPM: rate=%.1fhz, rpm=%d)\n", rpmdata.update_rate_hz, new_rpm);
 #endif
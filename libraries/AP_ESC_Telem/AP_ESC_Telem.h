@@ -27,6 +27,11 @@ public:
     // get an individual ESC's raw rpm if available
     bool get_raw_rpm(uint8_t esc_index, float& rpm) const;
 
+    // get the number of rpm updates received for an ESC. This changes
+    // whenever new rpm data arrives, so a consumer can tell if there
+    // is anything new without comparing values
+    uint32_t get_rpm_update_count(uint8_t esc_index) const;
+
     // get an individual ESC's temperature in centi-degrees if available, returns true on success
     bool get_temperature(uint8_t esc_index, int16_t& temp) const;
 
@@ -78,7 +83,12 @@ private:
     // callback to update the data in the frontend, should be called by the driver when new data is available
     void update_telem_data(const uint8_t esc_index, const AP_ESC_Telem_Backend::TelemetryData& new_data, const uint16_t data_mask);
 
-    // rpm data
+    // get a consistent copy of an ESC's rpm data without locking
+    void read_rpm_data(uint8_t esc_index, AP_ESC_Telem_Backend::RpmData &rpmdata) const;
+
+    // rpm data, written at the source by the backends. Each entry is
+    // guarded by its sequence counter so readers in other threads
+    // never see a partial update
     volatile AP_ESC_Telem_Backend::RpmData _rpm_data[ESC_TELEM_MAX_ESCS];
     // telemetry data
     volatile AP_ESC_Telem_Backend::TelemetryData _telem_data[ESC_TELEM_MAX_ESCS];
@@ -31,6 +31,7 @@ public:
         float    error_rate;        // error rate in percent
         uint32_t last_update_us;    // last update time, determines whether active
         float    update_rate_hz;
+        uint32_t seq;               // odd while an update is being written, incremented twice per update
     };
 
     enum TelemetryType {
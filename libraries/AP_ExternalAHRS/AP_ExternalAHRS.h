@@ -130,6 +130,7 @@ public:
         Vector3f accel;
         Vector3f gyro;
         float temperature;
+        uint64_t sample_us;     // time of the sample, 0 if not known
     } ins_data_message_t;
     
 private:
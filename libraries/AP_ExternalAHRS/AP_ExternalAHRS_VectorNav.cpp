@@ -114,12 +114,11 @@ AP_ExternalAHRS_VectorNav::AP_ExternalAHRS_VectorNav(AP_ExternalAHRS *_frontend,
     baudrate = sm.find_baudrate(AP_SerialManager::SerialProtocol_AHRS, 0);
     port_num = sm.find_portnum(AP_SerialManager::SerialProtocol_AHRS, 0);
 
-    bufsize = MAX(VN_PKT1_LENGTH, VN_PKT2_LENGTH);
+    // room for a few packets, so a burst is parsed without a read each
+    bufsize = 4 * MAX(VN_PKT1_LENGTH, VN_PKT2_LENGTH);
     pktbuf = new uint8_t[bufsize];
-    last_pkt1 = new VN_packet1;
-    last_pkt2 = new VN_packet2;
 
-    if (!pktbuf || !last_pkt1 || !last_pkt2) {
+    if (!pktbuf) {
         AP_HAL::panic("Failed to allocate ExternalAHRS");
     }
 
@@ -130,7 +129,9 @@ AP_ExternalAHRS_VectorNav::AP_ExternalAHRS_VectorNav(AP_ExternalAHRS *_frontend,
 }
 
 /*
-  check the UART for more data
+  check the UART for more data. Every complete packet read is parsed
+  in place in the buffer, and only a partial packet left at the end is
+  moved back to the start.
   returns true if the function should be called again straight away
  */
 bool AP_ExternalAHRS_VectorNav::check_uart()
@@ -138,7 +139,6 @@ bool AP_ExternalAHRS_VectorNav::check_uart()
     if (!port_opened) {
         return false;
     }
-    WITH_SEMAPHORE(state.sem);
 
     uint32_t n = uart->available();
     if (n == 0) {
@@ -152,49 +152,47 @@ bool AP_ExternalAHRS_VectorNav::check_uart()
         pktoffset += nread;
     }
 
-    bool match_header1, match_header2;
-
-    if (pktbuf[0] != 0xFA) {
-        goto reset;
-    }
-
-    match_header1 = (0 == memcmp(&pktbuf[1], vn_pkt1_header, MIN(sizeof(vn_pkt1_header), unsigned(pktoffset-1))));
-    match_header2 = (0 == memcmp(&pktbuf[1], vn_pkt2_header, MIN(sizeof(vn_pkt2_header), unsigned(pktoffset-1))));
-    if (!match_header1 && !match_header2) {
-        goto reset;
-    }
-
-    if (match_header1 && pktoffset >= VN_PKT1_LENGTH) {
-        uint16_t crc = crc16_ccitt(&pktbuf[1], VN_PKT1_LENGTH-1, 0);
-        if (crc == 0) {
-            // got pkt1
-            process_packet1(&pktbuf[sizeof(vn_pkt1_header)+1]);
-            memmove(&pktbuf[0], &pktbuf[VN_PKT1_LENGTH], pktoffset-VN_PKT1_LENGTH);
-            pktoffset -= VN_PKT1_LENGTH;
-        } else {
-            goto reset;
+    uint16_t start = 0;
+    while (start < pktoffset) {
+        const uint8_t *p = &pktbuf[start];
+        const uint16_t len = pktoffset - start;
+        bool resync = (p[0] != 0xFA);
+        bool match_header1 = false;
+        if (!resync) {
+            match_header1 = (0 == memcmp(&p[1], vn_pkt1_header, MIN(sizeof(vn_pkt1_header), unsigned(len-1))));
+            const bool match_header2 = (0 == memcmp(&p[1], vn_pkt2_header, MIN(sizeof(vn_pkt2_header), unsigned(len-1))));
+            resync = !match_header1 && !match_header2;
         }
-    } else if (match_header2 && pktoffset >= VN_PKT2_LENGTH) {
-        uint16_t crc = crc16_ccitt(&pktbuf[1], VN_PKT2_LENGTH-1, 0);
-        if (crc == 0) {
-            // got pkt2
-            process_packet2(&pktbuf[sizeof(vn_pkt2_header)+1]);
-            memmove(&pktbuf[0], &pktbuf[VN_PKT2_LENGTH], pktoffset-VN_PKT2_LENGTH);
-            pktoffset -= VN_PKT2_LENGTH;
-        } else {
-            goto reset;
+        if (!resync) {
+            const uint16_t pkt_len = match_header1 ? VN_PKT1_LENGTH : VN_PKT2_LENGTH;
+            if (len < pkt_len) {
+                // wait for the rest of the packet
+                break;
+            }
+            if (crc16_ccitt(&p[1], pkt_len-1, 0) == 0) {
+                if (match_header1) {
+                    // the start of the packet is len bytes back from
+                    // the end of the data we have just read
+                    uint64_t rx_us = uart->receive_time_constraint_us(len);
+                    if (rx_us == 0) {
+                        rx_us = AP_HAL::micros64();
+                    }
+                    process_packet1(&p[sizeof(vn_pkt1_header)+1], rx_us);
+                } else {
+                    process_packet2(&p[sizeof(vn_pkt2_header)+1]);
+                }
+                start += pkt_len;
+                continue;
+            }
         }
+        // not a packet, skip to the next possible start
+        const uint8_t *next = (const uint8_t *)memchr(&p[1], 0xFA, len-1);
+        start = next ? (next - pktbuf) : pktoffset;
     }
-    return true;
 
-reset:
-    uint8_t *p = (uint8_t *)memchr(&pktbuf[1], (char)0xFA, pktoffset-1);
-    if (p) {
-        uint8_t newlen = pktoffset - (p - pktbuf);
-        memmove(&pktbuf[0], p, newlen);
-        pktoffset = newlen;
-    } else {
-        pktoffset = 0;
+    if (start > 0) {
+        memmove(&pktbuf[0], &pktbuf[start], pktoffset-start);
+        pktoffset -= start;
     }
     return true;
 }
@@ -206,11 +204,16 @@ void AP_ExternalAHRS_VectorNav::update_thread()
         port_opened = true;
         uart->begin(baudrate, 1024, 512);
         send_config();
+        have_rx_event = uart->set_event_handle(&rx_event);
     }
 
     while (true) {
         if (!check_uart()) {
-            hal.scheduler->delay(1);
+            if (have_rx_event) {
+                rx_event.wait(10000);
+            } else {
+                hal.scheduler->delay(1);
+            }
         }
     }
 }
@@ -218,13 +221,13 @@ void AP_ExternalAHRS_VectorNav::update_thread()
 /*
   process packet type 1
  */
-void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
+void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b, uint64_t rx_us)
 {
-    const struct VN_packet1 &pkt1 = *(struct VN_packet1 *)b;
-    const struct VN_packet2 &pkt2 = *last_pkt2;
+    const struct VN_packet1 &pkt1 = *(const struct VN_packet1 *)b;
 
     last_pkt1_ms = AP_HAL::millis();
-    *last_pkt1 = pkt1;
+    last_posU = pkt1.posU;
+    last_velU = pkt1.velU;
 
     {
         WITH_SEMAPHORE(state.sem);
@@ -248,7 +251,7 @@ void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
         AP_ExternalAHRS::baro_data_message_t baro;
         baro.instance = 0;
         baro.pressure_pa = pkt1.pressure*1e3;
-        baro.temperature = pkt2.temp;
+        baro.temperature = last_temp;
 
         AP::baro().handle_external(baro);
     }
@@ -266,7 +269,10 @@ void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
 
         ins.accel = state.accel;
         ins.gyro = state.gyro;
-        ins.temperature = pkt2.temp;
+        ins.temperature = last_temp;
+        // time the VN took the sample, so the INS integrates with the
+        // sensor's sample spacing rather than our read jitter
+        ins.sample_us = imu_jitter.correct_offboard_timestamp_usec(pkt1.timeStartup / 1000U, rx_us);
 
         AP::ins().handle_external(ins);
     }
@@ -307,11 +313,12 @@ void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
  */
 void AP_ExternalAHRS_VectorNav::process_packet2(const uint8_t *b)
 {
-    const struct VN_packet2 &pkt2 = *(struct VN_packet2 *)b;
-    const struct VN_packet1 &pkt1 = *last_pkt1;
+    const struct VN_packet2 &pkt2 = *(const struct VN_packet2 *)b;
 
     last_pkt2_ms = AP_HAL::millis();
-    *last_pkt2 = pkt2;
+    last_temp = pkt2.temp;
+    last_gps1_fix = pkt2.GPS1Fix;
+    last_gps2_fix = pkt2.GPS2Fix;
 
     AP_ExternalAHRS::gps_data_message_t gps;
 
@@ -321,9 +328,9 @@ void AP_ExternalAHRS_VectorNav::process_packet2(const uint8_t *b)
     gps.fix_type = pkt2.GPS1Fix;
     gps.satellites_in_view = pkt2.numGPS1Sats;
 
-    gps.horizontal_pos_accuracy = pkt1.posU;
-    gps.vertical_pos_accuracy = pkt1.posU;
-    gps.horizontal_vel_accuracy = pkt1.velU;
+    gps.horizontal_pos_accuracy = last_posU;
+    gps.vertical_pos_accuracy = last_posU;
+    gps.horizontal_vel_accuracy = last_velU;
 
     gps.hdop = pkt2.GPS1DOP[4];
     gps.vdop = pkt2.GPS1DOP[3];
@@ -375,11 +382,11 @@ bool AP_ExternalAHRS_VectorNav::pre_arm_check(char *failure_msg, uint8_t failure
         hal.util->snprintf(failure_msg, failure_msg_len, "VectorNav unhealthy");
         return false;
     }
-    if (last_pkt2->GPS1Fix < 3) {
+    if (last_gps1_fix < 3) {
         hal.util->snprintf(failure_msg, failure_msg_len, "VectorNav no GPS1 lock");
         return false;
     }
-    if (last_pkt2->GPS2Fix < 3) {
+    if (last_gps2_fix < 3) {
         hal.util->snprintf(failure_msg, failure_msg_len, "VectorNav no GPS2 lock");
         return false;
     }
@@ -393,16 +400,15 @@ bool AP_ExternalAHRS_VectorNav::pre_arm_check(char *failure_msg, uint8_t failure
 void AP_ExternalAHRS_VectorNav::get_filter_status(nav_filter_status &status) const
 {
     memset(&status, 0, sizeof(status));
-    if (last_pkt1 && last_pkt2) {
+    if (initialised()) {
         status.flags.initalized = 1;
     }
-    if (healthy() && last_pkt2) {
+    if (healthy()) {
         status.flags.attitude = 1;
         status.flags.vert_vel = 1;
         status.flags.vert_pos = 1;
 
-        const struct VN_packet2 &pkt2 = *last_pkt2;
-        if (pkt2.GPS1Fix >= 3) {
+        if (last_gps1_fix >= 3) {
             status.flags.horiz_vel = 1;
             status.flags.horiz_pos_rel = 1;
             status.flags.horiz_pos_abs = 1;
@@ -416,7 +422,7 @@ void AP_ExternalAHRS_VectorNav::get_filter_status(nav_filter_status &status) con
 // send an EKF_STATUS message to GCS
 void AP_ExternalAHRS_VectorNav::send_status_report(mavlink_channel_t chan) const
 {
-    if (!last_pkt1) {
+    if (last_pkt1_ms == 0) {
         return;
     }
     // prepare flags
@@ -458,13 +464,12 @@ void AP_ExternalAHRS_VectorNav::send_status_report(mavlink_channel_t chan) const
     }
 
     // send message
-    const struct VN_packet1 &pkt1 = *(struct VN_packet1 *)last_pkt1;
     const float vel_gate = 5;
     const float pos_gate = 5;
     const float hgt_gate = 5;
     const float mag_var = 0;
     mavlink_msg_ekf_status_report_send(chan, flags,
-                                       pkt1.velU/vel_gate, pkt1.posU/pos_gate, pkt1.posU/hgt_gate,
+                                       last_velU/vel_gate, last_posU/pos_gate, last_posU/hgt_gate,
                                        mag_var, 0, 0);
 }
 
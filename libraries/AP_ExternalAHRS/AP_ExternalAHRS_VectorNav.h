@@ -23,6 +23,7 @@
 #if HAL_EXTERNAL_AHRS_ENABLED
 
 #include <GCS_MAVLink/GCS_MAVLink.h>
+#include <AP_RTC/JitterCorrection.h>
 
 class AP_ExternalAHRS_VectorNav : public AP_ExternalAHRS_backend {
 
@@ -39,10 +40,8 @@ public:
     void get_filter_status(nav_filter_status &status) const override;
     void send_status_report(mavlink_channel_t chan) const override;
 
-    // check for new data
-    void update() override {
-        check_uart();
-    }
+    // new data is handled in our own thread as it arrives
+    void update() override {}
 
 private:
     AP_HAL::UARTDriver *uart;
@@ -54,7 +53,7 @@ private:
     void update_thread();
     bool check_uart();
 
-    void process_packet1(const uint8_t *b);
+    void process_packet1(const uint8_t *b, uint64_t rx_us);
     void process_packet2(const uint8_t *b);
     void send_config(void) const;
 
@@ -62,11 +61,21 @@ private:
     uint16_t pktoffset;
     uint16_t bufsize;
 
-    struct VN_packet1 *last_pkt1;
-    struct VN_packet2 *last_pkt2;
+    // woken when the UART has data, if the HAL supports it
+    HAL_EventHandle rx_event;
+    bool have_rx_event;
 
+    // VN startup time to local time of the IMU samples
+    JitterCorrection imu_jitter{20};
+
+    // fields of the last packets needed when handling the other
     uint32_t last_pkt1_ms;
     uint32_t last_pkt2_ms;
+    float last_posU;
+    float last_velU;
+    float last_temp;
+    uint8_t last_gps1_fix;
+    uint8_t last_gps2_fix;
 };
 
 #endif  // HAL_EXTERNAL_AHRS_ENABLED
@@ -225,6 +225,15 @@ bool AP_Filesystem::set_mtime(const char *filename, const uint32_t mtime_sec)
     return backend.fs.set_mtime(filename, mtime_sec);
 }
 
+/*
+  ask for space for a new file to be allocated contiguously
+ */
+bool AP_Filesystem::preallocate(int fd, uint32_t size)
+{
+    const Backend &backend = backend_by_fd(fd);
+    return backend.fs.preallocate(fd, size);
+}
+
 // if filesystem is not running then try a remount
 bool AP_Filesystem::retry_mount(void)
 {
@@ -237,6 +246,12 @@ void AP_Filesystem::unmount(void)
     return LOCAL_BACKEND.fs.unmount();
 }
 
+// report IO cache statistics of the local filesystem
+void AP_Filesystem::cache_info(ExpandingString &str)
+{
+    LOCAL_BACKEND.fs.cache_info(str);
+}
+
 /*
   load a file to memory as a single chunk. Use only for small files
  */
@@ -83,12 +83,19 @@ public:
     // set modification time on a file
     bool set_mtime(const char *filename, const uint32_t mtime_sec);
 
+    // ask for the next size bytes written to an empty file to be
+    // placed contiguously. Returns false if not supported
+    bool preallocate(int fd, uint32_t size);
+
     // if filesystem is not running then try a remount. Return true if fs is mounted
     bool retry_mount(void);
 
     // unmount filesystem for reboot
     void unmount(void);
 
+    // report IO cache statistics of the local filesystem
+    void cache_info(ExpandingString &str);
+
     /*
       load a full file. Use delete to free the data
      */
@@ -6,6 +6,7 @@
 #include <AP_Math/AP_Math.h>
 #include <stdio.h>
 #include <AP_RTC/AP_RTC.h>
+#include <AP_Common/ExpandingString.h>
 
 #if HAVE_FILESYSTEM_SUPPORT && CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
 
@@ -34,9 +35,55 @@ static bool remount_needed;
 // mkdir() inside sdcard_retry()
 static HAL_Semaphore sem;
 
+/*
+  per file IO cache. Files opened read only get read-ahead, so small
+  sequential reads (FTP downloads, terrain) are served from memory and
+  the card sees aligned multi-sector reads. Files opened write only
+  get write-behind: small writes are collected and written out in
+  aligned blocks, and pending data goes to FatFs on fsync(), lseek()
+  and close()
+ */
+#ifndef FATFS_CACHE_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define FATFS_CACHE_SIZE MAX_IO_SIZE
+#else
+#define FATFS_CACHE_SIZE 0
+#endif
+#endif
+
+// number of open files that can have a cache at once
+#ifndef FATFS_CACHE_MAX_FILES
+#define FATFS_CACHE_MAX_FILES 4
+#endif
+
+static_assert((FATFS_CACHE_SIZE % FF_MAX_SS) == 0 && (FATFS_CACHE_SIZE & (FATFS_CACHE_SIZE-1)) == 0,
+              "FATFS_CACHE_SIZE must be a power of two multiple of the sector size");
+static_assert(FATFS_CACHE_SIZE <= MAX_IO_SIZE, "FATFS_CACHE_SIZE too large");
+
+typedef struct {
+    uint8_t *buf;
+    FSIZE_t ofs;        // file offset of buf[0]
+    FSIZE_t pos;        // read position seen by the caller
+    uint32_t len;       // bytes valid for reads, bytes pending for writes
+    bool write;
+} FAT_CACHE;
+
+static struct {
+    uint8_t in_use;
+    uint32_t no_cache;          // opens that could not get a cache
+    uint32_t read_fills;
+    uint32_t write_flushes;
+    uint64_t read_hit_bytes;    // bytes read from the cache
+    uint64_t read_fill_bytes;   // bytes read from the card into the cache
+    uint64_t read_direct_bytes; // bytes read from the card bypassing the cache
+    uint64_t write_cached_bytes;
+    uint64_t write_direct_bytes;
+} cache_stats;
+
 typedef struct {
     FIL *fh;
     char *name;
+    FAT_CACHE *cache;
 } FAT_FILE;
 
 #define MAX_FILES 16
@@ -132,6 +179,13 @@ static int free_file_descriptor(int fileno)
         free(fh);
     }
 
+    if (stream->cache != NULL) {
+        free(stream->cache->buf);
+        free(stream->cache);
+        stream->cache = NULL;
+        cache_stats.in_use--;
+    }
+
     free(stream->name);
     stream->name = NULL;
 
@@ -277,6 +331,229 @@ static bool remount_file_system(void)
     return true;
 }
 
+/*
+  read from the card in MAX_IO_SIZE pieces
+ */
+static int32_t fatfs_read(FIL *fh, void *buf, UINT bytes)
+{
+    UINT total = 0;
+    do {
+        UINT size = 0;
+        UINT n = MIN(bytes, MAX_IO_SIZE);
+        FRESULT res = f_read(fh, (void *)buf, n, &size);
+        if (res != FR_OK) {
+            errno = fatfs_to_errno(res);
+            return -1;
+        }
+        if (size == 0) {
+            break;
+        }
+        if (size > n) {
+            errno = EIO;
+            return -1;
+        }
+        total += size;
+        buf = (void *)(((uint8_t *)buf)+size);
+        bytes -= size;
+        if (size < n) {
+            break;
+        }
+    } while (bytes > 0);
+    return (int32_t)total;
+}
+
+/*
+  write to the card in MAX_IO_SIZE pieces, with one remount and retry
+  on a disk error
+ */
+static int32_t fatfs_write(FIL *fh, const void *buf, UINT bytes)
+{
+    UINT total = 0;
+    do {
+        UINT n = MIN(bytes, MAX_IO_SIZE);
+        UINT size = 0;
+        FRESULT res = f_write(fh, buf, n, &size);
+        if (res == FR_DISK_ERR && RETRY_ALLOWED()) {
+            // one retry on disk error
+            hal.scheduler->delay(100);
+            if (remount_file_system()) {
+                res = f_write(fh, buf, n, &size);
+            }
+        }
+        if (size > n || size == 0) {
+            errno = EIO;
+            return -1;
+        }
+        if (res != FR_OK || size > n) {
+            errno = fatfs_to_errno(res);
+            return -1;
+        }
+        total += size;
+        buf = (void *)(((uint8_t *)buf)+size);
+        bytes -= size;
+        if (size < n) {
+            break;
+        }
+    } while (bytes > 0);
+    return (int32_t)total;
+}
+
+/*
+  allocate a cache for a newly opened file. Files opened for both
+  reading and writing are not cached
+ */
+static FAT_CACHE *cache_alloc(FIL *fh, int flags)
+{
+    const int mode = flags & O_ACCMODE;
+    if (FATFS_CACHE_SIZE == 0 || mode == O_RDWR) {
+        return nullptr;
+    }
+    if (cache_stats.in_use >= FATFS_CACHE_MAX_FILES) {
+        cache_stats.no_cache++;
+        return nullptr;
+    }
+    FAT_CACHE *c = (FAT_CACHE *)calloc(sizeof(FAT_CACHE), 1);
+    if (c == nullptr) {
+        cache_stats.no_cache++;
+        return nullptr;
+    }
+    c->buf = (uint8_t *)malloc(FATFS_CACHE_SIZE);
+    if (c->buf == nullptr) {
+        free(c);
+        cache_stats.no_cache++;
+        return nullptr;
+    }
+    c->write = (mode == O_WRONLY);
+    c->ofs = fh->fptr;
+    c->pos = fh->fptr;
+    cache_stats.in_use++;
+    return c;
+}
+
+/*
+  write out any pending data in a write-behind cache
+ */
+static int cache_flush(FIL *fh, FAT_CACHE *c)
+{
+    if (c == nullptr || !c->write || c->len == 0) {
+        return 0;
+    }
+    const UINT len = c->len;
+    c->len = 0;
+    const int32_t ret = fatfs_write(fh, c->buf, len);
+    if (ret < 0) {
+        return -1;
+    }
+    cache_stats.write_flushes++;
+    if (UINT(ret) != len) {
+        // card is full
+        errno = ENOSPC;
+        return -1;
+    }
+    return 0;
+}
+
+/*
+  read through a read-ahead cache. On a miss the aligned block holding
+  the read position is loaded, reads of at least a block go straight
+  to the caller's buffer
+ */
+static int32_t cache_read(FIL *fh, FAT_CACHE *c, uint8_t *buf, UINT bytes)
+{
+    UINT total = 0;
+    while (bytes > 0) {
+        if (c->pos >= c->ofs && c->pos < c->ofs + c->len) {
+            const UINT n = MIN(bytes, UINT(c->ofs + c->len - c->pos));
+            memcpy(buf, &c->buf[c->pos - c->ofs], n);
+            c->pos += n;
+            buf += n;
+            bytes -= n;
+            total += n;
+            cache_stats.read_hit_bytes += n;
+            continue;
+        }
+        const FSIZE_t ofs = (bytes >= FATFS_CACHE_SIZE) ? c->pos : (c->pos & ~FSIZE_t(FATFS_CACHE_SIZE-1));
+        if (fh->fptr != ofs) {
+            FRESULT res = f_lseek(fh, ofs);
+            if (res != FR_OK) {
+                errno = fatfs_to_errno(res);
+                return -1;
+            }
+        }
+        if (bytes >= FATFS_CACHE_SIZE) {
+            const int32_t ret = fatfs_read(fh, buf, bytes);
+            if (ret < 0) {
+                return -1;
+            }
+            c->pos += ret;
+            total += ret;
+            cache_stats.read_direct_bytes += ret;
+            break;
+        }
+        c->ofs = ofs;
+        c->len = 0;
+        UINT size = 0;
+        FRESULT res = f_read(fh, c->buf, FATFS_CACHE_SIZE, &size);
+        if (res != FR_OK) {
+            errno = fatfs_to_errno(res);
+            return -1;
+        }
+        if (size > FATFS_CACHE_SIZE) {
+            errno = EIO;
+            return -1;
+        }
+        c->len = size;
+        cache_stats.read_fills++;
+        cache_stats.read_fill_bytes += size;
+        if (c->pos >= c->ofs + c->len) {
+            // end of file
+            break;
+        }
+    }
+    return (int32_t)total;
+}
+
+/*
+  write through a write-behind cache. Data is collected up to the next
+  block boundary in the file, whole aligned blocks go straight to the
+  card
+ */
+static int32_t cache_write(FIL *fh, FAT_CACHE *c, const uint8_t *buf, UINT bytes)
+{
+    const UINT count = bytes;
+    while (bytes > 0) {
+        if (c->len == 0) {
+            c->ofs = fh->fptr;
+            if ((c->ofs & (FATFS_CACHE_SIZE-1)) == 0 && bytes >= FATFS_CACHE_SIZE) {
+                const UINT n = bytes & ~UINT(FATFS_CACHE_SIZE-1);
+                const int32_t ret = fatfs_write(fh, buf, n);
+                if (ret < 0) {
+                    return -1;
+                }
+                cache_stats.write_direct_bytes += ret;
+                if (UINT(ret) < n) {
+                    // card is full
+                    return (int32_t)(count - bytes + ret);
+                }
+                buf += n;
+                bytes -= n;
+                continue;
+            }
+        }
+        const UINT room = FATFS_CACHE_SIZE - ((c->ofs + c->len) & (FATFS_CACHE_SIZE-1));
+        const UINT n = MIN(bytes, room);
+        memcpy(&c->buf[c->len], buf, n);
+        c->len += n;
+        buf += n;
+        bytes -= n;
+        cache_stats.write_cached_bytes += n;
+        if (n == room && cache_flush(fh, c) != 0) {
+            return -1;
+        }
+    }
+    return (int32_t)count;
+}
+
 int AP_Filesystem_FATFS::open(const char *pathname, int flags)
 {
     int fileno;
@@ -349,6 +626,8 @@ int AP_Filesystem_FATFS::open(const char *pathname, int flags)
         }
     }
 
+    stream->cache = cache_alloc(fh, flags);
+
     debug("Open %s -> %d", pathname, fileno);
 
     return fileno;
@@ -376,19 +655,23 @@ int AP_Filesystem_FATFS::close(int fileno)
     if (fh == NULL) {
         return -1;
     }
+    const int flush_ret = cache_flush(fh, stream->cache);
+    const int flush_errno = errno;
     res = f_close(fh);
     free_file_descriptor(fileno);
     if (res != FR_OK) {
         errno = fatfs_to_errno((FRESULT)res);
         return -1;
     }
+    if (flush_ret != 0) {
+        errno = flush_errno;
+        return -1;
+    }
     return 0;
 }
 
 int32_t AP_Filesystem_FATFS::read(int fd, void *buf, uint32_t count)
 {
-    UINT bytes = count;
-    int res;
     FIL *fh;
 
     FS_CHECK_ALLOWED(-1);
@@ -409,36 +692,18 @@ int32_t AP_Filesystem_FATFS::read(int fd, void *buf, uint32_t count)
         return -1;
     }
 
-    UINT total = 0;
-    do {
-        UINT size = 0;
-        UINT n = MIN(bytes, MAX_IO_SIZE);
-        res = f_read(fh, (void *)buf, n, &size);
-        if (res != FR_OK) {
-            errno = fatfs_to_errno((FRESULT)res);
-            return -1;
-        }
-        if (size == 0) {
-            break;
-        }
-        if (size > n) {
-            errno = EIO;
-            return -1;
-        }
-        total += size;
-        buf = (void *)(((uint8_t *)buf)+size);
-        bytes -= size;
-        if (size < n) {
-            break;
-        }
-    } while (bytes > 0);
-    return (ssize_t)total;
+    FAT_CACHE *c = file_table[fd]->cache;
+    if (c != nullptr && !c->write) {
+        return cache_read(fh, c, (uint8_t *)buf, count);
+    }
+    if (cache_flush(fh, c) != 0) {
+        return -1;
+    }
+    return fatfs_read(fh, buf, count);
 }
 
 int32_t AP_Filesystem_FATFS::write(int fd, const void *buf, uint32_t count)
 {
-    UINT bytes = count;
-    FRESULT res;
     FIL *fh;
     errno = 0;
 
@@ -454,34 +719,11 @@ int32_t AP_Filesystem_FATFS::write(int fd, const void *buf, uint32_t count)
         return -1;
     }
 
-    UINT total = 0;
-    do {
-        UINT n = MIN(bytes, MAX_IO_SIZE);
-        UINT size = 0;
-        res = f_write(fh, buf, n, &size);
-        if (res == FR_DISK_ERR && RETRY_ALLOWED()) {
-            // one retry on disk error
-            hal.scheduler->delay(100);
-            if (remount_file_system()) {
-                res = f_write(fh, buf, n, &size);
-            }
-        }
-        if (size > n || size == 0) {
-            errno = EIO;
-            return -1;
-        }
-        if (res != FR_OK || size > n) {
-            errno = fatfs_to_errno(res);
-            return -1;
-        }
-        total += size;
-        buf = (void *)(((uint8_t *)buf)+size);
-        bytes -= size;
-        if (size < n) {
-            break;
-        }
-    } while (bytes > 0);
-    return (ssize_t)total;
+    FAT_CACHE *c = file_table[fd]->cache;
+    if (c != nullptr && c->write) {
+        return cache_write(fh, c, (const uint8_t *)buf, count);
+    }
+    return fatfs_write(fh, buf, count);
 }
 
 int AP_Filesystem_FATFS::fsync(int fileno)
@@ -506,6 +748,9 @@ int AP_Filesystem_FATFS::fsync(int fileno)
     if (fh == NULL) {
         return -1;
     }
+    if (cache_flush(fh, stream->cache) != 0) {
+        return -1;
+    }
     res = f_sync(fh);
     if (res != FR_OK) {
         errno = fatfs_to_errno((FRESULT)res);
@@ -533,6 +778,26 @@ off_t AP_Filesystem_FATFS::lseek(int fileno, off_t position, int whence)
         return -1;
     }
 
+    FAT_CACHE *c = file_table[fileno]->cache;
+    if (c != nullptr && !c->write) {
+        // only move the read position, the cache seeks when it needs
+        // to read from the card
+        if (whence == SEEK_END) {
+            position += f_size(fh);
+        } else if (whence == SEEK_CUR) {
+            position += c->pos;
+        }
+        if (position < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        c->pos = MIN(FSIZE_t(position), f_size(fh));
+        return c->pos;
+    }
+    if (cache_flush(fh, c) != 0) {
+        return -1;
+    }
+
     if (whence == SEEK_END) {
         position += f_size(fh);
     } else if (whence==SEEK_CUR) {
@@ -832,6 +1097,36 @@ bool AP_Filesystem_FATFS::set_mtime(const char *filename, const uint32_t mtime_s
     return f_utime(filename, (FILINFO *)&fno) == FR_OK;
 }
 
+/*
+  find a contiguous free area for an empty file and make it where the
+  next cluster allocations come from (f_expand "prepare to allocate").
+  Writes then don't have to search the FAT for free clusters. The file
+  size is not changed, so there is nothing to truncate on close and a
+  crash leaves a file of the size actually written
+*/
+bool AP_Filesystem_FATFS::preallocate(int fd, uint32_t size)
+{
+    FS_CHECK_ALLOWED(false);
+    WITH_SEMAPHORE(sem);
+
+    FIL *fh = fileno_to_fatfs(fd);
+    if (fh == nullptr) {
+        return false;
+    }
+    const FAT_CACHE *c = file_table[fd]->cache;
+    if (size == 0 || f_size(fh) != 0 || (c != nullptr && c->write && c->len != 0)) {
+        // only empty files can be preallocated
+        errno = EINVAL;
+        return false;
+    }
+    const FRESULT res = f_expand(fh, size, 0);
+    if (res != FR_OK) {
+        errno = fatfs_to_errno(res);
+        return false;
+    }
+    return true;
+}
+
 /*
   retry mount of filesystem if needed
 */
@@ -842,6 +1137,27 @@ bool AP_Filesystem_FATFS::retry_mount(void)
     return sdcard_retry();
 }
 
+/*
+  report read-ahead and write-behind cache statistics
+*/
+void AP_Filesystem_FATFS::cache_info(ExpandingString &str)
+{
+    WITH_SEMAPHORE(sem);
+    str.printf("FATFS cache: size=%u files=%u/%u nocache=%u\n",
+               unsigned(FATFS_CACHE_SIZE),
+               unsigned(cache_stats.in_use), unsigned(FATFS_CACHE_MAX_FILES),
+               unsigned(cache_stats.no_cache));
+    str.printf("read: hit=%ukB fill=%ukB fills=%u direct=%ukB\n",
+               unsigned(cache_stats.read_hit_bytes / 1024),
+               unsigned(cache_stats.read_fill_bytes / 1024),
+               unsigned(cache_stats.read_fills),
+               unsigned(cache_stats.read_direct_bytes / 1024));
+    str.printf("write: cached=%ukB flushes=%u direct=%ukB\n",
+               unsigned(cache_stats.write_cached_bytes / 1024),
+               unsigned(cache_stats.write_flushes),
+               unsigned(cache_stats.write_direct_bytes / 1024));
+}
+
 /*
   unmount filesystem for reboot
 */
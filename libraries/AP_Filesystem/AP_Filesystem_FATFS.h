@@ -49,9 +49,15 @@ public:
     // set modification time on a file
     bool set_mtime(const char *filename, const uint32_t mtime_sec) override;
 
+    // ask for a contiguous area for the next size bytes of an empty file
+    bool preallocate(int fd, uint32_t size) override;
+
     // retry mount of filesystem if needed
     bool retry_mount(void) override;
 
     // unmount filesystem for reboot
     void unmount(void) override;
+
+    // report read-ahead and write-behind cache statistics
+    void cache_info(ExpandingString &str) override;
 };
@@ -19,6 +19,7 @@
 #include "AP_Filesystem_Param.h"
 #include <AP_Param/AP_Param.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
 #include <ctype.h>
 
 #define PACKED_NAME "param.pck"
@@ -56,6 +57,10 @@ int AP_Filesystem_Param::open(const char *fname, int flags)
     r.start = 0;
     r.count = 0;
     r.writebuf = nullptr;
+    r.read_size = 0;
+    r.file_size = 0;
+    r.with_crc = false;
+    r.block_size = 0;
     if (!read_only) {
         // setup for upload
         r.writebuf = new ExpandingString();
@@ -67,8 +72,11 @@ int AP_Filesystem_Param::open(const char *fname, int flags)
     }
 
     /*
-      allow for URI style arguments param.pck?start=N&count=C
+      allow for URI style arguments param.pck?start=N&count=C or
+      param.pck?since=CRC
      */
+    bool since = false;
+    uint32_t since_crc = 0;
     const char *c = strchr(fname, '?');
     while (c && *c) {
         c++;
@@ -92,12 +100,29 @@ int AP_Filesystem_Param::open(const char *fname, int flags)
             c = strchr(c, '&');
             continue;
         }
+        if (strncmp(c, "since=", 6) == 0) {
+            since_crc = strtoul(c+6, nullptr, 0);
+            since = true;
+            c += 6;
+            c = strchr(c, '&');
+            continue;
+        }
+    }
+
+    if (since) {
+        if (!read_only || r.start != 0 || r.count != 0) {
+            goto failed;
+        }
+        setup_since(r, since_crc);
     }
 
     return idx;
 
 failed:
     delete [] r.cursors;
+    r.cursors = nullptr;
+    delete r.writebuf;
+    r.writebuf = nullptr;
     r.open = false;
     errno = EINVAL;
     return -1;
@@ -142,6 +167,9 @@ int AP_Filesystem_Param::close(int fd)
     Any leading zero bytes after the header should be discarded as pad
     bytes. Pad bytes are used to ensure that a parameter data[] field
     does not cross a read packet boundary
+
+    For a since= request the magic is 0x671c and the header is
+    followed by a uint32_t crc of all the parameters
  */
 
 /*
@@ -156,14 +184,19 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
 
     if (c.token_ofs == 0) {
         c.idx = 0;
+        c.param_idx = 0;
         ap = AP_Param::first(&c.token, &ptype);
-        uint16_t idx = 0;
-        while (idx < r.start && ap) {
+        while (c.param_idx < r.start && ap) {
             ap = AP_Param::next_scalar(&c.token, &ptype);
-            idx++;
+            c.param_idx++;
         }
     } else {
         c.idx++;
+        c.param_idx++;
+        ap = AP_Param::next_scalar(&c.token, &ptype);
+    }
+    while (ap != nullptr && !param_wanted(r, c.param_idx)) {
+        c.param_idx++;
         ap = AP_Param::next_scalar(&c.token, &ptype);
     }
     if (ap == nullptr || (r.count && c.idx >= r.count)) {
@@ -190,7 +223,7 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
       won't get a corrupt value for a parameter
      */
     if (type_len > 1) {
-        const uint32_t ofs = c.token_ofs + sizeof(struct header) + packed_len;
+        const uint32_t ofs = c.token_ofs + header_len(r) + packed_len;
         const uint32_t ofs_mod = ofs % r.read_size;
         if (ofs_mod > 0 && ofs_mod < type_len) {
             const uint8_t pad = type_len - ofs_mod;
@@ -287,7 +320,8 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         }
     }
 
-    if (r.file_ofs < sizeof(struct header)) {
+    const uint8_t hlen = header_len(r);
+    if (r.file_ofs < hlen) {
         struct header hdr;
         hdr.total_params = AP_Param::count_parameters();
         if (hdr.total_params <= r.start) {
@@ -298,8 +332,14 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         if (r.count > 0 && hdr.num_params > r.count) {
             hdr.num_params = r.count;
         }
-        uint8_t n = MIN(sizeof(hdr) - r.file_ofs, count);
-        const uint8_t *b = (const uint8_t *)&hdr;
+        uint8_t b[sizeof(hdr)+sizeof(r.crc)];
+        if (r.with_crc) {
+            hdr.magic = pmagic_crc;
+            hdr.num_params = r.num_params;
+            memcpy(&b[sizeof(hdr)], &r.crc, sizeof(r.crc));
+        }
+        memcpy(b, &hdr, sizeof(hdr));
+        uint8_t n = MIN(hlen - r.file_ofs, count);
         memcpy(buf, &b[r.file_ofs], n);
         count -= n;
         header_total += n;
@@ -310,7 +350,7 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         }
     }
 
-    uint32_t data_ofs = r.file_ofs - sizeof(struct header);
+    uint32_t data_ofs = r.file_ofs - hlen;
     uint8_t best_i = 0;
     uint32_t best_ofs = r.cursors[0].token_ofs;
     size_t total = 0;
@@ -410,6 +450,101 @@ int AP_Filesystem_Param::stat(const char *name, struct stat *stbuf)
     return 0;
 }
 
+/*
+  length of the file header
+ */
+uint8_t AP_Filesystem_Param::header_len(const struct rfile &r) const
+{
+    return r.with_crc ? sizeof(struct header) + sizeof(r.crc) : sizeof(struct header);
+}
+
+/*
+  return true if the parameter at param_idx should be sent
+ */
+bool AP_Filesystem_Param::param_wanted(const struct rfile &r, uint16_t param_idx) const
+{
+    if (r.block_size == 0) {
+        return true;
+    }
+    const uint16_t block = param_idx / r.block_size;
+    return block < max_crc_blocks && (r.block_mask & (1ULL<<block)) != 0;
+}
+
+/*
+  split the parameters into blocks and return the crc of each block
+  and of the whole set
+ */
+uint32_t AP_Filesystem_Param::calc_crcs(uint16_t &total_params, uint16_t &block_size, uint32_t block_crc[max_crc_blocks]) const
+{
+    total_params = AP_Param::count_parameters();
+    block_size = MAX((total_params + max_crc_blocks - 1) / max_crc_blocks, 1);
+    memset(block_crc, 0, max_crc_blocks*sizeof(uint32_t));
+
+    AP_Param::ParamToken token;
+    enum ap_var_type ptype;
+    uint16_t idx = 0;
+    for (AP_Param *ap = AP_Param::first(&token, &ptype);
+         ap != nullptr && idx < total_params;
+         ap = AP_Param::next_scalar(&token, &ptype), idx++) {
+        char name[AP_MAX_NAME_SIZE+1];
+        name[AP_MAX_NAME_SIZE] = 0;
+        ap->copy_name_token(token, name, AP_MAX_NAME_SIZE, true);
+        const uint8_t type = ptype;
+        uint32_t &crc = block_crc[idx / block_size];
+        crc = crc_crc32(crc, &type, 1);
+        crc = crc_crc32(crc, (const uint8_t *)name, strlen(name));
+        crc = crc_crc32(crc, (const uint8_t *)ap, AP_Param::type_size(ptype));
+    }
+
+    uint32_t crc = crc_crc32(0, (const uint8_t *)&total_params, sizeof(total_params));
+    return crc_crc32(crc, (const uint8_t *)block_crc, max_crc_blocks*sizeof(uint32_t));
+}
+
+/*
+  setup a since= request. If since_crc is the crc of the current
+  parameters nothing is sent. If it is the crc of the set sent in the
+  last since= request only the blocks that changed since then are sent,
+  otherwise all parameters are
+ */
+void AP_Filesystem_Param::setup_since(struct rfile &r, uint32_t since_crc)
+{
+    uint16_t total_params, block_size;
+    uint32_t block_crc[max_crc_blocks];
+    r.crc = calc_crcs(total_params, block_size, block_crc);
+    r.with_crc = true;
+    r.num_params = total_params;
+    r.block_size = 0;
+
+    if (since_crc == r.crc) {
+        r.block_size = block_size;
+        r.block_mask = 0;
+        r.num_params = 0;
+    } else if (last_crcs != nullptr &&
+               last_crcs->crc == since_crc &&
+               last_crcs->total_params == total_params) {
+        r.block_size = block_size;
+        r.block_mask = 0;
+        r.num_params = 0;
+        for (uint8_t i=0; i<max_crc_blocks; i++) {
+            if (block_crc[i] != last_crcs->block_crc[i]) {
+                r.block_mask |= 1ULL<<i;
+                const uint16_t block_start = i * block_size;
+                r.num_params += MIN(block_size, total_params - block_start);
+            }
+        }
+    }
+
+    // the client will now have the current parameters
+    if (last_crcs == nullptr) {
+        last_crcs = new crc_state;
+    }
+    if (last_crcs != nullptr) {
+        last_crcs->crc = r.crc;
+        last_crcs->total_params = total_params;
+        memcpy(last_crcs->block_crc, block_crc, sizeof(block_crc));
+    }
+}
+
 /*
   check for the right file name
  */
@@ -44,6 +44,12 @@ private:
 
     static constexpr uint16_t pmagic = 0x671b;
 
+    // magic for a since= request, the header is followed by a uint32_t crc
+    static constexpr uint16_t pmagic_crc = 0x671c;
+
+    // the parameters are split into this many blocks for since= requests
+    static constexpr uint8_t max_crc_blocks = 64;
+
     // header at front of the file
     struct header {
         uint16_t magic = pmagic;
@@ -58,6 +64,7 @@ private:
         uint8_t trailer_len;
         uint8_t trailer[max_pack_len];
         uint16_t idx;
+        uint16_t param_idx;
     };
 
     struct rfile {
@@ -69,11 +76,30 @@ private:
         uint32_t file_size;
         struct cursor *cursors;
         ExpandingString *writebuf; // for upload
+
+        // for since= requests
+        bool with_crc;
+        uint16_t num_params;
+        uint16_t block_size;       // zero to send all blocks
+        uint64_t block_mask;
+        uint32_t crc;
     } file[max_open_file];
 
+    // block crcs of the parameters as last sent for a since= request
+    struct crc_state {
+        uint32_t crc;
+        uint16_t total_params;
+        uint32_t block_crc[max_crc_blocks];
+    };
+    struct crc_state *last_crcs;
+
     bool token_seek(const struct rfile &r, const uint32_t data_ofs, struct cursor &c);
     uint8_t pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf);
     bool check_file_name(const char *fname);
+    uint8_t header_len(const struct rfile &r) const;
+    bool param_wanted(const struct rfile &r, uint16_t param_idx) const;
+    uint32_t calc_crcs(uint16_t &total_params, uint16_t &block_size, uint32_t block_crc[max_crc_blocks]) const;
+    void setup_since(struct rfile &r, uint32_t since_crc);
 
     // finish uploading parameters
     bool finish_upload(const rfile &r);
@@ -31,7 +31,7 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags)
     }
     uint8_t idx;
     for (idx=0; idx<max_open_file; idx++) {
-        if (file[idx].data == nullptr) {
+        if (!file[idx].is_open()) {
             break;
         }
     }
@@ -39,43 +39,34 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags)
         errno = ENFILE;
         return -1;
     }
-    if (file[idx].data != nullptr) {
-        errno = EBUSY;
-        return -1;
-    }
-    file[idx].data = AP_ROMFS::find_decompress(fname, file[idx].size);
-    if (file[idx].data == nullptr) {
+    if (!file[idx].open(fname)) {
         errno = ENOENT;
         return -1;
     }
-    file[idx].ofs = 0;
     return idx;
 }
 
 int AP_Filesystem_ROMFS::close(int fd)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (fd < 0 || fd >= max_open_file || !file[fd].is_open()) {
         errno = EBADF;
         return -1;
     }
-    AP_ROMFS::free(file[fd].data);
-    file[fd].data = nullptr;
+    file[fd].close();
     return 0;
 }
 
 int32_t AP_Filesystem_ROMFS::read(int fd, void *buf, uint32_t count)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (fd < 0 || fd >= max_open_file || !file[fd].is_open()) {
         errno = EBADF;
         return -1;
     }
-    count = MIN(file[fd].size - file[fd].ofs, count);
-    if (count == 0) {
-        return 0;
+    const int32_t n = file[fd].read((uint8_t *)buf, count);
+    if (n < 0) {
+        errno = EIO;
     }
-    memcpy(buf, &file[fd].data[file[fd].ofs], count);
-    file[fd].ofs += count;
-    return count;
+    return n;
 }
 
 int32_t AP_Filesystem_ROMFS::write(int fd, const void *buf, uint32_t count)
@@ -91,37 +82,47 @@ int AP_Filesystem_ROMFS::fsync(int fd)
 
 int32_t AP_Filesystem_ROMFS::lseek(int fd, int32_t offset, int seek_from)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (fd < 0 || fd >= max_open_file || !file[fd].is_open()) {
         errno = EBADF;
         return -1;
     }
+    AP_ROMFS::Stream &f = file[fd];
+    uint32_t target = f.get_offset();
     switch (seek_from) {
     case SEEK_SET:
         if (offset < 0) {
             errno = EINVAL;
             return -1;
         }
-        file[fd].ofs = MIN(file[fd].size, (uint32_t)offset);
+        target = MIN(f.get_size(), (uint32_t)offset);
         break;
     case SEEK_CUR:
-        file[fd].ofs = MIN(file[fd].size, offset+file[fd].ofs);
+        target = MIN(f.get_size(), offset+f.get_offset());
         break;
     case SEEK_END:
-        file[fd].ofs = file[fd].size;
+        target = f.get_size();
         break;
     }
-    return file[fd].ofs;
+    // the data is only decompressed going forwards, so seeking back
+    // means starting again from the beginning
+    if (target < f.get_offset() && !f.rewind()) {
+        errno = EIO;
+        return -1;
+    }
+    if (!f.skip(target - f.get_offset())) {
+        errno = EIO;
+        return -1;
+    }
+    return f.get_offset();
 }
 
 int AP_Filesystem_ROMFS::stat(const char *name, struct stat *stbuf)
 {
     uint32_t size;
-    const uint8_t *data = AP_ROMFS::find_decompress(name, size);
-    if (data == nullptr) {
+    if (!AP_ROMFS::find_size(name, size)) {
         errno = ENOENT;
         return -1;
     }
-    AP_ROMFS::free(data);
     memset(stbuf, 0, sizeof(*stbuf));
     stbuf->st_size = size;
     return 0;
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "AP_Filesystem_backend.h"
+#include <AP_ROMFS/AP_ROMFS.h>
 
 class AP_Filesystem_ROMFS : public AP_Filesystem_Backend
 {
@@ -55,11 +56,8 @@ private:
     // only allow up to 4 files at a time
     static constexpr uint8_t max_open_file = 4;
     static constexpr uint8_t max_open_dir = 4;
-    struct rfile {
-        const uint8_t *data;
-        uint32_t size;
-        uint32_t ofs;
-    } file[max_open_file];
+    // files are decompressed as they are read
+    AP_ROMFS::Stream file[max_open_file];
 
     // allow up to 4 directory opens
     struct rdir {
@@ -23,6 +23,9 @@
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Common/ExpandingString.h>
+#include <AP_Common/MemoryArena.h>
+#include <AP_Common/MemoryTag.h>
+#include <AP_Scripting/AP_Scripting.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -33,9 +36,19 @@ struct SysFileList {
 static const SysFileList sysfs_file_list[] = {
     {"threads.txt"},
     {"tasks.txt"},
+    {"task_hist.txt"},
+    {"buses.txt"},
     {"dma.txt"},
     {"memory.txt"},
+    {"arena.txt"},
+    {"memtags.txt"},
     {"uarts.txt"},
+    {"profile.txt"},
+    {"storage.txt"},
+    {"fscache.txt"},
+#ifdef ENABLE_SCRIPTING
+    {"scripts.txt"},
+#endif
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     {"can_log.txt"},
     {"can0_stats.txt"},
@@ -94,6 +107,12 @@ int AP_Filesystem_Sys::open(const char *fname, int flags)
     if (strcmp(fname, "tasks.txt") == 0) {
         AP::scheduler().task_info(*r.str);
     }
+    if (strcmp(fname, "task_hist.txt") == 0) {
+        AP::scheduler().task_hist_info(*r.str);
+    }
+    if (strcmp(fname, "buses.txt") == 0) {
+        AP::scheduler().bus_info(*r.str);
+    }
 #endif
     if (strcmp(fname, "dma.txt") == 0) {
         hal.util->dma_info(*r.str);
@@ -101,9 +120,29 @@ int AP_Filesystem_Sys::open(const char *fname, int flags)
     if (strcmp(fname, "memory.txt") == 0) {
         hal.util->mem_info(*r.str);
     }
+    if (strcmp(fname, "arena.txt") == 0) {
+        MemoryArena::info(*r.str);
+    }
+    if (strcmp(fname, "memtags.txt") == 0) {
+        MemoryTags::info(*r.str);
+    }
     if (strcmp(fname, "uarts.txt") == 0) {
         hal.util->uart_info(*r.str);
     }
+    if (strcmp(fname, "profile.txt") == 0) {
+        hal.util->profile_info(*r.str);
+    }
+    if (strcmp(fname, "storage.txt") == 0) {
+        hal.storage->storage_info(*r.str);
+    }
+    if (strcmp(fname, "fscache.txt") == 0) {
+        AP::FS().cache_info(*r.str);
+    }
+#ifdef ENABLE_SCRIPTING
+    if (strcmp(fname, "scripts.txt") == 0 && AP::scripting() != nullptr) {
+        AP::scripting()->stats_info(*r.str);
+    }
+#endif
 #if HAL_CANMANAGER_ENABLED
     int8_t can_stats_num = -1;
     if (strcmp(fname, "can_log.txt") == 0) {
@@ -37,6 +37,8 @@ private:
     const void *backend;
 };
 
+class ExpandingString;
+
 class AP_Filesystem_Backend {
 
 public:
@@ -65,12 +67,19 @@ public:
     // set modification time on a file
     virtual bool set_mtime(const char *filename, const uint32_t mtime_sec) { return false; }
 
+    // ask for the next size bytes written to an empty file to be
+    // placed contiguously
+    virtual bool preallocate(int fd, uint32_t size) { return false; }
+
     // retry mount of filesystem if needed
     virtual bool retry_mount(void) { return true; }
 
     // unmount filesystem for reboot
     virtual void unmount(void) {}
 
+    // report IO cache statistics
+    virtual void cache_info(ExpandingString &str) {}
+
     /*
       load a full file. Use delete to free the data
      */
@@ -173,6 +173,36 @@ bool AP_FlashStorage::protected_switch_full_sector(void)
     return switch_sectors();
 }
 
+/*
+  erase the full sector ahead of time. The space reserved in the
+  current sector when we switched to it is enough for a full write out
+  of mem_buffer, after which nothing in the full sector is needed
+ */
+bool AP_FlashStorage::erase_full_sector(void)
+{
+    if (!have_full_sector()) {
+        return true;
+    }
+    if (write_error || !flash_erase_ok()) {
+        return false;
+    }
+    if (flash_sector_size - write_offset < reserved_space) {
+        // we have eaten into the reserved space, leave it for the
+        // next switch_full_sector()
+        return false;
+    }
+
+    debug("erasing full sector %u\n", current_sector ^ 1);
+
+    reserved_space = 0;
+    if (!write_all()) {
+        // the full sector is still needed
+        reserved_space = reserve_size;
+        return false;
+    }
+    return erase_sector(current_sector ^ 1, true);
+}
+
 // write some data to virtual EEPROM
 bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 {
@@ -196,6 +226,7 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
                 if (!flash_erase_ok()) {
                     return false;
                 }
+                stats.stalls++;
                 if (!switch_full_sector()) {
                     return false;                    
                 }
@@ -240,6 +271,8 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 #endif
 
         write_offset += sizeof(blk.header) + block_nbytes;
+        stats.writes++;
+        stats.bytes += block_nbytes;
 
         uint8_t n2 = block_nbytes - (offset % block_size);
         //debug("write_block at %u for %u n2=%u\n", block_ofs, block_nbytes, n2);
@@ -327,6 +360,7 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
  */
 bool AP_FlashStorage::erase_sector(uint8_t sector, bool mark_available)
 {
+    stats.erases++;
     if (!flash_erase(sector)) {
         return false;
     }
@@ -19,8 +19,10 @@
   backend for any HAL. The basic methodology is to use a log based
   storage system over two flash sectors. Key design elements:
 
-  - erase of sectors only called on init, as erase will lock the flash
-    and prevent code execution
+  - erase of sectors only called on init or when the caller says
+    erasing is allowed, as erase will lock the flash and prevent code
+    execution. The caller can erase the full sector ahead of time with
+    erase_full_sector() so that a sector switch never needs an erase
 
   - write using log based system
 
@@ -98,7 +100,8 @@ public:
     // caller provided function to read from a flash sector. Only called on init()
     FUNCTOR_TYPEDEF(FlashRead, bool, uint8_t , uint32_t , uint8_t *, uint16_t );
     
-    // caller provided function to erase a flash sector. Only called from init()
+    // caller provided function to erase a flash sector. Only called
+    // from init(), or when erasing is allowed by FlashEraseOK
     FUNCTOR_TYPEDEF(FlashErase, bool, uint8_t );
 
     // caller provided function to indicate if erasing is allowed
@@ -127,11 +130,29 @@ public:
     // offline for considerable periods as an erase will be needed
     bool switch_full_sector(void) WARN_IF_UNUSED;
 
+    // true if the other sector is full, so the next sector switch
+    // will need an erase
+    bool have_full_sector(void) const { return reserved_space != 0; }
+
+    // copy all live data into the current sector and erase the full
+    // sector so that the next sector switch can happen without an
+    // erase. Should only be called when safe to have CPU offline
+    bool erase_full_sector(void) WARN_IF_UNUSED;
+
     // write some data to storage from mem_buffer
     bool write(uint16_t offset, uint16_t length) WARN_IF_UNUSED;
 
     // fixed storage size
     static const uint16_t storage_size = HAL_STORAGE_SIZE;
+
+    // flash activity counters since boot
+    struct Stats {
+        uint32_t writes;        // log records written
+        uint32_t bytes;         // storage bytes written, excluding headers
+        uint32_t erases;        // sector erases
+        uint32_t stalls;        // sector erases forced by a write, which stop the CPU
+    };
+    const Stats &get_stats(void) const { return stats; }
     
 private:
     uint8_t *mem_buffer;
@@ -145,6 +166,7 @@ private:
     uint32_t write_offset;
     uint32_t reserved_space;
     bool write_error;
+    Stats stats;
 
     // 24 bit signature
 #if AP_FLASHSTORAGE_TYPE == AP_FLASHSTORAGE_TYPE_F4
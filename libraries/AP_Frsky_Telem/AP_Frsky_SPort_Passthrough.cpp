@@ -558,19 +558,14 @@ uint32_t AP_Frsky_SPort_Passthrough::calc_ap_status(void)
 uint32_t AP_Frsky_SPort_Passthrough::calc_home(void)
 {
     uint32_t home = 0;
-    Location loc;
-    Location home_loc;
-    bool got_position = false;
     float _relative_home_altitude = 0;
 
-    {
-        AP_AHRS &_ahrs = AP::ahrs();
-        WITH_SEMAPHORE(_ahrs.get_semaphore());
-        got_position = _ahrs.get_position(loc);
-        home_loc = _ahrs.get_home();
-    }
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
+    const Location &loc = nav.loc;
+    const Location &home_loc = nav.home;
 
-    if (got_position) {
+    if (nav.have_position) {
         // check home_loc is valid
         if (home_loc.lat != 0 || home_loc.lng != 0) {
             // distance between vehicle and home_loc in meters
@@ -599,17 +594,17 @@ uint32_t AP_Frsky_SPort_Passthrough::calc_velandyaw(void)
     float vspd = get_vspeed_ms();
     // vertical velocity in dm/s
     uint32_t velandyaw = prep_number(roundf(vspd * 10), 2, 1);
-    AP_AHRS &_ahrs = AP::ahrs();
-    WITH_SEMAPHORE(_ahrs.get_semaphore());
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
     // horizontal velocity in dm/s (use airspeed if available and enabled - even if not used - otherwise use groundspeed)
     const AP_Airspeed *aspeed = AP::airspeed();
     if (aspeed && aspeed->enabled()) {
         velandyaw |= prep_number(roundf(aspeed->get_airspeed() * 10), 2, 1)<<VELANDYAW_XYVEL_OFFSET;
     } else { // otherwise send groundspeed estimate from ahrs
-        velandyaw |= prep_number(roundf(_ahrs.groundspeed() * 10), 2, 1)<<VELANDYAW_XYVEL_OFFSET;
+        velandyaw |= prep_number(roundf(nav.groundspeed * 10), 2, 1)<<VELANDYAW_XYVEL_OFFSET;
     }
     // yaw from [0;36000] centidegrees to .2 degree increments [0;1800] (just in case, limit to 2047 (0x7FF) since the value is stored on 11 bits)
-    velandyaw |= ((uint16_t)roundf(_ahrs.yaw_sensor * 0.05f) & VELANDYAW_YAW_LIMIT)<<VELANDYAW_YAW_OFFSET;
+    velandyaw |= ((uint16_t)roundf(nav.yaw_sensor * 0.05f) & VELANDYAW_YAW_LIMIT)<<VELANDYAW_YAW_OFFSET;
     return velandyaw;
 }
 
@@ -300,7 +300,7 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
     // @Param: _DRV_OPTIONS
     // @DisplayName: driver options
     // @Description: Additional backend specific options
-    // @Bitmask: 0:Use UART2 for moving baseline on ublox,1:Use base station for GPS yaw on SBF
+    // @Bitmask: 0:Use UART2 for moving baseline on ublox,1:Use base station for GPS yaw on SBF,2:Inject RTCM fragments as they arrive without reassembly
     // @User: Advanced
     AP_GROUPINFO("_DRV_OPTIONS", 22, AP_GPS, _driver_options, 0),
 #endif
@@ -377,6 +377,16 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
     AP_GROUPINFO("2_CAN_OVRIDE", 31, AP_GPS, _override_node_id[1], 0),
 #endif
 
+#if GPS_PARSE_THREAD_ENABLED
+    // @Param: _THREAD
+    // @DisplayName: GPS parsing thread
+    // @Description: Parse data from serial GPS receivers in a separate thread as it arrives, rather than in the main loop. The main loop is then only given completed solutions
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("_THREAD", 32, AP_GPS, _parse_thread, 0),
+#endif
+
     AP_GROUPEND
 };
 
@@ -444,7 +454,83 @@ void AP_GPS::init(const AP_SerialManager& serial_manager)
             _rate_ms[i] = GPS_MAX_RATE_MS;
         }
     }
+
+#if GPS_PARSE_THREAD_ENABLED
+    if (_parse_thread) {
+        _parse = new parse_thread_state[GPS_MAX_RECEIVERS];
+        if (_parse == nullptr ||
+            !hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_GPS::parse_thread, void),
+                                          "gps", 3072, AP_HAL::Scheduler::PRIORITY_UART, 0)) {
+            // fall back to parsing in the main loop
+            delete[] _parse;
+            _parse = nullptr;
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "GPS: failed to start parse thread");
+        }
+    }
+#endif
+}
+
+/*
+  get the state a new UART driver should write to. With the parse
+  thread this is the thread's private copy, seeded from the frontend
+  state
+ */
+AP_GPS::GPS_State &AP_GPS::uart_driver_state(uint8_t instance)
+{
+#if GPS_PARSE_THREAD_ENABLED
+    if (_parse != nullptr) {
+        _parse[instance].state = state[instance];
+        _parse[instance].new_data = false;
+        return _parse[instance].state;
+    }
+#endif
+    return state[instance];
+}
+
+#if GPS_PARSE_THREAD_ENABLED
+/*
+  thread running the UART drivers. It wakes when any GPS UART has
+  data, or every few milliseconds on HALs without UART events
+ */
+void AP_GPS::parse_thread(void)
+{
+    while (!hal.scheduler->is_system_initialized()) {
+        hal.scheduler->delay(1);
+    }
+
+    bool have_events = false;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (_port[i] != nullptr && _port[i]->set_event_handle(&_parse_event)) {
+            have_events = true;
+        }
+    }
+
+    while (true) {
+        if (!have_events) {
+            hal.scheduler->delay_microseconds(2000);
+        } else {
+            // the timeout covers drivers that also need to send
+            // while no data is arriving
+            _parse_event.wait(10000);
+        }
+
+        WITH_SEMAPHORE(rsem);
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if (!(_parse_mask & (1U<<i)) || drivers[i] == nullptr ||
+                (locked_ports & (1U<<i)) || _type[i] == GPS_TYPE_NONE) {
+                continue;
+            }
+            if (drivers[i]->read()) {
+                parse_thread_state &ps = _parse[i];
+                ps.published = ps.state;
+                // the frontend consumes the UART timestamp once per solution
+                ps.state.uart_timestamp_ms = 0;
+                ps.new_data = true;
+            }
+        }
+    }
 }
+#endif // GPS_PARSE_THREAD_ENABLED
 
 // return number of active GPS sensors. Note that if the first GPS
 // is not present but the 2nd is then we return 2. Note that a blended
@@ -560,6 +646,8 @@ void AP_GPS::detect_instance(uint8_t instance)
     state[instance].hdop = GPS_UNKNOWN_DOP;
     state[instance].vdop = GPS_UNKNOWN_DOP;
 
+    GPS_State &uart_state = uart_driver_state(instance);
+
     switch (_type[instance]) {
     // user has to explicitly set the MAV type, do not use AUTO
     // do not try to detect the MAV type, assume it's there
@@ -609,15 +697,15 @@ void AP_GPS::detect_instance(uint8_t instance)
     switch (_type[instance]) {
     // by default the sbf/trimble gps outputs no data on its port, until configured.
     case GPS_TYPE_SBF:
-        new_gps = new AP_GPS_SBF(*this, state[instance], _port[instance]);
+        new_gps = new AP_GPS_SBF(*this, uart_state, _port[instance]);
         break;
 
     case GPS_TYPE_GSOF:
-        new_gps = new AP_GPS_GSOF(*this, state[instance], _port[instance]);
+        new_gps = new AP_GPS_GSOF(*this, uart_state, _port[instance]);
         break;
 
     case GPS_TYPE_NOVA:
-        new_gps = new AP_GPS_NOVA(*this, state[instance], _port[instance]);
+        new_gps = new AP_GPS_NOVA(*this, uart_state, _port[instance]);
         break;
 
     default:
@@ -676,7 +764,7 @@ void AP_GPS::detect_instance(uint8_t instance)
             ((!_auto_config && _baudrates[dstate->current_baud] >= 38400) ||
              _baudrates[dstate->current_baud] == 230400) &&
             AP_GPS_UBLOX::_detect(dstate->ublox_detect_state, data)) {
-            new_gps = new AP_GPS_UBLOX(*this, state[instance], _port[instance], GPS_ROLE_NORMAL);
+            new_gps = new AP_GPS_UBLOX(*this, uart_state, _port[instance], GPS_ROLE_NORMAL);
         }
 
         const uint32_t ublox_mb_required_baud = (_driver_options.get() & AP_GPS_Backend::DriverOptions::UBX_MBUseUart2)?230400:460800;
@@ -690,7 +778,7 @@ void AP_GPS::detect_instance(uint8_t instance)
             } else {
                 role = GPS_ROLE_MB_ROVER;
             }
-            new_gps = new AP_GPS_UBLOX(*this, state[instance], _port[instance], role);
+            new_gps = new AP_GPS_UBLOX(*this, uart_state, _port[instance], role);
         }
 #ifndef HAL_BUILD_AP_PERIPH
 #if !HAL_MINIMIZE_FEATURES
@@ -698,34 +786,34 @@ void AP_GPS::detect_instance(uint8_t instance)
         // and are surprisingly large
         else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_MTK19) &&
                  AP_GPS_MTK19::_detect(dstate->mtk19_detect_state, data)) {
-            new_gps = new AP_GPS_MTK19(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_MTK19(*this, uart_state, _port[instance]);
         } else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_MTK) &&
                    AP_GPS_MTK::_detect(dstate->mtk_detect_state, data)) {
-            new_gps = new AP_GPS_MTK(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_MTK(*this, uart_state, _port[instance]);
         }
 #endif
         else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_SBP) &&
                  AP_GPS_SBP2::_detect(dstate->sbp2_detect_state, data)) {
-            new_gps = new AP_GPS_SBP2(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_SBP2(*this, uart_state, _port[instance]);
         }
         else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_SBP) &&
                  AP_GPS_SBP::_detect(dstate->sbp_detect_state, data)) {
-            new_gps = new AP_GPS_SBP(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_SBP(*this, uart_state, _port[instance]);
         }
 #if !HAL_MINIMIZE_FEATURES
         else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_SIRF) &&
                  AP_GPS_SIRF::_detect(dstate->sirf_detect_state, data)) {
-            new_gps = new AP_GPS_SIRF(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_SIRF(*this, uart_state, _port[instance]);
         }
 #endif
         else if ((_type[instance] == GPS_TYPE_AUTO || _type[instance] == GPS_TYPE_ERB) &&
                  AP_GPS_ERB::_detect(dstate->erb_detect_state, data)) {
-            new_gps = new AP_GPS_ERB(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_ERB(*this, uart_state, _port[instance]);
         } else if ((_type[instance] == GPS_TYPE_NMEA ||
                     _type[instance] == GPS_TYPE_HEMI ||
                     _type[instance] == GPS_TYPE_ALLYSTAR) &&
                    AP_GPS_NMEA::_detect(dstate->nmea_detect_state, data)) {
-            new_gps = new AP_GPS_NMEA(*this, state[instance], _port[instance]);
+            new_gps = new AP_GPS_NMEA(*this, uart_state, _port[instance]);
         }
 #endif // HAL_BUILD_AP_PERIPH
         if (new_gps) {
@@ -736,6 +824,13 @@ void AP_GPS::detect_instance(uint8_t instance)
 found_gps:
     if (new_gps != nullptr) {
         state[instance].status = NO_FIX;
+#if GPS_PARSE_THREAD_ENABLED
+        if (_parse != nullptr && dstate->auto_detected_baud) {
+            // a UART driver, run it from the parse thread
+            uart_state.status = NO_FIX;
+            _parse_mask |= (1U<<instance);
+        }
+#endif
         drivers[instance] = new_gps;
         timing[instance].last_message_time_ms = now;
         timing[instance].delta_time_ms = GPS_TIMEOUT_MS;
@@ -804,7 +899,20 @@ void AP_GPS::update_instance(uint8_t instance)
     }
 
     // we have an active driver for this instance
-    bool result = drivers[instance]->read();
+    bool result;
+#if GPS_PARSE_THREAD_ENABLED
+    if (_parse_mask & (1U<<instance)) {
+        // take the latest solution from the parse thread
+        result = _parse[instance].new_data;
+        if (result) {
+            state[instance] = _parse[instance].published;
+            _parse[instance].new_data = false;
+        }
+    } else
+#endif
+    {
+        result = drivers[instance]->read();
+    }
     uint32_t tnow = AP_HAL::millis();
 
     // if we did not get a message, and the idle timer of 2 seconds
@@ -827,6 +935,9 @@ void AP_GPS::update_instance(uint8_t instance)
                 // don't end up with two allocated at any time
                 delete drivers[instance];
                 drivers[instance] = nullptr;
+#if GPS_PARSE_THREAD_ENABLED
+                _parse_mask &= ~(1U<<instance);
+#endif
                 state[instance].status = NO_GPS;
             }
             // log this data as a "flag" that the GPS is no longer
@@ -1338,6 +1449,11 @@ void AP_GPS::handle_gps_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_
         return;
     }
 
+    if (_driver_options.get() & AP_GPS_Backend::DriverOptions::RTCM_StreamFragments) {
+        stream_rtcm_fragment(flags, data, len);
+        return;
+    }
+
     // see if we need to allocate re-assembly buffer
     if (rtcm_buffer == nullptr) {
         rtcm_buffer = (struct rtcm_buffer *)calloc(1, sizeof(*rtcm_buffer));
@@ -1391,6 +1507,31 @@ void AP_GPS::handle_gps_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_
     }
 }
 
+/*
+  inject a fragment of a GPS_RTCM_DATA block straight away. RTCM is a
+  byte stream with its own framing and CRC, so the receiver doesn't
+  need whole blocks, and this saves the copy into the reassembly
+  buffer and the wait for the last fragment. Fragments must arrive in
+  order; one that doesn't follow the last streamed fragment is dropped,
+  and the receiver discards the broken message
+ */
+void AP_GPS::stream_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_t len)
+{
+    const uint8_t fragment = (flags >> 1U) & 0x03;
+    const uint8_t sequence = (flags >> 3U) & 0x1F;
+
+    if (fragment == 0) {
+        rtcm_stream.sequence = sequence;
+    } else if (sequence != rtcm_stream.sequence || fragment != rtcm_stream.next_fragment) {
+        // we missed part of this block
+        return;
+    }
+    rtcm_stream.next_fragment = fragment + 1;
+    if (len > 0) {
+        inject_data(data, len);
+    }
+}
+
 /*
    re-assemble GPS_RTCM_DATA message
  */
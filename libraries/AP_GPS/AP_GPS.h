@@ -48,6 +48,10 @@
 #define GPS_MOVING_BASELINE !HAL_MINIMIZE_FEATURES && GPS_MAX_RECEIVERS>1
 #endif
 
+#ifndef GPS_PARSE_THREAD_ENABLED
+#define GPS_PARSE_THREAD_ENABLED !HAL_MINIMIZE_FEATURES
+#endif
+
 #ifndef HAL_MSP_GPS_ENABLED
 #define HAL_MSP_GPS_ENABLED HAL_MSP_SENSORS_ENABLED
 #endif
@@ -555,6 +559,9 @@ protected:
     AP_Float _blend_tc;
     AP_Int16 _driver_options;
     AP_Int8 _primary;
+#if GPS_PARSE_THREAD_ENABLED
+    AP_Int8 _parse_thread;
+#endif
 #if GPS_MAX_RECEIVERS > 1 && HAL_ENABLE_LIBUAVCAN_DRIVERS
     AP_Int32 _node_id[GPS_MAX_RECEIVERS];
     AP_Int32 _override_node_id[GPS_MAX_RECEIVERS];
@@ -633,6 +640,26 @@ private:
     void detect_instance(uint8_t instance);
     void update_instance(uint8_t instance);
 
+#if GPS_PARSE_THREAD_ENABLED
+    /*
+      with GPS_THREAD set, UART drivers are run from their own thread
+      as data arrives. The driver writes to a private state, which is
+      copied to published each time it completes a solution, and
+      update_instance() takes the published state
+     */
+    struct parse_thread_state {
+        GPS_State state;
+        GPS_State published;
+        bool new_data;
+    } *_parse;
+    // instances whose driver is run by the parse thread
+    uint8_t _parse_mask;
+    HAL_EventHandle _parse_event;
+    void parse_thread(void);
+#endif
+    // state a new UART driver for an instance should write to
+    GPS_State &uart_driver_state(uint8_t instance);
+
     /*
       buffer for re-assembling RTCM data for GPS injection.
       The 8 bit flags field in GPS_RTCM_DATA is interpreted as:
@@ -653,6 +680,17 @@ private:
         uint8_t buffer[MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN*4];
     } *rtcm_buffer;
 
+    /*
+      with the RTCM streaming driver option, fragments are injected as
+      they arrive rather than after reassembly. This tracks the block
+      being streamed so out of order fragments can be dropped
+     */
+    struct {
+        uint8_t sequence;
+        uint8_t next_fragment;
+    } rtcm_stream;
+    void stream_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_t len);
+
     // re-assemble GPS_RTCM_DATA message
     void handle_gps_rtcm_data(const mavlink_message_t &msg);
     void handle_gps_inject(const mavlink_message_t &msg);
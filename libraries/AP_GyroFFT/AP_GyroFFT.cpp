@@ -155,6 +155,14 @@ const AP_Param::GroupInfo AP_GyroFFT::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("HMNC_PEAK", 13, AP_GyroFFT, _harmonic_peak, 0),
 
+    // @Param: OPTIONS
+    // @DisplayName: FFT options
+    // @Description: FFT configuration options. The sliding DFT engine tracks only the bins between MINHZ and MAXHZ and updates them with every gyro sample rather than running a full FFT per frame. This is cheaper than the FFT for narrow frequency ranges and allows a smaller window overlap step on slower boards. Takes effect on reboot.
+    // @Bitmask: 0:Sliding DFT engine
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("OPTIONS", 14, AP_GyroFFT, _options, 0),
+
     AP_GROUPEND
 };
 
@@ -229,7 +237,7 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
         const uint16_t loop_rate_hz = 1000*1000UL / target_looptime_us;
         _fft_sampling_rate_hz = loop_rate_hz / _sample_mode;
         for (uint8_t axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            if (!_downsampled_gyro_data[axis].set_size(_window_size + _samples_per_frame)) {
+            if (!_downsampled_gyro_data[axis].set_size(_window_size + _samples_per_frame * window_frames())) {
                 gcs().send_text(MAV_SEVERITY_WARNING, "Failed to allocate window for AP_GyroFFT");
                 return;
             }
@@ -245,7 +253,7 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
 
     // make the gyro window match the window size plus a buffer to cope with the backend
     // getting too far ahead.
-    if (!_ins->set_gyro_window_size(_window_size + _samples_per_frame)) {
+    if (!_ins->set_gyro_window_size(_window_size + _samples_per_frame * window_frames())) {
         return;
     }
 
@@ -279,6 +287,12 @@ void AP_GyroFFT::init(uint32_t target_looptime_us)
         gcs().send_text(MAV_SEVERITY_WARNING, "Failed to initialize DSP engine");
         return;
     }
+    if (option_set(Options::SlidingDFT)) {
+        _sliding_dft = hal.dsp->sdft_init(_window_size, XYZ_AXIS_COUNT);
+        if (_sliding_dft == nullptr) {
+            gcs().send_text(MAV_SEVERITY_WARNING, "AP_GyroFFT: sliding DFT unavailable, using FFT");
+        }
+    }
 
     // per-axis frame time
     _frame_time_ms = _samples_per_frame * 1000 / _fft_sampling_rate_hz;
@@ -408,14 +422,26 @@ uint16_t AP_GyroFFT::run_cycle()
     FloatBuffer& gyro_buffer = (_sample_mode == 0 ?_ins->get_raw_gyro_window(_update_axis) : _downsampled_gyro_data[_update_axis]);
     // if we have many more samples than the window size then we are struggling to 
     // stay ahead of the gyro loop so drop samples so that this cycle will use all available samples
-    if (gyro_buffer.available() > uint32_t(_state->_window_size + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
-        gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+    const uint16_t required_samples = get_required_samples();
+    if (gyro_buffer.available() > uint32_t(required_samples + uint16_t(_samples_per_frame >> 1))) { // half the frame size is a heuristic
+        gyro_buffer.advance(gyro_buffer.available() - required_samples);
+        if (_sliding_dft != nullptr) {
+            _sliding_dft->invalidate(_update_axis);
+        }
     }
-    // let's go!
-    hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
 
-    // calculate FFT and update filters outside the semaphore
-    uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    uint16_t bin_max;
+    if (_sliding_dft != nullptr) {
+        // update only the bins of interest, sliding the window forward by a frame
+        bin_max = hal.dsp->sdft_analyse(_state, _sliding_dft, _update_axis, gyro_buffer, _samples_per_frame,
+                                        config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    } else {
+        // let's go!
+        hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
+
+        // calculate FFT and update filters outside the semaphore
+        bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    }
 
     // something has been detected, update the peak frequency and associated metrics
     update_ref_energy(bin_max);
@@ -448,7 +474,7 @@ bool AP_GyroFFT::start_analysis() {
         return false;
     }
 
-    if (get_available_samples(_update_axis) >= _state->_window_size) {
+    if (get_available_samples(_update_axis) >= get_required_samples()) {
         _thread_state._analysis_started = true;
         return true;
     }
@@ -486,7 +512,7 @@ void AP_GyroFFT::update_thread(void)
         // this is to stop us burning CPU while waiting for samples, the reduction by _samples_per_frame is a heuristic to prevent waiting too long
         // and missing frames (easy to see in SITL because the noise will keep calibrating)
         // we always delay by at least 1us to give logging a chance to run at the same priority
-        uint32_t delay = constrain_int32((int16_t)_state->_window_size - (int16_t)remaining_samples, 0, _samples_per_frame)
+        uint32_t delay = constrain_int32((int16_t)get_required_samples() - (int16_t)remaining_samples, 0, _samples_per_frame)
             * 1e6 / _fft_sampling_rate_hz;
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         // in SITL the gyros do not run in a different thread
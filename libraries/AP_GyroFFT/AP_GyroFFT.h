@@ -203,6 +203,17 @@ private:
     bool analysis_enabled() const { return _initialized && _analysis_enabled && _thread_created; };
     // whether analysis can be run again or not
     bool start_analysis();
+    enum class Options : uint16_t {
+        SlidingDFT = 1 << 0,
+    };
+    bool option_set(Options option) const { return (uint16_t(_options.get()) & uint16_t(option)) != 0; }
+    // number of frames of samples buffered beyond the window, the sliding DFT needs
+    // the next frame of samples to be available in order to slide the window forward
+    uint8_t window_frames() const { return option_set(Options::SlidingDFT) ? 2 : 1; }
+    // samples needed before analysis of a frame can start
+    uint16_t get_required_samples() const {
+        return _state->_window_size + (_sliding_dft != nullptr ? _samples_per_frame : 0);
+    }
     // return samples available in the gyro window
     uint16_t get_available_samples(uint8_t axis) {
         return _sample_mode == 0 ?_ins->get_raw_gyro_window(axis).available() : _downsampled_gyro_data[axis].available();
@@ -265,6 +276,8 @@ private:
 
     // state of the FFT engine
     AP_HAL::DSP::FFTWindowState* _state;
+    // state of the optional sliding DFT engine
+    AP_HAL::DSP::SlidingDFTState* _sliding_dft;
     // update state machine step information
     uint8_t _update_axis;
     // noise base of the gyros
@@ -334,6 +347,8 @@ private:
     AP_Int8 _harmonic_fit;
     // harmonic peak target
     AP_Int8 _harmonic_peak;
+    // engine options
+    AP_Int16 _options;
     AP_InertialSensor* _ins;
 #if DEBUG_FFT
     uint32_t _last_output_ms;
@@ -6,6 +6,15 @@
   macros to allow code to build on multiple platforms more easily
  */
 
+/*
+  mark a function as being on the main loop hot path. Boards with an
+  ITCM set this in hwdef.h to place the function there instead of in
+  flash, elsewhere it has no effect
+ */
+#ifndef __FASTRAMFUNC__
+#define __FASTRAMFUNC__
+#endif
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
 /*
   allow double maths on Linux and SITL to avoid problems with system headers
@@ -34,6 +34,8 @@ struct AP_HAL::CANFrame {
 
     static const uint8_t MaxDataLen = 8;
 
+    static const uint8_t NumPriorityClasses = 4;
+
     uint32_t id;                ///< CAN ID with flags (above)
     uint8_t data[MaxDataLen];
     uint8_t dlc;                ///< Data Length Code
@@ -87,6 +89,17 @@ struct AP_HAL::CANFrame {
     {
         return rhs.priorityHigherThan(*this);
     }
+
+    // coarse priority from the top two bits of the identifier, 0 is
+    // the highest. For DroneCAN these are the top bits of the transfer
+    // priority, so ESC and actuator commands are in class 0
+    uint8_t priorityClass() const
+    {
+        if (isExtended()) {
+            return ((id & MaskExtID) >> 27) & 3U;
+        }
+        return ((id & MaskStdID) >> 9) & 3U;
+    }
 };
 
 class AP_HAL::CANIface
@@ -76,6 +76,163 @@ DSP::FFTWindowState::~FFTWindowState()
     _rfft_data = nullptr;
 }
 
+// number of frames a sliding DFT is slid before its bins are recalculated directly,
+// this bounds accumulated rounding error and recovers from samples lost while the buffer was full
+#define SDFT_RESYNC_FRAMES 64
+
+DSP::SlidingDFTState::SlidingDFTState(uint16_t window_size, uint8_t num_signals)
+    : _window_size(window_size),
+    _bin_count(window_size / 2),
+    _num_signals(num_signals)
+{
+    _twiddle = (float*)hal.util->malloc_type(sizeof(float) * window_size * 2, DSP_MEM_REGION);
+    _bins = (float*)hal.util->malloc_type(sizeof(float) * (_bin_count + 1) * 2 * num_signals, DSP_MEM_REGION);
+    _signals = (Signal*)hal.util->malloc_type(sizeof(Signal) * num_signals, DSP_MEM_REGION);
+
+    if (_twiddle == nullptr || _bins == nullptr || _signals == nullptr) {
+        hal.util->free_type(_twiddle, sizeof(float) * _window_size * 2, DSP_MEM_REGION);
+        hal.util->free_type(_bins, sizeof(float) * (_bin_count + 1) * 2 * _num_signals, DSP_MEM_REGION);
+        hal.util->free_type(_signals, sizeof(Signal) * _num_signals, DSP_MEM_REGION);
+        _twiddle = nullptr;
+        _bins = nullptr;
+        _signals = nullptr;
+        return;
+    }
+
+    memset(_signals, 0, sizeof(Signal) * num_signals);
+    for (uint16_t m = 0; m < window_size; m++) {
+        _twiddle[m * 2] = cosf(2.0f * M_PI * m / window_size);
+        _twiddle[m * 2 + 1] = sinf(2.0f * M_PI * m / window_size);
+    }
+}
+
+DSP::SlidingDFTState::~SlidingDFTState()
+{
+    hal.util->free_type(_twiddle, sizeof(float) * _window_size * 2, DSP_MEM_REGION);
+    _twiddle = nullptr;
+    hal.util->free_type(_bins, sizeof(float) * (_bin_count + 1) * 2 * _num_signals, DSP_MEM_REGION);
+    _bins = nullptr;
+    hal.util->free_type(_signals, sizeof(Signal) * _num_signals, DSP_MEM_REGION);
+    _signals = nullptr;
+}
+
+// initialise a sliding DFT instance
+DSP::SlidingDFTState* DSP::sdft_init(uint16_t window_size, uint8_t num_signals)
+{
+    // the twiddle indexing relies on the window being a power of 2
+    if (window_size == 0 || (window_size & (window_size - 1)) != 0 || num_signals == 0) {
+        return nullptr;
+    }
+    SlidingDFTState* sdft = new SlidingDFTState(window_size, num_signals);
+    if (sdft == nullptr || sdft->_twiddle == nullptr || sdft->_bins == nullptr || sdft->_signals == nullptr) {
+        delete sdft;
+        return nullptr;
+    }
+    return sdft;
+}
+
+// return sample i of the one or two spans making up a window
+static inline float iovec_sample(const ByteBuffer::IoVec vec[2], uint32_t n0, uint32_t i)
+{
+    return i < n0 ? ((const float*)vec[0].data)[i] : ((const float*)vec[1].data)[i - n0];
+}
+
+/*
+  analyse the oldest window of samples using a sliding DFT. Only the bins
+  needed for peak detection are tracked, and each new sample updates them as
+      X_k = (X_k - x_oldest + x_newest) * e^(j*2*pi*k/N)
+  The Hann window is applied in the frequency domain as
+      Y_k = 0.5 * X_k - 0.25 * (X_k-1 + X_k+1)
+ */
+uint16_t DSP::sdft_analyse(FFTWindowState* fft, SlidingDFTState* sdft, uint8_t signal, FloatBuffer& samples, uint16_t advance,
+                           uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
+{
+    if (sdft == nullptr || signal >= sdft->_num_signals || sdft->_window_size != fft->_window_size) {
+        return 0;
+    }
+
+    const uint16_t N = sdft->_window_size;
+    const uint16_t bin_count = sdft->_bin_count;
+
+    ByteBuffer::IoVec vec[2];
+    const uint8_t n_vec = samples.peekiovec(vec, N + advance);
+    const uint32_t n0 = n_vec > 0 ? vec[0].len / sizeof(float) : 0;
+    const uint32_t total = n0 + (n_vec > 1 ? vec[1].len / sizeof(float) : 0);
+    if (total < N) {
+        return 0;
+    }
+
+    // windowed bins needed by step_cmplx_mag() and the frequency interpolator
+    const uint16_t win_lo = start_bin > 0 ? start_bin - 1 : 0;
+    const uint16_t win_hi = MIN(end_bin + 3, bin_count);
+    // raw bins needed to apply the window
+    const uint16_t lo = win_lo > 0 ? win_lo - 1 : 0;
+    const uint16_t hi = MIN(win_hi + 1, bin_count);
+
+    SlidingDFTState::Signal& sig = sdft->_signals[signal];
+    float* X = &sdft->_bins[signal * (bin_count + 1) * 2];
+    const float* W = sdft->_twiddle;
+
+    // calculate the bins directly if they are stale
+    if (!sig._valid || sig._start_bin != lo || sig._end_bin != hi || sig._frames_since_sync >= SDFT_RESYNC_FRAMES) {
+        for (uint16_t k = lo; k <= hi; k++) {
+            float re = 0.0f, im = 0.0f;
+            uint16_t m = 0;
+            for (uint16_t n = 0; n < N; n++) {
+                const float x = iovec_sample(vec, n0, n);
+                re += x * W[m * 2];
+                im -= x * W[m * 2 + 1];
+                m = (m + k) & (N - 1);
+            }
+            X[k * 2] = re;
+            X[k * 2 + 1] = im;
+        }
+        sig._start_bin = lo;
+        sig._end_bin = hi;
+        sig._frames_since_sync = 0;
+    }
+
+    // apply the window and write the results where the FFT engine would
+    memset(fft->_freq_bins, 0, sizeof(float) * (bin_count + 1));
+    memset(fft->_rfft_data, 0, sizeof(float) * (N + 2));
+    for (uint16_t k = win_lo; k <= win_hi; k++) {
+        // real input, so the bins either side of DC and Nyquist are conjugates
+        const float m1_re = k == 0 ? X[2] : X[(k - 1) * 2];
+        const float m1_im = k == 0 ? -X[3] : X[(k - 1) * 2 + 1];
+        const float p1_re = k == bin_count ? X[(k - 1) * 2] : X[(k + 1) * 2];
+        const float p1_im = k == bin_count ? -X[(k - 1) * 2 + 1] : X[(k + 1) * 2 + 1];
+        const float re = 0.5f * X[k * 2] - 0.25f * (m1_re + p1_re);
+        const float im = 0.5f * X[k * 2 + 1] - 0.25f * (m1_im + p1_im);
+        fft->_rfft_data[k * 2] = re;
+        fft->_rfft_data[k * 2 + 1] = im;
+        fft->_freq_bins[k] = sq(re) + sq(im);
+    }
+
+    step_cmplx_mag(fft, start_bin, end_bin, noise_att_cutoff);
+    const uint16_t bin_max = step_calc_frequencies(fft, start_bin, end_bin);
+
+    // slide the window forward if all of the new samples are already available,
+    // otherwise recalculate directly next time
+    if (total >= uint32_t(N + advance)) {
+        for (uint16_t j = 0; j < advance; j++) {
+            const float delta = iovec_sample(vec, n0, N + j) - iovec_sample(vec, n0, j);
+            for (uint16_t k = lo; k <= hi; k++) {
+                const float re = X[k * 2] + delta;
+                const float im = X[k * 2 + 1];
+                X[k * 2] = re * W[k * 2] - im * W[k * 2 + 1];
+                X[k * 2 + 1] = re * W[k * 2 + 1] + im * W[k * 2];
+            }
+        }
+        sig._frames_since_sync++;
+        sig._valid = true;
+    } else {
+        sig._valid = false;
+    }
+    samples.advance(advance);
+
+    return bin_max;
+}
+
 // step 3: find the magnitudes of the complex data
 void DSP::step_cmplx_mag(FFTWindowState* fft, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
 {
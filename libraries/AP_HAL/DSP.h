@@ -73,6 +73,49 @@ public:
         virtual ~FFTWindowState();
         FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics);
     };
+    // sliding DFT state, tracks a range of DFT bins of several signals
+    // one sample at a time rather than recomputing a full FFT per frame
+    class SlidingDFTState {
+    public:
+        struct Signal {
+            // range of raw bins currently tracked
+            uint16_t _start_bin;
+            uint16_t _end_bin;
+            // frames slid since the bins were last calculated directly
+            uint16_t _frames_since_sync;
+            // whether the bins describe the oldest window of samples
+            bool _valid;
+        };
+        // size of the DFT window
+        const uint16_t _window_size;
+        // number of DFT bins
+        const uint16_t _bin_count;
+        // number of signals tracked
+        const uint8_t _num_signals;
+        // twiddle factors e^(j*2*pi*m/N), interleaved complex
+        float* _twiddle;
+        // unwindowed DFT bins 0 to _bin_count for each signal, interleaved complex
+        float* _bins;
+        // per-signal tracking state
+        Signal* _signals;
+
+        // force the bins of a signal to be recalculated, e.g. after samples were dropped
+        void invalidate(uint8_t signal) {
+            if (_signals != nullptr && signal < _num_signals) {
+                _signals[signal]._valid = false;
+            }
+        }
+
+        ~SlidingDFTState();
+        SlidingDFTState(uint16_t window_size, uint8_t num_signals);
+    };
+    // initialise a sliding DFT instance
+    SlidingDFTState* sdft_init(uint16_t window_size, uint8_t num_signals);
+    // analyse the oldest window of samples using the sliding DFT, writing the results into
+    // the FFT state, then slide the window forward by advance samples
+    uint16_t sdft_analyse(FFTWindowState* state, SlidingDFTState* sdft, uint8_t signal, FloatBuffer& samples, uint16_t advance,
+                          uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff);
+
     // initialise an FFT instance
     virtual FFTWindowState* fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t harmonics) = 0;
     // start an FFT analysis with an ObjectBuffer
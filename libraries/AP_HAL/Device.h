@@ -55,6 +55,17 @@ public:
     FUNCTOR_TYPEDEF(PeriodicCb, void);
     typedef void* PeriodicHandle;
 
+    // run time statistics of a periodic callback on a bus thread
+    struct PeriodicStats {
+        uint32_t bus_id;        // bus_id of the device that registered the callback
+        uint32_t period_usec;
+        uint32_t count;         // number of runs since boot
+        uint64_t late_us;       // total time runs started after they were due, including waiting for the bus
+        uint64_t run_us;        // total time runs held the bus
+        uint32_t late_max_us;   // longest delay since the maximums were last reset
+        uint32_t run_max_us;    // longest run since the maximums were last reset
+    };
+
     FUNCTOR_TYPEDEF(BankSelectCb, bool, uint8_t);
 
     Device(enum BusType type)
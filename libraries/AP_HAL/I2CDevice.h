@@ -47,6 +47,30 @@ public:
     virtual bool read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                          uint32_t recv_len, uint8_t times) = 0;
 
+    // one read in a batch of register reads
+    struct BatchRead {
+        I2CDevice *dev;         // device to read, on the same bus as this one
+        uint8_t first_reg;
+        uint8_t *recv;
+        uint32_t recv_len;
+        bool ok;                // set if the read succeeded
+    };
+
+    /*
+     * Read registers from several devices on this device's bus, sharing
+     * one acquisition of the bus between them where the platform
+     * allows. The bus semaphore must be held. Returns the number of reads
+     * that succeeded
+     */
+    virtual uint8_t read_registers_batch(BatchRead *reads, uint8_t n) {
+        uint8_t nok = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            reads[i].ok = reads[i].dev->read_registers(reads[i].first_reg, reads[i].recv, reads[i].recv_len);
+            nok += reads[i].ok;
+        }
+        return nok;
+    }
+
     /* See Device::get_semaphore() */
     virtual Semaphore *get_semaphore() override = 0;
 
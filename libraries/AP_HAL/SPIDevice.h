@@ -45,6 +45,23 @@ public:
     virtual bool transfer_fullduplex(const uint8_t *send, uint8_t *recv,
                                      uint32_t len) = 0;
 
+    /*
+     * Start a full duplex transfer and return without waiting for it
+     * to complete, so the caller can do other work while the DMA
+     * runs. @send and @recv may be the same buffer and must remain
+     * valid until transfer_async_finish(), which waits for the
+     * transfer and returns its result. The bus semaphore must be held
+     * from start to finish, and no other transfer may be made on the
+     * bus in between. The default implementation completes the
+     * transfer before returning.
+     */
+    virtual bool transfer_async_start(const uint8_t *send, uint8_t *recv,
+                                      uint32_t len) {
+        _async_result = transfer_fullduplex(send, recv, len);
+        return _async_result;
+    }
+    virtual bool transfer_async_finish() { return _async_result; }
+
     /* 
      *  send N bytes of clock pulses without taking CS. This is used
      *  when initialising microSD interfaces over SPI
@@ -64,6 +81,9 @@ public:
 
     // setup a bus clock slowdown factor (optional interface)
     virtual void set_slowdown(uint8_t slowdown) {}
+
+private:
+    bool _async_result;
 };
 
 class SPIDeviceManager {
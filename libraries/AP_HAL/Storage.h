@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include "AP_HAL_Namespace.h"
 
+class ExpandingString;
+
 class AP_HAL::Storage {
 public:
     virtual void init() = 0;
@@ -11,4 +13,7 @@ public:
     virtual void write_block(uint16_t dst, const void* src, size_t n) = 0;
     virtual void _timer_tick(void) {};
     virtual bool healthy(void) { return true; }
+
+    // get storage write statistics
+    virtual void storage_info(ExpandingString &str) {}
 };
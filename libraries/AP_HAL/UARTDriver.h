@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Namespace.h"
 #include "utility/BetterStream.h"
+#include "utility/RingBuffer.h"
 
 class ExpandingString;
 
@@ -74,6 +75,7 @@ public:
         OPTION_NODMA_RX           = (1U<<8), // don't use DMA for RX
         OPTION_NODMA_TX           = (1U<<9), // don't use DMA for TX
         OPTION_MAVLINK_NO_FORWARD = (1U<<10), // don't forward MAVLink data to or from this device
+        OPTION_MAVLINK_RX_THREAD  = (1U<<11), // parse MAVLink from this device in its own thread
     };
 
     enum flow_control {
@@ -97,6 +99,13 @@ public:
      */
     virtual bool wait_timeout(uint16_t n, uint32_t timeout_ms) { return false; }
 
+    /*
+      set an event handle to be signalled when incoming data
+      arrives, so a reader in its own thread can wait on the handle
+      rather than poll available(). Return false if not supported
+     */
+    virtual bool set_event_handle(EventHandle *evt_handle) { return false; }
+
     /*
      * Optional method to control the update of the motors. Derived classes
      * can implement it if their HAL layer requires.
@@ -122,6 +131,21 @@ public:
         return 57;
     }
 
+    /*
+      reserve len bytes in the transmit buffer so the caller can fill
+      them in place rather than copying through write(). vec is filled
+      in with one or two contiguous areas. Returns the number of areas,
+      or zero if there is not enough space or the driver does not
+      support in-place writes, in which case write() should be used.
+
+      A successful write_reserve() must be followed by write_commit()
+      before any other write to the port
+     */
+    virtual uint8_t write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) { return 0; }
+
+    // make len bytes filled in after write_reserve() available for sending
+    virtual bool write_commit(uint32_t len) { return false; }
+
     /*
       return true if this UART has DMA enabled on both RX and TX
      */
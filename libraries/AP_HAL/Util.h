@@ -2,6 +2,7 @@
 
 #include <stdarg.h>
 #include "AP_HAL_Namespace.h"
+#include "Device.h"
 
 class ExpandingString;
 
@@ -182,6 +183,44 @@ public:
     // request information on uart I/O
     virtual void uart_info(ExpandingString &str) {}
 
+    // request the PC sampling profile since the last call
+    virtual void profile_info(ExpandingString &str) {}
+
+    // run time statistics of a thread
+    struct ThreadStats {
+        const char *name;
+        uint8_t priority;
+        uint32_t stack_free;
+        uint64_t run_us;        // total time running since the thread started
+        uint32_t switch_count;  // number of times the thread has been switched out
+        uint32_t latency_max_us; // longest wait from ready to running since the maximum was last reset
+    };
+
+    // get statistics on the idx'th thread, optionally resetting its maximum
+    virtual bool thread_stats(uint8_t idx, ThreadStats &stats, bool reset_max) { return false; }
+
+    // get statistics on the idx'th device periodic callback, optionally resetting its maximums
+    virtual bool periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max) { return false; }
+
+    /*
+      hardware CRC engine, giving the same results as crc_crc32() and
+      crc16_ccitt() in AP_Math/crc.h. Return false if the hardware is
+      not available (or busy), in which case the caller uses software
+     */
+    virtual bool crc32_hw(uint32_t &crc, const uint8_t *buf, uint32_t size) { return false; }
+    virtual bool crc16_ccitt_hw(uint16_t &crc, const uint8_t *buf, uint32_t size) { return false; }
+
+    /*
+      hardware SHA-256 engine, for AP_Math/sha256.h. sha256_hw_start()
+      claims the engine for one hash and returns false if it is not
+      available, in which case the caller uses software. After a
+      successful start sha256_hw_finish() must always be called, from
+      the same thread, to release it
+     */
+    virtual bool sha256_hw_start() { return false; }
+    virtual void sha256_hw_update(const uint8_t *buf, uint32_t size) {}
+    virtual void sha256_hw_finish(uint8_t *digest, uint8_t len) {}
+
 protected:
     // we start soft_armed false, so that actuators don't send any
     // values until the vehicle code has fully started
@@ -121,6 +121,12 @@
 #define HAL_I2C_INTERNAL_MASK 1
 #endif
 
+// PC sampling profiler, read from @SYS/profile.txt. Costs
+// HAL_PROFILER_SLOTS*12 bytes of RAM and a timer interrupt per sample
+#ifndef HAL_PROFILER_ENABLED
+#define HAL_PROFILER_ENABLED 0
+#endif
+
 // put all storage of files under /APM directory
 #ifndef HAL_BOARD_STORAGE_DIRECTORY
 #define HAL_BOARD_STORAGE_DIRECTORY "/APM"
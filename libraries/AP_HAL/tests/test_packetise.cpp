@@ -0,0 +1,65 @@
+#include <AP_gtest.h>
+#include <AP_HAL/HAL.h>
+#include <AP_HAL/utility/RingBuffer.h>
+#include <AP_HAL/utility/packetise.h>
+#include <GCS_MAVLink/GCS.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// write an unsigned MAVLink2 packet with a payload of len bytes
+static void write_packet(ByteBuffer &buf, uint8_t len)
+{
+    uint8_t pkt[12+255] {};
+    pkt[0] = MAVLINK_STX;
+    pkt[1] = len;
+    buf.write(pkt, 12+len);
+}
+
+TEST(packetise, Single)
+{
+    ByteBuffer buf{1024};
+    write_packet(buf, 10);
+    write_packet(buf, 10);
+
+    // one packet at a time
+    EXPECT_EQ(22, mavlink_packetise(buf, buf.available()));
+
+    // not a whole packet yet
+    EXPECT_EQ(0, mavlink_packetise(buf, 21));
+}
+
+TEST(packetise, Batch)
+{
+    ByteBuffer buf{1024};
+    write_packet(buf, 10);
+    write_packet(buf, 10);
+    write_packet(buf, 10);
+
+    // all whole packets that fit
+    EXPECT_EQ(66, mavlink_packetise_batch(buf, 0, buf.available(), 100));
+    EXPECT_EQ(44, mavlink_packetise_batch(buf, 0, buf.available(), 50));
+
+    // a partial packet at the end is left for later
+    EXPECT_EQ(44, mavlink_packetise_batch(buf, 0, 60, 100));
+
+    // a packet bigger than the limit still goes out on its own
+    EXPECT_EQ(22, mavlink_packetise_batch(buf, 0, buf.available(), 10));
+    EXPECT_EQ(0, mavlink_packetise_batch(buf, 0, 20, 100));
+
+    // starting part way through the buffer
+    EXPECT_EQ(44, mavlink_packetise_batch(buf, 22, buf.available()-22, 100));
+}
+
+TEST(packetise, NonMAVLink)
+{
+    ByteBuffer buf{1024};
+    const uint8_t junk[5] {1, 2, 3, 4, 5};
+    buf.write(junk, sizeof(junk));
+    write_packet(buf, 10);
+
+    // junk is sent up to the next packet start
+    EXPECT_EQ(5, mavlink_packetise(buf, buf.available()));
+    EXPECT_EQ(27, mavlink_packetise_batch(buf, 0, buf.available(), 100));
+}
+
+AP_GTEST_MAIN()
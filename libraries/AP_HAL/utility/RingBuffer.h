@@ -246,6 +246,16 @@ public:
         return ret;
     }
 
+    /*
+      fill out up to two contiguous spans covering the first len
+      objects so they can be read in place. Returns the number of
+      spans used
+     */
+    // !!! Note ObjectBuffer_TS is a duplicate of this, update in both places !!!
+    uint8_t peekiovec(ByteBuffer::IoVec vec[2], uint32_t len) {
+        return buffer->peekiovec(vec, len * sizeof(T));
+    }
+
     // advance the read pointer (discarding objects)
     // !!! Note ObjectBuffer_TS is a duplicate of this, update in both places !!!
     bool advance(uint32_t n) {
@@ -422,6 +432,17 @@ public:
         return ret;
     }
 
+    /*
+      fill out up to two contiguous spans covering the first len
+      objects so they can be read in place. Returns the number of
+      spans used
+     */
+    // !!! Note this is a duplicate of ObjectBuffer with semaphore, update in both places !!!
+    uint8_t peekiovec(ByteBuffer::IoVec vec[2], uint32_t len) {
+        WITH_SEMAPHORE(sem);
+        return buffer->peekiovec(vec, len * sizeof(T));
+    }
+
     // advance the read pointer (discarding objects)
     // !!! Note this is a duplicate of ObjectBuffer with semaphore, update in both places !!!
     bool advance(uint32_t n) {
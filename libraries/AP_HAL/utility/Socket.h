@@ -55,6 +55,9 @@ public:
     // return true if there is room for output data
     bool pollout(uint32_t timeout_ms);
 
+    // return the underlying file descriptor, for use with poll/epoll
+    int get_read_fd(void) const { return fd; }
+
     // start listening for new tcp connections
     bool listen(uint16_t backlog) const;
 
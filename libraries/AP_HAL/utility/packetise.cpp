@@ -9,11 +9,12 @@
 #include "packetise.h"
 
 /*
-  return the number of bytes to send for a packetised connection
+  return the length of the packet starting ofs bytes into the buffer,
+  given n bytes available from there
  */
-uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
+static uint16_t packet_length(ByteBuffer &writebuf, uint32_t ofs, uint16_t n)
 {
-    int16_t b = writebuf.peek(0);
+    int16_t b = writebuf.peek(ofs);
     if (b != MAVLINK_STX_MAVLINK1 && b != MAVLINK_STX) {
         /*
           we have a non-mavlink packet at the start of the
@@ -23,7 +24,7 @@ uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
         uint16_t limit = n>256?256:n;
         uint16_t i;
         for (i=0; i<limit; i++) {
-            b = writebuf.peek(i);
+            b = writebuf.peek(ofs+i);
             if (b == MAVLINK_STX_MAVLINK1 || b == MAVLINK_STX) {
                 n = i;
                 break;
@@ -47,10 +48,10 @@ uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
     }
 
     // the length of the packet is the 2nd byte
-    int16_t len = writebuf.peek(1);
+    int16_t len = writebuf.peek(ofs+1);
     if (b == MAVLINK_STX) {
         // This is Mavlink2. Check for signed packet with extra 13 bytes
-        int16_t incompat_flags = writebuf.peek(2);
+        int16_t incompat_flags = writebuf.peek(ofs+2);
         if (incompat_flags & MAVLINK_IFLAG_SIGNED) {
             min_length += MAVLINK_SIGNATURE_BLOCK_LEN;
         }
@@ -67,4 +68,31 @@ uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
     }
     return n;
 }
+
+/*
+  return the number of bytes to send for a packetised connection
+ */
+uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n)
+{
+    return packet_length(writebuf, 0, n);
+}
+
+/*
+  return the number of bytes to send for a packetised connection,
+  combining as many whole packets as fit in max_len into one datagram
+  starting ofs bytes into the buffer, with n bytes available from
+  there. A single packet longer than max_len is still sent on its own
+ */
+uint16_t mavlink_packetise_batch(ByteBuffer &writebuf, uint32_t ofs, uint16_t n, uint16_t max_len)
+{
+    uint16_t total = packet_length(writebuf, ofs, n);
+    while (total > 0 && total < n) {
+        const uint16_t len = packet_length(writebuf, ofs+total, n - total);
+        if (len == 0 || total + len > max_len) {
+            break;
+        }
+        total += len;
+    }
+    return total;
+}
 #endif // HAL_BOOTLOADER_BUILD
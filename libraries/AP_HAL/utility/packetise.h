@@ -5,3 +5,18 @@
 */
 uint16_t mavlink_packetise(ByteBuffer &writebuf, uint16_t n);
 
+/*
+  largest datagram to build when combining packets, kept under the
+  ethernet MTU to avoid IP fragmentation
+*/
+#ifndef MAVLINK_PACKETISE_MAX_DATAGRAM
+#define MAVLINK_PACKETISE_MAX_DATAGRAM 1400
+#endif
+
+/*
+  return the number of bytes to send for a packetised connection,
+  combining whole packets up to max_len bytes, starting ofs bytes into
+  the buffer with n bytes available from there
+*/
+uint16_t mavlink_packetise_batch(ByteBuffer &writebuf, uint32_t ofs, uint16_t n, uint16_t max_len);
+
@@ -32,4 +32,5 @@ namespace ChibiOS {
     class SoftSigReaderInt;
     class CANIface;
     class Flash;
+    class Profiler;
 }
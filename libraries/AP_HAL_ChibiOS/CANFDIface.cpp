@@ -378,6 +378,7 @@ int16_t CANIface::send(const AP_HAL::CANFrame& frame, uint64_t tx_deadline,
     pending_tx_[index].aborted        = false;
     pending_tx_[index].setup          = true;
     pending_tx_[index].pushed         = false;
+    pending_tx_us_[index]             = AP_HAL::micros();
     return 1;
 }
 
@@ -714,7 +715,9 @@ void CANIface::setupMessageRam()
     MessageRam_.RxFIFO1SA = base + FDCAN_RXFIFO1_OFFSET;
     MessageRam_.TxFIFOQSA = base + FDCAN_TXFIFO_OFFSET;
 
-    can_->TXBC = 0; // fifo mode
+    // queue mode, so the highest priority pending frame is always sent
+    // first rather than in the order they were queued
+    can_->TXBC = FDCAN_TXBC_TFQM;
 #else
     uint32_t num_elements = 0;
 
@@ -729,7 +732,9 @@ void CANIface::setupMessageRam()
     // Tx FIFO/queue start address and element count
     num_elements = MIN((FDCAN_TX_FIFO_BUFFER_SIZE/FDCAN_FRAME_BUFFER_SIZE), 32U);
     if (num_elements) {
-        can_->TXBC = (FDCANMessageRAMOffset_ << 2) | (num_elements << 24);
+        // queue mode, so the highest priority pending frame is always
+        // sent first rather than in the order they were queued
+        can_->TXBC = (FDCANMessageRAMOffset_ << 2) | (num_elements << 24) | FDCAN_TXBC_TFQM;
         MessageRam_.TxFIFOQSA = SRAMCAN_BASE + (FDCANMessageRAMOffset_ * 4U);
         FDCANMessageRAMOffset_ += num_elements*FDCAN_FRAME_BUFFER_SIZE;
     }
@@ -754,6 +759,12 @@ void CANIface::handleTxCompleteInterrupt(const uint64_t timestamp_us)
                 continue;
             }
 
+            auto &prio = stats.tx_prio[pending_tx_[i].frame.priorityClass()];
+            const uint32_t latency_us = uint32_t(timestamp_us) - pending_tx_us_[i];
+            prio.tx_success++;
+            prio.latency_sum_us += latency_us;
+            prio.latency_max_us = MAX(prio.latency_max_us, latency_us);
+
             if (pending_tx_[i].loopback && had_activity_) {
                 CanRxItem rx_item;
                 rx_item.frame = pending_tx_[i].frame;
@@ -1055,6 +1066,14 @@ void CANIface::get_stats(ExpandingString &str)
                stats.num_busoff_err,
                stats.num_events,
                stats.ecr);
+    for (uint8_t i = 0; i < AP_HAL::CANFrame::NumPriorityClasses; i++) {
+        const auto &prio = stats.tx_prio[i];
+        str.printf("tx_prio%u:       %lu avg_us=%lu max_us=%lu\n",
+                   unsigned(i),
+                   prio.tx_success,
+                   prio.tx_success ? (unsigned long)(prio.latency_sum_us / prio.tx_success) : 0UL,
+                   prio.latency_max_us);
+    }
 }
 #endif
 
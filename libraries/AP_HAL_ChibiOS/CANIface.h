@@ -154,7 +154,14 @@ class ChibiOS::CANIface : public AP_HAL::CANIface
         uint32_t num_busoff_err;
         uint32_t num_events;
         uint32_t esr;
+        // time from send() to the end of transmission, by priority class
+        struct {
+            uint32_t tx_success;
+            uint32_t latency_max_us;
+            uint64_t latency_sum_us;
+        } tx_prio[AP_HAL::CANFrame::NumPriorityClasses];
     } stats;
+    uint32_t pending_tx_us_[NumTxMailboxes];
 #endif
 
 public:
@@ -362,6 +362,9 @@ int16_t CANIface::send(const AP_HAL::CANFrame& frame, uint64_t tx_deadline,
     txi.abort_on_error = (flags & AbortOnError) != 0;
     // setup frame initial state
     txi.pushed         = false;
+#if !defined(HAL_BUILD_AP_PERIPH) && !defined(HAL_BOOTLOADER_BUILD)
+    pending_tx_us_[txmailbox] = AP_HAL::micros();
+#endif
     return 1;
 }
 
@@ -487,6 +490,13 @@ void CANIface::handleTxMailboxInterrupt(uint8_t mailbox_index, bool txok, const
     if (txok && !txi.pushed) {
         txi.pushed = true;
         PERF_STATS(stats.tx_success);
+#if !defined(HAL_BUILD_AP_PERIPH) && !defined(HAL_BOOTLOADER_BUILD)
+        auto &prio = stats.tx_prio[txi.frame.priorityClass()];
+        const uint32_t latency_us = uint32_t(timestamp_us) - pending_tx_us_[mailbox_index];
+        prio.tx_success++;
+        prio.latency_sum_us += latency_us;
+        prio.latency_max_us = MAX(prio.latency_max_us, latency_us);
+#endif
     }
 }
 
@@ -969,6 +979,14 @@ void CANIface::get_stats(ExpandingString &str)
                stats.num_busoff_err,
                stats.num_events,
                stats.esr);
+    for (uint8_t i = 0; i < AP_HAL::CANFrame::NumPriorityClasses; i++) {
+        const auto &prio = stats.tx_prio[i];
+        str.printf("tx_prio%u:       %lu avg_us=%lu max_us=%lu\n",
+                   unsigned(i),
+                   prio.tx_success,
+                   prio.tx_success ? (unsigned long)(prio.latency_sum_us / prio.tx_success) : 0UL,
+                   prio.latency_max_us);
+    }
 }
 #endif
 
@@ -16,6 +16,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/OwnPtr.h>
+#include <AP_Math/AP_Math.h>
 #include <stdio.h>
 
 #if HAL_USE_I2C == TRUE || HAL_USE_SPI == TRUE || HAL_USE_WSPI == TRUE
@@ -33,6 +34,8 @@ using namespace ChibiOS;
 
 extern const AP_HAL::HAL& hal;
 
+DeviceBus *DeviceBus::thread_buses;
+
 DeviceBus::DeviceBus(uint8_t _thread_priority) :
         thread_priority(_thread_priority)
 {
@@ -61,12 +64,23 @@ void DeviceBus::bus_thread(void *arg)
         // find a callback to run
         for (callback = binfo->callbacks; callback; callback = callback->next) {
             if (now >= callback->next_usec) {
+                const uint64_t due_usec = callback->next_usec;
                 while (now >= callback->next_usec) {
                     callback->next_usec += callback->period_usec;
                 }
                 // call it with semaphore held
                 WITH_SEMAPHORE(binfo->semaphore);
+                const uint64_t start_usec = AP_HAL::micros64();
                 callback->cb();
+                const uint32_t late_us = start_usec - due_usec;
+                const uint32_t run_us = AP_HAL::micros64() - start_usec;
+
+                AP_HAL::Device::PeriodicStats &stats = callback->stats;
+                stats.count++;
+                stats.late_us += late_us;
+                stats.run_us += run_us;
+                stats.late_max_us = MAX(stats.late_max_us, late_us);
+                stats.run_max_us = MAX(stats.run_max_us, run_us);
             }
         }
 
@@ -131,6 +145,8 @@ AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t pe
         if (thread_ctx == nullptr) {
             AP_HAL::panic("Failed to create bus thread %s", name);
         }
+        thread_next = thread_buses;
+        thread_buses = this;
     }
     DeviceBus::callback_info *callback = new DeviceBus::callback_info;
     if (callback == nullptr) {
@@ -139,6 +155,7 @@ AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t pe
     callback->cb = cb;
     callback->period_usec = period_usec;
     callback->next_usec = AP_HAL::micros64() + period_usec;
+    callback->stats.bus_id = _hal_device->get_bus_id();
 
     // add to linked list of callbacks on thread
     callback->next = callbacks;
@@ -166,6 +183,30 @@ bool DeviceBus::adjust_timer(AP_HAL::Device::PeriodicHandle h, uint32_t period_u
     return true;
 }
 
+/*
+  get statistics on the idx'th periodic callback across all bus
+  threads. Callbacks and buses are only ever added at the head of their
+  lists, so walking them from another thread is safe
+ */
+bool DeviceBus::periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max)
+{
+    for (DeviceBus *bus = thread_buses; bus; bus = bus->thread_next) {
+        for (callback_info *callback = bus->callbacks; callback; callback = callback->next) {
+            if (idx-- != 0) {
+                continue;
+            }
+            stats = callback->stats;
+            stats.period_usec = callback->period_usec;
+            if (reset_max) {
+                callback->stats.late_max_us = 0;
+                callback->stats.run_max_us = 0;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
   setup to use DMA-safe bouncebuffers for device transfers
  */
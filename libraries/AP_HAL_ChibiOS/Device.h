@@ -41,6 +41,9 @@ public:
     bool adjust_timer(AP_HAL::Device::PeriodicHandle h, uint32_t period_usec);
     static void bus_thread(void *arg);
 
+    // get statistics on the idx'th periodic callback across all bus threads
+    static bool periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max);
+
     bool bouncebuffer_setup(const uint8_t *&buf_tx, uint16_t tx_len,
                             uint8_t *&buf_rx, uint16_t rx_len) WARN_IF_UNUSED;
     void bouncebuffer_finish(const uint8_t *buf_tx, uint8_t *buf_rx, uint16_t rx_len);
@@ -51,10 +54,15 @@ private:
         AP_HAL::Device::PeriodicCb cb;
         uint32_t period_usec;
         uint64_t next_usec;
+        AP_HAL::Device::PeriodicStats stats;
     } *callbacks;
     uint8_t thread_priority;
     thread_t* thread_ctx;
     bool thread_started;
+
+    // list of buses with a callback thread, for statistics
+    static DeviceBus *thread_buses;
+    DeviceBus *thread_next;
     AP_HAL::Device *hal_device;
 
     // support for bounce buffers for DMA-safe transfers
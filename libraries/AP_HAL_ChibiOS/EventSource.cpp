@@ -8,7 +8,7 @@ bool EventSource::wait(uint64_t duration, AP_HAL::EventHandle *evt_handle)
 {
     chibios_rt::EventListener evt_listener;
     eventmask_t evt_mask = evt_handle->get_evt_mask();
-    msg_t ret = msg_t();
+    eventmask_t ret = 0;
     ch_evt_src_.registerMask(&evt_listener, evt_mask);
     if (duration == 0) {
         ret = chEvtWaitAnyTimeout(evt_mask, TIME_IMMEDIATE);
@@ -16,7 +16,8 @@ bool EventSource::wait(uint64_t duration, AP_HAL::EventHandle *evt_handle)
         ret = chEvtWaitAnyTimeout(evt_mask, chTimeUS2I(duration));
     }
     ch_evt_src_.unregister(&evt_listener);
-    return ret == MSG_OK;
+    // chEvtWaitAnyTimeout() returns the events that woke us, zero on timeout
+    return ret != 0;
 }
 
 void EventSource::signal(uint32_t evt_mask)
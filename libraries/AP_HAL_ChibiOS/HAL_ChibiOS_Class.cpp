@@ -24,6 +24,7 @@
 #include <AP_HAL_ChibiOS/AP_HAL_ChibiOS_Private.h>
 #include "shared_dma.h"
 #include "sdcard.h"
+#include "Profiler.h"
 #include "hwdef/common/usbcfg.h"
 #include "hwdef/common/stm32_util.h"
 #include "hwdef/common/watchdog.h"
@@ -217,6 +218,10 @@ static void main_loop()
     hal.analogin->init();
     hal.scheduler->init();
 
+#if HAL_PROFILER_ENABLED
+    ChibiOS::Profiler::init();
+#endif
+
     /*
       run setup() at low priority to ensure CLI doesn't hang the
       system, and to allow initial sensor read loops to run
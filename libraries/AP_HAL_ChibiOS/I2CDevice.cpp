@@ -223,14 +223,9 @@ void I2CBus::dma_deallocate(Shared_DMA *)
 {
 }
 
-bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
-                         uint8_t *recv, uint32_t recv_len)
+// setup the bus configuration for SMBus or plain I2C transfers
+void I2CDevice::set_bus_mode(void)
 {
-    if (!bus.semaphore.check_owner()) {
-        hal.console->printf("I2C: not owner of 0x%x for addr 0x%02x\n", (unsigned)get_bus_id(), _address);
-        return false;
-    }
-
 #if defined(STM32F7) || defined(STM32H7) || defined(STM32F3)
     if (_use_smbus) {
         bus.i2ccfg.cr1 |= I2C_CR1_SMBHEN;
@@ -244,6 +239,17 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
         bus.i2ccfg.op_mode = OPMODE_I2C;
     }
 #endif
+}
+
+bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
+                         uint8_t *recv, uint32_t recv_len)
+{
+    if (!bus.semaphore.check_owner()) {
+        hal.console->printf("I2C: not owner of 0x%x for addr 0x%02x\n", (unsigned)get_bus_id(), _address);
+        return false;
+    }
+
+    set_bus_mode();
 
     if (_split_transfers) {
         /*
@@ -343,6 +349,86 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
     return false;
 }
 
+/*
+  read registers from several devices on this bus. The I2C peripheral
+  needs a new start condition for each device, so the reads can't be
+  chained into one DMA transfer, but they do share one acquisition of
+  the bus, DMA stream and peripheral start rather than setting up and
+  tearing down for each read. Reads which can't be batched, and any
+  left after a failure, fall back to normal transfers with retries
+ */
+uint8_t I2CDevice::read_registers_batch(BatchRead *reads, uint8_t n)
+{
+    if (!bus.semaphore.check_owner()) {
+        hal.console->printf("I2C: not owner of 0x%x for addr 0x%02x\n", (unsigned)get_bus_id(), _address);
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        reads[i].ok = false;
+    }
+
+    i2cAcquireBus(I2CD[bus.busnum].i2c);
+    bus.dma_handle->lock();
+
+    set_bus_mode();
+    i2cStart(I2CD[bus.busnum].i2c, &bus.i2ccfg);
+    osalDbgAssert(I2CD[bus.busnum].i2c->state == I2C_READY, "i2cStart state");
+
+    for (uint8_t i = 0; i < n; i++) {
+        I2CDevice *dev = from(reads[i].dev);
+        if (&dev->bus != &bus || dev->_split_transfers || dev->_use_smbus != _use_smbus) {
+            continue;
+        }
+        const uint8_t reg = reads[i].first_reg | dev->_read_flag;
+        const uint8_t *send = &reg;
+        uint8_t *recv = reads[i].recv;
+        const uint32_t recv_len = reads[i].recv_len;
+        if (!bus.bouncebuffer_setup(send, 1, recv, recv_len)) {
+            break;
+        }
+        uint32_t timeout_ms = 1+2*(((8*1000000UL/bus.busclock)*(1+recv_len))/1000);
+        timeout_ms = MAX(timeout_ms, dev->_timeout_ms);
+
+        osalSysLock();
+        hal.util->persistent_data.i2c_count++;
+        osalSysUnlock();
+
+        const msg_t ret = i2cMasterTransmitTimeout(I2CD[bus.busnum].i2c, dev->_address, send, 1,
+                                                   recv, recv_len, chTimeMS2I(timeout_ms));
+        bus.bouncebuffer_finish(send, recv, recv_len);
+        if (ret != MSG_OK) {
+            // the peripheral needs restarting, leave the rest to the retry path
+            break;
+        }
+        reads[i].ok = true;
+    }
+
+    i2cSoftStop(I2CD[bus.busnum].i2c);
+    osalDbgAssert(I2CD[bus.busnum].i2c->state == I2C_STOP, "i2cStart state");
+
+    bus.dma_handle->unlock();
+
+    if (I2CD[bus.busnum].i2c->errors & I2C_ISR_LIMIT) {
+        INTERNAL_ERROR(AP_InternalError::error_t::i2c_isr);
+    }
+#ifdef STM32_I2C_ISR_LIMIT
+    AP_HAL::Util::PersistentData &pd = hal.util->persistent_data;
+    pd.i2c_isr_count += I2CD[bus.busnum].i2c->isr_count;
+#endif
+
+    i2cReleaseBus(I2CD[bus.busnum].i2c);
+
+    uint8_t nok = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (!reads[i].ok) {
+            reads[i].ok = reads[i].dev->read_registers(reads[i].first_reg, reads[i].recv, reads[i].recv_len);
+        }
+        nok += reads[i].ok;
+    }
+    return nok;
+}
+
 
 /*
   register a periodic callback
@@ -80,6 +80,9 @@ public:
     bool read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                  uint32_t recv_len, uint8_t times) override;
 
+    /* See AP_HAL::I2CDevice::read_registers_batch() */
+    uint8_t read_registers_batch(BatchRead *reads, uint8_t n) override;
+
     /* See AP_HAL::Device::register_periodic_callback() */
     AP_HAL::Device::PeriodicHandle register_periodic_callback(
         uint32_t period_usec, AP_HAL::Device::PeriodicCb) override;
@@ -100,6 +103,7 @@ private:
     I2CBus &bus;
     bool _transfer(const uint8_t *send, uint32_t send_len,
                          uint8_t *recv, uint32_t recv_len);
+    void set_bus_mode(void);
 
     /* I2C interface #2 */
     uint8_t _retries;
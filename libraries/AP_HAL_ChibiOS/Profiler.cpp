@@ -0,0 +1,158 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#if HAL_PROFILER_ENABLED
+
+#include <AP_Common/ExpandingString.h>
+#include <AP_Math/AP_Math.h>
+#include <stdlib.h>
+
+using namespace ChibiOS;
+
+// slots copied out per lock in info()
+#define PROFILER_COPY_CHUNK 64
+
+virtual_timer_t Profiler::timer;
+Profiler::Slot Profiler::slots[HAL_PROFILER_SLOTS];
+uint32_t Profiler::isr_samples;
+uint32_t Profiler::dropped_samples;
+uint32_t Profiler::rand_state = 0x12345678;
+uint32_t Profiler::last_info_ms;
+
+void Profiler::init(void)
+{
+    last_info_ms = AP_HAL::millis();
+    chVTObjectInit(&timer);
+    chVTSet(&timer, chTimeUS2I(next_period_us()), sample_cb, nullptr);
+}
+
+/*
+  jitter the sample period so the samples don't lock to the phase of
+  the main loop
+ */
+uint32_t Profiler::next_period_us(void)
+{
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return HAL_PROFILER_PERIOD_US/2 + rand_state % HAL_PROFILER_PERIOD_US;
+}
+
+/*
+  timer callback, in interrupt context
+ */
+void Profiler::sample_cb(void *p)
+{
+    chSysLockFromISR();
+    if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) == 0) {
+        // we preempted another interrupt. The PC on the process
+        // stack is where that interrupt was taken, not where the CPU is
+        isr_samples++;
+    } else {
+        // the interrupted thread's exception frame is on its stack,
+        // with the PC in the 7th word
+        const uint32_t *frame = (const uint32_t *)__get_PSP();
+        add_sample(frame[6], uint32_t(chThdGetSelfX()));
+    }
+    chVTSetI(&timer, chTimeUS2I(next_period_us()), sample_cb, nullptr);
+    chSysUnlockFromISR();
+}
+
+void Profiler::add_sample(uint32_t pc, uint32_t thread)
+{
+    const uint32_t hash = (pc >> 1) * 2654435761U + thread;
+    for (uint8_t i=0; i<8; i++) {
+        Slot &s = slots[(hash + i) % HAL_PROFILER_SLOTS];
+        if (s.count == 0) {
+            s.pc = pc;
+            s.thread = thread;
+            s.count = 1;
+            return;
+        }
+        if (s.pc == pc && s.thread == thread) {
+            s.count++;
+            return;
+        }
+    }
+    dropped_samples++;
+}
+
+int Profiler::slot_compare(const void *v1, const void *v2)
+{
+    const uint32_t c1 = ((const Slot *)v1)->count;
+    const uint32_t c2 = ((const Slot *)v2)->count;
+    if (c1 == c2) {
+        return 0;
+    }
+    return c1 < c2 ? 1 : -1;
+}
+
+/*
+  report the samples since the last call, most frequent first
+ */
+void Profiler::info(ExpandingString &str)
+{
+    Slot *copy = (Slot *)malloc(sizeof(slots));
+    if (copy == nullptr) {
+        str.printf("ProfileV1\nout of memory\n");
+        return;
+    }
+
+    // copy a chunk at a time to keep the time with interrupts locked short
+    for (uint16_t i=0; i<HAL_PROFILER_SLOTS; i += PROFILER_COPY_CHUNK) {
+        const uint16_t n = MIN(PROFILER_COPY_CHUNK, HAL_PROFILER_SLOTS-i);
+        chSysLock();
+        memcpy(&copy[i], &slots[i], n*sizeof(Slot));
+        memset(&slots[i], 0, n*sizeof(Slot));
+        chSysUnlock();
+    }
+    chSysLock();
+    const uint32_t isr = isr_samples;
+    const uint32_t dropped = dropped_samples;
+    isr_samples = 0;
+    dropped_samples = 0;
+    chSysUnlock();
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - last_info_ms;
+    last_info_ms = now_ms;
+
+    uint16_t used = 0;
+    uint32_t samples = isr + dropped;
+    for (uint16_t i=0; i<HAL_PROFILER_SLOTS; i++) {
+        if (copy[i].count != 0) {
+            samples += copy[i].count;
+            copy[used++] = copy[i];
+        }
+    }
+    qsort(copy, used, sizeof(Slot), slot_compare);
+
+    str.printf("ProfileV1 PERIOD_US=%u TIME_MS=%u SAMPLES=%u ISR=%u DROPPED=%u\n",
+               unsigned(HAL_PROFILER_PERIOD_US), unsigned(dt_ms),
+               unsigned(samples), unsigned(isr), unsigned(dropped));
+    for (uint16_t i=0; i<used; i++) {
+        const char *name = "?";
+        for (thread_t *tp = chRegFirstThread(); tp; tp = chRegNextThread(tp)) {
+            if (uint32_t(tp) == copy[i].thread && tp->name != nullptr) {
+                name = tp->name;
+            }
+        }
+        str.printf("%6u 0x%08x %s\n", unsigned(copy[i].count), unsigned(copy[i].pc), name);
+    }
+    free(copy);
+}
+
+#endif // HAL_PROFILER_ENABLED
@@ -0,0 +1,70 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_HAL_ChibiOS.h"
+
+#if HAL_PROFILER_ENABLED
+
+// mean time between samples, the actual time is jittered by +-50%
+#ifndef HAL_PROFILER_PERIOD_US
+#define HAL_PROFILER_PERIOD_US 1000
+#endif
+
+// number of distinct (pc, thread) pairs between reads of profile.txt
+#ifndef HAL_PROFILER_SLOTS
+#define HAL_PROFILER_SLOTS 2048
+#endif
+
+class ExpandingString;
+
+/*
+  PC sampling profiler. A virtual timer interrupts the running thread
+  and counts the PC it was at, per thread. Reading @SYS/profile.txt
+  returns the counts since the last read, which
+  Tools/scripts/profile_symbolize.py turns into function names.
+
+  Code that runs with interrupts locked is counted where it unlocks,
+  and samples taken while another interrupt was running are only
+  counted as "isr"
+ */
+class ChibiOS::Profiler {
+public:
+    static void init(void);
+
+    // report counts since the last call and start again
+    static void info(ExpandingString &str);
+
+private:
+    struct Slot {
+        uint32_t pc;
+        uint32_t thread;
+        uint32_t count;
+    };
+
+    static void sample_cb(void *p);
+    static void add_sample(uint32_t pc, uint32_t thread);
+    static uint32_t next_period_us(void);
+    static int slot_compare(const void *v1, const void *v2);
+
+    static virtual_timer_t timer;
+    static Slot slots[HAL_PROFILER_SLOTS];
+    static uint32_t isr_samples;
+    static uint32_t dropped_samples;
+    static uint32_t rand_state;
+    static uint32_t last_info_ms;
+};
+
+#endif // HAL_PROFILER_ENABLED
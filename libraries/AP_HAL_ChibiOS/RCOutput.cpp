@@ -17,6 +17,7 @@
  */
 #include "RCOutput.h"
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #include <AP_HAL/utility/RingBuffer.h>
 #include "GPIO.h"
@@ -1143,6 +1144,15 @@ void RCOutput::dshot_send_groups(uint32_t time_out_us)
         return;
     }
 
+#ifdef HAL_WITH_BIDIR_DSHOT
+    // decode the telemetry captured by all groups in one pass before
+    // any of them is sent again, keeping the decode out of the time
+    // critical sequence of group sends
+    for (auto &group : pwm_group_list) {
+        bdshot_decode_group_telemetry(group);
+    }
+#endif
+
     bool command_sent = false;
     // queue up a command if there is one
     if (!hal.util->get_soft_armed()
@@ -1304,23 +1314,8 @@ void RCOutput::dshot_send(pwm_group &group, uint32_t time_out_us)
         }
     }
 
-    // if the last transaction returned telemetry, decode it
-    if (group.dshot_state == DshotState::RECV_COMPLETE) {
-        uint8_t chan = group.chan[group.bdshot.prev_telem_chan];
-        uint32_t now = AP_HAL::millis();
-        if (bdshot_decode_dshot_telemetry(group, group.bdshot.prev_telem_chan)) {
-            _bdshot.erpm_clean_frames[chan]++;
-            _active_escs_mask |= (1<<chan); // we know the ESC is functional at this point
-        } else {
-            _bdshot.erpm_errors[chan]++;
-        }
-        // reset statistics periodically
-        if (now - _bdshot.erpm_last_stats_ms[chan] > 5000) {
-            _bdshot.erpm_clean_frames[chan] = 0;
-            _bdshot.erpm_errors[chan] = 0;
-            _bdshot.erpm_last_stats_ms[chan] = now;
-        }
-    }
+    // if the last transaction returned telemetry that has not been decoded yet, decode it
+    bdshot_decode_group_telemetry(group);
 
     if (group.bdshot.enabled) {
         if (group.pwm_started) {
@@ -1427,6 +1422,8 @@ bool RCOutput::serial_led_send(pwm_group &group)
 
         group.serial_led_pending = false;
         group.prepared_send = false;
+        group.serial_led_sent_crc = serial_led_crc(group);
+        group.serial_led_sent = true;
 
         // fill the DMA buffer while we have the lock
         fill_DMA_buffer_serial_led(group);
@@ -1887,6 +1884,12 @@ void RCOutput::serial_end(void)
             }
             set_group_mode(group);
             set_freq_group(group);
+#ifdef HAL_WITH_BIDIR_DSHOT
+            // any captured telemetry has been overwritten by serial output
+            if (group.dshot_state == DshotState::RECV_COMPLETE) {
+                group.dshot_state = DshotState::IDLE;
+            }
+#endif
         }
     }
     serial_group = nullptr;
@@ -2273,6 +2276,8 @@ void RCOutput::set_serial_led_rgb_data(const uint16_t chan, int8_t led, uint8_t
             }
         }
 
+        grp->serial_led_sent = false;
+
         // at this point the group led data is all setup but the dma buffer still needs to be resized
         set_output_mode(1U<<chan, grp->led_mode);
 
@@ -2344,10 +2349,36 @@ void RCOutput::serial_led_send(const uint16_t chan)
         return;
     }
 
-    if (grp->prepared_send) {
-        grp->serial_led_pending = true;
-        serial_led_pending = true;
+    if (!grp->prepared_send) {
+        return;
+    }
+
+    // the LEDs hold their colour, so a frame the same as the last one
+    // sent needs no DMA. Scripts and notify set the same colours at
+    // their update rate while the DMA for LED frames competes with
+    // DShot on the timers of the group
+    if (grp->serial_led_sent && serial_led_crc(*grp) == grp->serial_led_sent_crc) {
+        // the next frame starts fresh as if this one had been sent
+        grp->prepared_send = false;
+        return;
+    }
+
+    grp->serial_led_pending = true;
+    serial_led_pending = true;
+}
+
+/*
+  crc of the serial LED data of a group
+*/
+uint32_t RCOutput::serial_led_crc(const pwm_group& group) const
+{
+    uint32_t crc = 0;
+    for (uint8_t j = 0; j < 4; j++) {
+        if (group.serial_led_data[j] != nullptr) {
+            crc = crc_crc32(crc, (const uint8_t *)group.serial_led_data[j], group.serial_nleds * sizeof(SerialLed));
+        }
     }
+    return crc;
 }
 
 #endif // HAL_USE_PWM
@@ -316,6 +316,10 @@ private:
         enum output_mode led_mode;
         volatile bool serial_led_pending;
         volatile bool prepared_send;
+        // crc of the LED data last sent, so unchanged frames are not
+        // sent again
+        uint32_t serial_led_sent_crc;
+        bool serial_led_sent;
         HAL_Semaphore serial_led_mutex;
         // structure to hold serial LED data until it can be transferred
         // to the DMA buffer
@@ -350,7 +354,6 @@ private:
             uint8_t curr_telem_chan;
             uint8_t prev_telem_chan;
             uint16_t telempsc;
-            uint32_t dma_buffer_copy[GCR_TELEMETRY_BUFFER_LEN];
 #if RCOU_DSHOT_TIMING_DEBUG
             uint16_t telem_rate[4];
             uint16_t telem_err_rate[4];
@@ -571,6 +574,7 @@ private:
     bool serial_led_send(pwm_group &group);
     void serial_led_set_single_rgb_data(pwm_group& group, uint8_t idx, uint8_t led, uint8_t red, uint8_t green, uint8_t blue);
     void fill_DMA_buffer_serial_led(pwm_group& group);
+    uint32_t serial_led_crc(const pwm_group& group) const;
     volatile bool serial_led_pending;
 
     void dma_allocate(Shared_DMA *ctx);
@@ -604,6 +608,7 @@ private:
     void bdshot_ic_dma_deallocate(Shared_DMA *ctx);
     static uint32_t bdshot_decode_telemetry_packet(uint32_t* buffer, uint32_t count);
     bool bdshot_decode_dshot_telemetry(pwm_group& group, uint8_t chan);
+    void bdshot_decode_group_telemetry(pwm_group& group);
     static uint8_t bdshot_find_next_ic_channel(const pwm_group& group);
     static void bdshot_dma_ic_irq_callback(void *p, uint32_t flags);
     static void bdshot_finish_dshot_gcr_transaction(void *p);
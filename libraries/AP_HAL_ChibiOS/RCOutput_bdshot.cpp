@@ -369,8 +369,8 @@ void RCOutput::bdshot_finish_dshot_gcr_transaction(void *p)
     dmaStreamDisable(dma);
     group->bdshot.dma_tx_size = MIN(uint16_t(GCR_TELEMETRY_BIT_LEN),
         GCR_TELEMETRY_BIT_LEN - dmaStreamGetTransactionSize(dma));
-    stm32_cacheBufferInvalidate(group->dma_buffer, group->bdshot.dma_tx_size);
-    memcpy(group->bdshot.dma_buffer_copy, group->dma_buffer, sizeof(uint32_t) * group->bdshot.dma_tx_size);
+    // the capture is decoded in place from the DMA buffer by the output thread
+    // before the buffer is next written, so there is nothing more to do here
 
     group->dshot_state = DshotState::RECV_COMPLETE;
 
@@ -393,6 +393,33 @@ void RCOutput::bdshot_finish_dshot_gcr_transaction(void *p)
     chSysUnlockFromISR();
 }
 
+/*
+  decode the telemetry from the last transaction of a group if it has
+  not been decoded yet and update the per-channel frame statistics
+ */
+void RCOutput::bdshot_decode_group_telemetry(pwm_group& group)
+{
+    if (group.dshot_state != DshotState::RECV_COMPLETE) {
+        return;
+    }
+    uint8_t chan = group.chan[group.bdshot.prev_telem_chan];
+    uint32_t now = AP_HAL::millis();
+    const bool decoded = bdshot_decode_dshot_telemetry(group, group.bdshot.prev_telem_chan);
+    group.dshot_state = DshotState::IDLE;
+    if (decoded) {
+        _bdshot.erpm_clean_frames[chan]++;
+        _active_escs_mask |= (1<<chan); // we know the ESC is functional at this point
+    } else {
+        _bdshot.erpm_errors[chan]++;
+    }
+    // reset statistics periodically
+    if (now - _bdshot.erpm_last_stats_ms[chan] > 5000) {
+        _bdshot.erpm_clean_frames[chan] = 0;
+        _bdshot.erpm_errors[chan] = 0;
+        _bdshot.erpm_last_stats_ms[chan] = now;
+    }
+}
+
 /*
   decode returned data from bi-directional dshot
  */
@@ -403,9 +430,8 @@ bool RCOutput::bdshot_decode_dshot_telemetry(pwm_group& group, uint8_t chan)
     }
 
     // evaluate dshot telemetry
-    group.bdshot.erpm[chan] = bdshot_decode_telemetry_packet(group.bdshot.dma_buffer_copy, group.bdshot.dma_tx_size);
-
-    group.dshot_state = DshotState::IDLE;
+    stm32_cacheBufferInvalidate(group.dma_buffer, sizeof(uint32_t) * group.bdshot.dma_tx_size);
+    group.bdshot.erpm[chan] = bdshot_decode_telemetry_packet(group.dma_buffer, group.bdshot.dma_tx_size);
 
 #if RCOU_DSHOT_TIMING_DEBUG
     // Record Stats
@@ -425,9 +451,9 @@ bool RCOutput::bdshot_decode_dshot_telemetry(pwm_group& group, uint8_t chan)
     if (chan == DEBUG_CHANNEL && (now  - group.bdshot.last_print) > 1000000) {
         hal.console->printf("TELEM: %d <%d Hz, %.1f%% err>", group.bdshot.erpm[chan], group.bdshot.telem_rate[chan],
             100.0f * float(group.bdshot.telem_err_rate[chan]) / (group.bdshot.telem_err_rate[chan] + group.bdshot.telem_rate[chan]));
-        hal.console->printf(" %ld ", group.bdshot.dma_buffer_copy[0]);
+        hal.console->printf(" %ld ", group.dma_buffer[0]);
         for (uint8_t l = 1; l < group.bdshot.dma_tx_size; l++) {
-            hal.console->printf(" +%ld ", group.bdshot.dma_buffer_copy[l] - group.bdshot.dma_buffer_copy[l-1]);
+            hal.console->printf(" +%ld ", group.dma_buffer[l] - group.dma_buffer[l-1]);
         }
         hal.console->printf("\n");
 
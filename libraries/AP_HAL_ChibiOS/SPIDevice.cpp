@@ -168,14 +168,27 @@ void SPIDevice::set_slowdown(uint8_t slowdown)
  */
 bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
 {
-    bool old_cs_forced = cs_forced;
+    if (bus.transfer_active) {
+        // the bus is busy with an asynchronous transfer
+        return false;
+    }
+    if (!start_transfer(send, recv, len)) {
+        return false;
+    }
+    return finish_transfer();
+}
+
+/*
+  assert chip select and start a DMA transfer without waiting for it
+ */
+bool SPIDevice::start_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
+{
+    xfer.old_cs_forced = cs_forced;
 
     if (!set_chip_select(true)) {
         return false;
     }
 
-    bool ret = true;
-
 #if defined(HAL_SPI_USE_POLLED)
     for (uint32_t i=0; i<len; i++) {
         uint8_t ret = spiPolledExchange(spi_devices[device_desc.bus].driver, send?send[i]:0);
@@ -185,7 +198,7 @@ bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
     }
 #else
     if (!bus.bouncebuffer_setup(send, len, recv, len)) {
-        set_chip_select(old_cs_forced);
+        set_chip_select(xfer.old_cs_forced);
         return false;
     }
     osalSysLock();
@@ -197,23 +210,54 @@ bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
     } else {
         spiStartExchangeI(spi_devices[device_desc.bus].driver, len, send, recv);
     }
+    osalSysUnlock();
+#endif
+    xfer.send = send;
+    xfer.recv = recv;
+    xfer.len = len;
+    xfer.active = true;
+    bus.transfer_active = true;
+    return true;
+}
+
+/*
+  wait for the transfer started by start_transfer() and release chip select
+ */
+bool SPIDevice::finish_transfer(void)
+{
+    if (!xfer.active) {
+        return false;
+    }
+    xfer.active = false;
+    bus.transfer_active = false;
+
+    bool ret = true;
+
+#if !defined(HAL_SPI_USE_POLLED)
+    SPIDriver *spid = spi_devices[device_desc.bus].driver;
     // we allow SPI transfers to take a maximum of 20ms plus 32us per
     // byte. This covers all use cases in ArduPilot. We don't ever
     // expect this timeout to trigger unless there is a severe MCU
     // error
-    const uint32_t timeout_us = 20000U + len * 32U;
-    msg_t msg = osalThreadSuspendTimeoutS(&spi_devices[device_desc.bus].driver->thread, TIME_US2I(timeout_us));
+    const uint32_t timeout_us = 20000U + xfer.len * 32U;
+    msg_t msg = MSG_OK;
+    osalSysLock();
+    // the transfer may already have completed, in which case the
+    // driver won't wake us
+    if (spid->state == SPI_ACTIVE) {
+        msg = osalThreadSuspendTimeoutS(&spid->thread, TIME_US2I(timeout_us));
+    }
     osalSysUnlock();
     if (msg == MSG_TIMEOUT) {
         ret = false;
         if (!hal.scheduler->in_expected_delay()) {
             INTERNAL_ERROR(AP_InternalError::error_t::spi_fail);
         }
-        spiAbort(spi_devices[device_desc.bus].driver);
+        spiAbort(spid);
     }
-    bus.bouncebuffer_finish(send, recv, len);
+    bus.bouncebuffer_finish(xfer.send, xfer.recv, xfer.len);
 #endif
-    set_chip_select(old_cs_forced);
+    set_chip_select(xfer.old_cs_forced);
     return ret;
 }
 
@@ -303,6 +347,22 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv, uint32_t
     return ret;
 }
 
+bool SPIDevice::transfer_async_start(const uint8_t *send, uint8_t *recv, uint32_t len)
+{
+    if (!bus.semaphore.check_owner() || bus.transfer_active) {
+        return false;
+    }
+    return start_transfer(send, recv, len);
+}
+
+bool SPIDevice::transfer_async_finish()
+{
+    if (!bus.semaphore.check_owner()) {
+        return false;
+    }
+    return finish_transfer();
+}
+
 AP_HAL::Semaphore *SPIDevice::get_semaphore()
 {
     return &bus.semaphore;
@@ -38,6 +38,9 @@ public:
     bool spi_started;
     uint8_t slowdown;
 
+    // true while a device has a transfer started on the bus
+    bool transfer_active;
+
     // we need an additional lock in the dma_allocate and
     // dma_deallocate functions to cope with 3-way contention as we
     // have two DMA channels that we are handling with the shared_dma
@@ -84,6 +87,13 @@ public:
     bool transfer_fullduplex(const uint8_t *send, uint8_t *recv,
                              uint32_t len) override;
 
+    /* See AP_HAL::SPIDevice::transfer_async_start() */
+    bool transfer_async_start(const uint8_t *send, uint8_t *recv,
+                              uint32_t len) override;
+
+    /* See AP_HAL::SPIDevice::transfer_async_finish() */
+    bool transfer_async_finish() override;
+
     /*
         Links the bank select callback to the spi bus, so that even when
         used outside of the driver bank selection can be done.
@@ -147,6 +157,18 @@ private:
     uint32_t derive_freq_flag(uint32_t _frequency);
     // low level transfer function
     bool do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len) WARN_IF_UNUSED;
+    // start a transfer with chip select asserted, and wait for it to complete
+    bool start_transfer(const uint8_t *send, uint8_t *recv, uint32_t len) WARN_IF_UNUSED;
+    bool finish_transfer(void) WARN_IF_UNUSED;
+
+    // the transfer in progress between start_transfer() and finish_transfer()
+    struct {
+        const uint8_t *send;
+        uint8_t *recv;
+        uint32_t len;
+        bool old_cs_forced;
+        bool active;
+    } xfer;
 };
 
 class SPIDeviceManager : public AP_HAL::SPIDeviceManager {
@@ -22,6 +22,7 @@
 #include "Scheduler.h"
 #include "hwdef/common/flash.h"
 #include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Common/ExpandingString.h>
 #include <stdio.h>
 
 using namespace ChibiOS;
@@ -214,6 +215,11 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
     if (length == 0) {
         return;
     }
+    const uint32_t now = AP_HAL::millis();
+    if (_dirty_mask.empty()) {
+        _first_dirty_ms = now;
+    }
+    _last_dirty_ms = now;
     uint16_t end = loc + length - 1;
     for (uint16_t line=loc>>CH_STORAGE_LINE_SHIFT;
          line <= end>>CH_STORAGE_LINE_SHIFT;
@@ -251,11 +257,27 @@ void Storage::_timer_tick(void)
     }
     if (_dirty_mask.empty()) {
         _last_empty_ms = AP_HAL::millis();
+#ifdef STORAGE_FLASH_PAGE
+        if (_initialisedType == StorageBackend::Flash) {
+            _flash_erase_idle();
+        }
+#endif
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        // let a burst of changes settle so it is written once
+        const uint32_t now = AP_HAL::millis();
+        if (now - _last_dirty_ms < HAL_STORAGE_FLASH_WRITE_DELAY_MS &&
+            now - _first_dirty_ms < HAL_STORAGE_FLASH_WRITE_DELAY_MAX_MS) {
+            return;
+        }
+    }
+#endif
+
+    // write out the first run of adjacent dirty lines. We limit the
+    // length of the run to keep the latency of this call to a minimum
     uint16_t i;
     for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -266,18 +288,26 @@ void Storage::_timer_tick(void)
         // this shouldn't be possible
         return;
     }
+    uint16_t nlines = 1;
+    while (nlines < HAL_STORAGE_WRITE_BATCH_LINES &&
+           i+nlines < CH_STORAGE_NUM_LINES &&
+           _dirty_mask.get(i+nlines)) {
+        nlines++;
+    }
+    const uint32_t offset = CH_STORAGE_LINE_SIZE*i;
+    const uint16_t length = CH_STORAGE_LINE_SIZE*nlines;
 
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmpline, &_buffer[offset], length);
     }
 
     bool write_ok = false;
 
 #if HAL_WITH_RAMTRON
     if (_initialisedType == StorageBackend::FRAM) {
-        if (fram.write(CH_STORAGE_LINE_SIZE*i, tmpline, CH_STORAGE_LINE_SIZE)) {
+        if (fram.write(offset, tmpline, length)) {
             write_ok = true;
         }
     }
@@ -285,11 +315,10 @@ void Storage::_timer_tick(void)
 
 #ifdef USE_POSIX
     if ((_initialisedType == StorageBackend::SDCard) && log_fd != -1) {
-        uint32_t offset = CH_STORAGE_LINE_SIZE*i;
         if (AP::FS().lseek(log_fd, offset, SEEK_SET) != offset) {
             return;
         }
-        if (AP::FS().write(log_fd, &_buffer[offset], CH_STORAGE_LINE_SIZE) != CH_STORAGE_LINE_SIZE) {
+        if (AP::FS().write(log_fd, tmpline, length) != length) {
             return;
         }
         if (AP::FS().fsync(log_fd) != 0) {
@@ -302,7 +331,7 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, nlines)) {
             write_ok = true;
         }
     }
@@ -310,14 +339,16 @@ void Storage::_timer_tick(void)
 
     if (write_ok) {
         WITH_SEMAPHORE(sem);
-        // while holding the semaphore we check if the copy of the
+        // while holding the semaphore we check if the copy of each
         // line is different from the original line. If it is
         // different then someone has re-dirtied the line while we
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t l=0; l<nlines; l++) {
+            if (memcmp(&tmpline[CH_STORAGE_LINE_SIZE*l], &_buffer[offset+CH_STORAGE_LINE_SIZE*l], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+l);
+            }
         }
     }
 }
@@ -341,17 +372,40 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write nlines adjacent storage lines
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
 #ifdef STORAGE_FLASH_PAGE
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, nlines*CH_STORAGE_LINE_SIZE);
 #else
     return false;
 #endif
 }
 
+/*
+  erase a full flash sector while disarmed and idle, so that the next
+  sector switch doesn't need to stop the CPU for an erase
+*/
+void Storage::_flash_erase_idle(void)
+{
+#ifdef STORAGE_FLASH_PAGE
+    if (!_flash.have_full_sector() || !_flash_erase_ok()) {
+        return;
+    }
+    const uint32_t now = AP_HAL::millis();
+    if (now - hal.util->get_last_armed_change() < HAL_STORAGE_FLASH_ERASE_IDLE_MS ||
+        now - _last_dirty_ms < HAL_STORAGE_FLASH_ERASE_IDLE_MS ||
+        now - _last_erase_attempt_ms < HAL_STORAGE_FLASH_ERASE_IDLE_MS) {
+        return;
+    }
+    _last_erase_attempt_ms = now;
+    if (!_flash.erase_full_sector()) {
+        ::printf("Storage: failed to erase full sector\n");
+    }
+#endif
+}
+
 /*
   callback to write data to flash
  */
@@ -446,6 +500,25 @@ bool Storage::healthy(void)
             (AP_HAL::millis() - _last_empty_ms < 2000u));
 }
 
+/*
+  get write and erase statistics
+ */
+void Storage::storage_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("StorageV1\n");
+    str.printf("dirty_lines=%u\n", unsigned(_dirty_mask.count()));
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        const AP_FlashStorage::Stats &stats = _flash.get_stats();
+        str.printf("flash_pages=%u,%u writes=%u bytes=%u erases=%u stalls=%u\n",
+                   unsigned(_flash_page), unsigned(_flash_page+1),
+                   unsigned(stats.writes), unsigned(stats.bytes),
+                   unsigned(stats.erases), unsigned(stats.stalls));
+    }
+#endif
+}
+
 /*
   erase all storage
  */
@@ -37,6 +37,30 @@
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
+// maximum number of adjacent dirty lines written by one _timer_tick()
+#ifndef HAL_STORAGE_WRITE_BATCH_LINES
+#define HAL_STORAGE_WRITE_BATCH_LINES 8
+#endif
+
+// flash writes wait until storage has been unchanged for this long,
+// so a burst of changes such as parameter saves while tuning is
+// written as fewer, larger records
+#ifndef HAL_STORAGE_FLASH_WRITE_DELAY_MS
+#define HAL_STORAGE_FLASH_WRITE_DELAY_MS 100
+#endif
+
+// but changes are never held back for longer than this
+#ifndef HAL_STORAGE_FLASH_WRITE_DELAY_MAX_MS
+#define HAL_STORAGE_FLASH_WRITE_DELAY_MAX_MS 1000
+#endif
+
+// once disarmed with nothing to write for this long a full flash
+// sector is erased, so storage can switch sectors in flight without
+// an erase
+#ifndef HAL_STORAGE_FLASH_ERASE_IDLE_MS
+#define HAL_STORAGE_FLASH_ERASE_IDLE_MS 5000
+#endif
+
 class ChibiOS::Storage : public AP_HAL::Storage {
 public:
     void init() override {}
@@ -47,6 +71,9 @@ public:
     void _timer_tick(void) override;
     bool healthy(void) override;
 
+    // get write and erase statistics
+    void storage_info(ExpandingString &str) override;
+
 private:
     enum class StorageBackend: uint8_t {
         None,
@@ -62,7 +89,7 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmpline[CH_STORAGE_LINE_SIZE*HAL_STORAGE_WRITE_BATCH_LINES];
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -72,6 +99,9 @@ private:
     bool _flash_failed;
     uint32_t _last_re_init_ms;
     uint32_t _last_empty_ms;
+    uint32_t _first_dirty_ms;
+    uint32_t _last_dirty_ms;
+    uint32_t _last_erase_attempt_ms;
 
 #ifdef STORAGE_FLASH_PAGE
     AP_FlashStorage _flash{_buffer,
@@ -83,7 +113,8 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t nlines);
+    void _flash_erase_idle(void);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
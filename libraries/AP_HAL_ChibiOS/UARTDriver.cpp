@@ -290,12 +290,18 @@ void UARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
 
 #ifndef HAL_UART_NODMA
     if (!half_duplex && !(_last_options & OPTION_NODMA_RX)) {
+#if HAL_UART_DMA_RX_CIRCULAR
+        if (rx_bounce_buf[0] == nullptr && sdef.dma_rx) {
+            rx_bounce_buf[0] = (uint8_t *)hal.util->malloc_type(RX_DMA_RING_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
+        }
+#else
         if (rx_bounce_buf[0] == nullptr && sdef.dma_rx) {
             rx_bounce_buf[0] = (uint8_t *)hal.util->malloc_type(RX_BOUNCE_BUFSIZE, AP_HAL::Util::MEM_DMA_SAFE);
         }
         if (rx_bounce_buf[1] == nullptr && sdef.dma_rx) {
             rx_bounce_buf[1] = (uint8_t *)hal.util->malloc_type(RX_BOUNCE_BUFSIZE, AP_HAL::Util::MEM_DMA_SAFE);
         }
+#endif
     }
     if (tx_bounce_buf == nullptr && sdef.dma_tx && !(_last_options & OPTION_NODMA_TX)) {
         tx_bounce_buf = (uint8_t *)hal.util->malloc_type(TX_BOUNCE_BUFSIZE, AP_HAL::Util::MEM_DMA_SAFE);
@@ -303,9 +309,17 @@ void UARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
     if (half_duplex) {
         rx_dma_enabled = tx_dma_enabled = false;
     } else {
+#if HAL_UART_DMA_RX_CIRCULAR
+        rx_dma_enabled = rx_bounce_buf[0] != nullptr;
+#else
         rx_dma_enabled = rx_bounce_buf[0] != nullptr && rx_bounce_buf[1] != nullptr;
+#endif
         tx_dma_enabled = tx_bounce_buf != nullptr;
     }
+    // note when we wanted DMA but could not get DMA-safe memory for
+    // the bounce buffers, so it shows up in uart_info()
+    rx_dma_alloc_failed = sdef.dma_rx && !rx_dma_enabled && !half_duplex && !(_last_options & OPTION_NODMA_RX);
+    tx_dma_alloc_failed = sdef.dma_tx && !tx_dma_enabled && !half_duplex && !(_last_options & OPTION_NODMA_TX);
 #endif
 
     /*
@@ -471,14 +485,72 @@ void UARTDriver::dma_rx_enable(void)
 #if defined(STM32H7)
     dmamode |= 1<<20;   // TRBUFF See 2.3.1 in the H743 errata
 #endif
+#if HAL_UART_DMA_RX_CIRCULAR
+    rx_ring_tail = 0;
+    stm32_cacheBufferInvalidate(rx_bounce_buf[0], RX_DMA_RING_SIZE);
+    dmaStreamSetMemory0(rxdma, rx_bounce_buf[0]);
+    dmaStreamSetTransactionSize(rxdma, RX_DMA_RING_SIZE);
+    dmaStreamSetMode(rxdma, dmamode | STM32_DMA_CR_DIR_P2M |
+                     STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC |
+                     STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+#else
     rx_bounce_idx ^= 1;
     stm32_cacheBufferInvalidate(rx_bounce_buf[rx_bounce_idx], RX_BOUNCE_BUFSIZE);
     dmaStreamSetMemory0(rxdma, rx_bounce_buf[rx_bounce_idx]);
     dmaStreamSetTransactionSize(rxdma, RX_BOUNCE_BUFSIZE);
     dmaStreamSetMode(rxdma, dmamode | STM32_DMA_CR_DIR_P2M |
                      STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
+#endif
     dmaStreamEnable(rxdma);
 }
+
+#if HAL_UART_DMA_RX_CIRCULAR
+/*
+  copy the data received since the last call out of the circular DMA
+  buffer. Must be called with the system locked
+ */
+void UARTDriver::rx_ring_drain(void)
+{
+    const uint16_t head = (RX_DMA_RING_SIZE - dmaStreamGetTransactionSize(rxdma)) % RX_DMA_RING_SIZE;
+    const uint16_t tail = rx_ring_tail;
+    if (head == tail) {
+        return;
+    }
+    const uint8_t *ring = rx_bounce_buf[0];
+    stm32_cacheBufferInvalidate(ring, RX_DMA_RING_SIZE);
+    uint16_t len;
+    if (head > tail) {
+        len = head - tail;
+        _readbuf.write(&ring[tail], len);
+    } else {
+        // the DMA has wrapped around
+        len = RX_DMA_RING_SIZE - tail;
+        _readbuf.write(&ring[tail], len);
+        _readbuf.write(ring, head);
+        len += head;
+    }
+    rx_ring_tail = head;
+    _rx_stats_bytes += len;
+    receive_timestamp_update();
+}
+
+// drain the circular buffer from an interrupt and wake any waiting reader
+void UARTDriver::rx_ring_drain_from_isr(void)
+{
+    chSysLockFromISR();
+    rx_ring_drain();
+    if (_wait.thread_ctx && _readbuf.available() >= _wait.n) {
+        chEvtSignalI(_wait.thread_ctx, EVT_DATA);
+    }
+    chSysUnlockFromISR();
+    if (_rts_is_active) {
+        update_rts_line();
+    }
+    if (_readbuf.available() > 0) {
+        signal_rx_event(true);
+    }
+}
+#endif // HAL_UART_DMA_RX_CIRCULAR
 #endif
 
 void UARTDriver::dma_tx_deallocate(Shared_DMA *ctx)
@@ -497,7 +569,18 @@ void UARTDriver::rx_irq_cb(void* self)
     if (!uart_drv->rx_dma_enabled) {
         return;
     }
-#if defined(STM32F7) || defined(STM32H7)
+#if HAL_UART_DMA_RX_CIRCULAR
+#if !defined(STM32F7) && !defined(STM32H7) && !defined(STM32F3) && !defined(STM32G4)
+    volatile uint16_t sr = ((SerialDriver*)(uart_drv->sdef.serial))->usart->SR;
+    if (!(sr & USART_SR_IDLE)) {
+        return;
+    }
+    volatile uint16_t dr = ((SerialDriver*)(uart_drv->sdef.serial))->usart->DR;
+    (void)dr;
+#endif
+    // the DMA keeps running, collect what it has received so far
+    uart_drv->rx_ring_drain_from_isr();
+#elif defined(STM32F7) || defined(STM32H7)
     //disable dma, triggering DMA transfer complete interrupt
     uart_drv->rxdma->stream->CR &= ~STM32_DMA_CR_EN;
 #elif defined(STM32F3) || defined(STM32G4)
@@ -527,6 +610,10 @@ void UARTDriver::rxbuff_full_irq(void* self, uint32_t flags)
     if (!uart_drv->rx_dma_enabled) {
         return;
     }
+#if HAL_UART_DMA_RX_CIRCULAR
+    // half or full transfer of the circular buffer, the DMA keeps running
+    uart_drv->rx_ring_drain_from_isr();
+#else
     uint16_t len = RX_BOUNCE_BUFSIZE - dmaStreamGetTransactionSize(uart_drv->rxdma);
     const uint8_t bounce_idx = uart_drv->rx_bounce_idx;
 
@@ -543,6 +630,7 @@ void UARTDriver::rxbuff_full_irq(void* self, uint32_t flags)
          */
         uart_drv->_readbuf.write(uart_drv->rx_bounce_buf[bounce_idx], len);
         uart_drv->receive_timestamp_update();
+        uart_drv->signal_rx_event(true);
     }
 
     if (uart_drv->_wait.thread_ctx && uart_drv->_readbuf.available() >= uart_drv->_wait.n) {
@@ -553,6 +641,7 @@ void UARTDriver::rxbuff_full_irq(void* self, uint32_t flags)
     if (uart_drv->_rts_is_active) {
         uart_drv->update_rts_line();
     }
+#endif // HAL_UART_DMA_RX_CIRCULAR
 #endif // HAL_USE_SERIAL
 }
 #endif // HAL_UART_NODMA
@@ -621,6 +710,14 @@ uint32_t UARTDriver::available() {
         }
 #endif
     }
+#if !defined(HAL_UART_NODMA) && HAL_UART_DMA_RX_CIRCULAR
+    if (rx_dma_enabled && rxdma) {
+        // include bytes the DMA has received but not yet signalled
+        chSysLock();
+        rx_ring_drain();
+        chSysUnlock();
+    }
+#endif
     return _readbuf.available();
 }
 
@@ -784,6 +881,40 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve space for an in-place write. The write mutex is held until
+  write_commit()
+ */
+uint8_t UARTDriver::write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_tx_initialised || lock_write_key != 0 || (_blocking_writes && !unbuffered_writes)) {
+        return 0;
+    }
+    _write_mutex.take_blocking();
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t n_vec = _writebuf.reserve(vec, len);
+    if (n_vec == 0) {
+        _write_mutex.give();
+    }
+    return n_vec;
+}
+
+/*
+  complete an in-place write started with write_reserve()
+ */
+bool UARTDriver::write_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    if (unbuffered_writes) {
+        chEvtSignal(uart_thread_ctx, EVT_TRANSMIT_DATA_READY);
+    }
+    _write_mutex.give();
+    return ret;
+}
+
 /*
   lock the uart for exclusive use by write_locked() and read_locked() with the right key
  */
@@ -835,6 +966,41 @@ bool UARTDriver::wait_timeout(uint16_t n, uint32_t timeout_ms)
     return available() >= n;
 }
 
+#if CH_CFG_USE_EVENTS == TRUE
+ChibiOS::EventSource UARTDriver::evt_src;
+
+/*
+  set an event handle to be signalled when incoming data arrives. One
+  handle may be used for several UARTs
+ */
+bool UARTDriver::set_event_handle(AP_HAL::EventHandle *evt_handle)
+{
+    if (evt_handle == nullptr) {
+        return false;
+    }
+    if (evt_handle->get_source() != &evt_src && !evt_handle->set_source(&evt_src)) {
+        return false;
+    }
+    _event_handle = evt_handle;
+    return evt_handle->register_event(1U << serial_num);
+}
+#endif
+
+// wake a reader waiting for incoming data on the event handle
+void UARTDriver::signal_rx_event(bool from_isr)
+{
+#if CH_CFG_USE_EVENTS == TRUE
+    if (_event_handle == nullptr) {
+        return;
+    }
+    if (from_isr) {
+        evt_src.signalI(1U << serial_num);
+    } else {
+        evt_src.signal(1U << serial_num);
+    }
+#endif
+}
+
 #ifndef HAL_UART_NODMA
 #pragma GCC diagnostic push
 #pragma GCC diagnostic error "-Wframe-larger-than=128"
@@ -1143,6 +1309,18 @@ void UARTDriver::_rx_timer_tick(void)
 #else
         bool enabled = (rxdma->stream->CR & STM32_DMA_CR_EN);
 #endif
+#if HAL_UART_DMA_RX_CIRCULAR
+        // pick up data that hasn't reached an idle line or half buffer yet
+        rx_ring_drain();
+        if (_rts_is_active) {
+            update_rts_line();
+        }
+        if (!enabled) {
+            // the DMA stops on a transfer error, restart it
+            dmaStreamDisable(rxdma);
+            dma_rx_enable();
+        }
+#else
         if (!enabled) {
             uint8_t len = RX_BOUNCE_BUFSIZE - dmaStreamGetTransactionSize(rxdma);
             if (len != 0) {
@@ -1159,6 +1337,7 @@ void UARTDriver::_rx_timer_tick(void)
             dmaStreamDisable(rxdma);
             dma_rx_enable();
         }
+#endif // HAL_UART_DMA_RX_CIRCULAR
         chSysUnlock();
     }
 #endif
@@ -1186,6 +1365,9 @@ void UARTDriver::_rx_timer_tick(void)
     if (_wait.thread_ctx && _readbuf.available() >= _wait.n) {
         chEvtSignal(_wait.thread_ctx, EVT_DATA);
     }
+    if (_readbuf.available() > 0) {
+        signal_rx_event(false);
+    }
     _in_rx_timer = false;
 }
 
@@ -1279,6 +1461,9 @@ void UARTDriver::_tx_timer_tick(void)
         if (_wait.thread_ctx && _readbuf.available() >= _wait.n) {
             chEvtSignal(_wait.thread_ctx, EVT_DATA);
         }
+        if (_readbuf.available() > 0) {
+            signal_rx_event(false);
+        }
         _in_rx_timer = false;
     }
 
@@ -1687,10 +1872,11 @@ void UARTDriver::uart_info(ExpandingString &str)
     } else {
         str.printf("UART%u ", unsigned(sdef.instance));
     }
+    // '*' marks DMA in use, '!' marks DMA wanted but not allocated
     str.printf("TX%c=%8u RX%c=%8u TXBD=%6u RXBD=%6u\n",
-               tx_dma_enabled ? '*' : ' ',
+               tx_dma_enabled ? '*' : (tx_dma_alloc_failed ? '!' : ' '),
                unsigned(_tx_stats_bytes),
-               rx_dma_enabled ? '*' : ' ',
+               rx_dma_enabled ? '*' : (rx_dma_alloc_failed ? '!' : ' '),
                unsigned(_rx_stats_bytes),
                unsigned(_tx_stats_bytes * 10000 / (now_ms - _last_stats_ms)),
                unsigned(_rx_stats_bytes * 10000 / (now_ms - _last_stats_ms)));
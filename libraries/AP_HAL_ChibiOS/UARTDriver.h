@@ -21,10 +21,23 @@
 #include "AP_HAL_ChibiOS.h"
 #include "shared_dma.h"
 #include "Semaphores.h"
+#include "EventSource.h"
 
 #define RX_BOUNCE_BUFSIZE 64U
 #define TX_BOUNCE_BUFSIZE 64U
 
+/*
+  receive DMA into a circular buffer which runs continuously, rather
+  than into bounce buffers which are swapped and re-armed on every idle
+  line or full buffer. New data is found from the DMA transfer count
+ */
+#ifndef HAL_UART_DMA_RX_CIRCULAR
+#define HAL_UART_DMA_RX_CIRCULAR 0
+#endif
+
+// size of the circular receive DMA buffer, interrupts come at each half
+#define RX_DMA_RING_SIZE (4*RX_BOUNCE_BUFSIZE)
+
 // enough for uartA to uartI, plus IOMCU
 #define UART_MAX_DRIVERS 10
 
@@ -59,6 +72,8 @@ public:
 
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
+    uint8_t write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool write_commit(uint32_t len) override;
 
     // lock a port for exclusive use. Use a key of 0 to unlock
     bool lock_port(uint32_t write_key, uint32_t read_key) override;
@@ -98,6 +113,10 @@ public:
 
     bool wait_timeout(uint16_t n, uint32_t timeout_ms) override;
 
+#if CH_CFG_USE_EVENTS == TRUE
+    bool set_event_handle(AP_HAL::EventHandle *evt_handle) override;
+#endif
+
     void set_flow_control(enum flow_control flow_control) override;
     enum flow_control get_flow_control(void) override { return _flow_control; }
 
@@ -141,6 +160,9 @@ private:
     const SerialDef &sdef;
     bool rx_dma_enabled;
     bool tx_dma_enabled;
+    // DMA wanted but no DMA-safe memory for bounce buffers
+    bool rx_dma_alloc_failed;
+    bool tx_dma_alloc_failed;
 
     /*
       copy of rx_line and tx_line with alternative configs resolved
@@ -178,11 +200,21 @@ private:
         uint16_t n;
     } _wait;
 
+#if CH_CFG_USE_EVENTS == TRUE
+    // handle to signal on incoming data, the UARTs share one event source with an event bit each
+    AP_HAL::EventHandle *_event_handle;
+    static ChibiOS::EventSource evt_src;
+#endif
+
     // we use in-task ring buffers to reduce the system call cost
     // of ::read() and ::write() in the main loop
 #ifndef HAL_UART_NODMA
     volatile uint8_t rx_bounce_idx;
     uint8_t *rx_bounce_buf[2];
+#if HAL_UART_DMA_RX_CIRCULAR
+    // rx_bounce_buf[0] is the circular buffer, this is where the next read from it starts
+    volatile uint16_t rx_ring_tail;
+#endif
     uint8_t *tx_bounce_buf;
     uint16_t contention_counter;
 #endif
@@ -254,6 +286,10 @@ private:
     void dma_tx_allocate(Shared_DMA *ctx);
     void dma_tx_deallocate(Shared_DMA *ctx);
     void dma_rx_enable(void);
+#if HAL_UART_DMA_RX_CIRCULAR
+    void rx_ring_drain(void);
+    void rx_ring_drain_from_isr(void);
+#endif
 #endif
     void update_rts_line(void);
 
@@ -267,6 +303,9 @@ private:
 
     void receive_timestamp_update(void);
 
+    // wake a reader waiting for incoming data on the event handle
+    void signal_rx_event(bool from_isr);
+
     // set SERIALn_OPTIONS for pullup/pulldown
     void set_pushpull(uint16_t options);
 
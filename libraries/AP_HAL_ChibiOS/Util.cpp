@@ -28,6 +28,8 @@
 #include <AP_Common/ExpandingString.h>
 #include "sdcard.h"
 #include "shared_dma.h"
+#include "Device.h"
+#include "Profiler.h"
 #include <AP_Common/ExpandingString.h>
 #if defined(HAL_PWM_ALARM) || HAL_DSHOT_ALARM || HAL_CANMANAGER_ENABLED
 #include <AP_Notify/AP_Notify.h>
@@ -464,6 +466,13 @@ void Util::mem_info(ExpandingString &str)
                    unsigned(regions[i].address), unsigned(regions[i].size/1024),
                    unsigned(totalp), unsigned(largest), unsigned(regions[i].flags));
     }
+
+    struct dma_alloc_info dinfo;
+    malloc_dma_info(&dinfo);
+    str.printf("DMA_RESERVE LEN=%5u FREE=%6u LRG=%6u USED=%u FAIL=%u FAILMAX=%u\n",
+               unsigned(dinfo.reserve_size), unsigned(dinfo.reserve_free),
+               unsigned(dinfo.reserve_largest), unsigned(dinfo.reserve_allocs),
+               unsigned(dinfo.failed_allocs), unsigned(dinfo.failed_largest));
 }
 #endif
 
@@ -599,3 +608,193 @@ void Util::uart_info(ExpandingString &str)
 #endif
 #endif // HAL_NO_UARTDRIVER
 }
+
+#if HAL_PROFILER_ENABLED
+// request the PC sampling profile since the last call
+void Util::profile_info(ExpandingString &str)
+{
+    Profiler::info(str);
+}
+#endif
+
+#if HAL_ENABLE_THREAD_STATISTICS && defined(HAL_EXPECTED_SYSCLOCK)
+/*
+  get statistics on the idx'th thread, from the counters kept by the
+  context switch and trace hooks in chconf.h
+ */
+bool Util::thread_stats(uint8_t idx, ThreadStats &stats, bool reset_max)
+{
+    const uint32_t cycles_per_us = HAL_EXPECTED_SYSCLOCK / 1000000U;
+    uint8_t i = 0;
+    for (thread_t *tp = chRegFirstThread(); tp; tp = chRegNextThread(tp), i++) {
+        if (i != idx) {
+            continue;
+        }
+        chSysLock();
+        const uint64_t run_cycles = tp->run_cycles;
+        const uint32_t latency_max = tp->latency_max;
+        stats.switch_count = tp->switch_count;
+        if (reset_max) {
+            tp->latency_max = 0;
+        }
+        chSysUnlock();
+        stats.name = tp->name != nullptr ? tp->name : "?";
+        stats.priority = tp->realprio;
+        stats.run_us = run_cycles / cycles_per_us;
+        stats.latency_max_us = latency_max / cycles_per_us;
+        stats.stack_free = stack_free(tp->wabase);
+        chRegReleaseThread(tp);
+        return true;
+    }
+    return false;
+}
+#endif
+
+#if HAL_USE_I2C == TRUE || HAL_USE_SPI == TRUE || HAL_USE_WSPI == TRUE
+// get statistics on the idx'th device periodic callback
+bool Util::periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max)
+{
+    return ChibiOS::DeviceBus::periodic_callback_stats(idx, stats, reset_max);
+}
+#endif
+
+#if HAL_CRC_HW_ENABLED
+/*
+  claim the CRC unit and set it up for one calculation. Fails from
+  interrupt context or when another thread has it, so callers fall
+  back to software rather than wait
+ */
+bool Util::crc_hw_start(uint32_t poly, uint32_t polysize, uint32_t init, bool reflect)
+{
+    if (port_is_isr_context() || !crc_sem.take_nonblocking()) {
+        return false;
+    }
+#if defined(STM32H7)
+    RCC->AHB4ENR |= RCC_AHB4ENR_CRCEN;
+#else
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+#endif
+    CRC->POL = poly;
+    CRC->INIT = init;
+    CRC->CR = polysize | (reflect ? (CRC_CR_REV_IN_0 | CRC_CR_REV_OUT) : 0) | CRC_CR_RESET;
+    return true;
+}
+
+/*
+  feed bytes through the CRC unit in order, using word writes for the
+  aligned part. With by-byte input reversal a byte swapped word is
+  processed first byte first, the same as four byte writes
+ */
+uint32_t Util::crc_hw_update(const uint8_t *buf, uint32_t size)
+{
+    while (size > 0 && (uintptr_t(buf) & 3U) != 0) {
+        *(volatile uint8_t *)&CRC->DR = *buf++;
+        size--;
+    }
+    while (size >= 4) {
+        CRC->DR = __REV(*(const uint32_t *)buf);
+        buf += 4;
+        size -= 4;
+    }
+    while (size--) {
+        *(volatile uint8_t *)&CRC->DR = *buf++;
+    }
+    const uint32_t ret = CRC->DR;
+    crc_sem.give();
+    return ret;
+}
+
+/*
+  crc_crc32() is the reflected form of the 0x04C11DB7 polynomial, so
+  reverse the input bytes and the result, and start from the bit
+  reversed crc
+ */
+bool Util::crc32_hw(uint32_t &crc, const uint8_t *buf, uint32_t size)
+{
+    if (!crc_hw_start(0x04C11DB7, 0, __RBIT(crc), true)) {
+        return false;
+    }
+    crc = crc_hw_update(buf, size);
+    return true;
+}
+
+bool Util::crc16_ccitt_hw(uint16_t &crc, const uint8_t *buf, uint32_t size)
+{
+    if (!crc_hw_start(0x1021, CRC_CR_POLYSIZE_0, crc, false)) {
+        return false;
+    }
+    crc = crc_hw_update(buf, size) & 0xFFFF;
+    return true;
+}
+#endif // HAL_CRC_HW_ENABLED
+
+#if HAL_SHA256_HW_ENABLED
+/*
+  claim the HASH unit for one SHA-256. As with the CRC unit callers
+  fall back to software rather than wait for it
+ */
+bool Util::sha256_hw_start()
+{
+    if (port_is_isr_context() || !hash_sem.take_nonblocking()) {
+        return false;
+    }
+    if (hash_busy) {
+        hash_sem.give();
+        return false;
+    }
+    hash_busy = true;
+    hash_pending_len = 0;
+    RCC->AHB2ENR |= RCC_AHB2ENR_HASHEN;
+    // SHA-256 hash mode with byte data, so little endian words read
+    // from memory are hashed first byte first
+    HASH->CR = HASH_CR_ALGO | HASH_CR_DATATYPE_1 | HASH_CR_INIT;
+    return true;
+}
+
+/*
+  writes to DIN stall the bus while the unit is busy with a block, so
+  there is no need to poll
+ */
+void Util::sha256_hw_update(const uint8_t *buf, uint32_t size)
+{
+    while (size > 0 && hash_pending_len != 0) {
+        hash_pending.b[hash_pending_len++] = *buf++;
+        size--;
+        if (hash_pending_len == 4) {
+            HASH->DIN = hash_pending.w;
+            hash_pending_len = 0;
+        }
+    }
+    while (size >= 4) {
+        uint32_t w;
+        memcpy(&w, buf, 4);
+        HASH->DIN = w;
+        buf += 4;
+        size -= 4;
+    }
+    while (size--) {
+        hash_pending.b[hash_pending_len++] = *buf++;
+    }
+}
+
+void Util::sha256_hw_finish(uint8_t *digest, uint8_t len)
+{
+    // the number of valid bits in the last word is set before it is
+    // written, 0 meaning all 32
+    HASH->STR = hash_pending_len * 8U;
+    if (hash_pending_len != 0) {
+        HASH->DIN = hash_pending.w;
+    }
+    HASH->STR = (hash_pending_len * 8U) | HASH_STR_DCAL;
+
+    // the last block takes well under a microsecond
+    for (uint32_t i=0; i<10000 && (HASH->SR & HASH_SR_DCIS) == 0; i++) {
+    }
+    for (uint8_t i=0; i<len; i += 4) {
+        const uint32_t w = __REV(HASH_DIGEST->HR[i/4]);
+        memcpy(&digest[i], &w, MIN(4, len - i));
+    }
+    hash_busy = false;
+    hash_sem.give();
+}
+#endif // HAL_SHA256_HW_ENABLED
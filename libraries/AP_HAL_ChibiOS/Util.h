@@ -30,6 +30,18 @@ class ExpandingString;
 #define HAL_ENABLE_SAVE_PERSISTENT_PARAMS !defined(HAL_BOOTLOADER_BUILD) && !defined(HAL_BUILD_AP_PERIPH) && (defined(STM32F7) || defined(STM32H7))
 #endif
 
+#ifndef HAL_CRC_HW_ENABLED
+// F7 and H7 have a CRC unit with programmable polynomial and bit
+// reversal, so it can produce the CRCs used in AP_Math/crc.h
+#define HAL_CRC_HW_ENABLED !defined(HAL_BOOTLOADER_BUILD) && (defined(STM32F7) || defined(STM32H7))
+#endif
+
+#ifndef HAL_SHA256_HW_ENABLED
+// only some H7 parts (H750, H753, H7A3, ...) have the HASH unit, the
+// CMSIS device header defines HASH on those
+#define HAL_SHA256_HW_ENABLED !defined(HAL_BOOTLOADER_BUILD) && defined(STM32H7) && defined(HASH)
+#endif
+
 class ChibiOS::Util : public AP_HAL::Util {
 public:
     static Util *from(AP_HAL::Util *util) {
@@ -89,8 +101,53 @@ public:
 #endif
     // request information on uart I/O
     virtual void uart_info(ExpandingString &str) override;
+
+#if HAL_PROFILER_ENABLED
+    // request the PC sampling profile since the last call
+    void profile_info(ExpandingString &str) override;
+#endif
+
+#if HAL_ENABLE_THREAD_STATISTICS && defined(HAL_EXPECTED_SYSCLOCK)
+    // get statistics on the idx'th thread
+    bool thread_stats(uint8_t idx, ThreadStats &stats, bool reset_max) override;
+#endif
+
+#if HAL_USE_I2C == TRUE || HAL_USE_SPI == TRUE || HAL_USE_WSPI == TRUE
+    // get statistics on the idx'th device periodic callback
+    bool periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max) override;
+#endif
+
+#if HAL_CRC_HW_ENABLED
+    bool crc32_hw(uint32_t &crc, const uint8_t *buf, uint32_t size) override;
+    bool crc16_ccitt_hw(uint16_t &crc, const uint8_t *buf, uint32_t size) override;
+#endif
+
+#if HAL_SHA256_HW_ENABLED
+    bool sha256_hw_start() override;
+    void sha256_hw_update(const uint8_t *buf, uint32_t size) override;
+    void sha256_hw_finish(uint8_t *digest, uint8_t len) override;
+#endif
     
 private:
+#if HAL_CRC_HW_ENABLED
+    // the CRC unit is shared between threads
+    HAL_Semaphore crc_sem;
+    bool crc_hw_start(uint32_t poly, uint32_t polysize, uint32_t init, bool reflect);
+    uint32_t crc_hw_update(const uint8_t *buf, uint32_t size);
+#endif
+#if HAL_SHA256_HW_ENABLED
+    // the HASH unit is held from sha256_hw_start() to
+    // sha256_hw_finish(). The semaphore is recursive, so hash_busy
+    // stops a nested hash in the same thread
+    HAL_Semaphore hash_sem;
+    bool hash_busy;
+    // bytes not yet making up a whole word for the HASH unit
+    union {
+        uint8_t b[4];
+        uint32_t w;
+    } hash_pending;
+    uint8_t hash_pending_len;
+#endif
 #ifdef HAL_PWM_ALARM
     struct ToneAlarmPwmGroup {
         pwmchannel_t chan;
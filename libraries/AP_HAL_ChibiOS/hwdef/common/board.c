@@ -246,7 +246,27 @@ void __early_init(void) {
 #endif
 }
 
+#ifdef HAL_ITCM_CODE_KB
+/*
+  copy the functions marked __FASTRAMFUNC__ from flash to ITCM. This
+  must happen before any of them is called
+ */
+static void itcm_code_init(void) {
+  extern uint32_t __fastramfunc_load__, __fastramfunc_base__, __fastramfunc_end__;
+  const uint32_t *src = &__fastramfunc_load__;
+  uint32_t *dst = &__fastramfunc_base__;
+  while (dst < &__fastramfunc_end__) {
+    *dst++ = *src++;
+  }
+  __DSB();
+  __ISB();
+}
+#endif
+
 void __late_init(void) {
+#ifdef HAL_ITCM_CODE_KB
+  itcm_code_init();
+#endif
   halInit();
   chSysInit();
   stm32_watchdog_save_reason();
@@ -72,6 +72,9 @@ extern "C" {
 
 #if HAL_ENABLE_THREAD_STATISTICS
 #define CH_DBG_STATISTICS TRUE
+// trace ready events so the trace hook can time the wait to run
+#define CH_DBG_TRACE_MASK CH_DBG_TRACE_MASK_READY
+#define CH_DBG_TRACE_BUFFER_SIZE 16
 #else
 #define CH_DBG_STATISTICS FALSE
 #endif
@@ -671,8 +674,14 @@ extern "C" {
  * @brief   System structure extension.
  * @details User fields added to the end of the @p ch_system_t structure.
  */
+#if HAL_ENABLE_THREAD_STATISTICS
+#define CH_CFG_SYSTEM_EXTRA_FIELDS                                          \
+  /* realtime counter at the last context switch */                         \
+  rtcnt_t               switch_rtc;
+#else
 #define CH_CFG_SYSTEM_EXTRA_FIELDS                                          \
   /* Add threads custom fields here.*/
+#endif
 
 /**
  * @brief   System initialization hook.
@@ -687,8 +696,24 @@ extern "C" {
  * @brief   Threads descriptor structure extension.
  * @details User fields added to the end of the @p thread_t structure.
  */
+#if HAL_ENABLE_THREAD_STATISTICS
+/*
+  run time accounting for Util::thread_stats(). Time in interrupts is
+  counted against the thread that was interrupted
+ */
+#define CH_CFG_THREAD_EXTRA_FIELDS                                          \
+  /* realtime counter cycles spent running */                               \
+  uint64_t              run_cycles;                                         \
+  /* number of times switched out */                                        \
+  uint32_t              switch_count;                                       \
+  /* realtime counter when made ready, zero when not waiting to run */      \
+  rtcnt_t               ready_rtc;                                          \
+  /* longest wait from ready to running, in realtime counter cycles */      \
+  rtcnt_t               latency_max;
+#else
 #define CH_CFG_THREAD_EXTRA_FIELDS                                          \
   /* Add threads custom fields here.*/
+#endif
 
 /**
  * @brief   Threads initialization hook.
@@ -697,9 +722,18 @@ extern "C" {
  * @note    It is invoked from within @p _thread_init() and implicitly from all
  *          the threads creation APIs.
  */
+#if HAL_ENABLE_THREAD_STATISTICS
+#define CH_CFG_THREAD_INIT_HOOK(tp) {                                       \
+  (tp)->run_cycles = 0U;                                                    \
+  (tp)->switch_count = 0U;                                                  \
+  (tp)->ready_rtc = 0U;                                                     \
+  (tp)->latency_max = 0U;                                                   \
+}
+#else
 #define CH_CFG_THREAD_INIT_HOOK(tp) {                                       \
   /* Add threads initialization code here.*/                                \
 }
+#endif
 
 /**
  * @brief   Threads finalization hook.
@@ -713,9 +747,25 @@ extern "C" {
  * @brief   Context switch hook.
  * @details This hook is invoked just before switching between threads.
  */
+#if HAL_ENABLE_THREAD_STATISTICS
+#define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
+  const rtcnt_t now_rtc = chSysGetRealtimeCounterX();                       \
+  (otp)->run_cycles += (rtcnt_t)(now_rtc - ch.switch_rtc);                  \
+  (otp)->switch_count++;                                                    \
+  ch.switch_rtc = now_rtc;                                                  \
+  if ((ntp)->ready_rtc != 0U) {                                             \
+    const rtcnt_t wait_rtc = now_rtc - (ntp)->ready_rtc;                    \
+    if (wait_rtc > (ntp)->latency_max) {                                    \
+      (ntp)->latency_max = wait_rtc;                                        \
+    }                                                                       \
+    (ntp)->ready_rtc = 0U;                                                  \
+  }                                                                         \
+}
+#else
 #define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
   /* Context switch code here.*/                                            \
 }
+#endif
 
 /**
  * @brief   ISR enter hook.
@@ -799,9 +849,17 @@ extern "C" {
  * @details This hook is invoked each time a new record is written in the
  *          trace buffer.
  */
+#if HAL_ENABLE_THREAD_STATISTICS
+#define CH_CFG_TRACE_HOOK(tep) {                                            \
+  if ((tep)->type == CH_TRACE_TYPE_READY) {                                 \
+    (tep)->u.rdy.tp->ready_rtc = chSysGetRealtimeCounterX() | 1U;           \
+  }                                                                         \
+}
+#else
 #define CH_CFG_TRACE_HOOK(tep) {                                            \
   /* Trace code here.*/                                                     \
 }
+#endif
 
 /** @} */
 
@@ -53,6 +53,19 @@ static const struct memory_region memory_regions[] = { HAL_MEMORY_REGIONS };
 
 static memory_heap_t heaps[NUM_MEMORY_REGIONS];
 
+#ifndef HAL_BOOTLOADER_BUILD
+// memory tag accounting in AP_Common/MemoryTag.cpp
+extern void memory_tag_allocated(size_t size);
+extern void memory_tag_freed(size_t size);
+#define MEMORY_TAG_ALLOCATED(p) memory_tag_allocated(chHeapGetSize(p))
+#define MEMORY_TAG_FREED(p) memory_tag_freed(chHeapGetSize(p))
+#define MEMORY_TAG_ALLOCATED_SIZE(size) memory_tag_allocated(size)
+#else
+#define MEMORY_TAG_ALLOCATED(p)
+#define MEMORY_TAG_FREED(p)
+#define MEMORY_TAG_ALLOCATED_SIZE(size)
+#endif
+
 #define MIN_ALIGNMENT 8U
 
 #if defined(STM32H7)
@@ -68,8 +81,14 @@ static memory_heap_t heaps[NUM_MEMORY_REGIONS];
 
 #if DMA_RESERVE_SIZE != 0
 static memory_heap_t dma_reserve_heap;
+static uint32_t dma_reserve_size;
 #endif
 
+// statistics on DMA-safe allocations, see malloc_dma_info()
+static uint32_t dma_reserve_allocs;
+static uint32_t dma_failed_allocs;
+static uint32_t dma_failed_largest;
+
 /*
   initialise memory handling
  */
@@ -103,6 +122,7 @@ void malloc_init(void)
         void *dma_reserve = malloc_dma(reserve_size);
         if (dma_reserve != NULL) {
             chHeapObjectInit(&dma_reserve_heap, dma_reserve, reserve_size);
+            dma_reserve_size = reserve_size;
             break;
         }
         reserve_size = (reserve_size * 7) / 8;
@@ -178,16 +198,25 @@ static void *malloc_flags(size_t size, uint32_t flags)
     // fall back to DMA reserve
     p = chHeapAllocAligned(&dma_reserve_heap, size, alignment);
     if (p) {
+        dma_reserve_allocs++;
         memset(p, 0, size);
+        MEMORY_TAG_ALLOCATED(p);
         return p;
     }
 #endif
 
     // failed
+    if (flags & dma_flags) {
+        dma_failed_allocs++;
+        if (size > dma_failed_largest) {
+            dma_failed_largest = size;
+        }
+    }
     return NULL;
 
 found:
     memset(p, 0, size);
+    MEMORY_TAG_ALLOCATED(p);
     return p;
 }
 
@@ -320,6 +349,7 @@ static void free_guard(void *p)
     if (mg == mg_head) {
         mg_head = mg->next;
     }
+    MEMORY_TAG_FREED((void*)(((uint8_t *)p) - (MALLOC_GUARD_SIZE+MALLOC_HEAD_SIZE)));
     chHeapFree((void*)(((uint8_t *)p) - (MALLOC_GUARD_SIZE+MALLOC_HEAD_SIZE)));
     chMtxUnlock(&mem_mutex);
 }
@@ -384,6 +414,7 @@ void free(void *ptr)
 #ifdef HAL_CHIBIOS_ENABLE_MALLOC_GUARD
         free_guard(ptr);
 #else
+        MEMORY_TAG_FREED(ptr);
         chHeapFree(ptr);
 #endif
     }
@@ -420,6 +451,27 @@ size_t mem_available(void)
     return totalp;
 }
 
+/*
+  return information on the DMA reserve heap and on DMA-safe
+  allocations that needed it or failed
+ */
+void malloc_dma_info(struct dma_alloc_info *info)
+{
+    memset(info, 0, sizeof(*info));
+#if DMA_RESERVE_SIZE != 0
+    if (dma_reserve_size != 0) {
+        size_t available = 0, largest = 0;
+        chHeapStatus(&dma_reserve_heap, &available, &largest);
+        info->reserve_size = dma_reserve_size;
+        info->reserve_free = available;
+        info->reserve_largest = largest;
+    }
+#endif
+    info->reserve_allocs = dma_reserve_allocs;
+    info->failed_allocs = dma_failed_allocs;
+    info->failed_largest = dma_failed_largest;
+}
+
 /*
   allocate a thread on any available heap
  */
@@ -431,6 +483,7 @@ thread_t *thread_create_alloc(size_t size,
     // first try default heap
     ret = chThdCreateFromHeap(NULL, size, name, prio, pf, arg);
     if (ret != NULL) {
+        MEMORY_TAG_ALLOCATED_SIZE(size);
         return ret;
     }
 
@@ -439,6 +492,7 @@ thread_t *thread_create_alloc(size_t size,
     for (i=1; i<NUM_MEMORY_REGIONS; i++) {
         ret = chThdCreateFromHeap(&heaps[i], size, name, prio, pf, arg);
         if (ret != NULL) {
+            MEMORY_TAG_ALLOCATED_SIZE(size);
             return ret;
         }
     }
@@ -42,6 +42,16 @@ struct memory_region {
 };
 #if CH_CFG_USE_HEAP == TRUE
 uint8_t malloc_get_heaps(memory_heap_t **_heaps, const struct memory_region **regions);
+
+struct dma_alloc_info {
+    uint32_t reserve_size;      // size of DMA reserve heap, zero if none
+    uint32_t reserve_free;      // bytes free in DMA reserve heap
+    uint32_t reserve_largest;   // largest free block in DMA reserve heap
+    uint32_t reserve_allocs;    // allocations that fell back to the reserve
+    uint32_t failed_allocs;     // DMA-safe allocations that failed
+    uint32_t failed_largest;    // largest failed DMA-safe allocation
+};
+void malloc_dma_info(struct dma_alloc_info *info);
 #endif
 
 // flush all dcache
@@ -28,6 +28,10 @@ mcu = {
 
     'EXPECTED_CLOCK' : 400000000,
 
+    # how much of the ITCM to use for functions marked __FASTRAMFUNC__,
+    # boards can change this with ITCM_CODE_KB in hwdef.dat
+    'ITCM_CODE_KB' : 16,
+
     # this MCU has M7 instructions and hardware double precision
     'CORTEX'    : 'cortex-m7',
     'CPU_FLAGS' : '-mcpu=cortex-m7 -mfpu=fpv5-d16 -mfloat-abi=hard',
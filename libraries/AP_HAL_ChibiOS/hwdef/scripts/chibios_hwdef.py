@@ -769,7 +769,7 @@ def write_mcu_config(f):
 
     f.write('\n')
 
-    ram_map = get_mcu_config('RAM_MAP', True)
+    ram_map = get_ram_map()
     f.write('// memory regions\n')
     regions = []
     total_memory = 0
@@ -784,6 +784,12 @@ def write_mcu_config(f):
     if ram_reserve_start > 0:
         f.write('#define HAL_RAM_RESERVE_START 0x%08x\n' % ram_reserve_start)
 
+    itcm_code_kb = get_itcm_code_kb()
+    if itcm_code_kb > 0:
+        f.write('\n// functions marked __FASTRAMFUNC__ run from ITCM\n')
+        f.write('#define HAL_ITCM_CODE_KB %u\n' % itcm_code_kb)
+        f.write('#define __FASTRAMFUNC__ __attribute__((section(".fastramfunc")))\n')
+
     f.write('\n// CPU serial number (12 bytes)\n')
     udid_start = get_mcu_config('UDID_START')
     if udid_start is None:
@@ -884,6 +890,38 @@ def write_mcu_config(f):
     if not args.bootloader:
         f.write('''#define STM32_DMA_REQUIRED TRUE\n\n''')
 
+def get_itcm_region():
+    '''return the index in RAM_MAP of the ITCM, or None'''
+    ram_map = get_mcu_config('RAM_MAP', True)
+    for i in range(len(ram_map)):
+        if ram_map[i][0] < 0x08000000 and ram_map[i][2] & 2:
+            return i
+    return None
+
+
+def get_itcm_code_kb():
+    '''return how much ITCM to reserve for __FASTRAMFUNC__ code'''
+    if args.bootloader or get_itcm_region() is None:
+        return 0
+    default = get_mcu_config('ITCM_CODE_KB')
+    if default is None:
+        default = 0
+    return get_config('ITCM_CODE_KB', default=default, type=int)
+
+
+def get_ram_map():
+    '''return the RAM_MAP with any ITCM used for code removed'''
+    ram_map = list(get_mcu_config('RAM_MAP', True))
+    itcm_code_kb = get_itcm_code_kb()
+    if itcm_code_kb > 0:
+        i = get_itcm_region()
+        (address, size, flags) = ram_map[i]
+        if itcm_code_kb >= size:
+            error("ITCM_CODE_KB %u too large for %uk of ITCM" % (itcm_code_kb, size))
+        ram_map[i] = (address + itcm_code_kb * 1024, size - itcm_code_kb, flags)
+    return ram_map
+
+
 def write_ldscript(fname):
     '''write ldscript.ld for this board'''
     flash_size = get_config('FLASH_USE_MAX_KB', type=int, default=0)
@@ -900,7 +938,7 @@ def write_ldscript(fname):
     flash_reserve_end = get_config('FLASH_RESERVE_END_KB', default=0, type=int)
 
     # ram layout
-    ram_map = get_mcu_config('RAM_MAP', True)
+    ram_map = get_ram_map()
 
     flash_base = 0x08000000 + flash_reserve_start * 1024
 
@@ -921,15 +959,40 @@ def write_ldscript(fname):
     ram0_start += ram_reserve_start
     ram0_len -= ram_reserve_start
 
+    # code marked __FASTRAMFUNC__ is linked to run from the start of
+    # ITCM and copied there from flash by board.c
+    itcm_code_kb = get_itcm_code_kb()
+    itcm_memory = ''
+    if itcm_code_kb > 0:
+        itcm_start = get_mcu_config('RAM_MAP', True)[get_itcm_region()][0]
+        itcm_memory = '    itcm  : org = 0x%08x, len = %uK\n' % (itcm_start, itcm_code_kb)
+
     f.write('''/* generated ldscript.ld */
 MEMORY
 {
     flash : org = 0x%08x, len = %uK
     ram0  : org = 0x%08x, len = %u
-}
+%s}
 
 INCLUDE common.ld
-''' % (flash_base, flash_length, ram0_start, ram0_len))
+''' % (flash_base, flash_length, ram0_start, ram0_len, itcm_memory))
+
+    if itcm_code_kb > 0:
+        f.write('''
+SECTIONS
+{
+    .fastramfunc : ALIGN(4)
+    {
+        . = ALIGN(4);
+        __fastramfunc_load__ = LOADADDR(.fastramfunc);
+        __fastramfunc_base__ = .;
+        *(.fastramfunc)
+        *(.fastramfunc.*)
+        . = ALIGN(4);
+        __fastramfunc_end__ = .;
+    } > itcm AT > flash
+}
+''')
 
 
 def copy_common_linkerscript(outdir, hwdef):
@@ -1887,7 +1950,8 @@ def write_hwdef_header(outfilename):
     dma_unassigned, ordered_timers = dma_resolver.write_dma_header(f, periph_list, mcu_type,
                                                    dma_exclude=get_dma_exclude(periph_list),
                                                    dma_priority=get_config('DMA_PRIORITY', default='TIM* SPI*', spaces=True),
-                                                   dma_noshare=dma_noshare)
+                                                   dma_noshare=dma_noshare,
+                                                   dma_latency_critical=get_config('DMA_LATENCY_CRITICAL', default=[], aslist=True))
 
     if not args.bootloader:
         write_PWM_config(f, ordered_timers)
@@ -118,6 +118,13 @@ def get_list_index(peripheral, priority_list):
     # default to max priority
     return len(priority_list)
 
+def is_latency_critical(peripheral, latency_list):
+    '''check if a peripheral is in the DMA_LATENCY_CRITICAL list'''
+    for pattern in latency_list:
+        if fnmatch.fnmatch(peripheral, pattern):
+            return True
+    return False
+
 def get_sharing_priority(periph_list, priority_list):
     '''get priority of a list of peripherals we could share with'''
     highest = len(priority_list)
@@ -290,7 +297,7 @@ def forbidden_list(p, peripheral_list):
 
 
 def write_dma_header(f, peripheral_list, mcu_type, dma_exclude=[],
-                     dma_priority='', dma_noshare=[]):
+                     dma_priority='', dma_noshare=[], dma_latency_critical=[]):
     '''write out a DMA resolver header file'''
     global dma_map, have_DMAMUX, has_bdshot
     timer_ch_periph = []
@@ -300,8 +307,10 @@ def write_dma_header(f, peripheral_list, mcu_type, dma_exclude=[],
     # form a list of DMA priorities
     priority_list = dma_priority.split()
 
-    # sort by priority
-    peripheral_list = sorted(peripheral_list, key=lambda x: get_list_index(x, priority_list))
+    # sort by priority, with latency critical peripherals first so they
+    # get the first pick of the dedicated streams
+    peripheral_list = sorted(peripheral_list, key=lambda x: (not is_latency_critical(x, dma_latency_critical),
+                                                             get_list_index(x, priority_list)))
 
     # form a list of peripherals that can't share
     noshare_list = dma_noshare[:]
@@ -390,8 +399,12 @@ def write_dma_header(f, peripheral_list, mcu_type, dma_exclude=[],
             if share_ok:
                 share_possibility.append(stream)
         if share_possibility:
-            # sort the possible sharings so minimise impact on high priority streams
-            share_possibility = sorted(share_possibility, key=lambda x: get_sharing_priority(stream_assign[x], priority_list))
+            # sort the possible sharings so minimise impact on high
+            # priority streams, keeping off the streams of latency
+            # critical peripherals unless there is no other choice
+            share_possibility = sorted(share_possibility, key=lambda x: (
+                not any(is_latency_critical(p, dma_latency_critical) for p in stream_assign[x]),
+                get_sharing_priority(stream_assign[x], priority_list)))
             # and take the one with the least impact (lowest value for highest priority stream share)
             stream = share_possibility[-1]
             if debug:
@@ -407,6 +420,8 @@ def write_dma_header(f, peripheral_list, mcu_type, dma_exclude=[],
         if len(stream_assign[stream]) > 1:
             if not check_sharing(stream_assign[stream]):
                 sys.exit(1)
+            if is_latency_critical(key, dma_latency_critical):
+                print("Latency critical %s shares DMA with %s" % (key, ','.join(stream_assign[stream])))
     
     if debug:
         print(stream_assign)
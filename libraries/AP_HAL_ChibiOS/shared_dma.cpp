@@ -23,12 +23,14 @@
 #if CH_CFG_USE_MUTEXES == TRUE && !defined(HAL_NO_SHARED_DMA)
 
 #include <AP_Common/ExpandingString.h>
+#include <AP_Math/AP_Math.h>
 
 using namespace ChibiOS;
 extern const AP_HAL::HAL& hal;
 
 Shared_DMA::dma_lock Shared_DMA::locks[SHARED_DMA_MAX_STREAM_ID+1];
 volatile Shared_DMA::dma_stats* Shared_DMA::_contention_stats;
+Shared_DMA *Shared_DMA::instances;
 
 void Shared_DMA::init(void)
 {
@@ -51,6 +53,11 @@ Shared_DMA::Shared_DMA(uint8_t _stream_id1,
     }
     allocate = _allocate;
     deallocate = _deallocate;
+
+    chSysLock();
+    next_instance = instances;
+    instances = this;
+    chSysUnlock();
 }
 
 //remove any assigned deallocator or allocator
@@ -67,6 +74,15 @@ void Shared_DMA::unregister()
         locks[stream_id2].deallocate(this);
         locks[stream_id2].obj = nullptr;
     }
+
+    chSysLock();
+    for (Shared_DMA **p = &instances; *p; p = &(*p)->next_instance) {
+        if (*p == this) {
+            *p = next_instance;
+            break;
+        }
+    }
+    chSysUnlock();
 }
 
 // lock one stream
@@ -160,9 +176,20 @@ void Shared_DMA::lock_core(void)
 // lock the DMA channels, blocking method
 void Shared_DMA::lock(void)
 {
+    const bool record_stats = _contention_stats != nullptr;
+    const uint32_t start_us = record_stats ? AP_HAL::micros() : 0;
     bool c1 = lock_stream(stream_id1);
     bool c2 = lock_stream(stream_id2);
     contention = c1 || c2;
+    if (record_stats) {
+        const uint32_t wait_us = AP_HAL::micros() - start_us;
+        instance_stats.locks++;
+        if (contention) {
+            instance_stats.contended_locks++;
+        }
+        instance_stats.wait_us += wait_us;
+        instance_stats.wait_max_us = MAX(instance_stats.wait_max_us, wait_us);
+    }
     lock_core();
 }
 
@@ -179,6 +206,9 @@ bool Shared_DMA::lock_nonblock(void)
         }
         chSysEnable();
         contention = true;
+        if (_contention_stats != nullptr) {
+            instance_stats.contended_locks++;
+        }
         return false;
     }
 
@@ -197,11 +227,17 @@ bool Shared_DMA::lock_nonblock(void)
         }
         chSysEnable();
         contention = true;
+        if (_contention_stats != nullptr) {
+            instance_stats.contended_locks++;
+        }
         return false;
     }
     lock_core();
-    if (_contention_stats != nullptr && stream_id2 < SHARED_DMA_MAX_STREAM_ID) {
-        _contention_stats[stream_id2].uncontended_locks++;
+    if (_contention_stats != nullptr) {
+        if (stream_id2 < SHARED_DMA_MAX_STREAM_ID) {
+            _contention_stats[stream_id2].uncontended_locks++;
+        }
+        instance_stats.locks++;
     }
     return true;
 }
@@ -229,6 +265,24 @@ void Shared_DMA::lock_all(void)
     }
 }
 
+#if STM32_DMA_ADVANCED
+#define STREAM_MUX 8
+#define STREAM_OFFSET 0
+#else
+#define STREAM_MUX 7
+#define STREAM_OFFSET 1
+#endif
+
+// display a stream ID as controller:stream
+static void stream_info(ExpandingString &str, uint8_t stream_id)
+{
+    if (stream_id < SHARED_DMA_MAX_STREAM_ID) {
+        str.printf("%1u:%1u", stream_id / STREAM_MUX + 1, stream_id % STREAM_MUX + STREAM_OFFSET);
+    } else {
+        str.printf("-");
+    }
+}
+
 // display dma contention statistics as text buffer for @SYS/dma.txt
 void Shared_DMA::dma_info(ExpandingString &str)
 {
@@ -239,7 +293,7 @@ void Shared_DMA::dma_info(ExpandingString &str)
     }
 
     // a header to allow for machine parsers to determine format
-    str.printf("DMAV1\n");
+    str.printf("DMAV2\n");
 
     for (uint8_t i = 0; i < SHARED_DMA_MAX_STREAM_ID; i++) {
         // ignore locks not in use
@@ -248,13 +302,6 @@ void Shared_DMA::dma_info(ExpandingString &str)
             && _contention_stats[i].transactions == 0) {
             continue;
         }
-#if STM32_DMA_ADVANCED
-#define STREAM_MUX 8
-#define STREAM_OFFSET 0
-#else
-#define STREAM_MUX 7
-#define STREAM_OFFSET 1
-#endif
         const char* fmt = "DMA=%1u:%1u TX=%8u ULCK=%8u CLCK=%8u CONT=%4.1f%%\n";
         float cond_per = 100.0f * float(_contention_stats[i].contended_locks)
             / (1 + _contention_stats[i].contended_locks + _contention_stats[i].uncontended_locks);
@@ -264,6 +311,21 @@ void Shared_DMA::dma_info(ExpandingString &str)
         _contention_stats[i].contended_locks = 0;
         _contention_stats[i].uncontended_locks = 0;
     }
+
+    // time each driver spent waiting for its streams
+    for (Shared_DMA *d = instances; d; d = d->next_instance) {
+        if (d->instance_stats.locks == 0 && d->instance_stats.contended_locks == 0) {
+            continue;
+        }
+        str.printf("LOCK=");
+        stream_info(str, d->stream_id1);
+        str.printf(",");
+        stream_info(str, d->stream_id2);
+        str.printf(" LCK=%8u CLCK=%8u WAIT=%8u MAXW=%6u\n",
+                   unsigned(d->instance_stats.locks), unsigned(d->instance_stats.contended_locks),
+                   unsigned(d->instance_stats.wait_us), unsigned(d->instance_stats.wait_max_us));
+        memset(&d->instance_stats, 0, sizeof(d->instance_stats));
+    }
 }
 
 #endif // CH_CFG_USE_SEMAPHORES
@@ -109,6 +109,18 @@ private:
         uint32_t uncontended_locks;
         uint32_t transactions;
     } *_contention_stats;
+
+    // per-instance lock statistics, collected once _contention_stats is allocated
+    struct {
+        uint32_t locks;
+        uint32_t contended_locks;   // locks that waited for, or failed on, a stream held by another driver
+        uint32_t wait_max_us;
+        uint64_t wait_us;
+    } instance_stats;
+
+    // list of all instances, for statistics
+    static Shared_DMA *instances;
+    Shared_DMA *next_instance;
 };
 
 #endif // HAL_NO_SHARED_DMA
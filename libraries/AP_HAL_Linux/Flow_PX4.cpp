@@ -44,6 +44,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FLOW_PX4_USE_NEON 1
+#endif
+
 extern const AP_HAL::HAL& hal;
 
 using namespace Linux;
@@ -123,11 +128,15 @@ static inline uint32_t compute_diff(uint8_t *image, uint16_t offx, uint16_t offy
  * @param off1Y y coordinate of upper left corner of pattern in image1
  * @param off2X x coordinate of upper left corner of pattern in image2
  * @param off2Y y coordinate of upper left corner of pattern in image2
+ * @param best SAD of the best match so far. Once a row takes the sum
+ *        past it the window can't be the best match, so the partial
+ *        sum is returned
  */
 static inline uint32_t compute_sad(uint8_t *image1, uint8_t *image2,
                                    uint16_t off1x, uint16_t off1y,
                                    uint16_t off2x, uint16_t off2y,
-                                   uint16_t row_size, uint16_t window_size)
+                                   uint16_t row_size, uint16_t window_size,
+                                   uint32_t best)
 {
     /* calculate position in image buffer
      * off1 for image1 and off2 for image2
@@ -137,11 +146,30 @@ static inline uint32_t compute_sad(uint8_t *image1, uint8_t *image2,
     unsigned int i,j;
     uint32_t acc = 0;
 
-    for (i = 0; i < window_size; i++) {
-        for (j = 0; j < window_size; j++) {
+#if FLOW_PX4_USE_NEON
+    if (window_size == 8) {
+        /* one row of the window per vector, accumulating the
+         * absolute differences in 16 bit lanes */
+        uint16x8_t sum = vdupq_n_u16(0);
+        for (j = 0; j < 8; j++) {
+            const uint8x8_t a = vld1_u8(&image1[off1 + j*row_size]);
+            const uint8x8_t b = vld1_u8(&image2[off2 + j*row_size]);
+            sum = vabal_u8(sum, a, b);
+        }
+        const uint32x4_t sum32 = vpaddlq_u16(sum);
+        const uint64x2_t sum64 = vpaddlq_u32(sum32);
+        return vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1);
+    }
+#endif
+
+    for (j = 0; j < window_size; j++) {
+        for (i = 0; i < window_size; i++) {
             acc += abs(image1[off1 + i + j*row_size] -
                        image2[off2 + i + j*row_size]);
         }
+        if (acc >= best) {
+            break;
+        }
     }
     return acc;
 }
@@ -269,7 +297,7 @@ uint8_t Flow_PX4::compute_flow(uint8_t *image1, uint8_t *image2,
                     uint32_t temp_dist = compute_sad(image1, image2, i, j,
                                                      i + ii, j + jj,
                                                      (uint16_t)_bytesperline,
-                                                     2 * _search_size);
+                                                     2 * _search_size, dist);
                     if (temp_dist < dist) {
                         sumx = ii;
                         sumy = jj;
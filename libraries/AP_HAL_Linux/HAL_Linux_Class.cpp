@@ -285,6 +285,12 @@ void _usage(void)
     printf("\tcustom storage path:\n");
     printf("\t                   --storage-directory /var/APM/storage\n");
     printf("\t                   -s /var/APM/storage\n");
+    printf("\tthread priority (1-99), repeat for each thread:\n");
+    printf("\t                   --thread-priority timer=20\n");
+    printf("\t                   -P spi=20\n");
+    printf("\tthread CPU affinity, repeat for each thread:\n");
+    printf("\t                   --cpu-affinity main=2\n");
+    printf("\t                   -a spi-0=3 -a io=0-1\n");
 #if AP_MODULE_SUPPORTED
     printf("\tmodule support:\n");
     printf("\t                   --module-directory %s\n", AP_MODULE_DEFAULT_DIRECTORY);
@@ -314,11 +320,13 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"storage-directory",   true,  0, 's'},
         {"module-directory",    true,  0, 'M'},
         {"defaults",            true,  0, 'd'},
+        {"thread-priority",     true,  0, 'P'},
+        {"cpu-affinity",        true,  0, 'a'},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:l:t:s:he:SM:",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:l:t:s:he:SM:P:a:",
                     options);
 
     /*
@@ -370,6 +378,18 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         case 'd':
             utilInstance.set_custom_defaults_path(gopt.optarg);
             break;
+        case 'P':
+            if (!Linux::Thread::add_priority_override(gopt.optarg)) {
+                printf("Bad thread priority '%s'\n", gopt.optarg);
+                exit(1);
+            }
+            break;
+        case 'a':
+            if (!Linux::Thread::add_affinity_override(gopt.optarg)) {
+                printf("Bad CPU affinity '%s'\n", gopt.optarg);
+                exit(1);
+            }
+            break;
         case 'h':
             _usage();
             exit(0);
@@ -243,6 +243,61 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
     return true;
 }
 
+/*
+  read registers from several devices on this bus, chained into a
+  single I2C_RDWR ioctl. If that fails each read is retried on its own
+ */
+uint8_t I2CDevice::read_registers_batch(BatchRead *reads, uint8_t n)
+{
+    const uint8_t max_reads = I2C_RDRW_IOCTL_MAX_MSGS / 2;
+    struct i2c_msg msgs[2 * max_reads];
+    uint8_t regs[max_reads];
+    uint8_t idx[max_reads];
+    uint8_t nbatch = 0;
+
+    memset(msgs, 0, sizeof(msgs));
+
+    for (uint8_t i = 0; i < n; i++) {
+        reads[i].ok = false;
+        I2CDevice *dev = from(reads[i].dev);
+        if (&dev->_bus != &_bus || dev->_split_transfers || nbatch == max_reads) {
+            continue;
+        }
+        regs[nbatch] = reads[i].first_reg | dev->_read_flag;
+        msgs[2 * nbatch].addr = dev->_address;
+        msgs[2 * nbatch].flags = 0;
+        msgs[2 * nbatch].buf = &regs[nbatch];
+        msgs[2 * nbatch].len = 1;
+        msgs[2 * nbatch + 1].addr = dev->_address;
+        msgs[2 * nbatch + 1].flags = I2C_M_RD;
+        msgs[2 * nbatch + 1].buf = reads[i].recv;
+        msgs[2 * nbatch + 1].len = reads[i].recv_len;
+        idx[nbatch++] = i;
+    }
+
+    if (nbatch > 0) {
+        struct i2c_rdwr_ioctl_data i2c_data = { };
+
+        i2c_data.msgs = msgs;
+        i2c_data.nmsgs = 2 * nbatch;
+
+        if (::ioctl(_bus.fd, I2C_RDWR, &i2c_data) != -1) {
+            for (uint8_t i = 0; i < nbatch; i++) {
+                reads[idx[i]].ok = true;
+            }
+        }
+    }
+
+    uint8_t nok = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        if (!reads[i].ok) {
+            reads[i].ok = reads[i].dev->read_registers(reads[i].first_reg, reads[i].recv, reads[i].recv_len);
+        }
+        nok += reads[i].ok;
+    }
+    return nok;
+}
+
 AP_HAL::Semaphore *I2CDevice::get_semaphore()
 {
     return &_bus.sem;
@@ -251,7 +306,7 @@ AP_HAL::Semaphore *I2CDevice::get_semaphore()
 AP_HAL::Device::PeriodicHandle I2CDevice::register_periodic_callback(
     uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
 {
-    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec);
+    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec, get_bus_id());
     if (!p) {
         AP_HAL::panic("Could not create periodic callback");
     }
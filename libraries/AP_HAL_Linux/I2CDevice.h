@@ -60,6 +60,9 @@ public:
     bool read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                  uint32_t recv_len, uint8_t times) override;
 
+    /* See AP_HAL::I2CDevice::read_registers_batch() */
+    uint8_t read_registers_batch(BatchRead *reads, uint8_t n) override;
+
     /* See AP_HAL::Device::get_semaphore() */
     AP_HAL::Semaphore *get_semaphore() override;
 
@@ -132,10 +132,12 @@ void OpticalFlow_Onboard::init()
             _camera_output_height = _height;
 
             /* we set these values here in order to the calculations be correct
-             * (such as PX4 init) even though we crop each frame later on. */
+             * (such as PX4 init) even though we crop each frame later on.
+             * The crop is done in place by pointing the flow at the
+             * crop origin, so lines keep the camera stride */
             _width = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH;
             _height = HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT;
-            _bytesperline = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH;
+            _bytesperline = _camera_output_width;
         }
     }
 
@@ -256,6 +258,7 @@ void OpticalFlow_Onboard::_run_optflow()
     uint32_t shrink_scale = 0, shrink_width = 0, shrink_height = 0;
     uint32_t shrink_width_offset = 0, shrink_height_offset = 0;
     uint8_t *convert_buffer = nullptr, *output_buffer = nullptr;
+    uint8_t *image = nullptr, *last_image = nullptr;
     uint8_t qual;
 
     if (_format == V4L2_PIX_FMT_YUYV) {
@@ -271,7 +274,7 @@ void OpticalFlow_Onboard::_run_optflow()
         }
     }
 
-    if (_shrink_by_software || _crop_by_software) {
+    if (_shrink_by_software) {
         output_buffer_size = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH *
             HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT;
 
@@ -324,7 +327,8 @@ void OpticalFlow_Onboard::_run_optflow()
             VideoIn::yuyv_to_grey((uint8_t *)video_frame.data,
                 convert_buffer_size * 2, convert_buffer);
 
-            memset(video_frame.data, 0, convert_buffer_size * 2);
+            /* the flow only reads the grey image at the start of the
+             * buffer, so there is no need to clear the rest of it */
             memcpy(video_frame.data, convert_buffer, convert_buffer_size);
         }
 
@@ -336,22 +340,20 @@ void OpticalFlow_Onboard::_run_optflow()
                                  shrink_width_offset, shrink_width,
                                  shrink_height_offset, shrink_height,
                                  shrink_scale, shrink_scale);
-            memset(video_frame.data, 0, _camera_output_width * _camera_output_height);
             memcpy(video_frame.data, output_buffer, output_buffer_size);
-        } else if (_crop_by_software) {
-            VideoIn::crop_8bpp((uint8_t *)video_frame.data, output_buffer,
-                               _camera_output_width,
-                               crop_left, HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH,
-                               crop_top, HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT);
+        }
 
-            memset(video_frame.data, 0, _camera_output_width * _camera_output_height);
-            memcpy(video_frame.data, output_buffer, output_buffer_size);
+        image = (uint8_t *)video_frame.data;
+        if (_crop_by_software && !_shrink_by_software) {
+            image = VideoIn::crop_8bpp_in_place(image, _camera_output_width,
+                                                crop_left, crop_top);
         }
 
         /* if it is at least the second frame we receive
          * since we have to compare 2 frames */
         if (_last_video_frame.data == nullptr) {
             _last_video_frame = video_frame;
+            last_image = image;
             continue;
         }
 
@@ -380,8 +382,7 @@ void OpticalFlow_Onboard::_run_optflow()
         /* compute gyro data and video frames
          * get flow rate to send it to the opticalflow driver
          */
-        qual = _flow->compute_flow((uint8_t*)_last_video_frame.data,
-                                   (uint8_t *)video_frame.data,
+        qual = _flow->compute_flow(last_image, image,
                                    video_frame.timestamp -
                                    _last_video_frame.timestamp,
                                    &flow_rate.x, &flow_rate.y);
@@ -408,6 +409,7 @@ void OpticalFlow_Onboard::_run_optflow()
         _videoin->put_frame(_last_video_frame);
         _last_integration_time = gyro_sample.time_us;
         _last_video_frame = video_frame;
+        last_image = image;
         _last_gyro_rate = gyro_sample.gyro;
     }
 
@@ -25,6 +25,9 @@
 
 namespace Linux {
 
+TimerPollable *TimerPollable::_all_timers;
+Semaphore TimerPollable::_all_timers_sem;
+
 void TimerPollable::on_can_read()
 {
     if (_removeme) {
@@ -33,19 +36,32 @@ void TimerPollable::on_can_read()
 
     uint64_t nevents = 0;
     int r = read(_fd, &nevents, sizeof(nevents));
-    if (r < 0) {
+    if (r < 0 || nevents == 0) {
         return;
     }
 
+    // the most recent of the expiries being handled
+    const uint64_t due_usec = _next_usec + (nevents - 1) * _stats.period_usec;
+    _next_usec += nevents * _stats.period_usec;
+
     if (_wrapper) {
         _wrapper->start_cb();
     }
 
+    const uint64_t start_usec = AP_HAL::micros64();
     _cb();
+    const uint32_t run_us = AP_HAL::micros64() - start_usec;
 
     if (_wrapper) {
         _wrapper->end_cb();
     }
+
+    const uint32_t late_us = start_usec > due_usec ? start_usec - due_usec : 0;
+    _stats.count++;
+    _stats.late_us += late_us;
+    _stats.run_us += run_us;
+    _stats.late_max_us = MAX(_stats.late_max_us, late_us);
+    _stats.run_max_us = MAX(_stats.run_max_us, run_us);
 }
 
 bool TimerPollable::setup_timer(uint32_t timeout_usec)
@@ -83,17 +99,39 @@ bool TimerPollable::adjust_timer(uint32_t timeout_usec)
         return false;
     }
 
+    _stats.period_usec = timeout_usec;
+    _next_usec = AP_HAL::micros64() + timeout_usec;
+
     return true;
 }
 
+bool TimerPollable::periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max)
+{
+    WITH_SEMAPHORE(_all_timers_sem);
+
+    for (TimerPollable *p = _all_timers; p; p = p->_all_next) {
+        if (idx-- != 0) {
+            continue;
+        }
+        stats = p->_stats;
+        if (reset_max) {
+            p->_stats.late_max_us = 0;
+            p->_stats.run_max_us = 0;
+        }
+        return true;
+    }
+    return false;
+}
+
 TimerPollable *PollerThread::add_timer(TimerPollable::PeriodicCb cb,
                                        TimerPollable::WrapperCb *wrapper,
-                                       uint32_t timeout_usec)
+                                       uint32_t timeout_usec,
+                                       uint32_t bus_id)
 {
     if (!_poller) {
         return nullptr;
     }
-    TimerPollable *p = new TimerPollable(cb, wrapper);
+    TimerPollable *p = new TimerPollable(cb, wrapper, bus_id);
     if (!p || !p->setup_timer(timeout_usec) ||
         !_poller.register_pollable(p, POLLIN)) {
         delete p;
@@ -102,6 +140,10 @@ TimerPollable *PollerThread::add_timer(TimerPollable::PeriodicCb cb,
 
     _timers.push_back(p);
 
+    WITH_SEMAPHORE(TimerPollable::_all_timers_sem);
+    p->_all_next = TimerPollable::_all_timers;
+    TimerPollable::_all_timers = p;
+
     return p;
 }
 
@@ -125,6 +167,15 @@ void PollerThread::_cleanup_timers()
     for (auto it = _timers.begin(); it != _timers.end(); it++) {
         TimerPollable *p = *it;
         if (p->_removeme) {
+            {
+                WITH_SEMAPHORE(TimerPollable::_all_timers_sem);
+                for (TimerPollable **pp = &TimerPollable::_all_timers; *pp; pp = &(*pp)->_all_next) {
+                    if (*pp == p) {
+                        *pp = p->_all_next;
+                        break;
+                    }
+                }
+            }
             _timers.erase(it);
             _poller.unregister_pollable(p);
             delete p;
@@ -22,6 +22,7 @@
 #include <AP_HAL/Device.h>
 
 #include "Poller.h"
+#include "Semaphores.h"
 #include "Thread.h"
 
 namespace Linux {
@@ -47,16 +48,29 @@ public:
     bool setup_timer(uint32_t timeout_usec);
     bool adjust_timer(uint32_t timeout_usec);
 
+    // get statistics on the idx'th timer across all poller threads
+    static bool periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max);
+
 protected:
-    TimerPollable(PeriodicCb cb, WrapperCb *wrapper)
+    TimerPollable(PeriodicCb cb, WrapperCb *wrapper, uint32_t bus_id)
         : _cb(cb)
         , _wrapper(wrapper)
     {
+        _stats.bus_id = bus_id;
     }
 
     PeriodicCb _cb;
     WrapperCb *_wrapper;
     bool _removeme = false;
+
+    // time the next expiry of the timer is due
+    uint64_t _next_usec;
+    AP_HAL::Device::PeriodicStats _stats{};
+
+    // list of all timers, for statistics
+    static TimerPollable *_all_timers;
+    static Semaphore _all_timers_sem;
+    TimerPollable *_all_next;
 };
 
 
@@ -67,7 +81,8 @@ public:
 
     TimerPollable *add_timer(TimerPollable::PeriodicCb cb,
                              TimerPollable::WrapperCb *wrapper,
-                             uint32_t timeout_usec);
+                             uint32_t timeout_usec,
+                             uint32_t bus_id);
     bool adjust_timer(TimerPollable *p, uint32_t timeout_usec);
 
     void mainloop();
@@ -411,7 +411,7 @@ AP_HAL::Semaphore *SPIDevice::get_semaphore()
 AP_HAL::Device::PeriodicHandle SPIDevice::register_periodic_callback(
     uint32_t period_usec, AP_HAL::Device::PeriodicCb cb)
 {
-    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec);
+    TimerPollable *p = _bus.thread.add_timer(cb, &_bus, period_usec, get_bus_id());
     if (!p) {
         AP_HAL::panic("Could not create periodic callback");
     }
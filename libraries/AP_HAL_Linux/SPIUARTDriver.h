@@ -12,6 +12,9 @@ public:
     void begin(uint32_t b, uint16_t rxS, uint16_t txS) override;
     void _timer_tick(void) override;
 
+    // data comes in over SPI, so this can only be polled
+    int get_poll_fd() const override { return -1; }
+
 protected:
     int _write_fd(const uint8_t *buf, uint16_t n) override;
     int _read_fd(uint8_t *buf, uint16_t n) override;
@@ -5,6 +5,7 @@
 #include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
 #include <sys/time.h>
 #include <unistd.h>
@@ -79,6 +80,8 @@ void Scheduler::init_realtime()
         AP_HAL::panic("Scheduler: failed to set scheduling parameters: %s",
                       strerror(errno));
     }
+
+    Thread::apply_overrides_to_self("main", SCHED_FIFO, APM_LINUX_MAIN_PRIORITY);
 }
 
 void Scheduler::init()
@@ -335,6 +338,88 @@ bool Scheduler::SchedulerThread::_run()
     return PeriodicThread::_run();
 }
 
+/*
+  keep the epoll set in step with the UART file descriptors, which
+  change as devices are opened and TCP clients come and go. Returns
+  true if any UART is waiting to be serviced
+ */
+bool Scheduler::UARTThread::_update_pollables()
+{
+    bool any_ready = false;
+    for (uint8_t i = 0; i < hal.num_serial; i++) {
+        UARTPollable &p = _pollables[i];
+        const int fd = UARTDriver::from(hal.serial(i))->get_poll_fd();
+        if (p.registered && p.get_fd() == fd) {
+            continue;
+        }
+        if (p.registered) {
+            _poller.unregister_pollable(&p);
+            p.registered = false;
+        }
+        p.set_fd(fd);
+        if (fd >= 0) {
+            /*
+              edge triggered, so a UART whose read buffer is full does
+              not keep waking us; whatever is left is picked up by the
+              periodic tick
+             */
+            p.registered = _poller.register_pollable(&p, EPOLLIN | EPOLLET);
+            // read anything that arrived before we started watching
+            p.ready = true;
+        }
+        any_ready |= p.ready;
+    }
+    return any_ready;
+}
+
+bool Scheduler::UARTThread::_run()
+{
+    _sched._wait_all_threads();
+
+    if (!_poller || _period_usec == 0) {
+        return PeriodicThread::_run();
+    }
+
+    uint64_t next_run_usec = AP_HAL::micros64() + _period_usec;
+
+    while (!_should_exit) {
+        const bool any_ready = _update_pollables();
+
+        uint64_t now_usec = AP_HAL::micros64();
+        if (now_usec < next_run_usec) {
+            const int timeout_ms = any_ready ? 0 : (next_run_usec - now_usec + 999) / 1000;
+            _poller.poll(timeout_ms);
+            now_usec = AP_HAL::micros64();
+        }
+
+        if (now_usec >= next_run_usec) {
+            next_run_usec += _period_usec;
+            if (next_run_usec <= now_usec) {
+                // we've lost sync - restart
+                next_run_usec = now_usec + _period_usec;
+            }
+            for (uint8_t i = 0; i < hal.num_serial; i++) {
+                _pollables[i].ready = false;
+            }
+            _task();
+            continue;
+        }
+
+        // only service the UARTs that have received data
+        for (uint8_t i = 0; i < hal.num_serial; i++) {
+            if (_pollables[i].ready) {
+                _pollables[i].ready = false;
+                hal.serial(i)->_timer_tick();
+            }
+        }
+    }
+
+    _started = false;
+    _should_exit = false;
+
+    return true;
+}
+
 void Scheduler::teardown()
 {
     _timer_thread.stop();
@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Linux.h"
 
+#include "Poller.h"
 #include "Semaphores.h"
 #include "Thread.h"
 
@@ -68,6 +69,42 @@ private:
         Scheduler &_sched;
     };
 
+    /*
+      the UART thread sleeps in epoll on the file descriptors of all
+      UARTs, so received bytes are handled as they arrive instead of on
+      the next tick. The periodic tick still runs to push out pending
+      writes and to service devices without a file descriptor
+     */
+    class UARTThread : public SchedulerThread {
+    public:
+        UARTThread(Thread::task_t t, Scheduler &sched)
+            : SchedulerThread(t, sched)
+        { }
+
+    protected:
+        bool _run() override;
+
+    private:
+        class UARTPollable : public Pollable {
+        public:
+            // the file descriptor belongs to the UART's device
+            ~UARTPollable() { _fd = -1; }
+
+            void set_fd(int fd) { _fd = fd; }
+
+            void on_can_read() override { ready = true; }
+            void on_hang_up() override { ready = true; }
+
+            bool registered = false;
+            bool ready = false;
+        };
+
+        bool _update_pollables();
+
+        Poller _poller{};
+        UARTPollable _pollables[AP_HAL::HAL::num_serial];
+    };
+
     void     init_realtime();
 
     void _wait_all_threads();
@@ -93,7 +130,7 @@ private:
     SchedulerThread _timer_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_timer_task, void), *this};
     SchedulerThread _io_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_io_task, void), *this};
     SchedulerThread _rcin_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_rcin_task, void), *this};
-    SchedulerThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
+    UARTThread _uart_thread{FUNCTOR_BIND_MEMBER(&Scheduler::_uart_task, void), *this};
 
     void _timer_task();
     void _io_task();
@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/uio.h>
 
 #include "AP_HAL_Linux.h"
 
@@ -23,4 +24,25 @@ public:
 
     /* Depends on lower level to implement, most devices are fine with defaults */
     virtual void set_parity(int v) { }
+
+    /*
+     * File descriptor that becomes readable when data arrives, so the
+     * UART thread can sleep on it. -1 if the device can only be polled.
+     */
+    virtual int get_fd() const { return -1; }
+
+    /*
+     * Send each of @count buffers as its own datagram, returning how many
+     * were sent. Devices without batched IO send them one at a time.
+     */
+    virtual int write_datagrams(const struct iovec *dgrams, uint8_t count)
+    {
+        uint8_t i;
+        for (i = 0; i < count; i++) {
+            if (write((const uint8_t *)dgrams[i].iov_base, dgrams[i].iov_len) != (ssize_t)dgrams[i].iov_len) {
+                break;
+            }
+        }
+        return i;
+    }
 };
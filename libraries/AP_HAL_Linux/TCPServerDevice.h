@@ -15,6 +15,12 @@ public:
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
 
+    // the listening socket becomes readable on a new connection, which
+    // read() then accepts
+    virtual int get_fd() const override {
+        return sock != nullptr ? sock->get_read_fd() : listener.get_read_fd();
+    }
+
 private:
     SocketAPM listener{false};
     SocketAPM *sock = nullptr;
@@ -20,6 +20,7 @@
 #include <limits.h>
 #include <sys/types.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <utility>
 
@@ -34,6 +35,148 @@ extern const AP_HAL::HAL &hal;
 
 namespace Linux {
 
+Thread::Override Thread::_overrides[16];
+uint8_t Thread::_num_overrides;
+
+/*
+  find the override for a thread name. With create set the spec name
+  itself is looked up exactly, adding it if needed
+ */
+Thread::Override *Thread::_find_override(const char *name, bool create)
+{
+    if (name == nullptr) {
+        return nullptr;
+    }
+    if (create) {
+        for (uint8_t i = 0; i < _num_overrides; i++) {
+            if (strcmp(_overrides[i].name, name) == 0) {
+                return &_overrides[i];
+            }
+        }
+        if (_num_overrides >= ARRAY_SIZE(_overrides) ||
+            strlen(name) >= sizeof(_overrides[0].name)) {
+            return nullptr;
+        }
+        Override &o = _overrides[_num_overrides++];
+        strcpy(o.name, name);
+        return &o;
+    }
+
+    if (strncmp(name, "ap-", 3) == 0) {
+        name += 3;
+    }
+    // the longest matching prefix wins, so "spi-1" beats "spi"
+    Override *best = nullptr;
+    size_t best_len = 0;
+    for (uint8_t i = 0; i < _num_overrides; i++) {
+        const size_t len = strlen(_overrides[i].name);
+        if (len > best_len && strncmp(name, _overrides[i].name, len) == 0) {
+            best = &_overrides[i];
+            best_len = len;
+        }
+    }
+    return best;
+}
+
+bool Thread::add_priority_override(const char *spec)
+{
+    const char *eq = strchr(spec, '=');
+    if (eq == nullptr || eq == spec || (size_t)(eq - spec) >= sizeof(_overrides[0].name)) {
+        return false;
+    }
+    char name[sizeof(_overrides[0].name)] {};
+    memcpy(name, spec, eq - spec);
+
+    char *end;
+    const long prio = strtol(eq + 1, &end, 10);
+    if (*end != 0 || prio < sched_get_priority_min(SCHED_FIFO) ||
+        prio > sched_get_priority_max(SCHED_FIFO) || prio == 0) {
+        return false;
+    }
+    Override *o = _find_override(name, true);
+    if (o == nullptr) {
+        return false;
+    }
+    o->prio = prio;
+    return true;
+}
+
+bool Thread::add_affinity_override(const char *spec)
+{
+    const char *eq = strchr(spec, '=');
+    if (eq == nullptr || eq == spec || (size_t)(eq - spec) >= sizeof(_overrides[0].name)) {
+        return false;
+    }
+    char name[sizeof(_overrides[0].name)] {};
+    memcpy(name, spec, eq - spec);
+
+    // cpulist in the kernel's format, e.g. "0-1,3"
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    const char *p = eq + 1;
+    while (*p != 0) {
+        char *end;
+        const unsigned long first = strtoul(p, &end, 10);
+        unsigned long last = first;
+        if (end == p) {
+            return false;
+        }
+        if (*end == '-') {
+            p = end + 1;
+            last = strtoul(p, &end, 10);
+            if (end == p || last < first) {
+                return false;
+            }
+        }
+        if (last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (unsigned long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, &cpus);
+        }
+        if (*end == ',') {
+            end++;
+        } else if (*end != 0) {
+            return false;
+        }
+        p = end;
+    }
+    if (CPU_COUNT(&cpus) == 0) {
+        return false;
+    }
+
+    Override *o = _find_override(name, true);
+    if (o == nullptr) {
+        return false;
+    }
+    o->cpus = cpus;
+    o->have_cpus = true;
+    return true;
+}
+
+void Thread::apply_overrides_to_self(const char *name, int policy, int prio)
+{
+    const Override *o = _find_override(name, false);
+    if (o == nullptr) {
+        return;
+    }
+    if (o->have_cpus) {
+        const int r = pthread_setaffinity_np(pthread_self(), sizeof(o->cpus), &o->cpus);
+        if (r != 0) {
+            AP_HAL::panic("Failed to set CPU affinity for thread '%s': %s",
+                          name, strerror(r));
+        }
+    }
+    if (o->prio != 0 && geteuid() == 0) {
+        struct sched_param param = { .sched_priority = o->prio };
+        const int r = pthread_setschedparam(pthread_self(), policy, &param);
+        if (r != 0) {
+            AP_HAL::panic("Failed to set priority for thread '%s': %s",
+                          name, strerror(r));
+        }
+    }
+}
+
 
 void *Thread::_run_trampoline(void *arg)
 {
@@ -165,12 +308,23 @@ bool Thread::start(const char *name, int policy, int prio)
         return false;
     }
 
+    const Override *o = _find_override(name, false);
+    if (o != nullptr && o->prio != 0) {
+        prio = o->prio;
+    }
+
     struct sched_param param = { .sched_priority = prio };
     pthread_attr_t attr;
     int r;
 
     pthread_attr_init(&attr);
 
+    if (o != nullptr && o->have_cpus &&
+        (r = pthread_attr_setaffinity_np(&attr, sizeof(o->cpus), &o->cpus)) != 0) {
+        AP_HAL::panic("Failed to set CPU affinity for thread '%s': %s",
+                      name, strerror(r));
+    }
+
     /*
       we need to run as root to get realtime scheduling. Allow it to
       run as non-root for debugging purposes, plus to allow the Replay
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <pthread.h>
+#include <sched.h>
 #include <inttypes.h>
 #include <stdlib.h>
 
@@ -51,7 +52,33 @@ public:
 
     bool join();
 
+    /*
+     * Scheduling overrides given on the command line, as
+     * "name=priority" or "name=cpulist" (e.g. "spi=2-3"). name matches
+     * thread names with or without their "ap-" prefix, and also
+     * matches as a prefix, so "spi" covers every SPI bus thread. The
+     * main thread is "main". Return false if spec can't be parsed
+     */
+    static bool add_priority_override(const char *spec);
+    static bool add_affinity_override(const char *spec);
+
+    /*
+     * Apply the overrides for name to the calling thread. Used for
+     * threads not started through start()
+     */
+    static void apply_overrides_to_self(const char *name, int policy, int prio);
+
 protected:
+    struct Override {
+        char name[16];
+        int prio;               // 0 when not overridden
+        bool have_cpus;
+        cpu_set_t cpus;
+    };
+    static Override *_find_override(const char *name, bool create);
+    static Override _overrides[16];
+    static uint8_t _num_overrides;
+
     static void *_run_trampoline(void *arg);
 
     /*
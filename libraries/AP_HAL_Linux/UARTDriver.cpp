@@ -49,6 +49,18 @@ void UARTDriver::set_device_path(const char *path)
     device_path = path;
 }
 
+/*
+  return the file descriptor the UART thread can sleep on waiting for
+  received data
+ */
+int UARTDriver::get_poll_fd() const
+{
+    if (!_initialised || !_device.get()) {
+        return -1;
+    }
+    return _device->get_fd();
+}
+
 /*
   open the tty
  */
@@ -353,6 +365,39 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve space for an in-place write. The write mutex is held until
+  write_commit()
+ */
+uint8_t UARTDriver::write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_initialised || !_nonblocking_writes) {
+        return 0;
+    }
+    if (!_write_mutex.take_nonblocking()) {
+        return 0;
+    }
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t n_vec = _writebuf.reserve(vec, len);
+    if (n_vec == 0) {
+        _write_mutex.give();
+    }
+    return n_vec;
+}
+
+/*
+  complete an in-place write started with write_reserve()
+ */
+bool UARTDriver::write_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    _write_mutex.give();
+    return ret;
+}
+
 /*
   try writing n bytes, handling an unresponsive port
  */
@@ -391,35 +436,21 @@ bool UARTDriver::_write_pending_bytes(void)
     uint32_t available_bytes = _writebuf.available();
     uint16_t n = available_bytes;
 
-    if (_packetise && n > 0) {
-        // send on MAVLink packet boundaries if possible
-        n = mavlink_packetise(_writebuf, n);
-    }
-
-    if (n > 0) {
-        int ret;
+    if (_packetise) {
+        _write_pending_datagrams(n);
+    } else if (n > 0) {
+        ByteBuffer::IoVec vec[2];
+        const auto n_vec = _writebuf.peekiovec(vec, n);
+        for (int i = 0; i < n_vec; i++) {
+            int ret = _write_fd(vec[i].data, (uint16_t)vec[i].len);
+            if (ret < 0) {
+                break;
+            }
+            _writebuf.advance(ret);
 
-        if (_packetise) {
-            // keep as a single UDP packet
-            uint8_t tmpbuf[n];
-            _writebuf.peekbytes(tmpbuf, n);
-            ret = _write_fd(tmpbuf, n);
-            if (ret > 0)
-                _writebuf.advance(ret);
-        } else {
-            ByteBuffer::IoVec vec[2];
-            const auto n_vec = _writebuf.peekiovec(vec, n);
-            for (int i = 0; i < n_vec; i++) {
-                ret = _write_fd(vec[i].data, (uint16_t)vec[i].len);
-                if (ret < 0) {
-                    break;
-                }
-                _writebuf.advance(ret);
-
-                /* We wrote less than we asked for, stop */
-                if ((unsigned)ret != vec[i].len) {
-                    break;
-                }
+            /* We wrote less than we asked for, stop */
+            if ((unsigned)ret != vec[i].len) {
+                break;
             }
         }
     }
@@ -427,6 +458,47 @@ bool UARTDriver::_write_pending_bytes(void)
     return _writebuf.available() != available_bytes;
 }
 
+/*
+  send pending bytes as datagrams on MAVLink packet boundaries,
+  combining whole packets up to MAVLINK_PACKETISE_MAX_DATAGRAM bytes
+  and passing several datagrams to the device in one go
+ */
+void UARTDriver::_write_pending_datagrams(uint16_t n)
+{
+    uint8_t tmpbuf[UART_MAX_DATAGRAMS * MAVLINK_PACKETISE_MAX_DATAGRAM];
+    struct iovec dgrams[UART_MAX_DATAGRAMS];
+    uint8_t count = 0;
+    uint16_t total = 0;
+
+    while (count < UART_MAX_DATAGRAMS && total < n) {
+        const uint16_t len = mavlink_packetise_batch(_writebuf, total, n - total,
+                                                     MAVLINK_PACKETISE_MAX_DATAGRAM);
+        if (len == 0 || total + len > sizeof(tmpbuf)) {
+            break;
+        }
+        dgrams[count].iov_base = &tmpbuf[total];
+        dgrams[count].iov_len = len;
+        count++;
+        total += len;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    if (!_connected) {
+        _connected = _device->open();
+    }
+    if (!_connected) {
+        return;
+    }
+
+    _writebuf.peekbytes(tmpbuf, total);
+    const int sent = _device->write_datagrams(dgrams, count);
+    for (int i = 0; i < sent; i++) {
+        _writebuf.advance(dgrams[i].iov_len);
+    }
+}
+
 /*
   push any pending bytes to/from the serial port. This is called at
   1kHz in the timer thread. Doing it this way reduces the system call
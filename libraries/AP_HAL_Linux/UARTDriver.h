@@ -7,6 +7,11 @@
 #include "SerialDevice.h"
 #include "Semaphores.h"
 
+// datagrams handed to the device per write on packetised connections
+#ifndef UART_MAX_DATAGRAMS
+#define UART_MAX_DATAGRAMS 8
+#endif
+
 namespace Linux {
 
 class UARTDriver : public AP_HAL::UARTDriver {
@@ -36,10 +41,16 @@ public:
     /* Linux implementations of Print virtual methods */
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
+    uint8_t write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool write_commit(uint32_t len) override;
 
     void set_device_path(const char *path);
 
+    // file descriptor to wait on for received data, or -1
+    virtual int get_poll_fd() const;
+
     bool _write_pending_bytes(void);
+    void _write_pending_datagrams(uint16_t n);
     virtual void _timer_tick(void) override;
 
     virtual enum flow_control get_flow_control(void) override
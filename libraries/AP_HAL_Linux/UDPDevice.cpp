@@ -1,10 +1,16 @@
 #include "UDPDevice.h"
 
+#include <arpa/inet.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
 
 UDPDevice::UDPDevice(const char *ip, uint16_t port, bool bcast, bool input):
     _ip(ip),
@@ -33,16 +39,98 @@ ssize_t UDPDevice::write(const uint8_t *buf, uint16_t n)
     return socket.sendto(buf, n, _ip, _port);
 }
 
+/*
+  send several datagrams with one system call
+ */
+int UDPDevice::write_datagrams(const struct iovec *dgrams, uint8_t count)
+{
+    if (!_connected) {
+        // each datagram needs its own sendto() with the address
+        return SerialDevice::write_datagrams(dgrams, count);
+    }
+
+    struct mmsghdr msgs[UDP_DEVICE_BATCH] {};
+    count = MIN(count, UDP_DEVICE_BATCH);
+    for (uint8_t i = 0; i < count; i++) {
+        msgs[i].msg_hdr.msg_iov = const_cast<struct iovec *>(&dgrams[i]);
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int ret;
+    do {
+        ret = sendmmsg(socket.get_read_fd(), msgs, count, MSG_DONTWAIT);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret < 0 ? 0 : ret;
+}
+
+/*
+  receive the datagrams waiting on the socket, up to
+  UDP_DEVICE_BATCH, with one system call
+ */
+bool UDPDevice::_read_batch()
+{
+    struct mmsghdr msgs[UDP_DEVICE_BATCH] {};
+    struct iovec iov[UDP_DEVICE_BATCH];
+    for (uint8_t i = 0; i < UDP_DEVICE_BATCH; i++) {
+        iov[i].iov_base = _rx_buf[i];
+        iov[i].iov_len = sizeof(_rx_buf[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // we only need the first sender, to connect back to it
+    struct sockaddr_in from {};
+    msgs[0].msg_hdr.msg_name = &from;
+    msgs[0].msg_hdr.msg_namelen = sizeof(from);
+
+    int ret;
+    do {
+        ret = recvmmsg(socket.get_read_fd(), msgs, UDP_DEVICE_BATCH, MSG_DONTWAIT, nullptr);
+    } while (ret < 0 && errno == EINTR);
+
+    _rx_idx = 0;
+    _rx_ofs = 0;
+    _rx_count = ret > 0 ? ret : 0;
+    if (_rx_count == 0) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < _rx_count; i++) {
+        _rx_len[i] = msgs[i].msg_len;
+    }
+
+    if (!_connected) {
+        _connected = socket.connect(inet_ntoa(from.sin_addr), ntohs(from.sin_port));
+    }
+
+    return true;
+}
+
 ssize_t UDPDevice::read(uint8_t *buf, uint16_t n)
 {
-    ssize_t ret = socket.recv(buf, n, 0);
-    if (!_connected && ret > 0) {
-        const char *ip;
-        uint16_t port;
-        socket.last_recv_address(ip, port);
-        _connected = socket.connect(ip, port);
+    ssize_t ret = 0;
+    bool refilled = false;
+
+    while (ret < n) {
+        if (_rx_idx >= _rx_count) {
+            // at most one system call per read
+            if (refilled || !_read_batch()) {
+                break;
+            }
+            refilled = true;
+        }
+        const uint16_t len = MIN(uint16_t(n - ret), uint16_t(_rx_len[_rx_idx] - _rx_ofs));
+        memcpy(&buf[ret], &_rx_buf[_rx_idx][_rx_ofs], len);
+        ret += len;
+        _rx_ofs += len;
+        if (_rx_ofs >= _rx_len[_rx_idx]) {
+            _rx_idx++;
+            _rx_ofs = 0;
+        }
     }
-    return ret;
+
+    return ret > 0 ? ret : -1;
 }
 
 bool UDPDevice::open()
@@ -3,6 +3,16 @@
 #include "SerialDevice.h"
 #include <AP_HAL/utility/Socket.h>
 
+// datagrams moved per sendmmsg()/recvmmsg() call
+#ifndef UDP_DEVICE_BATCH
+#define UDP_DEVICE_BATCH 8
+#endif
+
+// largest datagram we expect to receive
+#ifndef UDP_DEVICE_MAX_DATAGRAM
+#define UDP_DEVICE_MAX_DATAGRAM 1500
+#endif
+
 class UDPDevice: public SerialDevice {
 public:
     UDPDevice(const char *ip, uint16_t port, bool bcast, bool input);
@@ -14,11 +24,22 @@ public:
     virtual void set_speed(uint32_t speed) override;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
+    virtual int get_fd() const override { return socket.get_read_fd(); }
+    virtual int write_datagrams(const struct iovec *dgrams, uint8_t count) override;
 private:
+    bool _read_batch();
+
     SocketAPM socket{true};
     const char *_ip;
     uint16_t _port;
     bool _bcast;
     bool _input;
     bool _connected = false;
+
+    // datagrams received by the last recvmmsg() and not yet read
+    uint8_t _rx_buf[UDP_DEVICE_BATCH][UDP_DEVICE_MAX_DATAGRAM];
+    uint16_t _rx_len[UDP_DEVICE_BATCH];
+    uint8_t _rx_count = 0;
+    uint8_t _rx_idx = 0;
+    uint16_t _rx_ofs = 0;
 };
@@ -10,6 +10,7 @@
 #include <AP_HAL/AP_HAL.h>
 
 #include "Heat_Pwm.h"
+#include "PollerThread.h"
 #include "ToneAlarm_Disco.h"
 #include "Util.h"
 
@@ -93,6 +94,11 @@ uint32_t Util::available_memory(void)
     return 256*1024;
 }
 
+bool Util::periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max)
+{
+    return TimerPollable::periodic_callback_stats(idx, stats, reset_max);
+}
+
 #ifndef HAL_LINUX_DEFAULT_SYSTEM_ID
 #define HAL_LINUX_DEFAULT_SYSTEM_ID "linux-unknown"
 #endif
@@ -64,6 +64,9 @@ public:
 
     uint32_t available_memory(void) override;
 
+    // get statistics on the idx'th device periodic callback
+    bool periodic_callback_stats(uint8_t idx, AP_HAL::Device::PeriodicStats &stats, bool reset_max) override;
+
     bool get_system_id(char buf[40]) override;
     bool get_system_id_unformatted(uint8_t buf[], uint8_t &len) override;
 
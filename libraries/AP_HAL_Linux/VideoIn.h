@@ -63,6 +63,14 @@ public:
                           uint32_t crop_width, uint32_t top,
                           uint32_t crop_height);
 
+    /* return the start of a crop window inside an 8bpp image, to be
+     * read with the image's own line stride instead of copying it */
+    static uint8_t *crop_8bpp_in_place(uint8_t *buffer, uint32_t bytesperline,
+                                       uint32_t left, uint32_t top)
+    {
+        return buffer + top * bytesperline + left;
+    }
+
     static void yuyv_to_grey(uint8_t *buffer, uint32_t buffer_size,
                              uint8_t *new_buffer);
 
@@ -0,0 +1,57 @@
+#include <AP_gbenchmark.h>
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
+
+#include <AP_HAL_Linux/Flow_PX4.h>
+
+static void BM_FlowPX4(benchmark::State& state)
+{
+    uint8_t *image1, *image2;
+    const uint32_t size = state.range_x();
+    const uint32_t shift = state.range_y();
+
+    image1 = (uint8_t *)malloc(size * size);
+    if (!image1) {
+        fprintf(stderr, "error: couldn't malloc image1\n");
+        return;
+    }
+
+    image2 = (uint8_t *)malloc(size * size);
+    if (!image2) {
+        fprintf(stderr, "error: couldn't malloc image2\n");
+        free(image1);
+        return;
+    }
+
+    /* textured image, and the same image moved right and down */
+    srand(0);
+    for (uint32_t i = 0; i < size * size; i++) {
+        image1[i] = rand();
+    }
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const uint32_t sx = x >= shift ? x - shift : 0;
+            const uint32_t sy = y >= shift ? y - shift : 0;
+            image2[y * size + x] = image1[sy * size + sx];
+        }
+    }
+
+    Linux::Flow_PX4 flow(size, size,
+                         HAL_FLOW_PX4_MAX_FLOW_PIXEL,
+                         HAL_FLOW_PX4_BOTTOM_FLOW_FEATURE_THRESHOLD,
+                         HAL_FLOW_PX4_BOTTOM_FLOW_VALUE_THRESHOLD);
+    float flow_x, flow_y;
+
+    while (state.KeepRunning()) {
+        flow.compute_flow(image1, image2, 0, &flow_x, &flow_y);
+    }
+
+    free(image1);
+    free(image2);
+}
+
+BENCHMARK(BM_FlowPX4)->ArgPair(64, 0)->ArgPair(64, 2)->ArgPair(64, 4);
+#endif
+
+BENCHMARK_MAIN()
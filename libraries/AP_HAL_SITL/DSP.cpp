@@ -83,12 +83,19 @@ void DSP::step_hanning(FFTWindowStateSITL* fft, FloatBuffer& samples, uint16_t a
     // 5us
     // apply hanning window to gyro samples and store result in _freq_bins
     // hanning starts and ends with 0, could be skipped for minor speed improvement
-    uint32_t read_window = samples.peek(&fft->_freq_bins[0], fft->_window_size);
-    if (read_window != fft->_window_size) {
+    // the samples are windowed in place in the ring buffer rather than being copied out first
+    if (samples.available() < fft->_window_size) {
         return;
     }
+    ByteBuffer::IoVec vec[2];
+    const uint8_t n_vec = samples.peekiovec(vec, fft->_window_size);
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        const uint16_t n = vec[i].len / sizeof(float);
+        mult_f32((const float*)vec[i].data, &fft->_hanning_window[offset], &fft->_freq_bins[offset], n);
+        offset += n;
+    }
     samples.advance(advance);
-    mult_f32(&fft->_freq_bins[0], &fft->_hanning_window[0], &fft->_freq_bins[0], fft->_window_size);
 }
 
 // step 2: performm an in-place FFT on the windowed data
@@ -6,6 +6,10 @@
 #include <errno.h>
 #include <signal.h>
 #include <stdio.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
 
 #include "AP_HAL_SITL.h"
 #include "AP_HAL_SITL_Namespace.h"
@@ -158,6 +162,19 @@ void HAL_SITL::exit_signal_handler(int signum)
     HALSITL::Scheduler::_should_exit = true;
 }
 
+static volatile sig_atomic_t snapshot_requested;
+static volatile sig_atomic_t restore_requested;
+
+void HAL_SITL::snapshot_signal_handler(int signum)
+{
+    snapshot_requested = 1;
+}
+
+void HAL_SITL::restore_signal_handler(int signum)
+{
+    restore_requested = 1;
+}
+
 void HAL_SITL::setup_signal_handlers() const
 {
     struct sigaction sa = { };
@@ -165,6 +182,85 @@ void HAL_SITL::setup_signal_handlers() const
     sa.sa_flags = SA_NOCLDSTOP;
     sa.sa_handler = HAL_SITL::exit_signal_handler;
     sigaction(SIGTERM, &sa, NULL);
+
+    sa.sa_handler = HAL_SITL::snapshot_signal_handler;
+    sigaction(SIGUSR1, &sa, NULL);
+    sa.sa_handler = HAL_SITL::restore_signal_handler;
+    sigaction(SIGUSR2, &sa, NULL);
+}
+
+/*
+  snapshot of the whole vehicle, so autotest can start each test from
+  an aligned vehicle without rebooting and waiting for the EKF and GPS.
+
+  SIGUSR1 asks for a snapshot, taken at the end of the next main
+  loop. This process forks and from then on only holds the snapshot;
+  the child carries on as the vehicle, with the same parameters, EKF,
+  physics and simulated time, and the same sockets so connections
+  stay up. SIGUSR2 to this process kills the child and forks a new
+  one, returning the vehicle to the snapshot.
+
+  Only the built in physics models are part of the snapshot
+ */
+void HAL_SITL::take_snapshot() const
+{
+    // simulated time only moves forward in the main thread, so with it
+    // stopped here the other threads end up waiting for time to pass
+    // rather than part way through work, holding a semaphore
+    usleep(200000);
+    fflush(stdout);
+    fflush(stderr);
+
+    bool restoring = false;
+    while (true) {
+        const pid_t pid = fork();
+        if (pid == -1) {
+            ::fprintf(stderr, "Snapshot failed: %s\n", strerror(errno));
+            return;
+        }
+        if (pid == 0) {
+            break;
+        }
+
+        // the snapshot holder must never run the vehicle again
+        alarm(0);
+        signal(SIGALRM, SIG_IGN);
+        restore_requested = 0;
+        while (true) {
+            int status;
+            if (waitpid(pid, &status, WNOHANG) == pid) {
+                // the vehicle exited by itself, so do we
+                exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+            }
+            if (HALSITL::Scheduler::_should_exit) {
+                kill(pid, SIGTERM);
+                waitpid(pid, &status, 0);
+                exit(0);
+            }
+            if (restore_requested) {
+                kill(pid, SIGKILL);
+                waitpid(pid, &status, 0);
+                break;
+            }
+            usleep(10000);
+        }
+        restoring = true;
+    }
+
+#ifdef __linux__
+    // don't outlive the snapshot holder
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+    snapshot_requested = 0;
+    if (restoring) {
+        // storage and the log file were written to after the snapshot
+        sitlStorage.mark_all_dirty();
+#if HAL_LOGGING_ENABLED
+        AP::logger().StopLogging();
+#endif
+    }
+    HALSITL::Scheduler::restart_threads();
+    ::printf("Snapshot %s\n", restoring ? "restored" : "taken");
 }
 
 /*
@@ -243,6 +339,9 @@ void HAL_SITL::run(int argc, char * const argv[], Callbacks* callbacks) const
 
     while (!HALSITL::Scheduler::_should_reboot) {
         if (HALSITL::Scheduler::_should_exit) {
+#if !defined(HAL_BUILD_AP_PERIPH)
+            _sitl_state->profile_summary();
+#endif
             ::fprintf(stderr, "Exitting\n");
             exit(0);
         }
@@ -254,6 +353,10 @@ void HAL_SITL::run(int argc, char * const argv[], Callbacks* callbacks) const
         callbacks->loop();
         HALSITL::Scheduler::_run_io_procs();
 
+        if (snapshot_requested) {
+            take_snapshot();
+        }
+
         uint32_t now = AP_HAL::millis();
         if (now - last_watchdog_save >= 100 && using_watchdog) {
             // save persistent data every 100ms
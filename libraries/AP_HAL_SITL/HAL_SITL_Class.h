@@ -19,6 +19,9 @@ private:
 
     void setup_signal_handlers() const;
     static void exit_signal_handler(int);
+    static void snapshot_signal_handler(int);
+    static void restore_signal_handler(int);
+    void take_snapshot() const;
 };
 
 #if HAL_NUM_CAN_IFACES
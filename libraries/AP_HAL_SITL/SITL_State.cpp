@@ -14,7 +14,9 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <sys/select.h>
+#include <time.h>
 
+#include <AP_Logger/AP_Logger.h>
 #include <AP_Param/AP_Param.h>
 #include <SITL/SIM_JSBSim.h>
 #include <AP_HAL/utility/Socket.h>
@@ -176,6 +178,8 @@ void SITL_State::_fdm_input_step(void)
         return;
     }
 
+    uint64_t start_us = wall_time_us();
+
     if (_sitl != nullptr) {
         _update_gps(_sitl->state.latitude, _sitl->state.longitude,
                     _sitl->state.altitude,
@@ -194,9 +198,117 @@ void SITL_State::_fdm_input_step(void)
         }
     }
 
+    profile_stage(ProfileStage::SENSORS, start_us);
+
     // trigger all APM timers.
     _scheduler->timer_event();
     _scheduler->sitl_end_atomic();
+
+    profile_stage(ProfileStage::TIMERS, start_us);
+    profile_log();
+}
+
+uint64_t SITL_State::wall_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000U;
+}
+
+/*
+  account the time since start_us to a stage, and start timing the
+  next one
+ */
+void SITL_State::profile_stage(ProfileStage stage, uint64_t &start_us)
+{
+    const uint64_t now_us = wall_time_us();
+    _profile_total.stage_us[uint8_t(stage)] += now_us - start_us;
+    start_us = now_us;
+}
+
+/*
+  log the average time per step of each stage once a second of
+  simulation time
+ */
+void SITL_State::profile_log(void)
+{
+    const uint64_t sim_us = AP_HAL::micros64();
+    const uint64_t wall_us = wall_time_us();
+
+    if (_profile_start_wall_us == 0) {
+        _profile_start_wall_us = _profile_last_log_wall_us = wall_us;
+        _profile_start_sim_us = _profile_last_log_sim_us = sim_us;
+        _profile_last_log = _profile_total;
+        return;
+    }
+    if (sim_us - _profile_last_log_sim_us < 1000000U) {
+        return;
+    }
+
+    const uint32_t steps = _profile_total.steps - _profile_last_log.steps;
+    const uint64_t dt_wall_us = wall_us - _profile_last_log_wall_us;
+    float stage_us[uint8_t(ProfileStage::NUM_STAGES)];
+    uint64_t staged_us = 0;
+    for (uint8_t i=0; i<uint8_t(ProfileStage::NUM_STAGES); i++) {
+        const uint64_t dt_us = _profile_total.stage_us[i] - _profile_last_log.stage_us[i];
+        staged_us += dt_us;
+        stage_us[i] = steps ? float(dt_us) / steps : 0;
+    }
+    const float other_us = (steps && dt_wall_us > staged_us) ? float(dt_wall_us - staged_us) / steps : 0;
+    const float speedup = dt_wall_us ? float(sim_us - _profile_last_log_sim_us) / dt_wall_us : 0;
+
+#if HAL_LOGGING_ENABLED
+// @LoggerMessage: SPRF
+// @Description: Simulation step profile
+// @Field: TimeUS: Time since system startup
+// @Field: Steps: physics steps since the last message
+// @Field: Phys: wall clock time per step in the vehicle model
+// @Field: Sens: wall clock time per step in simulated sensors and devices
+// @Field: Tim: wall clock time per step in vehicle timer callbacks
+// @Field: Oth: wall clock time per step elsewhere, mostly vehicle code
+// @Field: Spd: achieved speedup
+    AP::logger().Write("SPRF", "TimeUS,Steps,Phys,Sens,Tim,Oth,Spd", "QIfffff",
+                       sim_us,
+                       steps,
+                       stage_us[uint8_t(ProfileStage::PHYSICS)],
+                       stage_us[uint8_t(ProfileStage::SENSORS)],
+                       stage_us[uint8_t(ProfileStage::TIMERS)],
+                       other_us,
+                       speedup);
+#else
+    (void)other_us;
+    (void)speedup;
+#endif
+
+    _profile_last_log = _profile_total;
+    _profile_last_log_wall_us = wall_us;
+    _profile_last_log_sim_us = sim_us;
+}
+
+void SITL_State::profile_summary(void) const
+{
+    if (_profile_start_wall_us == 0 || _profile_total.steps == 0) {
+        return;
+    }
+    static const char *stage_names[] { "physics", "sensors", "timers" };
+    static_assert(ARRAY_SIZE(stage_names) == uint8_t(ProfileStage::NUM_STAGES), "stage_names must match ProfileStage");
+
+    const uint64_t wall_us = MAX(wall_time_us() - _profile_start_wall_us, 1U);
+    const uint64_t sim_us = AP_HAL::micros64() - _profile_start_sim_us;
+    const uint32_t steps = _profile_total.steps;
+
+    ::fprintf(stderr, "SITL profile: %u steps, %.1fs wall, speedup %.2f\n",
+              unsigned(steps), wall_us*1.0e-6, double(sim_us) / wall_us);
+    uint64_t staged_us = 0;
+    for (uint8_t i=0; i<uint8_t(ProfileStage::NUM_STAGES); i++) {
+        const uint64_t us = _profile_total.stage_us[i];
+        staged_us += us;
+        ::fprintf(stderr, "  %-8s %8.2fs %5.1f%% %8.1fus/step\n",
+                  stage_names[i], us*1.0e-6, 100.0 * us / wall_us, double(us) / steps);
+    }
+    const uint64_t other_us = wall_us > staged_us ? wall_us - staged_us : 0;
+    ::fprintf(stderr, "  %-8s %8.2fs %5.1f%% %8.1fus/step\n",
+              "other", other_us*1.0e-6, 100.0 * other_us / wall_us, double(other_us) / steps);
 }
 
 
@@ -604,6 +716,7 @@ void SITL_State::_output_to_flightgear(void)
 void SITL_State::_fdm_input_local(void)
 {
     struct sitl_input input;
+    uint64_t start_us = wall_time_us();
 
     // check for direct RC input
     if (_sitl != nullptr) {
@@ -628,6 +741,8 @@ void SITL_State::_fdm_input_local(void)
         }
     }
 
+    profile_stage(ProfileStage::PHYSICS, start_us);
+
     if (gimbal != nullptr) {
         gimbal->update();
     }
@@ -725,6 +840,9 @@ void SITL_State::_fdm_input_local(void)
         _output_to_flightgear();
     }
 
+    profile_stage(ProfileStage::SENSORS, start_us);
+    _profile_total.steps++;
+
     // update simulation time
     if (_sitl) {
         hal.scheduler->stop_clock(_sitl->state.timestamp_us);
@@ -129,6 +129,9 @@ public:
     
     uint8_t get_instance() const { return _instance; }
 
+    // print where the wall clock time of the simulation went
+    void profile_summary(void) const;
+
 private:
     void _parse_command_line(int argc, char * const argv[]);
     void _set_param_default(const char *parm);
@@ -198,6 +201,32 @@ private:
     pid_t _parent_pid;
     uint32_t _update_count;
 
+    /*
+      wall clock time spent in each stage of a simulation step, to
+      find the bottleneck when running at a high speedup. Time not
+      spent in a stage is the vehicle code and waiting for the clock
+     */
+    enum class ProfileStage : uint8_t {
+        PHYSICS = 0,    // vehicle model update
+        SENSORS,        // sensors and simulated devices
+        TIMERS,         // vehicle timer callbacks
+        NUM_STAGES
+    };
+    struct ProfileCounters {
+        uint64_t stage_us[uint8_t(ProfileStage::NUM_STAGES)];
+        uint32_t steps;
+    };
+    ProfileCounters _profile_total;
+    ProfileCounters _profile_last_log;
+    uint64_t _profile_start_wall_us;
+    uint64_t _profile_start_sim_us;
+    uint64_t _profile_last_log_wall_us;
+    uint64_t _profile_last_log_sim_us;
+
+    static uint64_t wall_time_us(void);
+    void profile_stage(ProfileStage stage, uint64_t &start_us);
+    void profile_log(void);
+
     AP_Baro *_barometer;
     AP_InertialSensor *_ins;
     Scheduler *_scheduler;
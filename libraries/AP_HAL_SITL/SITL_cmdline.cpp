@@ -111,6 +111,7 @@ void SITL_State::_usage(void)
            "\t--irlock-port PORT       set port num for irlock\n"
            "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
            "\t--sysid ID               set SYSID_THISMAV\n"
+           "\t--lockstep N[:GROUP]     run in lockstep with N instances (-I 0 to N-1) in GROUP instead of in real time\n"
         );
 }
 
@@ -202,6 +203,8 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     char *autotest_dir = nullptr;
     _fg_address = "127.0.0.1";
     const char* config = "";
+    uint8_t lockstep_instances = 0;
+    const char *lockstep_group = "default";
 
     const int BASE_PORT = 5760;
     const int RCIN_PORT = 5501;
@@ -258,6 +261,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_IRLOCK_PORT,
         CMDLINE_START_TIME,
         CMDLINE_SYSID,
+        CMDLINE_LOCKSTEP,
     };
 
     const struct GetOptLong::option options[] = {
@@ -305,6 +309,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"irlock-port",     true,   0, CMDLINE_IRLOCK_PORT},
         {"start-time",      true,   0, CMDLINE_START_TIME},
         {"sysid",           true,   0, CMDLINE_SYSID},
+        {"lockstep",        true,   0, CMDLINE_LOCKSTEP},
         {0, false, 0, 0}
     };
 
@@ -457,6 +462,19 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
             printf("Setting SYSID_THISMAV=%d\n", sysid);
             break;
         }
+        case CMDLINE_LOCKSTEP: {
+            char *group = nullptr;
+            const long n = strtol(gopt.optarg, &group, 10);
+            if (n < 1 || n > SITL_LOCKSTEP_MAX_INSTANCES) {
+                fprintf(stderr, "You must specify between 1 and %u lockstep instances\n", unsigned(SITL_LOCKSTEP_MAX_INSTANCES));
+                exit(1);
+            }
+            lockstep_instances = n;
+            if (*group == ':' && group[1] != 0) {
+                lockstep_group = group+1;
+            }
+            break;
+        }
         case 'h':
             _usage();
             exit(0);
@@ -498,6 +516,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
             sitl_model->set_interface_ports(simulator_address, simulator_port_in, simulator_port_out);
             sitl_model->set_speedup(speedup);
             sitl_model->set_instance(_instance);
+            if (lockstep_instances > 0 &&
+                !sitl_model->enable_lockstep(lockstep_group, lockstep_instances)) {
+                printf("Failed to join lockstep group %s\n", lockstep_group);
+                exit(1);
+            }
             sitl_model->set_autotest_dir(autotest_dir);
             sitl_model->set_config(config);
             _synthetic_clock_mode = true;
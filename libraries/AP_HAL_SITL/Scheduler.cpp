@@ -291,6 +291,22 @@ void *Scheduler::thread_create_trampoline(void *ctx)
     return nullptr;
 }
 
+/*
+  only the thread calling fork() exists in the new process. Start the
+  others again from the beginning of their thread function, reusing
+  their stacks
+*/
+void Scheduler::restart_threads(void)
+{
+    WITH_SEMAPHORE(_thread_sem);
+    for (struct thread_attr *a=threads; a; a=a->next) {
+        pthread_t thread {};
+        if (pthread_create(&thread, &a->attr, thread_create_trampoline, a) != 0) {
+            AP_HAL::panic("Failed to restart thread %s", a->name);
+        }
+    }
+}
+
 #ifndef PTHREAD_STACK_MIN
 #define PTHREAD_STACK_MIN 16384U
 #endif
@@ -59,6 +59,9 @@ public:
     bool thread_create(AP_HAL::MemberProc, const char *name,
                        uint32_t stack_size, priority_base base, int8_t priority) override;
 
+    // start the threads from thread_create() again after a fork()
+    static void restart_threads(void);
+
     void set_in_semaphore_take_wait(bool value) { _in_semaphore_take_wait = value; }
     /*
      * semaphore_wait_hack_required - possibly move time input step
@@ -27,6 +27,10 @@ public:
     void _timer_tick(void) override;
     bool healthy(void) override;
 
+    // write all of storage out again, for when the file may not match
+    // what we have in memory
+    void mark_all_dirty(void) { _dirty_mask.setall(); }
+
 private:
     volatile bool _initialised;
     void _storage_create(void);
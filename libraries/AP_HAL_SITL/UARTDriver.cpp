@@ -263,7 +263,26 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return size;
 }
 
-    
+
+/*
+  reserve space for an in-place write
+ */
+uint8_t UARTDriver::write_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (_unbuffered_writes || txspace() <= len) {
+        return 0;
+    }
+    return _writebuffer.reserve(vec, len);
+}
+
+/*
+  complete an in-place write started with write_reserve()
+ */
+bool UARTDriver::write_commit(uint32_t len)
+{
+    return _writebuffer.commit(len);
+}
+
 /*
   start a TCP connection for the serial port. If wait_for_connection
   is true then block until a client connects
@@ -695,7 +714,8 @@ void UARTDriver::_timer_tick(void)
         uint16_t n = _writebuffer.available();
         n = MIN(n, max_bytes);
         if (n > 0) {
-            n = mavlink_packetise(_writebuffer, n);
+            // combine whole packets into one datagram
+            n = mavlink_packetise_batch(_writebuffer, 0, n, MAVLINK_PACKETISE_MAX_DATAGRAM);
         }
         if (n > 0) {
             // keep as a single UDP packet
@@ -54,6 +54,8 @@ public:
     /* Implementations of Print virtual methods */
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
+    uint8_t write_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool write_commit(uint32_t len) override;
 
     // file descriptor, exposed so SITL_State::loop_hook() can use it
     int _fd;
@@ -35,6 +35,7 @@
 #include <AP_Notify/AP_Notify.h>
 #include <AP_Mission/AP_Mission.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_RCTelemetry/AP_RCTelemetry.h>
 #include <stdio.h>
 
 #define PROT_BINARY   0x80
@@ -132,15 +133,10 @@ void AP_Hott_Telem::send_EAM(void)
         msg.temp2 = uint8_t(baro.get_temperature(1) + 20.5);
     }
 
-    AP_AHRS &ahrs = AP::ahrs();
-    float alt = 0;
-    Vector3f vel;
-    {
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        ahrs.get_relative_position_D_home(alt);
-        alt = -alt;
-        IGNORE_RETURN(ahrs.get_velocity_NED(vel));
-    }
+    AP_RCTelemetry::NavSnapshot nav;
+    AP_RCTelemetry::get_nav_snapshot(nav);
+    const float alt = -nav.relative_alt_D;
+    const Vector3f &vel = nav.velocity_NED;
     msg.altitude = uint16_t(500.5 + alt);
 
     msg.climbrate = uint16_t(30000.5 + vel.z * -100);
@@ -163,8 +159,7 @@ void AP_Hott_Telem::send_EAM(void)
     if (airspeed && airspeed->healthy()) {
         msg.speed = uint16_t(airspeed->get_airspeed() * 3.6 + 0.5);
     } else {
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        msg.speed = uint16_t(ahrs.groundspeed() * 3.6 + 0.5);
+        msg.speed = uint16_t(nav.groundspeed * 3.6 + 0.5);
     }
 
     send_packet((const uint8_t *)&msg, sizeof(msg));
@@ -255,19 +250,14 @@ void AP_Hott_Telem::send_GPS(void)
     msg.pos_EW_dm = dm;
     msg.pos_EW_sec = sec;
 
-    AP_AHRS &ahrs = AP::ahrs();
-    Vector2f home_vec;
-    float alt = 0;
-    Vector3f vel;
-    {
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        if (ahrs.get_relative_position_NE_home(home_vec)) {
-            msg.home_distance = home_vec.length();
-        }
-        ahrs.get_relative_position_D_home(alt);
-        alt = -alt;
-        IGNORE_RETURN(ahrs.get_velocity_NED(vel));
+    AP_RCTelemetry::NavSnapshot nav;
+    AP_RCTelemetry::get_nav_snapshot(nav);
+    const Vector2f &home_vec = nav.home_NE;
+    if (nav.have_home_NE) {
+        msg.home_distance = home_vec.length();
     }
+    const float alt = -nav.relative_alt_D;
+    const Vector3f &vel = nav.velocity_NED;
 
     msg.climbrate = uint16_t(30000.5 + vel.z * -100);
     msg.climbrate3s = 120 + vel.z * -3;
@@ -315,16 +305,11 @@ void AP_Hott_Telem::send_Vario(void)
         uint8_t  stop_byte = 0x7D;   //#44 stop
     } msg {};
 
-    AP_AHRS &ahrs = AP::ahrs();
-    Vector3f vel;
-    float alt = 0;
-    {
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        ahrs.get_relative_position_D_home(alt);
-        alt = -alt;
-        IGNORE_RETURN(ahrs.get_velocity_NED(vel));
-        msg.yaw = wrap_360_cd(ahrs.yaw_sensor) * 0.005;
-    }
+    AP_RCTelemetry::NavSnapshot nav;
+    AP_RCTelemetry::get_nav_snapshot(nav);
+    const float alt = -nav.relative_alt_D;
+    const Vector3f &vel = nav.velocity_NED;
+    msg.yaw = wrap_360_cd(nav.yaw_sensor) * 0.005;
 
     min_alt = MIN(alt, min_alt);
     max_alt = MAX(alt, max_alt);
@@ -285,13 +285,58 @@ void AP_IOMCU::send_servo_out()
         uint32_t now = AP_HAL::micros();
         if (now - last_servo_out_us >= 2000) {
             // don't send data at more than 500Hz
-            if (write_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm)) {
+            bool ok;
+            if (is_chibios_backend) {
+                ok = send_servo_out_and_read(n);
+            } else {
+                ok = write_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm);
+            }
+            if (ok) {
                 last_servo_out_us = now;
             }
         }
     }
 }
 
+/*
+  send servo output data, reading back whichever of the RC input,
+  status and servo pages is due in the same transaction. While outputs
+  are running this replaces the separate reads in the main loop, so
+  each output cycle costs one round trip
+ */
+bool AP_IOMCU::send_servo_out_and_read(uint8_t n)
+{
+    const uint32_t now = AP_HAL::millis();
+    if (now - last_rc_read_ms > 20) {
+        if (!write_read_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm,
+                                  PAGE_RAW_RCIN, sizeof(rc_input)/2, (uint16_t *)&rc_input)) {
+            return false;
+        }
+        handle_rc_input();
+        last_rc_read_ms = AP_HAL::millis();
+        return true;
+    }
+    if (now - last_status_read_ms > 50) {
+        if (!write_read_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm,
+                                  PAGE_STATUS, sizeof(reg_status)/2, (uint16_t *)&reg_status)) {
+            read_status_errors++;
+            return false;
+        }
+        handle_status();
+        last_status_read_ms = AP_HAL::millis();
+        return true;
+    }
+    if (now - last_servo_read_ms > 50) {
+        if (!write_read_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm,
+                                  PAGE_SERVOS, pwm_out.num_channels, pwm_in.pwm)) {
+            return false;
+        }
+        last_servo_read_ms = AP_HAL::millis();
+        return true;
+    }
+    return write_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm);
+}
+
 /*
   read RC input
  */
@@ -301,6 +346,14 @@ void AP_IOMCU::read_rc_input()
     if (!read_registers(PAGE_RAW_RCIN, 0, sizeof(rc_input)/2, r)) {
         return;
     }
+    handle_rc_input();
+}
+
+/*
+  handle new RC input page
+ */
+void AP_IOMCU::handle_rc_input()
+{
     if (rc_input.flags_failsafe && rc().ignore_rc_failsafe()) {
         rc_input.flags_failsafe = false;
     }
@@ -319,6 +372,14 @@ void AP_IOMCU::read_status()
         read_status_errors++;
         return;
     }
+    handle_status();
+}
+
+/*
+  handle new status page
+ */
+void AP_IOMCU::handle_status()
+{
     if (read_status_ok == 0) {
         // reset error count on first good read
         read_status_errors = 0;
@@ -474,6 +535,16 @@ bool AP_IOMCU::read_registers(uint8_t page, uint8_t offset, uint8_t count, uint1
         return false;
     }
 
+    return read_reply(page, offset, count, regs);
+}
+
+/*
+  receive the reply to a read of count registers
+*/
+bool AP_IOMCU::read_reply(uint8_t page, uint8_t offset, uint8_t count, uint16_t *regs)
+{
+    IOPacket pkt;
+
     // wait for the expected number of reply bytes or timeout
     if (!uart.wait_timeout(count*2+4, 10)) {
         debug("t=%u timeout read page=%u offset=%u count=%u\n",
@@ -489,8 +560,9 @@ bool AP_IOMCU::read_registers(uint8_t page, uint8_t offset, uint8_t count, uint1
         protocol_fail_count++;
         return false;
     }
-    if (pkt.get_size() != n) {
-        debug("t=%u bad len %u %u\n", AP_HAL::millis(), n, pkt.get_size());
+    const uint8_t expected_size = count*2 + 4;
+    if (n != expected_size) {
+        debug("t=%u bad len %u %u\n", AP_HAL::millis(), n, expected_size);
         protocol_fail_count++;
         return false;
     }
@@ -606,6 +678,42 @@ bool AP_IOMCU::write_registers(uint8_t page, uint8_t offset, uint8_t count, cons
     return true;
 }
 
+/*
+  write count 16 bit registers and read back read_count registers in
+  one transaction, saving a round trip over a write followed by a read
+*/
+bool AP_IOMCU::write_read_registers(uint8_t page, uint8_t offset, uint8_t count, const uint16_t *regs,
+                                    uint8_t read_page, uint8_t read_count, uint16_t *read_regs)
+{
+    if (count >= PKT_MAX_REGS || read_count > PKT_MAX_REGS) {
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return false;
+    }
+    IOPacket pkt;
+
+    discard_input();
+
+    pkt.code = CODE_WRITE_READ;
+    pkt.count = count+1;
+    pkt.page = page;
+    pkt.offset = offset;
+    pkt.crc = 0;
+    memcpy(pkt.regs, regs, 2*count);
+    pkt.regs[count] = (uint16_t(read_page) << 8) | read_count;
+    pkt.crc = crc_crc8((const uint8_t *)&pkt, pkt.get_size());
+
+    const uint8_t pkt_size = pkt.get_size();
+    size_t ret = write_wait((uint8_t *)&pkt, pkt_size);
+
+    if (ret != pkt_size) {
+        debug("write failed3 %u %u %u %u\n", pkt_size, page, offset, ret);
+        protocol_fail_count++;
+        return false;
+    }
+
+    return read_reply(read_page, 0, read_count, read_regs);
+}
+
 // modify a single register
 bool AP_IOMCU::modify_register(uint8_t page, uint8_t offset, uint16_t clearbits, uint16_t setbits)
 {
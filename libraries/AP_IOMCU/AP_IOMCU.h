@@ -126,6 +126,14 @@ private:
     // write count 16 bit registers
     bool write_registers(uint8_t page, uint8_t offset, uint8_t count, const uint16_t *regs);
 
+    // write count 16 bit registers and read read_count registers from
+    // the start of read_page in a single transaction
+    bool write_read_registers(uint8_t page, uint8_t offset, uint8_t count, const uint16_t *regs,
+                              uint8_t read_page, uint8_t read_count, uint16_t *read_regs);
+
+    // receive the reply to a read
+    bool read_reply(uint8_t page, uint8_t offset, uint8_t count, uint16_t *regs);
+
     // write a single register
     bool write_register(uint8_t page, uint8_t offset, uint16_t v) {
         return write_registers(page, offset, 1, &v);
@@ -158,9 +166,12 @@ private:
     bool last_safety_off;
 
     void send_servo_out(void);
+    bool send_servo_out_and_read(uint8_t n);
     void read_rc_input(void);
+    void handle_rc_input(void);
     void read_servo(void);
     void read_status(void);
+    void handle_status(void);
     void discard_input(void);
     void event_failed(uint32_t event_mask);
     void update_safety_options(void);
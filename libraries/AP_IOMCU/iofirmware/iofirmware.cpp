@@ -392,6 +392,41 @@ void AP_IOMCU_FW::process_io_packet()
         }
     }
     break;
+    case CODE_WRITE_READ: {
+        if (rx_io_packet.count == 0) {
+            iomcu.reg_status.num_errors++;
+            iomcu.reg_status.err_bad_opcode++;
+            break;
+        }
+        const uint16_t read_request = rx_io_packet.regs[rx_io_packet.count-1];
+        rx_io_packet.count--;
+        if (!handle_code_write()) {
+            tx_io_packet.count = 0;
+            tx_io_packet.code = CODE_ERROR;
+            tx_io_packet.crc = 0;
+            tx_io_packet.page = 0;
+            tx_io_packet.offset = 0;
+            tx_io_packet.crc =  crc_crc8((const uint8_t *)&tx_io_packet, tx_io_packet.get_size());
+            iomcu.reg_status.num_errors++;
+            iomcu.reg_status.err_write++;
+            break;
+        }
+        // the reply is the read, the write was successful if it arrives
+        rx_io_packet.page = read_request >> 8;
+        rx_io_packet.offset = 0;
+        rx_io_packet.count = MIN(read_request & 0xFF, PKT_MAX_REGS);
+        if (!handle_code_read()) {
+            tx_io_packet.count = 0;
+            tx_io_packet.code = CODE_ERROR;
+            tx_io_packet.crc = 0;
+            tx_io_packet.page = 0;
+            tx_io_packet.offset = 0;
+            tx_io_packet.crc =  crc_crc8((const uint8_t *)&tx_io_packet, tx_io_packet.get_size());
+            iomcu.reg_status.num_errors++;
+            iomcu.reg_status.err_read++;
+        }
+    }
+    break;
     default: {
         iomcu.reg_status.num_errors++;
         iomcu.reg_status.err_bad_opcode++;
@@ -34,6 +34,11 @@ enum iocode {
     // read types
     CODE_READ = 0,
     CODE_WRITE = 1,
+    // write, then read back in the same transaction. The last
+    // register of the packet is not written, it gives the page to
+    // read in the high byte and the number of registers in the low
+    // byte, starting at offset 0
+    CODE_WRITE_READ = 2,
 
     // reply codes
     CODE_SUCCESS = 0,
@@ -89,7 +94,7 @@ enum iopage {
 #define PAGE_CONFIG_PROTOCOL_VERSION  0
 #define PAGE_CONFIG_PROTOCOL_VERSION2 1
 #define IOMCU_PROTOCOL_VERSION       4
-#define IOMCU_PROTOCOL_VERSION2     10
+#define IOMCU_PROTOCOL_VERSION2     11
 
 // magic value for rebooting to bootloader
 #define REBOOT_BL_MAGIC 14662
@@ -1589,6 +1589,54 @@ void AP_InertialSensor::update(void)
   delays occur we need to cope with them. The long term sum of
   _delta_time should be exactly equal to the wall clock elapsed time
  */
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+/*
+  start delivering filtered primary gyro samples to a rate loop,
+  decimated to no more than max_rate_hz
+ */
+bool AP_InertialSensor::enable_rate_loop_samples(uint16_t max_rate_hz)
+{
+    const uint16_t raw_rate_hz = get_raw_gyro_rate_hz();
+    if (_rate_loop.samples != nullptr || raw_rate_hz == 0 || max_rate_hz == 0) {
+        return false;
+    }
+    _rate_loop.decimation = constrain_int16((raw_rate_hz + max_rate_hz - 1) / max_rate_hz, 1, UINT8_MAX);
+    _rate_loop.dt = _rate_loop.decimation / float(raw_rate_hz);
+    _rate_loop.samples = new ObjectBuffer<Vector3f>(4);
+    if (_rate_loop.samples == nullptr || _rate_loop.samples->get_size() == 0) {
+        delete _rate_loop.samples;
+        _rate_loop.samples = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/*
+  get the newest filtered primary gyro sample for the rate loop,
+  waiting up to timeout_us for one to arrive
+ */
+bool AP_InertialSensor::get_next_rate_loop_sample(Vector3f &gyro, uint32_t timeout_us)
+{
+    if (_rate_loop.samples == nullptr) {
+        return false;
+    }
+    const uint32_t start_us = AP_HAL::micros();
+    while (_rate_loop.samples->is_empty()) {
+        if (AP_HAL::micros() - start_us > timeout_us) {
+            return false;
+        }
+        // sleep for a fraction of the sample period
+        hal.scheduler->delay_microseconds(MAX(uint32_t(_rate_loop.dt * 1.0e6f) / 8, 20U));
+    }
+    // if we have fallen behind then skip to the newest sample
+    Vector3f sample;
+    while (_rate_loop.samples->pop(sample)) {
+        gyro = sample;
+    }
+    return true;
+}
+#endif // AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+
 void AP_InertialSensor::wait_for_sample(void)
 {
     if (_have_sample) {
@@ -35,6 +35,11 @@
 #define HAL_INS_TEMPERATURE_CAL_ENABLE !HAL_MINIMIZE_FEATURES && BOARD_FLASH_SIZE > 1024
 #endif
 
+// filtered primary gyro samples delivered at the sensor rate to a rate loop thread
+#ifndef AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+#define AP_INERTIALSENSOR_RATE_LOOP_ENABLED !HAL_MINIMIZE_FEATURES
+#endif
+
 
 #include <stdint.h>
 
@@ -238,6 +243,20 @@ public:
     uint8_t get_primary_accel(void) const { return _primary_accel; }
     uint8_t get_primary_gyro(void) const { return _primary_gyro; }
 
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+    // start delivering filtered primary gyro samples to a rate loop,
+    // decimated to no more than max_rate_hz. Returns false if the
+    // sample buffer could not be allocated
+    bool enable_rate_loop_samples(uint16_t max_rate_hz);
+
+    // get the newest filtered primary gyro sample for the rate loop,
+    // waiting up to timeout_us for one to arrive
+    bool get_next_rate_loop_sample(Vector3f &gyro, uint32_t timeout_us);
+
+    // return the period in seconds between rate loop samples
+    float get_rate_loop_dt(void) const { return _rate_loop.dt; }
+#endif
+
     // Update the harmonic notch frequency
     void update_harmonic_notch_freq_hz(float scaled_freq);
     // Update the harmonic notch frequencies
@@ -334,6 +353,10 @@ public:
     // return time in microseconds of last update() call
     uint32_t get_last_update_usec(void) const { return _last_update_usec; }
 
+    // return time in microseconds that the latest primary gyro sample
+    // used by update() came out of the filters
+    uint64_t get_gyro_sample_usec(void) const { return _gyro_published_us[_primary_gyro]; }
+
     // for killing an IMU for testing purposes
     void kill_imu(uint8_t imu_idx, bool kill_it);
 
@@ -385,6 +408,7 @@ public:
         enum batch_opt_t {
             BATCH_OPT_SENSOR_RATE = (1<<0),
             BATCH_OPT_POST_FILTER = (1<<1),
+            BATCH_OPT_STREAM      = (1<<2),
         };
 
         void rotate_to_next_sensor();
@@ -392,9 +416,21 @@ public:
 
         bool should_log(uint8_t instance, IMU_SENSOR_TYPE type);
         void push_data_to_log();
+        float sample_rate_hz(uint8_t instance, IMU_SENSOR_TYPE type) const;
+
+        // streaming of all sensors at once, see BATCH_OPT_STREAM
+        struct Stream;
+        struct StreamChunk;
+        bool init_streams();
+        void sample_stream(uint8_t instance, IMU_SENSOR_TYPE type, uint64_t sample_us, const Vector3f &sample);
+        void push_streams_to_log();
+        Stream *streams[INS_MAX_INSTANCES][2] {};
+        uint8_t num_streams;
+        bool streaming;
 
         // Logging functions
-        bool Write_ISBH(const float sample_rate_hz) const;
+        bool Write_ISBH(uint16_t seqno, IMU_SENSOR_TYPE sensor_type, uint8_t sensor_instance,
+                        uint16_t mul, uint64_t sample_us, const float sample_rate_hz) const;
         bool Write_ISBD() const;
 
         uint64_t measurement_started_us;
@@ -496,6 +532,17 @@ private:
     bool _new_accel_data[INS_MAX_INSTANCES];
     bool _new_gyro_data[INS_MAX_INSTANCES];
 
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+    // samples pushed by the primary gyro's backend and popped by the
+    // rate loop thread
+    struct {
+        ObjectBuffer<Vector3f> *samples;
+        uint8_t decimation;
+        uint8_t count;
+        float dt;
+    } _rate_loop;
+#endif
+
     // optional notch filter on gyro
     NotchFilterParams _notch_filter;
     NotchFilterVector3f _gyro_notch_filter[INS_MAX_INSTANCES];
@@ -555,6 +602,11 @@ private:
     uint64_t _accel_last_sample_us[INS_MAX_INSTANCES];
     uint64_t _gyro_last_sample_us[INS_MAX_INSTANCES];
 
+    // time the latest gyro sample was filtered by the backend, and
+    // the time of the sample taken by the last update()
+    uint64_t _gyro_filtered_us[INS_MAX_INSTANCES];
+    uint64_t _gyro_published_us[INS_MAX_INSTANCES];
+
     // sample times for checking real sensor rate for FIFO sensors
     uint16_t _sample_accel_count[INS_MAX_INSTANCES];
     uint32_t _sample_accel_start_us[INS_MAX_INSTANCES];
@@ -160,6 +160,84 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     }
 }
 
+/*
+  get the board rotation as a matrix
+ */
+static Matrix3f board_rotation_matrix(enum Rotation board_orientation, const Matrix3f *custom_rotation)
+{
+    if (board_orientation == ROTATION_CUSTOM && custom_rotation) {
+        return *custom_rotation;
+    }
+    Matrix3f m;
+    m.from_rotation(board_orientation);
+    return m;
+}
+
+/*
+  fold the raw scale, sensor rotation, offsets, scaling and board
+  rotation of _rotate_and_correct_accel() into a single affine
+  transform, so a block of FIFO samples costs one matrix multiply each
+ */
+bool AP_InertialSensor_Backend::_get_accel_transform(uint8_t instance, float raw_scale, Matrix3f &M, Vector3f &c) const
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning || _imu.tcal[instance].enable == AP_InertialSensor::TCal::Enable::Enabled) {
+        // temperature correction is non-linear, use the per sample path
+        return false;
+    }
+#endif
+
+    Matrix3f sensor_rot;
+    sensor_rot.from_rotation(_imu._accel_orientation[instance]);
+    Matrix3f S = sensor_rot * raw_scale;
+    c.zero();
+
+    if (!_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    )) {
+        // (S*raw - offset) scaled per axis
+        const Vector3f &accel_scale = _imu._accel_scale[instance].get();
+        const Vector3f &offset = _imu._accel_offset[instance].get();
+        S.a *= accel_scale.x;
+        S.b *= accel_scale.y;
+        S.c *= accel_scale.z;
+        c = Vector3f(-offset.x * accel_scale.x,
+                     -offset.y * accel_scale.y,
+                     -offset.z * accel_scale.z);
+    }
+
+    const Matrix3f B = board_rotation_matrix(_imu._board_orientation, _imu._custom_rotation);
+    M = B * S;
+    c = B * c;
+    return true;
+}
+
+/*
+  as _get_accel_transform() for _rotate_and_correct_gyro()
+ */
+bool AP_InertialSensor_Backend::_get_gyro_transform(uint8_t instance, float raw_scale, Matrix3f &M, Vector3f &c) const
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning || _imu.tcal[instance].enable == AP_InertialSensor::TCal::Enable::Enabled) {
+        return false;
+    }
+#endif
+
+    Matrix3f sensor_rot;
+    sensor_rot.from_rotation(_imu._gyro_orientation[instance]);
+    c.zero();
+    if (!_imu._calibrating_gyro) {
+        c = -_imu._gyro_offset[instance].get();
+    }
+
+    const Matrix3f B = board_rotation_matrix(_imu._board_orientation, _imu._custom_rotation);
+    M = B * sensor_rot * raw_scale;
+    c = B * c;
+    return true;
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -177,9 +255,45 @@ void AP_InertialSensor_Backend::_publish_gyro(uint8_t instance, const Vector3f &
     _imu._delta_angle_valid[instance] = true;
 }
 
-void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
-                                                            const Vector3f &gyro,
-                                                            uint64_t sample_us)
+/*
+  standard gyro filter stages. By default the notch and harmonic notch
+  run first, with the low pass filter last to attenuate any notch
+  induced noise
+ */
+struct AP_InertialSensor_Backend::GyroNotchStage {
+    static void apply(AP_InertialSensor_Backend &backend, uint8_t instance, Vector3f &gyro) {
+        if (backend._gyro_notch_enabled()) {
+            gyro = backend._imu._gyro_notch_filter[instance].apply(gyro);
+        }
+    }
+    static void reset(AP_InertialSensor_Backend &backend, uint8_t instance) {
+        backend._imu._gyro_notch_filter[instance].reset();
+    }
+};
+
+struct AP_InertialSensor_Backend::GyroHarmonicNotchStage {
+    static void apply(AP_InertialSensor_Backend &backend, uint8_t instance, Vector3f &gyro) {
+        if (backend.gyro_harmonic_notch_enabled()) {
+            gyro = backend._imu._gyro_harmonic_notch_filter[instance].apply(gyro);
+        }
+    }
+    static void reset(AP_InertialSensor_Backend &backend, uint8_t instance) {
+        backend._imu._gyro_harmonic_notch_filter[instance].reset();
+    }
+};
+
+struct AP_InertialSensor_Backend::GyroLowPassStage {
+    static void apply(AP_InertialSensor_Backend &backend, uint8_t instance, Vector3f &gyro) {
+        gyro = backend._imu._gyro_filter[instance].apply(gyro);
+    }
+    static void reset(AP_InertialSensor_Backend &backend, uint8_t instance) {
+        backend._imu._gyro_filter[instance].reset();
+    }
+};
+
+__FASTRAMFUNC__ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
+                                                                            const Vector3f &gyro,
+                                                                            uint64_t sample_us)
 {
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
@@ -269,27 +383,26 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
 #endif
         Vector3f gyro_filtered = gyro;
 
-        // apply the notch filter
-        if (_gyro_notch_enabled()) {
-            gyro_filtered = _imu._gyro_notch_filter[instance].apply(gyro_filtered);
-        }
-
-        // apply the harmonic notch filter
-        if (gyro_harmonic_notch_enabled()) {
-            gyro_filtered = _imu._gyro_harmonic_notch_filter[instance].apply(gyro_filtered);
-        }
-
-        // apply the low pass filter last to attentuate any notch induced noise
-        gyro_filtered = _imu._gyro_filter[instance].apply(gyro_filtered);
+        // run the configured filter stages
+        GyroFilterPipeline::apply(*this, instance, gyro_filtered);
 
         // if the filtering failed in any way then reset the filters and keep the old value
         if (gyro_filtered.is_nan() || gyro_filtered.is_inf()) {
-            _imu._gyro_filter[instance].reset();
-            _imu._gyro_notch_filter[instance].reset();
-            _imu._gyro_harmonic_notch_filter[instance].reset();
+            GyroFilterPipeline::reset(*this, instance);
         } else {
             _imu._gyro_filtered[instance] = gyro_filtered;
         }
+        _imu._gyro_filtered_us[instance] = now;
+
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+        if (_imu._rate_loop.samples != nullptr && instance == _imu._primary_gyro &&
+            ++_imu._rate_loop.count >= _imu._rate_loop.decimation) {
+            _imu._rate_loop.count = 0;
+            // the rate loop drains the buffer on every wakeup, so a
+            // full buffer only means it has stalled
+            _imu._rate_loop.samples->push(_imu._gyro_filtered[instance]);
+        }
+#endif
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -302,6 +415,18 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
     }
 }
 
+/*
+  notify a block of FIFO gyro samples. The semaphore is recursive, so
+  holding it across the block saves a take and give per sample
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n)
+{
+    WITH_SEMAPHORE(_sem);
+    for (uint8_t i = 0; i < n; i++) {
+        _notify_new_gyro_raw_sample(instance, gyro[i]);
+    }
+}
+
 void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gyro)
 {
     AP_Logger *logger = AP_Logger::get_singleton();
@@ -346,10 +471,10 @@ void AP_InertialSensor_Backend::_publish_accel(uint8_t instance, const Vector3f
     }
 }
 
-void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
-                                                             const Vector3f &accel,
-                                                             uint64_t sample_us,
-                                                             bool fsync_set)
+__FASTRAMFUNC__ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
+                                                                             const Vector3f &accel,
+                                                                             uint64_t sample_us,
+                                                                             bool fsync_set)
 {
     if ((1U<<instance) & _imu.imu_kill_mask) {
         return;
@@ -423,6 +548,17 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
     }
 }
 
+/*
+  notify a block of FIFO accel samples
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n)
+{
+    WITH_SEMAPHORE(_sem);
+    for (uint8_t i = 0; i < n; i++) {
+        _notify_new_accel_raw_sample(instance, accel[i]);
+    }
+}
+
 void AP_InertialSensor_Backend::_notify_new_accel_sensor_rate_sample(uint8_t instance, const Vector3f &accel)
 {
     if (!_imu.batchsampler.doing_sensor_rate_logging()) {
@@ -526,6 +662,7 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance)
     }
     if (_imu._new_gyro_data[instance]) {
         _publish_gyro(instance, _imu._gyro_filtered[instance]);
+        _imu._gyro_published_us[instance] = _imu._gyro_filtered_us[instance];
         // copy the gyro samples from the backend to the frontend window
 #if HAL_WITH_DSP
         _imu._gyro_raw[instance] = _imu._last_raw_gyro[instance] * _imu._gyro_raw_sampling_multiplier[instance];
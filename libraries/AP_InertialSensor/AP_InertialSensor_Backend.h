@@ -28,6 +28,17 @@
 #include <AP_ExternalAHRS/AP_ExternalAHRS.h>
 
 #include "AP_InertialSensor.h"
+#include "AP_InertialSensor_FilterPipeline.h"
+
+/*
+  the gyro filter stages run on each raw sample, in order. A board or
+  vehicle can define this to drop stages it never uses or to insert
+  extra high rate stages, which are declared alongside the standard
+  stages in AP_InertialSensor_Backend
+ */
+#ifndef HAL_INS_GYRO_FILTER_STAGES
+#define HAL_INS_GYRO_FILTER_STAGES GyroNotchStage, GyroHarmonicNotchStage, GyroLowPassStage
+#endif
 
 class AuxiliaryBus;
 class AP_Logger;
@@ -136,6 +147,13 @@ protected:
     void _rotate_and_correct_accel(uint8_t instance, Vector3f &accel);
     void _rotate_and_correct_gyro(uint8_t instance, Vector3f &gyro);
 
+    // get the combined scale, rotation and correction for a block of
+    // raw samples as out = M*raw + c. Returns false if the correction
+    // can't be expressed that way (eg. temperature calibration
+    // active), in which case use _rotate_and_correct_*() per sample
+    bool _get_accel_transform(uint8_t instance, float raw_scale, Matrix3f &M, Vector3f &c) const;
+    bool _get_gyro_transform(uint8_t instance, float raw_scale, Matrix3f &M, Vector3f &c) const;
+
     // rotate gyro vector, offset and publish
     void _publish_gyro(uint8_t instance, const Vector3f &gyro);
 
@@ -147,6 +165,10 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0);
 
+    // notify a block of FIFO gyro samples, taking the frontend
+    // semaphore once for the whole block
+    void _notify_new_gyro_raw_samples(uint8_t instance, const Vector3f *gyro, uint8_t n);
+
     // rotate accel vector, scale, offset and publish
     void _publish_accel(uint8_t instance, const Vector3f &accel);
 
@@ -158,6 +180,10 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false);
 
+    // notify a block of FIFO accel samples, taking the frontend
+    // semaphore once for the whole block
+    void _notify_new_accel_raw_samples(uint8_t instance, const Vector3f *accel, uint8_t n);
+
     // set the amount of oversamping a accel is doing
     void _set_accel_oversampling(uint8_t instance, uint8_t n);
 
@@ -338,6 +364,12 @@ protected:
 
 private:
 
+    // gyro filter pipeline stages, see HAL_INS_GYRO_FILTER_STAGES
+    struct GyroNotchStage;
+    struct GyroHarmonicNotchStage;
+    struct GyroLowPassStage;
+    typedef AP_InertialSensor_FilterPipeline<HAL_INS_GYRO_FILTER_STAGES> GyroFilterPipeline;
+
     bool should_log_imu_raw() const;
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel);
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &gryo);
@@ -0,0 +1,53 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  compile time filter pipeline for IMU samples
+
+  Each stage is a type providing
+      static void apply(Context &ctx, uint8_t instance, Vector3f &v);
+      static void reset(Context &ctx, uint8_t instance);
+  The stages are run in the order given. As the list is resolved at
+  build time, stages that are not listed cost nothing, and the ones
+  that are listed are inlined with no per sample dispatch
+ */
+#pragma once
+
+#include <stdint.h>
+#include <AP_Math/AP_Math.h>
+
+template <typename... Stages>
+struct AP_InertialSensor_FilterPipeline;
+
+template <>
+struct AP_InertialSensor_FilterPipeline<> {
+    template <typename Context>
+    static void apply(Context &ctx, uint8_t instance, Vector3f &v) {}
+    template <typename Context>
+    static void reset(Context &ctx, uint8_t instance) {}
+};
+
+template <typename First, typename... Rest>
+struct AP_InertialSensor_FilterPipeline<First, Rest...> {
+    template <typename Context>
+    static void apply(Context &ctx, uint8_t instance, Vector3f &v) {
+        First::apply(ctx, instance, v);
+        AP_InertialSensor_FilterPipeline<Rest...>::apply(ctx, instance, v);
+    }
+    template <typename Context>
+    static void reset(Context &ctx, uint8_t instance) {
+        First::reset(ctx, instance);
+        AP_InertialSensor_FilterPipeline<Rest...>::reset(ctx, instance);
+    }
+};
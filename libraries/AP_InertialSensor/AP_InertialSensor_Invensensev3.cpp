@@ -82,7 +82,7 @@ struct PACKED FIFOData {
 };
 
 #define INV3_SAMPLE_SIZE sizeof(FIFOData)
-#define INV3_FIFO_BUFFER_LEN 8
+#define INV3_ASYNC_BUFFER_SIZE (1 + INV3_FIFO_BUFFER_LEN * INV3_SAMPLE_SIZE)
 
 AP_InertialSensor_Invensensev3::AP_InertialSensor_Invensensev3(AP_InertialSensor &imu,
                                                                AP_HAL::OwnPtr<AP_HAL::Device> _dev,
@@ -98,6 +98,11 @@ AP_InertialSensor_Invensensev3::~AP_InertialSensor_Invensensev3()
     if (fifo_buffer != nullptr) {
         hal.util->free_type((void*)fifo_buffer, INV3_FIFO_BUFFER_LEN * INV3_SAMPLE_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
     }
+    for (uint8_t i = 0; i < ARRAY_SIZE(fifo_async_buffer); i++) {
+        if (fifo_async_buffer[i] != nullptr) {
+            hal.util->free_type(fifo_async_buffer[i], INV3_ASYNC_BUFFER_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
+        }
+    }
 }
 
 AP_InertialSensor_Backend *AP_InertialSensor_Invensensev3::probe(AP_InertialSensor &imu,
@@ -190,6 +195,14 @@ void AP_InertialSensor_Invensensev3::start()
         AP_HAL::panic("Invensensev3: Unable to allocate FIFO buffer");
     }
 
+    if (dev->bus_type() == AP_HAL::Device::BUS_TYPE_SPI) {
+        fifo_async_buffer[0] = (uint8_t *)hal.util->malloc_type(INV3_ASYNC_BUFFER_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
+        fifo_async_buffer[1] = (uint8_t *)hal.util->malloc_type(INV3_ASYNC_BUFFER_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
+        if (fifo_async_buffer[0] != nullptr && fifo_async_buffer[1] != nullptr) {
+            spi_dev = static_cast<AP_HAL::SPIDevice *>(dev.get());
+        }
+    }
+
     // start the timer process to read samples
     dev->register_periodic_callback(1e6 / INV3_ODR, FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensensev3::read_fifo, void));
 }
@@ -216,33 +229,52 @@ void AP_InertialSensor_Invensensev3::accumulate()
 
 bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, uint8_t n_samples)
 {
-    for (uint8_t i = 0; i < n_samples; i++) {
-        const FIFOData &d = data[i];
+    /*
+      the scale, rotation and calibration are the same for every
+      sample in the block, so fold them into one transform per sensor
+      and then publish the whole block
+     */
+    Matrix3f accel_M, gyro_M;
+    Vector3f accel_c, gyro_c;
+    const bool accel_affine = _get_accel_transform(accel_instance, accel_scale, accel_M, accel_c);
+    const bool gyro_affine = _get_gyro_transform(gyro_instance, GYRO_SCALE, gyro_M, gyro_c);
+
+    n_samples = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
+    uint8_t n = 0;
+    for (; n < n_samples; n++) {
+        const FIFOData &d = data[n];
 
         // we have a header to confirm we don't have FIFO corruption! no more mucking
         // about with the temperature registers
         if ((d.header & 0xF8) != 0x68) {
             // no or bad data
-            return false;
+            break;
         }
 
-        Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
-        Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
+        const Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
+        const Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
 
-        accel *= accel_scale;
-        gyro *= GYRO_SCALE;
+        if (accel_affine) {
+            accel_block[n] = accel_M * accel + accel_c;
+        } else {
+            accel_block[n] = accel * accel_scale;
+            _rotate_and_correct_accel(accel_instance, accel_block[n]);
+        }
+        if (gyro_affine) {
+            gyro_block[n] = gyro_M * gyro + gyro_c;
+        } else {
+            gyro_block[n] = gyro * GYRO_SCALE;
+            _rotate_and_correct_gyro(gyro_instance, gyro_block[n]);
+        }
 
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
     }
-    return true;
+
+    _notify_new_accel_raw_samples(accel_instance, accel_block, n);
+    _notify_new_gyro_raw_samples(gyro_instance, gyro_block, n);
+
+    return n == n_samples;
 }
 
 /*
@@ -262,6 +294,13 @@ void AP_InertialSensor_Invensensev3::read_fifo()
         goto check_registers;
     }
 
+    if (spi_dev != nullptr) {
+        if (!read_fifo_pipelined(n_samples, need_reset)) {
+            goto check_registers;
+        }
+        n_samples = 0;
+    }
+
     while (n_samples > 0) {
         uint8_t n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
         if (!block_read(INV3REG_FIFO_DATA, (uint8_t*)fifo_buffer, n * INV3_SAMPLE_SIZE)) {
@@ -291,6 +330,53 @@ check_registers:
     dev->set_speed(AP_HAL::Device::SPEED_HIGH);
 }
 
+/*
+  read the FIFO in blocks, starting the transfer of each block before
+  processing the previous one so the sample processing overlaps the
+  DMA when the FIFO has backed up
+ */
+bool AP_InertialSensor_Invensensev3::read_fifo_pipelined(uint16_t n_samples, bool &need_reset)
+{
+    uint8_t b = 0;
+    uint8_t n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
+    fifo_async_buffer[b][0] = INV3REG_FIFO_DATA | BIT_READ_FLAG;
+    if (!spi_dev->transfer_async_start(fifo_async_buffer[b], fifo_async_buffer[b], 1 + n * INV3_SAMPLE_SIZE)) {
+        return false;
+    }
+
+    while (true) {
+        if (!spi_dev->transfer_async_finish()) {
+            return false;
+        }
+        n_samples -= n;
+        const uint8_t b_done = b;
+        const uint8_t n_done = n;
+
+        bool started = false;
+        if (n_samples > 0) {
+            b ^= 1;
+            n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
+            fifo_async_buffer[b][0] = INV3REG_FIFO_DATA | BIT_READ_FLAG;
+            started = spi_dev->transfer_async_start(fifo_async_buffer[b], fifo_async_buffer[b], 1 + n * INV3_SAMPLE_SIZE);
+        }
+
+        if (!accumulate_samples((const FIFOData *)&fifo_async_buffer[b_done][1], n_done)) {
+            need_reset = true;
+            if (started) {
+                // the transfer must complete before the bus can be used again
+                UNUSED_RESULT(spi_dev->transfer_async_finish());
+            }
+            return true;
+        }
+        if (n_samples == 0) {
+            return true;
+        }
+        if (!started) {
+            return false;
+        }
+    }
+}
+
 bool AP_InertialSensor_Invensensev3::block_read(uint8_t reg, uint8_t *buf, uint32_t size)
 {
     return dev->read_registers(reg, buf, size);
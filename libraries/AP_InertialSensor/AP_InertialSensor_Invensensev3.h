@@ -14,6 +14,9 @@
 #include "AP_InertialSensor.h"
 #include "AP_InertialSensor_Backend.h"
 
+// number of samples read from the FIFO in one transfer
+#define INV3_FIFO_BUFFER_LEN 8
+
 class AP_InertialSensor_Invensensev3 : public AP_InertialSensor_Backend
 {
 public:
@@ -59,6 +62,10 @@ private:
 
     bool accumulate_samples(const struct FIFOData *data, uint8_t n_samples);
 
+    // read n_samples from the FIFO over SPI, processing each block
+    // while the next is transferred
+    bool read_fifo_pipelined(uint16_t n_samples, bool &need_reset);
+
     // instance numbers of accel and gyro data
     uint8_t gyro_instance;
     uint8_t accel_instance;
@@ -79,6 +86,15 @@ private:
     // buffer for fifo read
     struct FIFOData *fifo_buffer;
 
+    // on SPI, two buffers for pipelined fifo reads. The first byte of
+    // each is the register address, followed by the samples
+    AP_HAL::SPIDevice *spi_dev;
+    uint8_t *fifo_async_buffer[2];
+
+    // converted samples for one FIFO block, kept off the bus thread stack
+    Vector3f accel_block[INV3_FIFO_BUFFER_LEN];
+    Vector3f gyro_block[INV3_FIFO_BUFFER_LEN];
+
     float temp_filtered;
     LowPassFilter2pFloat temp_filter;
 };
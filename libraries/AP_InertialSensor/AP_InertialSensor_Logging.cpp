@@ -96,17 +96,18 @@ void AP_InertialSensor::Write_Vibration() const
 }
 
 // Write information about a series of IMU readings to log:
-bool AP_InertialSensor::BatchSampler::Write_ISBH(const float sample_rate_hz) const
+bool AP_InertialSensor::BatchSampler::Write_ISBH(uint16_t seqno, IMU_SENSOR_TYPE sensor_type, uint8_t sensor_instance,
+                                                  uint16_t mul, uint64_t sample_us, const float sample_rate_hz) const
 {
     const struct log_ISBH pkt{
         LOG_PACKET_HEADER_INIT(LOG_ISBH_MSG),
         time_us        : AP_HAL::micros64(),
-        seqno          : isb_seqnum,
-        sensor_type    : (uint8_t)type,
-        instance       : instance,
-        multiplier     : multiplier,
+        seqno          : seqno,
+        sensor_type    : (uint8_t)sensor_type,
+        instance       : sensor_instance,
+        multiplier     : mul,
         sample_count   : (uint16_t)_required_count,
-        sample_us      : measurement_started_us,
+        sample_us      : sample_us,
         sample_rate_hz : sample_rate_hz,
     };
 
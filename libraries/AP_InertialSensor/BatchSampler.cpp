@@ -4,11 +4,13 @@
 #include <GCS_MAVLink/GCS.h>
 #include <AP_Logger/AP_Logger.h>
 
+#define MASK_LOG_ANY                    0xFFFF
+
 // Class level parameters
 const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Param: BAT_CNT
     // @DisplayName: sample count per batch
-    // @Description: Number of samples to take when logging streams of IMU sensor readings.  Will be rounded down to a multiple of 32. This option takes effect on the next reboot.
+    // @Description: Number of samples to take when logging streams of IMU sensor readings.  Will be rounded down to a multiple of 32. When streaming all sensors this is also the number of samples buffered for each sensor while waiting to be logged. This option takes effect on the next reboot.
     // @User: Advanced
     // @Increment: 32
     // @RebootRequired: True
@@ -24,8 +26,8 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
 
     // @Param: BAT_OPT
     // @DisplayName: Batch Logging Options Mask
-    // @Description: Options for the BatchSampler. Post-filter and sensor-rate logging cannot be used at the same time.
-    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering
+    // @Description: Options for the BatchSampler. Post-filter and sensor-rate logging cannot be used at the same time. Streaming captures the accels and gyros of all IMUs in @PREFIX@BAT_MASK at once and logs them continuously rather than one sensor at a time, it cannot be used with sensor-rate logging and takes effect on the next reboot.
+    // @Bitmask: 0:Sensor-Rate Logging (sample at full sensor rate seen by AP), 1: Sample post-filtering, 2: Stream all sensors at once
     // @User: Advanced
     AP_GROUPINFO("BAT_OPT",  3, AP_InertialSensor::BatchSampler, _batch_options_mask, 0),
 
@@ -58,6 +60,11 @@ void AP_InertialSensor::BatchSampler::init()
 
     _required_count -= _required_count % 32; // round down to nearest multiple of 32
 
+    if ((batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_STREAM) {
+        initialised = streaming = init_streams();
+        return;
+    }
+
     const uint32_t total_allocation = 3*_required_count*sizeof(uint16_t);
     GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "INS: alloc %u bytes for ISB (free=%u)", (unsigned int)total_allocation, (unsigned int)hal.util->available_memory());
 
@@ -85,6 +92,10 @@ void AP_InertialSensor::BatchSampler::periodic()
     if (_sensor_mask == 0) {
         return;
     }
+    if (streaming) {
+        push_streams_to_log();
+        return;
+    }
     push_data_to_log();
 }
 
@@ -195,22 +206,8 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
 
     // possibly send isb header:
     if (!isbh_sent && data_read_offset == 0) {
-        float sample_rate = 0; // avoid warning about uninitialised values
-        switch(type) {
-        case IMU_SENSOR_TYPE_GYRO:
-            sample_rate = _imu._gyro_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._gyro_over_sampling[instance];
-            }
-            break;
-        case IMU_SENSOR_TYPE_ACCEL:
-            sample_rate = _imu._accel_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._accel_over_sampling[instance];
-            }
-            break;
-        }
-        if (!Write_ISBH(sample_rate)) {
+        if (!Write_ISBH(isb_seqnum, type, instance, multiplier, measurement_started_us,
+                        sample_rate_hz(instance, type))) {
             // buffer full?
             return;
         }
@@ -235,6 +232,24 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
     }
 }
 
+// sample rate of the data being logged for a sensor
+float AP_InertialSensor::BatchSampler::sample_rate_hz(uint8_t _instance, IMU_SENSOR_TYPE _type) const
+{
+    switch (_type) {
+    case IMU_SENSOR_TYPE_GYRO:
+        if (_doing_sensor_rate_logging) {
+            return _imu._gyro_raw_sample_rates[_instance] * _imu._gyro_over_sampling[_instance];
+        }
+        return _imu._gyro_raw_sample_rates[_instance];
+    case IMU_SENSOR_TYPE_ACCEL:
+        if (_doing_sensor_rate_logging) {
+            return _imu._accel_raw_sample_rates[_instance] * _imu._accel_over_sampling[_instance];
+        }
+        return _imu._accel_raw_sample_rates[_instance];
+    }
+    return 0;
+}
+
 bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_TYPE _type)
 {
     if (_sensor_mask == 0) {
@@ -256,7 +271,6 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
     if (logger == nullptr) {
         return false;
     }
-#define MASK_LOG_ANY                    0xFFFF
     if (!logger->should_log(MASK_LOG_ANY)) {
         return false;
     }
@@ -265,6 +279,10 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
 
 void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSensor::IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
 {
+    if (streaming) {
+        sample_stream(_instance, _type, sample_us, _sample);
+        return;
+    }
     if (!should_log(_instance, _type)) {
         return;
     }
@@ -278,4 +296,159 @@ void AP_InertialSensor::BatchSampler::sample(uint8_t _instance, AP_InertialSenso
 
     data_write_offset++; // may unblock the reading process
 }
+/*
+  streaming of all sensors at once. Each accel and gyro in the mask
+  fills its own ISBD packet, and completed packets are queued in a per
+  sensor ring buffer which the main thread drains to the log. The
+  backend thread is the only writer of each queue and the main thread
+  the only reader, so no locking is needed between them. Each batch of
+  _required_count samples gets an ISBH header so the log looks the
+  same to analysis tools as a series of one sensor at a time batches
+ */
+struct AP_InertialSensor::BatchSampler::StreamChunk {
+    struct log_ISBD pkt;
+    uint64_t sample_us; // time of the first sample of the batch
+};
+
+struct AP_InertialSensor::BatchSampler::Stream {
+    ObjectBuffer<StreamChunk> chunks;
+    StreamChunk chunk;      // being filled by the backend
+    uint8_t count;          // samples in chunk
+    uint16_t batch_offset;  // samples into the current batch
+    uint16_t batch;         // batch number, used for the ISB sequence number
+    uint8_t index;          // unique index of this stream
+    uint16_t multiplier;
+    bool isbh_sent;
+    uint32_t dropped;       // chunks lost because the log couldn't keep up
+};
+
+bool AP_InertialSensor::BatchSampler::init_streams()
+{
+    const uint8_t _count = MIN(MIN(_imu._accel_count, _imu._gyro_count), INS_MAX_INSTANCES);
+    const uint32_t nchunks = MAX(_required_count / ARRAY_SIZE(log_ISBD::x), 2U);
+    uint8_t nstreams = 0;
+    for (uint8_t i=0; i<_count; i++) {
+        if (_sensor_mask & (1U<<i)) {
+            nstreams += 2;
+        }
+    }
+    if (nstreams == 0) {
+        return false;
+    }
+
+    const uint32_t total_allocation = nstreams * (sizeof(Stream) + (nchunks+1) * sizeof(StreamChunk));
+    GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "INS: alloc %u bytes for ISB (free=%u)", (unsigned int)total_allocation, (unsigned int)hal.util->available_memory());
+
+    uint8_t index = 0;
+    for (uint8_t i=0; i<_count; i++) {
+        if (!(_sensor_mask & (1U<<i))) {
+            continue;
+        }
+        for (uint8_t t=0; t<2; t++) {
+            Stream *st = new Stream;
+            if (st == nullptr || !st->chunks.set_size(nchunks)) {
+                delete st;
+                for (auto &s : streams) {
+                    for (auto &ss : s) {
+                        delete ss;
+                        ss = nullptr;
+                    }
+                }
+                GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate %u bytes for IMU batch sampling", (unsigned int)total_allocation);
+                return false;
+            }
+            st->chunk.pkt = log_ISBD {
+                LOG_PACKET_HEADER_INIT(LOG_ISBD_MSG),
+            };
+            st->index = index++;
+            st->multiplier = (t == IMU_SENSOR_TYPE_ACCEL) ? _imu._accel_raw_sampling_multiplier[i] : _imu._gyro_raw_sampling_multiplier[i];
+            streams[i][t] = st;
+        }
+    }
+    num_streams = nstreams;
+
+    // sensor rate samples come from a single sensor at a time, so
+    // streaming logs at the backend rate
+    _doing_sensor_rate_logging = false;
+    _doing_post_filter_logging = (batch_opt_t)(_batch_options_mask.get()) & BATCH_OPT_POST_FILTER;
+
+    return true;
+}
+
+void AP_InertialSensor::BatchSampler::sample_stream(uint8_t _instance, IMU_SENSOR_TYPE _type, uint64_t sample_us, const Vector3f &_sample)
+{
+    if (_instance >= INS_MAX_INSTANCES) {
+        return;
+    }
+    Stream *st = streams[_instance][_type];
+    if (st == nullptr) {
+        return;
+    }
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr || !logger->should_log(MASK_LOG_ANY)) {
+        return;
+    }
+
+    StreamChunk &c = st->chunk;
+    if (st->count == 0 && st->batch_offset == 0) {
+        c.sample_us = sample_us;
+    }
+    c.pkt.x[st->count] = st->multiplier*_sample.x;
+    c.pkt.y[st->count] = st->multiplier*_sample.y;
+    c.pkt.z[st->count] = st->multiplier*_sample.z;
+    if (++st->count < ARRAY_SIZE(c.pkt.x)) {
+        return;
+    }
+
+    // chunk complete, queue it for the main thread
+    c.pkt.time_us = AP_HAL::micros64();
+    c.pkt.isb_seqno = st->batch * num_streams + st->index;
+    c.pkt.seqno = st->batch_offset / ARRAY_SIZE(c.pkt.x);
+    if (!st->chunks.push(c)) {
+        st->dropped++;
+    }
+    st->count = 0;
+    st->batch_offset += ARRAY_SIZE(c.pkt.x);
+    if (st->batch_offset >= _required_count) {
+        st->batch_offset = 0;
+        st->batch++;
+    }
+}
+
+void AP_InertialSensor::BatchSampler::push_streams_to_log()
+{
+    AP_Logger *logger = AP_Logger::get_singleton();
+    if (logger == nullptr) {
+        return;
+    }
+    // at most one chunk per sensor each call to avoid flooding
+    // AP_Logger's buffer, at the main loop rate that is well above
+    // the rate chunks are produced
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        for (uint8_t t=0; t<2; t++) {
+            Stream *st = streams[i][t];
+            if (st == nullptr) {
+                continue;
+            }
+            uint32_t n;
+            const StreamChunk *c = st->chunks.readptr(n);
+            if (c == nullptr) {
+                continue;
+            }
+            if (c->pkt.seqno == 0 && !st->isbh_sent) {
+                const IMU_SENSOR_TYPE sensor_type = IMU_SENSOR_TYPE(t);
+                if (!Write_ISBH(c->pkt.isb_seqno, sensor_type, i, st->multiplier, c->sample_us,
+                                sample_rate_hz(i, sensor_type))) {
+                    continue;
+                }
+                st->isbh_sent = true;
+            }
+            if (!logger->WriteBlock_first_succeed(&c->pkt, sizeof(c->pkt))) {
+                continue;
+            }
+            st->isbh_sent = false;
+            st->chunks.pop();
+        }
+    }
+}
 #endif //#if HAL_INS_ENABLED
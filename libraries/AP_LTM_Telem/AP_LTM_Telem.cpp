@@ -22,6 +22,7 @@
 #include <AP_BattMonitor/AP_BattMonitor.h>
 #include <AP_Notify/AP_Notify.h>
 #include <AP_RSSI/AP_RSSI.h>
+#include <AP_RCTelemetry/AP_RCTelemetry.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -68,15 +69,12 @@ void AP_LTM_Telem::send_Gframe(void)
     uint8_t gndspeed = 0;                   // gps ground speed (m/s)
     int32_t alt = 0;
     {
-        AP_AHRS &ahrs = AP::ahrs();
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        float alt_ahrs;
-        ahrs.get_relative_position_D_home(alt_ahrs);
-        alt = (int32_t) roundf(-alt_ahrs * 100.0); // altitude (cm)
-        Location loc;
-        if (ahrs.get_position(loc)) {
-            lat = loc.lat;
-            lon = loc.lng;
+        AP_RCTelemetry::NavSnapshot nav;
+        AP_RCTelemetry::get_nav_snapshot(nav);
+        alt = (int32_t) roundf(-nav.relative_alt_D * 100.0); // altitude (cm)
+        if (nav.have_position) {
+            lat = nav.loc.lat;
+            lon = nav.loc.lng;
             gndspeed = (uint8_t) roundf(gps.ground_speed());
         }
     }
@@ -164,11 +162,11 @@ void AP_LTM_Telem::send_Aframe(void)
     int16_t roll;
     int16_t heading;
     {
-        AP_AHRS &ahrs = AP::ahrs();
-        WITH_SEMAPHORE(ahrs.get_semaphore());
-        pitch = roundf(ahrs.pitch_sensor / 100.0); // attitude pitch in degrees
-        roll = roundf(ahrs.roll_sensor / 100.0);   // attitude roll in degrees
-        heading = roundf(ahrs.yaw_sensor / 100.0); // heading in degrees
+        AP_RCTelemetry::NavSnapshot nav;
+        AP_RCTelemetry::get_nav_snapshot(nav);
+        pitch = roundf(nav.pitch_sensor / 100.0); // attitude pitch in degrees
+        roll = roundf(nav.roll_sensor / 100.0);   // attitude roll in degrees
+        heading = roundf(nav.yaw_sensor / 100.0); // heading in degrees
     }
 
     uint8_t lt_buff[LTM_AFRAME_SIZE];
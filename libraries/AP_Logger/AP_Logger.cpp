@@ -6,10 +6,12 @@
 #include "AP_Logger_SITL.h"
 #include "AP_Logger_DataFlash.h"
 #include "AP_Logger_MAVLink.h"
+#include "AP_Logger_RAM.h"
 
 #include <AP_InternalError/AP_InternalError.h>
 #include <GCS_MAVLink/GCS.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
+#include <AP_Common/MemoryTag.h>
 
 AP_Logger *AP_Logger::_singleton;
 
@@ -59,8 +61,8 @@ extern const AP_HAL::HAL& hal;
 const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @Param: _BACKEND_TYPE
     // @DisplayName: AP_Logger Backend Storage type
-    // @Description: Bitmap of what Logger backend types to enable. Block-based logging is available on SITL and boards with dataflash chips. Multiple backends can be selected.
-    // @Bitmask: 0:File,1:MAVLink,2:Block
+    // @Description: Bitmap of what Logger backend types to enable. Block-based logging is available on SITL and boards with dataflash chips. Multiple backends can be selected. RAM ring keeps recent messages in memory and only writes them, and what follows them, to the File or Block backend when a crash or failsafe selected by LOG_RAM_TRIG occurs.
+    // @Bitmask: 0:File,1:MAVLink,2:Block,3:RAM ring
     // @User: Standard
     AP_GROUPINFO("_BACKEND_TYPE",  0, AP_Logger, _params.backend_types,       uint8_t(HAL_LOGGING_BACKENDS_DEFAULT)),
 
@@ -115,6 +117,133 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("_FILE_MB_FREE",  7, AP_Logger, _params.min_MB_free, 500),
 
+    // @Param: _RATEMAX
+    // @DisplayName: Maximum logging rate
+    // @Description: This sets the maximum rate that non-critical messages of any one type will be logged at. Messages written more often are dropped. Messages of several instances written at the same time, such as IMU, all count as one. Critical messages such as parameters, mode changes and events are never limited. Zero means no limit. The limit for individual message types can be set with LOG_RATEn_TYPE and LOG_RATEn_HZ
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATEMAX",  8, AP_Logger, _params.rate_max, 0),
+
+    // @Param: _RATE1_TYPE
+    // @DisplayName: Rate limited message type
+    // @Description: Message type to limit to LOG_RATE1_HZ instead of LOG_RATEMAX. This is the Type field of the FMT message for the message. -1 to disable
+    // @Range: -1 255
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE1_TYPE",  9, AP_Logger, _params.rate_overrides[0].msg_type, -1),
+
+    // @Param: _RATE1_HZ
+    // @DisplayName: Rate limit for message type
+    // @Description: Maximum rate to log messages of type LOG_RATE1_TYPE at. Zero means no limit
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE1_HZ",  10, AP_Logger, _params.rate_overrides[0].rate_hz, 0),
+
+    // @Param: _RATE2_TYPE
+    // @DisplayName: Rate limited message type
+    // @Description: Message type to limit to LOG_RATE2_HZ instead of LOG_RATEMAX. This is the Type field of the FMT message for the message. -1 to disable
+    // @Range: -1 255
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE2_TYPE",  11, AP_Logger, _params.rate_overrides[1].msg_type, -1),
+
+    // @Param: _RATE2_HZ
+    // @DisplayName: Rate limit for message type
+    // @Description: Maximum rate to log messages of type LOG_RATE2_TYPE at. Zero means no limit
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE2_HZ",  12, AP_Logger, _params.rate_overrides[1].rate_hz, 0),
+
+    // @Param: _RATE3_TYPE
+    // @DisplayName: Rate limited message type
+    // @Description: Message type to limit to LOG_RATE3_HZ instead of LOG_RATEMAX. This is the Type field of the FMT message for the message. -1 to disable
+    // @Range: -1 255
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE3_TYPE",  13, AP_Logger, _params.rate_overrides[2].msg_type, -1),
+
+    // @Param: _RATE3_HZ
+    // @DisplayName: Rate limit for message type
+    // @Description: Maximum rate to log messages of type LOG_RATE3_TYPE at. Zero means no limit
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE3_HZ",  14, AP_Logger, _params.rate_overrides[2].rate_hz, 0),
+
+    // @Param: _RATE4_TYPE
+    // @DisplayName: Rate limited message type
+    // @Description: Message type to limit to LOG_RATE4_HZ instead of LOG_RATEMAX. This is the Type field of the FMT message for the message. -1 to disable
+    // @Range: -1 255
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE4_TYPE",  15, AP_Logger, _params.rate_overrides[3].msg_type, -1),
+
+    // @Param: _RATE4_HZ
+    // @DisplayName: Rate limit for message type
+    // @Description: Maximum rate to log messages of type LOG_RATE4_TYPE at. Zero means no limit
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 0.1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RATE4_HZ",  16, AP_Logger, _params.rate_overrides[3].rate_hz, 0),
+
+    // @Param: _BUF_HWM
+    // @DisplayName: Log buffer high water mark
+    // @Description: When the fill of a logging backend's write buffer reaches this percentage, messages logged at high rate are progressively decimated until the buffer drains below half this level. Zero disables adaptive throttling
+    // @Units: %
+    // @Range: 0 100
+    // @Increment: 1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_BUF_HWM",  17, AP_Logger, _params.buf_hwm, HAL_LOGGER_BUF_HWM_DEFAULT),
+
+    // @Param: _FILE_PREALLOC
+    // @DisplayName: Log file preallocation size
+    // @Description: When a new log file is opened, a contiguous free area of this size is found on the microSD card and the log is written into it, so writes in flight don't stall searching for free space on large or fragmented cards. Set this to around the size of a typical flight log. The space is not reserved: the log can grow past it and its size is only what has been written. Zero disables preallocation. Only used on filesystems that support it
+    // @Units: MB
+    // @Range: 0 4000
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_PREALLOC",  18, AP_Logger, _params.file_prealloc, HAL_LOGGER_FILE_PREALLOC_DEFAULT),
+
+#if HAL_LOGGER_RAM_ENABLED
+    // @Param: _RAM_SIZE
+    // @DisplayName: RAM ring size
+    // @Description: Size of the RAM ring used when the RAM ring bit of LOG_BACKEND_TYPE is set. The ring holds the messages logged before a trigger, so its size sets how far back from a crash or failsafe the log goes. This size may be reduced depending on available memory
+    // @Units: kB
+    // @Range: 4 1024
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("_RAM_SIZE",  19, AP_Logger, _params.ram_size, HAL_LOGGER_RAM_SIZE_DEFAULT),
+
+    // @Param: _RAM_POST
+    // @DisplayName: RAM ring time logged after trigger
+    // @Description: When the RAM ring is written to storage, messages logged for this long after the trigger are written as well. A further trigger in that time extends it
+    // @Units: s
+    // @Range: 0 60
+    // @User: Advanced
+    AP_GROUPINFO("_RAM_POST",  20, AP_Logger, _params.ram_post, 5),
+
+    // @Param: _RAM_TRIG
+    // @DisplayName: RAM ring triggers
+    // @Description: Events which cause the RAM ring to be written to storage. Any other error covers every other ERR message that reports an error rather than its resolution
+    // @Bitmask: 0:Crash,1:EKF failsafe,2:Vibration failsafe,3:Any other error
+    // @User: Advanced
+    AP_GROUPINFO("_RAM_TRIG",  21, AP_Logger, _params.ram_trig, 7),
+#endif
+
+
     AP_GROUPEND
 };
 
@@ -151,6 +280,9 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
     _num_types = num_types;
     _structures = structures;
 
+    // account backends and their buffers to logging
+    WITH_MEMORY_TAG(LOGGER);
+
 #if HAL_LOGGING_FILESYSTEM_ENABLED
     if (_params.backend_types & uint8_t(Backend_Type::FILESYSTEM)) {
         LoggerMessageWriter_DFLogStart *message_writer =
@@ -211,6 +343,26 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
         }
     }
 #endif
+
+#if HAL_LOGGER_RAM_ENABLED
+    if ((_params.backend_types & uint8_t(Backend_Type::RAM)) && _next_backend > 0) {
+        // the storage backend is only reached through the ring
+        LoggerMessageWriter_DFLogStart *message_writer =
+            new LoggerMessageWriter_DFLogStart();
+        AP_Logger_Backend *ram = nullptr;
+        if (message_writer != nullptr)  {
+            ram = new AP_Logger_RAM(*this, message_writer, backends[0]);
+        }
+        if (ram == nullptr) {
+            hal.console->printf("Unable to open AP_Logger_RAM");
+            // note that message_writer is leaked here; costs several
+            // hundred bytes to fix for marginal utility
+        } else {
+            backends[0] = ram;
+        }
+    }
+#endif
+
     // the "main" logging type needs to come before mavlink so that index 0 is correct
 #if HAL_LOGGING_MAVLINK_ENABLED
     if (_params.backend_types & uint8_t(Backend_Type::MAVLINK)) {
@@ -238,6 +390,18 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
         backends[i]->Init();
     }
 
+    // only pay for the rate limiter if it is being used
+    bool rate_limited = is_positive(_params.rate_max) || _params.buf_hwm > 0;
+    for (const auto &o : _params.rate_overrides) {
+        rate_limited |= (o.msg_type >= 0 && is_positive(o.rate_hz));
+    }
+    if (rate_limited) {
+        _rate_limiter = new AP_Logger_RateLimiter(_params.rate_max, _params.rate_overrides);
+        if (_rate_limiter == nullptr) {
+            hal.console->printf("Unable to allocate log rate limiter\n");
+        }
+    }
+
     start_io_thread();
 
     EnableWrites(true);
@@ -702,6 +866,10 @@ void AP_Logger::save_format_Replay(const void *pBuffer)
 void AP_Logger::WriteBlock(const void *pBuffer, uint16_t size) {
 #if APM_BUILD_TYPE(APM_BUILD_Replay)
     save_format_Replay(pBuffer);
+#else
+    if (!should_log_rate_limited(((const uint8_t *)pBuffer)[2])) {
+        return;
+    }
 #endif
     FOR_EACH_BACKEND(WriteBlock(pBuffer, size));
 }
@@ -837,9 +1005,47 @@ void AP_Logger::periodic_tasks() {
 #ifndef HAL_BUILD_AP_PERIPH
     handle_log_send();
 #endif
+    Write_Compact_flush_old();
+    update_throttle();
     FOR_EACH_BACKEND(periodic_tasks());
 }
 
+/*
+  raise the throttling level while a backend's write buffer is above
+  LOG_BUF_HWM, and lower it again once all buffers have stayed below
+  half of that for a second
+ */
+void AP_Logger::update_throttle()
+{
+    if (_rate_limiter == nullptr || _params.buf_hwm <= 0) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _last_throttle_update_ms < 100) {
+        return;
+    }
+    _last_throttle_update_ms = now_ms;
+
+    uint8_t fill = 0;
+    for (uint8_t i=0; i<_next_backend; i++) {
+        fill = MAX(fill, backends[i]->buffer_fill_pct());
+    }
+
+    uint8_t level = _rate_limiter->get_throttle_level();
+    if (fill >= _params.buf_hwm) {
+        if (level < LOGGER_THROTTLE_MAX_LEVEL) {
+            level++;
+        }
+        _last_throttle_high_ms = now_ms;
+    } else if (fill >= _params.buf_hwm / 2) {
+        _last_throttle_high_ms = now_ms;
+    } else if (level > 0 && now_ms - _last_throttle_high_ms > 1000) {
+        level--;
+        _last_throttle_high_ms = now_ms;
+    }
+    _rate_limiter->set_throttle_level(level);
+}
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // currently only AP_Logger_File support this:
 void AP_Logger::flush(void) {
@@ -909,6 +1115,22 @@ uint32_t AP_Logger::num_dropped() const
     return backends[0]->num_dropped();
 }
 
+uint32_t AP_Logger::num_writes_contended() const
+{
+    if (_next_backend == 0) {
+        return 0;
+    }
+    return backends[0]->num_writes_contended();
+}
+
+uint32_t AP_Logger::num_writes_uncontended() const
+{
+    if (_next_backend == 0) {
+        return 0;
+    }
+    return backends[0]->num_writes_uncontended();
+}
+
 
 // end functions pass straight through to backend
 
@@ -963,6 +1185,10 @@ void AP_Logger::WriteV(const char *name, const char *labels, const char *units,
         return;
     }
 
+    if (!is_critical && !should_log_rate_limited(f->msg_type)) {
+        return;
+    }
+
     for (uint8_t i=0; i<_next_backend; i++) {
         if (!(f->sent_mask & (1U<<i))) {
             if (!backends[i]->Write_Emit_FMT(f->msg_type)) {
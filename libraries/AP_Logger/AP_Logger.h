@@ -85,6 +85,55 @@
 #include <stdint.h>
 
 #include "LoggerMessageWriter.h"
+#include "LogCompressor.h"
+#include "AP_Logger_RateLimiter.h"
+
+// default buffer fill percentage above which high rate messages are throttled
+#ifndef HAL_LOGGER_BUF_HWM_DEFAULT
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define HAL_LOGGER_BUF_HWM_DEFAULT 80
+#else
+#define HAL_LOGGER_BUF_HWM_DEFAULT 0
+#endif
+#endif
+
+// default space in MB to find contiguously for a new log file
+#ifndef HAL_LOGGER_FILE_PREALLOC_DEFAULT
+#define HAL_LOGGER_FILE_PREALLOC_DEFAULT 64
+#endif
+
+#ifndef HAL_LOGGER_RAM_ENABLED
+#define HAL_LOGGER_RAM_ENABLED (HAL_LOGGING_FILESYSTEM_ENABLED || HAL_LOGGING_BLOCK_ENABLED)
+#endif
+
+// default size in kB of the RAM ring kept for crash logs
+#ifndef HAL_LOGGER_RAM_SIZE_DEFAULT
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define HAL_LOGGER_RAM_SIZE_DEFAULT 64
+#else
+#define HAL_LOGGER_RAM_SIZE_DEFAULT 16
+#endif
+#endif
+
+#ifndef HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+#define HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_300)
+#endif
+
+/*
+  compressed log download over MAVLink. A GCS requests it by setting
+  this flag in the id of LOG_REQUEST_DATA; ofs and count are still raw
+  log offsets. The log is sent as blocks of up to
+  LOG_COMPRESS_BLOCK_SIZE raw bytes, each split over LOG_DATA messages
+  with the same id flag and ofs set to the raw offset of the block.
+  data[0] of each message is the chunk number within the block, with
+  the top bit set on the last chunk. The chunks make up a 16 bit block
+  header holding the raw length (top bit set if the block is stored
+  uncompressed) followed by an LZ4 compressed block. A block with a
+  raw length of zero marks the end of the requested data
+ */
+#define LOG_DOWNLOAD_COMPRESSED_FLAG 0x8000
+#define LOG_COMPRESS_BLOCK_SIZE      1024
+#define LOG_COMPRESS_BLOCK_STORED    0x8000
 
 
 class AP_Logger_Backend;
@@ -330,6 +379,11 @@ public:
     void WriteCritical(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, ...);
     void WriteV(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, va_list arg_list, bool is_critical=false);
 
+    // as Write(), but the record is delta encoded against the last
+    // record of the same name and packed into a CMPT message. Used to
+    // cut log bandwidth for high rate messages
+    void WriteCompact(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, ...);
+
     // This structure provides information on the internal member data of a PID for logging purposes
     struct PID_Info {
         float target;
@@ -367,6 +421,11 @@ public:
     // number of blocks that have been dropped
     uint32_t num_dropped(void) const;
 
+    // number of writes which had to wait for, or did not wait for, a
+    // backend lock
+    uint32_t num_writes_contended(void) const;
+    uint32_t num_writes_uncontended(void) const;
+
     // accesss to public parameters
     void set_force_log_disarmed(bool force_logging) { _force_log_disarmed = force_logging; }
     bool log_while_disarmed(void) const;
@@ -385,8 +444,25 @@ public:
         AP_Int8 mav_bufsize; // in kilobytes
         AP_Int16 file_timeout; // in seconds
         AP_Int16 min_MB_free;
+        AP_Float rate_max; // in Hz
+        AP_Logger_RateLimiter::Override rate_overrides[LOGGER_RATE_OVERRIDES];
+        AP_Int8 buf_hwm; // in percent
+        AP_Int16 file_prealloc; // in megabytes
+        AP_Int16 ram_size; // in kilobytes
+        AP_Int8 ram_post; // in seconds
+        AP_Int8 ram_trig;
     } _params;
 
+    // number of messages of a type dropped by LOG_RATEMAX and friends
+    uint32_t num_rate_limited(uint8_t msg_type) const {
+        return _rate_limiter != nullptr ? _rate_limiter->dropped(msg_type) : 0;
+    }
+
+    // current adaptive throttling level, see LOG_BUF_HWM
+    uint8_t log_throttle_level() const {
+        return _rate_limiter != nullptr ? _rate_limiter->get_throttle_level() : 0;
+    }
+
     const struct LogStructure *structure(uint16_t num) const;
     const struct UnitStructure *unit(uint16_t num) const;
     const struct MultiplierStructure *multiplier(uint16_t num) const;
@@ -439,6 +515,33 @@ public:
     // output a FMT message for each backend if not already done so
     void Safe_Write_Emit_FMT(log_write_fmt *f);
 
+    // limits the rate of non-critical messages, nullptr if no limits are set
+    AP_Logger_RateLimiter *_rate_limiter;
+    bool should_log_rate_limited(uint8_t msg_type) {
+        return _rate_limiter == nullptr || _rate_limiter->should_log(msg_type);
+    }
+
+    // adjust the throttling level from backend buffer fill
+    void update_throttle();
+    uint32_t _last_throttle_update_ms;
+    uint32_t _last_throttle_high_ms;
+
+    // pending CMPT message and last record for each message written
+    // with WriteCompact()
+    struct log_compact_state {
+        struct log_compact_state *next;
+        log_write_fmt *f;
+        uint32_t start_ms; // time the first record was added to pkt
+        uint8_t *prev;     // last record added to pkt
+        struct log_Compact pkt;
+    } *log_compact_states;
+    HAL_Semaphore log_compact_sem;
+
+    log_compact_state *compact_state_for_fmt(log_write_fmt *f);
+    bool Write_Compact_add(log_compact_state &s, const uint8_t *record);
+    void Write_Compact_flush(log_compact_state &s);
+    void Write_Compact_flush_old();
+
     // get count of number of times we have started logging
     uint8_t get_log_start_count(void) const {
         return _log_start_count;
@@ -470,6 +573,7 @@ private:
         FILESYSTEM = (1<<0),
         MAVLINK    = (1<<1),
         BLOCK      = (1<<2),
+        RAM        = (1<<3),
     };
 
     /*
@@ -567,6 +671,25 @@ private:
     GCS_MAVLINK *_log_sending_link;
     HAL_Semaphore _log_send_sem;
 
+#if HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+    // state for compressed download, allocated while in use
+    struct log_compress_state {
+        LogCompressor compressor;
+        uint8_t raw[LOG_COMPRESS_BLOCK_SIZE];
+        uint8_t block[2 + LOG_COMPRESS_BLOCK_SIZE]; // header and compressed or stored data
+        uint16_t block_len;
+        uint16_t block_sent;
+        uint32_t block_ofs; // raw offset of the start of the block
+        uint16_t block_raw_len;
+        uint8_t chunk_seq;
+    } *_log_compress;
+    bool _log_compressed;
+
+    bool setup_compressed_download(bool compressed);
+    void fill_compressed_block();
+    bool handle_log_send_compressed_data();
+#endif
+
     // last time arming failed, for backends
     uint32_t _last_arming_failure_ms;
 
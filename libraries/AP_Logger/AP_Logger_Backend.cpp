@@ -208,29 +208,13 @@ bool AP_Logger_Backend::Write_Emit_FMT(uint8_t msg_type)
     return true;
 }
 
-bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_critical)
+bool AP_Logger_Backend::msg_type_is_dynamic(uint8_t msg_type) const
+{
+    return _front.log_write_fmt_for_msg_type(msg_type) != nullptr;
+}
+
+void AP_Logger_Backend::pack_message(uint8_t *buffer, const uint8_t msg_type, const char *fmt, va_list arg_list)
 {
-    // stack-allocate a buffer so we can WriteBlock(); this could be
-    // 255 bytes!  If we were willing to lose the WriteBlock
-    // abstraction we could do WriteBytes() here instead?
-    const char *fmt  = nullptr;
-    uint8_t msg_len;
-    AP_Logger::log_write_fmt *f;
-    for (f = _front.log_write_fmts; f; f=f->next) {
-        if (f->msg_type == msg_type) {
-            fmt = f->fmt;
-            msg_len = f->msg_len;
-            break;
-        }
-    }
-    if (fmt == nullptr) {
-        INTERNAL_ERROR(AP_InternalError::error_t::logger_logwrite_missingfmt);
-        return false;
-    }
-    if (bufferspace_available() < msg_len) {
-        return false;
-    }
-    uint8_t buffer[msg_len];
     uint8_t offset = 0;
     buffer[offset++] = HEAD_BYTE1;
     buffer[offset++] = HEAD_BYTE2;
@@ -329,6 +313,32 @@ bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_
             offset += charlen;
         }
     }
+}
+
+bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_critical)
+{
+    // stack-allocate a buffer so we can WriteBlock(); this could be
+    // 255 bytes!  If we were willing to lose the WriteBlock
+    // abstraction we could do WriteBytes() here instead?
+    const char *fmt  = nullptr;
+    uint8_t msg_len;
+    AP_Logger::log_write_fmt *f;
+    for (f = _front.log_write_fmts; f; f=f->next) {
+        if (f->msg_type == msg_type) {
+            fmt = f->fmt;
+            msg_len = f->msg_len;
+            break;
+        }
+    }
+    if (fmt == nullptr) {
+        INTERNAL_ERROR(AP_InternalError::error_t::logger_logwrite_missingfmt);
+        return false;
+    }
+    if (bufferspace_available() < msg_len) {
+        return false;
+    }
+    uint8_t buffer[msg_len];
+    pack_message(buffer, msg_type, fmt, arg_list);
 
     return WritePrioritisedBlock(buffer, msg_len, is_critical);
 }
@@ -441,6 +451,10 @@ bool AP_Logger_Backend::ShouldLog(bool is_critical)
         }
     }
 
+    if (_ring_backed) {
+        return _ring_flushing;
+    }
+
     if (is_critical && have_logged_armed && !_front._params.file_disarm_rot) {
         // if we have previously logged while armed then we log all
         // critical messages from then on. That fixes a problem where
@@ -561,6 +575,9 @@ void AP_Logger_Backend::vehicle_was_disarmed()
 // this sensor is enabled if we should be logging at the moment
 bool AP_Logger_Backend::logging_enabled() const
 {
+    if (_ring_backed) {
+        return _ring_flushing;
+    }
     if (hal.util->get_soft_armed() ||
         _front.log_while_disarmed()) {
         return true;
@@ -579,6 +596,13 @@ void AP_Logger_Backend::Write_AP_Logger_Stats_File(const struct df_stats &_stats
         buf_space_min   : _stats.buf_space_min,
         buf_space_max   : _stats.buf_space_max,
         buf_space_avg   : (_stats.blocks) ? (_stats.buf_space_sigma / _stats.blocks) : 0,
+        fill_hist0      : _stats.fill_hist[0],
+        fill_hist1      : _stats.fill_hist[1],
+        fill_hist2      : _stats.fill_hist[2],
+        fill_hist3      : _stats.fill_hist[3],
+        write_time_max  : _stats.write_time_max_us,
+        write_time_avg  : (_stats.writes) ? (_stats.write_time_sigma_us / _stats.writes) : 0,
+        throttle_level  : _front.log_throttle_level(),
     };
     WriteBlock(&pkt, sizeof(pkt));
 }
@@ -595,6 +619,27 @@ void AP_Logger_Backend::df_stats_gather(const uint16_t bytes_written, uint32_t s
     stats.bytes += bytes_written;
     _log_file_size_bytes += bytes_written;
     stats.blocks++;
+
+    const uint8_t fill = buffer_fill_pct();
+    if (fill < 50) {
+        stats.fill_hist[0]++;
+    } else if (fill < 75) {
+        stats.fill_hist[1]++;
+    } else if (fill < 90) {
+        stats.fill_hist[2]++;
+    } else {
+        stats.fill_hist[3]++;
+    }
+}
+
+// record the time taken by a write to the storage device
+void AP_Logger_Backend::df_stats_write_time(uint32_t time_us)
+{
+    if (time_us > stats.write_time_max_us) {
+        stats.write_time_max_us = time_us;
+    }
+    stats.write_time_sigma_us += time_us;
+    stats.writes++;
 }
 
 void AP_Logger_Backend::df_stats_clear() {
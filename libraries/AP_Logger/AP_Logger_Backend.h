@@ -47,6 +47,9 @@ public:
 
     virtual uint32_t bufferspace_available() = 0;
 
+    // percentage of the write buffer in use, for adaptive throttling
+    virtual uint8_t buffer_fill_pct() const { return 0; }
+
     virtual void PrepForArming();
 
     virtual void start_new_log() { }
@@ -105,6 +108,11 @@ public:
         return _dropped;
     }
 
+    // number of writes which had to wait for (contended) or did not
+    // wait for (uncontended) a backend lock
+    virtual uint32_t num_writes_contended(void) const { return 0; }
+    virtual uint32_t num_writes_uncontended(void) const { return 0; }
+
     /*
      * Write support
      */
@@ -116,6 +124,10 @@ public:
     // values contained in arg_list:
     bool Write(uint8_t msg_type, va_list arg_list, bool is_critical=false);
 
+    // pack the values in arg_list into a log message of msg_type
+    // with the fields given by fmt. buffer must hold the full message
+    static void pack_message(uint8_t *buffer, uint8_t msg_type, const char *fmt, va_list arg_list);
+
     // these methods are used when reporting system status over mavlink
     virtual bool logging_enabled() const;
     virtual bool logging_failed() const = 0;
@@ -132,6 +144,17 @@ public:
 
     virtual void io_timer(void) {}
 
+    // set by AP_Logger_RAM on the backend it wraps; that backend
+    // then only logs, armed or not, while the ring is flushed to it
+    void set_ring_flushing(bool flushing) {
+        _ring_backed = true;
+        _ring_flushing = flushing;
+    }
+
+    // true if msg_type was created by AP_Logger::Write rather than
+    // coming from the vehicle's log structures
+    bool msg_type_is_dynamic(uint8_t msg_type) const;
+
 protected:
 
     AP_Logger &_front;
@@ -197,6 +220,7 @@ protected:
     bool _initialised;
 
     void df_stats_gather(uint16_t bytes_written, uint32_t space_remaining);
+    void df_stats_write_time(uint32_t time_us);
     void df_stats_log();
     void df_stats_clear();
 
@@ -208,12 +232,20 @@ private:
         uint32_t buf_space_min;
         uint32_t buf_space_max;
         uint32_t buf_space_sigma;
+        // count of writes with the buffer under 50%, 75%, 90% and over 90% full
+        uint16_t fill_hist[4];
+        // time taken by writes to the storage device
+        uint16_t writes;
+        uint32_t write_time_max_us;
+        uint32_t write_time_sigma_us;
     };
     struct df_stats stats;
 
     uint32_t _last_periodic_1Hz;
     uint32_t _last_periodic_10Hz;
     bool have_logged_armed;
+    bool _ring_backed;
+    bool _ring_flushing;
 
     void Write_AP_Logger_Stats_File(const struct df_stats &_stats);
     void validate_WritePrioritisedBlock(const void *pBuffer, uint16_t size);
@@ -17,13 +17,17 @@ const extern AP_HAL::HAL& hal;
 // this if (and only if!) the low level format changes
 #define DF_LOGGING_FORMAT    0x1901201B
 
+// time the IO thread may spend writing pages on each call
+#define LOG_BLOCK_WRITE_TIME_US 1000
+
 AP_Logger_Block::AP_Logger_Block(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
     writebuf(0),
     AP_Logger_Backend(front, writer)
 {
     // buffer is used for both reads and writes so access must always be within the semaphore
     buffer = (uint8_t *)hal.util->malloc_type(page_size_max, AP_HAL::Util::MEM_DMA_SAFE);
-    if (buffer == nullptr) {
+    next_page = (uint8_t *)hal.util->malloc_type(page_size_max, AP_HAL::Util::MEM_DMA_SAFE);
+    if (buffer == nullptr || next_page == nullptr) {
         AP_HAL::panic("Out of DMA memory for logging");
     }
     df_stats_clear();
@@ -78,6 +82,8 @@ uint32_t AP_Logger_Block::bufferspace_available()
 void AP_Logger_Block::StartWrite(uint32_t PageAdr)
 {
     df_PageAdr    = PageAdr;
+    // we can't be sure what has been written since the erase ahead
+    df_PreErasedBlock = UINT32_MAX;
 }
 
 void AP_Logger_Block::FinishWrite(void)
@@ -93,22 +99,59 @@ void AP_Logger_Block::FinishWrite(void)
 
     // when starting a new sector, erase it
     if ((df_PageAdr-1) % df_PagePerBlock == 0) {
-        // if we have wrapped over an existing log, force the oldest to be recalculated
-        if (_cached_oldest_log > 0) {
-            uint16_t log_num = StartRead(df_PageAdr);
-            if (log_num != 0xFFFF && log_num >= _cached_oldest_log) {
-                _cached_oldest_log = 0;
-            }
+        const uint32_t block = df_PageAdr / df_PagePerBlock;
+        if (block == df_PreErasedBlock) {
+            // already erased while we were idle
+            df_PreErasedBlock = UINT32_MAX;
+            return;
         }
+        check_wrapped_log(df_PageAdr);
         // are we about to erase a sector with our own headers in it?
         if (df_Write_FilePage > df_NumPages - df_PagePerBlock) {
             chip_full = true;
             return;
         }
-        SectorErase(df_PageAdr / df_PagePerBlock);
+        SectorErase(block);
+    }
+}
+
+// if we are about to overwrite an existing log, force the oldest to be recalculated
+void AP_Logger_Block::check_wrapped_log(uint32_t PageAdr)
+{
+    if (_cached_oldest_log > 0) {
+        uint16_t log_num = StartRead(PageAdr);
+        if (log_num != 0xFFFF && log_num >= _cached_oldest_log) {
+            _cached_oldest_log = 0;
+        }
     }
 }
 
+/*
+  erase the block after the one being written while the chip is idle,
+  so that the write pointer doesn't have to wait for the erase when it
+  gets there
+ */
+void AP_Logger_Block::pre_erase_next_block()
+{
+    if (!log_write_started || df_PreErasedBlock != UINT32_MAX) {
+        return;
+    }
+    // don't erase ahead into the start of the current log
+    if (df_Write_FilePage > df_NumPages - 2 * df_PagePerBlock) {
+        return;
+    }
+    uint32_t next_block = get_block(df_PageAdr) + 1;
+    if (next_block >= df_NumPages / df_PagePerBlock) {
+        next_block = 0;
+    }
+    if (Busy()) {
+        return;
+    }
+    check_wrapped_log(next_block * df_PagePerBlock + 1);
+    SectorErase(next_block);
+    df_PreErasedBlock = next_block;
+}
+
 bool AP_Logger_Block::WritesOK() const
 {
     if (!CardInserted() || erase_started) {
@@ -292,6 +335,7 @@ void AP_Logger_Block::EraseAll()
     // throw away everything
     log_write_started = false;
     writebuf.clear();
+    next_page_len = 0;
 
     // reset the format version and wrapped status so that any incomplete erase will be caught
     Sector4kErase(get_sector(df_NumPages));
@@ -525,6 +569,7 @@ void AP_Logger_Block::stop_logging(void)
 
     // nuke writing any previous log
     writebuf.clear();
+    next_page_len = 0;
 }
 
 // stop logging and flush any remaining data
@@ -825,7 +870,8 @@ bool AP_Logger_Block::io_thread_alive() const
   The IO timer runs every 1ms or at 1Khz. The standard flash chip can write rougly 130Kb/s
   so there is little point in trying to write more than 130 bytes - or 1 page (256 bytes).
   The W25Q128FV datasheet gives tpp as typically 0.7ms yielding an absolute maximum rate of
-  365Kb/s or just over a page per cycle.
+  365Kb/s or just over a page per cycle, so we keep writing pages for up to
+  LOG_BLOCK_WRITE_TIME_US while there is data to write.
  */
 void AP_Logger_Block::io_timer(void)
 {
@@ -889,23 +935,49 @@ void AP_Logger_Block::io_timer(void)
         log_write_started = false;
 
         // complete writing any previous log, a page at a time to avoid holding the lock for too long
-        if (writebuf.available()) {
+        if (writebuf.available() || next_page_len > 0) {
             write_log_page();
         } else {
             writebuf.clear();
             stop_log_pending = false;
         }
 
-    // write at most one page
-    } else if (writebuf.available() >= df_PageSize - sizeof(struct PageHeader)) {
+    } else {
         WITH_SEMAPHORE(sem);
 
-        write_log_page();
+        write_log_pages();
+        if (next_page_len == 0 && !chip_full) {
+            // not enough data for a page, use the time to erase ahead
+            pre_erase_next_block();
+        }
     }
 }
 
-// write out a page of log data
-void AP_Logger_Block::write_log_page()
+/*
+  fill next_page from the write buffer if it isn't already full.
+  Returns true if there is a page ready to write. Partial pages are
+  only written when flushing the log
+ */
+bool AP_Logger_Block::prepare_log_page(bool partial)
+{
+    if (next_page_len > 0) {
+        return true;
+    }
+    const uint32_t pagesize = df_PageSize - sizeof(struct PageHeader);
+    const uint32_t available = writebuf.available();
+    if (available == 0 || (!partial && available < pagesize)) {
+        return false;
+    }
+    uint32_t nbytes = writebuf.read(&next_page[sizeof(struct PageHeader)], pagesize);
+    if (nbytes <  pagesize) {
+        memset(&next_page[sizeof(struct PageHeader) + nbytes], 0, pagesize - nbytes);
+    }
+    next_page_len = nbytes;
+    return true;
+}
+
+// write the prepared page to the chip
+void AP_Logger_Block::write_prepared_page()
 {
     struct PageHeader ph;
     ph.FileNumber = df_Write_FileNumber;
@@ -913,14 +985,55 @@ void AP_Logger_Block::write_log_page()
 #if BLOCK_LOG_VALIDATE
     ph.crc = DF_LOGGING_FORMAT + df_Write_FilePage;
 #endif
-    memcpy(buffer, &ph, sizeof(ph));
-    const uint32_t pagesize = df_PageSize - sizeof(ph);
-    uint32_t nbytes = writebuf.read(&buffer[sizeof(ph)], pagesize);
-    if (nbytes <  pagesize) {
-        memset(&buffer[sizeof(ph) + nbytes], 0, pagesize - nbytes);
-    }
+    memcpy(next_page, &ph, sizeof(ph));
+
+    // the backends write from buffer, and the page we were using for
+    // the write becomes free for the next one
+    uint8_t *tmp = buffer;
+    buffer = next_page;
+    next_page = tmp;
+    next_page_len = 0;
+
+    const uint32_t write_start_us = AP_HAL::micros();
     FinishWrite();
+    df_stats_write_time(AP_HAL::micros() - write_start_us);
     df_Write_FilePage++;
 }
 
+// write out a page of log data, including a partial page
+void AP_Logger_Block::write_log_page()
+{
+    if (prepare_log_page(true)) {
+        write_prepared_page();
+    }
+}
+
+/*
+  write as many full pages as the chip will take within
+  LOG_BLOCK_WRITE_TIME_US. The next page is filled while the chip is
+  programming the last one, so the chip is given a new page as soon as
+  it is ready. We never wait on an erase, the write buffer soaks up
+  the data instead
+ */
+void AP_Logger_Block::write_log_pages()
+{
+    const uint32_t start_us = AP_HAL::micros();
+    bool wrote_page = false;
+    while (prepare_log_page(false)) {
+        // only wait for our own page programs, an erase takes far longer
+        while (Busy()) {
+            if (!wrote_page || AP_HAL::micros() - start_us > LOG_BLOCK_WRITE_TIME_US) {
+                return;
+            }
+        }
+        write_prepared_page();
+        wrote_page = true;
+        if (chip_full || AP_HAL::micros() - start_us > LOG_BLOCK_WRITE_TIME_US) {
+            // have the next page ready for the next call
+            prepare_log_page(false);
+            return;
+        }
+    }
+}
+
 #endif // HAL_LOGGING_BLOCK_ENABLED
@@ -27,6 +27,9 @@ public:
     uint16_t get_num_logs() override;
     void start_new_log(void) override;
     uint32_t bufferspace_available() override;
+    uint8_t buffer_fill_pct() const override {
+        return writebuf.get_size() ? 100U - (100U * writebuf.space()) / writebuf.get_size() : 0;
+    }
     void stop_logging(void) override;
     void stop_logging_async(void) override;
     bool logging_failed() const override;
@@ -62,6 +65,8 @@ protected:
 
     static const uint16_t page_size_max = 256;
     uint8_t *buffer;
+    // next page of log data, filled while the previous page programs
+    uint8_t *next_page;
     uint32_t last_messagewrite_message_sent;
 
 private:
@@ -74,6 +79,8 @@ private:
     virtual void Sector4kErase(uint32_t SectorAdr) = 0;
     virtual void StartErase() = 0;
     virtual bool InErase() = 0;
+    // true while the chip is busy with a program or erase
+    virtual bool Busy() = 0;
 
     struct PACKED PageHeader {
         uint32_t FilePage;
@@ -106,6 +113,10 @@ private:
     uint32_t df_Write_FilePage;
     // page to wipe from in the case of corruption
     uint32_t df_EraseFrom;
+    // block erased ahead of the write pointer, or UINT32_MAX
+    uint32_t df_PreErasedBlock = UINT32_MAX;
+    // bytes of log data in next_page, excluding the page header
+    uint16_t next_page_len;
 
     // offset from adding FMT messages to log data
     bool adding_fmt_headers;
@@ -161,6 +172,11 @@ private:
     // callback on IO thread
     bool io_thread_alive() const;
     void write_log_page();
+    bool prepare_log_page(bool partial);
+    void write_prepared_page();
+    void write_log_pages();
+    void pre_erase_next_block();
+    void check_wrapped_log(uint32_t PageAdr);
 };
 
 #endif  // HAL_LOGGING_BLOCK_ENABLED
@@ -36,6 +36,9 @@ extern const AP_HAL::HAL& hal;
 // time between tries to open log
 #define LOGGER_FILE_REOPEN_MS 5000
 
+// magic number at the start of LOGINDEX.DAT
+#define LOGGER_INDEX_MAGIC 0x58444e49
+
 /*
   constructor
  */
@@ -85,6 +88,17 @@ void AP_Logger_File::Init()
         return;
     }
 
+    // writes from threads other than the main thread are staged in a
+    // smaller buffer so that they never contend with the main thread
+    uint32_t stagesize = MAX(bufsize / 8, 2 * critical_message_reserved_space(bufsize));
+    while (!_stagebuf.set_size(stagesize) && stagesize >= 1024) {
+        stagesize *= 0.9;
+    }
+    if (!_stagebuf.get_size()) {
+        hal.console->printf("Out of memory for logging\n");
+        return;
+    }
+
     hal.console->printf("AP_Logger_File: buffer size=%u\n", (unsigned)bufsize);
 
     _initialised = true;
@@ -94,6 +108,8 @@ void AP_Logger_File::Init()
         _log_directory = custom_dir;
     }
 
+    index_load();
+
     Prep_MinSpace();
 }
 
@@ -171,13 +187,15 @@ void AP_Logger_File::periodic_1Hz()
 
 void AP_Logger_File::periodic_fullrate()
 {
+    drain_stagebuf();
     AP_Logger_Backend::push_log_blocks();
 }
 
 uint32_t AP_Logger_File::bufferspace_available()
 {
-    const uint32_t space = _writebuf.space();
-    const uint32_t crit = critical_message_reserved_space(_writebuf.get_size());
+    ByteBuffer &buf = hal.scheduler->in_main_thread() ? _writebuf : _stagebuf;
+    const uint32_t space = buf.space();
+    const uint32_t crit = critical_message_reserved_space(buf.get_size());
 
     return (space > crit) ? space - crit : 0;
 }
@@ -215,6 +233,10 @@ int64_t AP_Logger_File::disk_space()
 // returns 0 if no log was found
 uint16_t AP_Logger_File::find_oldest_log()
 {
+    if (_index.valid) {
+        return index_oldest_log();
+    }
+
     if (_cached_oldest_log != 0) {
         return _cached_oldest_log;
     }
@@ -336,6 +358,7 @@ void AP_Logger_File::Prep_MinSpace()
                 }
             } else {
                 free(filename_to_remove);
+                index_update(log_to_remove, false, 0, 0);
             }
         }
         log_to_remove++;
@@ -405,6 +428,269 @@ char *AP_Logger_File::_lastlog_file_name(void) const
     return buf;
 }
 
+/*
+  return path name of the log index file
+  Note: Caller must free.
+ */
+char *AP_Logger_File::_index_file_name(void) const
+{
+    char *buf = nullptr;
+    if (asprintf(&buf, "%s/LOGINDEX.DAT", _log_directory) == -1) {
+        return nullptr;
+    }
+    return buf;
+}
+
+/*
+  load the log index, rebuilding it if it is missing or doesn't match
+  the logs on the card
+ */
+void AP_Logger_File::index_load()
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    index_invalidate();
+
+    char *fname = _index_file_name();
+    if (fname == nullptr) {
+        return;
+    }
+    EXPECT_DELAY_MS(3000);
+    _index_fd = AP::FS().open(fname, O_RDWR);
+    free(fname);
+    if (_index_fd == -1) {
+        index_rebuild();
+        return;
+    }
+
+    struct log_index_header hdr {};
+    bool ok = AP::FS().read(_index_fd, &hdr, sizeof(hdr)) == int32_t(sizeof(hdr)) &&
+        hdr.magic == LOGGER_INDEX_MAGIC &&
+        hdr.max_log_files == MAX_LOG_FILES &&
+        hdr.last_log == find_last_log();
+
+    // read the entries a chunk at a time
+    struct log_index_entry last_entry {};
+    struct log_index_entry entries[32];
+    for (uint16_t log_num=1; ok && log_num<=MAX_LOG_FILES; ) {
+        const uint16_t n = MIN(ARRAY_SIZE(entries), MAX_LOG_FILES+1U-log_num);
+        if (AP::FS().read(_index_fd, entries, n*sizeof(entries[0])) != int32_t(n*sizeof(entries[0]))) {
+            ok = false;
+            break;
+        }
+        for (uint16_t i=0; i<n; i++, log_num++) {
+            if (!entries[i].present) {
+                continue;
+            }
+            _index.present.set(log_num);
+            if (log_num == hdr.last_log) {
+                last_entry = entries[i];
+            }
+        }
+    }
+    if (!ok) {
+        index_rebuild();
+        return;
+    }
+    _index.last_log = hdr.last_log;
+
+    // cheap check that nobody has added or removed logs behind our
+    // back
+    const uint16_t oldest = index_oldest_log();
+    if (log_exists(oldest) != _index.present.get(oldest) ||
+        log_exists(hdr.last_log) != _index.present.get(hdr.last_log)) {
+        index_rebuild();
+        return;
+    }
+
+    if (_index.present.get(hdr.last_log) && last_entry.size == 0) {
+        // the last log wasn't closed cleanly, so its size was never
+        // recorded
+        const uint32_t size = _get_log_size(hdr.last_log);
+        const uint32_t time_utc = _get_log_time(hdr.last_log);
+        _index.valid = true;
+        index_update(hdr.last_log, true, size, time_utc);
+        return;
+    }
+
+    _index.valid = true;
+}
+
+/*
+  rebuild the log index from the log directory. This is as slow as
+  listing the logs without an index, but only needs doing when the
+  index is missing or out of date
+ */
+void AP_Logger_File::index_rebuild()
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    index_invalidate();
+
+    if (hal.util->was_watchdog_reset()) {
+        // it takes too long, fall back to scanning as needed
+        return;
+    }
+
+    char *fname = _index_file_name();
+    if (fname == nullptr) {
+        return;
+    }
+    ensure_log_directory_exists();
+    EXPECT_DELAY_MS(3000);
+    _index_fd = AP::FS().open(fname, O_RDWR|O_CREAT|O_TRUNC);
+    free(fname);
+    if (_index_fd == -1) {
+        return;
+    }
+
+    // write an empty index, then fill in the logs we find
+    const struct log_index_header hdr {
+        magic         : LOGGER_INDEX_MAGIC,
+        max_log_files : MAX_LOG_FILES,
+        last_log      : find_last_log(),
+    };
+    bool ok = AP::FS().write(_index_fd, &hdr, sizeof(hdr)) == int32_t(sizeof(hdr));
+    const struct log_index_entry entries[32] {};
+    for (uint16_t log_num=1; ok && log_num<=MAX_LOG_FILES; log_num += ARRAY_SIZE(entries)) {
+        const uint16_t n = MIN(ARRAY_SIZE(entries), MAX_LOG_FILES+1U-log_num);
+        ok = AP::FS().write(_index_fd, entries, n*sizeof(entries[0])) == int32_t(n*sizeof(entries[0]));
+    }
+    _index.last_log = hdr.last_log;
+    _index.valid = ok;
+
+    EXPECT_DELAY_MS(3000);
+    auto *d = AP::FS().opendir(_log_directory);
+    if (d == nullptr) {
+        index_invalidate();
+        return;
+    }
+    EXPECT_DELAY_MS(3000);
+    for (struct dirent *de=AP::FS().readdir(d); _index.valid && de; de=AP::FS().readdir(d)) {
+        EXPECT_DELAY_MS(3000);
+        const uint8_t length = strlen(de->d_name);
+        if (length < 5 || strncmp(&de->d_name[length-4], ".BIN", 4)) {
+            // not \d+[.]BIN
+            continue;
+        }
+        const uint16_t log_num = strtoul(de->d_name, nullptr, 10);
+        if (log_num == 0 || log_num > MAX_LOG_FILES) {
+            continue;
+        }
+        char *path = nullptr;
+        if (asprintf(&path, "%s/%s", _log_directory, de->d_name) == -1) {
+            index_invalidate();
+            break;
+        }
+        struct stat st;
+        const bool have_stat = AP::FS().stat(path, &st) == 0;
+        free(path);
+        if (have_stat) {
+            index_update(log_num, true, st.st_size, st.st_mtime);
+        }
+    }
+    AP::FS().closedir(d);
+}
+
+/*
+  stop using the index and remove it, so that it is rebuilt on the
+  next boot
+ */
+void AP_Logger_File::index_invalidate()
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    const bool was_valid = _index.valid;
+    _index.valid = false;
+    _index.present.clearall();
+    if (_index_fd != -1) {
+        AP::FS().close(_index_fd);
+        _index_fd = -1;
+    }
+    if (!was_valid) {
+        return;
+    }
+    char *fname = _index_file_name();
+    if (fname != nullptr) {
+        AP::FS().unlink(fname);
+        free(fname);
+    }
+}
+
+// the oldest log present in the index, 0 if there are none
+uint16_t AP_Logger_File::index_oldest_log() const
+{
+    // logs numbered after the last log are older than those before it
+    for (uint16_t i=1; i<=MAX_LOG_FILES; i++) {
+        const uint16_t log_num = (_index.last_log + i - 1) % MAX_LOG_FILES + 1;
+        if (_index.present.get(log_num)) {
+            return log_num;
+        }
+    }
+    return 0;
+}
+
+/*
+  fetch the index entry for a log. Returns false if the index can't
+  answer, in which case the card has to be examined
+ */
+bool AP_Logger_File::index_get(const uint16_t log_num, struct log_index_entry &entry)
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    if (!_index.valid || log_num == 0 || log_num > MAX_LOG_FILES) {
+        return false;
+    }
+    if (!_index.present.get(log_num)) {
+        entry = {};
+        return true;
+    }
+    if (AP::FS().lseek(_index_fd, sizeof(struct log_index_header) + (log_num-1)*sizeof(entry), SEEK_SET) == -1 ||
+        AP::FS().read(_index_fd, &entry, sizeof(entry)) != int32_t(sizeof(entry))) {
+        index_invalidate();
+        return false;
+    }
+    return true;
+}
+
+/*
+  record a log being created, closed or removed in the index
+ */
+void AP_Logger_File::index_update(const uint16_t log_num, bool present, uint32_t size, uint32_t time_utc, bool is_last_log)
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    if (!_index.valid || log_num == 0 || log_num > MAX_LOG_FILES) {
+        return;
+    }
+    const struct log_index_entry entry {
+        size     : size,
+        time_utc : time_utc,
+        present  : present,
+    };
+    bool ok = AP::FS().lseek(_index_fd, sizeof(struct log_index_header) + (log_num-1)*sizeof(entry), SEEK_SET) != -1 &&
+        AP::FS().write(_index_fd, &entry, sizeof(entry)) == int32_t(sizeof(entry));
+    if (ok && is_last_log) {
+        const struct log_index_header hdr {
+            magic         : LOGGER_INDEX_MAGIC,
+            max_log_files : MAX_LOG_FILES,
+            last_log      : log_num,
+        };
+        ok = AP::FS().lseek(_index_fd, 0, SEEK_SET) != -1 &&
+            AP::FS().write(_index_fd, &hdr, sizeof(hdr)) == int32_t(sizeof(hdr));
+        _index.last_log = log_num;
+    }
+    if (!ok || AP::FS().fsync(_index_fd) != 0) {
+        index_invalidate();
+        return;
+    }
+    if (present) {
+        _index.present.set(log_num);
+    } else {
+        _index.present.clear(log_num);
+    }
+}
+
 
 // remove all log files
 void AP_Logger_File::EraseAll()
@@ -451,20 +737,37 @@ bool AP_Logger_File::StartNewLogOK() const
 /* Write a block of data at current offset */
 bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
 {
-    WITH_SEMAPHORE(semaphore);
-
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
     if (! WriteBlockCheckStartupMessages()) {
         _dropped++;
         return false;
     }
-
-#if APM_BUILD_TYPE(APM_BUILD_Replay)
     if (AP::FS().write(_write_fd, pBuffer, size) != size) {
         AP_HAL::panic("Short write");
     }
     return true;
+#else
+    if (hal.scheduler->in_main_thread()) {
+        return write_main_thread(pBuffer, size, is_critical);
+    }
+    return write_other_thread(pBuffer, size, is_critical);
 #endif
+}
+
+/*
+  write a block from the main thread. The main thread is the only
+  producer for _writebuf so this never waits on a lock, regardless of
+  how long the IO thread takes to write to the filesystem
+ */
+bool AP_Logger_File::write_main_thread(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (! WriteBlockCheckStartupMessages()) {
+        _dropped++;
+        return false;
+    }
 
+    // keep blocks from other threads flowing ahead of our own
+    drain_stagebuf();
 
     uint32_t space = _writebuf.space();
 
@@ -496,16 +799,82 @@ bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
         return false;
     }
 
-    _writebuf.write((uint8_t*)pBuffer, size);
+    ByteBuffer::IoVec vec[2];
+    const uint8_t n_vec = _writebuf.reserve(vec, size);
+    uint32_t ofs = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        memcpy(vec[i].data, (const uint8_t *)pBuffer + ofs, vec[i].len);
+        ofs += vec[i].len;
+    }
+    _writebuf.commit(ofs);
+
+    _writes_uncontended++;
     df_stats_gather(size, _writebuf.space());
     return true;
 }
 
+/*
+  write a block from a thread other than the main thread. These
+  producers serialise on the semaphore for the staging buffer, which
+  is only ever held for the duration of a memcpy
+ */
+bool AP_Logger_File::write_other_thread(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (semaphore.take_nonblocking()) {
+        _writes_uncontended++;
+    } else {
+        semaphore.take_blocking();
+        _writes_contended++;
+    }
+
+    bool ret = false;
+    if (! WriteBlockCheckStartupMessages()) {
+        _dropped++;
+    } else {
+        const uint32_t space = _stagebuf.space();
+        if ((!is_critical && space < critical_message_reserved_space(_stagebuf.get_size())) ||
+            space < size) {
+            _dropped++;
+        } else {
+            _stagebuf.write((const uint8_t *)pBuffer, size);
+            ret = true;
+        }
+    }
+
+    semaphore.give();
+    return ret;
+}
+
+/*
+  move complete blocks from the staging buffer into the write
+  buffer. Called only from the main thread, which is the sole consumer
+  of _stagebuf and the sole producer of _writebuf. Blocks are moved
+  all-or-nothing so that the main thread's own writes can never be
+  interleaved with part of a staged block
+ */
+void AP_Logger_File::drain_stagebuf(void)
+{
+    const uint32_t n = _stagebuf.available();
+    if (n == 0 || n > _writebuf.space()) {
+        return;
+    }
+    ByteBuffer::IoVec vec[2];
+    const uint8_t n_vec = _stagebuf.peekiovec(vec, n);
+    for (uint8_t i = 0; i < n_vec; i++) {
+        _writebuf.write(vec[i].data, vec[i].len);
+    }
+    _stagebuf.advance(n);
+    df_stats_gather(n, _writebuf.space());
+}
+
 /*
   find the highest log number
  */
 uint16_t AP_Logger_File::find_last_log()
 {
+    if (_index.valid) {
+        return _index.last_log;
+    }
     unsigned ret = 0;
     char *fname = _lastlog_file_name();
     if (fname == nullptr) {
@@ -523,6 +892,10 @@ uint16_t AP_Logger_File::find_last_log()
 
 uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
 {
+    struct log_index_entry entry;
+    if ((_write_fd == -1 || log_num != _write_log_num) && index_get(log_num, entry)) {
+        return entry.size;
+    }
     char *fname = _log_file_name(log_num);
     if (fname == nullptr) {
         return 0;
@@ -551,6 +924,10 @@ uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
 
 uint32_t AP_Logger_File::_get_log_time(const uint16_t log_num)
 {
+    struct log_index_entry entry;
+    if ((_write_fd == -1 || log_num != _write_log_num) && index_get(log_num, entry)) {
+        return entry.time_utc;
+    }
     char *fname = _log_file_name(log_num);
     if (fname == nullptr) {
         return 0;
@@ -624,6 +1001,10 @@ int16_t AP_Logger_File::get_log_data(const uint16_t list_entry, const uint16_t p
         _read_fd = AP::FS().open(fname, O_RDONLY);
         if (_read_fd == -1) {
             _open_error_ms = AP_HAL::millis();
+            if (errno == ENOENT) {
+                // removed behind our back
+                index_update(log_num, false, 0, 0);
+            }
             int saved_errno = errno;
             ::printf("Log read open fail for %s - %s\n",
                      fname, strerror(saved_errno));
@@ -681,14 +1062,14 @@ uint16_t AP_Logger_File::get_num_logs()
     uint16_t high = find_last_log();
     uint16_t i;
     for (i=high; i>0; i--) {
-        if (! log_exists(i)) {
+        if (! log_present(i)) {
             break;
         }
         ret++;
     }
     if (i == 0) {
         for (i=MAX_LOG_FILES; i>high; i--) {
-            if (! log_exists(i)) {
+            if (! log_present(i)) {
                 break;
             }
             ret++;
@@ -708,6 +1089,10 @@ void AP_Logger_File::stop_logging(void)
         int fd = _write_fd;
         _write_fd = -1;
         AP::FS().close(fd);
+
+        uint64_t utc_usec = 0;
+        AP::rtc().get_utc_usec(utc_usec);
+        index_update(_write_log_num, true, _write_offset, utc_usec / 1000000U);
     }
     if (have_sem) {
         write_fd_semaphore.give();
@@ -831,10 +1216,22 @@ void AP_Logger_File::start_new_log(void)
         }
         return;
     }
+    if (_front._params.file_prealloc > 0) {
+        // avoid cluster allocation stalls while flying, not an error
+        // if the filesystem can't do it
+        const int64_t avail = disk_space_avail();
+        uint32_t prealloc = uint32_t(MIN(_front._params.file_prealloc.get(), 4000)) * 1024U * 1024U;
+        if (avail > 0 && prealloc > avail) {
+            prealloc = avail;
+        }
+        AP::FS().preallocate(_write_fd, prealloc);
+    }
     _last_write_ms = AP_HAL::millis();
     _open_error_ms = 0;
     _write_offset = 0;
+    _write_log_num = log_num;
     _writebuf.clear();
+    _stagebuf.clear();
     write_fd_semaphore.give();
 
     // now update lastlog.txt with the new log number
@@ -856,9 +1253,14 @@ void AP_Logger_File::start_new_log(void)
 
     if (written < to_write) {
         _open_error_ms = AP_HAL::millis();
+        index_invalidate();
         return;
     }
 
+    uint64_t open_utc_usec = 0;
+    AP::rtc().get_utc_usec(open_utc_usec);
+    index_update(log_num, true, 0, open_utc_usec / 1000000U, true);
+
     return;
 }
 
@@ -867,6 +1269,7 @@ void AP_Logger_File::start_new_log(void)
 void AP_Logger_File::flush(void)
 #if APM_BUILD_TYPE(APM_BUILD_Replay) || APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
 {
+    drain_stagebuf();
     uint32_t tnow = AP_HAL::millis();
     while (_write_fd != -1 && _initialised && !recent_open_error() && _writebuf.available()) {
         // convince the IO timer that it really is OK to write out
@@ -961,6 +1364,7 @@ void AP_Logger_File::io_timer(void)
         write_fd_semaphore.give();
         return;
     }
+    const uint32_t write_start_us = AP_HAL::micros();
     ssize_t nwritten = AP::FS().write(_write_fd, head, nbytes);
     last_io_operation = "";
     if (nwritten <= 0) {
@@ -991,6 +1395,7 @@ void AP_Logger_File::io_timer(void)
         AP::FS().fsync(_write_fd);
         last_io_operation = "";
 #endif
+        df_stats_write_time(AP_HAL::micros() - write_start_us);
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
         // ChibiOS does not update mtime on writes, so if we opened
@@ -1076,6 +1481,8 @@ void AP_Logger_File::erase_next(void)
 
     _cached_oldest_log = 0;
 
+    index_rebuild();
+
     erase.log_num = 0;
 }
 
@@ -9,6 +9,7 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 
 #include <AP_HAL/utility/RingBuffer.h>
+#include <AP_Common/Bitmask.h>
 #include "AP_Logger_Backend.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
@@ -35,6 +36,13 @@ public:
     /* Write a block of data at current offset */
     bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override;
     uint32_t bufferspace_available() override;
+    uint8_t buffer_fill_pct() const override {
+        return _writebuf.get_size() ? 100U - (100U * _writebuf.space()) / _writebuf.get_size() : 0;
+    }
+
+    // write lock statistics
+    uint32_t num_writes_contended(void) const override { return _writes_contended; }
+    uint32_t num_writes_uncontended(void) const override { return _writes_uncontended; }
 
     // high level interface
     uint16_t find_last_log() override;
@@ -66,6 +74,7 @@ protected:
 private:
     int _write_fd = -1;
     char *_write_filename;
+    uint16_t _write_log_num;
     uint32_t _last_write_ms;
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
     bool _need_rtc_update;
@@ -95,20 +104,64 @@ private:
 
     bool file_exists(const char *filename) const;
     bool log_exists(const uint16_t lognum) const;
+    // log_exists(), answered from the index if possible
+    bool log_present(const uint16_t lognum) const {
+        return _index.valid ? (lognum <= MAX_LOG_FILES && _index.present.get(lognum)) : log_exists(lognum);
+    }
 
-    // write buffer
+    // write buffer. The main thread is the only producer and the IO
+    // thread the only consumer, so no lock is needed to access it
     ByteBuffer _writebuf{0};
     const uint16_t _writebuf_chunk = HAL_LOGGER_WRITE_CHUNK_SIZE;
     uint32_t _last_write_time;
 
+    // staging buffer for writes from threads other than the main
+    // thread. Producers serialise on the semaphore, the main thread
+    // drains it into _writebuf without taking the semaphore
+    ByteBuffer _stagebuf{0};
+    void drain_stagebuf(void);
+    bool write_main_thread(const void *pBuffer, uint16_t size, bool is_critical);
+    bool write_other_thread(const void *pBuffer, uint16_t size, bool is_critical);
+
     /* construct a file name given a log number. Caller must free. */
     char *_log_file_name(const uint16_t log_num) const;
     char *_log_file_name_long(const uint16_t log_num) const;
     char *_log_file_name_short(const uint16_t log_num) const;
     char *_lastlog_file_name() const;
+    char *_index_file_name() const;
     uint32_t _get_log_size(const uint16_t log_num);
     uint32_t _get_log_time(const uint16_t log_num);
 
+    /*
+      persistent index of the logs on the card, so listing logs
+      doesn't need a directory scan and a stat() of every file. The
+      index file holds a header and an entry for every possible log
+      number; which logs are present is also kept in memory
+     */
+    struct PACKED log_index_header {
+        uint32_t magic;
+        uint16_t max_log_files;
+        uint16_t last_log;
+    };
+    struct PACKED log_index_entry {
+        uint32_t size;      // bytes, zero while the log is open
+        uint32_t time_utc;  // seconds
+        uint8_t present;
+    };
+    struct {
+        bool valid;
+        uint16_t last_log;
+        Bitmask<MAX_LOG_FILES+1> present;
+    } _index;
+    int _index_fd = -1;
+    HAL_Semaphore _index_sem;
+    void index_load();
+    void index_rebuild();
+    void index_invalidate();
+    uint16_t index_oldest_log() const;
+    bool index_get(uint16_t log_num, struct log_index_entry &entry);
+    void index_update(uint16_t log_num, bool present, uint32_t size, uint32_t time_utc, bool is_last_log=false);
+
     void stop_logging(void) override;
 
     uint32_t last_messagewrite_message_sent;
@@ -120,7 +173,7 @@ private:
     const uint32_t _free_space_check_interval = 1000UL; // milliseconds
     const uint32_t _free_space_min_avail = 8388608; // bytes
 
-    // semaphore mediates access to the ringbuffer
+    // semaphore mediates access to the staging ringbuffer
     HAL_Semaphore semaphore;
     // write_fd_semaphore mediates access to write_fd so the frontend
     // can open/close files without causing the backend to write to a
@@ -136,6 +189,11 @@ private:
 
     const char *last_io_operation = "";
 
+    // count of writes which did (contended) and did not (uncontended)
+    // have to wait for a lock
+    uint32_t _writes_contended;
+    uint32_t _writes_uncontended;
+
     bool start_new_log_pending;
 };
 
@@ -124,6 +124,9 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
     mavlink_log_request_data_t packet;
     mavlink_msg_log_request_data_decode(&msg, &packet);
 
+    const bool compressed = (packet.id & LOG_DOWNLOAD_COMPRESSED_FLAG) != 0;
+    packet.id &= ~LOG_DOWNLOAD_COMPRESSED_FLAG;
+
     // consider opening or switching logs:
     if (transfer_activity != TransferActivity::SENDING || _log_num_data != packet.id) {
 
@@ -153,6 +156,20 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
         _log_data_remaining = packet.count;
     }
 
+#if HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+    if (!setup_compressed_download(compressed)) {
+        link.send_text(MAV_SEVERITY_INFO, "Log compression unavailable");
+        transfer_activity = TransferActivity::IDLE;
+        return;
+    }
+#else
+    if (compressed) {
+        // not supported on this board, the GCS should retry uncompressed
+        transfer_activity = TransferActivity::IDLE;
+        return;
+    }
+#endif
+
     transfer_activity = TransferActivity::SENDING;
     _log_sending_link = &link;
 
@@ -181,6 +198,10 @@ void AP_Logger::handle_log_request_end(GCS_MAVLINK &link, const mavlink_message_
 
     transfer_activity = TransferActivity::IDLE;
     _log_sending_link = nullptr;
+
+#if HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+    setup_compressed_download(false);
+#endif
 }
 
 /**
@@ -294,6 +315,12 @@ bool AP_Logger::handle_log_send_data()
         return false;
     }
 
+#if HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+    if (_log_compressed) {
+        return handle_log_send_compressed_data();
+    }
+#endif
+
     int16_t nbytes = 0;
     uint32_t len = _log_data_remaining;
 	mavlink_log_data_t packet;
@@ -331,4 +358,115 @@ bool AP_Logger::handle_log_send_data()
     return true;
 }
 
+#if HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+/**
+   switch between compressed and raw download, allocating the
+   compression state as needed. Returns false if it can't be allocated
+ */
+bool AP_Logger::setup_compressed_download(bool compressed)
+{
+    _log_compressed = false;
+    if (!compressed) {
+        delete _log_compress;
+        _log_compress = nullptr;
+        return true;
+    }
+    if (_log_compress == nullptr) {
+        _log_compress = new log_compress_state;
+        if (_log_compress == nullptr) {
+            return false;
+        }
+    }
+    _log_compress->block_len = 0;
+    _log_compress->block_sent = 0;
+    _log_compressed = true;
+    return true;
+}
+
+/**
+   read and compress the next block of log data
+ */
+void AP_Logger::fill_compressed_block()
+{
+    log_compress_state &c = *_log_compress;
+
+    const uint16_t len = MIN(_log_data_remaining, uint32_t(LOG_COMPRESS_BLOCK_SIZE));
+    int16_t nbytes = 0;
+    if (len > 0) {
+        nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, c.raw);
+        if (nbytes < 0) {
+            // report as EOF on error
+            nbytes = 0;
+        }
+    }
+
+    // only keep the compressed form if it is smaller
+    uint16_t data_len = 0;
+    uint16_t header = nbytes;
+    if (nbytes > 1) {
+        data_len = c.compressor.compress(c.raw, nbytes, &c.block[2], nbytes-1);
+    }
+    if (data_len == 0 && nbytes > 0) {
+        memcpy(&c.block[2], c.raw, nbytes);
+        data_len = nbytes;
+        header |= LOG_COMPRESS_BLOCK_STORED;
+    }
+    put_le16_ptr(c.block, header);
+
+    c.block_len = 2 + data_len;
+    c.block_sent = 0;
+    c.block_ofs = _log_data_offset;
+    c.block_raw_len = nbytes;
+    c.chunk_seq = 0;
+
+    _log_data_offset += nbytes;
+    _log_data_remaining -= nbytes;
+    if (nbytes < len) {
+        // short read, this is the end of the log
+        _log_data_remaining = 0;
+    }
+}
+
+/**
+   send the next chunk of compressed log data
+ */
+bool AP_Logger::handle_log_send_compressed_data()
+{
+    log_compress_state &c = *_log_compress;
+
+    if (c.block_sent >= c.block_len) {
+        fill_compressed_block();
+    }
+
+    mavlink_log_data_t packet;
+    const uint16_t n = MIN(c.block_len - c.block_sent, MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN-1);
+    const bool last_chunk = (c.block_sent + n == c.block_len);
+
+    packet.data[0] = (c.chunk_seq & 0x7F) | (last_chunk ? 0x80 : 0);
+    memcpy(&packet.data[1], &c.block[c.block_sent], n);
+    if (n+1 < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN) {
+        memset(&packet.data[n+1], 0, MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN-(n+1));
+    }
+
+    packet.ofs = c.block_ofs;
+    packet.id = _log_num_data | LOG_DOWNLOAD_COMPRESSED_FLAG;
+    packet.count = n+1;
+    _mav_finalize_message_chan_send(_log_sending_link->get_chan(),
+                                    MAVLINK_MSG_ID_LOG_DATA,
+                                    (const char *)&packet,
+                                    MAVLINK_MSG_ID_LOG_DATA_MIN_LEN,
+                                    MAVLINK_MSG_ID_LOG_DATA_LEN,
+                                    MAVLINK_MSG_ID_LOG_DATA_CRC);
+
+    c.block_sent += n;
+    c.chunk_seq++;
+    if (last_chunk && c.block_raw_len == 0) {
+        // the end of data marker has been sent
+        transfer_activity = TransferActivity::IDLE;
+        _log_sending_link = nullptr;
+    }
+    return true;
+}
+#endif // HAL_LOGGER_COMPRESSED_DOWNLOAD_ENABLED
+
 #endif
@@ -0,0 +1,260 @@
+/*
+   AP_Logger logging - RAM ring variant
+
+   Messages are kept in a ring in RAM, each preceded by its length so
+   the oldest whole message can be discarded to make space. Nothing
+   reaches the storage backend until an ERR message selected by
+   LOG_RAM_TRIG is logged. Storage then starts a log, writes its
+   usual formats and parameters, and is given the ring followed by
+   everything logged for LOG_RAM_POST seconds after the trigger.
+ */
+
+#include "AP_Logger_RAM.h"
+
+#if HAL_LOGGER_RAM_ENABLED
+
+#include "LoggerMessageWriter.h"
+
+#include <GCS_MAVLink/GCS.h>
+
+extern const AP_HAL::HAL& hal;
+
+void AP_Logger_RAM::Init()
+{
+    // the storage backend only logs when given the ring
+    _storage->set_ring_flushing(false);
+    _storage->Init();
+
+    uint32_t bufsize = uint32_t(_front._params.ram_size) * 1024U;
+    const uint32_t desired_bufsize = bufsize;
+    while (!_ring.set_size(bufsize) && bufsize >= 4096) {
+        bufsize /= 2;
+    }
+    if (_ring.get_size() == 0) {
+        hal.console->printf("AP_Logger_RAM: failed to allocate %u bytes\n", (unsigned)desired_bufsize);
+        return;
+    }
+    if (bufsize != desired_bufsize) {
+        hal.console->printf("AP_Logger_RAM: reduced ring %u/%u\n", (unsigned)bufsize, (unsigned)desired_bufsize);
+    }
+
+    _initialised = true;
+}
+
+void AP_Logger_RAM::start_new_log()
+{
+    start_new_log_reset_variables();
+    _logging_started = true;
+}
+
+void AP_Logger_RAM::stop_logging(void)
+{
+    _logging_started = false;
+    _storage->stop_logging();
+}
+
+bool AP_Logger_RAM::WritesOK() const
+{
+    return _initialised && _logging_started;
+}
+
+bool AP_Logger_RAM::logging_failed() const
+{
+    return !_initialised || _storage->logging_failed();
+}
+
+uint32_t AP_Logger_RAM::bufferspace_available()
+{
+    if (_state == State::RECORDING) {
+        // old messages are discarded to make space
+        return _ring.get_size();
+    }
+    return _ring.space();
+}
+
+uint8_t AP_Logger_RAM::buffer_fill_pct() const
+{
+    // only worth throttling while the ring is being flushed
+    if (_state == State::RECORDING || _ring.get_size() == 0) {
+        return 0;
+    }
+    return uint8_t((uint64_t(_ring.available()) * 100U) / _ring.get_size());
+}
+
+bool AP_Logger_RAM::is_trigger(const uint8_t *pBuffer, uint16_t size) const
+{
+    if (size != sizeof(struct log_Error) || pBuffer[2] != LOG_ERROR_MSG) {
+        return false;
+    }
+    struct log_Error pkt;
+    memcpy(&pkt, pBuffer, sizeof(pkt));
+    if (pkt.error_code == 0) {
+        // the error or failsafe has been resolved
+        return false;
+    }
+    const uint8_t triggers = uint8_t(_front._params.ram_trig);
+    switch (LogErrorSubsystem(pkt.sub_system)) {
+    case LogErrorSubsystem::CRASH_CHECK:
+        return triggers & uint8_t(Trigger::CRASH);
+    case LogErrorSubsystem::FAILSAFE_EKFINAV:
+        return triggers & uint8_t(Trigger::EKF_FAILSAFE);
+    case LogErrorSubsystem::FAILSAFE_VIBE:
+        return triggers & uint8_t(Trigger::VIBE_FAILSAFE);
+    default:
+        return triggers & uint8_t(Trigger::ANY_ERROR);
+    }
+}
+
+void AP_Logger_RAM::make_space(uint32_t len)
+{
+    while (_ring.space() < len) {
+        const int16_t oldest = _ring.peek(0);
+        if (oldest < 0) {
+            break;
+        }
+        _ring.advance(oldest + 1);
+    }
+}
+
+bool AP_Logger_RAM::_WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (size == 0 || size > UINT8_MAX) {
+        // every log message fits in the length byte
+        _dropped++;
+        return false;
+    }
+
+    WITH_SEMAPHORE(_ring_sem);
+
+    switch (_state) {
+    case State::RECORDING:
+        make_space(size + 1U);
+        break;
+    case State::TRIGGERED:
+        // messages from after the trigger are kept until written to storage
+        break;
+    case State::DRAINING:
+        return false;
+    }
+    if (_ring.space() < size + 1U) {
+        _dropped++;
+        return false;
+    }
+
+    const uint8_t len = size;
+    _ring.write(&len, 1);
+    _ring.write((const uint8_t *)pBuffer, size);
+
+    if (is_trigger((const uint8_t *)pBuffer, size)) {
+        _trigger_pending = true;
+    }
+    return true;
+}
+
+void AP_Logger_RAM::periodic_tasks()
+{
+    AP_Logger_Backend::periodic_tasks();
+    _storage->periodic_tasks();
+}
+
+void AP_Logger_RAM::periodic_10Hz(const uint32_t now)
+{
+    AP_Logger_Backend::periodic_10Hz(now);
+
+    if (_trigger_pending) {
+        _trigger_pending = false;
+        WITH_SEMAPHORE(_ring_sem);
+        if (_state == State::RECORDING) {
+            memset(_fmt_sent, 0, sizeof(_fmt_sent));
+            _storage->set_ring_flushing(true);
+            GCS_SEND_TEXT(MAV_SEVERITY_INFO, "Logger: writing RAM log");
+        }
+        // a later trigger extends the time logged after it
+        _state = State::TRIGGERED;
+        _trigger_ms = now;
+    }
+
+    switch (_state) {
+    case State::RECORDING:
+        return;
+    case State::TRIGGERED:
+        if (now - _trigger_ms >= uint32_t(_front._params.ram_post) * 1000U) {
+            WITH_SEMAPHORE(_ring_sem);
+            _state = State::DRAINING;
+        }
+        break;
+    case State::DRAINING:
+        if (_storage->logging_failed() ||
+            (_ring.is_empty() && _storage->buffer_fill_pct() == 0)) {
+            finish_flush();
+            return;
+        }
+        break;
+    }
+
+    if (!_storage->logging_started()) {
+        // a write starts logging on backends which open logs from the
+        // main thread; the File backend opens from its periodic tasks
+        _storage->Write_Message("RAM log");
+    }
+}
+
+void AP_Logger_RAM::push_log_blocks()
+{
+    AP_Logger_Backend::push_log_blocks();
+
+    if (_state == State::RECORDING) {
+        return;
+    }
+    // storage writes its own formats and parameters first
+    if (!_storage->logging_started() || !_storage->allow_start_ekf()) {
+        return;
+    }
+    drain();
+}
+
+void AP_Logger_RAM::drain()
+{
+    uint8_t buf[UINT8_MAX + 1];
+
+    WITH_SEMAPHORE(_ring_sem);
+
+    while (true) {
+        const int16_t len = _ring.peek(0);
+        if (len <= 0) {
+            break;
+        }
+        // leave room for the critical messages storage reserves space for
+        if (_storage->bufferspace_available() < uint32_t(len) + 1024U) {
+            break;
+        }
+        if (_ring.peekbytes(buf, len + 1) != uint32_t(len + 1)) {
+            break;
+        }
+        const uint8_t msg_type = buf[3];
+        const uint32_t fmt_bit = 1U << (msg_type & 31);
+        if (!(_fmt_sent[msg_type / 32] & fmt_bit) && msg_type_is_dynamic(msg_type)) {
+            // the storage log has only had the FMTs of the log structures
+            if (!_storage->Write_Emit_FMT(msg_type)) {
+                break;
+            }
+            _fmt_sent[msg_type / 32] |= fmt_bit;
+        }
+        if (!_storage->WriteBlock(&buf[1], len)) {
+            break;
+        }
+        _ring.advance(len + 1);
+    }
+}
+
+void AP_Logger_RAM::finish_flush()
+{
+    _storage->stop_logging_async();
+    _storage->set_ring_flushing(false);
+
+    WITH_SEMAPHORE(_ring_sem);
+    _ring.clear();
+    _state = State::RECORDING;
+}
+
+#endif // HAL_LOGGER_RAM_ENABLED
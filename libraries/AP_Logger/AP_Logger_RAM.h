@@ -0,0 +1,115 @@
+/*
+   AP_Logger logging - RAM ring variant
+
+   - keeps the most recent messages in a ring in RAM and only writes
+     them to the storage backend it wraps when a crash or failsafe is
+     logged, followed by LOG_RAM_POST seconds of messages after it
+ */
+#pragma once
+
+#include "AP_Logger_Backend.h"
+
+#if HAL_LOGGER_RAM_ENABLED
+
+#include <AP_HAL/utility/RingBuffer.h>
+
+class AP_Logger_RAM : public AP_Logger_Backend
+{
+public:
+    AP_Logger_RAM(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer,
+                  AP_Logger_Backend *storage) :
+        AP_Logger_Backend(front, writer),
+        _storage(storage),
+        _ring(0)
+        {}
+
+    void Init() override;
+
+    bool CardInserted(void) const override { return _storage->CardInserted(); }
+
+    // erase handling
+    void EraseAll() override { _storage->EraseAll(); }
+
+    // the log list and downloads are those of the storage backend
+    uint16_t find_last_log() override { return _storage->find_last_log(); }
+    void get_log_boundaries(uint16_t list_entry, uint32_t & start_page, uint32_t & end_page) override {
+        _storage->get_log_boundaries(list_entry, start_page, end_page);
+    }
+    void get_log_info(uint16_t list_entry, uint32_t &size, uint32_t &time_utc) override {
+        _storage->get_log_info(list_entry, size, time_utc);
+    }
+    int16_t get_log_data(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override {
+        return _storage->get_log_data(list_entry, page, offset, len, data);
+    }
+    uint16_t get_num_logs() override { return _storage->get_num_logs(); }
+    uint16_t find_oldest_log() override { return _storage->find_oldest_log(); }
+
+    bool logging_started(void) const override { return _logging_started; }
+    void start_new_log() override;
+    void stop_logging(void) override;
+
+    uint32_t bufferspace_available() override;
+    uint8_t buffer_fill_pct() const override;
+
+    bool logging_failed() const override;
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    void flush(void) override { _storage->flush(); }
+#endif
+
+    void periodic_tasks() override;
+    void io_timer(void) override { _storage->io_timer(); }
+
+    /* Write a block of data at current offset */
+    bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override;
+
+protected:
+
+    void periodic_10Hz(const uint32_t now) override;
+    void push_log_blocks() override;
+    bool WritesOK() const override;
+
+private:
+
+    enum class State : uint8_t {
+        RECORDING,  // overwriting the oldest messages
+        TRIGGERED,  // recording and flushing to storage until LOG_RAM_POST expires
+        DRAINING,   // flushing what is left in the ring to storage
+    };
+
+    // bits of LOG_RAM_TRIG
+    enum class Trigger : uint8_t {
+        CRASH         = (1U<<0),
+        EKF_FAILSAFE  = (1U<<1),
+        VIBE_FAILSAFE = (1U<<2),
+        ANY_ERROR     = (1U<<3),
+    };
+
+    // true if pBuffer is an ERR message selected by LOG_RAM_TRIG
+    bool is_trigger(const uint8_t *pBuffer, uint16_t size) const;
+
+    // discard the oldest messages until there is space for len bytes
+    void make_space(uint32_t len);
+
+    // write as much of the ring to storage as it has space for
+    void drain();
+
+    void finish_flush();
+
+    AP_Logger_Backend *_storage;
+
+    // messages, each preceded by its length
+    ByteBuffer _ring;
+    HAL_Semaphore _ring_sem;
+
+    State _state;
+    bool _trigger_pending;
+    bool _logging_started;
+    uint32_t _trigger_ms;
+
+    // dynamic message types whose FMT has been written to storage
+    // since the flush started
+    uint32_t _fmt_sent[8];
+};
+
+#endif // HAL_LOGGER_RAM_ENABLED
@@ -0,0 +1,54 @@
+#include "AP_Logger_RateLimiter.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Scheduler/AP_Scheduler.h>
+
+// messages arriving more often than this are streams which may be
+// decimated when throttled
+#define LOGGER_THROTTLE_STREAM_MS 20
+
+// maximum rate for a message type, zero for no limit
+float AP_Logger_RateLimiter::rate_for_msg_type(uint8_t msg_type) const
+{
+    for (uint8_t i=0; i<LOGGER_RATE_OVERRIDES; i++) {
+        if (_overrides[i].msg_type.get() == msg_type) {
+            return _overrides[i].rate_hz.get();
+        }
+    }
+    return _rate_max.get();
+}
+
+bool AP_Logger_RateLimiter::should_log(uint8_t msg_type)
+{
+    const uint16_t sched_count = AP::scheduler().ticks();
+    if (_last_sched_count[msg_type] == sched_count) {
+        // multiple messages of the same type in the same scheduler
+        // tick are how multi-instance messages such as IMU are
+        // written, so treat them all the same
+        return _last_tick_allowed.get(msg_type);
+    }
+
+    const uint16_t now_ms = AP_HAL::millis16();
+    bool allowed = true;
+    const float rate_hz = rate_for_msg_type(msg_type);
+    if (is_positive(rate_hz) && uint16_t(now_ms - _last_send_ms[msg_type]) < 1000.0f / rate_hz) {
+        allowed = false;
+    } else if (_throttle_level > 0 &&
+               uint16_t(now_ms - _last_seen_ms[msg_type]) < LOGGER_THROTTLE_STREAM_MS) {
+        // only decimate streams, low rate messages are left alone
+        const uint8_t mask = (1U << _throttle_level) - 1;
+        allowed = (++_decimate_count[msg_type] & mask) == 0;
+    }
+
+    _last_seen_ms[msg_type] = now_ms;
+    _last_sched_count[msg_type] = sched_count;
+    if (!allowed) {
+        _last_tick_allowed.clear(msg_type);
+        _dropped[msg_type]++;
+        return false;
+    }
+    _last_tick_allowed.set(msg_type);
+    _last_send_ms[msg_type] = now_ms;
+    return true;
+}
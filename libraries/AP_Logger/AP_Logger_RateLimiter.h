@@ -0,0 +1,55 @@
+/*
+  central rate limiting of log messages by message type
+ */
+#pragma once
+
+#include <AP_Common/Bitmask.h>
+#include <AP_Param/AP_Param.h>
+
+#define LOGGER_RATE_OVERRIDES 4
+
+// highest throttle level, where streams are decimated by 2^level
+#define LOGGER_THROTTLE_MAX_LEVEL 3
+
+class AP_Logger_RateLimiter {
+public:
+    struct Override {
+        AP_Int16 msg_type;
+        AP_Float rate_hz;
+    };
+
+    AP_Logger_RateLimiter(const AP_Float &rate_max, const Override *overrides) :
+        _rate_max(rate_max),
+        _overrides(overrides) {}
+
+    // return true if a message of this type should be written now
+    bool should_log(uint8_t msg_type);
+
+    // number of messages of this type dropped by rate limiting
+    uint32_t dropped(uint8_t msg_type) const { return _dropped[msg_type]; }
+
+    // when throttled, messages written at high rate are decimated by
+    // 2^level on top of any configured rate limit
+    void set_throttle_level(uint8_t level) { _throttle_level = MIN(level, LOGGER_THROTTLE_MAX_LEVEL); }
+    uint8_t get_throttle_level() const { return _throttle_level; }
+
+private:
+    const AP_Float &_rate_max;
+    const Override *_overrides;
+
+    uint8_t _throttle_level;
+
+    // time of the last message of each type we let through
+    uint16_t _last_send_ms[256];
+    // time of the last message of each type, whether written or not
+    uint16_t _last_seen_ms[256];
+    // scheduler tick of the last message of each type, and whether it
+    // was let through
+    uint16_t _last_sched_count[256];
+    Bitmask<256> _last_tick_allowed;
+    // counts messages of each type for decimation when throttled
+    uint8_t _decimate_count[256];
+    uint32_t _dropped[256];
+
+    float rate_for_msg_type(uint8_t msg_type) const;
+};
@@ -25,6 +25,7 @@ private:
     void  Sector4kErase(uint32_t SectorAdr) override;
     void  StartErase() override;
     bool  InErase() override;
+    bool  Busy() override { return false; }
 
     int flash_fd;
     uint32_t erase_started_ms;
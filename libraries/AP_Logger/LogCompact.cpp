@@ -0,0 +1,267 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  compact log records. Records written with WriteCompact() are delta
+  encoded field by field against the previous record of the same
+  message and packed several to a CMPT message. Each CMPT message is
+  self-contained: the first record in it is encoded against zero, so a
+  dropped message only loses the records it held. The FMT for the
+  original message is still written, so decoders can expand the
+  records using the normal format machinery
+ */
+
+#include <stdlib.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+#include "AP_Logger.h"
+#include "AP_Logger_Backend.h"
+
+extern const AP_HAL::HAL& hal;
+
+// maximum time a record may wait in a partially filled CMPT message
+#define LOG_COMPACT_FLUSH_MS 200
+
+// append v as a base-128 varint
+static bool put_varint(uint8_t *out, uint8_t space, uint8_t &ofs, uint64_t v)
+{
+    do {
+        if (ofs >= space) {
+            return false;
+        }
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        if (v != 0) {
+            b |= 0x80;
+        }
+        out[ofs++] = b;
+    } while (v != 0);
+    return true;
+}
+
+// read a little-endian unsigned field of len bytes
+static uint64_t get_field(const uint8_t *p, uint8_t len)
+{
+    uint64_t v = 0;
+    memcpy(&v, p, len);
+    return v;
+}
+
+// read a little-endian signed field of len bytes
+static int64_t get_signed_field(const uint8_t *p, uint8_t len)
+{
+    switch (len) {
+    case 1: {
+        int8_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    case 2: {
+        int16_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    case 4: {
+        int32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    default: {
+        int64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+
+/*
+  encode the fields of record against prev into out. Returns the
+  number of bytes used, or 0 if it does not fit in space
+ */
+static uint8_t compact_encode(const char *fmt, const uint8_t *record, const uint8_t *prev, uint8_t *out, uint8_t space)
+{
+    uint8_t ofs = 0;
+    // skip the packet header
+    uint16_t pos = LOG_PACKET_HEADER_LEN;
+    for (const char *c = fmt; *c; c++) {
+        uint8_t len = 0;
+        enum { SIGNED, UNSIGNED, BITS, BYTES } kind;
+        switch (*c) {
+        case 'b': len = 1; kind = SIGNED; break;
+        case 'h': case 'c': len = 2; kind = SIGNED; break;
+        case 'i': case 'e': case 'L': len = 4; kind = SIGNED; break;
+        case 'q': len = 8; kind = SIGNED; break;
+        case 'B': case 'M': len = 1; kind = UNSIGNED; break;
+        case 'H': case 'C': len = 2; kind = UNSIGNED; break;
+        case 'I': case 'E': len = 4; kind = UNSIGNED; break;
+        case 'Q': len = 8; kind = UNSIGNED; break;
+        case 'f': len = 4; kind = BITS; break;
+        case 'd': len = 8; kind = BITS; break;
+        case 'n': len = 4; kind = BYTES; break;
+        case 'N': len = 16; kind = BYTES; break;
+        case 'Z': case 'a': len = 64; kind = BYTES; break;
+        default:
+            return 0;
+        }
+        const uint8_t *r = &record[pos];
+        const uint8_t *p = &prev[pos];
+        pos += len;
+
+        switch (kind) {
+        case SIGNED:
+        case UNSIGNED: {
+            const int64_t delta = (kind == SIGNED) ?
+                get_signed_field(r, len) - get_signed_field(p, len) :
+                int64_t(get_field(r, len) - get_field(p, len));
+            // zigzag so small negative deltas are small too
+            const uint64_t zz = (uint64_t(delta) << 1) ^ uint64_t(delta >> 63);
+            if (!put_varint(out, space, ofs, zz)) {
+                return 0;
+            }
+            break;
+        }
+        case BITS:
+            // slowly changing floats mostly differ in the low mantissa bits
+            if (!put_varint(out, space, ofs, get_field(r, len) ^ get_field(p, len))) {
+                return 0;
+            }
+            break;
+        case BYTES:
+            if (ofs + len > space) {
+                return 0;
+            }
+            memcpy(&out[ofs], r, len);
+            ofs += len;
+            break;
+        }
+    }
+    return ofs;
+}
+
+void AP_Logger::WriteCompact(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, ...)
+{
+    struct log_write_fmt *f = msg_fmt_for_name(name, labels, units, mults, fmt);
+    if (f == nullptr) {
+        // unable to map name to a messagetype; could be out of
+        // msgtypes, could be out of slots, ...
+        INTERNAL_ERROR(AP_InternalError::error_t::logger_mapfailure);
+        return;
+    }
+    if (!should_log_rate_limited(f->msg_type)) {
+        return;
+    }
+
+    uint8_t record[f->msg_len];
+    va_list arg_list;
+    va_start(arg_list, fmt);
+    AP_Logger_Backend::pack_message(record, f->msg_type, f->fmt, arg_list);
+    va_end(arg_list);
+
+    {
+        WITH_SEMAPHORE(log_compact_sem);
+        log_compact_state *s = compact_state_for_fmt(f);
+        if (s != nullptr && Write_Compact_add(*s, record)) {
+            return;
+        }
+    }
+
+    // couldn't be encoded compactly, write it in full
+    Safe_Write_Emit_FMT(f);
+    WritePrioritisedBlock(record, f->msg_len, false);
+}
+
+// return (possibly allocating) the compact state for a message format
+AP_Logger::log_compact_state *AP_Logger::compact_state_for_fmt(log_write_fmt *f)
+{
+    for (log_compact_state *s = log_compact_states; s; s=s->next) {
+        if (s->f == f) {
+            return s;
+        }
+    }
+    log_compact_state *s = (log_compact_state *)calloc(1, sizeof(*s));
+    if (s == nullptr) {
+        return nullptr;
+    }
+    s->prev = (uint8_t *)calloc(1, f->msg_len);
+    if (s->prev == nullptr) {
+        free(s);
+        return nullptr;
+    }
+    s->f = f;
+    s->pkt.head1 = HEAD_BYTE1;
+    s->pkt.head2 = HEAD_BYTE2;
+    s->pkt.msgid = LOG_COMPACT_MSG;
+    s->pkt.msg_type = f->msg_type;
+    s->next = log_compact_states;
+    log_compact_states = s;
+    return s;
+}
+
+/*
+  add a record to the pending CMPT message, starting a new one if it
+  doesn't fit. Returns false if the record can't be encoded compactly
+ */
+bool AP_Logger::Write_Compact_add(log_compact_state &s, const uint8_t *record)
+{
+    const uint8_t space = sizeof(s.pkt.data) - s.pkt.length;
+    uint8_t len = compact_encode(s.f->fmt, record, s.prev, &s.pkt.data[s.pkt.length], space);
+    if (len == 0 && s.pkt.count > 0) {
+        Write_Compact_flush(s);
+        len = compact_encode(s.f->fmt, record, s.prev, s.pkt.data, sizeof(s.pkt.data));
+    }
+    if (len == 0) {
+        return false;
+    }
+    if (s.pkt.count == 0) {
+        s.start_ms = AP_HAL::millis();
+    }
+    s.pkt.length += len;
+    s.pkt.count++;
+    memcpy(s.prev, record, s.f->msg_len);
+    if (s.pkt.count == UINT8_MAX) {
+        Write_Compact_flush(s);
+    }
+    return true;
+}
+
+// write out the pending CMPT message and reset the delta state
+void AP_Logger::Write_Compact_flush(log_compact_state &s)
+{
+    if (s.pkt.count > 0) {
+        // decoders need the FMT of the records held
+        Safe_Write_Emit_FMT(s.f);
+        memset(&s.pkt.data[s.pkt.length], 0, sizeof(s.pkt.data) - s.pkt.length);
+        WritePrioritisedBlock(&s.pkt, sizeof(s.pkt), false);
+    }
+    s.pkt.count = 0;
+    s.pkt.length = 0;
+    memset(s.prev, 0, s.f->msg_len);
+}
+
+// flush CMPT messages which have been pending for too long
+void AP_Logger::Write_Compact_flush_old()
+{
+    if (log_compact_states == nullptr) {
+        return;
+    }
+    WITH_SEMAPHORE(log_compact_sem);
+    const uint32_t now_ms = AP_HAL::millis();
+    for (log_compact_state *s = log_compact_states; s; s=s->next) {
+        if (s->pkt.count > 0 && now_ms - s->start_ms > LOG_COMPACT_FLUSH_MS) {
+            Write_Compact_flush(*s);
+        }
+    }
+}
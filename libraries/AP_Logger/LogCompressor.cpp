@@ -0,0 +1,127 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogCompressor.h"
+
+#include <string.h>
+
+// constraints from the LZ4 block format
+#define LZ4_MIN_MATCH     4  // minimum match length
+#define LZ4_LAST_LITERALS 5  // last bytes of a block are always literals
+#define LZ4_MF_LIMIT      12 // last match must start this far from the end
+#define LZ4_MAX_OFFSET    65535
+
+// length as stored in a token nibble, 15 means extension bytes follow
+static uint8_t token_nibble(uint16_t len)
+{
+    return len < 15 ? len : 15;
+}
+
+uint32_t LogCompressor::read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// write the extension bytes of a literal or match length
+bool LogCompressor::write_length(uint8_t *&op, const uint8_t *oend, uint16_t len)
+{
+    while (len >= 255) {
+        if (op >= oend) {
+            return false;
+        }
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= oend) {
+        return false;
+    }
+    *op++ = len;
+    return true;
+}
+
+uint16_t LogCompressor::compress(const uint8_t *in, uint16_t in_len, uint8_t *out, uint16_t out_space)
+{
+    uint8_t *op = out;
+    const uint8_t *oend = out + out_space;
+    uint16_t anchor = 0;
+
+    if (in_len > LZ4_MF_LIMIT) {
+        memset(table, 0, sizeof(table));
+        const uint16_t match_limit = in_len - LZ4_LAST_LITERALS;
+        uint16_t ip = 0;
+
+        while (ip + LZ4_MF_LIMIT < in_len) {
+            const uint32_t seq = read32(&in[ip]);
+            const uint32_t h = hash(seq);
+            const uint16_t ref = table[h];
+            table[h] = ip;
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || read32(&in[ref]) != seq) {
+                ip++;
+                continue;
+            }
+
+            // extend the match forward
+            uint16_t match_len = LZ4_MIN_MATCH;
+            while (ip + match_len < match_limit && in[ref + match_len] == in[ip + match_len]) {
+                match_len++;
+            }
+
+            // token, literals, offset then match length
+            const uint16_t lit_len = ip - anchor;
+            const uint16_t ml = match_len - LZ4_MIN_MATCH;
+            if (op + 1 + lit_len + 2 > oend) {
+                return 0;
+            }
+            uint8_t *token = op++;
+            *token = (token_nibble(lit_len) << 4) | token_nibble(ml);
+            if (lit_len >= 15 && !write_length(op, oend, lit_len - 15)) {
+                return 0;
+            }
+            if (op + lit_len + 2 > oend) {
+                return 0;
+            }
+            memcpy(op, &in[anchor], lit_len);
+            op += lit_len;
+            const uint16_t offset = ip - ref;
+            *op++ = offset & 0xFF;
+            *op++ = offset >> 8;
+            if (ml >= 15 && !write_length(op, oend, ml - 15)) {
+                return 0;
+            }
+
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+
+    // the rest of the block is literals
+    const uint16_t lit_len = in_len - anchor;
+    if (op >= oend) {
+        return 0;
+    }
+    *op++ = token_nibble(lit_len) << 4;
+    if (lit_len >= 15 && !write_length(op, oend, lit_len - 15)) {
+        return 0;
+    }
+    if (op + lit_len > oend) {
+        return 0;
+    }
+    memcpy(op, &in[anchor], lit_len);
+    op += lit_len;
+
+    return op - out;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+  lightweight LZ4 block format compressor used for compressed log
+  download over MAVLink. Only compression is done on the vehicle, the
+  output can be decoded by any LZ4 block decoder
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOG_COMPRESS_HASH_BITS 9
+
+class LogCompressor {
+public:
+    /*
+      compress in_len bytes from in into out, which has out_space
+      bytes available. Returns the number of bytes written, or 0 if the
+      data could not be compressed into the space available, in which
+      case the caller should send the data uncompressed
+     */
+    uint16_t compress(const uint8_t *in, uint16_t in_len, uint8_t *out, uint16_t out_space);
+
+    // worst case size of compressed output for in_len bytes of input
+    static constexpr uint16_t max_compressed_size(uint16_t in_len) {
+        return in_len + in_len/255 + 16;
+    }
+
+private:
+    // positions in the input block of recently seen 4 byte sequences
+    uint16_t table[1U<<LOG_COMPRESS_HASH_BITS];
+
+    static uint32_t hash(uint32_t v) {
+        return (v * 2654435761U) >> (32 - LOG_COMPRESS_HASH_BITS);
+    }
+    static uint32_t read32(const uint8_t *p);
+    static bool write_length(uint8_t *&op, const uint8_t *oend, uint16_t len);
+};
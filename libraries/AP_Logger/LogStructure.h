@@ -202,6 +202,13 @@ struct PACKED log_DSF {
     uint32_t buf_space_min;
     uint32_t buf_space_max;
     uint32_t buf_space_avg;
+    uint16_t fill_hist0;
+    uint16_t fill_hist1;
+    uint16_t fill_hist2;
+    uint16_t fill_hist3;
+    uint32_t write_time_max;
+    uint32_t write_time_avg;
+    uint8_t throttle_level;
 };
 
 struct PACKED log_Event {
@@ -444,6 +451,8 @@ struct PACKED log_TERRAIN {
     float current_height;
     uint16_t pending;
     uint16_t loaded;
+    uint32_t cache_hits;
+    uint32_t cache_misses;
 };
 
 struct PACKED log_CSRV {
@@ -471,6 +480,16 @@ struct PACKED log_ARSP {
     uint8_t primary;
 };
 
+// container for delta encoded records written with WriteCompact()
+#define LOG_COMPACT_DATA_LEN 192
+struct PACKED log_Compact {
+    LOG_PACKET_HEADER;
+    uint8_t msg_type;
+    uint8_t count;
+    uint8_t length;
+    uint8_t data[LOG_COMPACT_DATA_LEN];
+};
+
 struct PACKED log_MAV_Stats {
     LOG_PACKET_HEADER;
     uint64_t timestamp;
@@ -623,6 +642,8 @@ struct PACKED log_Performance {
     uint32_t i2c_count;
     uint32_t i2c_isr_count;
     uint32_t extra_loop_us;
+    uint32_t log_writes_contended;
+    uint32_t log_writes_uncontended;
 };
 
 struct PACKED log_SRTL {
@@ -818,6 +839,13 @@ struct PACKED log_PSCZ {
 // @Field: FMn: Minimum free space in write buffer in last time period
 // @Field: FMx: Maximum free space in write buffer in last time period
 // @Field: FAv: Average free space in write buffer in last time period
+// @Field: H1: Number of writes to the buffer while it was less than 50% full
+// @Field: H2: Number of writes to the buffer while it was 50% to 75% full
+// @Field: H3: Number of writes to the buffer while it was 75% to 90% full
+// @Field: H4: Number of writes to the buffer while it was more than 90% full
+// @Field: WMx: Longest write to the storage device in last time period
+// @Field: WAv: Average time of a write to the storage device in last time period
+// @Field: Thr: Adaptive throttling level, high rate messages are decimated by 2^Thr
 
 // @LoggerMessage: DSTL
 // @Description: Deepstall Landing data
@@ -893,7 +921,7 @@ struct PACKED log_PSCZ {
 // @Field: rxp: received packet count
 // @Field: rxdp: perceived number of packets we never received
 // @Field: flags: compact representation of some stage of the channel
-// @Field: ss: stream slowdown is the number of ms being added to each message to fit within bandwidth
+// @Field: ss: stream slowdown is the estimated number of ms until the link send budget recovers
 // @Field: tf: times buffer was full when a message was going to be sent
 
 // @LoggerMessage: MAVC
@@ -991,6 +1019,8 @@ struct PACKED log_PSCZ {
 // @Field: I2CC: Number of i2c transactions processed
 // @Field: I2CI: Number of i2c interrupts serviced
 // @Field: Ex: number of microseconds being added to each loop to address scheduler overruns
+// @Field: LgC: number of log writes which had to wait for the logger backend lock
+// @Field: LgU: number of log writes which did not have to wait for a lock
 
 // @LoggerMessage: POWR
 // @Description: System power information
@@ -1142,12 +1172,16 @@ struct PACKED log_PSCZ {
 // @Field: CHeight: Vehicle height above terrain
 // @Field: Pending: Number of tile requests outstanding
 // @Field: Loaded: Number of tiles in memory
+// @Field: CHit: Number of height lookups served from a tile in memory
+// @Field: CMiss: Number of height lookups which had to wait for a tile to be read from disk
 
 // @LoggerMessage: TSYN
 // @Description: Time synchronisation response information
 // @Field: TimeUS: Time since system startup
 // @Field: SysID: system ID this data is for
 // @Field: RTT: round trip time for this system
+// @Field: Off: local time minus the time of this system, if it is the system whose timestamps are being corrected
+// @Field: Drift: rate of change of Off in parts per million
 
 // @LoggerMessage: UNIT
 // @Description: Message mapping from single character to SI unit
@@ -1207,6 +1241,15 @@ struct PACKED log_PSCZ {
 // @Field: AZ: Acceleration Z-axis
 // @Field: ThO: Throttle output
 
+// @LoggerMessage: CMPT
+// @Description: Compact records. Holds records of another message type, each field delta encoded against the previous record in this message and stored as a variable length integer. Integers are stored as zigzag encoded differences and floats as the XOR of their bit patterns; byte array fields are stored as they are. The first record is encoded against zero
+// @Field: Type: message type of the records held
+// @Field: Cnt: number of records held
+// @Field: Len: number of bytes of Data used
+// @Field: D0: encoded records
+// @Field: D1: encoded records, continued
+// @Field: D2: encoded records, continued
+
 // messages for all boards
 #define LOG_BASE_STRUCTURES \
     { LOG_FORMAT_MSG, sizeof(log_Format), \
@@ -1258,14 +1301,14 @@ LOG_STRUCTURE_FROM_CAMERA \
     { LOG_RAW_PROXIMITY_MSG, sizeof(log_Proximity_raw), \
       "PRXR", "QBffffffff", "TimeUS,Layer,D0,D45,D90,D135,D180,D225,D270,D315", "s#mmmmmmmm", "F-00000000" }, \
     { LOG_PERFORMANCE_MSG, sizeof(log_Performance),                     \
-      "PM",  "QHHIIHHIIIIII", "TimeUS,NLon,NLoop,MaxT,Mem,Load,ErrL,IntE,ErrC,SPIC,I2CC,I2CI,Ex", "s---b%------s", "F---0A------F" }, \
+      "PM",  "QHHIIHHIIIIIIII", "TimeUS,NLon,NLoop,MaxT,Mem,Load,ErrL,IntE,ErrC,SPIC,I2CC,I2CI,Ex,LgC,LgU", "s---b%------s--", "F---0A------F--" }, \
     { LOG_SRTL_MSG, sizeof(log_SRTL), \
       "SRTL", "QBHHBfff", "TimeUS,Active,NumPts,MaxPts,Action,N,E,D", "s----mmm", "F----000" }, \
 LOG_STRUCTURE_FROM_AVOIDANCE \
     { LOG_SIMSTATE_MSG, sizeof(log_AHRS), \
       "SIM","QccCfLLffff","TimeUS,Roll,Pitch,Yaw,Alt,Lat,Lng,Q1,Q2,Q3,Q4", "sddhmDU????", "FBBB0GG????" }, \
     { LOG_TERRAIN_MSG, sizeof(log_TERRAIN), \
-      "TERR","QBLLHffHH","TimeUS,Status,Lat,Lng,Spacing,TerrH,CHeight,Pending,Loaded", "s-DU-mm--", "F-GG-00--" }, \
+      "TERR","QBLLHffHHII","TimeUS,Status,Lat,Lng,Spacing,TerrH,CHeight,Pending,Loaded,CHit,CMiss", "s-DU-mm----", "F-GG-00----" }, \
 LOG_STRUCTURE_FROM_ESC_TELEM \
     { LOG_CSRV_MSG, sizeof(log_CSRV), \
       "CSRV","QBfffB","TimeUS,Id,Pos,Force,Speed,Pow", "s#---%", "F-0000" }, \
@@ -1292,7 +1335,7 @@ LOG_STRUCTURE_FROM_NAVEKF3 \
 LOG_STRUCTURE_FROM_NAVEKF \
 LOG_STRUCTURE_FROM_AHRS \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
-      "DSF", "QIHIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv", "s--b---", "F--0---" }, \
+      "DSF", "QIHIIIIHHHHIIB", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv,H1,H2,H3,H4,WMx,WAv,Thr", "s--b-------ss-", "F--0-------FF-" }, \
     { LOG_RPM_MSG, sizeof(log_RPM), \
       "RPM",  "Qff", "TimeUS,rpm1,rpm2", "sqq", "F00" }, \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
@@ -1317,7 +1360,9 @@ LOG_STRUCTURE_FROM_VISUALODOM \
     { LOG_PSC_MSG, sizeof(log_PSC), \
       "PSC", "Qffffffffffff", "TimeUS,TPX,TPY,PX,PY,TVX,TVY,VX,VY,TAX,TAY,AX,AY", "smmmmnnnnoooo", "F000000000000" }, \
     { LOG_PSCZ_MSG, sizeof(log_PSCZ), \
-      "PSCZ", "Qfffffffff", "TimeUS,TPZ,PZ,DVZ,TVZ,VZ,DAZ,TAZ,AZ,ThO", "smmnnnooo%", "F000000002" }
+      "PSCZ", "Qfffffffff", "TimeUS,TPZ,PZ,DVZ,TVZ,VZ,DAZ,TAZ,AZ,ThO", "smmnnnooo%", "F000000002" }, \
+    { LOG_COMPACT_MSG, sizeof(log_Compact), \
+      "CMPT", "BBBZZZ", "Type,Cnt,Len,D0,D1,D2", "------", "------" }
 
 // @LoggerMessage: SBPH
 // @Description: Swift Health Data
@@ -1431,6 +1476,7 @@ enum LogMessages : uint8_t {
     LOG_PSCZ_MSG,
     LOG_RAW_PROXIMITY_MSG,
     LOG_IDS_FROM_PRECLAND,
+    LOG_COMPACT_MSG,
 
     _LOG_LAST_MSG_
 };
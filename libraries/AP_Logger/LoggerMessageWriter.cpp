@@ -1,4 +1,5 @@
 #include "AP_Common/AP_FWVersion.h"
+#include <AP_Common/MemoryTag.h>
 #include "LoggerMessageWriter.h"
 #include <AP_Scheduler/AP_Scheduler.h>
 
@@ -203,6 +204,7 @@ void LoggerMessageWriter_WriteSysInfo::reset()
 {
     LoggerMessageWriter::reset();
     stage = Stage::FIRMWARE_STRING;
+    next_memory_tag = 1;
 }
 
 void LoggerMessageWriter_WriteSysInfo::process() {
@@ -253,7 +255,7 @@ void LoggerMessageWriter_WriteSysInfo::process() {
         stage = Stage::RC_PROTOCOL;
         FALLTHROUGH;
 
-    case Stage::RC_PROTOCOL:
+    case Stage::RC_PROTOCOL: {
         const char *prot = hal.rcin->protocol();
         if (prot == nullptr) {
             prot = "None";
@@ -261,6 +263,21 @@ void LoggerMessageWriter_WriteSysInfo::process() {
         if (! _logger_backend->Write_MessageF("RC Protocol: %s", prot)) {
             return; // call me again
         }
+        stage = Stage::MEMORY_TAGS;
+        FALLTHROUGH;
+    }
+
+    case Stage::MEMORY_TAGS:
+        // memory used by each subsystem that has any
+        while (next_memory_tag < uint8_t(MemoryTag::NUM_TAGS)) {
+            const MemoryTag tag = MemoryTag(next_memory_tag);
+            const uint32_t bytes = MemoryTags::allocated(tag);
+            if (bytes != 0 &&
+                ! _logger_backend->Write_MessageF("Mem %s: %u", MemoryTags::name(tag), unsigned(bytes))) {
+                return; // call me again
+            }
+            next_memory_tag++;
+        }
     }
 
     _finished = true;  // all done!
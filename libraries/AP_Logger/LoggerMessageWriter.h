@@ -33,9 +33,11 @@ private:
         GIT_VERSIONS,
         SYSTEM_ID,
         PARAM_SPACE_USED,
-        RC_PROTOCOL
+        RC_PROTOCOL,
+        MEMORY_TAGS
     };
     Stage stage;
+    uint8_t next_memory_tag;
 };
 
 class LoggerMessageWriter_WriteEntireMission : public LoggerMessageWriter {
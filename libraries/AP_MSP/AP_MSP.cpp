@@ -157,41 +157,69 @@ void AP_MSP::init_osd()
     _msp_status.osd_initialized = true;
 }
 
+void AP_MSP::update_status(uint32_t now)
+{
+    // toggle flashing every 0.7 seconds
+    if (((now / 700) & 0x01) != _msp_status.flashing_on) {
+        _msp_status.flashing_on = !_msp_status.flashing_on;
+    }
+
+    // detect flight mode changes and steal focus from text messages
+    if (AP::notify().flags.flight_mode != _msp_status.last_flight_mode) {
+        _msp_status.flight_mode_focus = true;
+        _msp_status.last_flight_mode = AP::notify().flags.flight_mode;
+        _msp_status.last_flight_mode_change_ms = AP_HAL::millis();
+    } else if (now - _msp_status.last_flight_mode_change_ms > OSD_FLIGHT_MODE_FOCUS_TIME) {
+        _msp_status.flight_mode_focus = false;
+    }
+}
+
+/*
+  the thread wakes as soon as a request arrives on any MSP UART so it
+  can be answered straight away. OSD state and pushed telemetry are
+  updated at 100Hz. On HALs without UART events we poll at 100Hz
+ */
 void AP_MSP::loop(void)
 {
+    bool have_events = false;
     for (uint8_t i=0; i<_msp_status.backend_count; i++) {
         // one time uart init
-        if (_backends[i] != nullptr)  {
-            _backends[i]->init_uart();
+        if (_backends[i] != nullptr && _backends[i]->init_uart()) {
+            if (_backends[i]->get_uart()->set_event_handle(&_rx_event)) {
+                have_events = true;
+            }
         }
     }
 
     while (true) {
-        hal.scheduler->delay(10); // 115200 baud, 18 MSP packets @4Hz, 100Hz should be OK
-
-        const uint32_t now = AP_HAL::millis();
-        // toggle flashing every 0.7 seconds
-        if (((now / 700) & 0x01) != _msp_status.flashing_on) {
-            _msp_status.flashing_on = !_msp_status.flashing_on;
+        uint32_t now = AP_HAL::millis();
+        if (have_events) {
+            const uint32_t wait_ms = 10 - MIN(now - _msp_status.last_update_ms, 10U);
+            _rx_event.wait(wait_ms * 1000U);
+            now = AP_HAL::millis();
+        } else {
+            hal.scheduler->delay(10); // 115200 baud, 18 MSP packets @4Hz, 100Hz should be OK
+            now = AP_HAL::millis();
         }
 
-        // detect flight mode changes and steal focus from text messages
-        if (AP::notify().flags.flight_mode != _msp_status.last_flight_mode) {
-            _msp_status.flight_mode_focus = true;
-            _msp_status.last_flight_mode = AP::notify().flags.flight_mode;
-            _msp_status.last_flight_mode_change_ms = AP_HAL::millis();
-        } else if (now - _msp_status.last_flight_mode_change_ms > OSD_FLIGHT_MODE_FOCUS_TIME) {
-            _msp_status.flight_mode_focus = false;
+        const bool do_update = now - _msp_status.last_update_ms >= 10;
+        if (do_update) {
+            _msp_status.last_update_ms = now;
+            update_status(now);
         }
 
         for (uint8_t i=0; i< _msp_status.backend_count; i++) {
             if (_backends[i] != nullptr) {
-                // dynamically hide/unhide
-                _backends[i]->hide_osd_items();
+                if (do_update) {
+                    // dynamically hide/unhide
+                    _backends[i]->hide_osd_items();
+                }
                 // process incoming MSP frames (and reply if needed)
                 _backends[i]->process_incoming_data();
-                // push outgoing telemetry frames
-                _backends[i]->process_outgoing_data();
+                if (do_update) {
+                    // push outgoing telemetry frames
+                    _backends[i]->process_outgoing_data();
+                }
             }
         }
     }
@@ -77,11 +77,16 @@ private:
         bool flight_mode_focus;                                 // do we need to steal focus from text messages
         bool osd_initialized;                                   // for one time osd initialization
         uint8_t backend_count;                                  // actual count of active bacends
+        uint32_t last_update_ms;                                // last run of the periodic OSD and telemetry update
     } _msp_status;
 
+    // signalled when any MSP UART receives data
+    HAL_EventHandle _rx_event;
+
     bool init_backend(uint8_t backend_idx, AP_HAL::UARTDriver *uart, AP_SerialManager::SerialProtocol protocol);
     void init_osd();
     void loop(void);
+    void update_status(uint32_t now);
     bool check_option(const msp_option_e option);
 
     static AP_MSP *_singleton;
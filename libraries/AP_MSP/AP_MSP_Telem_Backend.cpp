@@ -160,14 +160,10 @@ uint8_t AP_MSP_Telem_Backend::calc_cell_count(const float battery_voltage)
 
 float AP_MSP_Telem_Backend::get_vspeed_ms(void)
 {
-    {
-        // release semaphore as soon as possible
-        AP_AHRS &_ahrs = AP::ahrs();
-        Vector3f v {};
-        WITH_SEMAPHORE(_ahrs.get_semaphore());
-        if (_ahrs.get_velocity_NED(v)) {
-            return -v.z;
-        }
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
+    if (nav.have_velocity) {
+        return -nav.velocity_NED.z;
     }
     AP_Baro &_baro = AP::baro();
     WITH_SEMAPHORE(_baro.get_semaphore());
@@ -176,21 +172,17 @@ float AP_MSP_Telem_Backend::get_vspeed_ms(void)
 
 void AP_MSP_Telem_Backend::update_home_pos(home_state_t &home_state)
 {
-    AP_AHRS &_ahrs = AP::ahrs();
-    WITH_SEMAPHORE(_ahrs.get_semaphore());
-    Location loc;
-    float alt;
-    if (_ahrs.get_position(loc) && _ahrs.home_is_set()) {
-        const Location &home_loc = _ahrs.get_home();
-        home_state.home_distance_m = home_loc.get_distance(loc);
-        home_state.home_bearing_cd = loc.get_bearing_to(home_loc);
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
+    if (nav.have_position && nav.home_is_set) {
+        home_state.home_distance_m = nav.home.get_distance(nav.loc);
+        home_state.home_bearing_cd = nav.loc.get_bearing_to(nav.home);
     } else {
         home_state.home_distance_m = 0;
         home_state.home_bearing_cd = 0;
     }
-    _ahrs.get_relative_position_D_home(alt);
-    home_state.rel_altitude_cm = -alt * 100;
-    home_state.home_is_set = _ahrs.home_is_set();
+    home_state.rel_altitude_cm = -nav.relative_alt_D * 100;
+    home_state.home_is_set = nav.home_is_set;
 }
 
 void AP_MSP_Telem_Backend::update_gps_state(gps_state_t &gps_state)
@@ -797,8 +789,8 @@ MSPCommandResult AP_MSP_Telem_Backend::msp_process_out_osd_config(sbuf_t *dst)
 
 MSPCommandResult AP_MSP_Telem_Backend::msp_process_out_attitude(sbuf_t *dst)
 {
-    AP_AHRS &ahrs = AP::ahrs();
-    WITH_SEMAPHORE(ahrs.get_semaphore());
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
 
     struct PACKED {
         int16_t roll;
@@ -806,9 +798,9 @@ MSPCommandResult AP_MSP_Telem_Backend::msp_process_out_attitude(sbuf_t *dst)
         int16_t yaw;
     } attitude;
 
-    attitude.roll = ahrs.roll_sensor * 0.1;     // centidegress to decidegrees
-    attitude.pitch = ahrs.pitch_sensor * 0.1;   // centidegress to decidegrees
-    attitude.yaw = ahrs.yaw_sensor * 0.01;      // centidegress to degrees
+    attitude.roll = nav.roll_sensor * 0.1;     // centidegress to decidegrees
+    attitude.pitch = nav.pitch_sensor * 0.1;   // centidegress to decidegrees
+    attitude.yaw = nav.yaw_sensor * 0.01;      // centidegress to degrees
 
     sbuf_write_data(dst, &attitude, sizeof(attitude));
     return MSP_RESULT_ACK;
@@ -70,6 +70,7 @@ public:
     // init - perform required initialisation
     virtual bool init() override;
     virtual bool init_uart();
+    AP_HAL::UARTDriver *get_uart() const { return _msp_port.uart; }
     virtual void enable_warnings();
     virtual void hide_osd_items(void);
 
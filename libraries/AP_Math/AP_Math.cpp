@@ -418,6 +418,14 @@ void fill_nanf(float *f, uint16_t count)
         *f++ = n;
     }
 }
+
+void fill_nanf(double *f, uint16_t count)
+{
+    const double n = std::numeric_limits<double>::signaling_NaN();
+    while (count--) {
+        *f++ = n;
+    }
+}
 #endif
 
 // Convert 16-bit fixed-point to float
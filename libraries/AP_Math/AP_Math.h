@@ -298,6 +298,7 @@ float calc_lowpass_alpha_dt(float dt, float cutoff_freq);
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 // fill an array of float with NaN, used to invalidate memory in SITL
 void fill_nanf(float *f, uint16_t count);
+void fill_nanf(double *f, uint16_t count);
 #endif
 
 // from https://embeddedartistry.com/blog/2018/07/12/simple-fixed-point-conversion-in-c/
@@ -46,6 +46,7 @@ void SCurve::init()
     vel_max = 0.0f;
     time = 0.0f;
     num_segs = SEG_INIT;
+    seg_last = SEG_INIT;
     add_segment(num_segs, 0.0f, SegmentType::CONSTANT_JERK, 0.0f, 0.0f, 0.0f, 0.0f);
     track.zero();
     delta_unit.zero();
@@ -606,15 +607,9 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
     }
 
     SegmentType Jtype;
-    uint8_t pnt = num_segs;
+    const uint8_t pnt = get_segment_at_time(time_now);
     float Jm, T0, A0, V0, P0;
 
-    // find active segment at time_now
-    for (uint8_t i = 0; i < num_segs; i++) {
-        if (time_now < segment[num_segs - 1 - i].end_time) {
-            pnt = num_segs - 1 - i;
-        }
-    }
     if (pnt == 0) {
         Jtype = SegmentType::CONSTANT_JERK;
         Jm = 0.0f;
@@ -652,6 +647,22 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
     Pt_out = MAX(0.0f, Pt_out);
 }
 
+// return the index of the first segment ending after time_now, or num_segs if time_now is past the end
+// segment end times never decrease, and time usually moves by less than a segment between calls,
+// so the search starts from the segment found last time
+uint8_t SCurve::get_segment_at_time(float time_now) const
+{
+    uint8_t pnt = MIN(seg_last, num_segs);
+    while (pnt < num_segs && time_now >= segment[pnt].end_time) {
+        pnt++;
+    }
+    while (pnt > 0 && time_now < segment[pnt - 1].end_time) {
+        pnt--;
+    }
+    seg_last = pnt;
+    return pnt;
+}
+
 // calculate the jerk, acceleration, velocity and position at time time_now when running the constant jerk time segment
 void SCurve::calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
 {
@@ -123,6 +123,9 @@ private:
     // calculate the jerk, acceleration, velocity and position at time t
     void get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float &At_out, float &Vt_out, float &Pt_out) const;
 
+    // return the index of the first segment ending after time_now, or num_segs if time_now is past the end
+    uint8_t get_segment_at_time(float time_now) const;
+
     // calculate the jerk, acceleration, velocity and position at time t when running the constant jerk time segment
     void calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
 
@@ -197,6 +200,7 @@ private:
     const static uint8_t segments_max = 23; // maximum number of time segments
 
     uint8_t num_segs;       // number of time segments being used
+    mutable uint8_t seg_last;   // segment found by the last time lookup, where the next lookup starts searching
     struct {
         float jerk_ref;     // jerk reference value for time segment (the jerk at the beginning, middle or end depending upon the segment type)
         SegmentType seg_type;   // segment type (jerk is constant, increasing or decreasing)
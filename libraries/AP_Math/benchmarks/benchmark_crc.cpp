@@ -0,0 +1,71 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+
+static uint8_t buf[4096];
+
+static void fill_buf(void)
+{
+    for (uint16_t i=0; i<sizeof(buf); i++) {
+        buf[i] = i * 7 + 3;
+    }
+}
+
+static void BM_crc32(benchmark::State& state)
+{
+    fill_buf();
+    const uint32_t len = state.range_x();
+    while (state.KeepRunning()) {
+        uint32_t crc = crc_crc32(0, buf, len);
+        gbenchmark_escape(&crc);
+    }
+}
+
+static void BM_crc16_ccitt(benchmark::State& state)
+{
+    fill_buf();
+    const uint32_t len = state.range_x();
+    while (state.KeepRunning()) {
+        uint16_t crc = crc16_ccitt(buf, len, 0);
+        gbenchmark_escape(&crc);
+    }
+}
+
+static void BM_crc16_mcrf4xx(benchmark::State& state)
+{
+    fill_buf();
+    const uint32_t len = state.range_x();
+    while (state.KeepRunning()) {
+        uint16_t crc = crc16_mcrf4xx(0xFFFF, buf, len);
+        gbenchmark_escape(&crc);
+    }
+}
+
+static void BM_crc8_dvb_s2(benchmark::State& state)
+{
+    fill_buf();
+    const uint32_t len = state.range_x();
+    while (state.KeepRunning()) {
+        uint8_t crc = crc8_dvb_s2_update(0, buf, len);
+        gbenchmark_escape(&crc);
+    }
+}
+
+static void BM_crc24(benchmark::State& state)
+{
+    fill_buf();
+    const uint16_t len = state.range_x();
+    while (state.KeepRunning()) {
+        uint32_t crc = crc_crc24(buf, len);
+        gbenchmark_escape(&crc);
+    }
+}
+
+BENCHMARK(BM_crc32)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_crc16_ccitt)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_crc16_mcrf4xx)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_crc8_dvb_s2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(BM_crc24)->Arg(16)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
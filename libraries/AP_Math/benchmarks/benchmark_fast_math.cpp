@@ -0,0 +1,94 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/fast_math.h>
+
+static float angles[256];
+
+static void fill_angles(void)
+{
+    for (uint16_t i=0; i<ARRAY_SIZE(angles); i++) {
+        angles[i] = (i - 128) * 0.0491f;
+    }
+}
+
+static void BM_sinf(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (float a : angles) {
+            float v = sinf(a);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+template <FastMathAccuracy A>
+static void BM_fast_sinf(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (float a : angles) {
+            float v = fast_sinf<A>(a);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+static void BM_atan2f(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (uint16_t i=1; i<ARRAY_SIZE(angles); i++) {
+            float v = atan2f(angles[i], angles[i-1]);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+template <FastMathAccuracy A>
+static void BM_fast_atan2f(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (uint16_t i=1; i<ARRAY_SIZE(angles); i++) {
+            float v = fast_atan2f<A>(angles[i], angles[i-1]);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+static void BM_inv_sqrtf(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (float a : angles) {
+            float v = 1.0f / sqrtf(fabsf(a) + 1);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+template <FastMathAccuracy A>
+static void BM_fast_inv_sqrtf(benchmark::State& state)
+{
+    fill_angles();
+    while (state.KeepRunning()) {
+        for (float a : angles) {
+            float v = fast_inv_sqrtf<A>(fabsf(a) + 1);
+            gbenchmark_escape(&v);
+        }
+    }
+}
+
+BENCHMARK(BM_sinf);
+BENCHMARK_TEMPLATE(BM_fast_sinf, FastMathAccuracy::LOW);
+BENCHMARK_TEMPLATE(BM_fast_sinf, FastMathAccuracy::HIGH);
+BENCHMARK(BM_atan2f);
+BENCHMARK_TEMPLATE(BM_fast_atan2f, FastMathAccuracy::LOW);
+BENCHMARK_TEMPLATE(BM_fast_atan2f, FastMathAccuracy::HIGH);
+BENCHMARK(BM_inv_sqrtf);
+BENCHMARK_TEMPLATE(BM_fast_inv_sqrtf, FastMathAccuracy::LOW);
+BENCHMARK_TEMPLATE(BM_fast_inv_sqrtf, FastMathAccuracy::HIGH);
+
+BENCHMARK_MAIN()
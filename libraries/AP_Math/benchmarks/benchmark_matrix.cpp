@@ -1,6 +1,7 @@
 #include <AP_gbenchmark.h>
 
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
 
 static void BM_MatrixMultiplication(benchmark::State& state)
 {
@@ -19,4 +20,79 @@ static void BM_MatrixMultiplication(benchmark::State& state)
 
 BENCHMARK(BM_MatrixMultiplication);
 
+static void BM_MatrixNOuterProduct(benchmark::State& state)
+{
+    const float a[4] {1.0f, 2.0f, 3.0f, 4.0f};
+    const VectorN<float,4> v1(a), v2(a);
+    MatrixN<float,4> m;
+
+    while (state.KeepRunning()) {
+        m.mult(v1, v2);
+        gbenchmark_escape(&m);
+    }
+}
+
+BENCHMARK(BM_MatrixNOuterProduct);
+
+static void BM_MatrixNForceSymmetry(benchmark::State& state)
+{
+    const float a[4] {1.0f, 2.0f, 3.0f, 4.0f};
+    const float b[4] {4.0f, 3.0f, 2.0f, 1.0f};
+    MatrixN<float,4> m;
+    m.mult(VectorN<float,4>(a), VectorN<float,4>(b));
+
+    while (state.KeepRunning()) {
+        m.force_symmetry();
+        gbenchmark_escape(&m);
+    }
+}
+
+BENCHMARK(BM_MatrixNForceSymmetry);
+
+static void BM_VectorNMatrixMultiplication(benchmark::State& state)
+{
+    const float a[4] {1.0f, 2.0f, 3.0f, 4.0f};
+    const VectorN<float,4> v1(a);
+    MatrixN<float,4> m;
+    m.mult(v1, v1);
+    VectorN<float,4> v2;
+
+    while (state.KeepRunning()) {
+        v2.mult(m, v1);
+        gbenchmark_escape(&v2);
+    }
+}
+
+BENCHMARK(BM_VectorNMatrixMultiplication);
+
+static void BM_VectorNDotProduct(benchmark::State& state)
+{
+    float a[24];
+    for (uint8_t i=0; i<24; i++) {
+        a[i] = i * 0.5f;
+    }
+    const VectorN<float,24> v1(a), v2(a);
+
+    while (state.KeepRunning()) {
+        float d = v1 * v2;
+        gbenchmark_escape(&d);
+    }
+}
+
+BENCHMARK(BM_VectorNDotProduct);
+
+static void BM_Vector3Rotate(benchmark::State& state)
+{
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        for (uint8_t r = 0; r < ROTATION_MAX; r++) {
+            v.rotate(Rotation(r));
+        }
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_Vector3Rotate);
+
 BENCHMARK_MAIN();
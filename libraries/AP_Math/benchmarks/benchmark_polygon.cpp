@@ -0,0 +1,67 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+/*
+  a closed polygon fence with the given number of points on a wobbly
+  circle, so edges aren't all the same length
+ */
+#define MAX_POINTS 256
+
+static Vector2f polygon[MAX_POINTS+1];
+
+static void setup_polygon(unsigned n)
+{
+    for (unsigned i = 0; i < n; i++) {
+        const float a = 2 * M_PI * i / n;
+        const float r = 100 + 20 * sinf(5 * a);
+        polygon[i] = Vector2f(r * cosf(a), r * sinf(a));
+    }
+    polygon[n] = polygon[0];
+}
+
+static void BM_PolygonOutside(benchmark::State& state)
+{
+    const unsigned n = state.range_x();
+    setup_polygon(n);
+    const Vector2f p(30, -40);
+
+    while (state.KeepRunning()) {
+        bool outside = Polygon_outside(p, polygon, n+1);
+        gbenchmark_escape(&outside);
+    }
+}
+
+BENCHMARK(BM_PolygonOutside)->Arg(8)->Arg(32)->Arg(MAX_POINTS);
+
+static void BM_PolygonIntersects(benchmark::State& state)
+{
+    const unsigned n = state.range_x();
+    setup_polygon(n);
+    const Vector2f p1(0, 0);
+    const Vector2f p2(200, 150);
+    Vector2f intersection;
+
+    while (state.KeepRunning()) {
+        bool intersects = Polygon_intersects(polygon, n+1, p1, p2, intersection);
+        gbenchmark_escape(&intersects);
+    }
+}
+
+BENCHMARK(BM_PolygonIntersects)->Arg(8)->Arg(32)->Arg(MAX_POINTS);
+
+static void BM_PolygonClosestDistancePoint(benchmark::State& state)
+{
+    const unsigned n = state.range_x();
+    setup_polygon(n);
+    const Vector2f p(30, -40);
+
+    while (state.KeepRunning()) {
+        float distance = Polygon_closest_distance_point(polygon, n+1, p);
+        gbenchmark_escape(&distance);
+    }
+}
+
+BENCHMARK(BM_PolygonClosestDistancePoint)->Arg(8)->Arg(32)->Arg(MAX_POINTS);
+
+BENCHMARK_MAIN();
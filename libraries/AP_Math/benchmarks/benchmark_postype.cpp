@@ -0,0 +1,69 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+/*
+  cost of the position types used by the position controllers relative
+  to plain float. Run on boards without double precision FPU support
+  to see what enabling HAL_WITH_POSTYPE_DOUBLE costs there
+ */
+
+static void BM_Vector2fPosUpdate(benchmark::State& state)
+{
+    Vector2f pos{1.0e7f, -2.0e7f};
+    const Vector2f vel{1234.5f, -543.2f};
+    const float dt = 0.0025f;
+
+    while (state.KeepRunning()) {
+        pos += vel * dt;
+        gbenchmark_escape(&pos);
+    }
+}
+
+static void BM_Vector2pPosUpdate(benchmark::State& state)
+{
+    Vector2p pos{1.0e7, -2.0e7};
+    const Vector2f vel{1234.5f, -543.2f};
+    const float dt = 0.0025f;
+
+    while (state.KeepRunning()) {
+        pos += (vel * dt).topostype();
+        gbenchmark_escape(&pos);
+    }
+}
+
+static void BM_UpdatePosVelAccelXY(benchmark::State& state)
+{
+    Vector2p pos{1.0e7, -2.0e7};
+    Vector2f vel{1234.5f, -543.2f};
+    const Vector2f accel{10.0f, -20.0f};
+    const Vector2f limit;
+    const float dt = 0.0025f;
+
+    while (state.KeepRunning()) {
+        update_pos_vel_accel_xy(pos, vel, accel, dt, limit);
+        gbenchmark_escape(&pos);
+        gbenchmark_escape(&vel);
+    }
+}
+
+static void BM_ShapePosVelAccelXY(benchmark::State& state)
+{
+    const Vector2p pos_input{1.0e7 + 500.0, -2.0e7 - 300.0};
+    const Vector2p pos{1.0e7, -2.0e7};
+    const Vector2f vel_input, accel_input, vel{100.0f, -50.0f};
+    Vector2f accel;
+
+    while (state.KeepRunning()) {
+        shape_pos_vel_accel_xy(pos_input, vel_input, accel_input, pos, vel, accel,
+                               500.0f, 1000.0f, 250.0f, 0.5f, 0.0025f);
+        gbenchmark_escape(&accel);
+    }
+}
+
+BENCHMARK(BM_Vector2fPosUpdate);
+BENCHMARK(BM_Vector2pPosUpdate);
+BENCHMARK(BM_UpdatePosVelAccelXY);
+BENCHMARK(BM_ShapePosVelAccelXY);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+static void BM_QuaternionMultiply(benchmark::State& state)
+{
+    Quaternion q1, q2;
+    q1.from_euler(0.1f, -0.2f, 1.3f);
+    q2.from_euler(-0.05f, 0.03f, 0.01f);
+
+    while (state.KeepRunning()) {
+        Quaternion q3 = q1 * q2;
+        gbenchmark_escape(&q3);
+    }
+}
+
+BENCHMARK(BM_QuaternionMultiply);
+
+// the attitude update in the EKF output predictor and DCM
+static void BM_QuaternionRotate(benchmark::State& state)
+{
+    const Vector3f delta_angle(0.001f, -0.002f, 0.0005f);
+    Quaternion q;
+
+    while (state.KeepRunning()) {
+        q.rotate(delta_angle);
+        gbenchmark_escape(&q);
+    }
+}
+
+BENCHMARK(BM_QuaternionRotate);
+
+static void BM_QuaternionRotateFast(benchmark::State& state)
+{
+    const Vector3f delta_angle(0.001f, -0.002f, 0.0005f);
+    Quaternion q;
+
+    while (state.KeepRunning()) {
+        q.rotate_fast(delta_angle);
+        gbenchmark_escape(&q);
+    }
+}
+
+BENCHMARK(BM_QuaternionRotateFast);
+
+static void BM_QuaternionNormalize(benchmark::State& state)
+{
+    Quaternion q(1.01f, 0.02f, -0.03f, 0.04f);
+
+    while (state.KeepRunning()) {
+        q.normalize();
+        gbenchmark_escape(&q);
+    }
+}
+
+BENCHMARK(BM_QuaternionNormalize);
+
+static void BM_QuaternionRotationMatrix(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(0.1f, -0.2f, 1.3f);
+    Matrix3f m;
+
+    while (state.KeepRunning()) {
+        q.rotation_matrix(m);
+        gbenchmark_escape(&m);
+    }
+}
+
+BENCHMARK(BM_QuaternionRotationMatrix);
+
+static void BM_QuaternionToEuler(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(0.1f, -0.2f, 1.3f);
+    float roll, pitch, yaw;
+
+    while (state.KeepRunning()) {
+        q.to_euler(roll, pitch, yaw);
+        gbenchmark_escape(&roll);
+        gbenchmark_escape(&pitch);
+        gbenchmark_escape(&yaw);
+    }
+}
+
+BENCHMARK(BM_QuaternionToEuler);
+
+static void BM_QuaternionEarthToBody(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(0.1f, -0.2f, 1.3f);
+    const Vector3f v_earth(1.0f, 2.0f, -9.8f);
+
+    while (state.KeepRunning()) {
+        Vector3f v = v_earth;
+        q.earth_to_body(v);
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_QuaternionEarthToBody);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,34 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/SCurve.h>
+
+/*
+  cost of advancing a target along a leg with lookahead legs on
+  either side, as the waypoint navigation does on every loop
+ */
+
+static void BM_SCurveAdvanceTargetAlongTrack(benchmark::State& state)
+{
+    SCurve prev_leg;
+    SCurve this_leg;
+    SCurve next_leg;
+    prev_leg.calculate_track(Vector3f{-10000.0f, 0.0f, 0.0f}, Vector3f{}, 1000.0f, 250.0f, 150.0f, 250.0f, 100.0f, 1.0f, 100.0f);
+    this_leg.calculate_track(Vector3f{}, Vector3f{10000.0f, 10000.0f, 0.0f}, 1000.0f, 250.0f, 150.0f, 250.0f, 100.0f, 1.0f, 100.0f);
+    next_leg.calculate_track(Vector3f{10000.0f, 10000.0f, 0.0f}, Vector3f{20000.0f, 10000.0f, 0.0f}, 1000.0f, 250.0f, 150.0f, 250.0f, 100.0f, 1.0f, 100.0f);
+    const SCurve start_leg = this_leg;
+
+    while (state.KeepRunning()) {
+        Vector3f target_pos, target_vel, target_accel;
+        if (this_leg.finished()) {
+            this_leg = start_leg;
+        }
+        bool passed = this_leg.advance_target_along_track(prev_leg, next_leg, 200.0f, true, 0.0025f, target_pos, target_vel, target_accel);
+        gbenchmark_escape(&target_pos);
+        gbenchmark_escape(&passed);
+    }
+}
+
+BENCHMARK(BM_SCurveAdvanceTargetAlongTrack);
+
+BENCHMARK_MAIN();
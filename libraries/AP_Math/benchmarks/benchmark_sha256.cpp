@@ -0,0 +1,60 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/sha256.h>
+
+/*
+  MAVLink2 signing hashes the 32 byte key, the 10 byte header, the
+  payload, the 2 byte crc and the first 7 bytes of the signature for
+  every signed packet sent or received. Items per second is packets
+  per second for the given payload length
+ */
+static void BM_sha256_signature(benchmark::State& state)
+{
+    uint8_t key[32];
+    uint8_t packet[10+255+2+7];
+    for (uint16_t i=0; i<sizeof(key); i++) {
+        key[i] = i * 13 + 1;
+    }
+    for (uint16_t i=0; i<sizeof(packet); i++) {
+        packet[i] = i * 7 + 3;
+    }
+    const uint16_t payload_len = state.range_x();
+    while (state.KeepRunning()) {
+        sha256_ctx ctx;
+        uint8_t sig[6];
+        sha256_init(ctx);
+        sha256_update(ctx, key, sizeof(key));
+        sha256_update(ctx, packet, 10);
+        sha256_update(ctx, &packet[10], payload_len);
+        sha256_update(ctx, &packet[10+payload_len], 2);
+        sha256_update(ctx, &packet[12+payload_len], 7);
+        sha256_final(ctx, sig, sizeof(sig));
+        gbenchmark_escape(sig);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_sha256(benchmark::State& state)
+{
+    static uint8_t buf[4096];
+    for (uint16_t i=0; i<sizeof(buf); i++) {
+        buf[i] = i * 7 + 3;
+    }
+    const uint32_t len = state.range_x();
+    while (state.KeepRunning()) {
+        sha256_ctx ctx;
+        uint8_t digest[32];
+        sha256_init(ctx);
+        sha256_update(ctx, buf, len);
+        sha256_final(ctx, digest, sizeof(digest));
+        gbenchmark_escape(digest);
+    }
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+// heartbeat, attitude, and the largest payloads
+BENCHMARK(BM_sha256_signature)->Arg(9)->Arg(28)->Arg(255);
+BENCHMARK(BM_sha256)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -17,8 +17,28 @@
  */
 
 #include <stdint.h>
+#include <string.h>
+#include <AP_HAL/AP_HAL.h>
 #include "crc.h"
 
+#ifndef AP_CRC_HW_ENABLED
+#define AP_CRC_HW_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS && !defined(HAL_BOOTLOADER_BUILD))
+#endif
+
+#if AP_CRC_HW_ENABLED
+extern const AP_HAL::HAL& hal;
+
+// below this length setting up the hardware costs more than it saves
+#ifndef AP_CRC_HW_MIN_LEN
+#define AP_CRC_HW_MIN_LEN 32
+#endif
+#endif
+
+// slice-by-8 crc32 needs 8k of tables, so only use it where memory is plentiful
+#ifndef AP_CRC32_SLICE_BY_8
+#define AP_CRC32_SLICE_BY_8 (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 /**
  * crc4 method from datasheet for 16 bytes (8 short values)
  * 
@@ -90,10 +110,36 @@ uint8_t crc_crc8(const uint8_t *p, uint8_t len)
 	return crc & 0xFF;
 }
 
+// table for crc8_dvb() with the DVB-S2 polynomial 0xD5
+static const uint8_t crc8_dvb_s2_table[] = {
+    0x00, 0xd5, 0x7f, 0xaa, 0xfe, 0x2b, 0x81, 0x54, 0x29, 0xfc, 0x56, 0x83,
+    0xd7, 0x02, 0xa8, 0x7d, 0x52, 0x87, 0x2d, 0xf8, 0xac, 0x79, 0xd3, 0x06,
+    0x7b, 0xae, 0x04, 0xd1, 0x85, 0x50, 0xfa, 0x2f, 0xa4, 0x71, 0xdb, 0x0e,
+    0x5a, 0x8f, 0x25, 0xf0, 0x8d, 0x58, 0xf2, 0x27, 0x73, 0xa6, 0x0c, 0xd9,
+    0xf6, 0x23, 0x89, 0x5c, 0x08, 0xdd, 0x77, 0xa2, 0xdf, 0x0a, 0xa0, 0x75,
+    0x21, 0xf4, 0x5e, 0x8b, 0x9d, 0x48, 0xe2, 0x37, 0x63, 0xb6, 0x1c, 0xc9,
+    0xb4, 0x61, 0xcb, 0x1e, 0x4a, 0x9f, 0x35, 0xe0, 0xcf, 0x1a, 0xb0, 0x65,
+    0x31, 0xe4, 0x4e, 0x9b, 0xe6, 0x33, 0x99, 0x4c, 0x18, 0xcd, 0x67, 0xb2,
+    0x39, 0xec, 0x46, 0x93, 0xc7, 0x12, 0xb8, 0x6d, 0x10, 0xc5, 0x6f, 0xba,
+    0xee, 0x3b, 0x91, 0x44, 0x6b, 0xbe, 0x14, 0xc1, 0x95, 0x40, 0xea, 0x3f,
+    0x42, 0x97, 0x3d, 0xe8, 0xbc, 0x69, 0xc3, 0x16, 0xef, 0x3a, 0x90, 0x45,
+    0x11, 0xc4, 0x6e, 0xbb, 0xc6, 0x13, 0xb9, 0x6c, 0x38, 0xed, 0x47, 0x92,
+    0xbd, 0x68, 0xc2, 0x17, 0x43, 0x96, 0x3c, 0xe9, 0x94, 0x41, 0xeb, 0x3e,
+    0x6a, 0xbf, 0x15, 0xc0, 0x4b, 0x9e, 0x34, 0xe1, 0xb5, 0x60, 0xca, 0x1f,
+    0x62, 0xb7, 0x1d, 0xc8, 0x9c, 0x49, 0xe3, 0x36, 0x19, 0xcc, 0x66, 0xb3,
+    0xe7, 0x32, 0x98, 0x4d, 0x30, 0xe5, 0x4f, 0x9a, 0xce, 0x1b, 0xb1, 0x64,
+    0x72, 0xa7, 0x0d, 0xd8, 0x8c, 0x59, 0xf3, 0x26, 0x5b, 0x8e, 0x24, 0xf1,
+    0xa5, 0x70, 0xda, 0x0f, 0x20, 0xf5, 0x5f, 0x8a, 0xde, 0x0b, 0xa1, 0x74,
+    0x09, 0xdc, 0x76, 0xa3, 0xf7, 0x22, 0x88, 0x5d, 0xd6, 0x03, 0xa9, 0x7c,
+    0x28, 0xfd, 0x57, 0x82, 0xff, 0x2a, 0x80, 0x55, 0x01, 0xd4, 0x7e, 0xab,
+    0x84, 0x51, 0xfb, 0x2e, 0x7a, 0xaf, 0x05, 0xd0, 0xad, 0x78, 0xd2, 0x07,
+    0x53, 0x86, 0x2c, 0xf9,
+};
+
 // crc8 from betaflight
 uint8_t crc8_dvb_s2(uint8_t crc, uint8_t a)
 {
-    return crc8_dvb(crc, a, 0xD5);
+    return crc8_dvb_s2_table[crc ^ a];
 }
 
 // crc8 from betaflight
@@ -128,26 +174,13 @@ uint8_t crc8_dvb_s2_update(uint8_t crc, const void *data, uint32_t length)
  */
 uint16_t crc_xmodem_update(uint16_t crc, uint8_t data)
 {
-	crc = crc ^ ((uint16_t)data << 8);
-	for (uint16_t i=0; i<8; i++)
-	{
-		if(crc & 0x8000) {
-			crc = (crc << 1) ^ 0x1021;
-		} else {
-			crc <<= 1;
-        }
-	}
-
-	return crc;
+    // xmodem is the CCITT polynomial, so use its table
+    return crc16_ccitt(&data, 1, crc);
 }
 
 uint16_t crc_xmodem(const uint8_t *data, uint16_t len)
 {
-    uint16_t crc = 0;
-    for (uint16_t i=0; i<len; i++) {
-        crc = crc_xmodem_update(crc, data[i]);
-    }
-    return crc;
+    return crc16_ccitt(data, len, 0);
 }
 
 /*
@@ -200,8 +233,57 @@ static const uint32_t crc32_tab[] = {
 };
 
 
+#if AP_CRC32_SLICE_BY_8
+/*
+  tables for processing 8 bytes at a time. Table k gives the crc of a
+  byte followed by k zero bytes
+ */
+static const uint32_t (*crc32_slice_tables(void))[256]
+{
+    static struct SliceTables {
+        uint32_t t[8][256];
+        SliceTables() {
+            for (uint16_t i=0; i<256; i++) {
+                t[0][i] = crc32_tab[i];
+            }
+            for (uint16_t i=0; i<256; i++) {
+                for (uint8_t k=1; k<8; k++) {
+                    t[k][i] = (t[k-1][i] >> 8) ^ crc32_tab[t[k-1][i] & 0xff];
+                }
+            }
+        }
+    } tables;
+    return tables.t;
+}
+#endif
+
 uint32_t crc_crc32(uint32_t crc, const uint8_t *buf, uint32_t size)
 {
+#if AP_CRC_HW_ENABLED
+    if (size >= AP_CRC_HW_MIN_LEN && hal.util->crc32_hw(crc, buf, size)) {
+        return crc;
+    }
+#endif
+
+#if AP_CRC32_SLICE_BY_8
+    if (size >= 8) {
+        const uint32_t (*t)[256] = crc32_slice_tables();
+        while (size >= 8) {
+            // little endian, as the platforms using this are
+            uint32_t one, two;
+            memcpy(&one, buf, 4);
+            memcpy(&two, buf+4, 4);
+            one ^= crc;
+            crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+                  t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+                  t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^
+                  t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+            buf += 8;
+            size -= 8;
+        }
+    }
+#endif
+
 	for (uint32_t i=0; i<size; i++) {
 		crc = crc32_tab[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
 	}
@@ -273,12 +355,65 @@ static const uint16_t crc16tab[256] = {
 
 uint16_t crc16_ccitt(const uint8_t *buf, uint32_t len, uint16_t crc)
 {
+#if AP_CRC_HW_ENABLED
+    if (len >= AP_CRC_HW_MIN_LEN && hal.util->crc16_ccitt_hw(crc, buf, len)) {
+        return crc;
+    }
+#endif
     for (uint32_t i = 0; i < len; i++) {
         crc = (crc << 8) ^ crc16tab[((crc >> 8) ^ *buf++) & 0x00FF];
     }
     return crc;
 }
 
+/*
+  CRC-16/MCRF4XX, the reflected form of the CCITT polynomial used by
+  MAVLink (as crc_accumulate() in the MAVLink headers). MAVLink starts
+  from 0xFFFF
+ */
+static const uint16_t crc16_mcrf4xx_tab[256] = {
+  0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+  0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+  0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+  0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+  0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+  0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+  0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+  0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+  0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+  0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+  0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+  0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+  0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+  0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+  0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+  0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+  0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+  0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+  0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+  0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+  0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+  0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+  0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+  0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+  0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+  0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+  0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+  0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+  0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+  0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+  0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+  0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
+};
+
+uint16_t crc16_mcrf4xx(uint16_t crc, const uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ crc16_mcrf4xx_tab[(crc ^ *buf++) & 0xFF];
+    }
+    return crc;
+}
+
 /**
  * Calculate Modbus CRC16 for array of bytes
  * 
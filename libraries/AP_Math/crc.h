@@ -35,6 +35,9 @@ uint8_t crc_sum8(const uint8_t *p, uint8_t len);
 // Contact: Fergus Noble <fergus@swift-nav.com>
 uint16_t crc16_ccitt(const uint8_t *buf, uint32_t len, uint16_t crc);
 
+// reflected CCITT, as used by MAVLink
+uint16_t crc16_mcrf4xx(uint16_t crc, const uint8_t *buf, uint32_t len);
+
 uint16_t calc_crc_modbus(uint8_t *buf, uint16_t len);
 
 // generate 64bit FNV1a hash from buffer
@@ -0,0 +1,225 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  polynomial approximations of sin, cos, atan2 and sqrt for hot paths
+  that can live with a known error. Each function takes the accuracy
+  as a template parameter, the bounds below are the worst case over
+  the valid range and are checked by tests/test_fast_math.cpp
+
+                      LOW              HIGH
+  fast_sinf/cosf      5e-5             5e-7        absolute
+  fast_atan2f         2e-5 rad         4e-7 rad    absolute
+  fast_inv_sqrtf      2e-3             5e-6        relative
+  fast_sqrtf          2e-3             5e-6        relative
+
+  sin and cos are accurate for |x| up to FAST_MATH_TRIG_MAX, beyond that
+  (and for inf and NaN) they fall back to the libm functions.
+
+  No lookup tables are used: on flash with wait states a table read is
+  no faster than a few multiply-adds, and it costs flash.
+ */
+#pragma once
+
+#include <cmath>
+#include <stdint.h>
+#include <string.h>
+
+#include "definitions.h"
+
+enum class FastMathAccuracy : uint8_t {
+    LOW,
+    HIGH,
+};
+
+// largest argument the trig range reduction is accurate for
+#define FAST_MATH_TRIG_MAX 1.0e5f
+
+namespace FastMath {
+
+// pi/2 split into parts with few enough bits that k*part is exact for
+// any quadrant k up to FAST_MATH_TRIG_MAX
+static constexpr float PI_2_A = 1.5703125f;
+static constexpr float PI_2_B = 4.825592041015625e-4f;
+static constexpr float PI_2_C = 1.26759084650984732e-6f;
+
+// sin(r) for |r| <= pi/4
+template <FastMathAccuracy A>
+inline float sin_poly(float r)
+{
+    const float r2 = r*r;
+    if (A == FastMathAccuracy::LOW) {
+        return r * (1.0f + r2 * (-1.0f/6 + r2 * (1.0f/120)));
+    }
+    return r * (1.0f + r2 * (-1.0f/6 + r2 * (1.0f/120 + r2 * (-1.0f/5040))));
+}
+
+// cos(r) for |r| <= pi/4
+template <FastMathAccuracy A>
+inline float cos_poly(float r)
+{
+    const float r2 = r*r;
+    if (A == FastMathAccuracy::LOW) {
+        return 1.0f + r2 * (-0.5f + r2 * (1.0f/24 + r2 * (-1.0f/720)));
+    }
+    return 1.0f + r2 * (-0.5f + r2 * (1.0f/24 + r2 * (-1.0f/720 + r2 * (1.0f/40320))));
+}
+
+// atan(r) for 0 <= r <= tan(pi/12)
+template <FastMathAccuracy A>
+inline float atan_poly(float r)
+{
+    const float r2 = r*r;
+    if (A == FastMathAccuracy::LOW) {
+        return r * (1.0f + r2 * (-1.0f/3 + r2 * (1.0f/5)));
+    }
+    return r * (1.0f + r2 * (-1.0f/3 + r2 * (1.0f/5 + r2 * (-1.0f/7 + r2 * (1.0f/9)))));
+}
+
+// reduce x to r in [-pi/4, pi/4], returning the quadrant x was in
+inline uint8_t reduce_quadrant(float x, float &r)
+{
+    const float q = x * float(2.0/M_PI);
+    const int32_t k = int32_t(q >= 0 ? q + 0.5f : q - 0.5f);
+    const float kf = float(k);
+    r = ((x - kf * PI_2_A) - kf * PI_2_B) - kf * PI_2_C;
+    return uint8_t(k) & 3U;
+}
+
+} // namespace FastMath
+
+/*
+  sin and cos of x in radians, calculated together
+ */
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline void fast_sincosf(float x, float &s, float &c)
+{
+    if (!(fabsf(x) <= FAST_MATH_TRIG_MAX)) {
+        s = sinf(x);
+        c = cosf(x);
+        return;
+    }
+    float r;
+    const uint8_t q = FastMath::reduce_quadrant(x, r);
+    const float sr = FastMath::sin_poly<A>(r);
+    const float cr = FastMath::cos_poly<A>(r);
+    switch (q) {
+    case 0:
+        s = sr;
+        c = cr;
+        break;
+    case 1:
+        s = cr;
+        c = -sr;
+        break;
+    case 2:
+        s = -sr;
+        c = -cr;
+        break;
+    default:
+        s = -cr;
+        c = sr;
+        break;
+    }
+}
+
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline float fast_sinf(float x)
+{
+    if (!(fabsf(x) <= FAST_MATH_TRIG_MAX)) {
+        return sinf(x);
+    }
+    float r;
+    const uint8_t q = FastMath::reduce_quadrant(x, r);
+    const float v = (q & 1U) ? FastMath::cos_poly<A>(r) : FastMath::sin_poly<A>(r);
+    return (q & 2U) ? -v : v;
+}
+
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline float fast_cosf(float x)
+{
+    if (!(fabsf(x) <= FAST_MATH_TRIG_MAX)) {
+        return cosf(x);
+    }
+    float r;
+    const uint8_t q = FastMath::reduce_quadrant(x, r);
+    const float v = (q & 1U) ? FastMath::sin_poly<A>(r) : FastMath::cos_poly<A>(r);
+    return ((q + 1U) & 2U) ? -v : v;
+}
+
+/*
+  atan2 with the same quadrant conventions as atan2f. Returns zero when
+  both x and y are zero
+ */
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline float fast_atan2f(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    const float mn = ay < ax ? ay : ax;
+    const float mx = ay < ax ? ax : ay;
+    if (!(mx > 0)) {
+        return 0;
+    }
+    // atan(mn/mx) in [0, pi/4]. Above tan(pi/12) use
+    // atan(a) = pi/6 + atan((sqrt(3)a - 1)/(sqrt(3) + a)) so the series
+    // only has to cover [0, tan(pi/12)], with a single divide either way
+    const float sqrt3 = 1.73205080756887729f;
+    float r;
+    if (mn <= 0.267949192431122706f * mx) {
+        r = FastMath::atan_poly<A>(mn / mx);
+    } else {
+        r = float(M_PI/6) + FastMath::atan_poly<A>((sqrt3 * mn - mx) / (sqrt3 * mx + mn));
+    }
+    if (ay > ax) {
+        r = float(M_PI/2) - r;
+    }
+    if (x < 0) {
+        r = float(M_PI) - r;
+    }
+    return std::signbit(y) ? -r : r;
+}
+
+/*
+  1/sqrt(x) for positive x, by Newton-Raphson from a bit level estimate.
+  Cheaper than 1.0f/sqrtf(x) as it avoids the divide
+ */
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline float fast_inv_sqrtf(float x)
+{
+    uint32_t i;
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5f3759dfU - (i >> 1);
+    float y;
+    memcpy(&y, &i, sizeof(y));
+    const float half_x = 0.5f * x;
+    y = y * (1.5f - half_x * y * y);
+    if (A == FastMathAccuracy::HIGH) {
+        y = y * (1.5f - half_x * y * y);
+    }
+    return y;
+}
+
+/*
+  sqrt(x), returning zero for x <= 0 like safe_sqrt(). Only worth using
+  on boards without a hardware square root
+ */
+template <FastMathAccuracy A = FastMathAccuracy::HIGH>
+inline float fast_sqrtf(float x)
+{
+    if (!(x > 0)) {
+        return 0;
+    }
+    return x * fast_inv_sqrtf<A>(x);
+}
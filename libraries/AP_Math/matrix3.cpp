@@ -62,14 +62,16 @@ void Matrix3<T>::to_euler(float *roll, float *pitch, float *yaw) const
 template <typename T>
 void Matrix3<T>::from_rotation(enum Rotation rotation)
 {
-    (*this).a = {1,0,0};
-    (*this).b = {0,1,0};
-    (*this).c = {0,0,1};
-
-    (*this).a.rotate(rotation);
-    (*this).b.rotate(rotation);
-    (*this).c.rotate(rotation);
-    (*this).transpose();
+    if (rotation >= ROTATION_MAX) {
+        // report the error and leave an identity matrix
+        identity();
+        a.rotate(rotation);
+        return;
+    }
+    const float (&m)[3][3] = rotation_matrices[rotation];
+    a = Vector3<T>(m[0][0], m[0][1], m[0][2]);
+    b = Vector3<T>(m[1][0], m[1][1], m[1][2]);
+    c = Vector3<T>(m[2][0], m[2][1], m[2][2]);
 }
 
 /*
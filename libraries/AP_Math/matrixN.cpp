@@ -11,6 +11,14 @@
 template <typename T, uint8_t N>
 void MatrixN<T,N>::mult(const VectorN<T,N> &A, const VectorN<T,N> &B)
 {
+#if MATH_USE_CMSIS
+    if (std::is_same<T,float>::value && N >= MATH_CMSIS_MIN_N) {
+        // (N x 1) * (1 x N)
+        MathCMSIS::mat_mult(reinterpret_cast<float *>(v), reinterpret_cast<const float *>(A._v),
+                            reinterpret_cast<const float *>(B._v), N, 1, N);
+        return;
+    }
+#endif
     for (uint8_t i = 0; i < N; i++) {
         for (uint8_t j = 0; j < N; j++) {
             v[i][j] = A[i] * B[j];
@@ -46,8 +54,8 @@ MatrixN<T,N> &MatrixN<T,N>::operator +=(const MatrixN<T,N> &B)
 template <typename T, uint8_t N>
 void MatrixN<T,N>::force_symmetry(void)
 {
-    for (uint8_t i = 0; i < N; i++) {
-        for (uint8_t j = 0; j < (i - 1); j++) {
+    for (uint8_t i = 1; i < N; i++) {
+        for (uint8_t j = 0; j < i; j++) {
             v[i][j] = (v[i][j] + v[j][i]) / 2;
             v[j][i] = v[i][j];
         }
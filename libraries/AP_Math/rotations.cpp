@@ -0,0 +1,110 @@
+/*
+ * rotations.cpp
+ *
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rotations.h"
+
+/*
+  rotation matrix for each standard rotation, indexed by enum Rotation.
+  Row i gives component i of the rotated vector, so rotating v is
+  v' = M v. Entries must stay in the same order as the enum
+ */
+const float rotation_matrices[ROTATION_MAX][3][3] = {
+    // ROTATION_NONE
+    {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+    // ROTATION_YAW_45
+    {{HALF_SQRT_2, -HALF_SQRT_2, 0}, {HALF_SQRT_2, HALF_SQRT_2, 0}, {0, 0, 1}},
+    // ROTATION_YAW_90
+    {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}},
+    // ROTATION_YAW_135
+    {{-HALF_SQRT_2, -HALF_SQRT_2, 0}, {HALF_SQRT_2, -HALF_SQRT_2, 0}, {0, 0, 1}},
+    // ROTATION_YAW_180
+    {{-1, 0, 0}, {0, -1, 0}, {0, 0, 1}},
+    // ROTATION_YAW_225
+    {{-HALF_SQRT_2, HALF_SQRT_2, 0}, {-HALF_SQRT_2, -HALF_SQRT_2, 0}, {0, 0, 1}},
+    // ROTATION_YAW_270
+    {{0, 1, 0}, {-1, 0, 0}, {0, 0, 1}},
+    // ROTATION_YAW_315
+    {{HALF_SQRT_2, HALF_SQRT_2, 0}, {-HALF_SQRT_2, HALF_SQRT_2, 0}, {0, 0, 1}},
+    // ROTATION_ROLL_180
+    {{1, 0, 0}, {0, -1, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_45
+    {{HALF_SQRT_2, HALF_SQRT_2, 0}, {HALF_SQRT_2, -HALF_SQRT_2, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_90
+    {{0, 1, 0}, {1, 0, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_135
+    {{-HALF_SQRT_2, HALF_SQRT_2, 0}, {HALF_SQRT_2, HALF_SQRT_2, 0}, {0, 0, -1}},
+    // ROTATION_PITCH_180
+    {{-1, 0, 0}, {0, 1, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_225
+    {{-HALF_SQRT_2, -HALF_SQRT_2, 0}, {-HALF_SQRT_2, HALF_SQRT_2, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_270
+    {{0, -1, 0}, {-1, 0, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_180_YAW_315
+    {{HALF_SQRT_2, -HALF_SQRT_2, 0}, {-HALF_SQRT_2, -HALF_SQRT_2, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_90
+    {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},
+    // ROTATION_ROLL_90_YAW_45
+    {{HALF_SQRT_2, 0, HALF_SQRT_2}, {HALF_SQRT_2, 0, -HALF_SQRT_2}, {0, 1, 0}},
+    // ROTATION_ROLL_90_YAW_90
+    {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},
+    // ROTATION_ROLL_90_YAW_135
+    {{-HALF_SQRT_2, 0, HALF_SQRT_2}, {HALF_SQRT_2, 0, HALF_SQRT_2}, {0, 1, 0}},
+    // ROTATION_ROLL_270
+    {{1, 0, 0}, {0, 0, 1}, {0, -1, 0}},
+    // ROTATION_ROLL_270_YAW_45
+    {{HALF_SQRT_2, 0, -HALF_SQRT_2}, {HALF_SQRT_2, 0, HALF_SQRT_2}, {0, -1, 0}},
+    // ROTATION_ROLL_270_YAW_90
+    {{0, 0, -1}, {1, 0, 0}, {0, -1, 0}},
+    // ROTATION_ROLL_270_YAW_135
+    {{-HALF_SQRT_2, 0, -HALF_SQRT_2}, {HALF_SQRT_2, 0, -HALF_SQRT_2}, {0, -1, 0}},
+    // ROTATION_PITCH_90
+    {{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}},
+    // ROTATION_PITCH_270
+    {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}},
+    // ROTATION_PITCH_180_YAW_90
+    {{0, -1, 0}, {-1, 0, 0}, {0, 0, -1}},
+    // ROTATION_PITCH_180_YAW_270
+    {{0, 1, 0}, {1, 0, 0}, {0, 0, -1}},
+    // ROTATION_ROLL_90_PITCH_90
+    {{0, 1, 0}, {0, 0, -1}, {-1, 0, 0}},
+    // ROTATION_ROLL_180_PITCH_90
+    {{0, 0, -1}, {0, -1, 0}, {-1, 0, 0}},
+    // ROTATION_ROLL_270_PITCH_90
+    {{0, -1, 0}, {0, 0, 1}, {-1, 0, 0}},
+    // ROTATION_ROLL_90_PITCH_180
+    {{-1, 0, 0}, {0, 0, -1}, {0, -1, 0}},
+    // ROTATION_ROLL_270_PITCH_180
+    {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+    // ROTATION_ROLL_90_PITCH_270
+    {{0, -1, 0}, {0, 0, -1}, {1, 0, 0}},
+    // ROTATION_ROLL_180_PITCH_270
+    {{0, 0, 1}, {0, -1, 0}, {1, 0, 0}},
+    // ROTATION_ROLL_270_PITCH_270
+    {{0, 1, 0}, {0, 0, 1}, {1, 0, 0}},
+    // ROTATION_ROLL_90_PITCH_180_YAW_90
+    {{0, 0, 1}, {-1, 0, 0}, {0, -1, 0}},
+    // ROTATION_ROLL_90_YAW_270
+    {{0, 0, -1}, {-1, 0, 0}, {0, 1, 0}},
+    // ROTATION_ROLL_90_PITCH_68_YAW_293
+    {{ 0.143039f,  0.368776f, -0.918446f}, {-0.332133f, -0.856289f, -0.395546f}, {-0.932324f,  0.361625f,  0}},
+    // ROTATION_PITCH_315
+    {{HALF_SQRT_2, 0, -HALF_SQRT_2}, {0, 1, 0}, {HALF_SQRT_2, 0, HALF_SQRT_2}},
+    // ROTATION_ROLL_90_PITCH_315
+    {{HALF_SQRT_2, -HALF_SQRT_2, 0}, {0, 0, -1}, {HALF_SQRT_2, HALF_SQRT_2, 0}},
+    // ROTATION_PITCH_7
+    {{0.992546151641322f, 0, 0.12186934340514748f}, {0, 1, 0}, {-0.12186934340514748f, 0, 0.992546151641322f}},
+};
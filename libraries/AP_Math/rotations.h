@@ -17,6 +17,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 // these rotations form a full set - every rotation in the following
 // list when combined with another in the list forms an entry which is
 // also in the list. This is an important property. Please run the
@@ -83,6 +85,10 @@ enum Rotation : uint8_t {
 // definitions used by quaterion and vector3f
 #define HALF_SQRT_2 0.70710678118654757f
 
+// rotation matrix for each rotation below ROTATION_MAX, so that
+// rotating v gives M v. Defined in rotations.cpp
+extern const float rotation_matrices[ROTATION_MAX][3][3];
+
 /*
 Here are the same values in a form suitable for a @Values attribute in
 auto documentation:
@@ -0,0 +1,182 @@
+/*
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+  SHA-256 (FIPS 180-4). Used for MAVLink2 signing, where every signed
+  packet in either direction is hashed, so the software version works
+  on whole blocks straight from the input where it can and keeps only
+  16 words of message schedule.
+ */
+
+#include <string.h>
+#include <AP_HAL/AP_HAL.h>
+#include "AP_Math.h"
+#include "sha256.h"
+
+#ifndef AP_SHA256_HW_ENABLED
+#define AP_SHA256_HW_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS && !defined(HAL_BOOTLOADER_BUILD))
+#endif
+
+#if AP_SHA256_HW_ENABLED
+extern const AP_HAL::HAL& hal;
+#endif
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t ror(uint32_t x, uint8_t n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+/*
+  one round, with the working variables rotated by the caller's
+  argument order rather than by copying
+ */
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, k, w) do {                 \
+        const uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + \
+            ((e & f) ^ (~e & g)) + k + w;                               \
+        const uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) +     \
+            ((a & b) ^ (a & c) ^ (b & c));                              \
+        d += t1;                                                        \
+        h = t1 + t2;                                                    \
+    } while (0)
+
+static void sha256_block(uint32_t state[8], const uint8_t *block)
+{
+    uint32_t w[16];
+    for (uint8_t i=0; i<16; i++) {
+        w[i] = load_be32(&block[i*4]);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (uint8_t i=0; i<64; i += 8) {
+        if (i >= 16) {
+            // extend the schedule in place, 8 words at a time
+            for (uint8_t j=i; j<i+8; j++) {
+                const uint32_t w15 = w[(j-15) & 15];
+                const uint32_t w2 = w[(j-2) & 15];
+                w[j & 15] += (ror(w15, 7) ^ ror(w15, 18) ^ (w15 >> 3)) +
+                    w[(j-7) & 15] +
+                    (ror(w2, 17) ^ ror(w2, 19) ^ (w2 >> 10));
+            }
+        }
+        SHA256_ROUND(a, b, c, d, e, f, g, h, K[i+0], w[(i+0) & 15]);
+        SHA256_ROUND(h, a, b, c, d, e, f, g, K[i+1], w[(i+1) & 15]);
+        SHA256_ROUND(g, h, a, b, c, d, e, f, K[i+2], w[(i+2) & 15]);
+        SHA256_ROUND(f, g, h, a, b, c, d, e, K[i+3], w[(i+3) & 15]);
+        SHA256_ROUND(e, f, g, h, a, b, c, d, K[i+4], w[(i+4) & 15]);
+        SHA256_ROUND(d, e, f, g, h, a, b, c, K[i+5], w[(i+5) & 15]);
+        SHA256_ROUND(c, d, e, f, g, h, a, b, K[i+6], w[(i+6) & 15]);
+        SHA256_ROUND(b, c, d, e, f, g, h, a, K[i+7], w[(i+7) & 15]);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void sha256_init(sha256_ctx &ctx)
+{
+    static const uint32_t H0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx.state, H0, sizeof(H0));
+    ctx.length = 0;
+    ctx.buf_len = 0;
+#if AP_SHA256_HW_ENABLED
+    ctx.hw = hal.util->sha256_hw_start();
+#else
+    ctx.hw = false;
+#endif
+}
+
+void sha256_update(sha256_ctx &ctx, const void *data, uint32_t len)
+{
+#if AP_SHA256_HW_ENABLED
+    if (ctx.hw) {
+        hal.util->sha256_hw_update((const uint8_t *)data, len);
+        return;
+    }
+#endif
+    const uint8_t *p = (const uint8_t *)data;
+    ctx.length += len;
+    if (ctx.buf_len > 0) {
+        const uint8_t n = MIN(len, uint32_t(64 - ctx.buf_len));
+        memcpy(&ctx.buf[ctx.buf_len], p, n);
+        ctx.buf_len += n;
+        p += n;
+        len -= n;
+        if (ctx.buf_len < 64) {
+            return;
+        }
+        sha256_block(ctx.state, ctx.buf);
+        ctx.buf_len = 0;
+    }
+    while (len >= 64) {
+        sha256_block(ctx.state, p);
+        p += 64;
+        len -= 64;
+    }
+    memcpy(ctx.buf, p, len);
+    ctx.buf_len = len;
+}
+
+void sha256_final(sha256_ctx &ctx, uint8_t *digest, uint8_t len)
+{
+    len = MIN(len, 32);
+#if AP_SHA256_HW_ENABLED
+    if (ctx.hw) {
+        hal.util->sha256_hw_finish(digest, len);
+        ctx.hw = false;
+        return;
+    }
+#endif
+    const uint64_t bits = ctx.length * 8;
+    ctx.buf[ctx.buf_len++] = 0x80;
+    if (ctx.buf_len > 56) {
+        memset(&ctx.buf[ctx.buf_len], 0, 64 - ctx.buf_len);
+        sha256_block(ctx.state, ctx.buf);
+        ctx.buf_len = 0;
+    }
+    memset(&ctx.buf[ctx.buf_len], 0, 56 - ctx.buf_len);
+    for (uint8_t i=0; i<8; i++) {
+        ctx.buf[56+i] = bits >> (56 - 8*i);
+    }
+    sha256_block(ctx.state, ctx.buf);
+
+    for (uint8_t i=0; i<len; i++) {
+        digest[i] = ctx.state[i/4] >> (24 - 8*(i%4));
+    }
+}
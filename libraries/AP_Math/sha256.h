@@ -0,0 +1,35 @@
+/*
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+  SHA-256, using the HAL's hash unit when it has one
+ */
+#pragma once
+
+#include <stdint.h>
+
+struct sha256_ctx {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t buf[64];
+    uint8_t buf_len;
+    // the hash unit has been claimed for this hash
+    bool hw;
+};
+
+void sha256_init(sha256_ctx &ctx);
+void sha256_update(sha256_ctx &ctx, const void *data, uint32_t len);
+
+// finish the hash, writing the first len bytes (at most 32) of the digest
+void sha256_final(sha256_ctx &ctx, uint8_t *digest, uint8_t len);
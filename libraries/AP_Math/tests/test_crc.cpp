@@ -0,0 +1,55 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint8_t check_string[] = "123456789";
+
+TEST(CRCTest, CheckValues)
+{
+    const uint32_t len = sizeof(check_string) - 1;
+
+    // standard check values for "123456789"
+    EXPECT_EQ(0xCBF43926U, crc_crc32(0xFFFFFFFF, check_string, len) ^ 0xFFFFFFFF);
+    EXPECT_EQ(0x31C3U, crc_xmodem(check_string, len));
+    EXPECT_EQ(0x29B1U, crc16_ccitt(check_string, len, 0xFFFF));
+    EXPECT_EQ(0xBCU, crc8_dvb_s2_update(0, check_string, len));
+    EXPECT_EQ(0x6F91U, crc16_mcrf4xx(0xFFFF, check_string, len));
+}
+
+TEST(CRCTest, CRC32MatchesBitwise)
+{
+    uint8_t buf[300];
+    for (uint16_t i=0; i<sizeof(buf); i++) {
+        buf[i] = i * 7 + 3;
+    }
+    // every length and alignment around the 8 byte slices
+    for (uint16_t ofs=0; ofs<8; ofs++) {
+        for (uint16_t len=0; len<sizeof(buf)-ofs; len++) {
+            EXPECT_EQ(crc32_small(0x12345678, &buf[ofs], len),
+                      crc_crc32(0x12345678, &buf[ofs], len));
+        }
+    }
+}
+
+TEST(CRCTest, CRC8MatchesBitwise)
+{
+    for (uint16_t crc=0; crc<256; crc++) {
+        for (uint16_t a=0; a<256; a++) {
+            EXPECT_EQ(crc8_dvb(crc, a, 0xD5), crc8_dvb_s2(crc, a));
+        }
+    }
+}
+
+TEST(CRCTest, XmodemUpdate)
+{
+    uint16_t crc = 0;
+    for (uint8_t i=0; i<sizeof(check_string)-1; i++) {
+        crc = crc_xmodem_update(crc, check_string[i]);
+    }
+    EXPECT_EQ(0x31C3U, crc);
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,100 @@
+#include <AP_gtest.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/fast_math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// worst case errors, matching the table in fast_math.h
+static const double trig_err[] { 5e-5, 5e-7 };
+static const double atan2_err[] { 2e-5, 4e-7 };
+static const double sqrt_err[] { 2e-3, 5e-6 };
+
+template <FastMathAccuracy A>
+static void check_trig(void)
+{
+    const double max_err = trig_err[uint8_t(A)];
+    double worst = 0;
+    for (float x = -FAST_MATH_TRIG_MAX; x < FAST_MATH_TRIG_MAX; x += 0.731f) {
+        float s, c;
+        fast_sincosf<A>(x, s, c);
+        worst = MAX(worst, fabs(s - sin(double(x))));
+        worst = MAX(worst, fabs(c - cos(double(x))));
+        worst = MAX(worst, fabs(fast_sinf<A>(x) - sin(double(x))));
+        worst = MAX(worst, fabs(fast_cosf<A>(x) - cos(double(x))));
+    }
+    // fine steps around zero and the quadrant boundaries
+    for (float x = -7; x < 7; x += 0.0001f) {
+        worst = MAX(worst, fabs(fast_sinf<A>(x) - sin(double(x))));
+        worst = MAX(worst, fabs(fast_cosf<A>(x) - cos(double(x))));
+    }
+    EXPECT_LT(worst, max_err);
+}
+
+template <FastMathAccuracy A>
+static void check_atan2(void)
+{
+    const double max_err = atan2_err[uint8_t(A)];
+    double worst = 0;
+    for (float a = -M_PI; a <= M_PI; a += 0.0001f) {
+        for (float r : { 1e-3f, 1.0f, 1e4f }) {
+            const float y = r * sinf(a);
+            const float x = r * cosf(a);
+            worst = MAX(worst, fabs(fast_atan2f<A>(y, x) - atan2(double(y), double(x))));
+        }
+    }
+    EXPECT_LT(worst, max_err);
+}
+
+template <FastMathAccuracy A>
+static void check_sqrt(void)
+{
+    const double max_err = sqrt_err[uint8_t(A)];
+    double worst = 0;
+    for (float x = 1e-10f; x < 1e10f; x *= 1.0003f) {
+        worst = MAX(worst, fabs(fast_inv_sqrtf<A>(x) * sqrt(double(x)) - 1));
+        worst = MAX(worst, fabs(fast_sqrtf<A>(x) / sqrt(double(x)) - 1));
+    }
+    EXPECT_LT(worst, max_err);
+}
+
+TEST(FastMath, Trig)
+{
+    check_trig<FastMathAccuracy::LOW>();
+    check_trig<FastMathAccuracy::HIGH>();
+}
+
+TEST(FastMath, Atan2)
+{
+    check_atan2<FastMathAccuracy::LOW>();
+    check_atan2<FastMathAccuracy::HIGH>();
+
+    // same signs and quadrants as atan2f
+    EXPECT_FLOAT_EQ(M_PI/4, fast_atan2f(1.0f, 1.0f));
+    EXPECT_FLOAT_EQ(3*M_PI/4, fast_atan2f(1.0f, -1.0f));
+    EXPECT_FLOAT_EQ(-3*M_PI/4, fast_atan2f(-1.0f, -1.0f));
+    EXPECT_FLOAT_EQ(-M_PI/4, fast_atan2f(-1.0f, 1.0f));
+    EXPECT_FLOAT_EQ(M_PI/2, fast_atan2f(1.0f, 0.0f));
+    EXPECT_FLOAT_EQ(M_PI, fast_atan2f(0.0f, -1.0f));
+    EXPECT_FLOAT_EQ(-M_PI, fast_atan2f(-0.0f, -1.0f));
+    EXPECT_EQ(0, fast_atan2f(0.0f, 0.0f));
+}
+
+TEST(FastMath, Sqrt)
+{
+    check_sqrt<FastMathAccuracy::LOW>();
+    check_sqrt<FastMathAccuracy::HIGH>();
+
+    EXPECT_EQ(0, fast_sqrtf(0.0f));
+    EXPECT_EQ(0, fast_sqrtf(-1.0f));
+}
+
+TEST(FastMath, OutOfRange)
+{
+    // large arguments, inf and NaN are passed through to libm
+    EXPECT_FLOAT_EQ(sinf(1e7f), fast_sinf(1e7f));
+    EXPECT_FLOAT_EQ(cosf(-1e7f), fast_cosf(-1e7f));
+    EXPECT_TRUE(isnan(fast_sinf(NAN)));
+    EXPECT_TRUE(isnan(fast_cosf(INFINITY)));
+}
+
+AP_GTEST_MAIN()
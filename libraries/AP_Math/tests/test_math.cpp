@@ -76,6 +76,28 @@ TEST(VectorTest, Rotations)
     TEST_ROTATION(ROTATION_MAX, 1, 1, 1);
 }
 
+TEST(VectorTest, RotationMatrices)
+{
+    const Vector3f v(0.3f, -0.5f, 0.8f);
+    for (uint8_t r = 0; r < ROTATION_MAX; r++) {
+        const Rotation rotation = Rotation(r);
+        Vector3f rotated = v;
+        rotated.rotate(rotation);
+
+        // from_rotation() gives the same result as rotate()
+        Matrix3f m;
+        m.from_rotation(rotation);
+        const Vector3f mv = m * v;
+        EXPECT_FLOAT_EQ(rotated.x, mv.x) << "rotation " << unsigned(r);
+        EXPECT_FLOAT_EQ(rotated.y, mv.y) << "rotation " << unsigned(r);
+        EXPECT_FLOAT_EQ(rotated.z, mv.z) << "rotation " << unsigned(r);
+
+        // rotate_inverse() undoes rotate()
+        rotated.rotate_inverse(rotation);
+        EXPECT_NEAR(0, (rotated - v).length(), 1.0e-5) << "rotation " << unsigned(r);
+    }
+}
+
 TEST(MathTest, IsZero)
 {
     EXPECT_FALSE(is_zero(0.1f));
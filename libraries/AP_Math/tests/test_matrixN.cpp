@@ -0,0 +1,60 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/matrixN.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(MatrixNTest, OuterProduct)
+{
+    const float a[4] {1, 2, 3, 4};
+    const float b[4] {5, 6, 7, 8};
+    MatrixN<float,4> m;
+    m.mult(VectorN<float,4>(a), VectorN<float,4>(b));
+
+    // (A * B') * x = A * (B . x)
+    const float x[4] {1, -1, 2, 0.5};
+    VectorN<float,4> mx;
+    mx.mult(m, VectorN<float,4>(x));
+    const float bx = VectorN<float,4>(b) * VectorN<float,4>(x);
+    for (uint8_t i=0; i<4; i++) {
+        EXPECT_FLOAT_EQ(a[i] * bx, mx[i]);
+    }
+}
+
+TEST(MatrixNTest, ForceSymmetry)
+{
+    // outer products of different vectors are not symmetric
+    const float a[4] {1, 2, 3, 4};
+    const float b[4] {0.5, -1, 2, 3};
+    MatrixN<float,4> m1, m2;
+    m1.mult(VectorN<float,4>(a), VectorN<float,4>(b));
+    m2.mult(VectorN<float,4>(b), VectorN<float,4>(a));
+    m1.force_symmetry();
+    m2.force_symmetry();
+
+    // both give the average of the two, so must agree
+    const float x[4] {1, 0.25, -2, 0.5};
+    for (uint8_t k=0; k<4; k++) {
+        float e[4] {};
+        e[k] = 1;
+        VectorN<float,4> r1, r2;
+        r1.mult(m1, VectorN<float,4>(e));
+        r2.mult(m2, VectorN<float,4>(e));
+        EXPECT_FLOAT_EQ(r1 * VectorN<float,4>(x), r2 * VectorN<float,4>(x));
+    }
+}
+
+TEST(MatrixNTest, DotProduct)
+{
+    float a[24], b[24];
+    float expected = 0;
+    for (uint8_t i=0; i<24; i++) {
+        a[i] = i * 0.5f;
+        b[i] = 3 - i * 0.25f;
+        expected += a[i] * b[i];
+    }
+    EXPECT_FLOAT_EQ(expected, VectorN<float,24>(a) * VectorN<float,24>(b));
+}
+
+AP_GTEST_MAIN()
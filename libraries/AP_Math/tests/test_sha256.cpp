@@ -0,0 +1,85 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/sha256.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static void check_digest(const uint8_t *digest, const char *hex)
+{
+    char s[65];
+    for (uint8_t i=0; i<32; i++) {
+        snprintf(&s[i*2], 3, "%02x", digest[i]);
+    }
+    EXPECT_STREQ(hex, s);
+}
+
+static void hash_string(const char *str, uint8_t digest[32])
+{
+    sha256_ctx ctx;
+    sha256_init(ctx);
+    sha256_update(ctx, str, strlen(str));
+    sha256_final(ctx, digest, 32);
+}
+
+TEST(SHA256Test, FIPSVectors)
+{
+    uint8_t digest[32];
+
+    hash_string("", digest);
+    check_digest(digest, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    hash_string("abc", digest);
+    check_digest(digest, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    // 56 bytes, so the length goes in a second padding block
+    hash_string("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", digest);
+    check_digest(digest, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST(SHA256Test, MillionA)
+{
+    uint8_t buf[1000];
+    memset(buf, 'a', sizeof(buf));
+    sha256_ctx ctx;
+    sha256_init(ctx);
+    for (uint16_t i=0; i<1000; i++) {
+        sha256_update(ctx, buf, sizeof(buf));
+    }
+    uint8_t digest[32];
+    sha256_final(ctx, digest, 32);
+    check_digest(digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(SHA256Test, SplitUpdates)
+{
+    uint8_t buf[300];
+    for (uint16_t i=0; i<sizeof(buf); i++) {
+        buf[i] = i * 7 + 3;
+    }
+    uint8_t expected[32];
+    sha256_ctx ctx;
+    sha256_init(ctx);
+    sha256_update(ctx, buf, sizeof(buf));
+    sha256_final(ctx, expected, 32);
+
+    // any split of the input gives the same hash, as when signing
+    // a packet from its key, header, payload and signature parts
+    for (uint16_t split=0; split<=sizeof(buf); split += 7) {
+        uint8_t digest[32];
+        sha256_init(ctx);
+        sha256_update(ctx, buf, split);
+        sha256_update(ctx, &buf[split], sizeof(buf) - split);
+        sha256_final(ctx, digest, 32);
+        EXPECT_EQ(0, memcmp(expected, digest, 32));
+    }
+
+    // a short digest is the start of the full one
+    uint8_t digest[6];
+    sha256_init(ctx);
+    sha256_update(ctx, buf, sizeof(buf));
+    sha256_final(ctx, digest, sizeof(digest));
+    EXPECT_EQ(0, memcmp(expected, digest, sizeof(digest)));
+}
+
+AP_GTEST_MAIN()
@@ -21,265 +21,49 @@
 #include "AP_Math.h"
 #include <AP_InternalError/AP_InternalError.h>
 
-// rotate a vector by a standard rotation, attempting
-// to use the minimum number of floating point operations
+// rotate a vector by a standard rotation. This is called for every
+// sensor sample, so rather than switching on the rotation it looks up
+// the rotation matrix, leaving a single well predicted branch
 template <typename T>
 void Vector3<T>::rotate(enum Rotation rotation)
 {
-    T tmp;
-    switch (rotation) {
-    case ROTATION_NONE:
-        return;
-    case ROTATION_YAW_45: {
-        tmp = HALF_SQRT_2*(float)(x - y);
-        y   = HALF_SQRT_2*(float)(x + y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_YAW_90: {
-        tmp = x; x = -y; y = tmp;
-        return;
-    }
-    case ROTATION_YAW_135: {
-        tmp = -HALF_SQRT_2*(float)(x + y);
-        y   =  HALF_SQRT_2*(float)(x - y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_YAW_180:
-        x = -x; y = -y;
-        return;
-    case ROTATION_YAW_225: {
-        tmp = HALF_SQRT_2*(float)(y - x);
-        y   = -HALF_SQRT_2*(float)(x + y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_YAW_270: {
-        tmp = x; x = y; y = -tmp;
-        return;
-    }
-    case ROTATION_YAW_315: {
-        tmp = HALF_SQRT_2*(float)(x + y);
-        y   = HALF_SQRT_2*(float)(y - x);
-        x = tmp;
+    if (rotation == ROTATION_NONE) {
         return;
     }
-    case ROTATION_ROLL_180: {
-        y = -y; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_45: {
-        tmp = HALF_SQRT_2*(float)(x + y);
-        y   = HALF_SQRT_2*(float)(x - y);
-        x = tmp; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_90: {
-        tmp = x; x = y; y = tmp; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_135: {
-        tmp = HALF_SQRT_2*(float)(y - x);
-        y   = HALF_SQRT_2*(float)(y + x);
-        x = tmp; z = -z;
-        return;
-    }
-    case ROTATION_PITCH_180: {
-        x = -x; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_225: {
-        tmp = -HALF_SQRT_2*(float)(x + y);
-        y   =  HALF_SQRT_2*(float)(y - x);
-        x = tmp; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_270: {
-        tmp = x; x = -y; y = -tmp; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_180_YAW_315: {
-        tmp =  HALF_SQRT_2*(float)(x - y);
-        y   = -HALF_SQRT_2*(float)(x + y);
-        x = tmp; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_90: {
-        tmp = z; z = y; y = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_YAW_45: {
-        tmp = z; z = y; y = -tmp;
-        tmp = HALF_SQRT_2*(float)(x - y);
-        y   = HALF_SQRT_2*(float)(x + y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_YAW_90: {
-        tmp = z; z = y; y = -tmp;
-        tmp = x; x = -y; y = tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_YAW_135: {
-        tmp = z; z = y; y = -tmp;
-        tmp = -HALF_SQRT_2*(float)(x + y);
-        y   =  HALF_SQRT_2*(float)(x - y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_270: {
-        tmp = z; z = -y; y = tmp;
-        return;
-    }
-    case ROTATION_ROLL_270_YAW_45: {
-        tmp = z; z = -y; y = tmp;
-        tmp = HALF_SQRT_2*(float)(x - y);
-        y   = HALF_SQRT_2*(float)(x + y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_270_YAW_90: {
-        tmp = z; z = -y; y = tmp;
-        tmp = x; x = -y; y = tmp;
-        return;
-    }
-    case ROTATION_ROLL_270_YAW_135: {
-        tmp = z; z = -y; y = tmp;
-        tmp = -HALF_SQRT_2*(float)(x + y);
-        y   =  HALF_SQRT_2*(float)(x - y);
-        x = tmp;
-        return;
-    }
-    case ROTATION_PITCH_90: {
-        tmp = z; z = -x; x = tmp;
-        return;
-    }
-    case ROTATION_PITCH_270: {
-        tmp = z; z = x; x = -tmp;
-        return;
-    }
-    case ROTATION_PITCH_180_YAW_90: {
-        z = -z;
-        tmp = -x; x = -y; y = tmp;
-        return;
-    }
-    case ROTATION_PITCH_180_YAW_270: {
-        x = -x; z = -z;
-        tmp = x; x = y; y = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_90: {
-        tmp = z; z = y; y = -tmp;
-        tmp = z; z = -x; x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_180_PITCH_90: {
-        y = -y; z = -z;
-        tmp = z; z = -x; x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_270_PITCH_90: {
-        tmp = z; z = -y; y = tmp;
-        tmp = z; z = -x; x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_180: {
-        tmp = z; z = y; y = -tmp;
-        x = -x; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_270_PITCH_180: {
-        tmp = z; z = -y; y = tmp;
-        x = -x; z = -z;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_270: {
-        tmp = z; z = y; y = -tmp;
-        tmp = z; z = x; x = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_180_PITCH_270: {
-        y = -y; z = -z;
-        tmp = z; z = x; x = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_270_PITCH_270: {
-        tmp = z; z = -y; y = tmp;
-        tmp = z; z = x; x = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_180_YAW_90: {
-        tmp = z; z = y; y = -tmp;
-        x = -x; z = -z;
-        tmp = x; x = -y; y = tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_YAW_270: {
-        tmp = z; z = y; y = -tmp;
-        tmp = x; x = y; y = -tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_68_YAW_293: {
-        float tmpx = x;
-        float tmpy = y;
-        float tmpz = z;
-        x =  0.143039f * tmpx +  0.368776f * tmpy + -0.918446f * tmpz;
-        y = -0.332133f * tmpx + -0.856289f * tmpy + -0.395546f * tmpz;
-        z = -0.932324f * tmpx +  0.361625f * tmpy +  0.000000f * tmpz;
-        return;
-    }
-    case ROTATION_PITCH_315: {
-        tmp = HALF_SQRT_2*(float)(x - z);
-        z   = HALF_SQRT_2*(float)(x + z);
-        x = tmp;
-        return;
-    }
-    case ROTATION_ROLL_90_PITCH_315: {
-        tmp = z; z = y; y = -tmp;
-        tmp = HALF_SQRT_2*(float)(x - z);
-        z   = HALF_SQRT_2*(float)(x + z);
-        x = tmp;
-        return;
-    }
-    case ROTATION_PITCH_7: {
-        const float sin_pitch = 0.12186934340514748f; // sinf(pitch);
-        const float cos_pitch = 0.992546151641322f; // cosf(pitch);
-        float tmpx = x;
-        float tmpz = z;
-        x =  cos_pitch * tmpx + sin_pitch * tmpz;
-        z = -sin_pitch * tmpx + cos_pitch * tmpz;
-        return;
-    }
-    case ROTATION_CUSTOM: 
-        // Error: caller must perform custom rotations via matrix multiplication
-        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+    if (rotation >= ROTATION_MAX) {
+        if (rotation == ROTATION_CUSTOM) {
+            // Error: caller must perform custom rotations via matrix multiplication
+            INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        } else {
+            // rotation invalid
+            INTERNAL_ERROR(AP_InternalError::error_t::bad_rotation);
+        }
         return;
-    case ROTATION_MAX:
-        break;
     }
-    // rotation invalid
-    INTERNAL_ERROR(AP_InternalError::error_t::bad_rotation);
+    const float (&m)[3][3] = rotation_matrices[rotation];
+    const T vx = x, vy = y, vz = z;
+    x = m[0][0]*vx + m[0][1]*vy + m[0][2]*vz;
+    y = m[1][0]*vx + m[1][1]*vy + m[1][2]*vz;
+    z = m[2][0]*vx + m[2][1]*vy + m[2][2]*vz;
 }
 
 template <typename T>
 void Vector3<T>::rotate_inverse(enum Rotation rotation)
 {
-    Vector3<T> x_vec(1.0f,0.0f,0.0f);
-    Vector3<T> y_vec(0.0f,1.0f,0.0f);
-    Vector3<T> z_vec(0.0f,0.0f,1.0f);
-
-    x_vec.rotate(rotation);
-    y_vec.rotate(rotation);
-    z_vec.rotate(rotation);
-
-    Matrix3<T> M(
-        x_vec.x, y_vec.x, z_vec.x,
-        x_vec.y, y_vec.y, z_vec.y,
-        x_vec.z, y_vec.z, z_vec.z
-    );
-
-    (*this) = M.mul_transpose(*this);
+    if (rotation == ROTATION_NONE) {
+        return;
+    }
+    if (rotation >= ROTATION_MAX) {
+        // let rotate() report the error
+        rotate(rotation);
+        return;
+    }
+    // rotation matrices are orthogonal so the inverse is the transpose
+    const float (&m)[3][3] = rotation_matrices[rotation];
+    const T vx = x, vy = y, vz = z;
+    x = m[0][0]*vx + m[1][0]*vy + m[2][0]*vz;
+    y = m[0][1]*vx + m[1][1]*vy + m[2][1]*vz;
+    z = m[0][2]*vx + m[1][2]*vy + m[2][2]*vz;
 }
 
 // rotate vector by angle in radians in xy plane leaving z untouched
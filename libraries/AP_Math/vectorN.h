@@ -16,6 +16,8 @@
 
 #include <cmath>
 #include <string.h>
+#include <type_traits>
+#include <AP_HAL/AP_HAL_Boards.h>
 #include "matrixN.h"
 
 #ifndef MATH_CHECK_INDEXES
@@ -26,6 +28,39 @@
 #include <assert.h>
 #endif
 
+// use CMSIS-DSP kernels for float vectors and matrices where we link it
+#ifndef MATH_USE_CMSIS
+#define MATH_USE_CMSIS (HAL_WITH_DSP && CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS)
+#endif
+
+// below this size the CMSIS call overhead outweighs the gain over
+// loops the compiler can unroll
+#ifndef MATH_CMSIS_MIN_N
+#define MATH_CMSIS_MIN_N 8
+#endif
+
+#if MATH_USE_CMSIS
+#include <arm_math.h>
+
+namespace MathCMSIS {
+    // sum of a[i]*b[i]
+    inline float dot(const float *a, const float *b, uint16_t n) {
+        float ret;
+        arm_dot_prod_f32(a, b, n, &ret);
+        return ret;
+    }
+
+    // out (rows x cols) = a (rows x inner) * b (inner x cols)
+    inline void mat_mult(float *out, const float *a, const float *b, uint16_t rows, uint16_t inner, uint16_t cols) {
+        arm_matrix_instance_f32 ma, mb, mo;
+        arm_mat_init_f32(&ma, rows, inner, const_cast<float *>(a));
+        arm_mat_init_f32(&mb, inner, cols, const_cast<float *>(b));
+        arm_mat_init_f32(&mo, rows, cols, out);
+        arm_mat_mult_f32(&ma, &mb, &mo);
+    }
+}
+#endif
+
 template <typename T, uint8_t N>
 class MatrixN;
 
@@ -33,6 +68,8 @@ class MatrixN;
 template <typename T, uint8_t N>
 class VectorN
 {
+    friend class MatrixN<T,N>;
+
 public:
     // trivial ctor
     inline VectorN<T,N>() {
@@ -151,7 +188,12 @@ public:
 
     // dot product
     T operator *(const VectorN<T,N> &v) const {
-        float ret = 0;
+#if MATH_USE_CMSIS
+        if (std::is_same<T,float>::value && N >= MATH_CMSIS_MIN_N) {
+            return MathCMSIS::dot(reinterpret_cast<const float *>(_v), reinterpret_cast<const float *>(v._v), N);
+        }
+#endif
+        T ret = 0;
         for (uint8_t i=0; i<N; i++) {
             ret += _v[i] * v._v[i];
         }
@@ -161,6 +203,13 @@ public:
     // multiplication of a matrix by a vector, in-place
     // C = A * B
     void mult(const MatrixN<T,N> &A, const VectorN<T,N> &B) {
+#if MATH_USE_CMSIS
+        if (std::is_same<T,float>::value && N >= MATH_CMSIS_MIN_N) {
+            MathCMSIS::mat_mult(reinterpret_cast<float *>(_v), reinterpret_cast<const float *>(A.v),
+                                reinterpret_cast<const float *>(B._v), N, N, 1);
+            return;
+        }
+#endif
         for (uint8_t i = 0; i < N; i++) {
             _v[i] = 0;
             for (uint8_t k = 0; k < N; k++) {
@@ -33,6 +33,15 @@ const AP_Param::GroupInfo AP_Mission::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Mission, _options, AP_MISSION_OPTIONS_DEFAULT),
 
+    // @Param: CACHE
+    // @DisplayName: Mission command cache size
+    // @Description: Number of decoded mission commands kept in memory, which speeds up searches through large missions. Zero disables the cache.
+    // @Range: 0 1000
+    // @Increment: 1
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("CACHE",  3, AP_Mission, _cache_size, AP_MISSION_CACHE_SIZE_DEFAULT),
+
     AP_GROUPEND
 };
 
@@ -60,6 +69,15 @@ void AP_Mission::init()
         clear();
     }
 
+    // allocate the command cache, it does not need to be larger than the mission storage
+    const uint16_t cache_slots = MIN(uint16_t(MAX(_cache_size.get(), 0)), num_commands_max());
+    if (cache_slots > 0 && _cmd_cache == nullptr) {
+        _cmd_cache = new Mission_Command[cache_slots];
+        if (_cmd_cache != nullptr) {
+            _cmd_cache_slots = cache_slots;
+        }
+    }
+
     _last_change_time_ms = AP_HAL::millis();
 }
 
@@ -218,6 +236,7 @@ bool AP_Mission::clear()
 
     // remove all commands
     _cmd_total.set_and_save(0);
+    _land_markers.valid = false;
 
     // clear index to commands
     _nav_cmd.index = AP_MISSION_CMD_INDEX_NONE;
@@ -235,6 +254,7 @@ void AP_Mission::truncate(uint16_t index)
 {
     if ((unsigned)_cmd_total > index) {
         _cmd_total.set_and_save(index);
+        _land_markers.valid = false;
     }
 }
 
@@ -381,6 +401,38 @@ bool AP_Mission::replace_cmd(uint16_t index, const Mission_Command& cmd)
     return write_cmd_to_storage(index, cmd);
 }
 
+/// replace_mission - replaces the whole mission, including home at index 0, with count commands
+///     storage is written in blocks and the mission length is only updated once all commands are written
+///     returns false without changing the mission if there is not enough storage
+bool AP_Mission::replace_mission(const Mission_Command *cmds, uint16_t count)
+{
+    if (count > num_commands_max()) {
+        return false;
+    }
+
+    // hold the semaphore throughout so no reader sees a partly written mission
+    WITH_SEMAPHORE(_rsem);
+
+    const uint8_t block_cmds = 8;
+    uint8_t block[block_cmds * AP_MISSION_EEPROM_COMMAND_SIZE];
+    for (uint16_t index = 0; index < count; index += block_cmds) {
+        const uint16_t n = MIN(count - index, block_cmds);
+        for (uint16_t i = 0; i < n; i++) {
+            encode_cmd_for_storage(cmds[index + i], &block[i * AP_MISSION_EEPROM_COMMAND_SIZE]);
+            invalidate_cached_cmd(index + i);
+        }
+        _storage.write_block(4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE), block, n * AP_MISSION_EEPROM_COMMAND_SIZE);
+    }
+
+    _cmd_total.set_and_save(count);
+    _land_markers.valid = false;
+
+    // remember when the mission last changed
+    _last_change_time_ms = AP_HAL::millis();
+
+    return true;
+}
+
 /// is_nav_cmd - returns true if the command's id is a "navigation" command, false if "do" or "conditional" command
 bool AP_Mission::is_nav_cmd(const Mission_Command& cmd)
 {
@@ -661,6 +713,15 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+    Mission_Command *cached = nullptr;
+    if (_cmd_cache != nullptr) {
+        cached = &_cmd_cache[index % _cmd_cache_slots];
+        if (cached->index == index) {
+            cmd = *cached;
+            return true;
+        }
+    }
+
     // ensure all bytes of cmd are zeroed
     cmd = {};
 
@@ -671,15 +732,20 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
 
     PackedContent packed_content {};
 
-    const uint8_t b1 = _storage.read_byte(pos_in_storage);
+    // read the whole record in one go and decode it from RAM
+    uint8_t record[AP_MISSION_EEPROM_COMMAND_SIZE];
+    if (!_storage.read_block(record, pos_in_storage, sizeof(record))) {
+        return false;
+    }
+    const uint8_t b1 = record[0];
     if (b1 == 0) {
-        cmd.id = _storage.read_uint16(pos_in_storage+1);
-        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-        _storage.read_block(packed_content.bytes, pos_in_storage+5, 10);
+        memcpy(&cmd.id, &record[1], 2);
+        memcpy(&cmd.p1, &record[3], 2);
+        memcpy(packed_content.bytes, &record[5], 10);
     } else {
         cmd.id = b1;
-        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-        _storage.read_block(packed_content.bytes, pos_in_storage+3, 12);
+        memcpy(&cmd.p1, &record[1], 2);
+        memcpy(packed_content.bytes, &record[3], 12);
     }
 
     if (stored_in_location(cmd.id)) {
@@ -711,6 +777,10 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+    if (cached != nullptr) {
+        *cached = cmd;
+    }
+
     // return success
     return true;
 }
@@ -753,6 +823,25 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         return false;
     }
 
+    // calculate where in storage the command should be placed
+    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+
+    uint8_t record[AP_MISSION_EEPROM_COMMAND_SIZE];
+    encode_cmd_for_storage(cmd, record);
+    _storage.write_block(pos_in_storage, record, sizeof(record));
+
+    invalidate_cached_cmd(index);
+
+    // remember when the mission last changed
+    _last_change_time_ms = AP_HAL::millis();
+
+    // return success
+    return true;
+}
+
+// encode a command into its storage record
+void AP_Mission::encode_cmd_for_storage(const Mission_Command& cmd, uint8_t record[AP_MISSION_EEPROM_COMMAND_SIZE])
+{
     PackedContent packed {};
     if (stored_in_location(cmd.id)) {
         // Location is not PACKED; field-wise copy it:
@@ -771,26 +860,29 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         memcpy(packed.bytes, &cmd.content, 12);
     }
 
-    // calculate where in storage the command should be placed
-    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
-
     if (cmd.id < 256) {
-        _storage.write_byte(pos_in_storage, cmd.id);
-        _storage.write_uint16(pos_in_storage+1, cmd.p1);
-        _storage.write_block(pos_in_storage+3, packed.bytes, 12);
+        record[0] = cmd.id;
+        memcpy(&record[1], &cmd.p1, 2);
+        memcpy(&record[3], packed.bytes, 12);
     } else {
         // if the command ID is above 256 we store a 0 followed by the 16 bit command ID
-        _storage.write_byte(pos_in_storage, 0);
-        _storage.write_uint16(pos_in_storage+1, cmd.id);
-        _storage.write_uint16(pos_in_storage+3, cmd.p1);
-        _storage.write_block(pos_in_storage+5, packed.bytes, 10);
+        record[0] = 0;
+        memcpy(&record[1], &cmd.id, 2);
+        memcpy(&record[3], &cmd.p1, 2);
+        memcpy(&record[5], packed.bytes, 10);
     }
+}
 
-    // remember when the mission last changed
-    _last_change_time_ms = AP_HAL::millis();
-
-    // return success
-    return true;
+// forget any cached or indexed knowledge of the command at index
+void AP_Mission::invalidate_cached_cmd(uint16_t index)
+{
+    if (_cmd_cache != nullptr) {
+        Mission_Command &cached = _cmd_cache[index % _cmd_cache_slots];
+        if (cached.index == index) {
+            cached.index = 0;
+        }
+    }
+    _land_markers.valid = false;
 }
 
 /// write_home_to_storage - writes the special purpose cmd 0 (home) to storage
@@ -1990,18 +2082,16 @@ uint16_t AP_Mission::get_landing_sequence_start() const
 
     uint16_t landing_start_index = 0;
     float min_distance = -1;
+    const Location::DistanceFrom from_current{current_loc};
 
     // Go through mission looking for nearest landing start command
-    for (uint16_t i = 1; i < num_commands(); i++) {
-        Mission_Command tmp;
-        if (!read_cmd_from_storage(i, tmp)) {
-            continue;
-        }
+    Mission_Command tmp;
+    for (uint16_t i = 1; read_next_land_marker(i, tmp); i = tmp.index + 1) {
         if (tmp.id == MAV_CMD_DO_LAND_START) {
-            float tmp_distance = tmp.content.location.get_distance(current_loc);
+            float tmp_distance = from_current.get_distance(tmp.content.location);
             if (min_distance < 0 || tmp_distance < min_distance) {
                 min_distance = tmp_distance;
-                landing_start_index = i;
+                landing_start_index = tmp.index;
             }
         }
     }
@@ -2009,6 +2099,52 @@ uint16_t AP_Mission::get_landing_sequence_start() const
     return landing_start_index;
 }
 
+/*
+  read the next DO_LAND_START or DO_GO_AROUND command at or after
+  start_index, using the index of them built from the mission
+ */
+bool AP_Mission::read_next_land_marker(uint16_t start_index, Mission_Command &cmd) const
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (!_land_markers.valid || _land_markers.cmd_total != num_commands()) {
+        _land_markers.count = 0;
+        _land_markers.overflow = false;
+        for (uint16_t i = 1; i < num_commands(); i++) {
+            Mission_Command tmp;
+            if (!read_cmd_from_storage(i, tmp) ||
+                (tmp.id != MAV_CMD_DO_LAND_START && tmp.id != MAV_CMD_DO_GO_AROUND)) {
+                continue;
+            }
+            if (_land_markers.count >= ARRAY_SIZE(_land_markers.index)) {
+                _land_markers.overflow = true;
+                break;
+            }
+            _land_markers.index[_land_markers.count++] = i;
+        }
+        _land_markers.cmd_total = num_commands();
+        _land_markers.valid = true;
+    }
+
+    if (!_land_markers.overflow) {
+        for (uint8_t i = 0; i < _land_markers.count; i++) {
+            if (_land_markers.index[i] >= start_index && read_cmd_from_storage(_land_markers.index[i], cmd)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // too many to index, search the mission
+    for (uint16_t i = MAX(start_index, 1); i < num_commands(); i++) {
+        if (read_cmd_from_storage(i, cmd) &&
+            (cmd.id == MAV_CMD_DO_LAND_START || cmd.id == MAV_CMD_DO_GO_AROUND)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
    find the nearest landing sequence starting point (DO_LAND_START) and
    switch to that mission item.  Returns false if no DO_LAND_START
@@ -2041,17 +2177,15 @@ bool AP_Mission::jump_to_abort_landing_sequence(void)
     uint16_t abort_index = 0;
     if (AP::ahrs().get_position(current_loc)) {
         float min_distance = FLT_MAX;
+        const Location::DistanceFrom from_current{current_loc};
 
-        for (uint16_t i = 1; i < num_commands(); i++) {
-            Mission_Command tmp;
-            if (!read_cmd_from_storage(i, tmp)) {
-                continue;
-            }
+        Mission_Command tmp;
+        for (uint16_t i = 1; read_next_land_marker(i, tmp); i = tmp.index + 1) {
             if (tmp.id == MAV_CMD_DO_GO_AROUND) {
-                float tmp_distance = tmp.content.location.get_distance(current_loc);
+                float tmp_distance = from_current.get_distance(tmp.content.location);
                 if (tmp_distance < min_distance) {
                     min_distance = tmp_distance;
-                    abort_index = i;
+                    abort_index = tmp.index;
                 }
             }
         }
@@ -46,6 +46,18 @@
 #define AP_MISSION_MASK_CONTINUE_AFTER_LAND (1<<2)  // Allow mission to continue after land
 
 #define AP_MISSION_MAX_WP_HISTORY           7       // The maximum number of previous wp commands that will be stored from the active missions history
+
+#define AP_MISSION_MAX_LAND_MARKERS         16      // number of DO_LAND_START and DO_GO_AROUND commands that are indexed, more than this are searched for
+
+#ifndef AP_MISSION_CACHE_SIZE_DEFAULT
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MISSION_CACHE_SIZE_DEFAULT       256     // number of decoded commands kept in memory
+#elif HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define AP_MISSION_CACHE_SIZE_DEFAULT       64
+#else
+#define AP_MISSION_CACHE_SIZE_DEFAULT       0
+#endif
+#endif
 #define LAST_WP_PASSED (AP_MISSION_MAX_WP_HISTORY-2)
 
 /// @class    AP_Mission
@@ -417,6 +429,11 @@ public:
     ///     returns true if successfully replaced, false on failure
     bool replace_cmd(uint16_t index, const Mission_Command& cmd);
 
+    /// replace_mission - replaces the whole mission, including home at index 0, with count commands
+    ///     storage is written in blocks and the mission length is only updated once all commands are written
+    ///     returns false without changing the mission if there is not enough storage
+    bool replace_mission(const Mission_Command *cmds, uint16_t count);
+
     /// is_nav_cmd - returns true if the command's id is a "navigation" command, false if "do" or "conditional" command
     static bool is_nav_cmd(const Mission_Command& cmd);
 
@@ -685,6 +702,7 @@ private:
     AP_Int16                _cmd_total;  // total number of commands in the mission
     AP_Int16                _options;    // bitmask options for missions, currently for mission clearing on reboot but can be expanded as required
     AP_Int8                 _restart;   // controls mission starting point when entering Auto mode (either restart from beginning of mission or resume from last command run)
+    AP_Int16                _cache_size; // number of decoded commands to keep in memory
 
     // internal variables
     bool                    _force_resume;  // when set true it forces mission to resume irrespective of MIS_RESTART param.
@@ -706,6 +724,32 @@ private:
     // last time that mission changed
     uint32_t _last_change_time_ms;
 
+    // decoded commands, each held in the slot given by its index
+    // modulo the cache size. Empty slots have an index of zero as home
+    // is never cached
+    Mission_Command *_cmd_cache;
+    uint16_t _cmd_cache_slots;
+
+    // indexes of the DO_LAND_START and DO_GO_AROUND commands in
+    // mission order, rebuilt on the first search after the mission
+    // changes
+    mutable struct {
+        uint16_t index[AP_MISSION_MAX_LAND_MARKERS];
+        uint8_t count;
+        uint16_t cmd_total; // number of commands when the index was built
+        bool valid;
+        bool overflow;  // too many to index, searches read the mission
+    } _land_markers;
+
+    // read the next DO_LAND_START or DO_GO_AROUND at or after start_index
+    bool read_next_land_marker(uint16_t start_index, Mission_Command &cmd) const;
+
+    // forget any cached or indexed knowledge of the command at index
+    void invalidate_cached_cmd(uint16_t index);
+
+    // encode a command into its storage record
+    static void encode_cmd_for_storage(const Mission_Command& cmd, uint8_t record[AP_MISSION_EEPROM_COMMAND_SIZE]);
+
 
     // multi-thread support. This is static so it can be used from
     // const functions
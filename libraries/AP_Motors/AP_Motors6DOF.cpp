@@ -196,6 +196,28 @@ void AP_Motors6DOF::setup_motors(motor_frame_class frame_class, motor_frame_type
         add_motor_raw_6dof(AP_MOTORS_MOT_5,     0,              0,              0,              0,                  0,                  1.0f,           5);
         break;
     }
+
+    update_mix_matrix();
+}
+
+// pack the factors of the enabled motors into the mixing matrix used by
+// output_armed_stabilizing. Must be called after the motors are changed
+void AP_Motors6DOF::update_mix_matrix()
+{
+    _mix_count = 0;
+    for (uint8_t i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (!motor_enabled[i]) {
+            continue;
+        }
+        MixRow &row = _mix[_mix_count++];
+        row.motor = i;
+        row.factor[0] = _roll_factor[i];
+        row.factor[1] = _pitch_factor[i];
+        row.factor[2] = _yaw_factor[i];
+        row.factor[3] = _throttle_factor[i];
+        row.factor[4] = _forward_factor[i];
+        row.factor[5] = _lateral_factor[i];
+    }
 }
 
 void AP_Motors6DOF::add_motor_raw_6dof(int8_t motor_num, float roll_fac, float pitch_fac, float yaw_fac, float throttle_fac, float forward_fac, float lat_fac, uint8_t testing_order)
@@ -289,28 +311,18 @@ float AP_Motors6DOF::get_current_limit_max_throttle()
 // ToDo calculate headroom for rpy to be added for stabilization during full throttle/forward/lateral commands
 void AP_Motors6DOF::output_armed_stabilizing()
 {
+    // the current limit does not depend on this loop's outputs, so
+    // work it out first and apply it as the outputs are written
+    const float output_scale = calc_current_limit_scale();
+
     if ((sub_frame_t)_active_frame_class == SUB_FRAME_VECTORED) {
         output_armed_stabilizing_vectored();
     } else if ((sub_frame_t)_active_frame_class == SUB_FRAME_VECTORED_6DOF) {
         output_armed_stabilizing_vectored_6dof();
     } else {
-        uint8_t i;                          // general purpose counter
-        float   roll_thrust;                // roll thrust input value, +/- 1.0
-        float   pitch_thrust;               // pitch thrust input value, +/- 1.0
-        float   yaw_thrust;                 // yaw thrust input value, +/- 1.0
         float   throttle_thrust;            // throttle thrust input value, +/- 1.0
-        float   forward_thrust;             // forward thrust input value, +/- 1.0
-        float   lateral_thrust;             // lateral thrust input value, +/- 1.0
 
-        roll_thrust = (_roll_in + _roll_in_ff);
-        pitch_thrust = (_pitch_in + _pitch_in_ff);
-        yaw_thrust = (_yaw_in + _yaw_in_ff);
         throttle_thrust = get_throttle_bidirectional();
-        forward_thrust = _forward_in;
-        lateral_thrust = _lateral_in;
-
-        float rpy_out[AP_MOTORS_MAX_NUM_MOTORS]; // buffer so we don't have to multiply coefficients multiple times.
-        float linear_out[AP_MOTORS_MAX_NUM_MOTORS]; // 3 linear DOF mix for each motor
 
         // initialize limits flags
         limit.roll = false;
@@ -329,40 +341,50 @@ void AP_Motors6DOF::output_armed_stabilizing()
             limit.throttle_upper = true;
         }
 
-        // calculate roll, pitch and yaw for each motor
-        for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-            if (motor_enabled[i]) {
-                rpy_out[i] = roll_thrust * _roll_factor[i] +
-                             pitch_thrust * _pitch_factor[i] +
-                             yaw_thrust * _yaw_factor[i];
-
-            }
-        }
-
-        // calculate linear command for each motor
-        // linear factors should be 0.0 or 1.0 for now
-        for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-            if (motor_enabled[i]) {
-                linear_out[i] = throttle_thrust * _throttle_factor[i] +
-                                forward_thrust * _forward_factor[i] +
-                                lateral_thrust * _lateral_factor[i];
-            }
+        // roll, pitch, yaw, throttle, forward and lateral thrust inputs, +/- 1.0
+        const float thrust_in[6] {
+            _roll_in + _roll_in_ff,
+            _pitch_in + _pitch_in_ff,
+            _yaw_in + _yaw_in_ff,
+            throttle_thrust,
+            _forward_in,
+            _lateral_in
+        };
+
+        // mix, limit and scale each enabled motor in a single pass
+        for (uint8_t k=0; k<_mix_count; k++) {
+            const MixRow &row = _mix[k];
+            const float out = row.factor[0] * thrust_in[0] +
+                              row.factor[1] * thrust_in[1] +
+                              row.factor[2] * thrust_in[2] +
+                              row.factor[3] * thrust_in[3] +
+                              row.factor[4] * thrust_in[4] +
+                              row.factor[5] * thrust_in[5];
+            _thrust_rpyt_out[row.motor] = constrain_float(_motor_reverse[row.motor]*out, -1.0f, 1.0f) * output_scale;
         }
+        return;
+    }
 
-        // Calculate final output for each motor
-        for (i=0; i<AP_MOTORS_MAX_NUM_MOTORS; i++) {
-            if (motor_enabled[i]) {
-                _thrust_rpyt_out[i] = constrain_float(_motor_reverse[i]*(rpy_out[i] + linear_out[i]),-1.0f,1.0f);
-            }
+    if (is_equal(output_scale, 1.0f)) {
+        return;
+    }
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (motor_enabled[i]) {
+            _thrust_rpyt_out[i] *= output_scale;
         }
     }
+}
 
+// update the battery current limit, returning the scale to apply to
+// the motor outputs, 1.0 if current limiting is not enabled
+float AP_Motors6DOF::calc_current_limit_scale()
+{
     const AP_BattMonitor &battery = AP::battery();
 
 	// Current limiting
     float _batt_current;
     if (_batt_current_max <= 0.0f || !battery.current_amps(_batt_current)) {
-        return;
+        return 1.0f;
     }
 
     float _batt_current_delta = _batt_current - _batt_current_last;
@@ -387,11 +409,7 @@ void AP_Motors6DOF::output_armed_stabilizing()
 
     _output_limited = constrain_float(_output_limited, 0.0f, 1.0f);
 
-    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] *= _output_limited;
-        }
-    }
+    return _output_limited;
 }
 
 // output_armed - sends commands to the motors
@@ -65,6 +65,12 @@ protected:
     void output_armed_stabilizing_vectored();
     void output_armed_stabilizing_vectored_6dof();
 
+    // pack the enabled motors' factors into _mix
+    void update_mix_matrix();
+
+    // update the battery current limit and return the output scale
+    float calc_current_limit_scale();
+
     // Parameters
     AP_Int8             _motor_reverse[AP_MOTORS_MAX_NUM_MOTORS];
     AP_Float            _forwardVerticalCouplingFactor;
@@ -72,6 +78,14 @@ protected:
     float               _forward_factor[AP_MOTORS_MAX_NUM_MOTORS]; // each motors contribution to forward/backward
     float               _lateral_factor[AP_MOTORS_MAX_NUM_MOTORS];  // each motors contribution to lateral (left/right)
 
+    // packed mixing matrix, one row per enabled motor
+    struct MixRow {
+        float factor[6];    // roll, pitch, yaw, throttle, forward and lateral factors
+        uint8_t motor;      // motor number
+    };
+    MixRow              _mix[AP_MOTORS_MAX_NUM_MOTORS];
+    uint8_t             _mix_count;
+
     // current limiting
     float _output_limited = 1.0f;
     float _batt_current_last = 0.0f;
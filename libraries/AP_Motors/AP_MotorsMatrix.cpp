@@ -106,6 +106,7 @@ bool AP_MotorsMatrix::set_throttle_factor(int8_t motor_num, float throttle_facto
     }
 
     _throttle_factor[motor_num] = throttle_factor;
+    _packed.stale = true;
     return true;
 }
 
@@ -174,12 +175,16 @@ void AP_MotorsMatrix::output_to_motors()
             break;
     }
 
-    // convert output to PWM and send to each motor
+    // convert output to PWM and send to all motors in one call
+    uint16_t pwm[AP_MOTORS_MAX_NUM_MOTORS];
+    uint32_t motor_mask = 0;
     for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         if (motor_enabled[i]) {
-            rc_write(i, output_to_pwm(_actuator[i]));
+            pwm[i] = output_to_pwm(_actuator[i]);
+            motor_mask |= 1U << i;
         }
     }
+    rc_write_motors(pwm, motor_mask);
 }
 
 // get_motor_mask - returns a bitmask of which outputs are being used for motors (1 means being used)
@@ -204,7 +209,6 @@ uint16_t AP_MotorsMatrix::get_motor_mask()
 // includes new scaling stability patch
 void AP_MotorsMatrix::output_armed_stabilizing()
 {
-    uint8_t i;                          // general purpose counter
     float   roll_thrust;                // roll thrust input value, +/- 1.0
     float   pitch_thrust;               // pitch thrust input value, +/- 1.0
     float   yaw_thrust;                 // yaw thrust input value, +/- 1.0
@@ -264,31 +268,43 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // Octo-Quad (x8) + : MOT_YAW_HEADROOM = 300, ATC_RAT_RLL_IMAX = 0.5,   ATC_RAT_PIT_IMAX = 0.5,   ATC_RAT_YAW_IMAX = 0.25
     // Quads cannot make use of motor loss handling because it doesn't have enough degrees of freedom.
 
+    // the mix is done on the packed factors of the enabled motors, with
+    // thrust[] holding the output of each packed motor until the end
+    if (_packed.stale) {
+        update_packed_factors();
+    }
+    const uint8_t num_motors = _packed.count;
+    float thrust[AP_MOTORS_MAX_NUM_MOTORS];
+    int8_t lost = -1;   // packed index of the lost motor when thrust boost is enabled
+
     // calculate amount of yaw we can fit into the throttle range
     // this is always equal to or less than the requested yaw from the pilot or rate controller
     float rp_low = 1.0f;    // lowest thrust value
     float rp_high = -1.0f;  // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-            // record lowest roll + pitch command
-            if (_thrust_rpyt_out[i] < rp_low) {
-                rp_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch command
-            if (_thrust_rpyt_out[i] > rp_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rp_high = _thrust_rpyt_out[i];
-            }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        // calculate the thrust outputs for roll and pitch
+        thrust[k] = roll_thrust * _packed.roll[k] + pitch_thrust * _packed.pitch[k];
+        // record lowest roll + pitch command
+        if (thrust[k] < rp_low) {
+            rp_low = thrust[k];
+        }
+        if (_thrust_boost && _packed.motor[k] == _motor_lost_index) {
+            lost = k;
+            continue;
+        }
+        // record highest roll + pitch command
+        if (thrust[k] > rp_high) {
+            rp_high = thrust[k];
+        }
 
-            // Check the maximum yaw control that can be used on this channel
-            // Exclude any lost motors if thrust boost is enabled
-            if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)){
-                if (is_positive(yaw_thrust * _yaw_factor[i])) {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + _thrust_rpyt_out[i]), 0.0f)/_yaw_factor[i]));
-                } else {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + _thrust_rpyt_out[i], 0.0f)/_yaw_factor[i]));
-                }
+        // Check the maximum yaw control that can be used on this channel
+        // Exclude any lost motors if thrust boost is enabled
+        const float yaw_fac = _packed.yaw[k];
+        if (!is_zero(yaw_fac)) {
+            if (is_positive(yaw_thrust * yaw_fac)) {
+                yaw_allowed = MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + thrust[k]), 0.0f)/yaw_fac));
+            } else {
+                yaw_allowed = MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + thrust[k], 0.0f)/yaw_fac));
             }
         }
     }
@@ -304,19 +320,20 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     yaw_allowed = MAX(yaw_allowed, yaw_allowed_min);
 
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost && motor_enabled[_motor_lost_index]) {
+    if (lost >= 0) {
         // record highest roll + pitch command
-        if (_thrust_rpyt_out[_motor_lost_index] > rp_high) {
-            rp_high = _thrust_boost_ratio * rp_high + (1.0f - _thrust_boost_ratio) * _thrust_rpyt_out[_motor_lost_index];
+        if (thrust[lost] > rp_high) {
+            rp_high = _thrust_boost_ratio * rp_high + (1.0f - _thrust_boost_ratio) * thrust[lost];
         }
 
         // Check the maximum yaw control that can be used on this channel
         // Exclude any lost motors if thrust boost is enabled
-        if (!is_zero(_yaw_factor[_motor_lost_index])){
-            if (is_positive(yaw_thrust * _yaw_factor[_motor_lost_index])) {
-                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index]), 0.0f)/_yaw_factor[_motor_lost_index]));
+        const float yaw_fac = _packed.yaw[lost];
+        if (!is_zero(yaw_fac)){
+            if (is_positive(yaw_thrust * yaw_fac)) {
+                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + thrust[lost]), 0.0f)/yaw_fac));
             } else {
-                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + _thrust_rpyt_out[_motor_lost_index], 0.0f)/_yaw_factor[_motor_lost_index]));
+                yaw_allowed = _thrust_boost_ratio * yaw_allowed + (1.0f - _thrust_boost_ratio) * MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + thrust[lost], 0.0f)/yaw_fac));
             }
         }
     }
@@ -330,26 +347,24 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // add yaw control to thrust outputs
     float rpy_low = 1.0f;   // lowest thrust value
     float rpy_high = -1.0f; // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
+    for (uint8_t k = 0; k < num_motors; k++) {
+        thrust[k] += yaw_thrust * _packed.yaw[k];
 
-            // record lowest roll + pitch + yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch + yaw command
-            // Exclude any lost motors if thrust boost is enabled
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
+        // record lowest roll + pitch + yaw command
+        if (thrust[k] < rpy_low) {
+            rpy_low = thrust[k];
+        }
+        // record highest roll + pitch + yaw command
+        // Exclude any lost motors if thrust boost is enabled
+        if (thrust[k] > rpy_high && k != lost) {
+            rpy_high = thrust[k];
         }
     }
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
-    if (_thrust_boost) {
+    if (lost >= 0) {
         // record highest roll + pitch + yaw command
-        if (_thrust_rpyt_out[_motor_lost_index] > rpy_high && motor_enabled[_motor_lost_index]) {
-            rpy_high = _thrust_boost_ratio * rpy_high + (1.0f - _thrust_boost_ratio) * _thrust_rpyt_out[_motor_lost_index];
+        if (thrust[lost] > rpy_high) {
+            rpy_high = _thrust_boost_ratio * rpy_high + (1.0f - _thrust_boost_ratio) * thrust[lost];
         }
     }
 
@@ -389,10 +404,8 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
     const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    for (uint8_t k = 0; k < num_motors; k++) {
+        _thrust_rpyt_out[_packed.motor[k]] = (throttle_thrust_best_plus_adj * _packed.throttle[k]) + (rpy_scale * thrust[k]);
     }
 
     // determine throttle thrust for harmonic notch
@@ -524,6 +537,8 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
         // set order that motor appears in test
         _test_order[motor_num] = testing_order;
 
+        _packed.stale = true;
+
         // call parent class method
         add_motor_num(motor_num);
     }
@@ -557,6 +572,7 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
         _pitch_factor[motor_num] = 0.0f;
         _yaw_factor[motor_num] = 0.0f;
         _throttle_factor[motor_num] = 0.0f;
+        _packed.stale = true;
     }
 }
 
@@ -1093,6 +1109,27 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+    _packed.stale = true;
+}
+
+// pack the factors of the enabled motors so output_armed_stabilizing
+// only loops over motors that are in use
+void AP_MotorsMatrix::update_packed_factors()
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (!motor_enabled[i]) {
+            continue;
+        }
+        _packed.motor[n] = i;
+        _packed.roll[n] = _roll_factor[i];
+        _packed.pitch[n] = _pitch_factor[i];
+        _packed.yaw[n] = _yaw_factor[i];
+        _packed.throttle[n] = _throttle_factor[i];
+        n++;
+    }
+    _packed.count = n;
+    _packed.stale = false;
 }
 
 
@@ -1117,6 +1154,7 @@ void AP_MotorsMatrix::disable_yaw_torque(void)
     for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         _yaw_factor[i] = 0;
     }
+    _packed.stale = true;
 }
 
 // singleton instance
@@ -106,6 +106,9 @@ protected:
     // normalizes the roll, pitch and yaw factors so maximum magnitude is 0.5
     void                normalise_rpy_factors();
 
+    // pack the enabled motors' factors into _packed
+    void                update_packed_factors();
+
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
@@ -116,6 +119,18 @@ protected:
     float               _thrust_rpyt_out[AP_MOTORS_MAX_NUM_MOTORS]; // combined roll, pitch, yaw and throttle outputs to motors in 0~1 range
     uint8_t             _test_order[AP_MOTORS_MAX_NUM_MOTORS];  // order of the motors in the test sequence
 
+    // factors of the enabled motors only, packed for output_armed_stabilizing. Marked
+    // stale whenever the factors above change and repacked at the next output
+    struct {
+        float           roll[AP_MOTORS_MAX_NUM_MOTORS];
+        float           pitch[AP_MOTORS_MAX_NUM_MOTORS];
+        float           yaw[AP_MOTORS_MAX_NUM_MOTORS];
+        float           throttle[AP_MOTORS_MAX_NUM_MOTORS];
+        uint8_t         motor[AP_MOTORS_MAX_NUM_MOTORS];    // motor number of each packed entry
+        uint8_t         count;
+        bool            stale = true;
+    } _packed;
+
     // motor failure handling
     float               _thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];    // filtered thrust outputs with 1 second time constant
     uint8_t             _motor_lost_index;  // index number of the lost motor
@@ -95,6 +95,14 @@ void AP_Motors::rc_write(uint8_t chan, uint16_t pwm)
     SRV_Channels::set_output_pwm(function, pwm);
 }
 
+/*
+  write to a set of motor output channels, with pwm indexed by motor number
+ */
+void AP_Motors::rc_write_motors(const uint16_t *pwm, uint32_t motor_mask)
+{
+    SRV_Channels::set_output_pwm_motors(pwm, motor_mask);
+}
+
 /*
   write to an output channel for an angle actuator
  */
@@ -178,24 +178,67 @@ bool AP_Mount_Backend::calc_angle_to_sysid_target(Vector3f& angles_to_target_rad
                                   relative_pan);
 }
 
-// calc_angle_to_location - calculates the earth-frame roll, tilt and pan angles (and radians) to point at the given target
-bool AP_Mount_Backend::calc_angle_to_location(const struct Location &target, Vector3f& angles_to_target_rad, bool calc_tilt, bool calc_pan, bool relative_pan) const
+// update_target_cache - recalculate the target's offset from the EKF origin if the target, origin or home has moved
+bool AP_Mount_Backend::update_target_cache(const struct Location &target) const
 {
-    Location current_loc;
-    if (!AP::ahrs().get_position(current_loc)) {
+    const AP_AHRS &ahrs = AP::ahrs();
+    Location origin;
+    if (!ahrs.get_origin(origin)) {
         return false;
     }
-    const float GPS_vector_x = Location::diff_longitude(target.lng,current_loc.lng)*cosf(ToRad((current_loc.lat+target.lat)*0.00000005f))*0.01113195f;
-    const float GPS_vector_y = (target.lat-current_loc.lat)*0.01113195f;
-    int32_t target_alt_cm = 0;
-    if (!target.get_alt_cm(Location::AltFrame::ABOVE_HOME, target_alt_cm)) {
-        return false;
+    const int32_t home_alt_cm = ahrs.get_home().alt;
+    if (_target_cache.valid &&
+        _target_cache.target.same_latlon_as(target) &&
+        _target_cache.target.alt == target.alt &&
+        _target_cache.target.get_alt_frame() == target.get_alt_frame() &&
+        _target_cache.origin.same_latlon_as(origin) &&
+        _target_cache.home_alt_cm == home_alt_cm) {
+        return true;
     }
-    int32_t current_alt_cm = 0;
-    if (!current_loc.get_alt_cm(Location::AltFrame::ABOVE_HOME, current_alt_cm)) {
+    _target_cache.valid = false;
+    Vector2f ne_cm;
+    if (!target.get_vector_xy_from_origin_NE(ne_cm) ||
+        !target.get_alt_cm(Location::AltFrame::ABOVE_HOME, _target_cache.alt_cm)) {
         return false;
     }
-    float GPS_vector_z = target_alt_cm - current_alt_cm;
+    _target_cache.ne_m = ne_cm * 0.01f;
+    _target_cache.target = target;
+    _target_cache.origin = origin;
+    _target_cache.home_alt_cm = home_alt_cm;
+    _target_cache.valid = true;
+    return true;
+}
+
+// calc_angle_to_location - calculates the earth-frame roll, tilt and pan angles (and radians) to point at the given target
+bool AP_Mount_Backend::calc_angle_to_location(const struct Location &target, Vector3f& angles_to_target_rad, bool calc_tilt, bool calc_pan, bool relative_pan) const
+{
+    float GPS_vector_x, GPS_vector_y, GPS_vector_z;
+
+    // use the vehicle's position relative to the EKF origin so the target only needs converting when it moves
+    Vector2f vehicle_ne_m;
+    float vehicle_pos_d_m;
+    if (update_target_cache(target) && AP::ahrs().get_relative_position_NE_origin(vehicle_ne_m)) {
+        AP::ahrs().get_relative_position_D_home(vehicle_pos_d_m);
+        GPS_vector_x = _target_cache.ne_m.y - vehicle_ne_m.y;
+        GPS_vector_y = _target_cache.ne_m.x - vehicle_ne_m.x;
+        GPS_vector_z = _target_cache.alt_cm + vehicle_pos_d_m * 100.0f;
+    } else {
+        Location current_loc;
+        if (!AP::ahrs().get_position(current_loc)) {
+            return false;
+        }
+        GPS_vector_x = Location::diff_longitude(target.lng,current_loc.lng)*cosf(ToRad((current_loc.lat+target.lat)*0.00000005f))*0.01113195f;
+        GPS_vector_y = (target.lat-current_loc.lat)*0.01113195f;
+        int32_t target_alt_cm = 0;
+        if (!target.get_alt_cm(Location::AltFrame::ABOVE_HOME, target_alt_cm)) {
+            return false;
+        }
+        int32_t current_alt_cm = 0;
+        if (!current_loc.get_alt_cm(Location::AltFrame::ABOVE_HOME, current_alt_cm)) {
+            return false;
+        }
+        GPS_vector_z = target_alt_cm - current_alt_cm;
+    }
     float target_distance = 100.0f*norm(GPS_vector_x, GPS_vector_y);      // Careful , centimeters here locally. Baro/alt is in cm, lat/lon is in meters.
 
     // initialise all angles to zero
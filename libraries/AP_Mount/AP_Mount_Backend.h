@@ -125,6 +125,20 @@ protected:
 private:
 
     void rate_input_rad(float &out, const RC_Channel *ch, float min, float max) const;
+
+    // update the cached target offset from the EKF origin, returns false if it can't be calculated
+    bool update_target_cache(const struct Location &target) const;
+
+    // position of the last target relative to the EKF origin, so the
+    // location maths is only done when the target, origin or home moves
+    mutable struct {
+        Location target;
+        Location origin;
+        int32_t home_alt_cm;
+        Vector2f ne_m;          // target offset north and east of the EKF origin in meters
+        int32_t alt_cm;         // target altitude above home in cm
+        bool valid;
+    } _target_cache;
 };
 
 #endif // HAL_MOUNT_ENABLED
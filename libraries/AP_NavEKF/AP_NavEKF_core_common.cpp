@@ -16,10 +16,21 @@
  */
 #include "AP_NavEKF_core_common.h"
 
-NavEKF_core_common::Matrix24 NavEKF_core_common::KH;
-NavEKF_core_common::Matrix24 NavEKF_core_common::KHP;
-NavEKF_core_common::Matrix24 NavEKF_core_common::nextP;
-NavEKF_core_common::Vector28 NavEKF_core_common::Kfusion;
+#if HAL_NAVEKF_SHARED_SCRATCH
+NavEKF_core_common::Matrix24 NavEKF_core_common::KH EKF_ALIGNED;
+NavEKF_core_common::Matrix24 NavEKF_core_common::KHP EKF_ALIGNED;
+NavEKF_core_common::Matrix24 NavEKF_core_common::nextP EKF_ALIGNED;
+NavEKF_core_common::Vector28 NavEKF_core_common::Kfusion EKF_ALIGNED;
+#endif
+
+/*
+  zero part of an array, sized by ftype so it is correct for both
+  float and double builds
+ */
+void NavEKF_core_common::zero_range(ftype *v, uint8_t n1, uint8_t n2)
+{
+    memset(&v[n1], 0, sizeof(ftype)*(1+n2-n1));
+}
 
 /*
   fill common scratch variables, for detecting re-use of variables between loops in SITL
@@ -31,9 +42,9 @@ void NavEKF_core_common::fill_scratch_variables(void)
     // SITL where they are used without initialisation. These are all
     // supposed to be scratch variables that are not used between
     // iterations
-    fill_nanf(&KH[0][0], sizeof(KH)/sizeof(float));
-    fill_nanf(&KHP[0][0], sizeof(KHP)/sizeof(float));
-    fill_nanf(&nextP[0][0], sizeof(nextP)/sizeof(float));
-    fill_nanf(&Kfusion[0], sizeof(Kfusion)/sizeof(float));
+    fill_nanf(&KH[0][0], sizeof(KH)/sizeof(ftype));
+    fill_nanf(&KHP[0][0], sizeof(KHP)/sizeof(ftype));
+    fill_nanf(&nextP[0][0], sizeof(nextP)/sizeof(ftype));
+    fill_nanf(&Kfusion[0], sizeof(Kfusion)/sizeof(ftype));
 #endif
 }
@@ -17,9 +17,40 @@
 #pragma once
 
 #include <stdint.h>
+#include <AP_HAL/AP_HAL_Boards.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
 
+/*
+  by default the scratch variables are shared between all EKF
+  cores. Boards which run EKF lanes on separate threads need a copy
+  per core
+ */
+#ifndef HAL_NAVEKF_SHARED_SCRATCH
+#define HAL_NAVEKF_SHARED_SCRATCH (CONFIG_HAL_BOARD != HAL_BOARD_LINUX)
+#endif
+
+#if HAL_NAVEKF_SHARED_SCRATCH
+#define EKF_SCRATCH static
+#else
+#define EKF_SCRATCH
+#endif
+
+/*
+  EKF3 covariance arithmetic can be done in double precision on boards
+  with a double precision FPU. The state vector itself stays in float
+ */
+#ifndef HAL_WITH_EKF_DOUBLE
+#define HAL_WITH_EKF_DOUBLE 0
+#endif
+
+/*
+  matrix storage is aligned so the compiler can use vector loads and
+  stores for the covariance loops on boards that have them
+ */
+#define EKF_STORAGE_ALIGN 16
+#define EKF_ALIGNED __attribute__((aligned(EKF_STORAGE_ALIGN)))
+
 /*
   this declares a common parent class for AP_NavEKF2 and
   AP_NavEKF3. The purpose of this class is to hold common static
@@ -32,7 +63,11 @@
  */
 class NavEKF_core_common {
 public:
+#if HAL_WITH_EKF_DOUBLE
+    typedef double ftype;
+#else
     typedef float ftype;
+#endif
 #if MATH_CHECK_INDEXES
     typedef VectorN<ftype,28> Vector28;
     typedef VectorN<VectorN<ftype,24>,24> Matrix24;
@@ -42,11 +77,92 @@ public:
 #endif
 
 protected:
-    static Matrix24 KH;                   // intermediate result used for covariance updates
-    static Matrix24 KHP;                  // intermediate result used for covariance updates
-    static Matrix24 nextP;                // Predicted covariance matrix before addition of process noise to diagonals
-    static Vector28 Kfusion;              // intermediate fusion vector
+    EKF_SCRATCH Matrix24 KH EKF_ALIGNED;      // intermediate result used for covariance updates
+    EKF_SCRATCH Matrix24 KHP EKF_ALIGNED;     // intermediate result used for covariance updates
+    EKF_SCRATCH Matrix24 nextP EKF_ALIGNED;   // Predicted covariance matrix before addition of process noise to diagonals
+    EKF_SCRATCH Vector28 Kfusion EKF_ALIGNED; // intermediate fusion vector
 
     // fill all the common scratch variables with NaN on SITL
     void fill_scratch_variables(void);
+
+    // zero elements n1 to n2 inclusive of an array of ftype
+    void zero_range(ftype *v, uint8_t n1, uint8_t n2);
+
+    /*
+      kernels shared by EKF2 and EKF3 so a build with both only has
+      one copy. They are templates on the covariance matrix and
+      Jacobian types as EKF2 is always single precision and EKF3
+      may not be
+     */
+
+    // make the first n states of P symmetrical
+    template <typename Matrix>
+    static void force_symmetry(Matrix &P, uint8_t n);
+
+    // covariance update P = (I - K*H)*P for fusion of a scalar
+    // observation with Jacobian H and the gains in Kfusion
+    template <typename Matrix, typename Vector>
+    bool fuse_scalar_covariance(Matrix &P, const Vector &H, uint8_t n, bool checkVariances);
 };
+
+template <typename Matrix>
+void NavEKF_core_common::force_symmetry(Matrix &P, uint8_t n)
+{
+    for (uint8_t i=1; i<n; i++) {
+        for (uint8_t j=0; j<i; j++) {
+            const auto temp = 0.5f*(P[i][j] + P[j][i]);
+            P[i][j] = temp;
+            P[j][i] = temp;
+        }
+    }
+}
+
+/*
+  only the non-zero elements of H are used, so this costs one pass
+  over P rather than forming K*H*P, and symmetry is forced in the same
+  pass. n is the number of active states.
+  If checkVariances is true and the update would drive a variance
+  negative then P is left unchanged and false is returned
+ */
+template <typename Matrix, typename Vector>
+bool NavEKF_core_common::fuse_scalar_covariance(Matrix &P, const Vector &H, uint8_t n, bool checkVariances)
+{
+    // find the non-zero elements of the observation Jacobian
+    uint8_t hIndex[24];
+    uint8_t hCount = 0;
+    for (uint8_t k=0; k<24; k++) {
+        if (!is_zero(H[k])) {
+            hIndex[hCount++] = k;
+        }
+    }
+
+    // H*P, which is the only row we need as K*H*P = K * (H*P)
+    ftype HP[24];
+    for (uint8_t j=0; j<n; j++) {
+        ftype res = 0;
+        for (uint8_t k=0; k<hCount; k++) {
+            res += H[hIndex[k]] * P[hIndex[k]][j];
+        }
+        HP[j] = res;
+    }
+
+    // Check that we are not going to drive any variances negative and skip the update if so
+    if (checkVariances) {
+        for (uint8_t i=0; i<n; i++) {
+            if (Kfusion[i] * HP[i] > P[i][i]) {
+                return false;
+            }
+        }
+    }
+
+    // update the covariance matrix, averaging the off-diagonals to keep it symmetrical
+    for (uint8_t i=0; i<n; i++) {
+        P[i][i] -= Kfusion[i] * HP[i];
+        for (uint8_t j=0; j<i; j++) {
+            const ftype temp = 0.5f*(P[i][j] + P[j][i] - Kfusion[i] * HP[j] - Kfusion[j] * HP[i]);
+            P[i][j] = temp;
+            P[j][i] = temp;
+        }
+    }
+    return true;
+}
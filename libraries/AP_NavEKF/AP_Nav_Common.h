@@ -77,4 +77,8 @@ struct ekf_timing {
     float delVelDT_min;
 };
 
+// number of yaw hypotheses in the EKF-GSF yaw estimator. More models
+// give faster convergence at the cost of CPU, only the first 5 are logged
+#ifndef N_MODELS_EKFGSF
 #define N_MODELS_EKFGSF 5U
+#endif
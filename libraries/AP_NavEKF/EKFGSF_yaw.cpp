@@ -92,6 +92,8 @@ void EKFGSF_yaw::update(const Vector3f &delAng,
         accel_gain = 0.0f;
     }
 
+    calcCommonPredictValues();
+
     // Always run the AHRS prediction cycle for each model
     for (uint8_t mdl_idx = 0; mdl_idx < N_MODELS_EKFGSF; mdl_idx ++) {
         predict(mdl_idx);
@@ -192,42 +194,55 @@ void EKFGSF_yaw::fuseVelData(const Vector2f &vel, const float velAcc)
     }
 }
 
-void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
+/*
+  calculate the parts of the AHRS and EKF predictions that do not
+  depend on the model, so the per-model loops only carry the work that
+  differs between yaw hypotheses
+ */
+void EKFGSF_yaw::calcCommonPredictValues()
 {
-    // Generate attitude solution using simple complementary filter for the selected model
-
-    // Calculate 'k' unit vector of earth frame rotated into body frame
-    const Vector3f k(AHRS[mdl_idx].R[2][0], AHRS[mdl_idx].R[2][1], AHRS[mdl_idx].R[2][2]);
-
     // Calculate angular rate vector in rad/sec averaged across last sample interval
-    Vector3f ang_rate_delayed_raw = delta_angle / angle_dt;
+    ang_rate = delta_angle / angle_dt;
 
     // Perform angular rate correction using accel data and reduce correction as accel magnitude moves away from 1 g (reduces drift when vehicle picked up and moved).
     // During fixed wing flight, compensate for centripetal acceleration assuming coordinated turns and X axis forward
-
-    Vector3f tilt_error_gyro_correction = {}; // (rad/sec)
-
+    tilt_accel.zero();
     if (accel_gain > 0.0f) {
-
-        Vector3f accel = ahrs_accel;
+        tilt_accel = ahrs_accel;
 
         if (is_positive(true_airspeed)) {
             // Calculate centripetal acceleration in body frame from cross product of body rate and body frame airspeed vector
             // NOTE: this assumes X axis is aligned with airspeed vector
-            Vector3f centripetal_accel_vec_bf = Vector3f(0.0f, ang_rate_delayed_raw[2] * true_airspeed, - ang_rate_delayed_raw[1] * true_airspeed);
+            Vector3f centripetal_accel_vec_bf = Vector3f(0.0f, ang_rate[2] * true_airspeed, - ang_rate[1] * true_airspeed);
 
             // Correct measured accel for centripetal acceleration
-            accel -= centripetal_accel_vec_bf;
+            tilt_accel -= centripetal_accel_vec_bf;
         }
 
-        tilt_error_gyro_correction = (k % accel) * (accel_gain / ahrs_accel_norm);
-
+        tilt_accel *= accel_gain / ahrs_accel_norm;
     }
 
+    // Gyro bias estimation is only done at low rates
+    learn_gyro_bias = ang_rate.length() < 0.175f;
+
+    // Use fixed values for delta velocity and delta angle process noise variances
+    dvel_var = sq(EKFGSF_accelNoise * velocity_dt);
+    dang_var = sq(EKFGSF_gyroNoise * angle_dt);
+}
+
+void EKFGSF_yaw::predictAHRS(const uint8_t mdl_idx)
+{
+    // Generate attitude solution using simple complementary filter for the selected model
+
+    // Calculate 'k' unit vector of earth frame rotated into body frame
+    const Vector3f k(AHRS[mdl_idx].R[2][0], AHRS[mdl_idx].R[2][1], AHRS[mdl_idx].R[2][2]);
+
+    // tilt error correction (rad/sec), the accel gain has already been applied to tilt_accel
+    const Vector3f tilt_error_gyro_correction = k % tilt_accel;
+
     // Gyro bias estimation
-    const float gyro_bias_limit = radians(5.0f);
-    const float spinRate = ang_rate_delayed_raw.length();
-    if (spinRate < 0.175f) {
+    if (learn_gyro_bias) {
+        const float gyro_bias_limit = radians(5.0f);
         AHRS[mdl_idx].gyro_bias -= tilt_error_gyro_correction * (EKFGSF_gyroBiasGain * angle_dt);
 
         for (uint8_t i = 0; i < 3; i++) {
@@ -327,10 +342,13 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
         EKF[mdl_idx].X[2] = atan2f(-AHRS[mdl_idx].R[0][1], AHRS[mdl_idx].R[1][1]); // first rotation (yaw)
     }
 
+    const float t2 = sinf(EKF[mdl_idx].X[2]);
+    const float t3 = cosf(EKF[mdl_idx].X[2]);
+
     // calculate delta velocity in a horizontal front-right frame
     const Vector3f del_vel_NED = AHRS[mdl_idx].R * delta_velocity;
-    const float dvx =   del_vel_NED[0] * cosf(EKF[mdl_idx].X[2]) + del_vel_NED[1] * sinf(EKF[mdl_idx].X[2]);
-    const float dvy = - del_vel_NED[0] * sinf(EKF[mdl_idx].X[2]) + del_vel_NED[1] * cosf(EKF[mdl_idx].X[2]);
+    const float dvx =   del_vel_NED[0] * t3 + del_vel_NED[1] * t2;
+    const float dvy = - del_vel_NED[0] * t2 + del_vel_NED[1] * t3;
 
     // sum delta velocities in earth frame:
     EKF[mdl_idx].X[0] += del_vel_NED[0];
@@ -351,12 +369,10 @@ void EKFGSF_yaw::predict(const uint8_t mdl_idx)
     const float P22 = EKF[mdl_idx].P[2][2];
 
     // Use fixed values for delta velocity and delta angle process noise variances
-    const float dvxVar = sq(EKFGSF_accelNoise * velocity_dt); // variance of forward delta velocity - (m/s)^2
-    const float dvyVar = dvxVar; // variance of right delta velocity - (m/s)^2
-    const float dazVar = sq(EKFGSF_gyroNoise * angle_dt); // variance of yaw delta angle - rad^2
+    const float dvxVar = dvel_var; // variance of forward delta velocity - (m/s)^2
+    const float dvyVar = dvel_var; // variance of right delta velocity - (m/s)^2
+    const float dazVar = dang_var; // variance of yaw delta angle - rad^2
 
-    const float t2 = sinf(EKF[mdl_idx].X[2]);
-    const float t3 = cosf(EKF[mdl_idx].X[2]);
     const float t4 = dvy*t3;
     const float t5 = dvx*t2;
     const float t6 = t4+t5;
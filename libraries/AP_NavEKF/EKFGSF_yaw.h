@@ -87,6 +87,16 @@ private:
     float ahrs_accel_norm;          // length of body frame specific force vector used by AHRS calculation (m/s/s)
     float true_airspeed;            // true airspeed used to correct for centripetal acceleratoin in coordinated turns (m/s)
 
+    // Values that are the same for every model, calculated once per update
+    Vector3f ang_rate;              // angular rate vector averaged across last sample interval (rad/sec)
+    Vector3f tilt_accel;            // ahrs_accel scaled by accel_gain / ahrs_accel_norm, with centripetal correction (m/s/s)
+    bool learn_gyro_bias;           // true when body rates are low enough for gyro bias learning
+    float dvel_var;                 // variance of horizontal front and right delta velocity (m/s)^2
+    float dang_var;                 // variance of yaw delta angle (rad^2)
+
+    // Calculates the values shared by the AHRS and EKF predictions for all models
+    void calcCommonPredictValues();
+
     // Runs quaternion prediction for the selected AHRS using IMU (and optionally true airspeed) data
     void predictAHRS(const uint8_t mdl_idx);
 
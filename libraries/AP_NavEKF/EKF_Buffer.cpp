@@ -8,6 +8,36 @@
 #include <string.h>
 #include <AP_InternalError/AP_InternalError.h>
 
+void EKF_buffer_arena::start_sizing(void)
+{
+    memory = nullptr;
+    length = 0;
+    used = 0;
+}
+
+void EKF_buffer_arena::start_alloc(void *mem, uint32_t len)
+{
+    memory = (uint8_t *)mem;
+    length = len;
+    used = 0;
+}
+
+void *EKF_buffer_arena::alloc(uint32_t n, uint8_t elsize)
+{
+    // keep each buffer 8 byte aligned
+    const uint32_t len = (n*elsize + 7U) & ~7U;
+    void *ret = nullptr;
+    if (memory != nullptr) {
+        if (used + len > length) {
+            return nullptr;
+        }
+        ret = &memory[used];
+        memset(ret, 0, len);
+    }
+    used += len;
+    return ret;
+}
+
 // constructor
 ekf_ring_buffer::ekf_ring_buffer(uint8_t _elsize) :
     elsize(_elsize)
@@ -22,11 +52,27 @@ bool ekf_ring_buffer::init(uint8_t size)
     if (buffer == nullptr) {
         return false;
     }
+    init_indexes(size);
+    return true;
+}
+
+// initialise using space from an arena, which owns the memory
+bool ekf_ring_buffer::init(uint8_t size, EKF_buffer_arena &arena)
+{
+    buffer = arena.alloc(size, elsize);
+    if (buffer == nullptr) {
+        return arena.sizing();
+    }
+    init_indexes(size);
+    return true;
+}
+
+void ekf_ring_buffer::init_indexes(uint8_t size)
+{
     _size = size;
     _head = 0;
     _tail = 0;
     _new_data = false;
-    return true;
 }
 
 /*
@@ -47,12 +93,13 @@ uint32_t &ekf_ring_buffer::time_ms(uint8_t idx)
 }
 
 /*
-  Search through a ring buffer and return the newest data that is
-  older than the time specified by sample_time_ms Zeros old data
-  so it cannot not be used again Returns false if no data can be
-  found that is less than 100msec old
+  Search through a ring buffer for the newest data that is older than
+  the time specified by sample_time_ms, returning its index. Returns
+  false if no data can be found that is less than 100msec old. The
+  buffer is in time order and the sample time only moves forward, so
+  data that is skipped over is never scanned again
 */
-bool ekf_ring_buffer::recall(void *element,uint32_t sample_time)
+bool ekf_ring_buffer::recall_index(uint8_t &idx, uint32_t sample_time)
 {
     if (!_new_data) {
         return false;
@@ -83,34 +130,35 @@ bool ekf_ring_buffer::recall(void *element,uint32_t sample_time)
             }
             tail = (tail+1) % _size;
         }
+        if (!success) {
+            // everything we passed over is used or stale
+            _tail = tail;
+        }
     }
 
     if (!success) {
         return false;
     }
 
-    memcpy(element, get_offset(bestIndex), elsize);
+    idx = bestIndex;
     _tail = (bestIndex+1) % _size;
-    // make time zero to stop using it again,
-    // resolves corner case of reusing the element when head == tail
-    time_ms(bestIndex) = 0;
     return true;
 }
 
 /*
- * Writes data and timestamp to a Ring buffer and advances indices that
- * define the location of the newest and oldest data
+ * Advances the indices that define the location of the newest and
+ * oldest data, returning the element for the new data
  */
-void ekf_ring_buffer::push(const void *element)
+void *ekf_ring_buffer::push_slot()
 {
     if (buffer == nullptr) {
-        return;
+        return nullptr;
     }
     // Advance head to next available index
     _head = (_head+1) % _size;
     // New data is written at the head
-    memcpy(get_offset(_head), element, elsize);
     _new_data = true;
+    return get_offset(_head);
 }
 
 
@@ -159,43 +207,47 @@ bool ekf_imu_buffer::init(uint32_t size)
     return true;
 }
 
+// initialise using space from an arena, which owns the memory
+bool ekf_imu_buffer::init(uint32_t size, EKF_buffer_arena &arena)
+{
+    buffer = arena.alloc(size, elsize);
+    if (buffer == nullptr) {
+        return arena.sizing();
+    }
+    _size = size;
+    _youngest = 0;
+    _oldest = 0;
+    return true;
+}
+
 /*
-  Writes data to a Ring buffer and advances indices that
-  define the location of the newest and oldest data
+  Advances the indices that define the location of the newest and
+  oldest data, returning the element for the new data
 */
-void ekf_imu_buffer::push_youngest_element(const void *element)
+void *ekf_imu_buffer::push_youngest_slot()
 {
     if (!buffer) {
         INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
-        return;
+        return nullptr;
     }
     // push youngest to the buffer
     _youngest = (_youngest+1) % _size;
-    memcpy(get_offset(_youngest), element, elsize);
     // set oldest data index
     _oldest = (_youngest+1) % _size;
     if (_oldest == 0) {
         _filled = true;
     }
+    return get_offset(_youngest);
 }
 
-// retrieve the oldest data from the ring buffer tail
-void ekf_imu_buffer::get_oldest_element(void *element)
+// the oldest data in the ring buffer tail
+void *ekf_imu_buffer::get_oldest_slot() const
 {
     if (buffer == nullptr) {
         INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
-        memset(element, 0, elsize);
-    } else {
-        memcpy(element, get_offset(_oldest), elsize);
-    }
-}
-
-// writes the same data to all elements in the ring buffer
-void ekf_imu_buffer::reset_history(const void *element)
-{
-    for (uint8_t index=0; index<_size; index++) {
-        memcpy(get_offset(index), element, elsize);
+        return nullptr;
     }
+    return get_offset(_oldest);
 }
 
 // zeroes all data in the ring buffer
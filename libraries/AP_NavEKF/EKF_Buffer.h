@@ -6,6 +6,42 @@
 #include <stdint.h>
 #include <type_traits>
 
+/*
+  memory shared by the buffers of one EKF core so they are allocated
+  in one block, next to each other. The buffers are first initialised
+  with the arena sizing, which counts the space they need, and then
+  again once the arena has been given that much memory. A buffer
+  initialised from an arena must always be initialised from it
+ */
+class EKF_buffer_arena
+{
+public:
+    // start counting the space needed by buffers
+    void start_sizing(void);
+
+    // start handing out space from len bytes at mem
+    void start_alloc(void *mem, uint32_t len);
+
+    // true if only counting space
+    bool sizing(void) const {
+        return memory == nullptr;
+    }
+
+    // space used since the last start
+    uint32_t get_used(void) const {
+        return used;
+    }
+
+    // zeroed space for n elements of elsize bytes, nullptr if sizing
+    // or out of space
+    void *alloc(uint32_t n, uint8_t elsize);
+
+private:
+    uint8_t *memory;
+    uint32_t length;
+    uint32_t used;
+};
+
 typedef struct {
     // measurement timestamp (msec)
     uint32_t    time_ms;
@@ -13,7 +49,8 @@ typedef struct {
 
 // this class is to be used for observation buffers, the data is
 // pushed into buffer like any standard ring buffer return is based on
-// the sample time provided
+// the sample time provided. Elements are only accessed through
+// EKF_obs_buffer_t which knows their type
 class ekf_ring_buffer
 {
 public:
@@ -21,23 +58,26 @@ public:
 
     // initialise buffer, returns false when allocation has failed
     bool init(uint8_t size);
+    bool init(uint8_t size, EKF_buffer_arena &arena);
+
+    // zeroes all data in the ring buffer
+    void reset();
 
+protected:
     /*
-     * Searches through a ring buffer and return the newest data that is older than the
-     * time specified by sample_time_ms
-     * Zeros old data so it cannot not be used again
+     * Searches through a ring buffer for the newest data that is older than the
+     * time specified by sample_time_ms, returning its index and moving the tail past it
      * Returns false if no data can be found that is less than 100msec old
     */
-    bool recall(void *element, uint32_t sample_time);
+    bool recall_index(uint8_t &idx, uint32_t sample_time);
 
     /*
-     * Writes data and timestamp to a Ring buffer and advances indices that
-     * define the location of the newest and oldest data
+     * Advances the indices that define the location of the newest and oldest data
+     * and returns the element to write the new data to, or nullptr if not allocated
     */
-    void push(const void *element);
+    void *push_slot();
 
-    // zeroes all data in the ring buffer
-    void reset();
+    void *get_offset(uint8_t idx) const;
 
 private:
     const uint8_t elsize;
@@ -45,7 +85,8 @@ private:
     uint8_t _size, _head, _tail, _new_data;
 
     uint32_t &time_ms(uint8_t idx);
-    void *get_offset(uint8_t idx) const;
+
+    void init_indexes(uint8_t size);
 };
 
 /*
@@ -66,13 +107,37 @@ public:
     bool init(uint8_t size) {
         return ekf_ring_buffer::init(size);
     }
+    bool init(uint8_t size, EKF_buffer_arena &arena) {
+        return ekf_ring_buffer::init(size, arena);
+    }
 
+    /*
+     * Return the newest data that is older than the time specified by sample_time_ms
+     * Zeros old data so it cannot not be used again
+     * Returns false if no data can be found that is less than 100msec old
+    */
     bool recall(element_type &element,uint32_t sample_time) {
-        return ekf_ring_buffer::recall(&element, sample_time);
+        uint8_t idx;
+        if (!recall_index(idx, sample_time)) {
+            return false;
+        }
+        element_type &el = *(element_type *)get_offset(idx);
+        element = el;
+        // make time zero to stop using it again,
+        // resolves corner case of reusing the element when head == tail
+        el.time_ms = 0;
+        return true;
     }
 
-    void push(element_type element) {
-        return ekf_ring_buffer::push(&element);
+    /*
+     * Writes data and timestamp to a Ring buffer and advances indices that
+     * define the location of the newest and oldest data
+    */
+    void push(const element_type &element) {
+        element_type *el = (element_type *)push_slot();
+        if (el != nullptr) {
+            *el = element;
+        }
     }
 
     void reset() {
@@ -91,23 +156,12 @@ public:
     
     // initialise buffer, returns false when allocation has failed
     bool init(uint32_t size);
-
-    /*
-      Writes data to a Ring buffer and advances indices that
-      define the location of the newest and oldest data
-    */
-    void push_youngest_element(const void *element);
+    bool init(uint32_t size, EKF_buffer_arena &arena);
 
     // return true if the buffer has been filled at least once
     bool is_filled(void) const {
         return _filled;
     }
-    
-    // retrieve the oldest data from the ring buffer tail
-    void get_oldest_element(void *element);
-
-    // writes the same data to all elements in the ring buffer
-    void reset_history(const void *element);
 
     // zeroes all data in the ring buffer
     void reset();
@@ -132,6 +186,16 @@ protected:
     bool _filled;
 
     void *get_offset(uint8_t idx) const;
+
+    /*
+      Advances the indices that define the location of the newest and
+      oldest data and returns the element to write the new data to, or
+      nullptr if not allocated
+    */
+    void *push_youngest_slot();
+
+    // the oldest element, or nullptr if not allocated
+    void *get_oldest_slot() const;
 };
 
 /*
@@ -148,13 +212,19 @@ public:
     bool init(uint8_t size) {
         return ekf_imu_buffer::init(size);
     }
+    bool init(uint8_t size, EKF_buffer_arena &arena) {
+        return ekf_imu_buffer::init(size, arena);
+    }
 
     /*
       Writes data to a Ring buffer and advances indices that
      define the location of the newest and oldest data
     */
-    void push_youngest_element(element_type element) {
-        return ekf_imu_buffer::push_youngest_element(&element);
+    void push_youngest_element(const element_type &element) {
+        element_type *el = (element_type *)push_youngest_slot();
+        if (el != nullptr) {
+            *el = element;
+        }
     }
 
     // return true if the buffer has been filled at least once
@@ -164,14 +234,18 @@ public:
     
     // retrieve the oldest data from the ring buffer tail
     element_type get_oldest_element() {
-        element_type ret;
-        ekf_imu_buffer::get_oldest_element(&ret);
-        return ret;
+        const element_type *el = (const element_type *)get_oldest_slot();
+        if (el == nullptr) {
+            return element_type {};
+        }
+        return *el;
     }
 
     // writes the same data to all elements in the ring buffer
-    void reset_history(element_type element) {
-        ekf_imu_buffer::reset_history(&element);
+    void reset_history(const element_type &element) {
+        for (uint8_t index=0; index<_size; index++) {
+            *(element_type *)get_offset(index) = element;
+        }
     }
 
     // zeroes all data in the ring buffer
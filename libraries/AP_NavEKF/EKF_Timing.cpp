@@ -0,0 +1,78 @@
+/*
+  per-call timing of the main EKF steps
+*/
+
+#include "EKF_Timing.h"
+
+#if HAL_NAVEKF_TIMING_ENABLED
+
+#include <stdio.h>
+#include <time.h>
+
+static const char *step_names[] = {
+    "UpdateStrapdownEquationsNED",
+    "CovariancePrediction",
+    "FuseVelPosNED",
+    "FuseMagnetometer",
+    "FuseOptFlow",
+};
+
+static_assert(sizeof(step_names)/sizeof(step_names[0]) == uint8_t(EKF_Timing::Step::NumSteps), "step names must match steps");
+
+uint64_t EKF_Timing::now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+void EKF_Timing::record(Step step, uint64_t dt_ns)
+{
+    auto &s = steps[uint8_t(step)];
+    if (s.count == 0 || dt_ns < s.min_ns) {
+        s.min_ns = dt_ns;
+    }
+    if (dt_ns > s.max_ns) {
+        s.max_ns = dt_ns;
+    }
+    s.total_ns += dt_ns;
+    s.count++;
+}
+
+void EKF_Timing::accumulate(const EKF_Timing &other)
+{
+    for (uint8_t i=0; i<uint8_t(Step::NumSteps); i++) {
+        auto &s = steps[i];
+        const auto &o = other.steps[i];
+        if (o.count == 0) {
+            continue;
+        }
+        if (s.count == 0 || o.min_ns < s.min_ns) {
+            s.min_ns = o.min_ns;
+        }
+        if (o.max_ns > s.max_ns) {
+            s.max_ns = o.max_ns;
+        }
+        s.total_ns += o.total_ns;
+        s.count += o.count;
+    }
+}
+
+/*
+  print one line per step in a form that is easy for scripts to parse:
+  NAME STEP count=N mean_ns=N min_ns=N max_ns=N
+ */
+void EKF_Timing::print(const char *name) const
+{
+    for (uint8_t i=0; i<uint8_t(Step::NumSteps); i++) {
+        const auto &s = steps[i];
+        ::printf("%s %s count=%u mean_ns=%llu min_ns=%llu max_ns=%llu\n",
+                 name, step_names[i],
+                 (unsigned)s.count,
+                 (unsigned long long)(s.count ? s.total_ns / s.count : 0),
+                 (unsigned long long)s.min_ns,
+                 (unsigned long long)s.max_ns);
+    }
+}
+
+#endif // HAL_NAVEKF_TIMING_ENABLED
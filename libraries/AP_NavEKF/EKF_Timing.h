@@ -0,0 +1,74 @@
+/*
+  per-call timing of the main EKF steps, used to catch performance
+  regressions when replaying logs off-target. This measures wall clock
+  time rather than the replayed clock, so is only available on hosted
+  builds
+*/
+#pragma once
+
+#include <stdint.h>
+#include <AP_HAL/AP_HAL_Boards.h>
+#include <AP_Vehicle/AP_Vehicle_Type.h>
+
+#ifndef HAL_NAVEKF_TIMING_ENABLED
+#define HAL_NAVEKF_TIMING_ENABLED APM_BUILD_TYPE(APM_BUILD_Replay) && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+#if HAL_NAVEKF_TIMING_ENABLED
+
+class EKF_Timing
+{
+public:
+    enum class Step : uint8_t {
+        UpdateStrapdownEquationsNED = 0,
+        CovariancePrediction,
+        FuseVelPosNED,
+        FuseMagnetometer,
+        FuseOptFlow,
+        NumSteps
+    };
+
+    // add one call of the given step
+    void record(Step step, uint64_t dt_ns);
+
+    // add the counts from another set of timings
+    void accumulate(const EKF_Timing &other);
+
+    // print a line per step, prefixed by name
+    void print(const char *name) const;
+
+    // monotonic time in nanoseconds
+    static uint64_t now_ns(void);
+
+    // records the time from construction to destruction against a step
+    class Scope {
+    public:
+        Scope(EKF_Timing &_timing, Step _step) :
+            timing(_timing),
+            step(_step),
+            start_ns(now_ns()) {}
+        ~Scope() {
+            timing.record(step, now_ns() - start_ns);
+        }
+    private:
+        EKF_Timing &timing;
+        const Step step;
+        const uint64_t start_ns;
+    };
+
+private:
+    struct {
+        uint32_t count;
+        uint64_t total_ns;
+        uint64_t min_ns;
+        uint64_t max_ns;
+    } steps[uint8_t(Step::NumSteps)];
+};
+
+#define EKF_TIMING_SCOPE(timing, step) EKF_Timing::Scope _ekf_timing_scope(timing, EKF_Timing::Step::step)
+
+#else
+
+#define EKF_TIMING_SCOPE(timing, step)
+
+#endif // HAL_NAVEKF_TIMING_ENABLED
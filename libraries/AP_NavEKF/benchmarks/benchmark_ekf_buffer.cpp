@@ -0,0 +1,77 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_NavEKF/EKF_Buffer.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  the EKF buffers measurements until the fusion time horizon catches
+  up with them. Each iteration here is one 400Hz IMU step of that
+  pattern, with the sizes the EKF uses for a 250ms delay
+ */
+#define IMU_RATE_HZ 400
+#define IMU_BUFFER_LENGTH 100
+#define OBS_BUFFER_LENGTH 25
+#define OBS_DELAY_MS 220
+
+struct imu_elements {
+    Vector3f delAng;
+    Vector3f delVel;
+    float delAngDT;
+    float delVelDT;
+    uint32_t time_ms;
+    uint8_t gyro_index;
+    uint8_t accel_index;
+};
+
+struct obs_elements : EKF_obs_element_t {
+    Vector3f vel;
+    Vector2f pos;
+    float hgt;
+};
+
+static void BM_EKFIMUBuffer(benchmark::State& state)
+{
+    EKF_IMU_buffer_t<imu_elements> buffer;
+    buffer.init(IMU_BUFFER_LENGTH);
+    imu_elements imu {};
+    imu.delAngDT = imu.delVelDT = 1.0f / IMU_RATE_HZ;
+
+    while (state.KeepRunning()) {
+        imu.time_ms += 1000 / IMU_RATE_HZ;
+        buffer.push_youngest_element(imu);
+        imu_elements delayed = buffer.get_oldest_element();
+        gbenchmark_escape(&delayed);
+    }
+}
+
+BENCHMARK(BM_EKFIMUBuffer);
+
+// observations arriving at the given rate in Hz, recalled once per IMU step
+static void BM_EKFObsBuffer(benchmark::State& state)
+{
+    const uint32_t obs_interval = IMU_RATE_HZ / state.range_x();
+    EKF_obs_buffer_t<obs_elements> buffer;
+    buffer.init(OBS_BUFFER_LENGTH);
+    obs_elements obs {};
+    uint32_t imu_time_ms = 1000;
+    uint32_t step = 0;
+
+    while (state.KeepRunning()) {
+        imu_time_ms += 1000 / IMU_RATE_HZ;
+        if (++step % obs_interval == 0) {
+            obs.time_ms = imu_time_ms;
+            buffer.push(obs);
+        }
+        obs_elements delayed;
+        bool found = buffer.recall(delayed, imu_time_ms - OBS_DELAY_MS);
+        gbenchmark_escape(&found);
+        gbenchmark_escape(&delayed);
+    }
+}
+
+BENCHMARK(BM_EKFObsBuffer)->Arg(10)->Arg(50);
+
+BENCHMARK_MAIN();
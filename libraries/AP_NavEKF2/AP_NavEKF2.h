@@ -27,6 +27,7 @@
 #include <AP_Param/AP_Param.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
+#include <AP_NavEKF/EKF_Timing.h>
 
 class NavEKF2_core;
 
@@ -296,6 +297,11 @@ public:
     // write EKF information to on-board logs
     void Log_Write();
 
+#if HAL_NAVEKF_TIMING_ENABLED
+    // print per-call timing of the main filter steps, summed over all cores
+    void print_call_timing(void) const;
+#endif
+
     // check if external navigation is being used for yaw observation
     bool isExtNavUsedForYaw(void) const;
 
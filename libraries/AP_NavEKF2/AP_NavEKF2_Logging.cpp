@@ -328,3 +328,14 @@ void NavEKF2_core::Log_Write_GSF(uint64_t time_us) const
     }
     yawEstimator->Log_Write(time_us, LOG_NKY0_MSG, LOG_NKY1_MSG, DAL_CORE(core_index));
 }
+
+#if HAL_NAVEKF_TIMING_ENABLED
+void NavEKF2::print_call_timing(void) const
+{
+    EKF_Timing total {};
+    for (uint8_t i=0; i<num_cores; i++) {
+        total.accumulate(core[i].get_call_timing());
+    }
+    total.print("EKF2");
+}
+#endif
@@ -266,6 +266,8 @@ void NavEKF2_core::EstimateTerrainOffset()
 */
 void NavEKF2_core::FuseOptFlow()
 {
+    EKF_TIMING_SCOPE(call_timing, FuseOptFlow);
+
     Vector24 H_LOS;
     Vector3f relVelSensor;
     Vector14 SH_LOS;
@@ -641,52 +643,8 @@ void NavEKF2_core::FuseOptFlow()
             prevFlowFuseTime_ms = imuSampleTime_ms;
 
             // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=5; j++) {
-                    KH[i][j] = Kfusion[i] * H_LOS[j];
-                }
-                for (unsigned j = 6; j<=7; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                KH[i][8] = Kfusion[i] * H_LOS[8];
-                for (unsigned j = 9; j<=23; j++) {
-                    KH[i][j] = 0.0f;
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][0] * P[0][j];
-                    res += KH[i][1] * P[1][j];
-                    res += KH[i][2] * P[2][j];
-                    res += KH[i][3] * P[3][j];
-                    res += KH[i][4] * P[4][j];
-                    res += KH[i][5] * P[5][j];
-                    res += KH[i][8] * P[8][j];
-                    KHP[i][j] = res;
-                }
-            }
-
-            // Check that we are not going to drive any variances negative and skip the update if so
-            bool healthyFusion = true;
-            for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                if (KHP[i][i] > P[i][i]) {
-                    healthyFusion = false;
-                }
-            }
-
-            if (healthyFusion) {
-                // update the covariance matrix
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        P[i][j] = P[i][j] - KHP[i][j];
-                    }
-                }
-
-                // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                ForceSymmetry();
+            if (FuseScalarCovariance(H_LOS)) {
+                // limit the variances to prevent ill-conditioning.
                 ConstrainVariances();
 
                 // zero the attitude error state - by definition it is assumed to be zero before each observation fusion
@@ -559,6 +559,8 @@ void NavEKF2_core::SelectVelPosFusion()
 // fuse selected position, velocity and height measurements
 void NavEKF2_core::FuseVelPosNED()
 {
+    EKF_TIMING_SCOPE(call_timing, FuseVelPosNED);
+
     // health is set bad until test passed
     bool velHealth = false;                 // boolean true if velocity measurements have passed innovation consistency check
     bool posHealth = false;                 // boolean true if position measurements have passed innovation consistency check
@@ -855,31 +857,11 @@ void NavEKF2_core::FuseVelPosNED()
                     Kfusion[23] = 0.0f;
                 }
 
-                // update the covariance - take advantage of direct observation of a single state at index = stateIndex to reduce computations
-                // this is a numerically optimised implementation of standard equation P = (I - K*H)*P;
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++)
-                    {
-                        KHP[i][j] = Kfusion[i] * P[stateIndex][j];
-                    }
-                }
-                // Check that we are not going to drive any variances negative and skip the update if so
-                bool healthyFusion = true;
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    if (KHP[i][i] > P[i][i]) {
-                        healthyFusion = false;
-                    }
-                }
-                if (healthyFusion) {
-                    // update the covariance matrix
-                    for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                        for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                            P[i][j] = P[i][j] - KHP[i][j];
-                        }
-                    }
-
-                    // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                    ForceSymmetry();
+                // update the covariance - this is a direct observation of a single state at index = stateIndex
+                Vector24 H_OBS = {};
+                H_OBS[stateIndex] = 1.0f;
+                if (FuseScalarCovariance(H_OBS)) {
+                    // limit the variances to prevent ill-conditioning.
                     ConstrainVariances();
 
                     // update the states
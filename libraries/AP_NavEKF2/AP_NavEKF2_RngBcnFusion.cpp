@@ -64,7 +64,7 @@ void NavEKF2_core::FuseRngBcn()
     if (rngPred > 0.1f)
     {
         // calculate observation jacobians
-        float H_BCN[24] = {};
+        Vector24 H_BCN = {};
         float t2 = bcn_pd-pd;
         float t3 = bcn_pe-pe;
         float t4 = bcn_pn-pn;
@@ -164,45 +164,8 @@ void NavEKF2_core::FuseRngBcn()
             lastRngBcnPassTime_ms = imuSampleTime_ms;
 
             // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=5; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 6; j<=8; j++) {
-                    KH[i][j] = Kfusion[i] * H_BCN[j];
-                }
-                for (unsigned j = 9; j<=23; j++) {
-                    KH[i][j] = 0.0f;
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][6] * P[6][j];
-                    res += KH[i][7] * P[7][j];
-                    res += KH[i][8] * P[8][j];
-                    KHP[i][j] = res;
-                }
-            }
-            // Check that we are not going to drive any variances negative and skip the update if so
-            bool healthyFusion = true;
-            for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                if (KHP[i][i] > P[i][i]) {
-                    healthyFusion = false;
-                }
-            }
-            if (healthyFusion) {
-                // update the covariance matrix
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        P[i][j] = P[i][j] - KHP[i][j];
-                    }
-                }
-
-                // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                ForceSymmetry();
+            if (FuseScalarCovariance(H_BCN)) {
+                // limit the variances to prevent ill-conditioning.
                 ConstrainVariances();
 
                 // update the states
@@ -648,6 +648,8 @@ void NavEKF2_core::correctDeltaVelocity(Vector3f &delVel, float delVelDT, uint8_
 */
 void NavEKF2_core::UpdateStrapdownEquationsNED()
 {
+    EKF_TIMING_SCOPE(call_timing, UpdateStrapdownEquationsNED);
+
     // update the quaternion states by rotating from the previous attitude through
     // the delta angle rotation quaternion and normalise
     // apply correction for earth's rotation rate
@@ -878,6 +880,8 @@ void NavEKF2_core::calcOutputStates()
 */
 void NavEKF2_core::CovariancePrediction()
 {
+    EKF_TIMING_SCOPE(call_timing, CovariancePrediction);
+
     float windVelSigma; // wind velocity 1-sigma process noise - m/s
     float dAngBiasSigma;// delta angle bias 1-sigma process noise - rad/s
     float dVelBiasSigma;// delta velocity bias 1-sigma process noise - m/s
@@ -1464,15 +1468,17 @@ void NavEKF2_core::StoreQuatRotate(const Quaternion &deltaQuat)
 // force symmetry on the covariance matrix to prevent ill-conditioning
 void NavEKF2_core::ForceSymmetry()
 {
-    for (uint8_t i=1; i<=stateIndexLim; i++)
-    {
-        for (uint8_t j=0; j<=i-1; j++)
-        {
-            float temp = 0.5f*(P[i][j] + P[j][i]);
-            P[i][j] = temp;
-            P[j][i] = temp;
-        }
-    }
+    force_symmetry(P, stateIndexLim+1);
+}
+
+/*
+  update the covariance matrix using P = (I - K*H)*P for fusion of a
+  scalar observation with observation Jacobian H and the Kalman gains
+  in Kfusion
+ */
+bool NavEKF2_core::FuseScalarCovariance(const Vector24 &H, bool checkVariances)
+{
+    return fuse_scalar_covariance(P, H, stateIndexLim+1, checkVariances);
 }
 
 // copy covariances across from covariance prediction calculation
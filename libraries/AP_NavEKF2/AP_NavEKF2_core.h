@@ -29,6 +29,7 @@
 #include <AP_Math/vectorN.h>
 #include <AP_NavEKF/AP_NavEKF_core_common.h>
 #include <AP_NavEKF/EKF_Buffer.h>
+#include <AP_NavEKF/EKF_Timing.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_DAL/AP_DAL.h>
 
@@ -270,6 +271,11 @@ public:
     // this is used by other instances to level load
     uint8_t getFramesSincePredict(void) const;
 
+#if HAL_NAVEKF_TIMING_ENABLED
+    // per-call timing of the main filter steps
+    const EKF_Timing &get_call_timing(void) const { return call_timing; }
+#endif
+
     // get the IMU index. For now we return the gyro index, as that is most
     // critical for use by other subsystems.
     uint8_t getIMUIndex(void) const { return gyro_index_active; }
@@ -332,6 +338,8 @@ private:
     uint8_t core_index;
     uint8_t imu_buffer_length;
 
+    // EKF2 is always single precision
+    typedef float ftype;
 #if MATH_CHECK_INDEXES
     typedef VectorN<ftype,2> Vector2;
     typedef VectorN<ftype,3> Vector3;
@@ -350,6 +358,7 @@ private:
     typedef VectorN<ftype,23> Vector23;
     typedef VectorN<ftype,24> Vector24;
     typedef VectorN<ftype,25> Vector25;
+    typedef VectorN<ftype,28> Vector28;
     typedef VectorN<ftype,31> Vector31;
     typedef VectorN<VectorN<ftype,3>,3> Matrix3;
     typedef VectorN<VectorN<ftype,24>,24> Matrix24;
@@ -373,6 +382,7 @@ private:
     typedef ftype Vector23[23];
     typedef ftype Vector24[24];
     typedef ftype Vector25[25];
+    typedef ftype Vector28[28];
     typedef ftype Matrix3[3][3];
     typedef ftype Matrix24[24][24];
     typedef ftype Matrix34_50[34][50];
@@ -487,6 +497,10 @@ private:
     // force symmetry on the state covariance matrix
     void ForceSymmetry();
 
+    // covariance update for fusion of a scalar observation with Jacobian H using the gains in Kfusion
+    // returns false and leaves P unchanged if checkVariances is set and a variance would go negative
+    bool FuseScalarCovariance(const Vector24 &H, bool checkVariances=true);
+
     // copy covariances across from covariance prediction calculation and fix numerical errors
     void CopyCovariances();
 
@@ -1153,6 +1167,11 @@ private:
     // timing statistics
     struct ekf_timing timing;
 
+#if HAL_NAVEKF_TIMING_ENABLED
+    // per-call timing of the main filter steps
+    EKF_Timing call_timing {};
+#endif
+
     // when was attitude filter status last non-zero?
     uint32_t last_filter_ok_ms;
     
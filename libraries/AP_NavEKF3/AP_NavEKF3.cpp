@@ -712,6 +712,30 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
     // @User: Advanced
     AP_GROUPINFO("GND_EFF_DZ", 7, NavEKF3, _baroGndEffectDeadZone, 4.0f),
 
+    // @Param: OPTIONS
+    // @DisplayName: EKF3 options
+    // @Description: EKF3 option bits. RunLanesInParallel runs the update of each EKF lane after the first on its own thread, with the main thread waiting for all lanes to complete before the outputs are used. This allows lanes to be spread across CPU cores on boards that have them. It is only available on boards built with per-lane EKF scratch space, which is the default on Linux boards. AdaptivePredictRate halves the time between state predictions while the CPU load is below EK3_PRED_LOAD, which reduces the prediction error on vehicles with high dynamics. This uses more memory for the IMU buffers. StandbyLanes runs lanes other than the primary at half the normal prediction and fusion rate, which lowers the CPU cost of keeping redundant lanes on slower boards. Standby lanes are brought up to the full rate for 10 seconds whenever the primary lane is unhealthy, its error score rises, or a lane switch is requested.
+    // @Bitmask: 0:RunLanesInParallel,1:AdaptivePredictRate,2:StandbyLanes
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("OPTIONS", 8, NavEKF3, _options, 0),
+
+    // @Param: CKPT_INT
+    // @DisplayName: EKF3 checkpoint logging interval
+    // @Description: Interval between logged checkpoints of the state of each EKF3 core, in XKCP messages. Replay can resume from a checkpoint rather than replaying the log from the start, which makes looking at late events in long logs faster. Set to 0 to disable.
+    // @Range: 0 600
+    // @Units: s
+    // @User: Advanced
+    AP_GROUPINFO("CKPT_INT", 9, NavEKF3, _checkpointInterval, 0),
+
+    // @Param: PRED_LOAD
+    // @DisplayName: EKF3 adaptive prediction CPU load limit
+    // @Description: When the AdaptivePredictRate bit of EK3_OPTIONS is set, the faster state prediction rate is only used while the scheduler CPU load is below this percentage. The lanes return to the normal prediction rate when the load goes above it, and use the faster rate again once it has dropped 10% below it.
+    // @Range: 10 100
+    // @Units: %
+    // @User: Advanced
+    AP_GROUPINFO("PRED_LOAD", 10, NavEKF3, _predLoadPct, 70),
+
     AP_GROUPEND
 };
 
@@ -785,12 +809,14 @@ bool NavEKF3::InitialiseFilter(void)
         }
 
         //try to allocate from CCM RAM, fallback to Normal RAM if not available or full
-        core = (NavEKF3_core*)AP::dal().malloc_type(sizeof(NavEKF3_core)*num_cores, AP::dal().MEM_FAST);
-        if (core == nullptr) {
+        // the cores are never freed, so over-allocate to meet the alignment of the matrix storage
+        void *core_mem = AP::dal().malloc_type(sizeof(NavEKF3_core)*num_cores + alignof(NavEKF3_core) - 1, AP::dal().MEM_FAST);
+        if (core_mem == nullptr) {
             _enable.set(0);
             GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "EKF3 allocation failed");
             return false;
         }
+        core = (NavEKF3_core*)((uintptr_t(core_mem) + alignof(NavEKF3_core) - 1) & ~uintptr_t(alignof(NavEKF3_core) - 1));
 
         // Call constructors on all cores
         for (uint8_t i = 0; i < num_cores; i++) {
@@ -824,6 +850,10 @@ bool NavEKF3::InitialiseFilter(void)
     // invalidate shared origin
     common_origin_valid = false;
 
+    if (option_is_set(Option::RunLanesInParallel)) {
+        start_lane_threads();
+    }
+
     // initialise the cores. We return success only if all cores
     // initialise successfully
     bool ret = true;
@@ -882,17 +912,12 @@ void NavEKF3::UpdateFilter(void)
 
     imuSampleTime_us = AP::dal().micros64();
 
-    for (uint8_t i=0; i<num_cores; i++) {
-        // if we have not overrun by more than 3 IMU frames, and we
-        // have already used more than 1/3 of the CPU budget for this
-        // loop then suppress the prediction step. This allows
-        // multiple EKF instances to cooperate on scheduling
-        bool allow_state_prediction = true;
-        if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
-            AP::dal().ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
-            allow_state_prediction = false;
+    if (lane_threads.running) {
+        UpdateFilterParallel();
+    } else {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].UpdateFilter(allowStatePrediction(i));
         }
-        core[i].UpdateFilter(allow_state_prediction);
     }
 
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
@@ -976,10 +1001,149 @@ void NavEKF3::UpdateFilter(void)
         primary = 0;
     }
 
+    updateStandbyLanes();
+
     // align position of inactive sources to ahrs
     sources.align_inactive_sources();
 }
 
+/*
+  with the StandbyLanes option, lanes other than the primary run at a
+  reduced rate. They still consume every IMU sample through the
+  downsampling so their states stay current, and all lanes are
+  brought back to full rate while the primary looks to be degrading
+  so a lane switch has full accuracy alternatives to choose from
+*/
+void NavEKF3::updateStandbyLanes(void)
+{
+    if (!option_is_set(Option::StandbyLanes) || num_cores < 2) {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].setStandby(false);
+        }
+        return;
+    }
+
+    const uint32_t now = AP::dal().millis();
+    const NavEKF3_core &primaryCore = core[primary];
+    if (!primaryCore.healthy() || primaryCore.errorScore() > STANDBY_WAKE_ERROR_SCORE) {
+        standbyWakeup_ms = now;
+    }
+    const bool wake = standbyWakeup_ms != 0 && now - standbyWakeup_ms < STANDBY_WAKE_HOLD_MS;
+    for (uint8_t i=0; i<num_cores; i++) {
+        core[i].setStandby(i != primary && !wake);
+    }
+}
+
+/*
+  return true if the given lane may run a state prediction on this
+  frame. If we have not overrun by more than 3 IMU frames, and we have
+  already used more than 1/3 of the CPU budget for this loop then
+  suppress the prediction step. This allows multiple EKF instances to
+  cooperate on scheduling
+*/
+bool NavEKF3::allowStatePrediction(uint8_t i)
+{
+    const uint8_t framesPerPrediction = core[i].isStandby() ? 2*_framesPerPrediction : _framesPerPrediction;
+    if (core[i].getFramesSincePredict() < (framesPerPrediction+3) &&
+        AP::dal().ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
+        return false;
+    }
+    return true;
+}
+
+/*
+  start a worker thread for each lane after the first. Lane 0 always
+  runs in the calling thread
+*/
+void NavEKF3::start_lane_threads(void)
+{
+    if (lane_threads.start_attempted || num_cores < 2) {
+        return;
+    }
+    lane_threads.start_attempted = true;
+#if HAL_NAVEKF_SHARED_SCRATCH
+    // the lanes share scratch space so can't run at the same time
+    GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3: parallel lanes not supported");
+    return;
+#endif
+    lane_threads.next_lane = 1;
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_threads.run_seq[i] = 0;
+        lane_threads.done_seq[i] = 0;
+        if (!AP::dal().thread_create(FUNCTOR_BIND_MEMBER(&NavEKF3::lane_thread, void), "EKF3", 8192)) {
+            // lanes which did get a thread sit idle, we carry on
+            // running all lanes serially
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3: failed to start lane threads");
+            return;
+        }
+    }
+    lane_threads.seq = 0;
+    lane_threads.running = true;
+}
+
+/*
+  worker thread for one EKF lane. Waits for the main thread to post a
+  new sequence number for this lane, runs the lane and then reports
+  completion with the same sequence number
+*/
+void NavEKF3::lane_thread(void)
+{
+    const uint8_t lane = lane_threads.next_lane++;
+    uint32_t last_seq = 0;
+    while (true) {
+        const uint32_t seq = lane_threads.run_seq[lane];
+        if (seq == last_seq) {
+            AP::dal().delay_microseconds(50);
+            continue;
+        }
+        last_seq = seq;
+        core[lane].UpdateFilter(lane_threads.predict[lane]);
+        lane_threads.done_seq[lane] = seq;
+    }
+}
+
+/*
+  run all lanes, with lanes after the first on their worker
+  threads. Returns once every lane has completed, so callers see the
+  same state they would after a serial update.
+*/
+void NavEKF3::UpdateFilterParallel(void)
+{
+    // the prediction decision consumes frame timing so it must be
+    // made here, in lane order, to keep replay deterministic
+    bool predict0 = allowStatePrediction(0);
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_threads.predict[i] = allowStatePrediction(i);
+    }
+
+    const uint32_t seq = ++lane_threads.seq;
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_threads.run_seq[i] = seq;
+    }
+
+    core[0].UpdateFilter(predict0);
+
+    // barrier: wait for the other lanes
+    for (uint8_t i=1; i<num_cores; i++) {
+        while (lane_threads.done_seq[i] != seq) {
+            AP::dal().delay_microseconds(10);
+        }
+    }
+
+    // publish the first origin set by any lane, in lane order, so
+    // that the result does not depend on thread timing
+    if (!common_origin_valid) {
+        for (uint8_t i=0; i<num_cores; i++) {
+            Location loc;
+            if (core[i].getOriginRaw(loc)) {
+                common_EKF_origin = loc;
+                common_origin_valid = true;
+                break;
+            }
+        }
+    }
+}
+
 /*
   check if switching lanes will reduce the normalised
   innovations. This is called when the vehicle code is about to
@@ -991,6 +1155,10 @@ void NavEKF3::checkLaneSwitch(void)
     AP::dal().log_event3(AP_DAL::Event::checkLaneSwitch);
 
     uint32_t now = AP::dal().millis();
+
+    // the vehicle is close to an EKF failsafe, so bring any standby
+    // lanes up to full rate
+    standbyWakeup_ms = now;
     if (lastLaneSwitch_ms != 0 && now - lastLaneSwitch_ms < 5000) {
         // don't switch twice in 5 seconds
         return;
@@ -1986,3 +2154,31 @@ bool NavEKF3::yawAlignmentComplete(void) const
     }
     return core[primary].have_aligned_yaw();
 }
+
+// returns true when all cores have finished initialising
+bool NavEKF3::statesInitialised(void) const
+{
+    if (!core || num_cores == 0) {
+        return false;
+    }
+    for (uint8_t i=0; i<num_cores; i++) {
+        if (!core[i].statesAreInitialised()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// restore the state of a core from the data of a set of XKCP messages
+bool NavEKF3::restoreCheckpoint(uint8_t core_index, const uint8_t *data, uint16_t length)
+{
+    if (!core || core_index >= num_cores ||
+        length < sizeof(NavEKF3_core::checkpoint_elements)) {
+        return false;
+    }
+    NavEKF3_core::checkpoint_elements cp;
+    memcpy(&cp, data, sizeof(cp));
+    // the cores take their time stamps from the frontend
+    imuSampleTime_us = AP::dal().micros64();
+    return core[core_index].restoreCheckpoint(cp);
+}
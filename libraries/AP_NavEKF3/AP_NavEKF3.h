@@ -19,12 +19,15 @@
  */
 #pragma once
 
+#include <atomic>
+
 #include <AP_Common/Location.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Param/AP_Param.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
+#include <AP_NavEKF/EKF_Timing.h>
 
 class NavEKF3_core;
 
@@ -336,6 +339,20 @@ public:
     // write EKF information to on-board logs
     void Log_Write();
 
+    // returns true when all cores have finished initialising
+    bool statesInitialised(void) const;
+
+    /*
+      restore the state of a core from a checkpoint logged in XKCP
+      messages. Used by Replay to resume part way through a log
+     */
+    bool restoreCheckpoint(uint8_t core_index, const uint8_t *data, uint16_t length);
+
+#if HAL_NAVEKF_TIMING_ENABLED
+    // print per-call timing of the main filter steps, summed over all cores
+    void print_call_timing(void) const;
+#endif
+
     // are we using an external yaw source? This is needed by AHRS attitudes_consistent check
     bool using_external_yaw(void) const;
 
@@ -424,6 +441,18 @@ private:
     AP_Int8 _betaMask;              // Bitmask controlling when sideslip angle fusion is used to estimate non wind states
     AP_Float _ognmTestScaleFactor;  // Scale factor applied to the thresholds used by the on ground not moving test
     AP_Float _baroGndEffectDeadZone;// Dead zone applied to positive baro height innovations when in ground effect (m)
+    AP_Int32 _options;              // bitmask of EKF3 options
+    AP_Int16 _checkpointInterval;   // interval between logged checkpoints of the core states (sec)
+    AP_Int8 _predLoadPct;           // CPU load above which the faster prediction rate is not used (%)
+
+    enum class Option : uint32_t {
+        RunLanesInParallel = (1U<<0),
+        AdaptivePredictRate = (1U<<1),
+        StandbyLanes = (1U<<2),
+    };
+    bool option_is_set(Option option) const {
+        return (uint32_t(_options.get()) & uint32_t(option)) != 0;
+    }
 
 // Possible values for _flowUse
 #define FLOW_USE_NONE    0
@@ -469,6 +498,9 @@ private:
     // time of last lane switch
     uint32_t lastLaneSwitch_ms;
 
+    // time standby lanes were last brought up to full rate
+    uint32_t standbyWakeup_ms;
+
     // last time of Log_Write
     uint64_t lastLogWrite_us;
 
@@ -496,6 +528,8 @@ private:
 #define MAX_EKF_CORES     3 // maximum allowed EKF Cores to be instantiated
 #define CORE_ERR_LIM      1 // -LIM to LIM relative error range for a core
 #define BETTER_THRESH   0.5 // a lane should have this much relative error difference to be considered for overriding a healthy primary core
+#define STANDBY_WAKE_ERROR_SCORE 0.5 // primary error score above which standby lanes are brought up to full rate
+#define STANDBY_WAKE_HOLD_MS 10000   // time standby lanes are kept at full rate after the last wake up (msec)
     
     bool runCoreSelection;                          // true when the primary core has stabilised and the core selection logic can be started
     bool coreSetupRequired[MAX_EKF_CORES];          // true when this core index needs to be setup
@@ -507,6 +541,32 @@ private:
     // origin set by one of the cores
     struct Location common_EKF_origin;
     bool common_origin_valid;
+
+    // state for running lanes after the first on worker threads
+    struct {
+        bool start_attempted;
+        bool running;
+        uint32_t seq;                                  // sequence number of the last frame posted, main thread only
+        std::atomic<uint8_t> next_lane;                // lane to be claimed by the next worker thread to start
+        std::atomic<uint32_t> run_seq[MAX_EKF_CORES];  // sequence number a worker should run up to
+        std::atomic<uint32_t> done_seq[MAX_EKF_CORES]; // sequence number a worker has completed
+        bool predict[MAX_EKF_CORES];                   // prediction permission for each lane for this frame
+    } lane_threads;
+
+    // return true if the lane may run a state prediction this frame
+    bool allowStatePrediction(uint8_t i);
+
+    // start the lane worker threads
+    void start_lane_threads(void);
+
+    // worker thread main loop
+    void lane_thread(void);
+
+    // update all lanes using the worker threads
+    void UpdateFilterParallel(void);
+
+    // put non-primary lanes in standby, or wake them up if the primary is degrading
+    void updateStandbyLanes(void);
     
     // update the yaw reset data to capture changes due to a lane switch
     // new_primary - index of the ekf instance that we are about to switch to as the primary
@@ -80,8 +80,8 @@ void NavEKF3_core::FuseAirspeed()
             Kfusion[8] = SK_TAS[0]*(P[8][4]*SH_TAS[2] - P[8][22]*SH_TAS[2] + P[8][5]*SK_TAS[1] - P[8][23]*SK_TAS[1] + P[8][6]*vd*SH_TAS[0]);
             Kfusion[9] = SK_TAS[0]*(P[9][4]*SH_TAS[2] - P[9][22]*SH_TAS[2] + P[9][5]*SK_TAS[1] - P[9][23]*SK_TAS[1] + P[9][6]*vd*SH_TAS[0]);
         } else {
-            // zero indexes 0 to 9 = 10*4 bytes
-            memset(&Kfusion[0], 0, 40);
+            // zero indexes 0 to 9
+            zero_range(&Kfusion[0], 0, 9);
         }
 
         if (!inhibitDelAngBiasStates && !airDataFusionWindOnly) {
@@ -89,8 +89,8 @@ void NavEKF3_core::FuseAirspeed()
             Kfusion[11] = SK_TAS[0]*(P[11][4]*SH_TAS[2] - P[11][22]*SH_TAS[2] + P[11][5]*SK_TAS[1] - P[11][23]*SK_TAS[1] + P[11][6]*vd*SH_TAS[0]);
             Kfusion[12] = SK_TAS[0]*(P[12][4]*SH_TAS[2] - P[12][22]*SH_TAS[2] + P[12][5]*SK_TAS[1] - P[12][23]*SK_TAS[1] + P[12][6]*vd*SH_TAS[0]);
         } else {
-            // zero indexes 10 to 12 = 3*4 bytes
-            memset(&Kfusion[10], 0, 12);
+            // zero indexes 10 to 12
+            zero_range(&Kfusion[0], 10, 12);
         }
 
         if (!inhibitDelVelBiasStates && !airDataFusionWindOnly) {
@@ -103,8 +103,8 @@ void NavEKF3_core::FuseAirspeed()
                 }
             }
         } else {
-            // zero indexes 13 to 15 = 3*4 bytes
-            memset(&Kfusion[13], 0, 12);
+            // zero indexes 13 to 15
+            zero_range(&Kfusion[0], 13, 15);
         }
 
         // zero Kalman gains to inhibit magnetic field state estimation
@@ -116,16 +116,16 @@ void NavEKF3_core::FuseAirspeed()
             Kfusion[20] = SK_TAS[0]*(P[20][4]*SH_TAS[2] - P[20][22]*SH_TAS[2] + P[20][5]*SK_TAS[1] - P[20][23]*SK_TAS[1] + P[20][6]*vd*SH_TAS[0]);
             Kfusion[21] = SK_TAS[0]*(P[21][4]*SH_TAS[2] - P[21][22]*SH_TAS[2] + P[21][5]*SK_TAS[1] - P[21][23]*SK_TAS[1] + P[21][6]*vd*SH_TAS[0]);
         } else {
-            // zero indexes 16 to 21 = 6*4 bytes
-            memset(&Kfusion[16], 0, 24);
+            // zero indexes 16 to 21
+            zero_range(&Kfusion[0], 16, 21);
         }
 
         if (!inhibitWindStates) {
             Kfusion[22] = SK_TAS[0]*(P[22][4]*SH_TAS[2] - P[22][22]*SH_TAS[2] + P[22][5]*SK_TAS[1] - P[22][23]*SK_TAS[1] + P[22][6]*vd*SH_TAS[0]);
             Kfusion[23] = SK_TAS[0]*(P[23][4]*SH_TAS[2] - P[23][22]*SH_TAS[2] + P[23][5]*SK_TAS[1] - P[23][23]*SK_TAS[1] + P[23][6]*vd*SH_TAS[0]);
         } else {
-            // zero indexes 22 to 23 = 2*4 bytes
-            memset(&Kfusion[22], 0, 8);
+            // zero indexes 22 to 23
+            zero_range(&Kfusion[0], 22, 23);
         }
 
         // calculate measurement innovation variance
@@ -151,57 +151,20 @@ void NavEKF3_core::FuseAirspeed()
             stateStruct.quat.normalize();
 
             // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=3; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 4; j<=6; j++) {
-                    KH[i][j] = Kfusion[i] * H_TAS[j];
-                }
-                for (unsigned j = 7; j<=21; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 22; j<=23; j++) {
-                    KH[i][j] = Kfusion[i] * H_TAS[j];
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][4] * P[4][j];
-                    res += KH[i][5] * P[5][j];
-                    res += KH[i][6] * P[6][j];
-                    res += KH[i][22] * P[22][j];
-                    res += KH[i][23] * P[23][j];
-                    KHP[i][j] = res;
-                }
-            }
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=stateIndexLim; j++) {
-                    P[i][j] = P[i][j] - KHP[i][j];
-                }
-            }
+            IGNORE_RETURN(FuseScalarCovariance(H_TAS, false));
         }
     }
 
-    // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-    ForceSymmetry();
+    // limit the variances to prevent ill-conditioning.
     ConstrainVariances();
 }
 
 // select fusion of true airspeed measurements
 void NavEKF3_core::SelectTasFusion()
 {
-    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz
-    // If so, don't fuse measurements on this time step to reduce frame over-runs
-    // Only allow one time slip to prevent high rate magnetometer data locking out fusion of other measurements
-    if (magFusePerformed && dtIMUavg < 0.005f && !airSpdFusionDelayed) {
-        airSpdFusionDelayed = true;
+    // spread the fusion load over time steps to reduce frame over-runs
+    if (delayFusion(airSpdFusionDelayed)) {
         return;
-    } else {
-        airSpdFusionDelayed = false;
     }
 
     // get true airspeed measurement
@@ -221,14 +184,9 @@ void NavEKF3_core::SelectTasFusion()
 // it requires a stable wind for best results and should not be used for aerobatic flight
 void NavEKF3_core::SelectBetaDragFusion()
 {
-    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz
-    // If so, don't fuse measurements on this time step to reduce frame over-runs
-    // Only allow one time slip to prevent high rate magnetometer data preventing fusion of other measurements
-    if (magFusePerformed && dtIMUavg < 0.005f && !sideSlipFusionDelayed) {
-        sideSlipFusionDelayed = true;
+    // spread the fusion load over time steps to reduce frame over-runs
+    if (delayFusion(sideSlipFusionDelayed)) {
         return;
-    } else {
-        sideSlipFusionDelayed = false;
     }
 
     // set true when the fusion time interval has triggered
@@ -379,8 +337,8 @@ void NavEKF3_core::FuseSideslip()
             Kfusion[8] = SK_BETA[0]*(P[8][0]*SK_BETA[5] + P[8][1]*SK_BETA[4] - P[8][4]*SK_BETA[1] + P[8][5]*SK_BETA[2] + P[8][2]*SK_BETA[6] + P[8][6]*SK_BETA[3] - P[8][3]*SK_BETA[7] + P[8][22]*SK_BETA[1] - P[8][23]*SK_BETA[2]);
             Kfusion[9] = SK_BETA[0]*(P[9][0]*SK_BETA[5] + P[9][1]*SK_BETA[4] - P[9][4]*SK_BETA[1] + P[9][5]*SK_BETA[2] + P[9][2]*SK_BETA[6] + P[9][6]*SK_BETA[3] - P[9][3]*SK_BETA[7] + P[9][22]*SK_BETA[1] - P[9][23]*SK_BETA[2]);
         } else {
-            // zero indexes 0 to 9 = 10*4 bytes
-            memset(&Kfusion[0], 0, 40);
+            // zero indexes 0 to 9
+            zero_range(&Kfusion[0], 0, 9);
         }
 
         if (!inhibitDelAngBiasStates && !airDataFusionWindOnly) {
@@ -388,8 +346,8 @@ void NavEKF3_core::FuseSideslip()
             Kfusion[11] = SK_BETA[0]*(P[11][0]*SK_BETA[5] + P[11][1]*SK_BETA[4] - P[11][4]*SK_BETA[1] + P[11][5]*SK_BETA[2] + P[11][2]*SK_BETA[6] + P[11][6]*SK_BETA[3] - P[11][3]*SK_BETA[7] + P[11][22]*SK_BETA[1] - P[11][23]*SK_BETA[2]);
             Kfusion[12] = SK_BETA[0]*(P[12][0]*SK_BETA[5] + P[12][1]*SK_BETA[4] - P[12][4]*SK_BETA[1] + P[12][5]*SK_BETA[2] + P[12][2]*SK_BETA[6] + P[12][6]*SK_BETA[3] - P[12][3]*SK_BETA[7] + P[12][22]*SK_BETA[1] - P[12][23]*SK_BETA[2]);
         } else {
-            // zero indexes 10 to 12 = 3*4 bytes
-            memset(&Kfusion[10], 0, 12);
+            // zero indexes 10 to 12
+            zero_range(&Kfusion[0], 10, 12);
         }
 
         if (!inhibitDelVelBiasStates && !airDataFusionWindOnly) {
@@ -402,8 +360,8 @@ void NavEKF3_core::FuseSideslip()
                 }
             }
         } else {
-            // zero indexes 13 to 15 = 3*4 bytes
-            memset(&Kfusion[13], 0, 12);
+            // zero indexes 13 to 15
+            zero_range(&Kfusion[0], 13, 15);
         }
 
         // zero Kalman gains to inhibit magnetic field state estimation
@@ -415,16 +373,16 @@ void NavEKF3_core::FuseSideslip()
             Kfusion[20] = SK_BETA[0]*(P[20][0]*SK_BETA[5] + P[20][1]*SK_BETA[4] - P[20][4]*SK_BETA[1] + P[20][5]*SK_BETA[2] + P[20][2]*SK_BETA[6] + P[20][6]*SK_BETA[3] - P[20][3]*SK_BETA[7] + P[20][22]*SK_BETA[1] - P[20][23]*SK_BETA[2]);
             Kfusion[21] = SK_BETA[0]*(P[21][0]*SK_BETA[5] + P[21][1]*SK_BETA[4] - P[21][4]*SK_BETA[1] + P[21][5]*SK_BETA[2] + P[21][2]*SK_BETA[6] + P[21][6]*SK_BETA[3] - P[21][3]*SK_BETA[7] + P[21][22]*SK_BETA[1] - P[21][23]*SK_BETA[2]);
         } else {
-            // zero indexes 16 to 21 = 6*4 bytes
-            memset(&Kfusion[16], 0, 24);
+            // zero indexes 16 to 21
+            zero_range(&Kfusion[0], 16, 21);
         }
 
         if (!inhibitWindStates) {
             Kfusion[22] = SK_BETA[0]*(P[22][0]*SK_BETA[5] + P[22][1]*SK_BETA[4] - P[22][4]*SK_BETA[1] + P[22][5]*SK_BETA[2] + P[22][2]*SK_BETA[6] + P[22][6]*SK_BETA[3] - P[22][3]*SK_BETA[7] + P[22][22]*SK_BETA[1] - P[22][23]*SK_BETA[2]);
             Kfusion[23] = SK_BETA[0]*(P[23][0]*SK_BETA[5] + P[23][1]*SK_BETA[4] - P[23][4]*SK_BETA[1] + P[23][5]*SK_BETA[2] + P[23][2]*SK_BETA[6] + P[23][6]*SK_BETA[3] - P[23][3]*SK_BETA[7] + P[23][22]*SK_BETA[1] - P[23][23]*SK_BETA[2]);
         } else {
-            // zero indexes 22 to 23 = 2*4 bytes
-            memset(&Kfusion[22], 0, 8);
+            // zero indexes 22 to 23
+            zero_range(&Kfusion[0], 22, 23);
         }
 
         // calculate predicted sideslip angle and innovation using small angle approximation
@@ -442,43 +400,10 @@ void NavEKF3_core::FuseSideslip()
         stateStruct.quat.normalize();
 
         // correct the covariance P = (I - K*H)*P
-        // take advantage of the empty columns in KH to reduce the
-        // number of operations
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=6; j++) {
-                KH[i][j] = Kfusion[i] * H_BETA[j];
-            }
-            for (unsigned j = 7; j<=21; j++) {
-                KH[i][j] = 0.0f;
-            }
-            for (unsigned j = 22; j<=23; j++) {
-                KH[i][j] = Kfusion[i] * H_BETA[j];
-            }
-        }
-        for (unsigned j = 0; j<=stateIndexLim; j++) {
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                ftype res = 0;
-                res += KH[i][0] * P[0][j];
-                res += KH[i][1] * P[1][j];
-                res += KH[i][2] * P[2][j];
-                res += KH[i][3] * P[3][j];
-                res += KH[i][4] * P[4][j];
-                res += KH[i][5] * P[5][j];
-                res += KH[i][6] * P[6][j];
-                res += KH[i][22] * P[22][j];
-                res += KH[i][23] * P[23][j];
-                KHP[i][j] = res;
-            }
-        }
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                P[i][j] = P[i][j] - KHP[i][j];
-            }
-        }
+        IGNORE_RETURN(FuseScalarCovariance(H_BETA, false));
     }
 
-    // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-    ForceSymmetry();
+    // limit the variances to prevent ill-conditioning.
     ConstrainVariances();
 }
 
@@ -499,7 +424,7 @@ void NavEKF3_core::FuseDragForces()
     const bool using_mcoef = mcoef > 0.001f;
 
     memset (&Kfusion, 0, sizeof(Kfusion));
-    Vector24 Hfusion; // Observation Jacobians
+    Vector24 Hfusion = {}; // Observation Jacobians
     const float R_ACC = sq(fmaxf(frontend->_dragObsNoise, 0.5f));
     const float density_ratio = sqrtf(dal.get_EAS2TAS());
     const float rho = fmaxf(1.225f * density_ratio, 0.1f); // air density
@@ -717,39 +642,7 @@ void NavEKF3_core::FuseDragForces()
         stateStruct.quat.normalize();
 
         // correct the covariance P = (I - K*H)*P
-        // take advantage of the empty columns in KH to reduce the
-        // number of operations
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=6; j++) {
-                KH[i][j] = Kfusion[i] * Hfusion[j];
-            }
-            for (unsigned j = 7; j<=21; j++) {
-                KH[i][j] = 0.0f;
-            }
-            for (unsigned j = 22; j<=23; j++) {
-                KH[i][j] = Kfusion[i] * Hfusion[j];
-            }
-        }
-        for (unsigned j = 0; j<=stateIndexLim; j++) {
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                ftype res = 0;
-                res += KH[i][0] * P[0][j];
-                res += KH[i][1] * P[1][j];
-                res += KH[i][2] * P[2][j];
-                res += KH[i][3] * P[3][j];
-                res += KH[i][4] * P[4][j];
-                res += KH[i][5] * P[5][j];
-                res += KH[i][6] * P[6][j];
-                res += KH[i][22] * P[22][j];
-                res += KH[i][23] * P[23][j];
-                KHP[i][j] = res;
-            }
-        }
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                P[i][j] = P[i][j] - KHP[i][j];
-            }
-        }
+        IGNORE_RETURN(FuseScalarCovariance(Hfusion, false));
     }
 }
 #endif // EK3_FEATURE_DRAG_FUSION
@@ -611,9 +611,13 @@ bool NavEKF3_core::setOrigin(const Location &loc)
     validOrigin = true;
     GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 IMU%u origin set",(unsigned)imu_index);
 
-    // put origin in frontend as well to ensure it stays in sync between lanes
-    frontend->common_EKF_origin = EKF_origin;
-    frontend->common_origin_valid = true;
+    // put origin in frontend as well to ensure it stays in sync
+    // between lanes. When lanes run in parallel the frontend does this
+    // once all lanes have completed
+    if (!frontend->lane_threads.running) {
+        frontend->common_EKF_origin = EKF_origin;
+        frontend->common_origin_valid = true;
+    }
 
     return true;
 }
@@ -387,6 +387,72 @@ void NavEKF3_core::Log_Write(uint64_t time_us)
     Log_Write_State_Variances(time_us);
 
     Log_Write_Timing(time_us);
+
+    Log_Write_Checkpoint(time_us);
+}
+
+/*
+  log the filter state in enough detail to resume from it in
+  Replay, split over as many XKCP messages as it takes
+ */
+void NavEKF3_core::Log_Write_Checkpoint(uint64_t time_us)
+{
+    const int16_t interval_s = frontend->_checkpointInterval;
+    if (interval_s <= 0 || !statesInitialised) {
+        return;
+    }
+    const uint32_t now_ms = dal.millis();
+    if (lastCheckpointLogTime_ms != 0 && now_ms - lastCheckpointLogTime_ms < uint32_t(interval_s) * 1000U) {
+        return;
+    }
+    lastCheckpointLogTime_ms = now_ms;
+
+    checkpoint_elements cp {};
+    memcpy(cp.states, &statesArray[0], sizeof(cp.states));
+    uint16_t n = 0;
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=i; j<24; j++) {
+            cp.P[n++] = P[i][j];
+        }
+    }
+    cp.origin_lat = EKF_origin.lat;
+    cp.origin_lng = EKF_origin.lng;
+    cp.origin_alt = EKF_origin.alt;
+    cp.ekfGpsRefHgt = ekfGpsRefHgt;
+    cp.tiltErrorVariance = tiltErrorVariance;
+    cp.flags = (tiltAlignComplete ? CKPT_TILT_ALIGNED : 0) |
+        (yawAlignComplete ? CKPT_YAW_ALIGNED : 0) |
+        (magStateInitComplete ? CKPT_MAG_INIT : 0) |
+        (finalInflightYawInit ? CKPT_INFLIGHT_YAW_INIT : 0) |
+        (finalInflightMagInit ? CKPT_INFLIGHT_MAG_INIT : 0) |
+        (inhibitMagStates ? CKPT_INHIBIT_MAG : 0) |
+        (inhibitWindStates ? CKPT_INHIBIT_WIND : 0) |
+        (inhibitDelVelBiasStates ? CKPT_INHIBIT_DVEL_BIAS : 0) |
+        (inhibitDelAngBiasStates ? CKPT_INHIBIT_DANG_BIAS : 0) |
+        (validOrigin ? CKPT_VALID_ORIGIN : 0) |
+        (magFieldLearned ? CKPT_MAG_LEARNED : 0) |
+        (gpsGoodToAlign ? CKPT_GPS_GOOD_TO_ALIGN : 0) |
+        (onGround ? CKPT_ON_GROUND : 0) |
+        (inFlight ? CKPT_IN_FLIGHT : 0) |
+        (motorsArmed ? CKPT_ARMED : 0) |
+        (delAngBiasLearned ? CKPT_DANG_BIAS_LEARNED : 0);
+    cp.PV_AidingMode = uint8_t(PV_AidingMode);
+    cp.activeHgtSource = uint8_t(activeHgtSource);
+    cp.magSelectIndex = magSelectIndex;
+    cp.stateIndexLim = stateIndexLim;
+
+    const uint8_t *data = (const uint8_t *)&cp;
+    struct log_XKCP pkt {
+        LOG_PACKET_HEADER_INIT(LOG_XKCP_MSG),
+        time_us : time_us,
+        core    : DAL_CORE(core_index),
+    };
+    for (uint16_t ofs=0; ofs<sizeof(cp); ofs += sizeof(pkt.data)) {
+        memset(pkt.data, 0, sizeof(pkt.data));
+        memcpy(pkt.data, &data[ofs], MIN(sizeof(pkt.data), sizeof(cp) - ofs));
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        pkt.seq++;
+    }
 }
 
 void NavEKF3_core::Log_Write_Timing(uint64_t time_us)
@@ -424,3 +490,14 @@ void NavEKF3_core::Log_Write_GSF(uint64_t time_us)
     }
     yawEstimator->Log_Write(time_us, LOG_XKY0_MSG, LOG_XKY1_MSG, DAL_CORE(core_index));
 }
+
+#if HAL_NAVEKF_TIMING_ENABLED
+void NavEKF3::print_call_timing(void) const
+{
+    EKF_Timing total {};
+    for (uint8_t i=0; i<num_cores; i++) {
+        total.accumulate(core[i].get_call_timing());
+    }
+    total.print("EKF3");
+}
+#endif
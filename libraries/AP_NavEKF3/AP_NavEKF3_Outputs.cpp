@@ -366,6 +366,15 @@ bool NavEKF3_core::getOriginLLH(struct Location &loc) const
     return validOrigin;
 }
 
+// return the origin as set, without any height correction
+bool NavEKF3_core::getOriginRaw(struct Location &loc) const
+{
+    if (validOrigin) {
+        loc = EKF_origin;
+    }
+    return validOrigin;
+}
+
 // return earth magnetic field estimates in measurement units / 1000
 void NavEKF3_core::getMagNED(Vector3f &magNED) const
 {
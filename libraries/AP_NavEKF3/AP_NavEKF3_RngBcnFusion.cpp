@@ -80,8 +80,7 @@ void NavEKF3_core::FuseRngBcn()
     if (rngPred > 0.1f)
     {
         // calculate observation jacobians
-        float H_BCN[24];
-        memset(H_BCN, 0, sizeof(H_BCN));
+        Vector24 H_BCN = {};
         float t2 = bcn_pd-pd;
         float t3 = bcn_pe-pe;
         float t4 = bcn_pn-pn;
@@ -144,8 +143,8 @@ void NavEKF3_core::FuseRngBcn()
             Kfusion[11] = -t26*(P[11][7]*t4*t9+P[11][8]*t3*t9+P[11][9]*t2*t9);
             Kfusion[12] = -t26*(P[12][7]*t4*t9+P[12][8]*t3*t9+P[12][9]*t2*t9);
         } else {
-            // zero indexes 10 to 12 = 3*4 bytes
-            memset(&Kfusion[10], 0, 12);
+            // zero indexes 10 to 12
+            zero_range(&Kfusion[0], 10, 12);
         }
 
         if (!inhibitDelVelBiasStates) {
@@ -158,8 +157,8 @@ void NavEKF3_core::FuseRngBcn()
                 }
             }
         } else {
-            // zero indexes 13 to 15 = 3*4 bytes
-            memset(&Kfusion[13], 0, 12);
+            // zero indexes 13 to 15
+            zero_range(&Kfusion[0], 13, 15);
         }
 
         // only allow the range observations to modify the vertical states if we are using it as a height reference
@@ -179,16 +178,16 @@ void NavEKF3_core::FuseRngBcn()
             Kfusion[20] = -t26*(P[20][7]*t4*t9+P[20][8]*t3*t9+P[20][9]*t2*t9);
             Kfusion[21] = -t26*(P[21][7]*t4*t9+P[21][8]*t3*t9+P[21][9]*t2*t9);
         } else {
-            // zero indexes 16 to 21 = 6*4 bytes
-            memset(&Kfusion[16], 0, 24);
+            // zero indexes 16 to 21
+            zero_range(&Kfusion[0], 16, 21);
         }
 
         if (!inhibitWindStates) {
             Kfusion[22] = -t26*(P[22][7]*t4*t9+P[22][8]*t3*t9+P[22][9]*t2*t9);
             Kfusion[23] = -t26*(P[23][7]*t4*t9+P[23][8]*t3*t9+P[23][9]*t2*t9);
         } else {
-            // zero indexes 22 to 23 = 2*4 bytes
-            memset(&Kfusion[22], 0, 8);
+            // zero indexes 22 to 23
+            zero_range(&Kfusion[0], 22, 23);
         }
 
         // Calculate innovation using the selected offset value
@@ -208,45 +207,8 @@ void NavEKF3_core::FuseRngBcn()
             lastRngBcnPassTime_ms = imuSampleTime_ms;
 
             // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=6; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 7; j<=9; j++) {
-                    KH[i][j] = Kfusion[i] * H_BCN[j];
-                }
-                for (unsigned j = 10; j<=23; j++) {
-                    KH[i][j] = 0.0f;
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][7] * P[7][j];
-                    res += KH[i][8] * P[8][j];
-                    res += KH[i][9] * P[9][j];
-                    KHP[i][j] = res;
-                }
-            }
-            // Check that we are not going to drive any variances negative and skip the update if so
-            bool healthyFusion = true;
-            for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                if (KHP[i][i] > P[i][i]) {
-                    healthyFusion = false;
-                }
-            }
-            if (healthyFusion) {
-                // update the covariance matrix
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        P[i][j] = P[i][j] - KHP[i][j];
-                    }
-                }
-
-                // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                ForceSymmetry();
+            if (FuseScalarCovariance(H_BCN)) {
+                // limit the variances to prevent ill-conditioning.
                 ConstrainVariances();
 
                 // correct the state vector
@@ -84,7 +84,10 @@ bool NavEKF3_core::setup_core(uint8_t _imu_index, uint8_t _core_index)
 #endif
 
     // calculate the IMU buffer length required to accommodate the maximum delay with some allowance for jitter
-    imu_buffer_length = (maxTimeDelay_ms / (uint16_t)(EKF_TARGET_DT_MS)) + 1;
+    // the buffer must cover the delay at the fastest prediction rate we may use
+    adaptivePredictRate = frontend->option_is_set(NavEKF3::Option::AdaptivePredictRate);
+    const uint16_t minTargetDt_ms = adaptivePredictRate ? EKF_TARGET_DT_FAST_MS : EKF_TARGET_DT_MS;
+    imu_buffer_length = (maxTimeDelay_ms / minTargetDt_ms) + 1;
 
     // set the observation buffer length to handle the minimum time of arrival between observations in combination
     // with the worst case delay from current time to ekf fusion time
@@ -101,90 +104,123 @@ bool NavEKF3_core::setup_core(uint8_t _imu_index, uint8_t _core_index)
     // calculate buffer size for external nav data
     const uint8_t extnav_buffer_length = MIN((ekf_delay_ms / frontend->extNavIntervalMin_ms) + 1, imu_buffer_length);
 
-    if(!storedGPS.init(obs_buffer_length)) {
+    // count the space needed by the buffers, then allocate it in one
+    // block and give it out to them
+    EKF_buffer_arena arena;
+    arena.start_sizing();
+    init_buffers(arena, flow_buffer_length, extnav_buffer_length);
+    const uint32_t buffer_space = arena.get_used();
+    if (buffer_space > buffer_memory_len) {
+        if (buffer_memory != nullptr) {
+            dal.free_type(buffer_memory, buffer_memory_len, dal.MEM_FAST);
+        }
+        buffer_memory_len = 0;
+        buffer_memory = dal.malloc_type(buffer_space, dal.MEM_FAST);
+        if (buffer_memory == nullptr) {
+            return false;
+        }
+        buffer_memory_len = buffer_space;
+    }
+    arena.start_alloc(buffer_memory, buffer_memory_len);
+    if (!init_buffers(arena, flow_buffer_length, extnav_buffer_length)) {
+        return false;
+    }
+
+    GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 IMU%u buffs IMU=%u OBS=%u OF=%u EN:%u dt=%.4f",
+                    (unsigned)imu_index,
+                    (unsigned)imu_buffer_length,
+                    (unsigned)obs_buffer_length,
+                    (unsigned)flow_buffer_length,
+                    (unsigned)extnav_buffer_length,
+                    (double)dtEkfAvg);
+
+    if ((yawEstimator == nullptr) && (frontend->_gsfRunMask & (1U<<core_index))) {
+        // check if there is enough memory to create the EKF-GSF object
+        if (dal.available_memory() < sizeof(EKFGSF_yaw) + 1024) {
+            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "EKF3 IMU%u GSF: not enough memory",(unsigned)imu_index);
+            return false;
+        }
+
+        // try to instantiate
+        yawEstimator = new EKFGSF_yaw();
+        if (yawEstimator == nullptr) {
+            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "EKF3 IMU%uGSF: allocation failed",(unsigned)imu_index);
+            return false;
+        }
+    }
+
+    return true;
+}
+    
+
+/*
+  initialise the sensor and output buffers from an arena. Called once
+  to size the arena and once more to allocate from it
+ */
+bool NavEKF3_core::init_buffers(EKF_buffer_arena &arena, uint8_t flow_buffer_length, uint8_t extnav_buffer_length)
+{
+    // the IMU and output buffers are used on every prediction step so
+    // they go first
+    if(!storedIMU.init(imu_buffer_length, arena)) {
         return false;
     }
-    if(!storedMag.init(obs_buffer_length)) {
+    if(!storedOutput.init(imu_buffer_length, arena)) {
         return false;
     }
-    if(!storedBaro.init(obs_buffer_length)) {
+    if(!storedGPS.init(obs_buffer_length, arena)) {
         return false;
     }
-    if(dal.airspeed() && !storedTAS.init(obs_buffer_length)) {
+    if(!storedMag.init(obs_buffer_length, arena)) {
         return false;
     }
-    if(dal.opticalflow_enabled() && !storedOF.init(flow_buffer_length)) {
+    if(!storedBaro.init(obs_buffer_length, arena)) {
+        return false;
+    }
+    if(dal.airspeed() && !storedTAS.init(obs_buffer_length, arena)) {
+        return false;
+    }
+    if(dal.opticalflow_enabled() && !storedOF.init(flow_buffer_length, arena)) {
         return false;
     }
 #if EK3_FEATURE_BODY_ODOM
-    if(frontend->sources.ext_nav_enabled() && !storedBodyOdm.init(obs_buffer_length)) {
+    if(frontend->sources.ext_nav_enabled() && !storedBodyOdm.init(obs_buffer_length, arena)) {
         return false;
     }
-    if(frontend->sources.wheel_encoder_enabled() && !storedWheelOdm.init(imu_buffer_length)) {
+    if(frontend->sources.wheel_encoder_enabled() && !storedWheelOdm.init(imu_buffer_length, arena)) {
         // initialise to same length of IMU to allow for multiple wheel sensors
         return false;
     }
 #endif // EK3_FEATURE_BODY_ODOM
-    if(frontend->sources.gps_yaw_enabled() && !storedYawAng.init(obs_buffer_length)) {
+    if(frontend->sources.gps_yaw_enabled() && !storedYawAng.init(obs_buffer_length, arena)) {
         return false;
     }
     // Note: the use of dual range finders potentially doubles the amount of data to be stored
-    if(dal.rangefinder() && !storedRange.init(MIN(2*obs_buffer_length , imu_buffer_length))) {
+    if(dal.rangefinder() && !storedRange.init(MIN(2*obs_buffer_length , imu_buffer_length), arena)) {
         return false;
     }
     // Note: range beacon data is read one beacon at a time and can arrive at a high rate
-    if(dal.beacon() && !storedRangeBeacon.init(imu_buffer_length+1)) {
+    if(dal.beacon() && !storedRangeBeacon.init(imu_buffer_length+1, arena)) {
         return false;
     }
 #if EK3_FEATURE_EXTERNAL_NAV
-    if (frontend->sources.ext_nav_enabled() && !storedExtNav.init(extnav_buffer_length)) {
+    if (frontend->sources.ext_nav_enabled() && !storedExtNav.init(extnav_buffer_length, arena)) {
         return false;
     }
-    if (frontend->sources.ext_nav_enabled() && !storedExtNavVel.init(extnav_buffer_length)) {
+    if (frontend->sources.ext_nav_enabled() && !storedExtNavVel.init(extnav_buffer_length, arena)) {
         return false;
     }
-    if(frontend->sources.ext_nav_enabled() && !storedExtNavYawAng.init(extnav_buffer_length)) {
+    if(frontend->sources.ext_nav_enabled() && !storedExtNavYawAng.init(extnav_buffer_length, arena)) {
         return false;
     }
 #endif // EK3_FEATURE_EXTERNAL_NAV
-    if(!storedIMU.init(imu_buffer_length)) {
-        return false;
-    }
-    if(!storedOutput.init(imu_buffer_length)) {
-        return false;
-    }
 #if EK3_FEATURE_DRAG_FUSION
-    if (!storedDrag.init(obs_buffer_length)) {
+    if (!storedDrag.init(obs_buffer_length, arena)) {
         return false;
     }
 #endif
 
-    GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 IMU%u buffs IMU=%u OBS=%u OF=%u EN:%u dt=%.4f",
-                    (unsigned)imu_index,
-                    (unsigned)imu_buffer_length,
-                    (unsigned)obs_buffer_length,
-                    (unsigned)flow_buffer_length,
-                    (unsigned)extnav_buffer_length,
-                    (double)dtEkfAvg);
-
-    if ((yawEstimator == nullptr) && (frontend->_gsfRunMask & (1U<<core_index))) {
-        // check if there is enough memory to create the EKF-GSF object
-        if (dal.available_memory() < sizeof(EKFGSF_yaw) + 1024) {
-            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "EKF3 IMU%u GSF: not enough memory",(unsigned)imu_index);
-            return false;
-        }
-
-        // try to instantiate
-        yawEstimator = new EKFGSF_yaw();
-        if (yawEstimator == nullptr) {
-            GCS_SEND_TEXT(MAV_SEVERITY_CRITICAL, "EKF3 IMU%uGSF: allocation failed",(unsigned)imu_index);
-            return false;
-        }
-    }
-
     return true;
 }
-    
 
 /********************************************************
 *                   INIT FUNCTIONS                      *
@@ -224,6 +260,7 @@ void NavEKF3_core::InitialiseVariables()
     lastVelReset_ms = 0;
     lastPosResetD_ms = 0;
     lastRngMeasTime_ms = 0;
+    lastCheckpointLogTime_ms = 0;
 
     // initialise other variables
     memset(&dvelBiasAxisInhibit, 0, sizeof(dvelBiasAxisInhibit));
@@ -236,6 +273,8 @@ void NavEKF3_core::InitialiseVariables()
     finalInflightYawInit = false;
     dtIMUavg = ins.get_loop_delta_t();
     dtEkfAvg = EKF_TARGET_DT;
+    ekfTargetDt = EKF_TARGET_DT;
+    standby = false;
     dt = 0;
     velDotNEDfilt.zero();
     lastKnownPositionNE.zero();
@@ -304,6 +343,7 @@ void NavEKF3_core::InitialiseVariables()
     gpsHorizVelFilt = 0.0f;
     memset(&statesArray, 0, sizeof(statesArray));
     memset(&vertCompFiltState, 0, sizeof(vertCompFiltState));
+    fusionLoad = 0;
     posVelFusionDelayed = false;
     optFlowFusionDelayed = false;
     flowFusionActive = false;
@@ -583,6 +623,83 @@ bool NavEKF3_core::InitialiseFilterBootstrap(void)
     return false;
 }
 
+/*
+  restore the filter from a logged checkpoint. Variables which are not
+  in the checkpoint start as they would on a fresh initialisation and
+  the observation buffers start empty, so the restored filter converges
+  on the original over the length of the buffers rather than matching
+  it from the first frame
+ */
+bool NavEKF3_core::restoreCheckpoint(const checkpoint_elements &cp)
+{
+    if (!statesInitialised) {
+        return false;
+    }
+
+    InitialiseVariables();
+
+    memcpy(&statesArray[0], cp.states, sizeof(cp.states));
+    uint16_t n = 0;
+    for (uint8_t i=0; i<24; i++) {
+        for (uint8_t j=i; j<24; j++) {
+            P[i][j] = P[j][i] = cp.P[n++];
+        }
+    }
+    EKF_origin.lat = cp.origin_lat;
+    EKF_origin.lng = cp.origin_lng;
+    EKF_origin.alt = cp.origin_alt;
+    ekfGpsRefHgt = cp.ekfGpsRefHgt;
+    tiltErrorVariance = cp.tiltErrorVariance;
+    tiltAlignComplete = (cp.flags & CKPT_TILT_ALIGNED) != 0;
+    yawAlignComplete = (cp.flags & CKPT_YAW_ALIGNED) != 0;
+    magStateInitComplete = (cp.flags & CKPT_MAG_INIT) != 0;
+    finalInflightYawInit = (cp.flags & CKPT_INFLIGHT_YAW_INIT) != 0;
+    finalInflightMagInit = (cp.flags & CKPT_INFLIGHT_MAG_INIT) != 0;
+    inhibitMagStates = (cp.flags & CKPT_INHIBIT_MAG) != 0;
+    inhibitWindStates = (cp.flags & CKPT_INHIBIT_WIND) != 0;
+    inhibitDelVelBiasStates = (cp.flags & CKPT_INHIBIT_DVEL_BIAS) != 0;
+    inhibitDelAngBiasStates = (cp.flags & CKPT_INHIBIT_DANG_BIAS) != 0;
+    validOrigin = (cp.flags & CKPT_VALID_ORIGIN) != 0;
+    magFieldLearned = (cp.flags & CKPT_MAG_LEARNED) != 0;
+    gpsGoodToAlign = (cp.flags & CKPT_GPS_GOOD_TO_ALIGN) != 0;
+    onGround = prevOnGround = (cp.flags & CKPT_ON_GROUND) != 0;
+    inFlight = prevInFlight = (cp.flags & CKPT_IN_FLIGHT) != 0;
+    motorsArmed = prevMotorsArmed = (cp.flags & CKPT_ARMED) != 0;
+    delAngBiasLearned = (cp.flags & CKPT_DANG_BIAS_LEARNED) != 0;
+    PV_AidingMode = PV_AidingModePrev = AidingMode(cp.PV_AidingMode);
+    activeHgtSource = prevHgtSource = AP_NavEKF_Source::SourceZ(cp.activeHgtSource);
+    magSelectIndex = cp.magSelectIndex;
+    stateIndexLim = cp.stateIndexLim;
+
+    // don't time out the aiding sources we were using
+    lastPosPassTime_ms = lastVelPassTime_ms = lastHgtPassTime_ms = imuSampleTime_ms;
+    lastTasPassTime_ms = lastSynthYawTime_ms = imuSampleTime_ms;
+    posTimeout = velTimeout = hgtTimeout = tasTimeout = false;
+
+    calcEarthRateNED(earthRateNED, validOrigin ? EKF_origin.lat : dal.get_home().lat);
+
+    // fill the IMU history with a stationary sample at the current
+    // attitude until real samples replace it
+    Matrix3f Tbn;
+    stateStruct.quat.rotation_matrix(Tbn);
+    imuDataNew.delAngDT = imuDataNew.delVelDT = dtEkfAvg;
+    imuDataNew.delAng.zero();
+    imuDataNew.delVel = Tbn.mul_transpose(Vector3f(0, 0, -GRAVITY_MSS * dtEkfAvg));
+    imuDataNew.time_ms = imuSampleTime_ms;
+    imuDataNew.gyro_index = gyro_index_active;
+    imuDataNew.accel_index = accel_index_active;
+    imuDataDelayed = imuDataNew;
+    storedIMU.reset_history(imuDataNew);
+
+    // reset the output predictor states
+    StoreOutputReset();
+
+    // keep logging checkpoints in step with the log we resumed from
+    lastCheckpointLogTime_ms = dal.millis();
+
+    return true;
+}
+
 // initialise the covariance matrix
 void NavEKF3_core::CovarianceInit()
 {
@@ -633,6 +750,34 @@ void NavEKF3_core::CovarianceInit()
 /********************************************************
 *                 UPDATE FUNCTIONS                      *
 ********************************************************/
+/*
+  select the target time between state predictions. Lanes in standby
+  use a longer time step. Otherwise when the
+  AdaptivePredictRate option is set the faster time step is used
+  while the CPU load stays below EK3_PRED_LOAD, dropping back to the
+  normal time step as soon as the load goes above it. The load comes
+  from the DAL so replay makes the same choice
+ */
+void NavEKF3_core::updatePredictRate()
+{
+    if (standby) {
+        ekfTargetDt = EKF_TARGET_DT_STANDBY;
+        return;
+    }
+    if (!adaptivePredictRate) {
+        ekfTargetDt = EKF_TARGET_DT;
+        return;
+    }
+    const uint8_t load = dal.get_cpu_load_pct();
+    const int16_t loadMax = frontend->_predLoadPct;
+    const bool fast = is_equal(ekfTargetDt, ftype(EKF_TARGET_DT_FAST));
+    if (fast ? (load > loadMax) : (load + EKF_PREDICT_LOAD_HYST >= loadMax)) {
+        ekfTargetDt = EKF_TARGET_DT;
+    } else {
+        ekfTargetDt = EKF_TARGET_DT_FAST;
+    }
+}
+
 // Update Filter States - this should be called whenever new IMU data is available
 void NavEKF3_core::UpdateFilter(bool predict)
 {
@@ -654,6 +799,9 @@ void NavEKF3_core::UpdateFilter(bool predict)
     // Check arm status and perform required checks and mode changes
     controlFilterModes();
 
+    // choose the prediction time step before downsampling the IMU data
+    updatePredictRate();
+
     // read IMU data as delta angles and velocities
     readIMUData();
 
@@ -670,6 +818,9 @@ void NavEKF3_core::UpdateFilter(bool predict)
         // Must be run before SelectMagFusion() to provide an up to date yaw estimate
         runYawEstimatorPrediction();
 
+        // nothing has been fused on this time step yet
+        fusionLoad = 0;
+
         // Update states using  magnetometer or external yaw sensor data
         SelectMagFusion();
 
@@ -744,8 +895,10 @@ void NavEKF3_core::correctDeltaVelocity(Vector3f &delVel, float delVelDT, uint8_
  * the vehicle when each observation is fused. This attitude error is then used to correct
  * the quaternion.
 */
-void NavEKF3_core::UpdateStrapdownEquationsNED()
+__FASTRAMFUNC__ void NavEKF3_core::UpdateStrapdownEquationsNED()
 {
+    EKF_TIMING_SCOPE(call_timing, UpdateStrapdownEquationsNED);
+
     // update the quaternion states by rotating from the previous attitude through
     // the delta angle rotation quaternion and normalise
     // apply correction for earth's rotation rate
@@ -993,6 +1146,8 @@ void NavEKF3_core::calcOutputStates()
 */
 void NavEKF3_core::CovariancePrediction(Vector3f *rotVarVecPtr)
 {
+    EKF_TIMING_SCOPE(call_timing, CovariancePrediction);
+
     float daxVar;       // X axis delta angle noise variance rad^2
     float dayVar;       // Y axis delta angle noise variance rad^2
     float dazVar;       // Z axis delta angle noise variance rad^2
@@ -1497,123 +1652,127 @@ void NavEKF3_core::CovariancePrediction(Vector3f *rotVarVecPtr)
             nextP[15][15] = P[15][15];
 
             if (stateIndexLim > 15) {
-                nextP[0][16] = -PS11*P[1][16] - PS12*P[2][16] - PS13*P[3][16] + PS6*P[10][16] + PS7*P[11][16] + PS9*P[12][16] + P[0][16];
-                nextP[1][16] = PS11*P[0][16] - PS12*P[3][16] + PS13*P[2][16] - PS34*P[10][16] - PS7*P[12][16] + PS9*P[11][16] + P[1][16];
-                nextP[2][16] = PS11*P[3][16] + PS12*P[0][16] - PS13*P[1][16] - PS34*P[11][16] + PS6*P[12][16] - PS9*P[10][16] + P[2][16];
-                nextP[3][16] = -PS11*P[2][16] + PS12*P[1][16] + PS13*P[0][16] - PS34*P[12][16] - PS6*P[11][16] + PS7*P[10][16] + P[3][16];
-                nextP[4][16] = -PS139*P[15][16] + PS140*P[14][16] - PS44*P[13][16] + PS60*P[2][16] + PS62*P[1][16] + PS72*P[0][16] - PS74*P[3][16] + P[4][16];
-                nextP[5][16] = PS160*P[15][16] - PS162*P[13][16] - PS60*P[1][16] + PS62*P[2][16] - PS65*P[14][16] + PS72*P[3][16] + PS74*P[0][16] + P[5][16];
-                nextP[6][16] = -PS165*P[14][16] + PS166*P[13][16] + PS60*P[0][16] + PS62*P[3][16] - PS70*P[15][16] - PS72*P[2][16] + PS74*P[1][16] + P[6][16];
-                nextP[7][16] = P[4][16]*dt + P[7][16];
-                nextP[8][16] = P[5][16]*dt + P[8][16];
-                nextP[9][16] = P[6][16]*dt + P[9][16];
-                nextP[10][16] = P[10][16];
-                nextP[11][16] = P[11][16];
-                nextP[12][16] = P[12][16];
-                nextP[13][16] = P[13][16];
-                nextP[14][16] = P[14][16];
-                nextP[15][16] = P[15][16];
-                nextP[16][16] = P[16][16];
-                nextP[0][17] = -PS11*P[1][17] - PS12*P[2][17] - PS13*P[3][17] + PS6*P[10][17] + PS7*P[11][17] + PS9*P[12][17] + P[0][17];
-                nextP[1][17] = PS11*P[0][17] - PS12*P[3][17] + PS13*P[2][17] - PS34*P[10][17] - PS7*P[12][17] + PS9*P[11][17] + P[1][17];
-                nextP[2][17] = PS11*P[3][17] + PS12*P[0][17] - PS13*P[1][17] - PS34*P[11][17] + PS6*P[12][17] - PS9*P[10][17] + P[2][17];
-                nextP[3][17] = -PS11*P[2][17] + PS12*P[1][17] + PS13*P[0][17] - PS34*P[12][17] - PS6*P[11][17] + PS7*P[10][17] + P[3][17];
-                nextP[4][17] = -PS139*P[15][17] + PS140*P[14][17] - PS44*P[13][17] + PS60*P[2][17] + PS62*P[1][17] + PS72*P[0][17] - PS74*P[3][17] + P[4][17];
-                nextP[5][17] = PS160*P[15][17] - PS162*P[13][17] - PS60*P[1][17] + PS62*P[2][17] - PS65*P[14][17] + PS72*P[3][17] + PS74*P[0][17] + P[5][17];
-                nextP[6][17] = -PS165*P[14][17] + PS166*P[13][17] + PS60*P[0][17] + PS62*P[3][17] - PS70*P[15][17] - PS72*P[2][17] + PS74*P[1][17] + P[6][17];
-                nextP[7][17] = P[4][17]*dt + P[7][17];
-                nextP[8][17] = P[5][17]*dt + P[8][17];
-                nextP[9][17] = P[6][17]*dt + P[9][17];
-                nextP[10][17] = P[10][17];
-                nextP[11][17] = P[11][17];
-                nextP[12][17] = P[12][17];
-                nextP[13][17] = P[13][17];
-                nextP[14][17] = P[14][17];
-                nextP[15][17] = P[15][17];
-                nextP[16][17] = P[16][17];
-                nextP[17][17] = P[17][17];
-                nextP[0][18] = -PS11*P[1][18] - PS12*P[2][18] - PS13*P[3][18] + PS6*P[10][18] + PS7*P[11][18] + PS9*P[12][18] + P[0][18];
-                nextP[1][18] = PS11*P[0][18] - PS12*P[3][18] + PS13*P[2][18] - PS34*P[10][18] - PS7*P[12][18] + PS9*P[11][18] + P[1][18];
-                nextP[2][18] = PS11*P[3][18] + PS12*P[0][18] - PS13*P[1][18] - PS34*P[11][18] + PS6*P[12][18] - PS9*P[10][18] + P[2][18];
-                nextP[3][18] = -PS11*P[2][18] + PS12*P[1][18] + PS13*P[0][18] - PS34*P[12][18] - PS6*P[11][18] + PS7*P[10][18] + P[3][18];
-                nextP[4][18] = -PS139*P[15][18] + PS140*P[14][18] - PS44*P[13][18] + PS60*P[2][18] + PS62*P[1][18] + PS72*P[0][18] - PS74*P[3][18] + P[4][18];
-                nextP[5][18] = PS160*P[15][18] - PS162*P[13][18] - PS60*P[1][18] + PS62*P[2][18] - PS65*P[14][18] + PS72*P[3][18] + PS74*P[0][18] + P[5][18];
-                nextP[6][18] = -PS165*P[14][18] + PS166*P[13][18] + PS60*P[0][18] + PS62*P[3][18] - PS70*P[15][18] - PS72*P[2][18] + PS74*P[1][18] + P[6][18];
-                nextP[7][18] = P[4][18]*dt + P[7][18];
-                nextP[8][18] = P[5][18]*dt + P[8][18];
-                nextP[9][18] = P[6][18]*dt + P[9][18];
-                nextP[10][18] = P[10][18];
-                nextP[11][18] = P[11][18];
-                nextP[12][18] = P[12][18];
-                nextP[13][18] = P[13][18];
-                nextP[14][18] = P[14][18];
-                nextP[15][18] = P[15][18];
-                nextP[16][18] = P[16][18];
-                nextP[17][18] = P[17][18];
-                nextP[18][18] = P[18][18];
-                nextP[0][19] = -PS11*P[1][19] - PS12*P[2][19] - PS13*P[3][19] + PS6*P[10][19] + PS7*P[11][19] + PS9*P[12][19] + P[0][19];
-                nextP[1][19] = PS11*P[0][19] - PS12*P[3][19] + PS13*P[2][19] - PS34*P[10][19] - PS7*P[12][19] + PS9*P[11][19] + P[1][19];
-                nextP[2][19] = PS11*P[3][19] + PS12*P[0][19] - PS13*P[1][19] - PS34*P[11][19] + PS6*P[12][19] - PS9*P[10][19] + P[2][19];
-                nextP[3][19] = -PS11*P[2][19] + PS12*P[1][19] + PS13*P[0][19] - PS34*P[12][19] - PS6*P[11][19] + PS7*P[10][19] + P[3][19];
-                nextP[4][19] = -PS139*P[15][19] + PS140*P[14][19] - PS44*P[13][19] + PS60*P[2][19] + PS62*P[1][19] + PS72*P[0][19] - PS74*P[3][19] + P[4][19];
-                nextP[5][19] = PS160*P[15][19] - PS162*P[13][19] - PS60*P[1][19] + PS62*P[2][19] - PS65*P[14][19] + PS72*P[3][19] + PS74*P[0][19] + P[5][19];
-                nextP[6][19] = -PS165*P[14][19] + PS166*P[13][19] + PS60*P[0][19] + PS62*P[3][19] - PS70*P[15][19] - PS72*P[2][19] + PS74*P[1][19] + P[6][19];
-                nextP[7][19] = P[4][19]*dt + P[7][19];
-                nextP[8][19] = P[5][19]*dt + P[8][19];
-                nextP[9][19] = P[6][19]*dt + P[9][19];
-                nextP[10][19] = P[10][19];
-                nextP[11][19] = P[11][19];
-                nextP[12][19] = P[12][19];
-                nextP[13][19] = P[13][19];
-                nextP[14][19] = P[14][19];
-                nextP[15][19] = P[15][19];
-                nextP[16][19] = P[16][19];
-                nextP[17][19] = P[17][19];
-                nextP[18][19] = P[18][19];
-                nextP[19][19] = P[19][19];
-                nextP[0][20] = -PS11*P[1][20] - PS12*P[2][20] - PS13*P[3][20] + PS6*P[10][20] + PS7*P[11][20] + PS9*P[12][20] + P[0][20];
-                nextP[1][20] = PS11*P[0][20] - PS12*P[3][20] + PS13*P[2][20] - PS34*P[10][20] - PS7*P[12][20] + PS9*P[11][20] + P[1][20];
-                nextP[2][20] = PS11*P[3][20] + PS12*P[0][20] - PS13*P[1][20] - PS34*P[11][20] + PS6*P[12][20] - PS9*P[10][20] + P[2][20];
-                nextP[3][20] = -PS11*P[2][20] + PS12*P[1][20] + PS13*P[0][20] - PS34*P[12][20] - PS6*P[11][20] + PS7*P[10][20] + P[3][20];
-                nextP[4][20] = -PS139*P[15][20] + PS140*P[14][20] - PS44*P[13][20] + PS60*P[2][20] + PS62*P[1][20] + PS72*P[0][20] - PS74*P[3][20] + P[4][20];
-                nextP[5][20] = PS160*P[15][20] - PS162*P[13][20] - PS60*P[1][20] + PS62*P[2][20] - PS65*P[14][20] + PS72*P[3][20] + PS74*P[0][20] + P[5][20];
-                nextP[6][20] = -PS165*P[14][20] + PS166*P[13][20] + PS60*P[0][20] + PS62*P[3][20] - PS70*P[15][20] - PS72*P[2][20] + PS74*P[1][20] + P[6][20];
-                nextP[7][20] = P[4][20]*dt + P[7][20];
-                nextP[8][20] = P[5][20]*dt + P[8][20];
-                nextP[9][20] = P[6][20]*dt + P[9][20];
-                nextP[10][20] = P[10][20];
-                nextP[11][20] = P[11][20];
-                nextP[12][20] = P[12][20];
-                nextP[13][20] = P[13][20];
-                nextP[14][20] = P[14][20];
-                nextP[15][20] = P[15][20];
-                nextP[16][20] = P[16][20];
-                nextP[17][20] = P[17][20];
-                nextP[18][20] = P[18][20];
-                nextP[19][20] = P[19][20];
-                nextP[20][20] = P[20][20];
-                nextP[0][21] = -PS11*P[1][21] - PS12*P[2][21] - PS13*P[3][21] + PS6*P[10][21] + PS7*P[11][21] + PS9*P[12][21] + P[0][21];
-                nextP[1][21] = PS11*P[0][21] - PS12*P[3][21] + PS13*P[2][21] - PS34*P[10][21] - PS7*P[12][21] + PS9*P[11][21] + P[1][21];
-                nextP[2][21] = PS11*P[3][21] + PS12*P[0][21] - PS13*P[1][21] - PS34*P[11][21] + PS6*P[12][21] - PS9*P[10][21] + P[2][21];
-                nextP[3][21] = -PS11*P[2][21] + PS12*P[1][21] + PS13*P[0][21] - PS34*P[12][21] - PS6*P[11][21] + PS7*P[10][21] + P[3][21];
-                nextP[4][21] = -PS139*P[15][21] + PS140*P[14][21] - PS44*P[13][21] + PS60*P[2][21] + PS62*P[1][21] + PS72*P[0][21] - PS74*P[3][21] + P[4][21];
-                nextP[5][21] = PS160*P[15][21] - PS162*P[13][21] - PS60*P[1][21] + PS62*P[2][21] - PS65*P[14][21] + PS72*P[3][21] + PS74*P[0][21] + P[5][21];
-                nextP[6][21] = -PS165*P[14][21] + PS166*P[13][21] + PS60*P[0][21] + PS62*P[3][21] - PS70*P[15][21] - PS72*P[2][21] + PS74*P[1][21] + P[6][21];
-                nextP[7][21] = P[4][21]*dt + P[7][21];
-                nextP[8][21] = P[5][21]*dt + P[8][21];
-                nextP[9][21] = P[6][21]*dt + P[9][21];
-                nextP[10][21] = P[10][21];
-                nextP[11][21] = P[11][21];
-                nextP[12][21] = P[12][21];
-                nextP[13][21] = P[13][21];
-                nextP[14][21] = P[14][21];
-                nextP[15][21] = P[15][21];
-                nextP[16][21] = P[16][21];
-                nextP[17][21] = P[17][21];
-                nextP[18][21] = P[18][21];
-                nextP[19][21] = P[19][21];
-                nextP[20][21] = P[20][21];
-                nextP[21][21] = P[21][21];
+                // the magnetic field states have all covariances held at zero while inhibited
+                // and do not couple into the other states, so skip predicting them
+                if (!inhibitMagStates) {
+                    nextP[0][16] = -PS11*P[1][16] - PS12*P[2][16] - PS13*P[3][16] + PS6*P[10][16] + PS7*P[11][16] + PS9*P[12][16] + P[0][16];
+                    nextP[1][16] = PS11*P[0][16] - PS12*P[3][16] + PS13*P[2][16] - PS34*P[10][16] - PS7*P[12][16] + PS9*P[11][16] + P[1][16];
+                    nextP[2][16] = PS11*P[3][16] + PS12*P[0][16] - PS13*P[1][16] - PS34*P[11][16] + PS6*P[12][16] - PS9*P[10][16] + P[2][16];
+                    nextP[3][16] = -PS11*P[2][16] + PS12*P[1][16] + PS13*P[0][16] - PS34*P[12][16] - PS6*P[11][16] + PS7*P[10][16] + P[3][16];
+                    nextP[4][16] = -PS139*P[15][16] + PS140*P[14][16] - PS44*P[13][16] + PS60*P[2][16] + PS62*P[1][16] + PS72*P[0][16] - PS74*P[3][16] + P[4][16];
+                    nextP[5][16] = PS160*P[15][16] - PS162*P[13][16] - PS60*P[1][16] + PS62*P[2][16] - PS65*P[14][16] + PS72*P[3][16] + PS74*P[0][16] + P[5][16];
+                    nextP[6][16] = -PS165*P[14][16] + PS166*P[13][16] + PS60*P[0][16] + PS62*P[3][16] - PS70*P[15][16] - PS72*P[2][16] + PS74*P[1][16] + P[6][16];
+                    nextP[7][16] = P[4][16]*dt + P[7][16];
+                    nextP[8][16] = P[5][16]*dt + P[8][16];
+                    nextP[9][16] = P[6][16]*dt + P[9][16];
+                    nextP[10][16] = P[10][16];
+                    nextP[11][16] = P[11][16];
+                    nextP[12][16] = P[12][16];
+                    nextP[13][16] = P[13][16];
+                    nextP[14][16] = P[14][16];
+                    nextP[15][16] = P[15][16];
+                    nextP[16][16] = P[16][16];
+                    nextP[0][17] = -PS11*P[1][17] - PS12*P[2][17] - PS13*P[3][17] + PS6*P[10][17] + PS7*P[11][17] + PS9*P[12][17] + P[0][17];
+                    nextP[1][17] = PS11*P[0][17] - PS12*P[3][17] + PS13*P[2][17] - PS34*P[10][17] - PS7*P[12][17] + PS9*P[11][17] + P[1][17];
+                    nextP[2][17] = PS11*P[3][17] + PS12*P[0][17] - PS13*P[1][17] - PS34*P[11][17] + PS6*P[12][17] - PS9*P[10][17] + P[2][17];
+                    nextP[3][17] = -PS11*P[2][17] + PS12*P[1][17] + PS13*P[0][17] - PS34*P[12][17] - PS6*P[11][17] + PS7*P[10][17] + P[3][17];
+                    nextP[4][17] = -PS139*P[15][17] + PS140*P[14][17] - PS44*P[13][17] + PS60*P[2][17] + PS62*P[1][17] + PS72*P[0][17] - PS74*P[3][17] + P[4][17];
+                    nextP[5][17] = PS160*P[15][17] - PS162*P[13][17] - PS60*P[1][17] + PS62*P[2][17] - PS65*P[14][17] + PS72*P[3][17] + PS74*P[0][17] + P[5][17];
+                    nextP[6][17] = -PS165*P[14][17] + PS166*P[13][17] + PS60*P[0][17] + PS62*P[3][17] - PS70*P[15][17] - PS72*P[2][17] + PS74*P[1][17] + P[6][17];
+                    nextP[7][17] = P[4][17]*dt + P[7][17];
+                    nextP[8][17] = P[5][17]*dt + P[8][17];
+                    nextP[9][17] = P[6][17]*dt + P[9][17];
+                    nextP[10][17] = P[10][17];
+                    nextP[11][17] = P[11][17];
+                    nextP[12][17] = P[12][17];
+                    nextP[13][17] = P[13][17];
+                    nextP[14][17] = P[14][17];
+                    nextP[15][17] = P[15][17];
+                    nextP[16][17] = P[16][17];
+                    nextP[17][17] = P[17][17];
+                    nextP[0][18] = -PS11*P[1][18] - PS12*P[2][18] - PS13*P[3][18] + PS6*P[10][18] + PS7*P[11][18] + PS9*P[12][18] + P[0][18];
+                    nextP[1][18] = PS11*P[0][18] - PS12*P[3][18] + PS13*P[2][18] - PS34*P[10][18] - PS7*P[12][18] + PS9*P[11][18] + P[1][18];
+                    nextP[2][18] = PS11*P[3][18] + PS12*P[0][18] - PS13*P[1][18] - PS34*P[11][18] + PS6*P[12][18] - PS9*P[10][18] + P[2][18];
+                    nextP[3][18] = -PS11*P[2][18] + PS12*P[1][18] + PS13*P[0][18] - PS34*P[12][18] - PS6*P[11][18] + PS7*P[10][18] + P[3][18];
+                    nextP[4][18] = -PS139*P[15][18] + PS140*P[14][18] - PS44*P[13][18] + PS60*P[2][18] + PS62*P[1][18] + PS72*P[0][18] - PS74*P[3][18] + P[4][18];
+                    nextP[5][18] = PS160*P[15][18] - PS162*P[13][18] - PS60*P[1][18] + PS62*P[2][18] - PS65*P[14][18] + PS72*P[3][18] + PS74*P[0][18] + P[5][18];
+                    nextP[6][18] = -PS165*P[14][18] + PS166*P[13][18] + PS60*P[0][18] + PS62*P[3][18] - PS70*P[15][18] - PS72*P[2][18] + PS74*P[1][18] + P[6][18];
+                    nextP[7][18] = P[4][18]*dt + P[7][18];
+                    nextP[8][18] = P[5][18]*dt + P[8][18];
+                    nextP[9][18] = P[6][18]*dt + P[9][18];
+                    nextP[10][18] = P[10][18];
+                    nextP[11][18] = P[11][18];
+                    nextP[12][18] = P[12][18];
+                    nextP[13][18] = P[13][18];
+                    nextP[14][18] = P[14][18];
+                    nextP[15][18] = P[15][18];
+                    nextP[16][18] = P[16][18];
+                    nextP[17][18] = P[17][18];
+                    nextP[18][18] = P[18][18];
+                    nextP[0][19] = -PS11*P[1][19] - PS12*P[2][19] - PS13*P[3][19] + PS6*P[10][19] + PS7*P[11][19] + PS9*P[12][19] + P[0][19];
+                    nextP[1][19] = PS11*P[0][19] - PS12*P[3][19] + PS13*P[2][19] - PS34*P[10][19] - PS7*P[12][19] + PS9*P[11][19] + P[1][19];
+                    nextP[2][19] = PS11*P[3][19] + PS12*P[0][19] - PS13*P[1][19] - PS34*P[11][19] + PS6*P[12][19] - PS9*P[10][19] + P[2][19];
+                    nextP[3][19] = -PS11*P[2][19] + PS12*P[1][19] + PS13*P[0][19] - PS34*P[12][19] - PS6*P[11][19] + PS7*P[10][19] + P[3][19];
+                    nextP[4][19] = -PS139*P[15][19] + PS140*P[14][19] - PS44*P[13][19] + PS60*P[2][19] + PS62*P[1][19] + PS72*P[0][19] - PS74*P[3][19] + P[4][19];
+                    nextP[5][19] = PS160*P[15][19] - PS162*P[13][19] - PS60*P[1][19] + PS62*P[2][19] - PS65*P[14][19] + PS72*P[3][19] + PS74*P[0][19] + P[5][19];
+                    nextP[6][19] = -PS165*P[14][19] + PS166*P[13][19] + PS60*P[0][19] + PS62*P[3][19] - PS70*P[15][19] - PS72*P[2][19] + PS74*P[1][19] + P[6][19];
+                    nextP[7][19] = P[4][19]*dt + P[7][19];
+                    nextP[8][19] = P[5][19]*dt + P[8][19];
+                    nextP[9][19] = P[6][19]*dt + P[9][19];
+                    nextP[10][19] = P[10][19];
+                    nextP[11][19] = P[11][19];
+                    nextP[12][19] = P[12][19];
+                    nextP[13][19] = P[13][19];
+                    nextP[14][19] = P[14][19];
+                    nextP[15][19] = P[15][19];
+                    nextP[16][19] = P[16][19];
+                    nextP[17][19] = P[17][19];
+                    nextP[18][19] = P[18][19];
+                    nextP[19][19] = P[19][19];
+                    nextP[0][20] = -PS11*P[1][20] - PS12*P[2][20] - PS13*P[3][20] + PS6*P[10][20] + PS7*P[11][20] + PS9*P[12][20] + P[0][20];
+                    nextP[1][20] = PS11*P[0][20] - PS12*P[3][20] + PS13*P[2][20] - PS34*P[10][20] - PS7*P[12][20] + PS9*P[11][20] + P[1][20];
+                    nextP[2][20] = PS11*P[3][20] + PS12*P[0][20] - PS13*P[1][20] - PS34*P[11][20] + PS6*P[12][20] - PS9*P[10][20] + P[2][20];
+                    nextP[3][20] = -PS11*P[2][20] + PS12*P[1][20] + PS13*P[0][20] - PS34*P[12][20] - PS6*P[11][20] + PS7*P[10][20] + P[3][20];
+                    nextP[4][20] = -PS139*P[15][20] + PS140*P[14][20] - PS44*P[13][20] + PS60*P[2][20] + PS62*P[1][20] + PS72*P[0][20] - PS74*P[3][20] + P[4][20];
+                    nextP[5][20] = PS160*P[15][20] - PS162*P[13][20] - PS60*P[1][20] + PS62*P[2][20] - PS65*P[14][20] + PS72*P[3][20] + PS74*P[0][20] + P[5][20];
+                    nextP[6][20] = -PS165*P[14][20] + PS166*P[13][20] + PS60*P[0][20] + PS62*P[3][20] - PS70*P[15][20] - PS72*P[2][20] + PS74*P[1][20] + P[6][20];
+                    nextP[7][20] = P[4][20]*dt + P[7][20];
+                    nextP[8][20] = P[5][20]*dt + P[8][20];
+                    nextP[9][20] = P[6][20]*dt + P[9][20];
+                    nextP[10][20] = P[10][20];
+                    nextP[11][20] = P[11][20];
+                    nextP[12][20] = P[12][20];
+                    nextP[13][20] = P[13][20];
+                    nextP[14][20] = P[14][20];
+                    nextP[15][20] = P[15][20];
+                    nextP[16][20] = P[16][20];
+                    nextP[17][20] = P[17][20];
+                    nextP[18][20] = P[18][20];
+                    nextP[19][20] = P[19][20];
+                    nextP[20][20] = P[20][20];
+                    nextP[0][21] = -PS11*P[1][21] - PS12*P[2][21] - PS13*P[3][21] + PS6*P[10][21] + PS7*P[11][21] + PS9*P[12][21] + P[0][21];
+                    nextP[1][21] = PS11*P[0][21] - PS12*P[3][21] + PS13*P[2][21] - PS34*P[10][21] - PS7*P[12][21] + PS9*P[11][21] + P[1][21];
+                    nextP[2][21] = PS11*P[3][21] + PS12*P[0][21] - PS13*P[1][21] - PS34*P[11][21] + PS6*P[12][21] - PS9*P[10][21] + P[2][21];
+                    nextP[3][21] = -PS11*P[2][21] + PS12*P[1][21] + PS13*P[0][21] - PS34*P[12][21] - PS6*P[11][21] + PS7*P[10][21] + P[3][21];
+                    nextP[4][21] = -PS139*P[15][21] + PS140*P[14][21] - PS44*P[13][21] + PS60*P[2][21] + PS62*P[1][21] + PS72*P[0][21] - PS74*P[3][21] + P[4][21];
+                    nextP[5][21] = PS160*P[15][21] - PS162*P[13][21] - PS60*P[1][21] + PS62*P[2][21] - PS65*P[14][21] + PS72*P[3][21] + PS74*P[0][21] + P[5][21];
+                    nextP[6][21] = -PS165*P[14][21] + PS166*P[13][21] + PS60*P[0][21] + PS62*P[3][21] - PS70*P[15][21] - PS72*P[2][21] + PS74*P[1][21] + P[6][21];
+                    nextP[7][21] = P[4][21]*dt + P[7][21];
+                    nextP[8][21] = P[5][21]*dt + P[8][21];
+                    nextP[9][21] = P[6][21]*dt + P[9][21];
+                    nextP[10][21] = P[10][21];
+                    nextP[11][21] = P[11][21];
+                    nextP[12][21] = P[12][21];
+                    nextP[13][21] = P[13][21];
+                    nextP[14][21] = P[14][21];
+                    nextP[15][21] = P[15][21];
+                    nextP[16][21] = P[16][21];
+                    nextP[17][21] = P[17][21];
+                    nextP[18][21] = P[18][21];
+                    nextP[19][21] = P[19][21];
+                    nextP[20][21] = P[20][21];
+                    nextP[21][21] = P[21][21];
+                }
 
                 if (stateIndexLim > 21) {
                     nextP[0][22] = -PS11*P[1][22] - PS12*P[2][22] - PS13*P[3][22] + PS6*P[10][22] + PS7*P[11][22] + PS9*P[12][22] + P[0][22];
@@ -1703,12 +1862,21 @@ void NavEKF3_core::CovariancePrediction(Vector3f *rotVarVecPtr)
     }
 
     // covariance matrix is symmetrical, so copy diagonals and copy lower half in nextP
-    // to lower and upper half in P
+    // to lower and upper half in P. Inhibited magnetic field states were not predicted
+    // and are left for ConstrainVariances() to zero
+    const bool skipMagStates = inhibitMagStates && stateIndexLim > 15;
     for (uint8_t row = 0; row <= stateIndexLim; row++) {
+        if (skipMagStates && row >= 16 && row <= 21) {
+            continue;
+        }
         // copy diagonals
         P[row][row] = nextP[row][row];
         // copy off diagonals
         for (uint8_t column = 0 ; column < row; column++) {
+            if (skipMagStates && column == 16) {
+                column = 21;
+                continue;
+            }
             P[row][column] = P[column][row] = nextP[column][row];
         }
     }
@@ -1788,15 +1956,38 @@ void NavEKF3_core::StoreQuatRotate(const Quaternion &deltaQuat)
 // force symmetry on the covariance matrix to prevent ill-conditioning
 void NavEKF3_core::ForceSymmetry()
 {
-    for (uint8_t i=1; i<=stateIndexLim; i++)
-    {
-        for (uint8_t j=0; j<=i-1; j++)
-        {
-            float temp = 0.5f*(P[i][j] + P[j][i]);
-            P[i][j] = temp;
-            P[j][i] = temp;
-        }
+    force_symmetry(P, stateIndexLim+1);
+}
+
+/*
+  update the covariance matrix using P = (I - K*H)*P for fusion of a
+  scalar observation with observation Jacobian H and the Kalman gains
+  in Kfusion
+ */
+bool NavEKF3_core::FuseScalarCovariance(const Vector24 &H, bool checkVariances)
+{
+    // each scalar update costs about the same, so count them to level the load
+    if (fusionLoad < UINT8_MAX) {
+        fusionLoad++;
     }
+    return fuse_scalar_covariance(P, H, stateIndexLim+1, checkVariances);
+}
+
+/*
+  put a fusion step off to the next frame if enough has already been
+  fused on this one and the filter is running faster than 200Hz, to
+  reduce frame over-runs. Only one time slip is allowed so that high
+  rate data fused earlier in the frame can't lock out other
+  measurements, which bounds the extra age of the data to one frame
+ */
+bool NavEKF3_core::delayFusion(bool &delayed)
+{
+    if (fusionLoad >= EK3_FUSION_LOAD_MAX && dtIMUavg < 0.005f && !delayed) {
+        delayed = true;
+        return true;
+    }
+    delayed = false;
+    return false;
 }
 
 // constrain variances (diagonal terms) in the state covariance matrix to  prevent ill-conditioning
@@ -1812,8 +2003,9 @@ void NavEKF3_core::ConstrainVariances()
         // this counter is decremented by 1 each prediction cycle in CovariancePrediction
         // resulting in the count from each clip event fading to zero over 1 second which
         // is sufficient to capture collapse from fusion of the lowest update rate sensor
-        vertVelVarClipCounter += EKF_TARGET_RATE_HZ;
-        if (vertVelVarClipCounter > VERT_VEL_VAR_CLIP_COUNT_LIM) {
+        const uint32_t predictRate_hz = uint32_t(1.0f / ekfTargetDt);
+        vertVelVarClipCounter += predictRate_hz;
+        if (vertVelVarClipCounter > VERT_VEL_VAR_CLIP_COUNT_LIM(predictRate_hz)) {
             // reset the corresponding covariances
             zeroRows(P,6,6);
             zeroCols(P,6,6);
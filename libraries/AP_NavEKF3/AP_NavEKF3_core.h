@@ -30,6 +30,7 @@
 #include <AP_NavEKF/AP_NavEKF_core_common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
 #include <AP_NavEKF/EKF_Buffer.h>
+#include <AP_NavEKF/EKF_Timing.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_DAL/AP_DAL.h>
@@ -59,6 +60,17 @@
 #define EKF_TARGET_DT_MS 12
 #define EKF_TARGET_DT    0.012f
 
+// faster update time used when the CPU has headroom and the
+// AdaptivePredictRate option is set
+#define EKF_TARGET_DT_FAST_MS 6
+#define EKF_TARGET_DT_FAST    0.006f
+
+// update time used by lanes in standby
+#define EKF_TARGET_DT_STANDBY 0.024f
+
+// CPU load hysteresis (percent) for switching back to the faster update time
+#define EKF_PREDICT_LOAD_HYST 10
+
 // mag fusion final reset altitude (using NED frame so altitude is negative)
 #define EKF3_MAG_FINAL_RESET_ALT 2.5f
 
@@ -85,9 +97,12 @@
 #define POS_STATE_MIN_VARIANCE 1E-4f
 
 // maximum number of times the vertical velocity variance can hit the lower limit before the
-// associated states, variances and covariances are reset
-#define EKF_TARGET_RATE_HZ uint32_t(1.0f / EKF_TARGET_DT)
-#define VERT_VEL_VAR_CLIP_COUNT_LIM (5 * EKF_TARGET_RATE_HZ)
+// associated states, variances and covariances are reset, for a given prediction rate
+#define VERT_VEL_VAR_CLIP_COUNT_LIM(rate_hz) (5 * (rate_hz))
+
+// number of scalar observations fused in a frame after which other
+// fusion steps are put off to the next frame when running faster than 200Hz
+#define EK3_FUSION_LOAD_MAX 3
 
 class NavEKF3_core : public NavEKF_core_common
 {
@@ -113,6 +128,10 @@ public:
     // Intended to be used by the front-end to determine which is the primary EKF
     float errorScore(void) const;
 
+    // set when this lane is not the primary and may run at a reduced rate
+    void setStandby(bool _standby) { standby = _standby; }
+    bool isStandby(void) const { return standby; }
+
     // Write the last calculated NE position relative to the reference point (m).
     // If a calculated solution is not available, use the best available data and return false
     // If false returned, do not use for flight control
@@ -183,6 +202,9 @@ public:
     // Returns false if the origin has not been set
     bool getOriginLLH(struct Location &loc) const;
 
+    // return the origin as set, without any height correction. Returns false if no origin has been set
+    bool getOriginRaw(struct Location &loc) const;
+
     // set the latitude and longitude and height used to set the NED origin
     // All NED positions calculated by the filter will be relative to this location
     // returns false if Absolute aiding and GPS is being used or if the origin is already set
@@ -358,6 +380,11 @@ public:
     // this is used by other instances to level load
     uint8_t getFramesSincePredict(void) const;
 
+#if HAL_NAVEKF_TIMING_ENABLED
+    // per-call timing of the main filter steps
+    const EKF_Timing &get_call_timing(void) const { return call_timing; }
+#endif
+
     // get the IMU index. For now we return the gyro index, as that is most
     // critical for use by other subsystems.
     uint8_t getIMUIndex(void) const { return gyro_index_active; }
@@ -394,6 +421,31 @@ public:
 
     void Log_Write(uint64_t time_us);
 
+    // state logged in XKCP checkpoint messages, made of 32 bit words
+    struct PACKED checkpoint_elements {
+        float states[24];
+        float P[300];               // upper triangle of the covariance matrix, by row
+        int32_t origin_lat;
+        int32_t origin_lng;
+        int32_t origin_alt;
+        double ekfGpsRefHgt;
+        float tiltErrorVariance;
+        uint32_t flags;             // checkpoint_flags
+        uint8_t PV_AidingMode;
+        uint8_t activeHgtSource;
+        uint8_t magSelectIndex;
+        uint8_t stateIndexLim;
+    };
+    static_assert(sizeof(checkpoint_elements) % 4 == 0, "checkpoint must be whole words");
+
+    // true once the states are initialised and the IMU buffer filled
+    bool statesAreInitialised(void) const {
+        return statesInitialised && storedIMU.is_filled();
+    }
+
+    // restore the filter from a checkpoint, see NavEKF3::restoreCheckpoint()
+    bool restoreCheckpoint(const checkpoint_elements &cp);
+
 private:
     EKFGSF_yaw *yawEstimator;
     AP_DAL &dal;
@@ -407,8 +459,9 @@ private:
     uint8_t imu_buffer_length;
     uint8_t obs_buffer_length;
 
-    typedef float ftype;
+    // ftype comes from NavEKF_core_common and is double when HAL_WITH_EKF_DOUBLE is set
 #if MATH_CHECK_INDEXES
+    typedef VectorN<float,24> StateVector;
     typedef VectorN<ftype,2> Vector2;
     typedef VectorN<ftype,3> Vector3;
     typedef VectorN<ftype,4> Vector4;
@@ -433,6 +486,7 @@ private:
     typedef VectorN<VectorN<ftype,34>,50> Matrix34_50;
     typedef VectorN<uint32_t,50> Vector_u32_50;
 #else
+    typedef float StateVector[24];
     typedef ftype Vector2[2];
     typedef ftype Vector3[3];
     typedef ftype Vector4[4];
@@ -457,7 +511,7 @@ private:
     typedef uint32_t Vector_u32_50[50];
 #endif
 
-    // the states are available in two forms, either as a Vector24, or
+    // the states are available in two forms, either as a StateVector, or
     // broken down as individual elements. Both are equivalent (same
     // memory)
     struct state_elements {
@@ -472,9 +526,10 @@ private:
     };
 
     union {
-        Vector24 statesArray;
+        StateVector statesArray EKF_ALIGNED;
         struct state_elements stateStruct;
     };
+    static_assert(sizeof(StateVector) == sizeof(state_elements), "statesArray must overlay stateStruct");
 
     struct output_elements {
         Quaternion  quat;           // quaternion defining rotation from local NED earth frame to body frame
@@ -622,6 +677,15 @@ private:
     // constrain variances (diagonal terms) in the state covariance matrix
     void ConstrainVariances();
 
+    // covariance update for fusion of a scalar observation with Jacobian H using the gains in Kfusion
+    // returns false and leaves P unchanged if checkVariances is set and a variance would go negative
+    bool FuseScalarCovariance(const Vector24 &H, bool checkVariances=true);
+
+    // return true if a fusion step should be put off to the next frame to
+    // spread the fusion load. delayed is the step's record of having been
+    // put off, so it is never put off on two frames in a row
+    bool delayFusion(bool &delayed);
+
     // constrain states
     void ConstrainStates();
 
@@ -684,6 +748,9 @@ private:
     // update IMU delta angle and delta velocity measurements
     void readIMUData();
 
+    // select the state prediction time step from the CPU load
+    void updatePredictRate();
+
     // update estimate of inactive bias states
     void learnInactiveBiases();
 
@@ -734,6 +801,9 @@ private:
     // reset yaw based on magnetic field sample
     void setYawFromMag();
 
+    // initialise the data buffers from an arena
+    bool init_buffers(EKF_buffer_arena &arena, uint8_t flow_buffer_length, uint8_t extnav_buffer_length);
+
     // zero stored variables
     void InitialiseVariables();
 
@@ -949,7 +1019,10 @@ private:
     uint32_t vertVelVarClipCounter; // counter used to control reset of vertical velocity variance following collapse against the lower limit
 
     float gpsNoiseScaler;           // Used to scale the  GPS measurement noise and consistency gates to compensate for operation with small satellite counts
-    Matrix24 P;                     // covariance matrix
+    Matrix24 P EKF_ALIGNED;         // covariance matrix
+    // one block of memory holding all the buffers
+    void *buffer_memory;
+    uint32_t buffer_memory_len;
     EKF_IMU_buffer_t<imu_elements> storedIMU;      // IMU data buffer
     EKF_obs_buffer_t<gps_elements> storedGPS;      // GPS data buffer
     EKF_obs_buffer_t<mag_elements> storedMag;      // Magnetometer data buffer
@@ -982,7 +1055,7 @@ private:
     ftype varInnovVtas;             // innovation variance output from fusion of airspeed measurements
     float defaultAirSpeed;          // default equivalent airspeed in m/s to be used if the measurement is unavailable. Do not use if not positive.
     float defaultAirSpeedVariance;  // default equivalent airspeed variance in (m/s)**2 to be used when defaultAirSpeed is specified. 
-    bool magFusePerformed;          // boolean set to true when magnetometer fusion has been perfomred in that time step
+    uint8_t fusionLoad;             // number of scalar observations fused on this time step, used for load levelling
     MagCal effectiveMagCal;         // the actual mag calibration being used as the default
     uint32_t prevTasStep_ms;        // time stamp of last TAS fusion step
     uint32_t prevBetaDragStep_ms;   // time stamp of last synthetic sideslip fusion step
@@ -1082,6 +1155,9 @@ private:
     uint8_t magSelectIndex;         // Index of the magnetometer that is being used by the EKF
     bool runUpdates;                // boolean true when the EKF updates can be run
     uint32_t framesSincePredict;    // number of frames lapsed since EKF instance did a state prediction
+    ftype ekfTargetDt;              // target time between state predictions (sec)
+    bool adaptivePredictRate;       // true when the prediction time step may be shortened when CPU load allows
+    bool standby;                   // true when this lane runs at the reduced standby prediction rate
     bool startPredictEnabled;       // boolean true when the frontend has given permission to start a new state prediciton cycle
     uint8_t localFilterTimeStep_ms; // average number of msec between filter updates
     float posDownObsNoise;          // observation noise variance on the vertical position used by the state and covariance update step (m^2)
@@ -1401,6 +1477,11 @@ private:
     // timing statistics
     struct ekf_timing timing;
 
+#if HAL_NAVEKF_TIMING_ENABLED
+    // per-call timing of the main filter steps
+    EKF_Timing call_timing {};
+#endif
+
     // when was attitude filter status last non-zero?
     uint32_t last_filter_ok_ms;
     
@@ -1480,4 +1561,25 @@ private:
     void Log_Write_State_Variances(uint64_t time_us) const;
     void Log_Write_Timing(uint64_t time_us);
     void Log_Write_GSF(uint64_t time_us);
+    void Log_Write_Checkpoint(uint64_t time_us);
+
+    enum checkpoint_flags {
+        CKPT_TILT_ALIGNED      = (1U<<0),
+        CKPT_YAW_ALIGNED       = (1U<<1),
+        CKPT_MAG_INIT          = (1U<<2),
+        CKPT_INFLIGHT_YAW_INIT = (1U<<3),
+        CKPT_INFLIGHT_MAG_INIT = (1U<<4),
+        CKPT_INHIBIT_MAG       = (1U<<5),
+        CKPT_INHIBIT_WIND      = (1U<<6),
+        CKPT_INHIBIT_DVEL_BIAS = (1U<<7),
+        CKPT_INHIBIT_DANG_BIAS = (1U<<8),
+        CKPT_VALID_ORIGIN      = (1U<<9),
+        CKPT_MAG_LEARNED       = (1U<<10),
+        CKPT_GPS_GOOD_TO_ALIGN = (1U<<11),
+        CKPT_ON_GROUND         = (1U<<12),
+        CKPT_IN_FLIGHT         = (1U<<13),
+        CKPT_ARMED             = (1U<<14),
+        CKPT_DANG_BIAS_LEARNED = (1U<<15),
+    };
+    uint32_t lastCheckpointLogTime_ms;  // time the last checkpoint was logged (msec)
 };
@@ -18,7 +18,8 @@
     LOG_XKV1_MSG, \
     LOG_XKV2_MSG, \
     LOG_XKY0_MSG, \
-    LOG_XKY1_MSG
+    LOG_XKY1_MSG, \
+    LOG_XKCP_MSG
 
 // @LoggerMessage: XKF0
 // @Description: EKF3 beacon sensor diagnostics
@@ -418,6 +419,31 @@ struct PACKED log_XKV {
     float v11;
 };
 
+// @LoggerMessage: XKCP
+// @Description: EKF3 checkpoint. Each checkpoint is split over several messages which together hold a core's states, covariance and mode flags, allowing Replay to resume part way through a log
+// @Field: TimeUS: Time since system startup
+// @Field: C: EKF3 core this data is for
+// @Field: Seq: index of this part of the checkpoint
+// @Field: D0: checkpoint data
+// @Field: D1: checkpoint data
+// @Field: D2: checkpoint data
+// @Field: D3: checkpoint data
+// @Field: D4: checkpoint data
+// @Field: D5: checkpoint data
+// @Field: D6: checkpoint data
+// @Field: D7: checkpoint data
+// @Field: D8: checkpoint data
+// @Field: D9: checkpoint data
+// @Field: D10: checkpoint data
+// @Field: D11: checkpoint data
+struct PACKED log_XKCP {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t core;
+    uint8_t seq;
+    uint32_t data[12];
+};
+
 #define LOG_STRUCTURE_FROM_NAVEKF3        \
     { LOG_XKF0_MSG, sizeof(log_XKF0), \
       "XKF0","QBBccCCcccccccc","TimeUS,C,ID,rng,innov,SIV,TR,BPN,BPE,BPD,OFH,OFL,OFN,OFE,OFD", "s#-m---mmmmmmmm", "F--B---BBBBBBBB" }, \
@@ -445,4 +471,6 @@ struct PACKED log_XKV {
     { LOG_XKV1_MSG, sizeof(log_XKV), \
       "XKV1","QBffffffffffff","TimeUS,C,V00,V01,V02,V03,V04,V05,V06,V07,V08,V09,V10,V11", "s#------------", "F-------------" }, \
     { LOG_XKV2_MSG, sizeof(log_XKV), \
-      "XKV2","QBffffffffffff","TimeUS,C,V12,V13,V14,V15,V16,V17,V18,V19,V20,V21,V22,V23", "s#------------", "F-------------" },
+      "XKV2","QBffffffffffff","TimeUS,C,V12,V13,V14,V15,V16,V17,V18,V19,V20,V21,V22,V23", "s#------------", "F-------------" }, \
+    { LOG_XKCP_MSG, sizeof(log_XKCP), \
+      "XKCP","QBBIIIIIIIIIIII","TimeUS,C,Seq,D0,D1,D2,D3,D4,D5,D6,D7,D8,D9,D10,D11", "s#-------------", "F--------------" },
@@ -391,13 +391,21 @@ void AP_OSD_MAX7456::transfer_frame()
     }
 
     buffer_offset = 0;
-    for (uint8_t y=0; y<video_lines; y++) {
+    bool buffer_full = false;
+    for (uint8_t y=0; y<video_lines && !buffer_full; y++) {
+        // most rows are unchanged between updates, so skip them
+        // without comparing character by character
+        if (memcmp(frame[y], shadow_frame[y], video_columns) == 0) {
+            continue;
+        }
         for (uint8_t x=0; x<video_columns; x++) {
             if (!is_dirty(x, y)) {
                 continue;
             }
             //ensure space for 1 char and escape sequence
+            //remaining changes are sent on the next flush
             if (buffer_offset >= spi_buffer_size - 32) {
+                buffer_full = true;
                 break;
             }
             shadow_frame[y][x] = frame[y][x];
@@ -25,6 +25,7 @@
 
 #include <cmath>
 #include <string.h>
+#include <stdlib.h>
 
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
@@ -81,6 +82,21 @@ uint16_t AP_Param::_count_marker;
 uint16_t AP_Param::_count_marker_done;
 HAL_Semaphore AP_Param::_count_sem;
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+// storage offsets of stored parameters
+struct AP_Param::storage_offset *AP_Param::_storage_index;
+uint16_t AP_Param::_storage_index_count;
+uint16_t AP_Param::_storage_index_size;
+bool AP_Param::_storage_index_valid;
+HAL_Semaphore AP_Param::_storage_index_sem;
+#endif
+
+#if AP_PARAM_INDEX_ENABLED
+// index of scalar parameters
+struct AP_Param::param_index AP_Param::_index;
+HAL_Semaphore AP_Param::_index_sem;
+#endif
+
 // storage and naming information about all types that can be saved
 const AP_Param::Info *AP_Param::_var_info;
 
@@ -88,7 +104,7 @@ struct AP_Param::param_override *AP_Param::param_overrides = nullptr;
 uint16_t AP_Param::num_param_overrides = 0;
 uint16_t AP_Param::num_read_only = 0;
 
-ObjectBuffer_TS<AP_Param::param_save> AP_Param::save_queue{30};
+struct AP_Param::save_queue_state AP_Param::save_queue;
 bool AP_Param::registered_save_handler;
 
 // we need a dummy object for the parameter save callback
@@ -152,6 +168,13 @@ void AP_Param::erase_all(void)
 
     // add a sentinal directly after the header
     write_sentinal(sizeof(struct EEPROM_header));
+
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    // storage is now empty
+    WITH_SEMAPHORE(_storage_index_sem);
+    storage_index_clear();
+    _storage_index_valid = true;
+#endif
 }
 
 /* the 'group_id' of a element of a group is the 18 bit identifier
@@ -720,6 +743,20 @@ bool AP_Param::is_sentinal(const Param_header &phdr)
 // if the sentinal isn't found either, the offset is set to 0xFFFF
 bool AP_Param::scan(const AP_Param::Param_header *target, uint16_t *pofs)
 {
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    {
+        WITH_SEMAPHORE(_storage_index_sem);
+        if (_storage_index_valid) {
+            uint16_t idx;
+            if (storage_index_find(header_key(*target), idx)) {
+                *pofs = _storage_index[idx].ofs;
+                return true;
+            }
+            *pofs = sentinal_offset;
+            return false;
+        }
+    }
+#endif
     struct Param_header phdr;
     uint16_t ofs = sizeof(AP_Param::EEPROM_header);
     while (ofs < _storage.size()) {
@@ -874,6 +911,40 @@ AP_Param::find_group(const char *name, uint16_t vindex, ptrdiff_t group_offset,
 //
 AP_Param *
 AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
+{
+    AP_Param *ap = nullptr;
+#if AP_PARAM_INDEX_ENABLED
+    if (index_available()) {
+        WITH_SEMAPHORE(_index_sem);
+        uint16_t pos;
+        if (_index.valid && index_find(name, pos)) {
+            ap = _index.entries[pos].ap;
+            *ptype = (enum ap_var_type)_index.entries[pos].type;
+        }
+    }
+#endif
+    if (ap == nullptr) {
+        // the index only holds visible scalars, so disabled groups
+        // and vectors need the full tree walk
+        ap = find_linear(name, ptype);
+    }
+    if (ap != nullptr && flags != nullptr) {
+        uint32_t group_element = 0;
+        const struct GroupInfo *ginfo;
+        struct GroupNesting group_nesting {};
+        uint8_t idx;
+        ap->find_var_info(&group_element, ginfo, group_nesting, &idx);
+        if (ginfo != nullptr) {
+            *flags = ginfo->flags;
+        }
+    }
+    return ap;
+}
+
+// Find a variable by name, walking the whole var_info tree
+//
+AP_Param *
+AP_Param::find_linear(const char *name, enum ap_var_type *ptype)
 {
     for (uint16_t i=0; i<_num_vars; i++) {
         uint8_t type = _var_info[i].type;
@@ -888,16 +959,6 @@ AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
             }
             AP_Param *ap = find_group(name + len, i, 0, group_info, ptype);
             if (ap != nullptr) {
-                if (flags != nullptr) {
-                    uint32_t group_element = 0;
-                    const struct GroupInfo *ginfo;
-                    struct GroupNesting group_nesting {};
-                    uint8_t idx;
-                    ap->find_var_info(&group_element, ginfo, group_nesting, &idx);
-                    if (ginfo != nullptr) {
-                        *flags = ginfo->flags;
-                    }
-                }
                 return ap;
             }
             // we continue looking as we want to allow top level
@@ -920,6 +981,21 @@ AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
 AP_Param *
 AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_INDEX_ENABLED
+    if (index_available()) {
+        WITH_SEMAPHORE(_index_sem);
+        if (_index.valid) {
+            if (idx >= _index.count) {
+                return nullptr;
+            }
+            const index_entry &e = _index.entries[idx];
+            *token = e.token;
+            *ptype = (enum ap_var_type)e.type;
+            _index.cursor = idx;
+            return e.ap;
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count=0;
     for (ap=AP_Param::first(token, ptype);
@@ -933,6 +1009,22 @@ AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token
 // by-name equivalent of find_by_index()
 AP_Param* AP_Param::find_by_name(const char* name, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_INDEX_ENABLED
+    if (index_available()) {
+        WITH_SEMAPHORE(_index_sem);
+        if (_index.valid) {
+            uint16_t pos;
+            if (!index_find(name, pos)) {
+                return nullptr;
+            }
+            const index_entry &e = _index.entries[pos];
+            *token = e.token;
+            *ptype = (enum ap_var_type)e.type;
+            _index.cursor = pos;
+            return e.ap;
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count = 0;
     for (ap = AP_Param::first(token, ptype);
@@ -1191,6 +1283,13 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
     eeprom_write_check(ap, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
     eeprom_write_check(&phdr, ofs, sizeof(phdr));
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    {
+        WITH_SEMAPHORE(_storage_index_sem);
+        storage_index_insert(phdr, ofs);
+    }
+#endif
+
     if (send_to_gcs) {
         send_parameter(name, (enum ap_var_type)phdr.type, idx);
     }
@@ -1201,19 +1300,28 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
 */
 void AP_Param::save(bool force_save)
 {
-    struct param_save p, p2;
-    p.param = this;
-    p.force_save = force_save;
-    if (save_queue.peek(p2) &&
-        p2.param == this &&
-        p2.force_save == force_save) {
-        // this one is already at the head of the list to be
-        // saved. This check is cheap and catches the case where we
-        // are flooding the save queue with one parameter (eg. mission
-        // creation, changing MIS_TOTAL)
-        return;
-    }
-    while (!save_queue.push(p)) {
+    while (true) {
+        {
+            WITH_SEMAPHORE(save_queue.sem);
+            for (uint8_t i=0; i<save_queue.count; i++) {
+                struct param_save &p = save_queue.pending[(save_queue.head + i) % AP_PARAM_SAVE_QUEUE_LENGTH];
+                if (p.param == this) {
+                    // this one is already waiting to be saved. This
+                    // catches the case where we are flooding the save
+                    // queue with one parameter (eg. mission creation,
+                    // changing MIS_TOTAL, or autotune updating gains)
+                    p.force_save |= force_save;
+                    return;
+                }
+            }
+            if (save_queue.count < AP_PARAM_SAVE_QUEUE_LENGTH) {
+                struct param_save &p = save_queue.pending[(save_queue.head + save_queue.count) % AP_PARAM_SAVE_QUEUE_LENGTH];
+                p.param = this;
+                p.force_save = force_save;
+                save_queue.count++;
+                return;
+            }
+        }
         // if we can't save to the queue
         if (hal.util->get_soft_armed() && hal.scheduler->in_main_thread()) {
             // if we are armed in main thread then don't sleep, instead we lose the
@@ -1229,13 +1337,28 @@ void AP_Param::save(bool force_save)
     }
 }
 
+/*
+  take the oldest entry from the save queue
+ */
+bool AP_Param::save_queue_pop(struct param_save &p)
+{
+    WITH_SEMAPHORE(save_queue.sem);
+    if (save_queue.count == 0) {
+        return false;
+    }
+    p = save_queue.pending[save_queue.head];
+    save_queue.head = (save_queue.head + 1) % AP_PARAM_SAVE_QUEUE_LENGTH;
+    save_queue.count--;
+    return true;
+}
+
 /*
   background function for saving parameters. This runs on the IO thread
  */
 void AP_Param::save_io_handler(void)
 {
     struct param_save p;
-    while (save_queue.pop(p)) {
+    while (save_queue_pop(p)) {
         p.param->save_sync(p.force_save, true);
     }
     if (hal.scheduler->is_system_initialized()) {
@@ -1250,7 +1373,7 @@ void AP_Param::save_io_handler(void)
 void AP_Param::flush(void)
 {
     uint16_t counter = 200; // 2 seconds max
-    while (counter-- && save_queue.available()) {
+    while (counter-- && save_queue.count != 0) {
         hal.scheduler->expect_delay_ms(10);
         hal.scheduler->delay(10);
         hal.scheduler->expect_delay_ms(0);
@@ -1481,6 +1604,7 @@ bool AP_Param::load_all()
 {
     struct Param_header phdr;
     uint16_t ofs = sizeof(AP_Param::EEPROM_header);
+    const uint32_t start_us = AP_HAL::micros();
 
     reload_defaults_file(false);
 
@@ -1488,13 +1612,23 @@ bool AP_Param::load_all()
         registered_save_handler = true;
         hal.scheduler->register_io_process(FUNCTOR_BIND((&save_dummy), &AP_Param::save_io_handler, void));
     }
-    
+
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    // rebuild the storage offset table as we walk storage
+    WITH_SEMAPHORE(_storage_index_sem);
+    storage_index_clear();
+    _storage_index_valid = true;
+#endif
+
+    bool found_sentinal = false;
+    uint16_t count = 0;
     while (ofs < _storage.size()) {
         _storage.read_block(&phdr, ofs, sizeof(phdr));
         if (is_sentinal(phdr)) {
             // we've reached the sentinal
             sentinal_offset = ofs;
-            return true;
+            found_sentinal = true;
+            break;
         }
 
         const struct AP_Param::Info *info;
@@ -1505,14 +1639,154 @@ bool AP_Param::load_all()
             _storage.read_block(ptr, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
         }
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+        if (_storage_index_valid &&
+            (_storage_index_count < _storage_index_size || storage_index_grow())) {
+            // entries are appended in storage order, and sorted below
+            _storage_index[_storage_index_count].header = header_key(phdr);
+            _storage_index[_storage_index_count].ofs = ofs;
+            _storage_index_count++;
+        }
+#endif
+
+        count++;
         ofs += type_size((enum ap_var_type)phdr.type) + sizeof(phdr);
     }
 
-    // we didn't find the sentinal
-    Debug("no sentinal in load_all");
-    return false;
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    if (found_sentinal && _storage_index_valid) {
+        storage_index_sort();
+    } else {
+        // fall back to walking storage in scan()
+        storage_index_clear();
+    }
+#endif
+
+    if (!found_sentinal) {
+        // we didn't find the sentinal
+        Debug("no sentinal in load_all");
+        return false;
+    }
+
+    hal.console->printf("Loaded %u parameters in %u ms\n",
+                        (unsigned)count, (unsigned)((AP_HAL::micros() - start_us) / 1000U));
+    return true;
+}
+
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+/*
+  return a parameter header as a single value for the storage table
+ */
+uint32_t AP_Param::header_key(const Param_header &phdr)
+{
+    uint32_t key;
+    memcpy(&key, &phdr, sizeof(key));
+    return key;
+}
+
+/*
+  empty the storage offset table, marking it invalid. Called with
+  _storage_index_sem held
+ */
+void AP_Param::storage_index_clear(void)
+{
+    _storage_index_count = 0;
+    _storage_index_valid = false;
 }
 
+/*
+  expand the storage offset table. On allocation failure the table is
+  freed and marked invalid. Called with _storage_index_sem held
+ */
+bool AP_Param::storage_index_grow(void)
+{
+    const uint16_t new_size = _storage_index_size + 64;
+    struct storage_offset *new_index = new storage_offset[new_size];
+    if (new_index == nullptr) {
+        delete[] _storage_index;
+        _storage_index = nullptr;
+        _storage_index_size = 0;
+        storage_index_clear();
+        return false;
+    }
+    if (_storage_index != nullptr) {
+        memcpy(new_index, _storage_index, _storage_index_count * sizeof(storage_offset));
+        delete[] _storage_index;
+    }
+    _storage_index = new_index;
+    _storage_index_size = new_size;
+    return true;
+}
+
+/*
+  sort the storage table by header after load_all(), keeping the first
+  stored copy of any duplicated header as scan() would. Called with
+  _storage_index_sem held
+ */
+void AP_Param::storage_index_sort(void)
+{
+    qsort(_storage_index, _storage_index_count, sizeof(storage_offset), [](const void *v1, const void *v2) {
+        const storage_offset *s1 = (const storage_offset *)v1;
+        const storage_offset *s2 = (const storage_offset *)v2;
+        if (s1->header != s2->header) {
+            return s1->header < s2->header ? -1 : 1;
+        }
+        return (int)s1->ofs - (int)s2->ofs;
+    });
+    uint16_t n = 0;
+    for (uint16_t i=0; i<_storage_index_count; i++) {
+        if (n > 0 && _storage_index[n-1].header == _storage_index[i].header) {
+            continue;
+        }
+        _storage_index[n++] = _storage_index[i];
+    }
+    _storage_index_count = n;
+}
+
+/*
+  find the position of a header in the storage table, or the position
+  it should be inserted at if not found. Called with
+  _storage_index_sem held
+ */
+bool AP_Param::storage_index_find(uint32_t header, uint16_t &idx)
+{
+    uint16_t lo = 0, hi = _storage_index_count;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (_storage_index[mid].header < header) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    idx = lo;
+    return lo < _storage_index_count && _storage_index[lo].header == header;
+}
+
+/*
+  add a newly stored parameter to the storage table. Called with
+  _storage_index_sem held
+ */
+void AP_Param::storage_index_insert(const Param_header &phdr, uint16_t ofs)
+{
+    if (!_storage_index_valid) {
+        return;
+    }
+    const uint32_t header = header_key(phdr);
+    uint16_t idx;
+    if (storage_index_find(header, idx)) {
+        return;
+    }
+    if (_storage_index_count >= _storage_index_size && !storage_index_grow()) {
+        return;
+    }
+    memmove(&_storage_index[idx+1], &_storage_index[idx], (_storage_index_count - idx) * sizeof(storage_offset));
+    _storage_index[idx].header = header;
+    _storage_index[idx].ofs = ofs;
+    _storage_index_count++;
+}
+#endif // AP_PARAM_STORAGE_INDEX_ENABLED
+
 /*
  * reload from hal.util defaults file or embedded param region
  * @last_pass: if this is the last pass on defaults - unknown parameters are
@@ -1609,6 +1883,9 @@ AP_Param *AP_Param::first(ParamToken *token, enum ap_var_type *ptype)
     token->key = 0;
     token->group_element = 0;
     token->idx = 0;
+#if AP_PARAM_INDEX_ENABLED
+    _index.cursor = 0;
+#endif
     if (_num_vars == 0) {
         return nullptr;
     }
@@ -1769,6 +2046,35 @@ AP_Param *AP_Param::next(ParamToken *token, enum ap_var_type *ptype, bool skip_d
 /// as needed
 AP_Param *AP_Param::next_scalar(ParamToken *token, enum ap_var_type *ptype)
 {
+#if AP_PARAM_INDEX_ENABLED
+    {
+        /*
+          sequential iteration (eg. a GCS parameter download) follows
+          the cursor through the index rather than re-walking the
+          group tree for every parameter
+         */
+        WITH_SEMAPHORE(_index_sem);
+        if (_index.valid && _index.marker == _count_marker) {
+            const uint16_t c = _index.cursor;
+            if (c < _index.count &&
+                _index.entries[c].token.key == token->key &&
+                _index.entries[c].token.group_element == token->group_element &&
+                _index.entries[c].token.idx == token->idx &&
+                _index.entries[c].token.last_disabled == token->last_disabled) {
+                if (c+1 >= _index.count) {
+                    return nullptr;
+                }
+                const index_entry &e = _index.entries[c+1];
+                *token = e.token;
+                if (ptype != nullptr) {
+                    *ptype = (enum ap_var_type)e.type;
+                }
+                _index.cursor = c+1;
+                return e.ap;
+            }
+        }
+    }
+#endif
     AP_Param *ap;
     enum ap_var_type type;
     while ((ap = next(token, &type, true)) != nullptr && type > AP_PARAM_FLOAT) ;
@@ -2263,6 +2569,11 @@ bool AP_Param::count_embedded_param_defaults(uint16_t &count)
  */
 void AP_Param::load_embedded_param_defaults(bool last_pass)
 {
+    if (embedded_param_defaults_bin()) {
+        load_embedded_param_defaults_bin(last_pass);
+        return;
+    }
+
     delete[] param_overrides;
     param_overrides = nullptr;
     num_param_overrides = 0;
@@ -2337,6 +2648,123 @@ void AP_Param::load_embedded_param_defaults(bool last_pass)
     }
     num_param_overrides = num_defaults;
 }
+
+/*
+  return true if the embedded defaults are in the binary form
+ */
+bool AP_Param::embedded_param_defaults_bin(void)
+{
+    static const uint8_t marker[4] { 0, 'P', 'D', 'B' };
+    param_defaults_bin_header hdr;
+    if (param_defaults_data.length < sizeof(hdr)) {
+        return false;
+    }
+    memcpy(&hdr, (const void *)param_defaults_data.data, sizeof(hdr));
+    return memcmp(hdr.marker, marker, sizeof(marker)) == 0;
+}
+
+/*
+  binary search the sorted binary defaults table for a name
+ */
+bool AP_Param::embedded_param_defaults_bin_find(const char *name, uint16_t count, uint16_t &pos)
+{
+    const volatile char *table = param_defaults_data.data + sizeof(param_defaults_bin_header);
+    uint16_t low = 0;
+    uint16_t high = count;
+    while (low < high) {
+        const uint16_t mid = (low + high) / 2;
+        char entry_name[AP_MAX_NAME_SIZE];
+        memcpy(entry_name, (const void *)&table[mid * sizeof(param_defaults_bin_entry)], sizeof(entry_name));
+        const int cmp = strncmp(name, entry_name, AP_MAX_NAME_SIZE);
+        if (cmp == 0) {
+            pos = mid;
+            return true;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return false;
+}
+
+/*
+  load defaults from the binary form of the embedded region. Looking
+  up each name with find() walks the parameter tree once per default,
+  so instead walk the tree once and look each parameter up in the
+  sorted table. The count is in the header so no counting pass is
+  needed either
+ */
+void AP_Param::load_embedded_param_defaults_bin(bool last_pass)
+{
+    delete[] param_overrides;
+    param_overrides = nullptr;
+    num_param_overrides = 0;
+    num_read_only = 0;
+
+    param_defaults_bin_header hdr;
+    memcpy(&hdr, (const void *)param_defaults_data.data, sizeof(hdr));
+    const uint16_t max_count = (param_defaults_data.length - sizeof(hdr)) / sizeof(param_defaults_bin_entry);
+    const uint16_t count = MIN(hdr.count, max_count);
+    if (count == 0) {
+        return;
+    }
+
+    // overrides are first held at the position of their table entry
+    // so unknown names can be found and reported afterwards
+    param_overrides = new param_override[count];
+    if (param_overrides == nullptr) {
+        AP_HAL::panic("AP_Param: Failed to allocate overrides");
+        return;
+    }
+
+    const volatile char *table = param_defaults_data.data + sizeof(hdr);
+    ParamToken token {};
+    enum ap_var_type var_type;
+    for (AP_Param *vp = first(&token, &var_type);
+         vp != nullptr;
+         vp = next(&token, &var_type)) {
+        if (var_type > AP_PARAM_FLOAT) {
+            // vectors are matched by their elements
+            continue;
+        }
+        char name[AP_MAX_NAME_SIZE+1];
+        vp->copy_name_token(token, name, sizeof(name), true);
+        name[AP_MAX_NAME_SIZE] = 0;
+        uint16_t pos;
+        if (!embedded_param_defaults_bin_find(name, count, pos) ||
+            param_overrides[pos].object_ptr != nullptr) {
+            continue;
+        }
+        param_defaults_bin_entry entry;
+        memcpy(&entry, (const void *)&table[pos * sizeof(entry)], sizeof(entry));
+        param_overrides[pos].object_ptr = vp;
+        param_overrides[pos].value = entry.value;
+        param_overrides[pos].read_only = (entry.flags & param_defaults_bin_readonly) != 0;
+        if (!vp->configured_in_storage()) {
+            vp->set_float(entry.value, var_type);
+        }
+    }
+
+    uint16_t num_defaults = 0;
+    for (uint16_t i=0; i<count; i++) {
+        if (param_overrides[i].object_ptr == nullptr) {
+            if (last_pass) {
+                char name[AP_MAX_NAME_SIZE+1] {};
+                memcpy(name, (const void *)&table[i * sizeof(param_defaults_bin_entry)], AP_MAX_NAME_SIZE);
+                ::printf("Ignored unknown param %s from embedded table\n", name);
+                hal.console->printf("Ignored unknown param %s from embedded table\n", name);
+            }
+            continue;
+        }
+        if (param_overrides[i].read_only) {
+            num_read_only++;
+        }
+        param_overrides[num_defaults++] = param_overrides[i];
+    }
+    num_param_overrides = num_defaults;
+}
 #endif // AP_PARAM_MAX_EMBEDDED_PARAM > 0
 
 /* 
@@ -2399,6 +2827,11 @@ uint16_t AP_Param::count_parameters(void)
     WITH_SEMAPHORE(_count_sem);
     if (_parameter_count != 0 &&
         _count_marker == _count_marker_done) {
+#if AP_PARAM_INDEX_ENABLED
+        if (index_needs_build()) {
+            index_build(_parameter_count, _count_marker_done);
+        }
+#endif
         return _parameter_count;
     }
     /*
@@ -2422,9 +2855,159 @@ uint16_t AP_Param::count_parameters(void)
         _parameter_count = count;
         _count_marker_done = marker;
     }
+#if AP_PARAM_INDEX_ENABLED
+    if (index_needs_build()) {
+        index_build(_parameter_count, _count_marker_done);
+    }
+#endif
     return _parameter_count;
 }
 
+#if AP_PARAM_INDEX_ENABLED
+/*
+  case insensitive FNV-1a hash of a parameter name
+ */
+uint32_t AP_Param::name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+    for (uint8_t i=0; i<AP_MAX_NAME_SIZE && name[i] != 0; i++) {
+        char c = name[i];
+        if (c >= 'a' && c <= 'z') {
+            c -= 'a' - 'A';
+        }
+        hash ^= (uint8_t)c;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/*
+  return true if the index should be rebuilt for the current parameter
+  count. We wait until the vehicle is initialised so that dynamically
+  allocated parameter groups are present
+ */
+bool AP_Param::index_needs_build(void)
+{
+    return hal.scheduler->is_system_initialized() &&
+        (!_index.built || _index.marker != _count_marker_done);
+}
+
+/*
+  rebuild the parameter index. Called with _count_sem held
+ */
+void AP_Param::index_build(uint16_t count, uint16_t marker)
+{
+    WITH_SEMAPHORE(_index_sem);
+
+    _index.valid = false;
+    _index.built = true;
+    _index.marker = marker;
+    _index.cursor = 0;
+
+    if (count > _index.size) {
+        delete[] _index.entries;
+        delete[] _index.hashes;
+        _index.size = 0;
+        _index.entries = new index_entry[count];
+        _index.hashes = new index_hash[count];
+        if (_index.entries == nullptr || _index.hashes == nullptr) {
+            // not enough memory, fall back to walking the tree
+            delete[] _index.entries;
+            delete[] _index.hashes;
+            _index.entries = nullptr;
+            _index.hashes = nullptr;
+            return;
+        }
+        _index.size = count;
+    }
+
+    ParamToken token {};
+    enum ap_var_type type;
+    uint16_t n = 0;
+    for (AP_Param *ap = first(&token, &type);
+         ap != nullptr;
+         ap = next_scalar(&token, &type)) {
+        if (n >= count) {
+            // the tree changed under us
+            return;
+        }
+        char name[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(token, name, AP_MAX_NAME_SIZE);
+        name[AP_MAX_NAME_SIZE] = 0;
+        _index.entries[n].ap = ap;
+        _index.entries[n].token = token;
+        _index.entries[n].type = type;
+        _index.hashes[n].hash = name_hash(name);
+        _index.hashes[n].pos = n;
+        n++;
+    }
+    if (n != count) {
+        return;
+    }
+
+    // sort by hash, keeping next_scalar() order for equal hashes so
+    // duplicate names resolve the same way as the tree walk
+    qsort(_index.hashes, n, sizeof(index_hash), [](const void *v1, const void *v2) {
+        const index_hash *h1 = (const index_hash *)v1;
+        const index_hash *h2 = (const index_hash *)v2;
+        if (h1->hash != h2->hash) {
+            return h1->hash < h2->hash ? -1 : 1;
+        }
+        return (int)h1->pos - (int)h2->pos;
+    });
+
+    _index.count = n;
+    _index.valid = true;
+}
+
+/*
+  return true if the index can be used for lookups, building it if
+  needed
+ */
+bool AP_Param::index_available(void)
+{
+    if (!hal.scheduler->is_system_initialized()) {
+        return false;
+    }
+    if (_index.marker != _count_marker || !_index.valid) {
+        count_parameters();
+    }
+    return _index.valid && _index.marker == _count_marker;
+}
+
+/*
+  find a parameter in the index by name. Called with _index_sem held
+ */
+bool AP_Param::index_find(const char *name, uint16_t &pos)
+{
+    const uint32_t hash = name_hash(name);
+
+    // find the first entry with a matching hash
+    uint16_t lo = 0, hi = _index.count;
+    while (lo < hi) {
+        const uint16_t mid = (lo + hi) / 2;
+        if (_index.hashes[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // check names to cope with hash collisions
+    for (uint16_t i=lo; i<_index.count && _index.hashes[i].hash == hash; i++) {
+        const index_entry &e = _index.entries[_index.hashes[i].pos];
+        char buf[AP_MAX_NAME_SIZE+1];
+        e.ap->copy_name_token(e.token, buf, AP_MAX_NAME_SIZE);
+        buf[AP_MAX_NAME_SIZE] = 0;
+        if (strncasecmp(name, buf, AP_MAX_NAME_SIZE) == 0) {
+            pos = _index.hashes[i].pos;
+            return true;
+        }
+    }
+    return false;
+}
+#endif // AP_PARAM_INDEX_ENABLED
+
 /*
   invalidate parameter count cache
  */
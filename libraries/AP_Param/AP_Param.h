@@ -46,6 +46,33 @@
 #endif
 #endif
 
+/*
+  number of pending background parameter saves
+ */
+#ifndef AP_PARAM_SAVE_QUEUE_LENGTH
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define AP_PARAM_SAVE_QUEUE_LENGTH 64
+#else
+#define AP_PARAM_SAVE_QUEUE_LENGTH 30
+#endif
+#endif
+
+/*
+  keep an index of the scalar parameters, allowing name lookups and
+  sequential iteration without walking the var_info tree
+ */
+#ifndef AP_PARAM_INDEX_ENABLED
+#define AP_PARAM_INDEX_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+/*
+  keep a table of storage offsets for stored parameters, so that loads
+  and saves don't need to walk storage
+ */
+#ifndef AP_PARAM_STORAGE_INDEX_ENABLED
+#define AP_PARAM_STORAGE_INDEX_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
 /*
   flags for variables in var_info and group tables
  */
@@ -587,6 +614,24 @@ private:
         volatile char data[AP_PARAM_MAX_EMBEDDED_PARAM];
     };
     static const param_defaults_struct param_defaults_data;
+
+    /*
+      binary form of the embedded defaults, written by apj_tool.py
+      --binary. A header is followed by entries sorted by name so the
+      table can be matched against the parameter tree without parsing
+      any text. A text file can't start with a nul, so the marker
+      tells the two forms apart
+     */
+    struct PACKED param_defaults_bin_header {
+        uint8_t marker[4]; // 0, 'P', 'D', 'B'
+        uint16_t count;
+    };
+    struct PACKED param_defaults_bin_entry {
+        char name[AP_MAX_NAME_SIZE]; // nul padded, not terminated if AP_MAX_NAME_SIZE long
+        float value;
+        uint8_t flags;
+    };
+    static const uint8_t param_defaults_bin_readonly = 1U<<0;
 #endif
 
 
@@ -637,6 +682,9 @@ private:
                                     char *buffer,
                                     size_t buffer_size,
                                     uint8_t idx) const;
+    static AP_Param *           find_linear(
+                                    const char *name,
+                                    enum ap_var_type *ptype);
     static AP_Param *           find_group(
                                     const char *name,
                                     uint16_t vindex,
@@ -684,6 +732,9 @@ private:
      */
     static bool count_embedded_param_defaults(uint16_t &count);
     static void load_embedded_param_defaults(bool last_pass);
+    static bool embedded_param_defaults_bin(void);
+    static bool embedded_param_defaults_bin_find(const char *name, uint16_t count, uint16_t &pos);
+    static void load_embedded_param_defaults_bin(bool last_pass);
 
     // send a parameter to all GCS instances
     void send_parameter(const char *name, enum ap_var_type param_header_type, uint8_t idx) const;
@@ -697,6 +748,66 @@ private:
     static HAL_Semaphore        _count_sem;
     static const struct Info *  _var_info;
 
+#if AP_PARAM_STORAGE_INDEX_ENABLED
+    /*
+      table of storage offsets for each stored parameter header,
+      sorted by header. Built by load_all() so that scan() is a binary
+      search rather than a walk of storage
+     */
+    struct storage_offset {
+        uint32_t header;
+        uint16_t ofs;
+    };
+    static struct storage_offset *_storage_index;
+    static uint16_t             _storage_index_count;
+    static uint16_t             _storage_index_size;
+    static bool                 _storage_index_valid;
+    static HAL_Semaphore        _storage_index_sem;
+
+    static uint32_t             header_key(const Param_header &phdr);
+    static bool                 storage_index_grow(void);
+    static void                 storage_index_clear(void);
+    static bool                 storage_index_find(uint32_t header, uint16_t &idx);
+    static void                 storage_index_insert(const Param_header &phdr, uint16_t ofs);
+    static void                 storage_index_sort(void);
+#endif
+
+#if AP_PARAM_INDEX_ENABLED
+    /*
+      index of all scalar parameters, built alongside the parameter
+      count once the vehicle has finished initialising. Entries are
+      held in next_scalar() order, with a second table sorted by a
+      hash of the parameter name for find() and find_by_name()
+     */
+    struct PACKED index_entry {
+        AP_Param *ap;
+        ParamToken token;
+        uint8_t type;
+    };
+    struct PACKED index_hash {
+        uint32_t hash;
+        uint16_t pos;
+    };
+    struct param_index {
+        index_entry *entries;
+        index_hash *hashes;
+        uint16_t size;      // allocated length of both tables
+        uint16_t count;
+        uint16_t marker;    // _count_marker when the index was built
+        uint16_t cursor;    // position of the last token returned by next_scalar()
+        bool built;         // a build has been attempted
+        bool valid;
+    };
+    static struct param_index   _index;
+    static HAL_Semaphore        _index_sem;
+
+    static uint32_t             name_hash(const char *name);
+    static bool                 index_needs_build(void);
+    static void                 index_build(uint16_t count, uint16_t marker);
+    static bool                 index_available(void);
+    static bool                 index_find(const char *name, uint16_t &pos);
+#endif
+
     /*
       list of overridden values from load_defaults_file()
     */
@@ -722,8 +833,18 @@ private:
         AP_Param *param;
         bool force_save;
     };
-    static ObjectBuffer_TS<struct param_save> save_queue;
+    /*
+      queue of pending saves. Repeated saves of a parameter that is
+      already queued are merged into the existing entry
+     */
+    static struct save_queue_state {
+        struct param_save pending[AP_PARAM_SAVE_QUEUE_LENGTH];
+        uint8_t head;
+        uint8_t count;
+        HAL_Semaphore sem;
+    } save_queue;
     static bool registered_save_handler;
+    static bool save_queue_pop(struct param_save &p);
 
     // background function for saving parameters
     void save_io_handler(void);
@@ -0,0 +1,117 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a parameter tree of BENCH_NUM_GROUPS groups of BENCH_GROUP_SIZE
+  parameters, which is about the size of a vehicle's tree
+ */
+#define BENCH_NUM_GROUPS 40
+#define BENCH_GROUP_SIZE 16
+
+class BenchGroup {
+public:
+    BenchGroup() {
+        AP_Param::setup_object_defaults(this, var_info);
+    }
+
+    static const struct AP_Param::GroupInfo var_info[];
+
+private:
+    AP_Int8 enable;
+    AP_Int16 options;
+    AP_Float value[BENCH_GROUP_SIZE-2];
+};
+
+#define BENCH_VALUE(n) AP_GROUPINFO("V" #n, n+2, BenchGroup, value[n], n)
+
+const AP_Param::GroupInfo BenchGroup::var_info[] = {
+    AP_GROUPINFO("ENABLE", 0, BenchGroup, enable, 1),
+    AP_GROUPINFO("OPTIONS", 1, BenchGroup, options, 0),
+    BENCH_VALUE(0), BENCH_VALUE(1), BENCH_VALUE(2), BENCH_VALUE(3),
+    BENCH_VALUE(4), BENCH_VALUE(5), BENCH_VALUE(6), BENCH_VALUE(7),
+    BENCH_VALUE(8), BENCH_VALUE(9), BENCH_VALUE(10), BENCH_VALUE(11),
+    BENCH_VALUE(12), BENCH_VALUE(13),
+    AP_GROUPEND
+};
+
+static BenchGroup groups[BENCH_NUM_GROUPS];
+
+#define BENCH_GROUP(n) { AP_PARAM_GROUP, "G" #n "_", n, &groups[n], { group_info : BenchGroup::var_info }, 0 }
+
+static const AP_Param::Info var_info[] = {
+    BENCH_GROUP(0), BENCH_GROUP(1), BENCH_GROUP(2), BENCH_GROUP(3), BENCH_GROUP(4),
+    BENCH_GROUP(5), BENCH_GROUP(6), BENCH_GROUP(7), BENCH_GROUP(8), BENCH_GROUP(9),
+    BENCH_GROUP(10), BENCH_GROUP(11), BENCH_GROUP(12), BENCH_GROUP(13), BENCH_GROUP(14),
+    BENCH_GROUP(15), BENCH_GROUP(16), BENCH_GROUP(17), BENCH_GROUP(18), BENCH_GROUP(19),
+    BENCH_GROUP(20), BENCH_GROUP(21), BENCH_GROUP(22), BENCH_GROUP(23), BENCH_GROUP(24),
+    BENCH_GROUP(25), BENCH_GROUP(26), BENCH_GROUP(27), BENCH_GROUP(28), BENCH_GROUP(29),
+    BENCH_GROUP(30), BENCH_GROUP(31), BENCH_GROUP(32), BENCH_GROUP(33), BENCH_GROUP(34),
+    BENCH_GROUP(35), BENCH_GROUP(36), BENCH_GROUP(37), BENCH_GROUP(38), BENCH_GROUP(39),
+    AP_VAREND
+};
+
+static AP_Param param_loader(var_info);
+
+// names spread through the tree, as a GCS setting parameters would use
+static const char *find_names[] = {
+    "G0_ENABLE", "G7_V3", "G19_OPTIONS", "G26_V11", "G33_V0", "G39_V13",
+};
+
+static void BM_ParamFind(benchmark::State& state)
+{
+    // counting builds the lookup index where it is enabled
+    AP_Param::count_parameters();
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        enum ap_var_type ptype;
+        AP_Param *vp = AP_Param::find(find_names[i++ % ARRAY_SIZE(find_names)], &ptype);
+        gbenchmark_escape(&vp);
+    }
+}
+
+BENCHMARK(BM_ParamFind);
+
+// one iteration is a whole walk of the tree, as for a parameter download
+static void BM_ParamNextScalar(benchmark::State& state)
+{
+    AP_Param::count_parameters();
+
+    while (state.KeepRunning()) {
+        AP_Param::ParamToken token {};
+        enum ap_var_type ptype;
+        uint16_t count = 0;
+        for (AP_Param *vp = AP_Param::first(&token, &ptype);
+             vp != nullptr;
+             vp = AP_Param::next_scalar(&token, &ptype)) {
+            count++;
+        }
+        gbenchmark_escape(&count);
+    }
+}
+
+BENCHMARK(BM_ParamNextScalar);
+
+static void BM_ParamCopyName(benchmark::State& state)
+{
+    AP_Param::ParamToken token {};
+    enum ap_var_type ptype;
+    AP_Param *vp = AP_Param::first(&token, &ptype);
+    for (uint16_t i = 0; i < BENCH_NUM_GROUPS * BENCH_GROUP_SIZE / 2; i++) {
+        vp = AP_Param::next_scalar(&token, &ptype);
+    }
+    char name[AP_MAX_NAME_SIZE+1];
+
+    while (state.KeepRunning()) {
+        vp->copy_name_token(token, name, sizeof(name), true);
+        gbenchmark_escape(name);
+    }
+}
+
+BENCHMARK(BM_ParamCopyName);
+
+BENCHMARK_MAIN();
@@ -204,9 +204,20 @@ void AP_Proximity_Backend::database_push(float angle, float pitch, float distanc
     if (oaDb == nullptr || !oaDb->healthy()) {
         return;
     }
+    Vector3f temp_pos;
+    if (!database_object_position(angle, pitch, distance, current_pos, body_to_ned, temp_pos)) {
+        return;
+    }
+
+    oaDb->queue_push(temp_pos, timestamp_ms, distance);
+}
+
+// calculate an object's position as a NEU offset in meters from the EKF origin
+bool AP_Proximity_Backend::database_object_position(float angle, float pitch, float distance, const Vector3f &current_pos, const Matrix3f &body_to_ned, Vector3f &pos)
+{
     if ((pitch > 90.0f) || (pitch < -90.0f)) {
         // sanity check on pitch
-        return;
+        return false;
     }
     //Assume object is angle and pitch bearing and distance meters away from the vehicle 
     Vector3f object_3D;
@@ -214,11 +225,42 @@ void AP_Proximity_Backend::database_push(float angle, float pitch, float distanc
     const Vector3f rotated_object_3D = body_to_ned * object_3D;
 
     //Calculate the position vector from origin
-    Vector3f temp_pos = current_pos + rotated_object_3D;
+    pos = current_pos + rotated_object_3D;
     //Convert the vector to a NEU frame from NED
-    temp_pos.z = temp_pos.z * -1.0f;
+    pos.z = pos.z * -1.0f;
+    return true;
+}
 
-    oaDb->queue_push(temp_pos, timestamp_ms, distance);
+// add a point to a batch of points for the Object Avoidance database
+// the vehicle's position and attitude are taken once per batch
+void AP_Proximity_Backend::database_batch_add(DatabaseBatch &batch, float angle, float distance)
+{
+    if (batch.count >= ARRAY_SIZE(batch.pos)) {
+        database_batch_push(batch);
+    }
+    if (batch.count == 0) {
+        if (!database_prepare_for_push(batch.current_pos, batch.body_to_ned)) {
+            return;
+        }
+        batch.timestamp_ms = AP_HAL::millis();
+    }
+    if (database_object_position(angle, 0.0f, distance, batch.current_pos, batch.body_to_ned, batch.pos[batch.count])) {
+        batch.distance[batch.count] = distance;
+        batch.count++;
+    }
+}
+
+// push a batch of points to the Object Avoidance database in one operation
+void AP_Proximity_Backend::database_batch_push(DatabaseBatch &batch)
+{
+    if (batch.count == 0) {
+        return;
+    }
+    AP_OADatabase *oaDb = AP::oadatabase();
+    if (oaDb != nullptr) {
+        oaDb->queue_push(batch.pos, batch.distance, batch.count, batch.timestamp_ms);
+    }
+    batch.count = 0;
 }
 
 #endif // HAL_PROXIMITY_ENABLED
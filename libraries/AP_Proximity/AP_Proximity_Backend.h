@@ -25,6 +25,7 @@
 #define PROXIMITY_GND_DETECT_THRESHOLD 1.0f // set ground detection threshold to be 1 meters
 #define PROXIMITY_ALT_DETECT_TIMEOUT_MS 500 // alt readings should arrive within this much time
 #define PROXIMITY_BOUNDARY_3D_TIMEOUT_MS 750 // we should check the 3D boundary faces after every this many ms
+#define PROXIMITY_DB_BATCH_MAX 16           // maximum number of points held in a DatabaseBatch
 
 class AP_Proximity_Backend
 {
@@ -112,6 +113,22 @@ protected:
     };
     static void database_push(float angle, float pitch, float distance, uint32_t timestamp_ms, const Vector3f &current_pos, const Matrix3f &body_to_ned);
 
+    // points from a scan segment collected so they can be pushed to the database in one operation
+    struct DatabaseBatch {
+        Vector3f pos[PROXIMITY_DB_BATCH_MAX];      // object positions as offsets in meters from the EKF origin (NEU)
+        float distance[PROXIMITY_DB_BATCH_MAX];    // distance to each object in meters
+        uint8_t count;                              // number of points in the batch
+        uint32_t timestamp_ms;                      // system time the first point was added
+        Vector3f current_pos;                       // vehicle position when the first point was added
+        Matrix3f body_to_ned;                       // vehicle attitude when the first point was added
+    };
+    // add a point to a batch, pushing the batch first if it is full
+    static void database_batch_add(DatabaseBatch &batch, float angle, float distance);
+    // push all points in a batch to the database and empty it
+    static void database_batch_push(DatabaseBatch &batch);
+    // calculate an object's position (NEU offset in meters from EKF origin) from its body frame angle, pitch and distance
+    static bool database_object_position(float angle, float pitch, float distance, const Vector3f &current_pos, const Matrix3f &body_to_ned, Vector3f &pos);
+
     uint32_t _last_timeout_check_ms;  // time when boundary was checked for non-updated valid faces
 
     // used for ground detection
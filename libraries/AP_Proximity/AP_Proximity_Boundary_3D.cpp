@@ -32,6 +32,9 @@ AP_Proximity_Boundary_3D::AP_Proximity_Boundary_3D()
 //   should be called if the sector_middle_deg or _sector_width_deg arrays are changed
 void AP_Proximity_Boundary_3D::init()
 {
+    for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
+        _sector_middle_deg[sector] = sector * PROXIMITY_SECTOR_WIDTH_DEG;
+    }
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
         const float pitch = ((float)_pitch_middle_deg[layer]);
         for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
@@ -47,7 +50,7 @@ void AP_Proximity_Boundary_3D::init()
 // yaw is the horizontal body-frame angle (in degrees) to the obstacle (0=directly ahead of the vehicle, 90 is to the right of the vehicle)
 AP_Proximity_Boundary_3D::Face AP_Proximity_Boundary_3D::get_face(float pitch, float yaw) const
 {   
-    const uint8_t sector = wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / 45.0f;
+    const uint8_t sector = MIN(wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) * (PROXIMITY_NUM_SECTORS / 360.0f), PROXIMITY_NUM_SECTORS - 1);
     const float pitch_limited = constrain_float(pitch, -75.0f, 74.9f);
     const uint8_t layer = (pitch_limited + 75.0f)/PROXIMITY_PITCH_WIDTH_DEG;
     return Face{layer, sector};
@@ -372,17 +375,27 @@ bool AP_Proximity_Boundary_3D::get_layer_distances(uint8_t layer_number, float d
     prx_filt_dist_array.offset_valid = 0;
     for (uint8_t i=0; i<PROXIMITY_MAX_DIRECTION; i++) {
         prx_dist_array.orientation[i] = i;
-        const AP_Proximity_Boundary_3D::Face face(layer_number, i);
-        if (!face.valid()) {
-            return false;
-        }
-        if (get_distance(face, prx_dist_array.distance[i]) && get_filtered_distance(face, prx_filt_dist_array.distance[i])) {
-            valid_distances = true;
-            prx_dist_array.offset_valid |= (1U << i);
-            prx_filt_dist_array.offset_valid |= (1U << i);
-        } else {
-            prx_dist_array.distance[i] = dist_max;
-            prx_filt_dist_array.distance[i] = dist_max;
+        prx_dist_array.distance[i] = dist_max;
+        prx_filt_dist_array.distance[i] = dist_max;
+
+        // check each sector centred on this direction
+        uint8_t sector = (i * PROXIMITY_SECTORS_PER_DIRECTION + PROXIMITY_NUM_SECTORS - (PROXIMITY_SECTORS_PER_DIRECTION / 2)) % PROXIMITY_NUM_SECTORS;
+        for (uint8_t j=0; j<PROXIMITY_SECTORS_PER_DIRECTION; j++) {
+            const AP_Proximity_Boundary_3D::Face face(layer_number, sector);
+            if (!face.valid()) {
+                return false;
+            }
+            float distance, filt_distance;
+            if (get_distance(face, distance) && get_filtered_distance(face, filt_distance)) {
+                if (((prx_dist_array.offset_valid & (1U << i)) == 0) || (distance < prx_dist_array.distance[i])) {
+                    prx_dist_array.distance[i] = distance;
+                    prx_filt_dist_array.distance[i] = filt_distance;
+                }
+                valid_distances = true;
+                prx_dist_array.offset_valid |= (1U << i);
+                prx_filt_dist_array.offset_valid |= (1U << i);
+            }
+            sector = get_next_sector(sector);
         }
     }
 
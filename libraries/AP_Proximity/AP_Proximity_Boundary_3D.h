@@ -21,11 +21,14 @@
 
 #include <Filter/LowPassFilter.h>
 
+#ifndef PROXIMITY_NUM_SECTORS
 #define PROXIMITY_NUM_SECTORS         8       // number of sectors
+#endif
 #define PROXIMITY_NUM_LAYERS          5       // num of layers in a sector
 #define PROXIMITY_MIDDLE_LAYER        2       // middle layer
 #define PROXIMITY_PITCH_WIDTH_DEG     30      // width between each layer in degrees
 #define PROXIMITY_SECTOR_WIDTH_DEG    (360.0f/PROXIMITY_NUM_SECTORS)   // width of sectors in degrees
+#define PROXIMITY_SECTORS_PER_DIRECTION (PROXIMITY_NUM_SECTORS/PROXIMITY_MAX_DIRECTION) // number of sectors in each of the directions reported to the ground station
 #define PROXIMITY_BOUNDARY_DIST_MIN   0.6f    // minimum distance for a boundary point.  This ensures the object avoidance code doesn't think we are outside the boundary.
 #define PROXIMITY_BOUNDARY_DIST_DEFAULT 100   // if we have no data for a sector, boundary is placed 100m out
 #define PROXIMITY_FILT_RESET_TIME     1000    // reset filter if last distance was pushed more than this many ms away
@@ -55,7 +58,7 @@ public:
 	    bool operator !=(const Face &other) const { return ((layer != other.layer) || (sector != other.sector)); }
 
         uint8_t layer;  // vertical "steps" on the 3D Boundary. 0th layer is the bottom most layer, 1st layer is 30 degrees above (in body frame) and so on
-        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is 45 degrees wide.
+        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is PROXIMITY_SECTOR_WIDTH_DEG wide (45 degrees by default).
     };
 
     // returns face corresponding to the provided yaw and (optionally) pitch
@@ -111,15 +114,17 @@ public:
     // get number of layers
     uint8_t get_num_layers() const { return PROXIMITY_NUM_LAYERS; }
 
-    // get raw and filtered distances in 8 directions per layer.
+    // get raw and filtered distances in 8 directions per layer.  When there are more than 8 sectors the shortest distance
+    // of the sectors in each direction is used
     bool get_layer_distances(uint8_t layer_number, float dist_max, AP_Proximity::Proximity_Distance_Array &prx_dist_array, AP_Proximity::Proximity_Distance_Array &prx_filt_dist_array) const;
 
     // pass down filter cut-off freq from params
     void set_filter_freq(float filt_freq) { _filter_freq = filt_freq; }
 
     // sectors
-    static_assert(PROXIMITY_NUM_SECTORS == 8, "PROXIMITY_NUM_SECTOR must be 8");
-    const uint16_t _sector_middle_deg[PROXIMITY_NUM_SECTORS] {0, 45, 90, 135, 180, 225, 270, 315};    // middle angle of each sector
+    static_assert((PROXIMITY_NUM_SECTORS % PROXIMITY_MAX_DIRECTION) == 0, "PROXIMITY_NUM_SECTORS must be a multiple of PROXIMITY_MAX_DIRECTION");
+    static_assert((PROXIMITY_NUM_SECTORS * PROXIMITY_NUM_LAYERS) <= UINT8_MAX, "PROXIMITY_NUM_SECTORS too large for obstacle numbering");
+    float _sector_middle_deg[PROXIMITY_NUM_SECTORS];    // middle angle of each sector, filled in by init
     // layers
     static_assert(PROXIMITY_NUM_LAYERS == 5, "PROXIMITY_NUM_LAYERS must be 5");
     const int16_t _pitch_middle_deg[PROXIMITY_NUM_LAYERS] {-60, -30, 0, 30, 60};
@@ -204,7 +204,7 @@ bool AP_Proximity_LightWareSF40C_v09::send_request_for_distance()
     char request_str[16];
     snprintf(request_str, sizeof(request_str), "?TS,%u,%u\r\n",
              (unsigned int)PROXIMITY_SECTOR_WIDTH_DEG,
-             boundary._sector_middle_deg[_last_sector]);
+             (unsigned int)boundary._sector_middle_deg[_last_sector]);
     _uart->write(request_str);
 
 
@@ -149,6 +149,8 @@ void AP_Proximity_LightWareSF45B::process_message()
                 // mark previous face invalid
                 boundary.reset_face(_face);
             }
+            // publish the previous face's minisectors to the OA database together
+            database_batch_push(_db_batch);
             // record updated face
             _face = face;
             _face_yaw_deg = 0;
@@ -160,7 +162,7 @@ void AP_Proximity_LightWareSF45B::process_message()
         const uint8_t minisector = convert_angle_to_minisector(angle_deg);
         if (minisector != _minisector) {
             if ((_minisector != UINT8_MAX) && _minisector_distance_valid) {
-                database_push(_minisector_angle, _minisector_distance);
+                database_batch_add(_db_batch, _minisector_angle, _minisector_distance);
             }
             // init mini sector
             _minisector = minisector;
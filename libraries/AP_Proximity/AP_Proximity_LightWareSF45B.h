@@ -86,6 +86,7 @@ private:
     float _face_distance;                   // shortest distance (in meters) on face
     float _face_yaw_deg;                    // yaw angle (in degrees) of shortest distance on face
     bool _face_distance_valid;              // true if face has at least one valid distance
+    DatabaseBatch _db_batch;                // minisector points waiting to be pushed to the OA database
 
     // mini sector (5 degrees) angles and distances (used to populate obstacle database for path planning)
     uint8_t _minisector = UINT8_MAX;        // mini sector number (from 0 to 71) of most recently received distance
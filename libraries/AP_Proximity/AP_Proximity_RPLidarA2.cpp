@@ -320,7 +320,10 @@ void AP_Proximity_RPLidarA2::parse_response_data()
                         // distance is for a new face, the previous one can be updated now
                         if (_last_distance_valid) {
                             boundary.set_face_attributes(_last_face, _last_angle_deg, _last_distance_m);
-                        } else {
+                        }
+                        // publish the previous face's points to the OA database together
+                        database_batch_push(_db_batch);
+                        if (!_last_distance_valid) {
                             // reset distance from last face
                             boundary.reset_face(face);
                         }
@@ -335,9 +338,9 @@ void AP_Proximity_RPLidarA2::parse_response_data()
                             _last_distance_m = distance_m;
                             _last_distance_valid = true;
                             _last_angle_deg = angle_deg;
+                            // update OA database with the new shortest distance for this face
+                            database_batch_add(_db_batch, _last_angle_deg, _last_distance_m);
                         }
-                        // update OA database
-                        database_push(_last_angle_deg, _last_distance_m);
                     }
                 }
             } else {
@@ -35,6 +35,60 @@
 
 extern const AP_HAL::HAL& hal;
 
+// how long a backend keeps being fed bytes after its frame start byte is seen while searching
+#define RCPROTOCOL_SYNC_HOLD_MS 50
+
+/*
+  detection signatures, in rcprotocol_t order. A backend is only fed
+  bytes at its own baudrate, and if it has frame start bytes, only
+  once one of them has been seen recently. The start byte itself is
+  fed, so no frame is lost to the check
+ */
+const AP_RCProtocol::detect_signature AP_RCProtocol::signatures[AP_RCProtocol::NONE] = {
+    // PPM
+    { 0, true, 0, {} },
+    // IBUS, length byte of a 32 byte frame
+    { 115200, true, 1, { 0x20 } },
+    // SBUS
+    { 100000, true, 1, { 0x0F } },
+    // SBUS_NI
+    { 100000, true, 1, { 0x0F } },
+    // DSM frames have no start byte
+    { 115200, true, 0, {} },
+    // SUMD
+    { 115200, true, 1, { 0xA8 } },
+    // SRXL v1, v2 and v5 headers
+    { 115200, true, 3, { SRXL_HEADER_V1, SRXL_HEADER_V2, SRXL_HEADER_V5 } },
+    // SRXL2
+    { 115200, false, 1, { 0xA6 } },
+    // CRSF accepts any device address, its baudrate is unique
+    { CRSF_BAUDRATE, true, 0, {} },
+    // ST24
+    { 115200, true, 1, { ST24_STX1 } },
+    // FPORT
+    { 115200, true, 1, { 0x7E } },
+    // FPORT2, length bytes of the 8, 16 and 24 channel and downlink frames
+    { 115200, true, 4, { 0x0D, 0x18, 0x23, 0x08 } },
+};
+
+bool AP_RCProtocol::signature_match(enum rcprotocol_t protocol, uint8_t byte, uint32_t baudrate, uint32_t now_ms)
+{
+    const detect_signature &sig = signatures[protocol];
+    if (sig.baudrate != baudrate) {
+        return false;
+    }
+    if (sig.num_sync == 0) {
+        return true;
+    }
+    for (uint8_t i = 0; i < sig.num_sync; i++) {
+        if (byte == sig.sync[i]) {
+            _sync_seen_ms[protocol] = now_ms;
+            return true;
+        }
+    }
+    return now_ms - _sync_seen_ms[protocol] < RCPROTOCOL_SYNC_HOLD_MS;
+}
+
 void AP_RCProtocol::init()
 {
     backend[AP_RCProtocol::PPM] = new AP_RCProtocol_PPMSum(*this);
@@ -97,6 +151,9 @@ void AP_RCProtocol::process_pulse(uint32_t width_s0, uint32_t width_s1)
             // this protocol is disabled for pulse input
             continue;
         }
+        if (!signatures[i].pulses) {
+            continue;
+        }
         if (backend[i] != nullptr) {
             if (!protocol_enabled(rcprotocol_t(i))) {
                 continue;
@@ -182,6 +239,10 @@ bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
             if (!protocol_enabled(rcprotocol_t(i))) {
                 continue;
             }
+            if (!signature_match(rcprotocol_t(i), byte, baudrate, now)) {
+                // this byte can't be from this protocol
+                continue;
+            }
             const uint32_t frame_count = backend[i]->get_rc_frame_count();
             const uint32_t input_count = backend[i]->get_rc_input_count();
             backend[i]->process_byte(byte, baudrate);
@@ -98,10 +98,27 @@ private:
     // return true if a specific protocol is enabled
     bool protocol_enabled(enum rcprotocol_t protocol) const;
 
+    /*
+      cheap per-protocol checks used while searching, so backends that
+      can't be receiving this input aren't fed it
+     */
+    struct detect_signature {
+        uint32_t baudrate;      // serial baudrate, 0 if the protocol has no byte input
+        bool pulses;            // true if the protocol can be decoded from pulses
+        uint8_t num_sync;       // number of valid first bytes of a frame, 0 if any byte can start a frame
+        uint8_t sync[4];
+    };
+    static const detect_signature signatures[NONE];
+
+    // return true if a searching backend should be fed this byte
+    bool signature_match(enum rcprotocol_t protocol, uint8_t byte, uint32_t baudrate, uint32_t now_ms);
+
     enum rcprotocol_t _detected_protocol = NONE;
     uint16_t _disabled_for_pulses;
     bool _detected_with_bytes;
     AP_RCProtocol_Backend *backend[NONE];
+    // last time each protocol's frame start byte was seen while searching
+    uint32_t _sync_seen_ms[NONE];
     bool _new_input;
     uint32_t _last_input_ms;
     bool _valid_serial_prot;
@@ -144,6 +144,47 @@ void AP_CRSF_Telem::update_custom_telemetry_rates(AP_RCProtocol_CRSF::RFMode rf_
     }
 }
 
+/*
+  standard telemetry frames have fixed rates that fit the slowest links.
+  Faster links report a higher telemetry rate, so share part of that
+  rate between the broadcast frames by scheduler priority. A frame is
+  never sent slower than its default rate or faster than its cap
+ */
+void AP_CRSF_Telem::update_bcast_telemetry_rates()
+{
+    static const struct {
+        uint8_t slot;
+        uint16_t default_period_ms;
+        uint16_t fastest_period_ms;
+    } bcast_rates[] = {
+        { ATTITUDE,    120,  20 },  //  8Hz - 50Hz
+        { BATTERY,     500, 200 },  //  2Hz -  5Hz
+        { GPS,         280, 100 },  //  3Hz - 10Hz
+        { FLIGHT_MODE, 500, 250 },  //  2Hz -  4Hz
+    };
+
+    // custom telemetry and parameter requests use their own rates
+    if (rc().crsf_custom_telemetry() || _custom_telem.params_mode_active) {
+        return;
+    }
+    const uint16_t avg_rate = get_avg_packet_rate();
+    if (avg_rate == 0 || abs(int16_t(avg_rate) - int16_t(_bcast_budget_rate)) < 5) {
+        return;
+    }
+    _bcast_budget_rate = avg_rate;
+
+    const float budget_hz = avg_rate * CRSF_TELEM_BCAST_BUDGET_PCT * 0.01f;
+    float total_priority = 0;
+    for (const auto &r : bcast_rates) {
+        total_priority += 1.0f / _scheduler.packet_weight[r.slot];
+    }
+    for (const auto &r : bcast_rates) {
+        const float rate_hz = budget_hz * (1.0f / _scheduler.packet_weight[r.slot]) / total_priority;
+        const float period_ms = constrain_float(1000.0f / MAX(rate_hz, 0.1f), r.fastest_period_ms, r.default_period_ms);
+        set_scheduler_entry_min_period(r.slot, uint32_t(period_ms));
+    }
+}
+
 void AP_CRSF_Telem::process_rf_mode_changes()
 {
     const AP_RCProtocol_CRSF::RFMode current_rf_mode = get_rf_mode();
@@ -263,6 +304,7 @@ void AP_CRSF_Telem::adjust_packet_weight(bool queue_empty)
 {
     uint32_t now_ms = AP_HAL::millis();
     setup_custom_telemetry();
+    update_bcast_telemetry_rates();
 
     /*
      whenever we detect a pending request we configure the scheduler
@@ -741,14 +783,14 @@ void AP_CRSF_Telem::calc_gps()
 // prepare attitude data
 void AP_CRSF_Telem::calc_attitude()
 {
-    AP_AHRS &_ahrs = AP::ahrs();
-    WITH_SEMAPHORE(_ahrs.get_semaphore());
+    NavSnapshot nav;
+    get_nav_snapshot(nav);
 
     const int16_t INT_PI = 31415;
     // units are radians * 10000
-    _telem.bcast.attitude.roll_angle = htobe16(constrain_int16(roundf(wrap_PI(_ahrs.roll) * 10000.0f), -INT_PI, INT_PI));
-    _telem.bcast.attitude.pitch_angle = htobe16(constrain_int16(roundf(wrap_PI(_ahrs.pitch) * 10000.0f), -INT_PI, INT_PI));
-    _telem.bcast.attitude.yaw_angle = htobe16(constrain_int16(roundf(wrap_PI(_ahrs.yaw) * 10000.0f), -INT_PI, INT_PI));
+    _telem.bcast.attitude.roll_angle = htobe16(constrain_int16(roundf(wrap_PI(nav.roll) * 10000.0f), -INT_PI, INT_PI));
+    _telem.bcast.attitude.pitch_angle = htobe16(constrain_int16(roundf(wrap_PI(nav.pitch) * 10000.0f), -INT_PI, INT_PI));
+    _telem.bcast.attitude.yaw_angle = htobe16(constrain_int16(roundf(wrap_PI(nav.yaw) * 10000.0f), -INT_PI, INT_PI));
 
     _telem_size = sizeof(AP_CRSF_Telem::AttitudeFrame);
     _telem_type = AP_RCProtocol_CRSF::CRSF_FRAMETYPE_ATTITUDE;
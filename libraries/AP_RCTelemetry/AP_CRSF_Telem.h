@@ -25,6 +25,12 @@
 #define HAL_CRSF_TELEM_TEXT_SELECTION_ENABLED HAL_CRSF_TELEM_ENABLED && BOARD_FLASH_SIZE > 1024
 #endif
 
+// percentage of the measured telemetry rate given to the broadcast
+// frames when scaling their rates to the link
+#ifndef CRSF_TELEM_BCAST_BUDGET_PCT
+#define CRSF_TELEM_BCAST_BUDGET_PCT 60
+#endif
+
 #if HAL_CRSF_TELEM_ENABLED
 
 #include <AP_Notify/AP_Notify.h>
@@ -262,6 +268,7 @@ private:
     void adjust_packet_weight(bool queue_empty) override;
     void setup_custom_telemetry();
     void update_custom_telemetry_rates(AP_RCProtocol_CRSF::RFMode rf_mode);
+    void update_bcast_telemetry_rates();
 
     void calc_parameter_ping();
     void calc_heartbeat();
@@ -310,6 +317,8 @@ private:
     // reporting telemetry rate
     uint32_t _telem_last_report_ms;
     uint16_t _telem_last_avg_rate;
+    // telemetry rate the broadcast frame rates were last scaled for
+    uint16_t _bcast_budget_rate;
 
     bool _telem_pending;
     bool _enable_telemetry;
@@ -33,6 +33,46 @@
 
 extern const AP_HAL::HAL& hal;
 
+decltype(AP_RCTelemetry::_nav_snapshot) AP_RCTelemetry::_nav_snapshot;
+
+/*
+  get the shared navigation snapshot, refreshing it from the AHRS if it
+  is older than TELEM_NAV_SNAPSHOT_MS
+ */
+void AP_RCTelemetry::get_nav_snapshot(NavSnapshot &snapshot)
+{
+    WITH_SEMAPHORE(_nav_snapshot.sem);
+
+    NavSnapshot &d = _nav_snapshot.data;
+    const uint32_t now_ms = AP_HAL::millis();
+    if (d.timestamp_ms == 0 || now_ms - d.timestamp_ms >= TELEM_NAV_SNAPSHOT_MS) {
+        AP_AHRS &ahrs = AP::ahrs();
+        WITH_SEMAPHORE(ahrs.get_semaphore());
+        d.have_position = ahrs.get_position(d.loc);
+        d.home = ahrs.get_home();
+        d.home_is_set = ahrs.home_is_set();
+        d.have_velocity = ahrs.get_velocity_NED(d.velocity_NED);
+        if (!d.have_velocity) {
+            d.velocity_NED.zero();
+        }
+        d.have_home_NE = ahrs.get_relative_position_NE_home(d.home_NE);
+        if (!d.have_home_NE) {
+            d.home_NE.zero();
+        }
+        d.relative_alt_D = 0;
+        ahrs.get_relative_position_D_home(d.relative_alt_D);
+        d.groundspeed = ahrs.groundspeed();
+        d.roll = ahrs.roll;
+        d.pitch = ahrs.pitch;
+        d.yaw = ahrs.yaw;
+        d.roll_sensor = ahrs.roll_sensor;
+        d.pitch_sensor = ahrs.pitch_sensor;
+        d.yaw_sensor = ahrs.yaw_sensor;
+        d.timestamp_ms = MAX(now_ms, 1U);
+    }
+    snapshot = d;
+}
+
 /*
   setup ready for passthrough telem
  */
@@ -18,6 +18,7 @@
 #include <AP_Notify/AP_Notify.h>
 #include <AP_HAL/utility/RingBuffer.h>
 #include <AP_Math/AP_Math.h>
+#include <AP_Common/Location.h>
 
 #define TELEM_PAYLOAD_STATUS_CAPACITY          5 // size of the message buffer queue (max number of messages waiting to be sent)
 
@@ -25,6 +26,11 @@
 #define TELEM_TIME_SLOT_MAX               15
 //#define TELEM_DEBUG
 
+// maximum age of the shared navigation snapshot before it is refreshed
+#ifndef TELEM_NAV_SNAPSHOT_MS
+#define TELEM_NAV_SNAPSHOT_MS             20
+#endif
+
 class AP_RCTelemetry {
 public:
     AP_RCTelemetry(uint8_t time_slots) : _time_slots(time_slots) {}
@@ -78,6 +84,27 @@ public:
         return _scheduler.max_packet_rate;
     }
 
+    // AHRS navigation state shared by all telemetry protocols. Each
+    // protocol building a frame in the same update period gets the same
+    // copy, so the AHRS semaphore is only taken once per period rather
+    // than once per frame on each link
+    struct NavSnapshot {
+        uint32_t timestamp_ms;
+        Location loc;
+        Location home;
+        Vector3f velocity_NED;
+        Vector2f home_NE;
+        float relative_alt_D;   // metres below home
+        float groundspeed;
+        float roll, pitch, yaw; // radians
+        int32_t roll_sensor, pitch_sensor, yaw_sensor;  // centi-degrees
+        bool have_position;
+        bool have_velocity;
+        bool have_home_NE;
+        bool home_is_set;
+    };
+    static void get_nav_snapshot(NavSnapshot &snapshot);
+
 protected:
     uint8_t run_wfq_scheduler(const bool use_shaper = true);
     // process a specific entry
@@ -124,6 +151,11 @@ protected:
     } _statustext;
 
 private:
+    static struct {
+        HAL_Semaphore sem;
+        NavSnapshot data;
+    } _nav_snapshot;
+
     uint32_t check_sensor_status_timer;
     uint32_t check_ekf_status_timer;
     uint32_t _disabled_scheduler_entries_bitmask;
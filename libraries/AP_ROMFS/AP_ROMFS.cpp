@@ -18,6 +18,7 @@
 
 #include "AP_ROMFS.h"
 #include "tinf.h"
+#include <AP_Math/AP_Math.h>
 #include <AP_Math/crc.h>
 
 #ifdef HAL_HAVE_AP_ROMFS_EMBEDDED_H
@@ -122,6 +123,136 @@ void AP_ROMFS::free(const uint8_t *data)
 #endif
 }
 
+/*
+  find the decompressed size of a file from the gzip trailer
+*/
+bool AP_ROMFS::find_size(const char *name, uint32_t &size)
+{
+    uint32_t compressed_size = 0;
+    uint32_t crc;
+    const uint8_t *compressed_data = find_file(name, compressed_size, crc);
+    if (!compressed_data) {
+        return false;
+    }
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    size = compressed_size;
+#else
+    if (compressed_size < 4) {
+        return false;
+    }
+    const uint8_t *p = &compressed_data[compressed_size-4];
+    size = p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24;
+#endif
+    return true;
+}
+
+bool AP_ROMFS::Stream::open(const char *name)
+{
+    close();
+    uint32_t compressed_size = 0;
+    const uint8_t *compressed_data = find_file(name, compressed_size, crc_expected);
+    if (!compressed_data) {
+        return false;
+    }
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    data = compressed_data;
+    data_size = size = compressed_size;
+    ofs = 0;
+    return true;
+#else
+    if (compressed_size < 4) {
+        return false;
+    }
+    const uint8_t *p = &compressed_data[compressed_size-4];
+    size = p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24;
+
+    // deflate can refer back at most 32k bytes
+    window_size = MAX(MIN(size, 32768U), 1U);
+    d = (TINF_DATA *)malloc(sizeof(TINF_DATA));
+    window = (uint8_t *)malloc(window_size);
+    data = compressed_data;
+    data_size = compressed_size;
+    if (d == nullptr || window == nullptr || !rewind()) {
+        close();
+        return false;
+    }
+    return true;
+#endif
+}
+
+void AP_ROMFS::Stream::close()
+{
+#ifndef HAL_ROMFS_UNCOMPRESSED
+    ::free(d);
+    ::free(window);
+    d = nullptr;
+    window = nullptr;
+#endif
+    data = nullptr;
+}
+
+bool AP_ROMFS::Stream::rewind()
+{
+    if (data == nullptr) {
+        return false;
+    }
+    ofs = 0;
+#ifndef HAL_ROMFS_UNCOMPRESSED
+    crc = 0;
+    uzlib_uncompress_init(d, window, window_size);
+    d->source = data;
+    d->source_limit = data + data_size - 4;
+    if (uzlib_gzip_parse_header(d) != TINF_OK) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+int32_t AP_ROMFS::Stream::read(uint8_t *buf, uint32_t count)
+{
+    if (data == nullptr) {
+        return -1;
+    }
+    count = MIN(size - ofs, count);
+    if (count == 0) {
+        return 0;
+    }
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    memcpy(buf, &data[ofs], count);
+#else
+    d->dest = buf;
+    d->destSize = count;
+    const int res = uzlib_uncompress(d);
+    if ((res != TINF_OK && res != TINF_DONE) || uint32_t(d->dest - buf) != count) {
+        return -1;
+    }
+    crc = crc32_small(crc, buf, count);
+    if (ofs + count == size && crc != crc_expected) {
+        return -1;
+    }
+#endif
+    ofs += count;
+    return count;
+}
+
+bool AP_ROMFS::Stream::skip(uint32_t count)
+{
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    ofs = MIN(size, ofs + count);
+#else
+    uint8_t buf[64];
+    while (count > 0) {
+        const int32_t n = read(buf, MIN(count, sizeof(buf)));
+        if (n <= 0) {
+            return n == 0;
+        }
+        count -= n;
+    }
+#endif
+    return true;
+}
+
 /*
   directory listing interface. Start with ofs=0. Returns pathnames
   that match dirname prefix. Ends with nullptr return when no more
@@ -5,6 +5,8 @@
 
 #include <AP_HAL/AP_HAL.h>
 
+struct TINF_DATA;
+
 class AP_ROMFS {
 public:
     // find a file and de-compress, assumning gzip format. The
@@ -16,6 +18,49 @@ public:
     // free returned data
     static void free(const uint8_t *data);
 
+    // find the decompressed size of a file without decompressing it
+    static bool find_size(const char *name, uint32_t &size);
+
+    /*
+      incremental decompression of a file for readers that don't need
+      it all in memory at once. Only a window of the last 32k bytes of
+      output (or the whole file if smaller) is allocated, whatever the
+      size of the file
+     */
+    class Stream {
+    public:
+        ~Stream() { close(); }
+
+        // open a file, returning false if not found or out of memory
+        bool open(const char *name);
+        void close();
+        bool is_open() const { return data != nullptr; }
+
+        // read up to count bytes. Returns the number of bytes read,
+        // zero at the end of the file or -1 if the data is corrupt
+        int32_t read(uint8_t *buf, uint32_t count);
+
+        // discard count bytes, returning false on corrupt data
+        bool skip(uint32_t count);
+
+        // go back to the start of the file
+        bool rewind();
+
+        uint32_t get_size() const { return size; }
+        uint32_t get_offset() const { return ofs; }
+
+    private:
+        const uint8_t *data = nullptr;
+        uint32_t data_size;
+        uint32_t size;      // decompressed size
+        uint32_t ofs;       // decompressed offset
+        uint32_t crc;       // crc of the decompressed data read so far
+        uint32_t crc_expected;
+        TINF_DATA *d = nullptr;
+        uint8_t *window = nullptr;
+        uint32_t window_size;
+    };
+
     /*
       directory listing interface. Start with ofs=0. Returns pathnames
       that match dirname prefix. Ends with nullptr return when no more
@@ -0,0 +1,135 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  class to estimate the offset and drift between a remote clock and
+  our own from request/response exchanges such as MAVLink TIMESYNC.
+
+  Each exchange gives an offset measurement assuming the response was
+  timestamped half way through the round trip, so its error is at
+  most half the round trip time. Exchanges with a round trip time well
+  above the shortest recent one were delayed in one direction and are
+  not used. The remaining measurements go through an alpha-beta filter
+  which tracks the offset and its rate of change, so timestamps stay
+  accurate between exchanges.
+
+  Unlike JitterCorrection this doesn't need the remote timestamps to
+  arrive with a short lag at least some of the time, so the transport
+  delay of timestamped data is measured rather than having to be
+  given as a parameter.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include "ClockSync.h"
+
+// exchanges with a longer round trip are never used
+#define CLOCKSYNC_MAX_RTT_US 500000U
+
+// margin for round trip jitter above twice the shortest round trip
+#define CLOCKSYNC_RTT_MARGIN_US 1000U
+
+// exchanges needed before the estimate is used
+#define CLOCKSYNC_CONVERGED_SAMPLES 5
+
+// the estimate is not used if there has been no exchange for this long
+#define CLOCKSYNC_TIMEOUT_US 10000000U
+
+// measurements further than half the round trip plus this from the
+// estimate are outliers. Several in a row mean the remote clock jumped
+#define CLOCKSYNC_OUTLIER_US 5000
+#define CLOCKSYNC_MAX_OUTLIERS 3
+
+// largest believable clock drift
+#define CLOCKSYNC_MAX_DRIFT 500.0e-6f
+
+// filter gain once converged
+#define CLOCKSYNC_ALPHA 0.2f
+
+void ClockSync::add_exchange(uint64_t local_send_usec, uint64_t local_receive_usec, uint64_t remote_usec)
+{
+    if (local_receive_usec <= local_send_usec ||
+        local_receive_usec - local_send_usec > CLOCKSYNC_MAX_RTT_US) {
+        return;
+    }
+    const uint32_t rtt_usec = local_receive_usec - local_send_usec;
+
+    // let the shortest round trip rise slowly so we follow a link
+    // which has become slower
+    if (samples == 0 || rtt_usec < min_rtt_usec) {
+        min_rtt_usec = rtt_usec;
+    } else {
+        min_rtt_usec += MAX(min_rtt_usec / 32U, 1U);
+    }
+    if (samples != 0 && rtt_usec > 2 * min_rtt_usec + CLOCKSYNC_RTT_MARGIN_US) {
+        return;
+    }
+
+    const int64_t measured_usec = int64_t(local_send_usec + rtt_usec / 2) - int64_t(remote_usec);
+
+    if (samples == 0) {
+        offset_usec = measured_usec;
+        drift = 0;
+        ref_local_usec = local_receive_usec;
+        samples = 1;
+        return;
+    }
+
+    if (local_receive_usec <= ref_local_usec) {
+        return;
+    }
+    const float dt_usec = local_receive_usec - ref_local_usec;
+    const int64_t predicted_usec = offset_usec + int64_t(drift * dt_usec);
+    const float residual_usec = measured_usec - predicted_usec;
+
+    if (samples >= CLOCKSYNC_CONVERGED_SAMPLES &&
+        fabsf(residual_usec) > rtt_usec / 2 + CLOCKSYNC_OUTLIER_US) {
+        if (++outliers >= CLOCKSYNC_MAX_OUTLIERS) {
+            reset();
+            add_exchange(local_send_usec, local_receive_usec, remote_usec);
+        }
+        return;
+    }
+    outliers = 0;
+
+    // plain average over the first samples, then a critically
+    // damped alpha-beta filter
+    const float alpha = MAX(1.0f / (samples + 1), CLOCKSYNC_ALPHA);
+    const float beta = sq(alpha) / (2 - alpha);
+    offset_usec = predicted_usec + int64_t(alpha * residual_usec);
+    drift = constrain_float(drift + beta * residual_usec / dt_usec, -CLOCKSYNC_MAX_DRIFT, CLOCKSYNC_MAX_DRIFT);
+    ref_local_usec = local_receive_usec;
+    if (samples < UINT16_MAX) {
+        samples++;
+    }
+}
+
+bool ClockSync::converged(uint64_t local_usec) const
+{
+    return samples >= CLOCKSYNC_CONVERGED_SAMPLES &&
+        (local_usec < ref_local_usec || local_usec - ref_local_usec < CLOCKSYNC_TIMEOUT_US);
+}
+
+uint64_t ClockSync::remote_to_local_usec(uint64_t remote_usec) const
+{
+    const int64_t local_usec = int64_t(remote_usec) + offset_usec;
+    return local_usec + int64_t(drift * float(local_usec - int64_t(ref_local_usec)));
+}
+
+void ClockSync::reset()
+{
+    samples = 0;
+    outliers = 0;
+    drift = 0;
+}
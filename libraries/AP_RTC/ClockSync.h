@@ -0,0 +1,49 @@
+/*
+  remote clock offset and drift estimator
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class ClockSync {
+public:
+    // add the result of a request/response exchange with the remote
+    // system. local_send_usec and local_receive_usec are the local
+    // times the request was sent and the response arrived, and
+    // remote_usec is the remote time in the response
+    void add_exchange(uint64_t local_send_usec, uint64_t local_receive_usec, uint64_t remote_usec);
+
+    // true if enough recent exchanges have been seen for
+    // remote_to_local_usec() to be used
+    bool converged(uint64_t local_usec) const;
+
+    // convert a remote timestamp to the local time domain
+    uint64_t remote_to_local_usec(uint64_t remote_usec) const;
+
+    // forget all samples, for when the remote system changes
+    void reset();
+
+    // local minus remote time in microseconds at the last exchange
+    int64_t get_offset_usec() const { return offset_usec; }
+
+    // how fast the remote clock runs relative to ours, in parts per million
+    float get_drift_ppm() const { return drift * 1.0e6f; }
+
+    // shortest recent round trip time in microseconds
+    uint32_t get_min_rtt_usec() const { return min_rtt_usec; }
+
+private:
+    // local time of the last exchange used
+    uint64_t ref_local_usec;
+
+    // local minus remote at ref_local_usec, and its rate of change
+    int64_t offset_usec;
+    float drift;
+
+    // round trip time below which exchanges are used
+    uint32_t min_rtt_usec;
+
+    uint16_t samples;
+    uint8_t outliers;
+};
@@ -142,6 +142,7 @@ Location AP_Rally::rally_location_to_location(const RallyLocation &rally_loc) co
 bool AP_Rally::find_nearest_rally_point(const Location &current_loc, RallyLocation &return_loc) const
 {
     float min_dis = -1;
+    const Location::DistanceFrom from_current{current_loc};
 
     for (uint8_t i = 0; i < (uint8_t) _rally_point_total_count; i++) {
         RallyLocation next_rally;
@@ -149,7 +150,7 @@ bool AP_Rally::find_nearest_rally_point(const Location &current_loc, RallyLocati
             continue;
         }
         Location rally_loc = rally_location_to_location(next_rally);
-        float dis = current_loc.get_distance(rally_loc);
+        float dis = from_current.get_distance(rally_loc);
 
         if (is_valid(rally_loc) && (dis < min_dis || min_dis < 0)) {
             min_dis = dis;
@@ -181,7 +182,8 @@ Location AP_Rally::calc_best_rally_or_home_location(const Location &current_loc,
     if (find_nearest_rally_point(current_loc, ral_loc)) {
         Location loc = rally_location_to_location(ral_loc);
         // use the rally point if it's closer then home, or we aren't generally considering home as acceptable
-        if (!_rally_incl_home  || (current_loc.get_distance(loc) < current_loc.get_distance(return_loc))) {
+        const Location::DistanceFrom from_current{current_loc};
+        if (!_rally_incl_home  || (from_current.get_distance(loc) < from_current.get_distance(return_loc))) {
             return_loc = rally_location_to_location(ral_loc);
         }
     }
@@ -59,8 +59,13 @@ bool AP_RangeFinder_Backend_Serial::detect(uint8_t serial_instance)
 void AP_RangeFinder_Backend_Serial::update(void)
 {
     if (get_reading(state.distance_cm)) {
+        // timestamp the reading with when its last byte arrived, not
+        // when we got round to reading it, so users can allow for the
+        // delay. The UART gives 0 if it can't tell
+        const uint32_t now_ms = AP_HAL::millis();
+        const uint32_t receive_ms = uart->receive_time_constraint_us(0) / 1000U;
+        state.last_reading_ms = (receive_ms != 0) ? MIN(receive_ms, now_ms) : now_ms;
         // update range_valid state based on distance measured
-        state.last_reading_ms = AP_HAL::millis();
         update_status();
     } else if (AP_HAL::millis() - state.last_reading_ms > read_timeout_ms()) {
         set_status(RangeFinder::Status::NoData);
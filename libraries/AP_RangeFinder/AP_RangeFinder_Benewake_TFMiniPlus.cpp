@@ -138,13 +138,10 @@ fail:
 
 void AP_RangeFinder_Benewake_TFMiniPlus::update()
 {
-    WITH_SEMAPHORE(_sem);
-
-    if (accum.count > 0) {
-        state.distance_cm = accum.sum / accum.count;
+    float distance_cm;
+    if (accum.consume(distance_cm)) {
+        state.distance_cm = distance_cm;
         state.last_reading_ms = AP_HAL::millis();
-        accum.sum = 0;
-        accum.count = 0;
         update_status();
     } else if (AP_HAL::millis() - state.last_reading_ms > 200) {
         set_status(RangeFinder::Status::NoData);
@@ -213,9 +210,5 @@ void AP_RangeFinder_Benewake_TFMiniPlus::timer()
 
     process_raw_measure(u.val.distance, u.val.strength, distance);
 
-    {
-        WITH_SEMAPHORE(_sem);
-        accum.sum += distance;
-        accum.count++;
-    }
+    accum.accumulate(distance);
 }
@@ -21,6 +21,7 @@
 
 #include <AP_HAL/utility/sparse-endian.h>
 #include <AP_HAL/I2CDevice.h>
+#include <AP_Common/SeqLock.h>
 
 class AP_RangeFinder_Benewake_TFMiniPlus : public AP_RangeFinder_Backend
 {
@@ -55,8 +56,6 @@ private:
 
     AP_HAL::OwnPtr<AP_HAL::I2CDevice> _dev;
 
-    struct {
-        uint32_t sum;
-        uint32_t count;
-    } accum;
+    // mean distance in cm from the bus thread
+    SeqLockAccumulator<float> accum;
 };
@@ -160,13 +160,9 @@ void AP_RangeFinder_TeraRangerI2C::timer(void)
     uint16_t _raw_distance = 0;
     uint16_t _distance_cm = 0;
 
-    if (collect_raw(_raw_distance)) {
-        WITH_SEMAPHORE(_sem);
-
-        if (process_raw_measure(_raw_distance, _distance_cm)){
-            accum.sum += _distance_cm;
-            accum.count++;
-        }
+    if (collect_raw(_raw_distance) &&
+        process_raw_measure(_raw_distance, _distance_cm)) {
+        accum.accumulate(_distance_cm);
     }
     // and immediately ask for a new reading
     measure();
@@ -177,14 +173,11 @@ void AP_RangeFinder_TeraRangerI2C::timer(void)
 */
 void AP_RangeFinder_TeraRangerI2C::update(void)
 {
-    WITH_SEMAPHORE(_sem);
-
-    if (accum.count > 0) {
-        state.distance_cm = accum.sum / accum.count;
+    float distance_cm;
+    if (accum.consume(distance_cm)) {
+        state.distance_cm = distance_cm;
         state.last_reading_ms = AP_HAL::millis();
-        accum.sum = 0;
-        accum.count = 0;
-        update_status();        
+        update_status();
     } else if (AP_HAL::millis() - state.last_reading_ms > 200) {
         set_status(RangeFinder::Status::NoData);
     }
@@ -3,6 +3,7 @@
 #include "AP_RangeFinder.h"
 #include "AP_RangeFinder_Backend.h"
 #include <AP_HAL/I2CDevice.h>
+#include <AP_Common/SeqLock.h>
 
 class AP_RangeFinder_TeraRangerI2C : public AP_RangeFinder_Backend
 {
@@ -35,8 +36,6 @@ private:
     void timer(void);
     AP_HAL::OwnPtr<AP_HAL::I2CDevice> dev;
 
-    struct {
-        uint32_t sum;
-        uint32_t count;
-    } accum;
+    // mean distance in cm from the bus thread
+    SeqLockAccumulator<float> accum;
 };
@@ -550,9 +550,7 @@ void AP_RangeFinder_VL53L1X::timer(void)
 {
     uint16_t range_mm;
     if ((get_reading(range_mm)) && (range_mm <= 4000)) {
-        WITH_SEMAPHORE(_sem);
-        sum_mm += range_mm;
-        counter++;
+        accum_mm.accumulate(range_mm);
     }
 }
 
@@ -561,13 +559,11 @@ void AP_RangeFinder_VL53L1X::timer(void)
 */
 void AP_RangeFinder_VL53L1X::update(void)
 {
-    WITH_SEMAPHORE(_sem);
-    if (counter > 0) {
-        state.distance_cm = sum_mm / (10*counter);
+    float range_mm;
+    if (accum_mm.consume(range_mm)) {
+        state.distance_cm = range_mm * 0.1f;
         state.last_reading_ms = AP_HAL::millis();
         update_status();
-        sum_mm = 0;
-        counter = 0;
     } else if (AP_HAL::millis() - state.last_reading_ms > 200) {
         // if no updates for 0.2s set no-data
         set_status(RangeFinder::Status::NoData);
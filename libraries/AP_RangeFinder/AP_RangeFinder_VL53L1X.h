@@ -3,6 +3,7 @@
 #include "AP_RangeFinder.h"
 #include "AP_RangeFinder_Backend.h"
 #include <AP_HAL/I2CDevice.h>
+#include <AP_Common/SeqLock.h>
 
 class AP_RangeFinder_VL53L1X : public AP_RangeFinder_Backend
 {
@@ -1271,8 +1272,8 @@ private:
 
     uint16_t fast_osc_frequency;
     uint16_t osc_calibrate_val;
-    uint32_t sum_mm;
-    uint32_t counter;
+    // mean range in mm from the bus thread
+    SeqLockAccumulator<float> accum_mm;
     bool calibrated;
 
     bool read_register(uint16_t reg, uint8_t &value) WARN_IF_UNUSED;
@@ -62,7 +62,7 @@ const AP_Param::GroupInfo AP_Scheduler::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Scheduling options
     // @Description: This controls optional aspects of the scheduler.
-    // @Bitmask: 0:Enable per-task perf info
+    // @Bitmask: 0:Enable per-task perf info,1:Earliest deadline first task ordering
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Scheduler, _options, 0),
 
@@ -119,6 +119,9 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
     memset(_last_run, 0, sizeof(_last_run[0]) * _num_tasks);
     _tick_counter = 0;
 
+    _deadline_order = new uint8_t[_num_tasks];
+    _deadline_slack = new int16_t[_num_tasks];
+
     // setup initial performance counters
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
@@ -148,6 +151,47 @@ static void fill_nanf_stack(void)
 }
 #endif
 
+// number of ticks between runs of a task
+uint16_t AP_Scheduler::task_interval_ticks(const Task &task) const
+{
+    // we allow 0 to mean loop rate
+    uint32_t interval_ticks = (is_zero(task.rate_hz) ? 1 : _loop_rate_hz / task.rate_hz);
+    if (interval_ticks < 1) {
+        interval_ticks = 1;
+    }
+    return MIN(interval_ticks, UINT16_MAX);
+}
+
+/*
+  fill _deadline_order with the tasks that are due to run, sorted by
+  slack. A task becomes due interval_ticks after it last ran and its
+  deadline is one interval later, so slack is the number of ticks left
+  before it misses its deadline. Ties keep task table order so the
+  table still gives priority between tasks with equal slack
+ */
+uint8_t AP_Scheduler::order_by_deadline()
+{
+    uint8_t num_due = 0;
+    for (uint8_t i=0; i<_num_tasks; i++) {
+        const uint16_t dt = _tick_counter - _last_run[i];
+        const uint16_t interval_ticks = task_interval_ticks(get_task(i));
+        if (dt < interval_ticks) {
+            continue;
+        }
+        const int16_t slack = constrain_int32(int32_t(interval_ticks)*2 - dt, INT16_MIN, INT16_MAX);
+        // insertion sort, the due list is short and mostly in order
+        uint8_t n = num_due++;
+        while (n > 0 && _deadline_slack[n-1] > slack) {
+            _deadline_order[n] = _deadline_order[n-1];
+            _deadline_slack[n] = _deadline_slack[n-1];
+            n--;
+        }
+        _deadline_order[n] = i;
+        _deadline_slack[n] = slack;
+    }
+    return num_due;
+}
+
 /*
   run one tick
   this will run as many scheduler tasks as we can in the specified time
@@ -157,15 +201,18 @@ void AP_Scheduler::run(uint32_t time_available)
     uint32_t run_started_usec = AP_HAL::micros();
     uint32_t now = run_started_usec;
 
-    for (uint8_t i=0; i<_num_tasks; i++) {
-        const AP_Scheduler::Task& task = (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+    // optionally run due tasks earliest deadline first rather than
+    // in task table order
+    const bool deadline_ordering = (_options & uint8_t(Options::DEADLINE_ORDERING)) &&
+        _deadline_order != nullptr && _deadline_slack != nullptr;
+    const uint8_t num_candidates = deadline_ordering ? order_by_deadline() : _num_tasks;
+
+    for (uint8_t n=0; n<num_candidates; n++) {
+        const uint8_t i = deadline_ordering ? _deadline_order[n] : n;
+        const AP_Scheduler::Task& task = get_task(i);
 
         const uint16_t dt = _tick_counter - _last_run[i];
-        // we allow 0 to mean loop rate
-        uint32_t interval_ticks = (is_zero(task.rate_hz) ? 1 : _loop_rate_hz / task.rate_hz);
-        if (interval_ticks < 1) {
-            interval_ticks = 1;
-        }
+        const uint32_t interval_ticks = task_interval_ticks(task);
         if (dt < interval_ticks) {
             // this task is not yet scheduled to run again
             continue;
@@ -173,7 +220,8 @@ void AP_Scheduler::run(uint32_t time_available)
         // this task is due to run. Do we have enough time to run it?
         _task_time_allowed = task.max_time_micros;
 
-        if (dt >= interval_ticks*2) {
+        const bool past_deadline = dt >= interval_ticks*2;
+        if (past_deadline) {
             perf_info.task_slipped(i);
         }
 
@@ -198,6 +246,10 @@ void AP_Scheduler::run(uint32_t time_available)
         task.function();
         hal.util->persistent_data.scheduler_task = -1;
 
+        if (past_deadline) {
+            perf_info.task_missed_deadline(i);
+        }
+
         // record the tick counter when we ran. This drives
         // when we next run the event
         _last_run[i] = _tick_counter;
@@ -269,8 +321,16 @@ void AP_Scheduler::loop()
     _rsem.take_blocking();
     hal.util->persistent_data.scheduler_task = -1;
 
-    const uint32_t sample_time_us = AP_HAL::micros();
-    
+    run_loop(AP_HAL::micros());
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    // move result of AP_HAL::micros() forward:
+    hal.scheduler->delay_microseconds(1);
+#endif
+}
+
+void AP_Scheduler::run_loop(uint32_t sample_time_us)
+{
     if (_loop_timer_start_us == 0) {
         _loop_timer_start_us = sample_time_us;
         _last_loop_time_s = get_loop_period_s();
@@ -292,8 +352,10 @@ void AP_Scheduler::loop()
           for testing low CPU conditions we can add an optional delay in SITL
         */
         auto *sitl = AP::sitl();
-        uint32_t loop_delay_us = sitl->loop_delay.get();
-        hal.scheduler->delay_microseconds(loop_delay_us);
+        if (sitl != nullptr) {
+            uint32_t loop_delay_us = sitl->loop_delay.get();
+            hal.scheduler->delay_microseconds(loop_delay_us);
+        }
     }
 #endif
 
@@ -322,11 +384,6 @@ void AP_Scheduler::loop()
     // run the tasks
     run(time_available);
 
-#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-    // move result of AP_HAL::micros() forward:
-    hal.scheduler->delay_microseconds(1);
-#endif
-
     if (task_not_achieved > 0) {
         // add some extra time to the budget
         extra_loop_us = MIN(extra_loop_us+100U, 5000U);
@@ -358,6 +415,9 @@ void AP_Scheduler::update_logging()
     if (_log_performance_bit != (uint32_t)-1 &&
         AP::logger().should_log(_log_performance_bit)) {
         Log_Write_Performance();
+        Log_Write_Task_Histograms();
+        Log_Write_Bus_Stats();
+        Log_Write_Thread_Stats();
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
@@ -388,15 +448,194 @@ void AP_Scheduler::Log_Write_Performance()
         i2c_count        : pd.i2c_count,
         i2c_isr_count    : pd.i2c_isr_count,
         extra_loop_us    : extra_loop_us,
+        log_writes_contended : AP::logger().num_writes_contended(),
+        log_writes_uncontended : AP::logger().num_writes_uncontended(),
     };
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
+// return the name of a task given its index in perf_info
+const char *AP_Scheduler::task_name(uint8_t i) const
+{
+    if (i < _num_unshared_tasks) {
+        return _tasks[i].name;
+    }
+    if (i == _num_tasks) {
+        return "fast_loop";
+    }
+    return _common_tasks[i - _num_unshared_tasks].name;
+}
+
+// Write the per-task run time histograms
+void AP_Scheduler::Log_Write_Task_Histograms()
+{
+    if (!perf_info.has_task_info()) {
+        return;
+    }
+    const uint64_t now = AP_HAL::micros64();
+    for (uint8_t i = 0; i < _num_tasks + 1; i++) {
+        const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
+        if (ti->tick_count == 0) {
+            continue;
+        }
+        char name[16] {};
+        strncpy(name, task_name(i), sizeof(name));
+// @LoggerMessage: TSKH
+// @Description: Scheduler per-task run time histogram over the last second
+// @Field: TimeUS: Time since system startup
+// @Field: Name: task name
+// @Field: B0: number of runs taking 0us
+// @Field: B1: number of runs taking 1us
+// @Field: B2: number of runs taking 2-3us
+// @Field: B3: number of runs taking 4-7us
+// @Field: B4: number of runs taking 8-15us
+// @Field: B5: number of runs taking 16-31us
+// @Field: B6: number of runs taking 32-63us
+// @Field: B7: number of runs taking 64-127us
+// @Field: B8: number of runs taking 128-255us
+// @Field: B9: number of runs taking 256-511us
+// @Field: B10: number of runs taking 512-1023us
+// @Field: B11: number of runs taking 1024us or more
+// @Field: P99: upper bound of the bucket holding the 99th percentile run time
+// @Field: Miss: number of runs that started after the task deadline
+        AP::logger().Write("TSKH",
+                           "TimeUS,Name,B0,B1,B2,B3,B4,B5,B6,B7,B8,B9,B10,B11,P99,Miss",
+                           "s-------------s-",
+                           "F-------------F-",
+                           "QNHHHHHHHHHHHHHH",
+                           now, name,
+                           ti->hist[0], ti->hist[1], ti->hist[2], ti->hist[3],
+                           ti->hist[4], ti->hist[5], ti->hist[6], ti->hist[7],
+                           ti->hist[8], ti->hist[9], ti->hist[10], ti->hist[11],
+                           ti->percentile_us(99), ti->deadline_miss_count);
+    }
+}
+
+// Write the device bus periodic callback timing statistics
+void AP_Scheduler::Log_Write_Bus_Stats()
+{
+    const uint64_t now = AP_HAL::micros64();
+    AP_HAL::Device::PeriodicStats stats;
+    for (uint8_t i = 0; hal.util->periodic_callback_stats(i, stats, true); i++) {
+// @LoggerMessage: BUSC
+// @Description: Device bus thread periodic callback timing
+// @Field: TimeUS: Time since system startup
+// @Field: Id: bus_id of the device that registered the callback
+// @Field: Per: callback period
+// @Field: N: number of runs since boot
+// @Field: LTot: total time runs started after they were due, including waiting for the bus
+// @Field: LMax: longest delay in starting a run since the last message
+// @Field: RTot: total time runs held the bus
+// @Field: RMax: longest run since the last message
+        AP::logger().Write("BUSC",
+                           "TimeUS,Id,Per,N,LTot,LMax,RTot,RMax",
+                           "s-s-ssss",
+                           "F-F-FFFF",
+                           "QIIIQIQI",
+                           now, stats.bus_id, stats.period_usec, stats.count,
+                           stats.late_us, stats.late_max_us,
+                           stats.run_us, stats.run_max_us);
+    }
+}
+
+/*
+  record the time from the gyro sample used by this loop, and from the
+  start of the loop, to the motor outputs being sent
+ */
+void AP_Scheduler::output_sent()
+{
+    const uint64_t sample_us = AP::ins().get_gyro_sample_usec();
+    if (sample_us == 0) {
+        return;
+    }
+    const uint64_t now = AP_HAL::micros64();
+    const uint32_t latency_us = MIN(now - sample_us, UINT32_MAX);
+    const uint32_t loop_us = uint32_t(now) - _loop_timer_start_us;
+    if (_output_latency.count == 0) {
+        _output_latency.min_us = latency_us;
+        _output_latency.max_us = latency_us;
+        _output_latency.loop_max_us = loop_us;
+    } else {
+        _output_latency.min_us = MIN(_output_latency.min_us, latency_us);
+        _output_latency.max_us = MAX(_output_latency.max_us, latency_us);
+        _output_latency.loop_max_us = MAX(_output_latency.loop_max_us, loop_us);
+    }
+    _output_latency.count++;
+    _output_latency.sum_us += latency_us;
+    _output_latency.sum_sq_us += uint64_t(latency_us) * latency_us;
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _output_latency.last_log_ms >= 1000) {
+        _output_latency.last_log_ms = now_ms;
+        if (_log_performance_bit != (uint32_t)-1 &&
+            AP::logger().should_log(_log_performance_bit)) {
+            Log_Write_Output_Latency();
+        }
+        _output_latency.count = 0;
+        _output_latency.sum_us = 0;
+        _output_latency.sum_sq_us = 0;
+    }
+}
+
+// Write the gyro sample to motor output latency statistics
+void AP_Scheduler::Log_Write_Output_Latency()
+{
+    const float n = _output_latency.count;
+    const float avg_us = _output_latency.sum_us / n;
+    const float var_us = MAX(_output_latency.sum_sq_us / n - sq(avg_us), 0);
+// @LoggerMessage: LAT
+// @Description: Latency from gyro sample to motor output
+// @Field: TimeUS: Time since system startup
+// @Field: N: number of outputs since the last message
+// @Field: Min: shortest time from the gyro sample being filtered to the outputs being sent
+// @Field: Avg: mean time from the gyro sample being filtered to the outputs being sent
+// @Field: Max: longest time from the gyro sample being filtered to the outputs being sent
+// @Field: Jit: standard deviation of the time from the gyro sample being filtered to the outputs being sent
+// @Field: LMax: longest time from the start of the loop to the outputs being sent
+    AP::logger().Write("LAT",
+                       "TimeUS,N,Min,Avg,Max,Jit,LMax",
+                       "s-sssss",
+                       "F-FFFFF",
+                       "QIIIIII",
+                       AP_HAL::micros64(),
+                       _output_latency.count,
+                       _output_latency.min_us,
+                       uint32_t(avg_us),
+                       _output_latency.max_us,
+                       uint32_t(sqrtf(var_us)),
+                       _output_latency.loop_max_us);
+}
+
+// Write the per-thread run time statistics
+void AP_Scheduler::Log_Write_Thread_Stats()
+{
+    const uint64_t now = AP_HAL::micros64();
+    AP_HAL::Util::ThreadStats stats;
+    for (uint8_t i = 0; hal.util->thread_stats(i, stats, true); i++) {
+// @LoggerMessage: THRD
+// @Description: Thread run time statistics
+// @Field: TimeUS: Time since system startup
+// @Field: Name: thread name
+// @Field: Pri: thread priority
+// @Field: RunUS: total time the thread has run, including interrupts taken while it was running
+// @Field: Sw: number of times the thread has been switched out
+// @Field: LMax: longest time from the thread becoming ready to it running since the last message
+// @Field: Stk: free stack space
+        AP::logger().Write("THRD",
+                           "TimeUS,Name,Pri,RunUS,Sw,LMax,Stk",
+                           "s--s-sb",
+                           "F--F-F-",
+                           "QNBQIII",
+                           now, stats.name, stats.priority, stats.run_us,
+                           stats.switch_count, stats.latency_max_us, stats.stack_free);
+    }
+}
+
 // display task statistics as text buffer for @SYS/tasks.txt
 void AP_Scheduler::task_info(ExpandingString &str)
 {
     // a header to allow for machine parsers to determine format
-    str.printf("TasksV1\n");
+    str.printf("TasksV2\n");
 
     // dynamically enable statistics collection
     if (!(_options & uint8_t(Options::RECORD_TASK_INFO))) {
@@ -418,7 +657,7 @@ void AP_Scheduler::task_info(ExpandingString &str)
     }
 
     for (uint8_t i = 0; i < _num_tasks + 1; i++) {
-        const char* task_name = (i < _num_unshared_tasks) ? _tasks[i].name : i == _num_tasks ? "fast_loop" : _common_tasks[i - _num_unshared_tasks].name;
+        const char* task_name = this->task_name(i);
         const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
 
         uint16_t avg = 0;
@@ -429,13 +668,70 @@ void AP_Scheduler::task_info(ExpandingString &str)
         }
 
 #if HAL_MINIMIZE_FEATURES
-        const char* fmt = "%-16.16s MIN=%3u MAX=%3u AVG=%3u OVR=%3u SLP=%3u, TOT=%4.1f%%\n";
+        const char* fmt = "%-16.16s MIN=%3u MAX=%3u AVG=%3u OVR=%3u SLP=%3u MISS=%3u, TOT=%4.1f%%\n";
 #else
-        const char* fmt = "%-32.32s MIN=%3u MAX=%3u AVG=%3u OVR=%3u SLP=%3u, TOT=%4.1f%%\n";
+        const char* fmt = "%-32.32s MIN=%3u MAX=%3u AVG=%3u OVR=%3u SLP=%3u MISS=%3u, TOT=%4.1f%%\n";
 #endif
         str.printf(fmt, task_name,
                    unsigned(MIN(ti->min_time_us, 999)), unsigned(MIN(ti->max_time_us, 999)), unsigned(avg),
-                   unsigned(MIN(ti->overrun_count, 999)), unsigned(MIN(ti->slip_count, 999)), pct);
+                   unsigned(MIN(ti->overrun_count, 999)), unsigned(MIN(ti->slip_count, 999)),
+                   unsigned(MIN(ti->deadline_miss_count, 999)), pct);
+    }
+}
+
+// display per-task run time histograms as text buffer for @SYS/task_hist.txt
+void AP_Scheduler::task_hist_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("TaskHistV1\n");
+
+    // dynamically enable statistics collection
+    if (!(_options & uint8_t(Options::RECORD_TASK_INFO))) {
+        _options |= uint8_t(Options::RECORD_TASK_INFO);
+        return;
+    }
+
+    if (perf_info.get_task_info(0) == nullptr) {
+        return;
+    }
+
+    // bucket upper bounds in microseconds, last bucket is open ended
+    str.printf("%-32.32s", "BUCKET_MAX");
+    for (uint8_t b = 0; b < PERFINFO_TASK_HIST_BUCKETS-1; b++) {
+        str.printf(" %5u", unsigned(AP::PerfInfo::hist_bucket_max_us(b)));
+    }
+    str.printf("   inf   P99\n");
+
+    for (uint8_t i = 0; i < _num_tasks + 1; i++) {
+        const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
+        str.printf("%-32.32s", task_name(i));
+        for (uint8_t b = 0; b < PERFINFO_TASK_HIST_BUCKETS; b++) {
+            str.printf(" %5u", unsigned(ti->hist[b]));
+        }
+        str.printf(" %5u\n", unsigned(ti->percentile_us(99)));
+    }
+}
+
+// display device bus callback timing as text buffer for @SYS/buses.txt
+void AP_Scheduler::bus_info(ExpandingString &str)
+{
+    // a header to allow for machine parsers to determine format
+    str.printf("BusCbV1\n");
+
+    AP_HAL::Device::PeriodicStats stats;
+    for (uint8_t i = 0; hal.util->periodic_callback_stats(i, stats, false); i++) {
+        const uint32_t count = MAX(stats.count, 1U);
+        const uint32_t run_avg_us = stats.run_us / count;
+        const float load_pct = stats.period_usec > 0 ? 100.0f * run_avg_us / stats.period_usec : 0;
+        str.printf("ID=0x%06x BUS=%u:%u ADDR=0x%02x PER=%6u RUNS=%8u LAVG=%5u LMAX=%5u RAVG=%5u RMAX=%5u LOAD=%4.1f%%\n",
+                   unsigned(stats.bus_id),
+                   unsigned(AP_HAL::Device::devid_get_bus_type(stats.bus_id)),
+                   unsigned(AP_HAL::Device::devid_get_bus(stats.bus_id)),
+                   unsigned(AP_HAL::Device::devid_get_address(stats.bus_id)),
+                   unsigned(stats.period_usec), unsigned(stats.count),
+                   unsigned(stats.late_us / count), unsigned(stats.late_max_us),
+                   unsigned(run_avg_us), unsigned(stats.run_max_us),
+                   load_pct);
     }
 }
 
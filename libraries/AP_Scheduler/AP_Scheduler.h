@@ -61,6 +61,8 @@
 
 class AP_Scheduler
 {
+    friend class AP_Scheduler_Benchmark;
+
 public:
 
     FUNCTOR_TYPEDEF(scheduler_fastloop_fn_t, void);
@@ -84,7 +86,8 @@ public:
     };
 
     enum class Options : uint8_t {
-        RECORD_TASK_INFO = 1 << 0
+        RECORD_TASK_INFO = 1 << 0,
+        DEADLINE_ORDERING = 1 << 1,
     };
 
     // initialise scheduler
@@ -100,6 +103,10 @@ public:
     // write out PERF message to logger
     void Log_Write_Performance();
 
+    // call from the fast loop once the motor outputs have been sent,
+    // to measure the latency from the gyro sample they were based on
+    void output_sent();
+
     // call when one tick has passed
     void tick(void);
 
@@ -161,6 +168,8 @@ public:
     HAL_Semaphore &get_semaphore(void) { return _rsem; }
 
     void task_info(ExpandingString &str);
+    void task_hist_info(ExpandingString &str);
+    void bus_info(ExpandingString &str);
 
     static const struct AP_Param::GroupInfo var_info[];
 
@@ -168,6 +177,35 @@ public:
     AP::PerfInfo perf_info;
 
 private:
+    // run the fast loop and the due tasks for an INS sample taken at
+    // sample_time_us
+    void run_loop(uint32_t sample_time_us);
+
+    // name of a task by its perf_info index
+    const char *task_name(uint8_t i) const;
+
+    // write per-task run time histograms to the log
+    void Log_Write_Task_Histograms();
+
+    // write device bus callback timing statistics to the log
+    void Log_Write_Bus_Stats();
+    void Log_Write_Thread_Stats();
+
+    // write gyro sample to motor output latency statistics to the log
+    void Log_Write_Output_Latency();
+
+    // return a task by its index
+    const Task &get_task(uint8_t i) const {
+        return (i < _num_unshared_tasks) ? _tasks[i] : _common_tasks[i - _num_unshared_tasks];
+    }
+
+    // number of ticks between runs of a task
+    uint16_t task_interval_ticks(const Task &task) const;
+
+    // fill _deadline_order with the tasks due to run, earliest
+    // deadline first, returning the number of due tasks
+    uint8_t order_by_deadline();
+
     // function that is called before anything in the scheduler table:
     scheduler_fastloop_fn_t _fastloop_fn;
 
@@ -208,6 +246,10 @@ private:
     // tick counter at the time we last ran each task
     uint16_t *_last_run;
 
+    // scratch space for deadline ordering of due tasks
+    uint8_t *_deadline_order;
+    int16_t *_deadline_slack;
+
     // number of microseconds allowed for the current task
     uint32_t _task_time_allowed;
 
@@ -225,6 +267,17 @@ private:
 
     // time of last loop in seconds
     float _last_loop_time_s;
+
+    // gyro sample to motor output latency since the last LAT message
+    struct {
+        uint32_t last_log_ms;
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint32_t loop_max_us;
+        uint64_t sum_us;
+        uint64_t sum_sq_us;
+    } _output_latency;
     
     // bitmask bit which indicates if we should log PERF message
     uint32_t _log_performance_bit;
@@ -72,11 +72,63 @@ void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, b
     }
     ti.elapsed_time_us += task_time_us;
     ti.tick_count++;
+    uint16_t &bucket = ti.hist[hist_bucket(task_time_us)];
+    if (bucket < UINT16_MAX) {
+        bucket++;
+    }
     if (overrun) {
         ti.overrun_count++;
     }
 }
 
+// histogram bucket for a task run time
+uint8_t AP::PerfInfo::hist_bucket(uint16_t task_time_us)
+{
+    if (task_time_us == 0) {
+        return 0;
+    }
+    const uint8_t bucket = (sizeof(unsigned) * 8) - __builtin_clz(task_time_us);
+    return MIN(bucket, PERFINFO_TASK_HIST_BUCKETS-1);
+}
+
+// upper bound of a histogram bucket in microseconds
+uint16_t AP::PerfInfo::hist_bucket_max_us(uint8_t bucket)
+{
+    if (bucket >= PERFINFO_TASK_HIST_BUCKETS-1) {
+        return UINT16_MAX;
+    }
+    return (1U<<bucket) - 1;
+}
+
+// return the upper bound of the bucket containing the given percentile of runs
+uint16_t AP::PerfInfo::TaskInfo::percentile_us(uint8_t pct) const
+{
+    return hist_percentile_us(hist, pct, max_time_us);
+}
+
+// return the upper bound of the bucket of a histogram containing the
+// given percentile of runs, or max_us if it is in the last bucket
+uint32_t AP::PerfInfo::hist_percentile_us(const uint16_t hist[PERFINFO_TASK_HIST_BUCKETS], uint8_t pct, uint32_t max_us)
+{
+    uint32_t total = 0;
+    for (uint8_t i=0; i<PERFINFO_TASK_HIST_BUCKETS; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const uint32_t target = (total * pct + 99) / 100;
+    uint32_t sum = 0;
+    for (uint8_t i=0; i<PERFINFO_TASK_HIST_BUCKETS; i++) {
+        sum += hist[i];
+        if (sum >= target) {
+            // the last bucket is open ended, report the max seen
+            return i == PERFINFO_TASK_HIST_BUCKETS-1 ? max_us : hist_bucket_max_us(i);
+        }
+    }
+    return max_us;
+}
+
 // check_loop_time - check latest loop time vs min, max and overtime threshold
 void AP::PerfInfo::check_loop_time(uint32_t time_in_micros)
 {
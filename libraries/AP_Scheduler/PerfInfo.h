@@ -2,6 +2,11 @@
 
 #include <stdint.h>
 
+// number of log2 buckets in the per-task run time histogram. Bucket 0
+// counts runs of 0us, bucket n counts runs of [2^(n-1), 2^n) us and
+// the last bucket counts everything longer
+#define PERFINFO_TASK_HIST_BUCKETS 12
+
 namespace AP {
 
 class PerfInfo {
@@ -16,8 +21,22 @@ public:
         uint32_t tick_count;
         uint16_t slip_count;
         uint16_t overrun_count;
+        uint16_t deadline_miss_count;
+        uint16_t hist[PERFINFO_TASK_HIST_BUCKETS];
+
+        // return the upper bound in microseconds of the histogram
+        // bucket containing the given percentile of runs
+        uint16_t percentile_us(uint8_t pct) const;
     };
 
+    // histogram bucket for a task run time
+    static uint8_t hist_bucket(uint16_t task_time_us);
+    // upper bound of a histogram bucket in microseconds, 0xFFFF for the last bucket
+    static uint16_t hist_bucket_max_us(uint8_t bucket);
+    // upper bound of the bucket containing the given percentile of
+    // runs, max_us if that is the last bucket
+    static uint32_t hist_percentile_us(const uint16_t hist[PERFINFO_TASK_HIST_BUCKETS], uint8_t pct, uint32_t max_us);
+
     /* Do not allow copies */
     PerfInfo(const PerfInfo &other) = delete;
     PerfInfo &operator=(const PerfInfo&) = delete;
@@ -50,7 +69,13 @@ public:
     // record that a task slipped
     void task_slipped(uint8_t task_index) {
         if (_task_info && task_index <= _num_tasks) {
-            _task_info[task_index].overrun_count++;
+            _task_info[task_index].slip_count++;
+        }
+    }
+    // record that a task ran after its deadline
+    void task_missed_deadline(uint8_t task_index) {
+        if (_task_info && task_index <= _num_tasks) {
+            _task_info[task_index].deadline_miss_count++;
         }
     }
 
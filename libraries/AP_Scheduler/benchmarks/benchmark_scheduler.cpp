@@ -0,0 +1,419 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include <AP_Scheduler/AP_Scheduler.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  run the scheduler against a stopped SITL clock with synthetic task
+  costs, to see how its policies cope with overload without flying.
+
+  The task tables are the rates and time limits of the Copter and
+  Plane scheduler_tasks[] tables plus the common vehicle tasks. By
+  default each task averages half its time limit with one run in 50
+  taking 1.5 times the limit. Costs measured on a vehicle can be used
+  instead by setting SCHED_BENCH_TASKS to the path of a copy of its
+  @SYS/tasks.txt, which gives the AVG and MAX of each task and of the
+  fast loop. The first argument scales all the costs in percent, so
+  values above 100 overload the loop. The second selects earliest
+  deadline first ordering (SCHED_OPTIONS bit 1) instead of task table
+  order.
+
+  The label of each benchmark holds the results over SIM_SECONDS:
+  run:   task runs made as a percentage of those asked for
+  worst: the task with the lowest percentage
+  slip:  number of times a task was due but one interval late
+  miss:  number of runs that started after their deadline
+  jit:   standard deviation of the loop time
+  lmax:  longest loop
+  long:  loops more than 20% over the loop period
+  extra: mean extra time the scheduler gave each loop for tasks that
+         were falling behind
+ */
+
+#define SIM_SECONDS 10
+
+// one run in SPIKE_INTERVAL of a task takes its maximum time
+#define SPIKE_INTERVAL 50
+
+struct BenchTask {
+    const char *name;
+    float rate_hz;
+    uint16_t max_time_micros;
+};
+
+static const BenchTask copter_tasks[] = {
+    { "Copter::rc_loop",                       100,  130 },
+    { "Copter::throttle_loop",                  50,   75 },
+    { "AP_GPS::update",                         50,  200 },
+    { "OpticalFlow::update",                   200,  160 },
+    { "Copter::update_batt_compass",            10,  120 },
+    { "RC_Channels::read_aux_all",              10,   50 },
+    { "Copter::arm_motors_check",               10,   50 },
+    { "Copter::auto_disarm_check",              10,   50 },
+    { "Copter::auto_trim",                      10,   75 },
+    { "Copter::read_rangefinder",               20,  100 },
+    { "AP_Proximity::update",                  200,   50 },
+    { "AP_Beacon::update",                     400,   50 },
+    { "Copter::update_altitude",                10,  100 },
+    { "Copter::run_nav_updates",                50,  100 },
+    { "Copter::update_throttle_hover",         100,   90 },
+    { "ModeSmartRTL::save_position",             3,  100 },
+    { "AC_Sprayer::update",                      3,   90 },
+    { "Copter::three_hz_loop",                   3,   75 },
+    { "AP_ServoRelayEvents::update_events",     50,   75 },
+    { "AP_Baro::accumulate",                    50,   90 },
+    { "AC_Fence::update",                       10,  100 },
+    { "Copter::update_precland",               400,   50 },
+    { "Copter::check_dynamic_flight",           50,   75 },
+    { "Copter::fourhundred_hz_logging",        400,   50 },
+    { "AP_Notify::update",                      50,   90 },
+    { "Copter::one_hz_loop",                     1,  100 },
+    { "Copter::ekf_check",                      10,   75 },
+    { "Copter::check_vibration",                10,   50 },
+    { "Copter::gpsglitch_check",                10,   50 },
+    { "Copter::landinggear_update",             10,   75 },
+    { "Copter::standby_update",                100,   75 },
+    { "Copter::lost_vehicle_check",             10,   50 },
+    { "GCS::update_receive",                   400,  180 },
+    { "GCS::update_send",                      400,  550 },
+    { "AP_Mount::update",                       50,   75 },
+    { "AP_Camera::update",                      50,   75 },
+    { "Copter::ten_hz_logging_loop",            10,  350 },
+    { "Copter::twentyfive_hz_logging",          25,  110 },
+    { "AP_Logger::periodic_tasks",             400,  300 },
+    { "AP_InertialSensor::periodic",           400,   50 },
+    { "AP_Scheduler::update_logging",          0.1,   75 },
+    { "Copter::rpm_update",                     40,  200 },
+    { "Copter::compass_cal_update",            100,  100 },
+    { "Copter::accel_cal_update",               10,  100 },
+    { "AP_TempCalibration::update",             10,  100 },
+    { "Copter::avoidance_adsb_update",          10,  100 },
+    { "Copter::afs_fs_check",                   10,  100 },
+    { "Copter::terrain_update",                 10,  100 },
+    { "AP_Gripper::update",                     10,   75 },
+    { "AP_Winch::update",                       50,   50 },
+    { "AP_Button::update",                       5,  100 },
+    { "AP_Stats::update",                        1,  100 },
+    { "AP_Vehicle::update_dynamic_notch", LOOP_RATE,  200 },
+    { "AP_Vehicle::send_watchdog_reset_statustext", 0.1, 20 },
+    { "AP_ESC_Telem::update",                   10,   50 },
+    { "AP_Vehicle::publish_osd_info",            1,   10 },
+};
+
+static const BenchTask plane_tasks[] = {
+    { "Plane::ahrs_update",                    400,  400 },
+    { "Plane::read_radio",                      50,  100 },
+    { "Plane::check_short_failsafe",            50,  100 },
+    { "Plane::update_speed_height",             50,  200 },
+    { "Plane::update_control_mode",            400,  100 },
+    { "Plane::stabilize",                      400,  100 },
+    { "Plane::set_servos",                     400,  100 },
+    { "Plane::update_throttle_hover",          100,   90 },
+    { "Plane::read_control_switch",              7,  100 },
+    { "Plane::update_GPS_50Hz",                 50,  300 },
+    { "Plane::update_GPS_10Hz",                 10,  400 },
+    { "Plane::navigate",                        10,  150 },
+    { "Plane::update_compass",                  10,  200 },
+    { "Plane::read_airspeed",                   10,  100 },
+    { "Plane::update_alt",                      10,  200 },
+    { "Plane::adjust_altitude_target",          10,  200 },
+    { "Plane::afs_fs_check",                    10,  100 },
+    { "Plane::ekf_check",                       10,   75 },
+    { "GCS::update_receive",                   300,  500 },
+    { "GCS::update_send",                      300,  750 },
+    { "AP_ServoRelayEvents::update_events",     50,  150 },
+    { "AP_BattMonitor::read",                   10,  300 },
+    { "AP_Baro::accumulate",                    50,  150 },
+    { "AP_Notify::update",                      50,  300 },
+    { "AC_Fence::update",                       10,  100 },
+    { "Plane::read_rangefinder",                50,  100 },
+    { "AP_ICEngine::update",                    10,  100 },
+    { "Compass::cal_update",                    50,   50 },
+    { "Plane::accel_cal_update",                10,   50 },
+    { "OpticalFlow::update",                    50,   50 },
+    { "Plane::one_second_loop",                  1,  400 },
+    { "Plane::three_hz_loop",                    3,   75 },
+    { "Plane::check_long_failsafe",              3,  400 },
+    { "Plane::rpm_update",                      10,  100 },
+    { "Plane::airspeed_ratio_update",            1,  100 },
+    { "AP_Mount::update",                       50,  100 },
+    { "AP_Camera::update",                      50,  100 },
+    { "AP_Scheduler::update_logging",          0.2,  100 },
+    { "Plane::compass_save",                   0.1,  200 },
+    { "Plane::Log_Write_Fast",                  25,  300 },
+    { "Plane::update_logging1",                 25,  300 },
+    { "Plane::update_logging2",                 25,  300 },
+    { "Plane::update_soaring",                  50,  400 },
+    { "Plane::parachute_check",                 10,  200 },
+    { "AP_Terrain::update",                     10,  200 },
+    { "Plane::update_is_flying_5Hz",             5,  100 },
+    { "AP_Logger::periodic_tasks",              50,  400 },
+    { "AP_InertialSensor::periodic",            50,   50 },
+    { "Plane::avoidance_adsb_update",           10,  100 },
+    { "RC_Channels::read_aux_all",              10,  200 },
+    { "AP_Button::update",                       5,  100 },
+    { "AP_Stats::update",                        1,  100 },
+    { "AP_Gripper::update",                     10,   75 },
+    { "Plane::landing_gear_update",              5,   50 },
+    { "Plane::efi_update",                      10,  200 },
+    { "AP_Vehicle::update_dynamic_notch", LOOP_RATE,  200 },
+    { "AP_Vehicle::send_watchdog_reset_statustext", 0.1, 20 },
+    { "AP_ESC_Telem::update",                   10,   50 },
+    { "AP_Vehicle::publish_osd_info",            1,   10 },
+};
+
+#define MAX_BENCH_TASKS 64
+
+class AP_Scheduler_Benchmark {
+public:
+    // simulate SIM_SECONDS of the main loop, putting the results in label
+    void run(const BenchTask *table, uint8_t num_tasks,
+             uint16_t loop_rate_hz, uint16_t fast_loop_us,
+             uint16_t load_pct, bool deadline_ordering,
+             char *label, uint8_t label_len);
+
+private:
+    // a task which advances the clock by a pseudo-random cost
+    struct SyntheticTask {
+        float base_us;
+        float max_us;
+        uint32_t seed;
+        uint32_t runs;
+
+        void setup(float avg_us, float max_us, uint32_t seed);
+        void run();
+    };
+
+    // costs read from SCHED_BENCH_TASKS
+    struct MeasuredCost {
+        char name[33];
+        uint16_t avg_us;
+        uint16_t max_us;
+    };
+
+    void load_measured_costs();
+    const MeasuredCost *find_measured_cost(const char *name) const;
+
+    AP_Scheduler scheduler;
+    SyntheticTask fast_loop;
+    SyntheticTask synthetic[MAX_BENCH_TASKS];
+    AP_Scheduler::Task tasks[MAX_BENCH_TASKS];
+
+    MeasuredCost measured[MAX_BENCH_TASKS+1];
+    uint8_t num_measured;
+    bool measured_loaded;
+};
+
+void AP_Scheduler_Benchmark::SyntheticTask::setup(float avg_us, float _max_us, uint32_t _seed)
+{
+    max_us = MAX(_max_us, avg_us);
+    // choose the cost of the other runs so the mean is avg_us
+    base_us = MAX((avg_us * SPIKE_INTERVAL - max_us) / (SPIKE_INTERVAL - 1), 0);
+    seed = _seed;
+    runs = 0;
+}
+
+void AP_Scheduler_Benchmark::SyntheticTask::run()
+{
+    seed = seed * 1103515245U + 12345U;
+    float cost_us;
+    if (++runs % SPIKE_INTERVAL == 0) {
+        cost_us = max_us;
+    } else {
+        // +-25% around the base cost
+        cost_us = base_us * (0.75f + 0.5f * ((seed >> 16) & 0xFFFF) / 65535.0f);
+    }
+    hal.scheduler->stop_clock(AP_HAL::micros64() + uint32_t(cost_us));
+}
+
+/*
+  read the task costs from a @SYS/tasks.txt listing, which has a line
+  per task of the form "name MIN=n MAX=n AVG=n ..."
+ */
+void AP_Scheduler_Benchmark::load_measured_costs()
+{
+    measured_loaded = true;
+    const char *path = getenv("SCHED_BENCH_TASKS");
+    if (path == nullptr) {
+        return;
+    }
+    FILE *f = fopen(path, "r");
+    if (f == nullptr) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        return;
+    }
+    char line[200];
+    while (fgets(line, sizeof(line), f) && num_measured < ARRAY_SIZE(measured)) {
+        MeasuredCost &m = measured[num_measured];
+        unsigned min_us, max_us, avg_us;
+        if (sscanf(line, "%32s MIN=%u MAX=%u AVG=%u", m.name, &min_us, &max_us, &avg_us) != 4) {
+            continue;
+        }
+        m.avg_us = avg_us;
+        m.max_us = max_us;
+        num_measured++;
+    }
+    fclose(f);
+}
+
+const AP_Scheduler_Benchmark::MeasuredCost *AP_Scheduler_Benchmark::find_measured_cost(const char *name) const
+{
+    for (uint8_t i = 0; i < num_measured; i++) {
+        // tasks.txt truncates names to 32 characters
+        if (strncmp(measured[i].name, name, 32) == 0) {
+            return &measured[i];
+        }
+    }
+    return nullptr;
+}
+
+void AP_Scheduler_Benchmark::run(const BenchTask *table, uint8_t num_tasks,
+                                 uint16_t loop_rate_hz, uint16_t fast_loop_us,
+                                 uint16_t load_pct, bool deadline_ordering,
+                                 char *label, uint8_t label_len)
+{
+    if (!measured_loaded) {
+        load_measured_costs();
+    }
+    num_tasks = MIN(num_tasks, MAX_BENCH_TASKS);
+    const float scale = load_pct * 0.01f;
+
+    for (uint8_t i = 0; i < num_tasks; i++) {
+        const MeasuredCost *m = find_measured_cost(table[i].name);
+        if (m != nullptr) {
+            synthetic[i].setup(m->avg_us * scale, m->max_us * scale, i + 1);
+        } else {
+            synthetic[i].setup(table[i].max_time_micros * 0.5f * scale,
+                               table[i].max_time_micros * 1.5f * scale, i + 1);
+        }
+        tasks[i] = {
+            .function = FUNCTOR_BIND(&synthetic[i], &SyntheticTask::run, void),
+            .name = table[i].name,
+            .rate_hz = table[i].rate_hz,
+            .max_time_micros = table[i].max_time_micros,
+        };
+    }
+    const MeasuredCost *m = find_measured_cost("fast_loop");
+    if (m != nullptr) {
+        fast_loop.setup(m->avg_us * scale, m->max_us * scale, 0);
+    } else {
+        fast_loop.setup(fast_loop_us * scale, fast_loop_us * 1.2f * scale, 0);
+    }
+
+    // start from a fresh scheduler each time
+    AP_Scheduler &s = scheduler;
+    delete[] s._last_run;
+    delete[] s._deadline_order;
+    delete[] s._deadline_slack;
+    s.perf_info.free_task_info();
+    s._fastloop_fn = FUNCTOR_BIND(&fast_loop, &SyntheticTask::run, void);
+    s._loop_rate_hz.set(loop_rate_hz);
+    s._active_loop_rate_hz.set(loop_rate_hz);
+    s._loop_period_us = 0;
+    s._loop_period_s = 0;
+    s._options.set(uint8_t(AP_Scheduler::Options::RECORD_TASK_INFO) |
+                   (deadline_ordering ? uint8_t(AP_Scheduler::Options::DEADLINE_ORDERING) : 0));
+    s._loop_timer_start_us = 0;
+    s._spare_micros = 0;
+    s._spare_ticks = 0;
+    s.extra_loop_us = 0;
+    s.task_not_achieved = 0;
+    s.task_all_achieved = 0;
+    s.init(tasks, num_tasks, (uint32_t)-1);
+
+    if (AP_HAL::micros64() == 0) {
+        // a stopped clock of zero means the clock is running
+        hal.scheduler->stop_clock(1000000);
+    }
+
+    const uint32_t loop_us = 1000000U / loop_rate_hz;
+    const uint32_t num_loops = SIM_SECONDS * loop_rate_hz;
+    uint64_t next_sample_us = AP_HAL::micros64() + loop_us;
+    uint64_t extra_loop_us_total = 0;
+    for (uint32_t i = 0; i < num_loops; i++) {
+        // wait for the next INS sample. If the last loop overran a
+        // sample is already waiting and this loop starts late
+        uint64_t now = AP_HAL::micros64();
+        if (now < next_sample_us) {
+            now = next_sample_us;
+            hal.scheduler->stop_clock(now);
+        }
+        while (next_sample_us <= now) {
+            next_sample_us += loop_us;
+        }
+        if (i == 0) {
+            // there is no previous loop to time this one against
+            s.perf_info.ignore_this_loop();
+        }
+        s.run_loop(uint32_t(now));
+        extra_loop_us_total += s.get_extra_loop_us();
+    }
+
+    // compare the runs made with those asked for
+    uint32_t runs = 0;
+    uint32_t runs_wanted = 0;
+    uint32_t slips = 0;
+    uint32_t misses = 0;
+    float worst_pct = 100;
+    const char *worst = "none";
+    for (uint8_t i = 0; i < num_tasks; i++) {
+        const AP::PerfInfo::TaskInfo *ti = s.perf_info.get_task_info(i);
+        const uint32_t wanted = MAX(num_loops / s.task_interval_ticks(tasks[i]), 1U);
+        runs += ti->tick_count;
+        runs_wanted += wanted;
+        slips += ti->slip_count;
+        misses += ti->deadline_miss_count;
+        const float pct = 100.0f * ti->tick_count / wanted;
+        if (pct < worst_pct) {
+            worst_pct = pct;
+            worst = tasks[i].name;
+        }
+    }
+
+    snprintf(label, label_len,
+             "run=%.1f%% worst=%s:%.0f%% slip=%u miss=%u jit=%uus lmax=%uus long=%u extra=%uus",
+             100.0f * runs / runs_wanted, worst, worst_pct,
+             unsigned(slips), unsigned(misses),
+             unsigned(s.perf_info.get_stddev_time()), unsigned(s.perf_info.get_max_time()),
+             unsigned(s.perf_info.get_num_long_running()),
+             unsigned(extra_loop_us_total / num_loops));
+}
+
+static AP_Scheduler_Benchmark bench;
+
+static void BM_SchedulerCopter(benchmark::State& state)
+{
+    char label[160];
+    while (state.KeepRunning()) {
+        bench.run(copter_tasks, ARRAY_SIZE(copter_tasks), 400, 1000,
+                  state.range_x(), state.range_y() != 0, label, sizeof(label));
+    }
+    state.SetLabel(label);
+}
+
+static void BM_SchedulerPlane(benchmark::State& state)
+{
+    char label[160];
+    while (state.KeepRunning()) {
+        bench.run(plane_tasks, ARRAY_SIZE(plane_tasks), 300, 400,
+                  state.range_x(), state.range_y() != 0, label, sizeof(label));
+    }
+    state.SetLabel(label);
+}
+
+// cost scale in percent, and whether to use earliest deadline first ordering
+BENCHMARK(BM_SchedulerCopter)->ArgPair(50, 0)->ArgPair(50, 1)->ArgPair(100, 0)->ArgPair(100, 1)
+                             ->ArgPair(150, 0)->ArgPair(150, 1)->ArgPair(200, 0)->ArgPair(200, 1);
+BENCHMARK(BM_SchedulerPlane)->ArgPair(50, 0)->ArgPair(50, 1)->ArgPair(100, 0)->ArgPair(100, 1)
+                            ->ArgPair(150, 0)->ArgPair(150, 1)->ArgPair(200, 0)->ArgPair(200, 1);
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+BENCHMARK_MAIN()
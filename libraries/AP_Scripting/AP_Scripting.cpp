@@ -16,6 +16,7 @@
 #include <AP_Scripting/AP_Scripting.h>
 #include <AP_HAL/AP_HAL.h>
 #include <GCS_MAVLink/GCS.h>
+#include <AP_Common/MemoryTag.h>
 
 #include "lua_scripts.h"
 
@@ -109,6 +110,13 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("DIR_DISABLE", 9, AP_Scripting, _dir_disable, 0),
 
+    // @Param: VM_SLICES
+    // @DisplayName: Scripting Virtual Machine Time Slices
+    // @Description: The number of times a script can run out of its SCR_VM_I_COUNT instructions in one run and be suspended, to carry on where it left off when its turn next comes, before it is considered to have taken an excessive amount of time. A script can only be suspended while running Lua code; running out inside a library function, or in a function called back from one such as a table.sort comparison, stops the script. 1 stops scripts the first time they run out
+    // @Range: 1 1000
+    // @User: Advanced
+    AP_GROUPINFO("VM_SLICES", 10, AP_Scripting, _script_vm_slices, 50),
+
     AP_GROUPEND
 };
 
@@ -135,6 +143,7 @@ void AP_Scripting::init(void) {
         }
     }
 
+    WITH_MEMORY_TAG(SCRIPTING);
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_Scripting::thread, void),
                                       "Scripting", SCRIPTING_STACK_SIZE, AP_HAL::Scheduler::PRIORITY_SCRIPTING, 0)) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Could not create scripting stack (%d)", SCRIPTING_STACK_SIZE);
@@ -193,19 +202,36 @@ void AP_Scripting::repl_stop(void) {
 }
 
 void AP_Scripting::thread(void) {
-    lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_level, terminal);
+    lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_vm_slices, _script_heap_size, _debug_level, terminal);
     if (lua == nullptr || !lua->heap_allocated()) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Unable to allocate scripting memory");
         delete lua;
         _init_failed = true;
         return;
     }
+    _lua = lua;
     lua->run();
 
     // only reachable if the lua backend has died for any reason
     gcs().send_text(MAV_SEVERITY_CRITICAL, "Scripting has stopped");
 }
 
+void AP_Scripting::stats_info(ExpandingString &str)
+{
+    if (_lua == nullptr) {
+        return;
+    }
+    _lua->stats_info(str);
+}
+
+void AP_Scripting::handle_message_event(uint32_t msgid)
+{
+    if (_lua == nullptr) {
+        return;
+    }
+    _lua->handle_message_event(msgid);
+}
+
 void AP_Scripting::handle_mission_command(const AP_Mission::Mission_Command& cmd_in)
 {
     if (!_enable) {
@@ -26,6 +26,9 @@
   #define SCRIPTING_MAX_NUM_I2C_DEVICE 4
 #endif
 
+class ExpandingString;
+class lua_scripts;
+
 class AP_Scripting
 {
 public:
@@ -44,6 +47,13 @@ public:
 
     static const struct AP_Param::GroupInfo var_info[];
 
+    // per-script statistics for @SYS/scripts.txt
+    void stats_info(ExpandingString &str);
+
+    // wake scripts waiting on a MAVLink message id
+    void handle_message_event(uint32_t msgid);
+    lua_scripts *get_lua(void) const { return _lua; }
+
     MAV_RESULT handle_command_int_packet(const mavlink_command_int_t &packet);
 
     void handle_mission_command(const AP_Mission::Mission_Command& cmd);
@@ -92,9 +102,12 @@ private:
     AP_Int32 _script_heap_size;
     AP_Int8 _debug_level;
     AP_Int16 _dir_disable;
+    AP_Int16 _script_vm_slices;
 
     bool _init_failed;  // true if memory allocation failed
 
+    lua_scripts *_lua;  // the running interpreter, nullptr until the thread has started
+
     static AP_Scripting *_singleton;
 
 };
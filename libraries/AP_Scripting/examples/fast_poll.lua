@@ -0,0 +1,43 @@
+-- This script is an example of reading the AHRS, GPS and rangefinders at a
+-- high rate without making garbage. The _into functions write into a
+-- Location or Vector3f made once when the script loads, and the bulk getters
+-- return several values from one call
+
+local position = Location()
+local velocity = Vector3f()
+local gps_loc = Location()
+local distances = {}
+
+local count = 0
+
+function update()
+  local have_position = ahrs:get_position_into(position)
+  local have_velocity = ahrs:get_velocity_NED_into(velocity)
+  local roll, pitch, yaw = ahrs:get_attitude()
+
+  local gps_status, num_sats, ground_speed = 0, 0, 0
+  if gps:num_sensors() > 0 then
+    gps:location_into(0, gps_loc)
+    gps_status, num_sats, ground_speed = gps:state(0)
+  end
+
+  local num_rangefinders = rangefinder:distances_cm(distances)
+
+  count = count + 1
+  if count >= 50 then
+    count = 0
+    if have_position and have_velocity then
+      gcs:send_text(6, string.format("LUA: alt %.1fm vel %.1f %.1f %.1f att %.0f %.0f %.0f",
+                                     position:alt() * 0.01, velocity:x(), velocity:y(), velocity:z(),
+                                     math.deg(roll), math.deg(pitch), math.deg(yaw)))
+    end
+    gcs:send_text(6, string.format("LUA: gps status %d sats %d speed %.1f", gps_status, num_sats, ground_speed))
+    for i = 1, num_rangefinders do
+      gcs:send_text(6, string.format("LUA: rangefinder %d %dcm", i, distances[i]))
+    end
+  end
+
+  return update, 20
+end
+
+return update()
@@ -0,0 +1,64 @@
+-- This script is an example of a computation too long for one run of a script.
+-- A script that runs out of SCR_VM_I_COUNT instructions while running Lua code
+-- is suspended and carries on where it left off in its next turn, up to
+-- SCR_VM_SLICES times in one run. The geo functions do the loops over tables
+-- of Locations natively, which is much quicker than doing them in Lua
+
+local NUM_POINTS = 200
+
+-- build a lawnmower pattern of points around the vehicle
+local function build_survey(centre)
+  local points = {}
+  for i = 1, NUM_POINTS do
+    local loc = Location()
+    loc:lat(centre:lat())
+    loc:lng(centre:lng())
+    local row = (i - 1) // 10
+    local col = (i - 1) % 10
+    if row % 2 == 1 then
+      col = 9 - col
+    end
+    loc:offset(row * 20 - 190, col * 20 - 90)
+    points[i] = loc
+  end
+  return points
+end
+
+-- a slow pure Lua sort of the points by distance from the centre, which
+-- is likely to take several slices
+local function sort_by_distance(points, centre)
+  local dist = {}
+  for i = 1, #points do
+    dist[i] = centre:get_distance(points[i])
+  end
+  for i = 2, #points do
+    local j = i
+    while j > 1 and dist[j-1] > dist[j] do
+      dist[j-1], dist[j] = dist[j], dist[j-1]
+      points[j-1], points[j] = points[j], points[j-1]
+      j = j - 1
+    end
+  end
+end
+
+function update()
+  local centre = ahrs:get_position()
+  if not centre then
+    return update, 1000
+  end
+
+  local points = build_survey(centre)
+  local fence = { points[1], points[10], points[NUM_POINTS - 9], points[NUM_POINTS] }
+  gcs:send_text(6, string.format("LUA: survey %.0fm long, centre inside %s",
+                                 geo.path_length(points),
+                                 tostring(geo.inside_polygon(centre, fence))))
+
+  sort_by_distance(points, centre)
+  local nearest, dist = geo.nearest(centre, points)
+  gcs:send_text(6, string.format("LUA: nearest point %d at %.1fm, closest after sort %.1fm",
+                                 nearest, dist, centre:get_distance(points[1])))
+
+  return update, 10000
+end
+
+return update()
@@ -0,0 +1,40 @@
+-- This script is an example of sleeping until something happens rather than polling for it
+
+local MAVLINK_MSG_ID_COMMAND_LONG = 76
+
+-- ask to be woken early on these events, the subscriptions last for the life of the script
+wake_on("mode")
+wake_on("arming")
+wake_on("mission")
+if not wake_on_mavlink(MAVLINK_MSG_ID_COMMAND_LONG) then
+  gcs:send_text(0, "LUA: no room to wake on COMMAND_LONG")
+end
+
+local last_mode = vehicle:get_mode()
+local last_armed = arming:is_armed()
+local last_mission_index = mission:get_current_nav_index()
+
+function update() -- runs when an event happens, or after 10 seconds at the latest
+
+  local mode = vehicle:get_mode()
+  if mode ~= last_mode then
+    gcs:send_text(6, string.format("LUA: mode changed to %d", mode))
+    last_mode = mode
+  end
+
+  local armed = arming:is_armed()
+  if armed ~= last_armed then
+    gcs:send_text(6, armed and "LUA: armed" or "LUA: disarmed")
+    last_armed = armed
+  end
+
+  local mission_index = mission:get_current_nav_index()
+  if mission_index ~= last_mission_index then
+    gcs:send_text(6, string.format("LUA: mission item %d", mission_index))
+    last_mission_index = mission_index
+  end
+
+  return update, 10000 -- the longest we want to sleep for without an event
+end
+
+return update()
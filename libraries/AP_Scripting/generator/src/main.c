@@ -24,6 +24,7 @@ char keyword_singleton[]           = "singleton";
 char keyword_userdata[]            = "userdata";
 char keyword_write[]               = "write";
 char keyword_literal[]             = "literal";
+char keyword_manual[]              = "manual";
 
 // attributes (should include the leading ' )
 char keyword_attr_enum[]    = "'enum";
@@ -358,6 +359,13 @@ struct userdata_enum {
   char * name;     // enum name
 };
 
+// a method written by hand in lua_bindings.cpp
+struct manual_method {
+  struct manual_method * next;
+  char * name;     // name used for scripting access
+  char * function; // C function implementing it
+};
+
 struct userdata {
   struct userdata * next;
   char *name;  // name of the C++ singleton
@@ -366,6 +374,7 @@ struct userdata {
   struct userdata_field *fields;
   struct method *methods;
   struct userdata_enum *enums;
+  struct manual_method *manual_methods;
   enum userdata_type ud_type;
   uint32_t operations; // bitset of enum operation_types
   int flags; // flags from the userdata_flags enum
@@ -635,6 +644,25 @@ void handle_userdata_enum(struct userdata *data) {
   }
 }
 
+void handle_manual_method(struct userdata *data) {
+  trace(TRACE_SINGLETON, "Adding a manual method");
+
+  char * name = next_token();
+  if (name == NULL) {
+    error(ERROR_SINGLETON, "Missing a method name for the manual method of %s", data->name);
+  }
+  char * function = next_token();
+  if (function == NULL) {
+    error(ERROR_SINGLETON, "Missing the function implementing %s for %s", name, data->name);
+  }
+
+  struct manual_method *method = (struct manual_method *) allocate(sizeof(struct manual_method));
+  method->next = data->manual_methods;
+  string_copy(&(method->name), name);
+  string_copy(&(method->function), function);
+  data->manual_methods = method;
+}
+
 void handle_userdata_field(struct userdata *data) {
   trace(TRACE_USERDATA, "Adding a userdata field");
 
@@ -889,8 +917,10 @@ void handle_singleton(void) {
     string_copy(&(node->dependency), depends);
   } else if (strcmp(type, keyword_literal) == 0) {
     node->flags |= UD_FLAG_LITERAL;
+  } else if (strcmp(type, keyword_manual) == 0) {
+    handle_manual_method(node);
   } else {
-    error(ERROR_SINGLETON, "Singletons only support aliases, methods, semaphore, depends or literal keywords (got %s)", type);
+    error(ERROR_SINGLETON, "Singletons only support aliases, methods, semaphore, depends, literal or manual keywords (got %s)", type);
   }
 
   // ensure no more tokens on the line
@@ -1074,6 +1104,20 @@ void emit_userdata_declarations(void) {
   }
 }
 
+void emit_manual_declarations(void) {
+  struct userdata * node = parsed_singletons;
+  while (node) {
+    start_dependency(header, node->dependency);
+    struct manual_method *manual = node->manual_methods;
+    while (manual) {
+      fprintf(header, "int %s(lua_State *L);\n", manual->function);
+      manual = manual->next;
+    }
+    end_dependency(header, node->dependency);
+    node = node->next;
+  }
+}
+
 void emit_ap_object_declarations(void) {
   struct userdata * node = parsed_ap_objects;
   while (node) {
@@ -1826,6 +1870,12 @@ void emit_singleton_metatables(struct userdata *head) {
       method = method->next;
     }
 
+    struct manual_method *manual = node->manual_methods;
+    while (manual) {
+      fprintf(source, "    {\"%s\", %s},\n", manual->name, manual->function);
+      manual = manual->next;
+    }
+
     fprintf(source, "    {NULL, NULL}\n");
     fprintf(source, "};\n");
     end_dependency(source, node->dependency);
@@ -2145,6 +2195,7 @@ int main(int argc, char **argv) {
 
   emit_userdata_declarations();
   emit_ap_object_declarations();
+  emit_manual_declarations();
 
   fprintf(header, "void load_generated_bindings(lua_State *L);\n");
   fprintf(header, "void load_generated_sandbox(lua_State *L);\n");
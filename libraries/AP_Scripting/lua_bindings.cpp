@@ -2,10 +2,12 @@
 #include <SRV_Channel/SRV_Channel.h>
 #include <AP_HAL/HAL.h>
 #include <AP_Logger/AP_Logger.h>
+#include <AP_RangeFinder/AP_RangeFinder_Backend.h>
 
 #include "lua_bindings.h"
 
 #include "lua_boxed_numerics.h"
+#include "lua_scripts.h"
 #include <AP_Scripting/lua_generated_bindings.h>
 
 #include <AP_Scripting/AP_Scripting.h>
@@ -75,11 +77,65 @@ static int lua_mission_receive(lua_State *L) {
     return 5;
 }
 
+// wake the calling script early when an event happens
+// event is one of "mode", "arming" or "mission"
+static int lua_wake_on(lua_State *L) {
+    check_arguments(L, 1, "wake_on");
+
+    static const char *const event_names[] = { "mode", "arming", "mission", nullptr };
+    static const lua_scripts::wake_event wake_events[] = {
+        lua_scripts::wake_event::MODE,
+        lua_scripts::wake_event::ARMING,
+        lua_scripts::wake_event::MISSION,
+    };
+    const int event = luaL_checkoption(L, 1, nullptr, event_names);
+
+    lua_scripts *lua = AP::scripting()->get_lua();
+    lua_pushboolean(L, lua != nullptr && lua->wake_on(wake_events[event]));
+    return 1;
+}
+
+// wake the calling script early when a MAVLink message with the given id arrives
+static int lua_wake_on_mavlink(lua_State *L) {
+    check_arguments(L, 1, "wake_on_mavlink");
+
+    const lua_Integer msgid = luaL_checkinteger(L, 1);
+    luaL_argcheck(L, (msgid >= 0) && (msgid <= 0xFFFFFF), 1, "msgid out of range");
+
+    lua_scripts *lua = AP::scripting()->get_lua();
+    lua_pushboolean(L, lua != nullptr && lua->wake_on_mavlink(msgid));
+    return 1;
+}
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+// returns pool size, pool bytes in use, heap bytes in use, peak bytes in use,
+// pool fragmentation percentage and the count of pool misses
+static int lua_mem_stats(lua_State *L) {
+    check_arguments(L, 0, "mem_stats");
+
+    const lua_mem_pool &pool = lua_scripts::mem_pool();
+    const lua_mem_pool::stats &st = pool.get_stats();
+    lua_pushinteger(L, st.pool_size);
+    lua_pushinteger(L, st.pool_used);
+    lua_pushinteger(L, st.heap_used);
+    lua_pushinteger(L, st.peak_used);
+    lua_pushinteger(L, pool.fragmentation_pct());
+    lua_pushinteger(L, st.pool_misses);
+
+    return 6;
+}
+#endif // AP_SCRIPTING_MEM_POOL_ENABLED
+
 static const luaL_Reg global_functions[] =
 {
     {"millis", lua_millis},
     {"micros", lua_micros},
     {"mission_receive", lua_mission_receive},
+    {"wake_on", lua_wake_on},
+    {"wake_on_mavlink", lua_wake_on_mavlink},
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+    {"mem_stats", lua_mem_stats},
+#endif
     {NULL, NULL}
 };
 
@@ -281,6 +337,196 @@ const luaL_Reg AP_Logger_functions[] = {
     {NULL, NULL}
 };
 
+/*
+  native versions of loops over tables of Locations, which are slow
+  enough in Lua to make a script run out of time on large missions
+  and fences
+ */
+
+// the Location at index i of the table at index table
+static const Location *geo_location_at(lua_State *L, int table, lua_Integer i) {
+    lua_rawgeti(L, table, i);
+    const Location *loc = (const Location *)luaL_testudata(L, -1, "Location");
+    if (loc == nullptr) {
+        luaL_error(L, "entry %d is not a Location", (int)i);
+    }
+    // the table keeps the Location alive
+    lua_pop(L, 1);
+    return loc;
+}
+
+// total distance in metres along a table of Locations
+static int lua_geo_path_length(lua_State *L) {
+    check_arguments(L, 1, "geo.path_length");
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    const lua_Integer n = lua_rawlen(L, 1);
+    float length = 0;
+    for (lua_Integer i = 2; i <= n; i++) {
+        length += geo_location_at(L, 1, i - 1)->get_distance(*geo_location_at(L, 1, i));
+    }
+
+    lua_pushnumber(L, length);
+    return 1;
+}
+
+// index in a table of Locations of the one nearest a Location, and its
+// distance in metres. Returns nothing if the table is empty
+static int lua_geo_nearest(lua_State *L) {
+    check_arguments(L, 2, "geo.nearest");
+    const Location *loc = check_Location(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    const lua_Integer n = lua_rawlen(L, 2);
+    lua_Integer nearest = 0;
+    float nearest_dist = 0;
+    for (lua_Integer i = 1; i <= n; i++) {
+        const float dist = loc->get_distance(*geo_location_at(L, 2, i));
+        if (nearest == 0 || dist < nearest_dist) {
+            nearest = i;
+            nearest_dist = dist;
+        }
+    }
+    if (nearest == 0) {
+        return 0;
+    }
+
+    lua_pushinteger(L, nearest);
+    lua_pushnumber(L, nearest_dist);
+    return 2;
+}
+
+// true if a Location is inside the polygon with a table of Locations
+// as its vertices. The polygon may or may not repeat its first vertex
+static int lua_geo_inside_polygon(lua_State *L) {
+    check_arguments(L, 2, "geo.inside_polygon");
+    const Location *loc = check_Location(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    const lua_Integer n = lua_rawlen(L, 2);
+    if (n < 3) {
+        return luaL_argerror(L, 2, "polygon needs at least 3 vertices");
+    }
+
+    // count the edges crossing a line north of loc, with the vertices
+    // in metres north and east of it
+    bool inside = false;
+    Vector2f prev = loc->get_distance_NE(*geo_location_at(L, 2, n));
+    for (lua_Integer i = 1; i <= n; i++) {
+        const Vector2f v = loc->get_distance_NE(*geo_location_at(L, 2, i));
+        if ((v.y > 0) != (prev.y > 0) &&
+            prev.x + (v.x - prev.x) * (0 - prev.y) / (v.y - prev.y) > 0) {
+            inside = !inside;
+        }
+        prev = v;
+    }
+
+    lua_pushboolean(L, inside);
+    return 1;
+}
+
+const luaL_Reg geo_functions[] = {
+    {"path_length", lua_geo_path_length},
+    {"nearest", lua_geo_nearest},
+    {"inside_polygon", lua_geo_inside_polygon},
+    {NULL, NULL}
+};
+
+/*
+  versions of the AHRS, GPS and rangefinder getters for scripts that
+  poll them at a high rate. These write into a Location or Vector3f
+  the script already has, or return several values from one call,
+  rather than making new userdata for the garbage collector each time
+ */
+
+// roll, pitch and yaw in radians
+int lua_ahrs_get_attitude(lua_State *L) {
+    check_arguments(L, 1, "ahrs:get_attitude");
+    AP_AHRS &ahrs = AP::ahrs();
+
+    WITH_SEMAPHORE(ahrs.get_semaphore());
+    lua_pushnumber(L, ahrs.get_roll());
+    lua_pushnumber(L, ahrs.get_pitch());
+    lua_pushnumber(L, ahrs.get_yaw());
+    return 3;
+}
+
+// writes the position into a Location, returning false if there isn't one
+int lua_ahrs_get_position_into(lua_State *L) {
+    check_arguments(L, 2, "ahrs:get_position_into");
+    Location *loc = check_Location(L, 2);
+    AP_AHRS &ahrs = AP::ahrs();
+
+    WITH_SEMAPHORE(ahrs.get_semaphore());
+    lua_pushboolean(L, ahrs.get_position(*loc));
+    return 1;
+}
+
+// writes the NED velocity into a Vector3f, returning false if there isn't one
+int lua_ahrs_get_velocity_NED_into(lua_State *L) {
+    check_arguments(L, 2, "ahrs:get_velocity_NED_into");
+    Vector3f *vel = check_Vector3f(L, 2);
+    AP_AHRS &ahrs = AP::ahrs();
+
+    WITH_SEMAPHORE(ahrs.get_semaphore());
+    lua_pushboolean(L, ahrs.get_velocity_NED(*vel));
+    return 1;
+}
+
+static uint8_t check_gps_instance(lua_State *L, const AP_GPS &gps) {
+    const lua_Integer instance = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, ((instance >= 0) && (instance < gps.num_sensors())), 2, "argument out of range");
+    return static_cast<uint8_t>(instance);
+}
+
+// writes the location of a GPS instance into a Location
+int lua_gps_location_into(lua_State *L) {
+    check_arguments(L, 3, "gps:location_into");
+    const AP_GPS &gps = AP::gps();
+    const uint8_t instance = check_gps_instance(L, gps);
+    *check_Location(L, 3) = gps.location(instance);
+    return 0;
+}
+
+// fix status, number of satellites, ground speed and ground course of
+// a GPS instance
+int lua_gps_state(lua_State *L) {
+    check_arguments(L, 2, "gps:state");
+    const AP_GPS &gps = AP::gps();
+    const uint8_t instance = check_gps_instance(L, gps);
+    lua_pushinteger(L, gps.status(instance));
+    lua_pushinteger(L, gps.num_sats(instance));
+    lua_pushnumber(L, gps.ground_speed(instance));
+    lua_pushnumber(L, gps.ground_course(instance));
+    return 4;
+}
+
+// fills a table with the distance in cm of each rangefinder, indexed
+// from 1, or -1 for one without a good reading. Returns the number of
+// rangefinders
+int lua_rangefinder_distances_cm(lua_State *L) {
+    check_arguments(L, 2, "rangefinder:distances_cm");
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const RangeFinder *rangefinder = RangeFinder::get_singleton();
+    if (rangefinder == nullptr) {
+        return luaL_argerror(L, 1, "rangefinder not supported on this firmware");
+    }
+
+    const uint8_t num = rangefinder->num_sensors();
+    for (uint8_t i = 0; i < num; i++) {
+        const AP_RangeFinder_Backend *backend = rangefinder->get_backend(i);
+        lua_Integer dist = -1;
+        if (backend != nullptr && backend->status() == RangeFinder::Status::Good) {
+            dist = backend->distance_cm();
+        }
+        lua_pushinteger(L, dist);
+        lua_rawseti(L, 2, i + 1);
+    }
+
+    lua_pushinteger(L, num);
+    return 1;
+}
+
 static int lua_get_i2c_device(lua_State *L) {
 
     const int args = lua_gettop(L);
@@ -349,6 +595,10 @@ void load_lua_bindings(lua_State *L) {
     luaL_newlib(L, i2c_functions);
     lua_settable(L, -3);
 
+    lua_pushstring(L, "geo");
+    luaL_newlib(L, geo_functions);
+    lua_settable(L, -3);
+
     luaL_setfuncs(L, global_functions, 0);
 }
 
@@ -0,0 +1,141 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lua_mem_pool.h"
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <string.h>
+
+extern const AP_HAL::HAL& hal;
+
+void lua_mem_pool::init(void *heap, uint32_t pool_size)
+{
+    _heap = heap;
+    pool_size &= ~uint32_t(granularity-1);
+    if (pool_size == 0) {
+        return;
+    }
+    _region = (uint8_t *)hal.util->heap_realloc(_heap, nullptr, pool_size);
+    if (_region == nullptr) {
+        // run without a pool
+        return;
+    }
+    _region_end = _region + pool_size;
+    _carve = _region;
+    _stats.pool_size = pool_size;
+}
+
+void *lua_mem_pool::pool_alloc(int8_t c)
+{
+    const size_t size = class_size(c);
+    void *ret;
+    if (_free[c] != nullptr) {
+        ret = _free[c];
+        _free[c] = _free[c]->next;
+    } else if (_carve != nullptr && size_t(_region_end - _carve) >= size) {
+        ret = _carve;
+        _carve += size;
+        _stats.pool_carved += size;
+    } else {
+        return nullptr;
+    }
+    _stats.pool_used += size;
+    return ret;
+}
+
+void lua_mem_pool::pool_free(void *ptr, int8_t c)
+{
+    free_block *b = (free_block *)ptr;
+    b->next = _free[c];
+    _free[c] = b;
+    _stats.pool_used -= class_size(c);
+}
+
+void lua_mem_pool::update_peak(void)
+{
+    _stats.peak_used = MAX(_stats.peak_used, _stats.pool_used + _stats.heap_used);
+}
+
+void *lua_mem_pool::realloc(void *ptr, size_t osize, size_t nsize)
+{
+    if (ptr == nullptr) {
+        // for new blocks Lua passes the object type in osize
+        osize = 0;
+    }
+    const bool pooled = ptr != nullptr && in_pool(ptr);
+
+    if (nsize == 0) {
+        if (pooled) {
+            pool_free(ptr, size_class(osize));
+        } else if (ptr != nullptr) {
+            hal.util->heap_realloc(_heap, ptr, 0);
+            _stats.heap_used -= osize;
+        }
+        return nullptr;
+    }
+
+    const int8_t nc = size_class(nsize);
+    if (pooled && nc == size_class(osize)) {
+        // still fits in the same block
+        return ptr;
+    }
+    if (ptr != nullptr && !pooled && nc < 0) {
+        // a large block staying large, let the heap resize it
+        void *ret = hal.util->heap_realloc(_heap, ptr, nsize);
+        if (ret != nullptr) {
+            _stats.heap_used += nsize - osize;
+            update_peak();
+        }
+        return ret;
+    }
+
+    void *ret = nc >= 0 ? pool_alloc(nc) : nullptr;
+    if (ret == nullptr) {
+        if (nc >= 0) {
+            _stats.pool_misses++;
+        }
+        ret = hal.util->heap_realloc(_heap, nullptr, nsize);
+        if (ret == nullptr) {
+            // Lua requires the old block to survive a failed resize
+            return nullptr;
+        }
+        _stats.heap_used += nsize;
+    }
+
+    if (ptr != nullptr) {
+        memcpy(ret, ptr, MIN(osize, nsize));
+        if (pooled) {
+            pool_free(ptr, size_class(osize));
+        } else {
+            hal.util->heap_realloc(_heap, ptr, 0);
+            _stats.heap_used -= osize;
+        }
+    }
+    update_peak();
+    return ret;
+}
+
+uint8_t lua_mem_pool::fragmentation_pct(void) const
+{
+    if (_stats.pool_carved == 0) {
+        return 0;
+    }
+    return (100U * (_stats.pool_carved - _stats.pool_used)) / _stats.pool_carved;
+}
+
+#endif // AP_SCRIPTING_MEM_POOL_ENABLED
@@ -0,0 +1,97 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  size class pool allocator for the Lua VM. Most Lua allocations are
+  small strings, tables and closures which churn with every garbage
+  collection. Serving them from per-size free lists in a region
+  reserved from the scripting heap is cheaper than the heap allocator
+  and keeps them from fragmenting the rest of the heap. Lua passes the
+  old size of a block whenever it is freed or resized, so blocks need no
+  header; a block belongs to the pool if it lies within the region
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#ifndef AP_SCRIPTING_MEM_POOL_ENABLED
+#define AP_SCRIPTING_MEM_POOL_ENABLED 1
+#endif
+
+// share of the scripting heap reserved for the pool
+#ifndef AP_SCRIPTING_MEM_POOL_PCT
+#define AP_SCRIPTING_MEM_POOL_PCT 25
+#endif
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+
+class lua_mem_pool
+{
+public:
+    // reserve pool_size bytes of heap for the pool
+    void init(void *heap, uint32_t pool_size);
+
+    // allocator with the semantics of lua_Alloc
+    void *realloc(void *ptr, size_t osize, size_t nsize);
+
+    struct stats {
+        uint32_t pool_size;     // bytes reserved for the pool
+        uint32_t pool_carved;   // bytes of the pool divided into blocks so far
+        uint32_t pool_used;     // bytes of pool blocks in use
+        uint32_t heap_used;     // bytes allocated from the heap outside the pool
+        uint32_t peak_used;     // peak of pool_used + heap_used
+        uint32_t pool_misses;   // small allocations that had to use the heap
+    };
+    const struct stats &get_stats(void) const { return _stats; }
+
+    // percentage of the carved pool sitting unused in free lists
+    uint8_t fragmentation_pct(void) const;
+
+private:
+    static const uint8_t granularity = 8;
+    static const uint8_t num_classes = 8;   // blocks of 8 to 64 bytes
+
+    struct free_block {
+        free_block *next;
+    };
+
+    void *_heap;
+    uint8_t *_region;
+    uint8_t *_region_end;
+    uint8_t *_carve;                        // start of the uncarved part of the region
+    free_block *_free[num_classes];
+    struct stats _stats;
+
+    // size class of a block, or -1 if it is too large for the pool
+    static int8_t size_class(size_t size) {
+        if (size == 0 || size > num_classes * granularity) {
+            return -1;
+        }
+        return (size - 1) / granularity;
+    }
+    static size_t class_size(int8_t c) { return (c + 1) * granularity; }
+
+    bool in_pool(const void *ptr) const {
+        return (const uint8_t *)ptr >= _region && (const uint8_t *)ptr < _region_end;
+    }
+
+    void *pool_alloc(int8_t c);
+    void pool_free(void *ptr, int8_t c);
+    void update_peak(void);
+};
+
+#endif // AP_SCRIPTING_MEM_POOL_ENABLED
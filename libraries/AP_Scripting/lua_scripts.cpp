@@ -17,22 +17,42 @@
 #include <AP_HAL/AP_HAL.h>
 #include <GCS_MAVLink/GCS.h>
 #include "AP_Scripting.h"
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Common/ExpandingString.h>
+#include <AP_Common/MemoryTag.h>
+#include <AP_Arming/AP_Arming.h>
+#include <AP_Mission/AP_Mission.h>
+#include <AP_Vehicle/AP_Vehicle.h>
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
 extern const AP_HAL::HAL& hal;
 
 bool lua_scripts::overtime;
+bool lua_scripts::yield_allowed;
 jmp_buf lua_scripts::panic_jmp;
 
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal)
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int16 &vm_slices, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal)
     : _vm_steps(vm_steps),
+      _vm_slices(vm_slices),
       _debug_level(debug_level),
      terminal(_terminal) {
+    WITH_MEMORY_TAG(SCRIPTING);
     _heap = hal.util->allocate_heap_memory(heap_size);
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+    if (_heap != nullptr) {
+        _pool.init(_heap, (uint32_t(heap_size.get()) * AP_SCRIPTING_MEM_POOL_PCT) / 100);
+    }
+#endif
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
+    if (yield_allowed && lua_isyieldable(L)) {
+        // suspend the script, it carries on from here in its next slice
+        lua_yield(L, 0);
+        return;
+    }
+
     lua_scripts::overtime = true;
 
     // we need to aggressively bail out as we are over time
@@ -50,11 +70,31 @@ int lua_scripts::atpanic(lua_State *L) {
     return 0;
 }
 
+/*
+  .lua files are loaded as source and .luac files as precompiled
+  bytecode. Lua checks a bytecode header against the sizes and number
+  formats of this build, so bytecode for another platform fails to
+  load rather than misbehaving
+ */
+const char *lua_scripts::script_load_mode(const char *filename) {
+    const size_t length = strlen(filename);
+    if (length > 4 && strcmp(&filename[length-4], ".lua") == 0) {
+        return "t";
+    }
+#if AP_SCRIPTING_BYTECODE_ENABLED
+    if (length > 5 && strcmp(&filename[length-5], ".luac") == 0) {
+        return "b";
+    }
+#endif
+    return nullptr;
+}
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+    const char *mode = script_load_mode(filename);
+    if (int error = luaL_loadfilex(L, filename, mode)) {
         switch (error) {
             case LUA_ERRSYNTAX:
-                gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Syntax error in %s", filename);
+                gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s error in %s", (mode[0] == 'b') ? "Bytecode" : "Syntax", filename);
                 gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: Error: %s", lua_tostring(L, -1));
                 lua_pop(L, lua_gettop(L));
                 return nullptr;
@@ -84,11 +124,17 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
 
     new_script->name = filename;
     new_script->next = nullptr;
+    memset(&new_script->stats, 0, sizeof(new_script->stats));
+    new_script->wake_events = 0;
+    new_script->wake_msgids = 0;
 
     create_sandbox(L);
     lua_setupvalue(L, -2, 1);
 
     new_script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);   // cache the reference
+    new_script->thread = lua_newthread(L);
+    new_script->thread_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    new_script->slices = 0;
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
 
     return new_script;
@@ -128,27 +174,36 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         return;
     }
 
-    // load anything that ends in .lua
+    // load anything that ends in .lua or .luac
     for (struct dirent *de=AP::FS().readdir(d); de; de=AP::FS().readdir(d)) {
-        uint8_t length = strlen(de->d_name);
-        if (length < 5) {
-            // not long enough
-            continue;
-        }
-
-        if (strncmp(&de->d_name[length-4], ".lua", 4)) {
-            // doesn't end in .lua
+        const char *mode = script_load_mode(de->d_name);
+        if (mode == nullptr) {
             continue;
         }
 
         // FIXME: because chunk name fetching is not working we are allocating and storing an extra string we shouldn't need to
-        size_t size = strlen(dirname) + strlen(de->d_name) + 2;
+        // one spare byte so a .lua name can be checked for a .luac alongside it
+        size_t size = strlen(dirname) + strlen(de->d_name) + 3;
         char * filename = (char *) hal.util->heap_realloc(_heap, nullptr, size);
         if (filename == nullptr) {
             continue;
         }
         snprintf(filename, size, "%s/%s", dirname, de->d_name);
 
+#if AP_SCRIPTING_BYTECODE_ENABLED
+        if (mode[0] == 't') {
+            // a compiled copy of the script takes precedence over the source
+            struct stat st;
+            strcat(filename, "c");
+            const bool have_bytecode = AP::FS().stat(filename, &st) == 0;
+            filename[strlen(filename)-1] = 0;
+            if (have_bytecode) {
+                hal.util->heap_realloc(_heap, filename, 0);
+                continue;
+            }
+        }
+#endif
+
         // we have something that looks like a lua file, attempt to load it
         script_info * script = load_script(L, filename);
         if (script == nullptr) {
@@ -178,32 +233,57 @@ void lua_scripts::run_next_script(lua_State *L) {
 
     uint64_t start_time_ms = AP_HAL::millis64();
     // strip the selected script out of the list
-    script_info *script = scripts;
-    scripts = script->next;
+    script_info *script;
+    {
+        WITH_SEMAPHORE(list_sem);
+        script = scripts;
+        scripts = script->next;
+        running = script;
+    }
+    last_run = nullptr;
+
+    // the script runs in its own thread, which is left suspended if it
+    // runs out of time part way through
+    lua_State *T = script->thread;
+    if (script->slices == 0) {
+        // start a new run, pushing the function to the top of the stack
+        lua_rawgeti(T, LUA_REGISTRYINDEX, script->lua_ref);
+    }
+    script->slices++;
+    // a script still running at the end of its last slice is stopped
+    yield_allowed = script->slices < _vm_slices;
 
     // reset the hook to clear the counter
-    reset_loop_overtime(L);
+    reset_loop_overtime(T);
 
-    // store top of stack so we can calculate the number of return values
-    int stack_top = lua_gettop(L);
+    const uint32_t alloc_start = _alloc_bytes;
+    const uint32_t run_start_us = AP_HAL::micros();
+    const int status = lua_resume(T, L, 0);
+    yield_allowed = false;
+    update_run_stats(script, AP_HAL::micros() - run_start_us, _alloc_bytes - alloc_start);
 
-    // pop the function to the top of the stack
-    lua_rawgeti(L, LUA_REGISTRYINDEX, script->lua_ref);
+    if (status == LUA_YIELD) {
+        // let the other scripts have their turn before carrying on
+        script->next_run_ms = AP_HAL::millis64() + AP_SCRIPTING_YIELD_DELAY_MS;
+        reschedule_script(script);
+        last_run = script;
+        return;
+    }
+    script->slices = 0;
 
-    if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
+    if (status) {
         if (overtime) {
             // script has consumed an excessive amount of CPU time
             gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s exceeded time limit", script->name);
-            remove_script(L, script);
         } else {
-            hal.console->printf("Lua: Error: %s\n", lua_tostring(L, -1));
-            gcs().send_text(MAV_SEVERITY_INFO, "Lua: %s", lua_tostring(L, -1));
-            remove_script(L, script);
+            hal.console->printf("Lua: Error: %s\n", lua_tostring(T, -1));
+            gcs().send_text(MAV_SEVERITY_INFO, "Lua: %s", lua_tostring(T, -1));
         }
-        lua_pop(L, 1);
+        // an error leaves the thread dead, it goes with the script
+        remove_script(L, script);
         return;
     } else {
-        int returned = lua_gettop(L) - stack_top;
+        int returned = lua_gettop(T);
         switch (returned) {
             case 0:
                 // no time to reschedule so bail out
@@ -212,34 +292,35 @@ void lua_scripts::run_next_script(lua_State *L) {
             case 2:
                 {
                    // sanity check the return types
-                   if (lua_type(L, -1) != LUA_TNUMBER) {
-                       gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s did not return a delay (0x%d)", script->name, lua_type(L, -1));
-                       lua_pop(L, 2);
+                   if (lua_type(T, -1) != LUA_TNUMBER) {
+                       gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s did not return a delay (0x%d)", script->name, lua_type(T, -1));
+                       lua_pop(T, 2);
                        remove_script(L, script);
                        return;
                    }
-                   if (lua_type(L, -2) != LUA_TFUNCTION) {
-                       gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s did not return a function (0x%d)", script->name, lua_type(L, -2));
-                       lua_pop(L, 2);
+                   if (lua_type(T, -2) != LUA_TFUNCTION) {
+                       gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s did not return a function (0x%d)", script->name, lua_type(T, -2));
+                       lua_pop(T, 2);
                        remove_script(L, script);
                        return;
                    }
 
                    // types match the expectations, go ahead and reschedule
-                   script->next_run_ms = start_time_ms + (uint64_t)luaL_checknumber(L, -1);
-                   lua_pop(L, 1);
+                   script->next_run_ms = start_time_ms + (uint64_t)luaL_checknumber(T, -1);
+                   lua_pop(T, 1);
                    int old_ref = script->lua_ref;
-                   script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);
-                   luaL_unref(L, LUA_REGISTRYINDEX, old_ref);
+                   script->lua_ref = luaL_ref(T, LUA_REGISTRYINDEX);
+                   luaL_unref(T, LUA_REGISTRYINDEX, old_ref);
                    reschedule_script(script);
+                   last_run = script;
                    break;
                 }
             default:
                 {
                     gcs().send_text(MAV_SEVERITY_CRITICAL, "Lua: %s returned bad result count (%d)", script->name, returned);
-                    remove_script(L, script);
                     // pop all the results we got that we didn't expect
-                    lua_pop(L, returned);
+                    lua_pop(T, returned);
+                    remove_script(L, script);
                     break;
                  }
          }
@@ -251,23 +332,33 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
         return;
     }
 
-    // ensure that the script isn't in the loaded list for any reason
-    if (scripts == nullptr) {
-        // nothing to do, already not in the list
-    } else if (scripts == script) {
-        scripts = script->next;
-    } else {
-        for(script_info * current = scripts; current->next != nullptr; current = current->next) {
-            if (current->next == script) {
-                current->next = script->next;
-                break;
+    {
+        WITH_SEMAPHORE(list_sem);
+        if (running == script) {
+            running = nullptr;
+        }
+        // ensure that the script isn't in the loaded list for any reason
+        if (scripts == nullptr) {
+            // nothing to do, already not in the list
+        } else if (scripts == script) {
+            scripts = script->next;
+        } else {
+            for(script_info * current = scripts; current->next != nullptr; current = current->next) {
+                if (current->next == script) {
+                    current->next = script->next;
+                    break;
+                }
             }
         }
     }
+    if (last_run == script) {
+        last_run = nullptr;
+    }
 
     if (L != nullptr) {
         // state could be null if we are force killing all scripts
         luaL_unref(L, LUA_REGISTRYINDEX, script->lua_ref);
+        luaL_unref(L, LUA_REGISTRYINDEX, script->thread_ref);
     }
     hal.util->heap_realloc(_heap, script->name, 0);
     hal.util->heap_realloc(_heap, script, 0);
@@ -281,6 +372,11 @@ void lua_scripts::reschedule_script(script_info *script) {
        return;
     }
 
+    WITH_SEMAPHORE(list_sem);
+    if (running == script) {
+        running = nullptr;
+    }
+
     script->next = nullptr;
     if (scripts == nullptr) {
         scripts = script;
@@ -308,12 +404,282 @@ void lua_scripts::reschedule_script(script_info *script) {
     previous->next = script;
 }
 
+bool lua_scripts::wake_on(wake_event event) {
+    if (running == nullptr) {
+        return false;
+    }
+    running->wake_events |= uint8_t(event);
+    events.subscribed = true;
+    return true;
+}
+
+bool lua_scripts::wake_on_mavlink(uint32_t msgid) {
+    if (running == nullptr) {
+        return false;
+    }
+    WITH_SEMAPHORE(events.sem);
+    uint8_t i;
+    for (i=0; i<events.num_msgids; i++) {
+        if (events.msgid[i] == msgid) {
+            break;
+        }
+    }
+    if (i == events.num_msgids) {
+        if (i == AP_SCRIPTING_WAKE_MSGID_MAX) {
+            return false;
+        }
+        events.msgid[i] = msgid;
+        events.num_msgids++;
+    }
+    running->wake_msgids |= 1U<<i;
+    events.subscribed = true;
+    return true;
+}
+
+void lua_scripts::handle_message_event(uint32_t msgid) {
+    // slots are only ever added, so this can be checked without the lock
+    const uint8_t n = events.num_msgids;
+    for (uint8_t i=0; i<n; i++) {
+        if (events.msgid[i] == msgid) {
+            WITH_SEMAPHORE(events.sem);
+            events.msgid_pending |= 1U<<i;
+            return;
+        }
+    }
+}
+
+void lua_scripts::check_events(void) {
+    // state is polled here rather than hooked in each library, it is
+    // cheap compared with a script polling it from Lua
+    uint8_t fired = 0;
+    const uint8_t mode = AP::vehicle()->get_mode();
+    const bool armed = AP::arming().is_armed();
+    const AP_Mission *mission = AP::mission();
+    const uint16_t mission_index = (mission != nullptr) ? mission->get_current_nav_index() : 0;
+    if (events.have_state) {
+        if (mode != events.mode) {
+            fired |= uint8_t(wake_event::MODE);
+        }
+        if (armed != events.armed) {
+            fired |= uint8_t(wake_event::ARMING);
+        }
+        if (mission_index != events.mission_index) {
+            fired |= uint8_t(wake_event::MISSION);
+        }
+    }
+    events.have_state = true;
+    events.mode = mode;
+    events.armed = armed;
+    events.mission_index = mission_index;
+
+    uint8_t msgids_fired;
+    {
+        WITH_SEMAPHORE(events.sem);
+        msgids_fired = events.msgid_pending;
+        events.msgid_pending = 0;
+    }
+    if (fired == 0 && msgids_fired == 0) {
+        return;
+    }
+
+    // take the woken scripts off the list and put them back due now
+    const uint64_t now_ms = AP_HAL::millis64();
+    script_info *woken = nullptr;
+    {
+        WITH_SEMAPHORE(list_sem);
+        script_info **link = &scripts;
+        while (*link != nullptr) {
+            script_info *script = *link;
+            if (script->next_run_ms > now_ms &&
+                ((script->wake_events & fired) || (script->wake_msgids & msgids_fired))) {
+                *link = script->next;
+                script->next = woken;
+                woken = script;
+            } else {
+                link = &script->next;
+            }
+        }
+    }
+    while (woken != nullptr) {
+        script_info *script = woken;
+        woken = script->next;
+        script->next_run_ms = now_ms;
+        reschedule_script(script);
+    }
+}
+
+void lua_scripts::wait_for_next_script(void) {
+    while (true) {
+        if (events.subscribed) {
+            check_events();
+        }
+        const uint64_t now_ms = AP_HAL::millis64();
+        if (now_ms >= scripts->next_run_ms) {
+            return;
+        }
+        uint64_t delay_ms = scripts->next_run_ms - now_ms;
+        if (events.subscribed) {
+            delay_ms = MIN(delay_ms, uint64_t(AP_SCRIPTING_EVENT_POLL_MS));
+        }
+        hal.scheduler->delay(delay_ms);
+    }
+}
+
 void *lua_scripts::_heap;
+uint32_t lua_scripts::_alloc_bytes;
+
+// file name of a script without the directory
+const char *lua_scripts::script_basename(const script_info *script) {
+    const char *name = strrchr(script->name, '/');
+    return (name == nullptr) ? script->name : name + 1;
+}
+
+void lua_scripts::update_run_stats(script_info *script, uint32_t run_time_us, uint32_t alloc_bytes) {
+    WITH_SEMAPHORE(list_sem);
+    struct script_stats &st = script->stats;
+    st.run_count++;
+    st.run_time_us += run_time_us;
+    st.run_time_last_us = run_time_us;
+    st.run_time_max_us = MAX(st.run_time_max_us, run_time_us);
+    st.alloc_bytes += alloc_bytes;
+    uint16_t &bucket = st.hist[AP::PerfInfo::hist_bucket(uint16_t(MIN(run_time_us, uint32_t(UINT16_MAX))))];
+    if (bucket < UINT16_MAX) {
+        bucket++;
+    }
+}
+
+void lua_scripts::log_script_stats(void) {
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_stats_log_ms < 1000) {
+        return;
+    }
+    last_stats_log_ms = now_ms;
+    WITH_SEMAPHORE(list_sem);
+    for (const script_info *script = scripts; script != nullptr; script = script->next) {
+        const struct script_stats &st = script->stats;
+        char lname[16] {};
+        strncpy_noterm(lname, script_basename(script), sizeof(lname));
+        // @LoggerMessage: LUAS
+        // @Description: Scripting per-script run time and memory use
+        // @Field: TimeUS: Time since system startup
+        // @Field: Name: script file name
+        // @Field: Runs: number of times the script has run
+        // @Field: Tot: total time spent running the script
+        // @Field: Max: longest run of the script
+        // @Field: P99: upper bound of the run time histogram bucket holding the 99th percentile
+        // @Field: Alloc: total bytes allocated while running the script
+        // @Field: GC: total time collecting garbage after the script
+        AP::logger().Write("LUAS", "TimeUS,Name,Runs,Tot,Max,P99,Alloc,GC",
+                           "s--sssbs",
+                           "F--FFF0F",
+                           "QNIQIIQQ",
+                           AP_HAL::micros64(),
+                           lname,
+                           st.run_count,
+                           st.run_time_us,
+                           st.run_time_max_us,
+                           AP::PerfInfo::hist_percentile_us(st.hist, 99, st.run_time_max_us),
+                           st.alloc_bytes,
+                           st.gc_time_us);
+    }
+}
+
+/*
+  one row per loaded script: run count, run time statistics in
+  microseconds, bytes allocated and GC time, followed by the run time
+  histogram in the same log2 buckets as task_hist.txt
+ */
+void lua_scripts::stats_info(ExpandingString &str) {
+    // a header to allow for machine parsers to determine format
+    str.printf("ScriptStatsV1\n");
+    str.printf("%-24.24s %7s %10s %7s %7s %7s %10s %10s", "NAME", "RUNS", "TOT_US", "AVG_US", "MAX_US", "P99_US", "ALLOC", "GC_US");
+    for (uint8_t b = 0; b < PERFINFO_TASK_HIST_BUCKETS-1; b++) {
+        str.printf(" %5u", unsigned(AP::PerfInfo::hist_bucket_max_us(b)));
+    }
+    str.printf("   inf\n");
+
+    WITH_SEMAPHORE(list_sem);
+    if (running != nullptr) {
+        script_stats_row(str, running);
+    }
+    for (const script_info *script = scripts; script != nullptr; script = script->next) {
+        script_stats_row(str, script);
+    }
+}
+
+void lua_scripts::script_stats_row(ExpandingString &str, const script_info *script) {
+    const struct script_stats &st = script->stats;
+    str.printf("%-24.24s %7u %10llu %7u %7u %7u %10llu %10llu",
+               script_basename(script),
+               unsigned(st.run_count),
+               (unsigned long long)st.run_time_us,
+               unsigned(st.run_count ? st.run_time_us / st.run_count : 0),
+               unsigned(st.run_time_max_us),
+               unsigned(AP::PerfInfo::hist_percentile_us(st.hist, 99, st.run_time_max_us)),
+               (unsigned long long)st.alloc_bytes,
+               (unsigned long long)st.gc_time_us);
+    for (uint8_t b = 0; b < PERFINFO_TASK_HIST_BUCKETS; b++) {
+        str.printf(" %5u", unsigned(st.hist[b]));
+    }
+    str.printf("\n");
+}
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+lua_mem_pool lua_scripts::_pool;
 
 void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
-    (void)ud; (void)osize;  /* not used */
+    (void)ud;  /* not used */
+    if (ptr == nullptr) {
+        // for new blocks Lua passes the object type in osize
+        osize = 0;
+    }
+    if (nsize > osize) {
+        _alloc_bytes += nsize - osize;
+    }
+    return _pool.realloc(ptr, osize, nsize);
+}
+
+void lua_scripts::log_mem_stats(void) {
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_mem_log_ms < 1000) {
+        return;
+    }
+    last_mem_log_ms = now_ms;
+    const lua_mem_pool::stats &st = _pool.get_stats();
+    // @LoggerMessage: LUAM
+    // @Description: Scripting memory use
+    // @Field: TimeUS: Time since system startup
+    // @Field: PSz: bytes of heap reserved for the small object pool
+    // @Field: PUse: bytes of pool blocks in use
+    // @Field: HUse: bytes allocated from the heap outside the pool
+    // @Field: Peak: peak of PUse + HUse
+    // @Field: Frag: percentage of the divided pool sitting in free lists
+    // @Field: Miss: small allocations that had to use the heap
+    AP::logger().Write("LUAM", "TimeUS,PSz,PUse,HUse,Peak,Frag,Miss",
+                       "sbbbb%-",
+                       "F00000-",
+                       "QIIIIBI",
+                       AP_HAL::micros64(),
+                       st.pool_size,
+                       st.pool_used,
+                       st.heap_used,
+                       st.peak_used,
+                       _pool.fragmentation_pct(),
+                       st.pool_misses);
+}
+#else
+void *lua_scripts::alloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+    (void)ud;  /* not used */
+    if (ptr == nullptr) {
+        // for new blocks Lua passes the object type in osize
+        osize = 0;
+    }
+    if (nsize > osize) {
+        _alloc_bytes += nsize - osize;
+    }
     return hal.util->heap_realloc(_heap, ptr, nsize);
 }
+#endif // AP_SCRIPTING_MEM_POOL_ENABLED
 
 void lua_scripts::repl_cleanup (void) {
     if (terminal.session) {
@@ -348,7 +714,12 @@ void lua_scripts::run(void) {
         for (script_info *script = scripts; script != nullptr; script = scripts) {
             remove_script(nullptr, script);
         }
-        scripts = nullptr;
+        {
+            WITH_SEMAPHORE(list_sem);
+            scripts = nullptr;
+            running = nullptr;
+        }
+        last_run = nullptr;
         overtime = false;
         // end any open REPL sessions
         repl_cleanup();
@@ -408,11 +779,8 @@ void lua_scripts::run(void) {
               }
 #endif // defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
 
-            // compute delay time
-            uint64_t now_ms = AP_HAL::millis64();
-            if (now_ms < scripts->next_run_ms) {
-                hal.scheduler->delay(scripts->next_run_ms - now_ms);
-            }
+            // wait for the next script to be due
+            wait_for_next_script();
 
             if (_debug_level > 1) {
                 gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Running %s", scripts->name);
@@ -433,7 +801,18 @@ void lua_scripts::run(void) {
             }
 
             // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
+            const uint32_t gc_start_us = AP_HAL::micros();
             lua_gc(L, LUA_GCCOLLECT, 0);
+            if (last_run != nullptr) {
+                // charge the collection to the script that made the garbage
+                WITH_SEMAPHORE(list_sem);
+                last_run->stats.gc_time_us += AP_HAL::micros() - gc_start_us;
+            }
+            log_script_stats();
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+            log_mem_stats();
+#endif
 
         } else {
             if (_debug_level > 0) {
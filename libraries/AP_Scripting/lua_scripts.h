@@ -15,13 +15,18 @@
 #pragma once
 
 #include <AP_Common/AP_Common.h>
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Param/AP_Param.h>
 #include <setjmp.h>
 
 #include <AP_Filesystem/posix_compat.h>
+#include <AP_Scheduler/PerfInfo.h>
 #include "lua_bindings.h"
+#include "lua_mem_pool.h"
 #include <AP_Scripting/AP_Scripting.h>
 
+class ExpandingString;
+
 #ifndef REPL_DIRECTORY
   #if HAL_OS_FATFS_IO
     #define REPL_DIRECTORY "/APM/repl"
@@ -38,6 +43,27 @@
   #endif //HAL_OS_FATFS_IO
 #endif // SCRIPTING_DIRECTORY
 
+// allow precompiled .luac scripts, see Tools/scripts/compile_lua_scripts.py
+#ifndef AP_SCRIPTING_BYTECODE_ENABLED
+  #define AP_SCRIPTING_BYTECODE_ENABLED 1
+#endif // AP_SCRIPTING_BYTECODE_ENABLED
+
+// how often events are checked for while scripts are sleeping on them
+#ifndef AP_SCRIPTING_EVENT_POLL_MS
+  #define AP_SCRIPTING_EVENT_POLL_MS 10
+#endif // AP_SCRIPTING_EVENT_POLL_MS
+
+// number of distinct MAVLink message ids scripts can wake on
+#ifndef AP_SCRIPTING_WAKE_MSGID_MAX
+  #define AP_SCRIPTING_WAKE_MSGID_MAX 8
+#endif // AP_SCRIPTING_WAKE_MSGID_MAX
+
+// how long a script suspended part way through a run waits before
+// carrying on, so the scripting thread doesn't use all the idle time
+#ifndef AP_SCRIPTING_YIELD_DELAY_MS
+  #define AP_SCRIPTING_YIELD_DELAY_MS 1
+#endif // AP_SCRIPTING_YIELD_DELAY_MS
+
 #ifndef REPL_IN
   #define REPL_IN REPL_DIRECTORY "/in"
 #endif // REPL_IN
@@ -49,7 +75,7 @@
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int16 &vm_slices, const AP_Int32 &heap_size, const AP_Int8 &debug_level, struct AP_Scripting::terminal_s &_terminal);
 
     /* Do not allow copies */
     lua_scripts(const lua_scripts &other) = delete;
@@ -62,21 +88,63 @@ public:
     void run(void);
 
     static bool overtime; // script exceeded it's execution slot, and we are bailing out
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+    static const lua_mem_pool &mem_pool(void) { return _pool; }
+#endif
+
+    // per-script run time, memory and GC statistics for @SYS/scripts.txt
+    void stats_info(ExpandingString &str);
+
+    // events a script can be woken early for
+    enum class wake_event : uint8_t {
+        MODE    = 1U<<0,
+        ARMING  = 1U<<1,
+        MISSION = 1U<<2,
+    };
+    // wake the running script when an event happens, or when a MAVLink
+    // message arrives. Returns false if there is no room for the msgid
+    bool wake_on(wake_event event);
+    bool wake_on_mavlink(uint32_t msgid);
+
+    // called from the GCS threads for each MAVLink message received
+    void handle_message_event(uint32_t msgid);
+
 private:
 
     void create_sandbox(lua_State *L);
 
     void repl_cleanup(void);
 
+    // accounting of the scripting thread time and memory used by a script
+    struct script_stats {
+        uint32_t run_count;
+        uint64_t run_time_us;     // total time spent running the script
+        uint32_t run_time_max_us;
+        uint32_t run_time_last_us;
+        uint64_t alloc_bytes;     // total bytes allocated while running the script
+        uint64_t gc_time_us;      // total time collecting garbage after the script
+        uint16_t hist[PERFINFO_TASK_HIST_BUCKETS]; // log2 histogram of run times
+    };
+
     typedef struct script_info {
        int lua_ref;          // reference to the loaded script object
+       lua_State *thread;    // thread the script runs in, so it can be suspended part way through a run
+       int thread_ref;       // reference keeping the thread from being collected
+       uint16_t slices;      // time slices used by the current run, 0 if it isn't part way through one
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       struct script_stats stats;
+       uint8_t wake_events;  // wake_event bitmask the script is waiting on
+       uint8_t wake_msgids;  // bitmask of the wake_msgid slots the script is waiting on
        script_info *next;
     } script_info;
 
     script_info *load_script(lua_State *L, char *filename);
 
+    // return the load mode for a script file name, nullptr if it isn't a script
+    static const char *script_load_mode(const char *filename);
+
     void reset_loop_overtime(lua_State *L);
 
     void load_all_scripts_in_dir(lua_State *L, const char *dirname);
@@ -103,10 +171,42 @@ private:
     int sandbox_ref;
 
     script_info *scripts; // linked list of scripts to be run, sorted by next run time (soonest first)
+    script_info *running; // script taken off the list to run, nullptr once it has been rescheduled or removed
+    script_info *last_run; // script that ran last if it is still loaded, to charge the following GC to
+
+    // protects the script list and statistics from @SYS readers
+    HAL_Semaphore list_sem;
+
+    // event wakeups. The MAVLink message ids are shared between
+    // scripts, each has a slot with a pending bit set by the GCS threads
+    struct {
+        bool subscribed;            // true once any script has called wake_on
+        bool have_state;
+        uint8_t mode;
+        bool armed;
+        uint16_t mission_index;
+        uint32_t msgid[AP_SCRIPTING_WAKE_MSGID_MAX];
+        uint8_t num_msgids;
+        uint8_t msgid_pending;
+        HAL_Semaphore sem;
+    } events;
+
+    // bring forward any script waiting on an event that has happened
+    void check_events(void);
+    // sleep until the first script in the list is due, waking early for events
+    void wait_for_next_script(void);
+
+    void update_run_stats(script_info *script, uint32_t run_time_us, uint32_t alloc_bytes);
+    uint32_t last_stats_log_ms;
+    void log_script_stats(void);
+    static const char *script_basename(const script_info *script);
+    void script_stats_row(ExpandingString &str, const script_info *script);
 
     // hook will be run when CPU time for a script is exceeded
     // it must be static to be passed to the C API
     static void hook(lua_State *L, lua_Debug *ar);
+    // true while the running script may be suspended when it runs out of time
+    static bool yield_allowed;
 
     // lua panic handler, will jump back to the start of run
     static int atpanic(lua_State *L);
@@ -115,9 +215,19 @@ private:
     lua_State *lua_state;
 
     const AP_Int32 & _vm_steps;
+    const AP_Int16 & _vm_slices;
     const AP_Int8 & _debug_level;
 
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
     static void *_heap;
+
+    // total bytes handed out by alloc, wrapping
+    static uint32_t _alloc_bytes;
+
+#if AP_SCRIPTING_MEM_POOL_ENABLED
+    static lua_mem_pool _pool;
+    uint32_t last_mem_log_ms;
+    void log_mem_stats(void);
+#endif
 };
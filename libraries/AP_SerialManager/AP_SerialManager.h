@@ -186,6 +186,9 @@ public:
     // should_forward_mavlink_telemetry - returns true if this port should forward telemetry
     bool should_forward_mavlink_telemetry(enum SerialProtocol protocol, uint8_t instance) const;
 
+    // mavlink_rx_thread - returns true if MAVLink from this port should be parsed in its own thread
+    bool mavlink_rx_thread(enum SerialProtocol protocol, uint8_t instance) const;
+
     // get_mavlink_protocol - provides the specific MAVLink protocol for a
     // given channel, or SerialProtocol_None if not found
     SerialProtocol get_mavlink_protocol(mavlink_channel_t mav_chan) const;
@@ -30,8 +30,8 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
-    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 2.5k of memory. Boards with less memory are limited to 500 points.
+    // @Range: 0 5000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -67,10 +67,16 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
 *    for a more complete description.
 *
+*    To avoid comparing every segment with every other, the segments are
+*    first added to a grid of SMARTRTL_PRUNING_CELL_SIZE cells hashed by
+*    their north-east position, and each segment is only compared with the
+*    segments in the cells around it.
+*
 *    The simplification and pruning algorithms run in the background and do not
 *    alter the path in memory.  Two definitions, SMARTRTL_SIMPLIFY_TIME_US and
 *    SMARTRTL_PRUNING_LOOP_TIME_US are used to limit how long each algorithm will
-*    be run before they save their state and return.
+*    be run before they save their state and return.  They run in their own low
+*    priority thread, or the IO thread if that can't be created.
 *
 *    Both algorithms are "anytime algorithms" meaning they can be interrupted
 *    before they complete which is helpful when memory is filling up and we just
@@ -107,7 +113,7 @@ void AP_SmartRTL::init()
     }
 
     // allocate arrays
-    _path = (Vector3f*)calloc(_points_max, sizeof(Vector3f));
+    _path = (packed_point_t*)calloc(_points_max, sizeof(packed_point_t));
 
     _prune.loops_max = _points_max * SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT;
     _prune.loops = (prune_loop_t*)calloc(_prune.loops_max, sizeof(prune_loop_t));
@@ -115,13 +121,28 @@ void AP_SmartRTL::init()
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
+    // one grid bucket for every two points, rounded up to a power of two
+    uint32_t grid_buckets = 16;
+    while (grid_buckets < uint32_t(_points_max) / 2) {
+        grid_buckets *= 2;
+    }
+    _prune.grid_buckets_mask = grid_buckets - 1;
+    _prune.grid_buckets = (uint16_t*)calloc(grid_buckets, sizeof(uint16_t));
+
+    _prune.grid_entries_max = MIN(uint32_t(_points_max) * SMARTRTL_PRUNING_ENTRIES_MULT, uint32_t(UINT16_MAX-1));
+    _prune.grid_entries = (grid_entry_t*)calloc(_prune.grid_entries_max, sizeof(grid_entry_t));
+
     // check if memory allocation failed
-    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
+    if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr ||
+        _prune.grid_buckets == nullptr || _prune.grid_entries == nullptr) {
         log_action(SRTL_DEACTIVATED_INIT_FAILED);
         gcs().send_text(MAV_SEVERITY_WARNING, "SmartRTL deactivated: init failed");
         free(_path);
         free(_prune.loops);
         free(_simplify.stack);
+        free(_prune.grid_buckets);
+        free(_prune.grid_entries);
+        _path = nullptr;
         return;
     }
 
@@ -129,8 +150,22 @@ void AP_SmartRTL::init()
 
     // when running the example sketch, we want the cleanup tasks to run when we tell them to, not in the background (so that they can be timed.)
     if (!_example_mode){
-        // register background cleanup to run in IO thread
-        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_SmartRTL::run_background_cleanup, void));
+        // run background cleanup in a low priority thread so it can use
+        // spare CPU time, falling back to the IO thread
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_SmartRTL::cleanup_thread, void),
+                                          "SmartRTL",
+                                          2048, AP_HAL::Scheduler::PRIORITY_IO, -1)) {
+            hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_SmartRTL::run_background_cleanup, void));
+        }
+    }
+}
+
+// background cleanup thread
+void AP_SmartRTL::cleanup_thread()
+{
+    while (true) {
+        hal.scheduler->delay(1);
+        run_background_cleanup();
     }
 }
 
@@ -161,7 +196,7 @@ bool AP_SmartRTL::pop_point(Vector3f& point)
     }
 
     // return last point and remove from path
-    point = _path[--_path_points_count];
+    point = get_point(--_path_points_count);
 
     // record count of last point popped
     _path_points_completed_limit = _path_points_count;
@@ -191,7 +226,7 @@ bool AP_SmartRTL::peek_point(Vector3f& point)
     }
 
     // return last point
-    point = _path[_path_points_count-1];
+    point = get_point(_path_points_count-1);
 
     _path_sem.give();
     return true;
@@ -326,7 +361,7 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
 
     // check if we have traveled far enough
     if (_path_points_count > 0) {
-        const Vector3f& last_pos = _path[_path_points_count-1];
+        const Vector3f last_pos = get_point(_path_points_count-1);
         if (last_pos.distance_squared(point) < sq(_accuracy.get())) {
             _path_sem.give();
             return true;
@@ -341,13 +376,35 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
     }
 
     // add point to path
-    _path[_path_points_count++] = point;
+    if (!set_point(_path_points_count, point)) {
+        _path_sem.give();
+        deactivate(SRTL_DEACTIVATED_OUT_OF_RANGE, "too far from origin");
+        return false;
+    }
+    _path_points_count++;
     log_action(SRTL_POINT_ADD, point);
 
     _path_sem.give();
     return true;
 }
 
+// store a point in the path, returns false if it is too far from the EKF origin to be stored
+bool AP_SmartRTL::set_point(uint16_t index, const Vector3f& point)
+{
+    const float xy_max = float(1UL<<23) - 1;
+    const float z_max = float(1UL<<15) - 1;
+    const float x = roundf(point.x * SMARTRTL_POINT_XY_SCALE);
+    const float y = roundf(point.y * SMARTRTL_POINT_XY_SCALE);
+    const float z = roundf(point.z * SMARTRTL_POINT_Z_SCALE);
+    if (!(fabsf(x) <= xy_max && fabsf(y) <= xy_max && fabsf(z) <= z_max)) {
+        return false;
+    }
+    _path[index].x = int32_t(x);
+    _path[index].y = int32_t(y);
+    _path[index].z = int32_t(z);
+    return true;
+}
+
 // run background cleanup - should be run regularly from the IO thread
 void AP_SmartRTL::run_background_cleanup()
 {
@@ -526,7 +583,7 @@ void AP_SmartRTL::detect_simplifications()
         for (uint16_t i = start_index + 1; i < end_index; i++) {
             // only check points that have not already been flagged for simplification
             if (_simplify.bitmask.get(i)) {
-                const float dist = _path[i].distance_to_segment(_path[start_index], _path[end_index]);
+                const float dist = get_point(i).distance_to_segment(get_point(start_index), get_point(end_index));
                 if (dist > max_dist) {
                     farthest_point_index = i;
                     max_dist = dist;
@@ -559,7 +616,7 @@ void AP_SmartRTL::detect_simplifications()
 /**
 *   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
-*   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
+*   to the line segments between other sequential points nearby in the grid. If they get close enough, anything between them could be pruned.
 *
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
@@ -574,36 +631,146 @@ void AP_SmartRTL::detect_loops()
     // capture start time
     const uint32_t start_time_us = AP_HAL::micros();
 
+    // add the segments that can be compared against to the grid. The
+    // newest segment compares against those ending up to point count-3
+    while (_prune.grid_added + 2 < _prune.path_points_count) {
+        if (AP_HAL::micros() - start_time_us >= SMARTRTL_PRUNING_LOOP_TIME_US) {
+            return;
+        }
+        if (!prune_grid_add(_prune.grid_added)) {
+            // out of grid space, check the remaining segments one by one
+            _prune.grid_linear_from = _prune.grid_added;
+            _prune.grid_added = _prune.path_points_count;
+            break;
+        }
+        _prune.grid_added++;
+    }
+
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+        // find the earliest segment that comes close to the segment ending at point i
+        uint16_t j;
+        dist_point dp;
+        if (prune_grid_find(_prune.i, j, dp)) {
+            // if there is a loop here, add to loop array
+            if (!add_loop(j, _prune.i-1, dp.midpoint)) {
+                // if the buffer is full, stop trying to prune
                 _prune.complete = true;
-                _prune.path_points_completed = _prune.path_points_count;
                 return;
             }
         }
 
-        // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
-        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
+        // move to the previous segment
+        _prune.i--;
+        // complete when outer loop has run out of new points to check
+        if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+    }
+}
+
+// grid cell range covered by the segment ending at path point seg with a margin in meters
+void AP_SmartRTL::prune_grid_cells(uint16_t seg, float margin, int32_t &x_min, int32_t &y_min, int32_t &x_max, int32_t &y_max) const
+{
+    const Vector3f p1 = get_point(seg-1);
+    const Vector3f p2 = get_point(seg);
+    const float scale = 1.0f / _prune.grid_cell_size;
+    x_min = floorf((MIN(p1.x, p2.x) - margin) * scale);
+    y_min = floorf((MIN(p1.y, p2.y) - margin) * scale);
+    x_max = floorf((MAX(p1.x, p2.x) + margin) * scale);
+    y_max = floorf((MAX(p1.y, p2.y) + margin) * scale);
+}
+
+// grid bucket of a cell
+uint16_t AP_SmartRTL::prune_grid_bucket(int32_t x, int32_t y) const
+{
+    return ((uint32_t(x) * 73856093U) ^ (uint32_t(y) * 19349663U)) & _prune.grid_buckets_mask;
+}
+
+// add the segment ending at path point seg to the loop detection grid
+// returns false if the grid is out of space
+bool AP_SmartRTL::prune_grid_add(uint16_t seg)
+{
+    int32_t x_min, y_min, x_max, y_max;
+    prune_grid_cells(seg, 0, x_min, y_min, x_max, y_max);
+    const uint32_t num_cells = uint32_t(x_max - x_min + 1) * uint32_t(y_max - y_min + 1);
+
+    if (num_cells > SMARTRTL_PRUNING_CELLS_MAX) {
+        // long segments go on their own list, compared against every segment
+        if (_prune.grid_entries_count >= _prune.grid_entries_max) {
+            return false;
+        }
+        _prune.grid_entries[_prune.grid_entries_count] = grid_entry_t {seg, _prune.grid_large};
+        _prune.grid_large = _prune.grid_entries_count++;
+        return true;
+    }
+
+    if (_prune.grid_entries_count + num_cells > _prune.grid_entries_max) {
+        return false;
+    }
+    for (int32_t x = x_min; x <= x_max; x++) {
+        for (int32_t y = y_min; y <= y_max; y++) {
+            uint16_t &bucket = _prune.grid_buckets[prune_grid_bucket(x, y)];
+            _prune.grid_entries[_prune.grid_entries_count] = grid_entry_t {seg, bucket};
+            bucket = _prune.grid_entries_count++;
+        }
+    }
+    return true;
+}
+
+// find the earliest segment before the segment ending at path point seg that comes within
+// SMARTRTL_PRUNING_DELTA of it.  Consecutive segments touch so the segment before seg is not checked
+bool AP_SmartRTL::prune_grid_find(uint16_t seg, uint16_t &found, dist_point &dp) const
+{
+    const Vector3f p1 = get_point(seg);
+    const Vector3f p2 = get_point(seg-1);
+    const uint16_t last = seg - 2;
+    uint16_t best = last + 1;
+
+    // check one segment, keeping it if it is earlier than the best so far
+    auto check = [&](uint16_t j) {
+        if (j < 1 || j > last || j >= best) {
+            return;
+        }
+        const dist_point d = segment_segment_dist(p1, p2, get_point(j-1), get_point(j));
+        if (d.distance < SMARTRTL_PRUNING_DELTA) {
+            best = j;
+            dp = d;
+        }
+    };
+
+    int32_t x_min, y_min, x_max, y_max;
+    prune_grid_cells(seg, SMARTRTL_PRUNING_DELTA, x_min, y_min, x_max, y_max);
+    const uint32_t num_cells = uint32_t(x_max - x_min + 1) * uint32_t(y_max - y_min + 1);
+    if (num_cells > _prune.grid_buckets_mask + 1U) {
+        // a segment this long covers the whole grid, check everything
+        for (uint16_t j = 1; j <= last; j++) {
+            check(j);
+        }
+    } else {
+        for (int32_t x = x_min; x <= x_max; x++) {
+            for (int32_t y = y_min; y <= y_max; y++) {
+                for (uint16_t e = _prune.grid_buckets[prune_grid_bucket(x, y)]; e != UINT16_MAX; e = _prune.grid_entries[e].next) {
+                    check(_prune.grid_entries[e].seg);
+                }
             }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
         }
+        for (uint16_t e = _prune.grid_large; e != UINT16_MAX; e = _prune.grid_entries[e].next) {
+            check(_prune.grid_entries[e].seg);
+        }
+        for (uint16_t j = _prune.grid_linear_from; j <= last; j++) {
+            check(j);
+        }
+    }
+
+    if (best > last) {
+        return false;
     }
+    found = best;
+    return true;
 }
 
 // restart simplify if new points have been added to path
@@ -647,8 +814,17 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
 {
     _prune.complete = false;
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
     _prune.path_points_count = path_points_count;
+
+    // the path may have changed, so rebuild the grid
+    if (_prune.grid_buckets != nullptr) {
+        memset(_prune.grid_buckets, 0xFF, (_prune.grid_buckets_mask + 1U) * sizeof(uint16_t));
+    }
+    _prune.grid_entries_count = 0;
+    _prune.grid_large = UINT16_MAX;
+    _prune.grid_added = 1;
+    _prune.grid_linear_from = UINT16_MAX;
+    _prune.grid_cell_size = MAX(SMARTRTL_PRUNING_CELL_SIZE, 1.0f);
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
@@ -670,7 +846,7 @@ void AP_SmartRTL::remove_points_by_simplify_bitmask()
     uint16_t removed = 0;
     for (uint16_t src = 1; src < _path_points_count; src++) {
         if (!_simplify.bitmask.get(src)) {
-            log_action(SRTL_POINT_SIMPLIFY, _path[src]);
+            log_action(SRTL_POINT_SIMPLIFY, get_point(src));
             removed++;
         } else {
             _path[dest] = _path[src];
@@ -716,13 +892,14 @@ bool AP_SmartRTL::remove_points_by_loops(uint16_t num_points_to_remove)
         i--;
         prune_loop_t loop = _prune.loops[i];
 
-        // midpoint goes into start_index (this is the end point of the first segment)
-        _path[loop.start_index] = loop.midpoint;
+        // midpoint goes into start_index (this is the end point of the first segment). It is between two
+        // points already on the path so is always in range
+        set_point(loop.start_index, loop.midpoint);
 
         // shift points after the end of the loop down by the number of points in the loop
         uint16_t loop_num_points_to_remove = loop.end_index - loop.start_index;
         for (uint16_t dest = loop.start_index + 1; dest < _path_points_count - loop_num_points_to_remove; dest++) {
-            log_action(SRTL_POINT_PRUNE, _path[dest]);
+            log_action(SRTL_POINT_PRUNE, get_point(dest));
             _path[dest] = _path[dest + loop_num_points_to_remove];
         }
 
@@ -773,9 +950,9 @@ bool AP_SmartRTL::add_loop(uint16_t start_index, uint16_t end_index, const Vecto
 
     // create new loop structure and calculate length squared of loop
     prune_loop_t new_loop = {start_index, end_index, midpoint, 0.0f};
-    new_loop.length_squared = midpoint.distance_squared(_path[start_index]) + midpoint.distance_squared(_path[end_index]);
+    new_loop.length_squared = midpoint.distance_squared(get_point(start_index)) + midpoint.distance_squared(get_point(end_index));
     for (uint16_t i = start_index; i < end_index; i++) {
-        new_loop.length_squared += _path[i].distance_squared(_path[i+1]);
+        new_loop.length_squared += get_point(i).distance_squared(get_point(i+1));
     }
 
     // look for overlapping loops and find their combined length
@@ -6,8 +6,14 @@
 
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
-#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
-#define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 25bytes * this number.
+#ifndef SMARTRTL_POINTS_MAX
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define SMARTRTL_POINTS_MAX              5000   // the absolute maximum number of points this library can support.
+#else
+#define SMARTRTL_POINTS_MAX              500
+#endif
+#endif
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -20,9 +26,22 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_CELL_SIZE (_accuracy * 4.0f)   // size in meters of the grid cells segments are hashed into for loop detection
+#define SMARTRTL_PRUNING_CELLS_MAX       4      // segments covering more grid cells than this are kept on a separate list
+#define SMARTRTL_PRUNING_ENTRIES_MULT    2      // number of grid cell entries as compared to maximum number of points
+#define SMARTRTL_POINT_XY_SCALE          64.0f  // stored north and east positions are in 1/64 m, giving +-131km from the EKF origin
+#define SMARTRTL_POINT_Z_SCALE           16.0f  // stored down positions are in 1/16 m, giving +-2km from the EKF origin
 
 class AP_SmartRTL {
 
+    // points are stored packed into 8 bytes, see SMARTRTL_POINT_XY_SCALE
+    // and SMARTRTL_POINT_Z_SCALE
+    struct packed_point_t {
+        int64_t x : 24;
+        int64_t y : 24;
+        int64_t z : 16;
+    };
+
 public:
 
     // constructor, destructor
@@ -38,7 +57,10 @@ public:
     uint16_t get_num_points() const;
 
     // get a point on the path
-    const Vector3f& get_point(uint16_t index) const { return _path[index]; }
+    Vector3f get_point(uint16_t index) const {
+        const packed_point_t &p = _path[index];
+        return Vector3f(p.x * (1.0f/SMARTRTL_POINT_XY_SCALE), p.y * (1.0f/SMARTRTL_POINT_XY_SCALE), p.z * (1.0f/SMARTRTL_POINT_Z_SCALE));
+    }
 
     // get next point on the path to home, returns true on success
     bool pop_point(Vector3f& point);
@@ -100,6 +122,7 @@ private:
         SRTL_DEACTIVATED_BAD_POSITION_TIMEOUT,
         SRTL_DEACTIVATED_PATH_FULL_TIMEOUT,
         SRTL_DEACTIVATED_PROGRAM_ERROR,
+        SRTL_DEACTIVATED_OUT_OF_RANGE,
     };
 
     // enum for SRTL_OPTIONS parameter
@@ -111,6 +134,14 @@ private:
     // add point to end of path
     bool add_point(const Vector3f& point);
 
+    // store a point in the path, returns false if it is too far from
+    // the EKF origin to be stored
+    bool set_point(uint16_t index, const Vector3f& point);
+
+    // background cleanup thread, used instead of the IO thread when it
+    // can be created
+    void cleanup_thread();
+
     // routine cleanup attempts to remove 10 points (see SMARTRTL_CLEANUP_POINT_MIN definition) by simplification or loop pruning
     void routine_cleanup(uint16_t path_points_count, uint16_t path_points_complete_limit);
 
@@ -169,6 +200,23 @@ private:
     // get the closest distance between 2 line segments and the point midway between the closest points
     static dist_point segment_segment_dist(const Vector3f& p1, const Vector3f& p2, const Vector3f& p3, const Vector3f& p4);
 
+    // add the segment ending at path point seg to the loop detection grid
+    // returns false if the grid is out of space
+    bool prune_grid_add(uint16_t seg);
+
+    // find the earliest segment before the segment ending at path point
+    // seg that comes within SMARTRTL_PRUNING_DELTA of it. Returns true and
+    // fills in the index of the segment's end point and the midpoint
+    // between the closest points on success
+    bool prune_grid_find(uint16_t seg, uint16_t &found, dist_point &dp) const;
+
+    // grid cell range covered by the segment ending at path point seg
+    // with a margin in meters
+    void prune_grid_cells(uint16_t seg, float margin, int32_t &x_min, int32_t &y_min, int32_t &x_max, int32_t &y_max) const;
+
+    // grid bucket of a cell
+    uint16_t prune_grid_bucket(int32_t x, int32_t y) const;
+
     // de-activate SmartRTL, send warning to GCS and logger
     void deactivate(SRTL_Actions action, const char *reason);
 
@@ -192,7 +240,7 @@ private:
     ThoroughCleanupType _thorough_clean_type;   // used by example sketch to test simplify and prune separately
 
     // path variables
-    Vector3f* _path;    // points are stored in meters from EKF origin in NED
+    packed_point_t* _path;  // points are stored from EKF origin in NED
     uint16_t _path_points_max;  // after the array has been allocated, we will need to know how big it is. We can't use the parameter, because a user could change the parameter in-flight
     uint16_t _path_points_count;// number of points in the path array
     uint16_t _path_points_completed_limit;  // set by main thread to the path_point_count when a point is popped.  used by simplify and prune algorithms to detect path shrinking
@@ -222,15 +270,30 @@ private:
         Vector3f midpoint;      // midpoint which should replace the first point when the loop is removed
         float length_squared;   // length squared (in meters) of the loop (used so we can remove the longest loops)
     } prune_loop_t;
+    typedef struct {
+        uint16_t seg;   // end point of the segment
+        uint16_t next;  // next entry in the same grid bucket, UINT16_MAX at the end
+    } grid_entry_t;
     struct {
         bool complete;
         uint16_t path_points_count;  // copy of _path_points_count taken when the prune algorithm started
         uint16_t path_points_completed; // number of points in that path that have already been checked for loops and should be ignored
-        uint16_t i;     // loop search's outer loop index
-        uint16_t j;     // loop search's inner loop index
+        uint16_t i;     // end point of the next segment to search for loops
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+
+        // grid of the path's segments, hashed by the north-east cells they
+        // cover, so the loop search only compares nearby segments
+        uint16_t* grid_buckets;     // first entry of each bucket
+        uint16_t grid_buckets_mask; // number of buckets minus one, a power of two
+        grid_entry_t* grid_entries;
+        uint16_t grid_entries_max;
+        uint16_t grid_entries_count;
+        uint16_t grid_large;        // first entry of segments covering too many cells
+        uint16_t grid_added;        // end point of the next segment to add to the grid
+        uint16_t grid_linear_from;  // segments from here on did not fit in the grid, they are checked one by one
+        float grid_cell_size;
     } _prune;
 
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
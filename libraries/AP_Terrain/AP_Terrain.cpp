@@ -15,6 +15,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/MemoryArena.h>
 #include <AP_Math/AP_Math.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <GCS_MAVLink/GCS.h>
@@ -53,7 +54,15 @@ const AP_Param::GroupInfo AP_Terrain::var_info[] = {
     // @Bitmask: 0:Disable Download
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",   2, AP_Terrain, options, 0),
-    
+
+    // @Param: CACHE_SZ
+    // @DisplayName: Terrain cache size
+    // @Description: The number of terrain grid blocks to keep in memory. Each block uses about 2 kilobytes. When more than the default 12 blocks are kept, blocks ahead of the vehicle along its velocity vector and the current mission leg are read from the SD card before they are needed. If the requested size cannot be allocated a smaller cache is used.
+    // @Range: 12 200
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("CACHE_SZ",  3, AP_Terrain, config_cache_size, TERRAIN_GRID_BLOCK_CACHE_SIZE),
+
     AP_GROUPEND
 };
 
@@ -106,8 +115,39 @@ bool AP_Terrain::height_amsl(const Location &loc, float &height, bool corrected)
     calculate_grid_info(loc, info);
 
     // find the grid
-    const struct grid_block &grid = find_grid_cache(info).grid;
+    const struct grid_cache &gcache = find_grid_cache(info);
+    const struct grid_block &grid = gcache.grid;
+    if (gcache.state == GRID_CACHE_DISKWAIT) {
+        cache_misses++;
+    } else {
+        cache_hits++;
+    }
+
+    if (!interpolate_height(grid, info, height)) {
+        return false;
+    }
+
+    if (loc.lat == ahrs.get_home().lat &&
+        loc.lng == ahrs.get_home().lng) {
+        // remember home altitude as a special case
+        home_height = height;
+        home_loc = loc;
+    }
+
+    // apply correction which assumes home altitude is at terrain altitude
+    if (corrected) {
+        height += (ahrs.get_home().alt * 0.01f) - home_height;
+    }
+
+    return true;
+}
 
+
+/*
+  interpolate the height at a grid_info position within a grid block
+ */
+bool AP_Terrain::interpolate_height(const struct grid_block &grid, const struct grid_info &info, float &height)
+{
     /*
       note that we rely on the one square overlap to ensure these
       calculations don't go past the end of the arrays
@@ -140,23 +180,78 @@ bool AP_Terrain::height_amsl(const Location &loc, float &height, bool corrected)
     float avg  = (1.0f-info.frac_y) * avg1 + info.frac_y * avg2;
 
     height = avg;
+    return true;
+}
 
-    if (loc.lat == ahrs.get_home().lat &&
-        loc.lng == ahrs.get_home().lng) {
-        // remember home altitude as a special case
-        home_height = height;
-        home_loc = loc;
+/*
+  return terrain heights for a set of locations. The locations are
+  handled in chunks; within a chunk the grid block of each location is
+  worked out once, and each grid block is looked up in the cache once
+  for all the locations that fall in it
+ */
+uint16_t AP_Terrain::height_amsl_batch(const Location *locs, float *heights, bool *valid, uint16_t count, bool corrected)
+{
+    if (!allocate()) {
+        for (uint16_t i=0; i<count; i++) {
+            valid[i] = false;
+        }
+        return 0;
     }
 
-    // apply correction which assumes home altitude is at terrain altitude
-    if (corrected) {
-        height += (ahrs.get_home().alt * 0.01f) - home_height;
-    }
+    const AP_AHRS &ahrs = AP::ahrs();
+    const Location &ahrs_home = ahrs.get_home();
+    const uint8_t chunk_size = 16;
+    struct grid_info info[chunk_size];
+    uint16_t found = 0;
+
+    for (uint16_t base=0; base<count; base += chunk_size) {
+        const uint8_t n = MIN(count - base, chunk_size);
+        uint16_t pending = 0;
+        for (uint8_t i=0; i<n; i++) {
+            const Location &loc = locs[base+i];
+            valid[base+i] = false;
+            if ((loc.lat == home_loc.lat && loc.lng == home_loc.lng) ||
+                (loc.lat == ahrs_home.lat && loc.lng == ahrs_home.lng)) {
+                // home is special cased by height_amsl()
+                valid[base+i] = height_amsl(loc, heights[base+i], corrected);
+                found += valid[base+i];
+                continue;
+            }
+            calculate_grid_info(loc, info[i]);
+            pending |= 1U<<i;
+        }
 
-    return true;
+        while (pending != 0) {
+            const uint8_t first = __builtin_ctz(pending);
+            const struct grid_cache &gcache = find_grid_cache(info[first]);
+            for (uint8_t i=first; i<n; i++) {
+                if (!(pending & (1U<<i)) ||
+                    info[i].grid_lat != info[first].grid_lat ||
+                    info[i].grid_lon != info[first].grid_lon) {
+                    continue;
+                }
+                pending &= ~(1U<<i);
+                if (gcache.state == GRID_CACHE_DISKWAIT) {
+                    cache_misses++;
+                    continue;
+                }
+                cache_hits++;
+                float &height = heights[base+i];
+                if (!interpolate_height(gcache.grid, info[i], height)) {
+                    continue;
+                }
+                // apply correction which assumes home altitude is at terrain altitude
+                if (corrected) {
+                    height += (ahrs_home.alt * 0.01f) - home_height;
+                }
+                valid[base+i] = true;
+                found++;
+            }
+        }
+    }
+    return found;
 }
 
-
 /* 
    find difference between home terrain height and the terrain
    height at the current location in meters. A positive result
@@ -322,6 +417,9 @@ void AP_Terrain::update(void)
         have_current_loc_height = true;
     }
 
+    // queue reads of the blocks we will need soon
+    prefetch_ahead();
+
     // check for pending mission data
     update_mission_data();
 
@@ -373,7 +471,9 @@ void AP_Terrain::log_terrain_data()
         terrain_height : terrain_height,
         current_height : current_height,
         pending        : pending,
-        loaded         : loaded
+        loaded         : loaded,
+        cache_hits     : cache_hits,
+        cache_misses   : cache_misses,
     };
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
@@ -390,13 +490,25 @@ bool AP_Terrain::allocate(void)
     if (cache != nullptr) {
         return true;
     }
-    cache = (struct grid_cache *)calloc(TERRAIN_GRID_BLOCK_CACHE_SIZE, sizeof(cache[0]));
+    // try for the configured cache size, falling back to smaller
+    // caches if memory is short
+    uint16_t size = constrain_int16(config_cache_size, TERRAIN_GRID_BLOCK_CACHE_SIZE, TERRAIN_GRID_BLOCK_CACHE_SIZE_MAX);
+    while (true) {
+        cache = (struct grid_cache *)MemoryArena::allocate(size * sizeof(cache[0]), MemoryTag::TERRAIN);
+        if (cache != nullptr || size <= TERRAIN_GRID_BLOCK_CACHE_SIZE) {
+            break;
+        }
+        size = MAX(size / 2, TERRAIN_GRID_BLOCK_CACHE_SIZE);
+    }
     if (cache == nullptr) {
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Terrain: Allocation failed");
         memory_alloc_failed = true;
         return false;
     }
-    cache_size = TERRAIN_GRID_BLOCK_CACHE_SIZE;
+    if (size != config_cache_size) {
+        gcs().send_text(MAV_SEVERITY_INFO, "Terrain: cache size %u blocks", (unsigned)size);
+    }
+    cache_size = size;
     return true;
 }
 
@@ -32,6 +32,13 @@
 
 #define TERRAIN_DEBUG 0
 
+#ifndef AP_TERRAIN_MMAP_ENABLED
+#define AP_TERRAIN_MMAP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+// number of degree files kept memory mapped at once
+#define TERRAIN_MMAP_MAX_FILES 4
+
 
 // MAVLink sends 4x4 grids
 #define TERRAIN_GRID_MAVLINK_SIZE 4
@@ -51,9 +58,18 @@
 #define TERRAIN_GRID_BLOCK_SIZE_X (TERRAIN_GRID_MAVLINK_SIZE*TERRAIN_GRID_BLOCK_MUL_X)
 #define TERRAIN_GRID_BLOCK_SIZE_Y (TERRAIN_GRID_MAVLINK_SIZE*TERRAIN_GRID_BLOCK_MUL_Y)
 
-// number of grid_blocks in the LRU memory cache
+// default number of grid_blocks in the LRU memory cache
 #define TERRAIN_GRID_BLOCK_CACHE_SIZE 12
 
+// maximum number of grid_blocks in the LRU memory cache
+#define TERRAIN_GRID_BLOCK_CACHE_SIZE_MAX 200
+
+// how far ahead of the vehicle, in seconds of travel, blocks are prefetched
+#define TERRAIN_PREFETCH_TIME_S 60
+
+// maximum number of blocks queued ahead of the vehicle per prefetch pass
+#define TERRAIN_PREFETCH_MAX_BLOCKS 8
+
 // format of grid on disk
 #define TERRAIN_GRID_FORMAT_VERSION 1
 
@@ -126,6 +142,17 @@ public:
      */
     bool height_amsl(const Location &loc, float &height, bool corrected);
 
+    /*
+      return terrain heights in meters above sea level for a set of
+      locations, with the same meaning as height_amsl(). Locations in
+      the same grid block share one cache lookup, so this is cheaper
+      than repeated height_amsl() calls for points along a path.
+
+      valid[i] is set to say if heights[i] is available. Returns the
+      number of heights available
+     */
+    uint16_t height_amsl_batch(const Location *locs, float *heights, bool *valid, uint16_t count, bool corrected);
+
     /* 
        find difference between home terrain height and the terrain
        height at the current location in meters. A positive result
@@ -306,6 +333,12 @@ private:
     */
     bool check_bitmap(const struct grid_block &grid, uint8_t idx_x, uint8_t idx_y);
 
+    /*
+      interpolate the height at a grid_info position within a grid
+      block. Returns false if the surrounding heights are not available
+    */
+    bool interpolate_height(const struct grid_block &grid, const struct grid_info &info, float &height);
+
     /*
       request any missing 4x4 grids from a block
     */
@@ -317,6 +350,12 @@ private:
      */
     void schedule_disk_io(void);
 
+    /*
+      queue disk reads for blocks ahead of the vehicle
+     */
+    void prefetch_ahead(void);
+    void prefetch_path(const Location &start, const Vector2f &ne_offset, uint8_t &budget);
+
     /*
       get some statistics for TERRAIN_REPORT
      */
@@ -335,6 +374,7 @@ private:
     uint32_t east_blocks(struct grid_block &block) const;
     void write_block(void);
     void read_block(void);
+    bool block_valid(struct grid_block &block, int32_t lat, int32_t lon);
 
     /*
       check for missing mission terrain data
@@ -351,6 +391,7 @@ private:
     AP_Int8  enable;
     AP_Int16 grid_spacing; // meters between grid points
     AP_Int16 options; // option bits
+    AP_Int16 config_cache_size; // number of grid blocks to keep in memory
 
     enum class Options {
         DisableDownload = (1U<<0),
@@ -364,6 +405,13 @@ private:
     uint8_t cache_size = 0;
     struct grid_cache *cache = nullptr;
 
+    // cache statistics for height lookups, for logging
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+
+    // last time we queued blocks ahead of the vehicle
+    uint32_t last_prefetch_ms;
+
     // a grid_cache block waiting for disk IO
     enum DiskIoState {
         DiskIoIdle      = 0,
@@ -430,6 +478,25 @@ private:
 
     char *file_path = nullptr;
 
+#if AP_TERRAIN_MMAP_ENABLED
+    /*
+      read-only mappings of degree files. Blocks are copied straight
+      from the page cache on the main thread, without waiting for the
+      IO thread
+     */
+    struct mapped_file {
+        int fd;
+        uint8_t *base;
+        size_t length;
+        uint32_t last_access_ms;
+        int8_t lat_degrees;
+        int16_t lon_degrees;
+    } mapped_files[TERRAIN_MMAP_MAX_FILES];
+
+    struct mapped_file *map_file(int8_t lat_degrees, int16_t lon_degrees);
+    bool mmap_read_block(struct grid_block &block);
+#endif
+
     // status
     enum TerrainStatus system_status = TerrainStatusDisabled;
 
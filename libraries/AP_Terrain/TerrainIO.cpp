@@ -28,6 +28,13 @@
 
 #include <AP_Filesystem/AP_Filesystem.h>
 
+#if AP_TERRAIN_MMAP_ENABLED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 extern const AP_HAL::HAL& hal;
 
 /*
@@ -35,13 +42,19 @@ extern const AP_HAL::HAL& hal;
  */
 void AP_Terrain::check_disk_read(void)
 {
+    // read the most recently accessed block first, so blocks in use
+    // are read ahead of prefetched blocks
+    int16_t read_idx = -1;
     for (uint16_t i=0; i<cache_size; i++) {
-        if (cache[i].state == GRID_CACHE_DISKWAIT) {
-            disk_block.block = cache[i].grid;
-            disk_io_state = DiskIoWaitRead;
-            return;
+        if (cache[i].state == GRID_CACHE_DISKWAIT &&
+            (read_idx == -1 || cache[i].last_access_ms > cache[read_idx].last_access_ms)) {
+            read_idx = i;
         }
-    }    
+    }
+    if (read_idx != -1) {
+        disk_block.block = cache[read_idx].grid;
+        disk_io_state = DiskIoWaitRead;
+    }
 }
 
 /*
@@ -286,6 +299,19 @@ void AP_Terrain::write_block(void)
     disk_io_state = DiskIoDoneWrite;
 }
 
+/*
+  check a block read from disk is the one we wanted and is intact
+ */
+bool AP_Terrain::block_valid(struct grid_block &block, int32_t lat, int32_t lon)
+{
+    return TERRAIN_LATLON_EQUAL(block.lat,lat) &&
+        TERRAIN_LATLON_EQUAL(block.lon,lon) &&
+        block.bitmap != 0 &&
+        block.spacing == grid_spacing &&
+        block.version == TERRAIN_GRID_FORMAT_VERSION &&
+        block.crc == get_block_crc(block);
+}
+
 /*
   read in disk_block
  */
@@ -300,12 +326,7 @@ void AP_Terrain::read_block(void)
 
     ssize_t ret = AP::FS().read(fd, &disk_block, sizeof(disk_block));
     if (ret != sizeof(disk_block) || 
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lat,lat) ||
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lon,lon) ||
-        disk_block.block.bitmap == 0 ||
-        disk_block.block.spacing != grid_spacing ||
-        disk_block.block.version != TERRAIN_GRID_FORMAT_VERSION ||
-        disk_block.block.crc != get_block_crc(disk_block.block)) {
+        !block_valid(disk_block.block, lat, lon)) {
 #if TERRAIN_DEBUG
         printf("read empty block at %ld %ld ret=%d (%ld %ld %u 0x%08lx) 0x%04x:0x%04x\n",
                (long)lat,
@@ -378,4 +399,123 @@ void AP_Terrain::io_timer(void)
     }
 }
 
+#if AP_TERRAIN_MMAP_ENABLED
+/*
+  get a read-only mapping of a degree file, replacing the least
+  recently used mapping if needed. This runs on the main thread, so it
+  builds its own path rather than sharing file_path with the IO thread
+ */
+AP_Terrain::mapped_file *AP_Terrain::map_file(int8_t lat_degrees, int16_t lon_degrees)
+{
+    uint8_t oldest_i = 0;
+    for (uint8_t i=0; i<TERRAIN_MMAP_MAX_FILES; i++) {
+        mapped_file &m = mapped_files[i];
+        if (m.base != nullptr &&
+            m.lat_degrees == lat_degrees &&
+            m.lon_degrees == lon_degrees) {
+            m.last_access_ms = AP_HAL::millis();
+            return &m;
+        }
+        if (m.base == nullptr ||
+            (mapped_files[oldest_i].base != nullptr &&
+             m.last_access_ms < mapped_files[oldest_i].last_access_ms)) {
+            oldest_i = i;
+        }
+    }
+
+    const char* terrain_dir = hal.util->get_custom_terrain_directory();
+    if (terrain_dir == nullptr) {
+        terrain_dir = HAL_BOARD_TERRAIN_DIRECTORY;
+    }
+    char path[256];
+    const int n = hal.util->snprintf(path, sizeof(path), "%s/%c%02u%c%03u.DAT",
+                                     terrain_dir,
+                                     lat_degrees<0?'S':'N',
+                                     (unsigned)MIN(abs((int32_t)lat_degrees), 99),
+                                     lon_degrees<0?'W':'E',
+                                     (unsigned)MIN(abs((int32_t)lon_degrees), 999));
+    if (n <= 0 || n >= (int)sizeof(path)) {
+        return nullptr;
+    }
+
+    // the IO thread creates the file, so don't create it here
+    const int mfd = ::open(path, O_RDONLY|O_CLOEXEC);
+    if (mfd == -1) {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(mfd, &st) != 0 || st.st_size <= 0) {
+        ::close(mfd);
+        return nullptr;
+    }
+    void *base = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, mfd, 0);
+    if (base == MAP_FAILED) {
+        ::close(mfd);
+        return nullptr;
+    }
+
+    mapped_file &m = mapped_files[oldest_i];
+    if (m.base != nullptr) {
+        ::munmap(m.base, m.length);
+        ::close(m.fd);
+    }
+    m.fd = mfd;
+    m.base = (uint8_t *)base;
+    m.length = st.st_size;
+    m.lat_degrees = lat_degrees;
+    m.lon_degrees = lon_degrees;
+    m.last_access_ms = AP_HAL::millis();
+    return &m;
+}
+
+/*
+  fill in a block directly from a mapped degree file. Returns false if
+  the file can't be mapped, in which case the IO thread reads the
+  block as usual. A block past the end of the file, or one which fails
+  validation, is returned empty just as read_block() would
+ */
+bool AP_Terrain::mmap_read_block(struct grid_block &block)
+{
+    if (io_failure) {
+        return false;
+    }
+    mapped_file *m = map_file(block.lat_degrees, block.lon_degrees);
+    if (m == nullptr) {
+        return false;
+    }
+    const uint32_t blocknum = east_blocks(block) * block.grid_idx_x + block.grid_idx_y;
+    const size_t file_offset = blocknum * sizeof(union grid_io_block);
+    if (file_offset + sizeof(union grid_io_block) > m->length) {
+        // the IO thread may have grown the file since we mapped it
+        struct stat st;
+        if (::fstat(m->fd, &st) != 0) {
+            return false;
+        }
+        if ((size_t)st.st_size > m->length) {
+            void *base = ::mremap(m->base, m->length, st.st_size, MREMAP_MAYMOVE);
+            if (base == MAP_FAILED) {
+                ::munmap(m->base, m->length);
+                ::close(m->fd);
+                m->base = nullptr;
+                return false;
+            }
+            m->base = (uint8_t *)base;
+            m->length = st.st_size;
+        }
+        if (file_offset + sizeof(union grid_io_block) > m->length) {
+            // not on disk yet
+            return true;
+        }
+    }
+
+    // copy out before validating, as the CRC check works in place
+    struct grid_block mblock;
+    memcpy(&mblock, &m->base[file_offset], sizeof(mblock));
+    if (block_valid(mblock, block.lat, block.lon)) {
+        block = mblock;
+    }
+    return true;
+}
+#endif // AP_TERRAIN_MMAP_ENABLED
+
 #endif // AP_TERRAIN_AVAILABLE
@@ -24,6 +24,7 @@
 #include <GCS_MAVLink/GCS.h>
 #include "AP_Terrain.h"
 #include <AP_GPS/AP_GPS.h>
+#include <AP_AHRS/AP_AHRS.h>
 
 #if AP_TERRAIN_AVAILABLE
 
@@ -82,28 +83,108 @@ void AP_Terrain::update_mission_data(void)
         // we will fetch 5 points around the waypoint. Four at 10 grid
         // spacings away at 45, 135, 225 and 315 degrees, and the
         // point itself
-        if (next_mission_pos != 4) {
-            cmd.content.location.offset_bearing(45+90*next_mission_pos, grid_spacing.get() * 10);
+        Location locs[5];
+        uint8_t n = 0;
+        for (uint8_t pos=next_mission_pos; pos<5; pos++) {
+            locs[n] = cmd.content.location;
+            if (pos != 4) {
+                locs[n].offset_bearing(45+90*pos, grid_spacing.get() * 10);
+            }
+            n++;
         }
 
         // we have a mission command to check
-        float height;
-        if (!height_amsl(cmd.content.location, height, false)) {
-            // if we can't get data for a mission item then return and
-            // check again next time
-            return;
+        float heights[5];
+        bool valid[5];
+        height_amsl_batch(locs, heights, valid, n, false);
+        for (uint8_t j=0; j<n; j++) {
+            if (!valid[j]) {
+                // if we can't get data for a mission item then return and
+                // check again next time
+                return;
+            }
+            next_mission_pos++;
         }
 
-        next_mission_pos++;
-        if (next_mission_pos == 5) {
 #if TERRAIN_DEBUG
-            hal.console->printf("checked waypoint %u\n", (unsigned)next_mission_index);
+        hal.console->printf("checked waypoint %u\n", (unsigned)next_mission_index);
 #endif
 
-            // move to next waypoint
-            next_mission_index++;
-            next_mission_pos = 0;
+        // move to next waypoint
+        next_mission_index++;
+        next_mission_pos = 0;
+    }
+}
+
+/*
+  queue disk reads for grid blocks the vehicle will need soon, so they
+  are in memory before the vehicle reaches them. Blocks are taken along
+  the current velocity vector and along the current mission leg. This
+  is only done when the cache is larger than the default, so that the
+  prefetched blocks don't push out the blocks in use
+ */
+void AP_Terrain::prefetch_ahead(void)
+{
+    if (cache_size <= TERRAIN_GRID_BLOCK_CACHE_SIZE || grid_spacing <= 0) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_prefetch_ms < 1000) {
+        return;
+    }
+    last_prefetch_ms = now_ms;
+
+    const AP_AHRS &ahrs = AP::ahrs();
+    Location loc;
+    if (!ahrs.get_position(loc)) {
+        return;
+    }
+
+    uint8_t budget = MIN(cache_size - TERRAIN_GRID_BLOCK_CACHE_SIZE, TERRAIN_PREFETCH_MAX_BLOCKS);
+
+    // along the mission leg first, as that is where we are going
+    if (mission.state() == AP_Mission::MISSION_RUNNING) {
+        const Location &target = mission.get_current_nav_cmd().content.location;
+        if (target.lat != 0 || target.lng != 0) {
+            prefetch_path(loc, loc.get_distance_NE(target), budget);
+        }
+    }
+
+    // then along the velocity vector
+    Vector3f vel;
+    if (ahrs.get_velocity_NED(vel)) {
+        prefetch_path(loc, Vector2f(vel.x, vel.y) * TERRAIN_PREFETCH_TIME_S, budget);
+    }
+
+    schedule_disk_io();
+}
+
+/*
+  queue disk reads for the blocks along a path from start
+ */
+void AP_Terrain::prefetch_path(const Location &start, const Vector2f &ne_offset, uint8_t &budget)
+{
+    // step at half a block so that no block along the path is skipped
+    const float step = 0.5f * grid_spacing * MIN(TERRAIN_GRID_BLOCK_SPACING_X, TERRAIN_GRID_BLOCK_SPACING_Y);
+    const float length = ne_offset.length();
+    if (length < step) {
+        return;
+    }
+    const Vector2f dir = ne_offset / length;
+    int32_t last_lat = 0, last_lon = 0;
+    for (float d = step; d <= length && budget > 0; d += step) {
+        Location loc = start;
+        loc.offset(dir.x * d, dir.y * d);
+        struct grid_info info;
+        calculate_grid_info(loc, info);
+        if (info.grid_lat == last_lat && info.grid_lon == last_lon) {
+            continue;
         }
+        last_lat = info.grid_lat;
+        last_lon = info.grid_lon;
+        // this marks missing blocks as waiting for a disk read
+        find_grid_cache(info);
+        budget--;
     }
 }
 
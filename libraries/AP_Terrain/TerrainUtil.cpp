@@ -142,6 +142,13 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
     // mark as waiting for disk read
     grid.state = GRID_CACHE_DISKWAIT;
 
+#if AP_TERRAIN_MMAP_ENABLED
+    if (mmap_read_block(grid.grid)) {
+        // served from the page cache, no need for the IO thread
+        grid.state = GRID_CACHE_VALID;
+    }
+#endif
+
     return grid;
 }
 
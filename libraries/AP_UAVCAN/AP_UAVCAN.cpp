@@ -106,6 +106,8 @@ const AP_Param::GroupInfo AP_UAVCAN::var_info[] = {
 // set this to 1 to minimise resend of stale msgs
 #define CAN_PERIODIC_TX_TIMEOUT_MS 2
 
+HAL_Semaphore AP_UAVCAN::RaiiSynchronizer::sem;
+
 // publisher interfaces
 static uavcan::Publisher<uavcan::equipment::actuator::ArrayCommand>* act_out_array[HAL_MAX_CAN_PROTOCOL_DRIVERS];
 static uavcan::Publisher<uavcan::equipment::esc::RawCommand>* esc_raw[HAL_MAX_CAN_PROTOCOL_DRIVERS];
@@ -354,7 +356,13 @@ void AP_UAVCAN::loop(void)
             continue;
         }
 
-        const int error = _node->spin(uavcan::MonotonicDuration::fromMSec(1));
+        // wait for received frames without holding the node, so other
+        // threads can send in the meantime
+        _iface_mgr->wait_for_event(1000);
+
+        WITH_SEMAPHORE(_node_sem);
+
+        const int error = _node->spinOnce();
 
         if (error < 0) {
             hal.scheduler->delay_microseconds(100);
@@ -449,6 +457,17 @@ void AP_UAVCAN::SRV_send_actuator(void)
     } while (repeat_send);
 }
 
+/*
+  send one RawCommand for all enabled ESCs. Each command is 14 bits, so
+  up to 4 ESCs fit in a single frame and an octocopter takes 3 frames
+  (14 bytes of payload plus the transfer CRC). The message is trimmed
+  to the highest enabled ESC to keep it as short as possible.
+
+  This is sent as classic CAN even on FDCAN peripherals: AP_HAL::CANFrame
+  carries at most 8 data bytes and the UAVCAN v0 transport has no FD
+  framing, so packing all ESCs into one 64 byte frame needs both of
+  those first.
+ */
 void AP_UAVCAN::SRV_send_esc(void)
 {
     static const int cmd_max = uavcan::equipment::esc::RawCommand::FieldTypes::cmd::RawValueType::max();
@@ -489,23 +508,37 @@ void AP_UAVCAN::SRV_send_esc(void)
         }
 
         esc_raw[_driver_index]->broadcast(esc_msg);
+
+        for (uint8_t i = 0; i < UAVCAN_SRV_NUMBER; i++) {
+            _SRV_conf[i].esc_pending = false;
+        }
     }
 }
 
 void AP_UAVCAN::SRV_push_servos()
 {
-    WITH_SEMAPHORE(SRV_sem);
-
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        // Check if this channels has any function assigned
-        if (SRV_Channels::channel_function(i)) {
-            _SRV_conf[i].pulse = SRV_Channels::srv_channel(i)->get_output_pwm();
-            _SRV_conf[i].esc_pending = true;
-            _SRV_conf[i].servo_pending = true;
+    {
+        WITH_SEMAPHORE(SRV_sem);
+
+        for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
+            // Check if this channels has any function assigned
+            if (SRV_Channels::channel_function(i)) {
+                _SRV_conf[i].pulse = SRV_Channels::srv_channel(i)->get_output_pwm();
+                _SRV_conf[i].esc_pending = true;
+                _SRV_conf[i].servo_pending = true;
+            }
         }
+
+        _SRV_armed = hal.util->safety_switch_state() != AP_HAL::Util::SAFETY_DISARMED;
     }
 
-    _SRV_armed = hal.util->safety_switch_state() != AP_HAL::Util::SAFETY_DISARMED;
+    // send ESC commands from the output thread rather than waiting for
+    // the driver thread to wake up. If the driver thread has the node
+    // they stay pending and it sends them when it is done
+    if (_initialized && _SRV_armed && _esc_bm > 0 && _node_sem.take_nonblocking()) {
+        SRV_send_esc();
+        _node_sem.give();
+    }
 }
 
 
@@ -141,9 +141,15 @@ public:
     };
 
 private:
-    // This will be needed to implement if UAVCAN is used with multithreading
-    // Such cases will be firmware update, etc.
-    class RaiiSynchronizer {};
+    // the node may be used from threads other than the driver thread,
+    // such as for ESC output, so its allocator needs a lock
+    class RaiiSynchronizer {
+    public:
+        RaiiSynchronizer() { sem.take_blocking(); }
+        ~RaiiSynchronizer() { sem.give(); }
+    private:
+        static HAL_Semaphore sem;
+    };
 
     void loop(void);
 
@@ -173,6 +179,10 @@ private:
 
     uavcan::Node<0> *_node;
 
+    // held for any use of _node once the driver thread is running. Take
+    // it before SRV_sem, never while holding SRV_sem
+    HAL_Semaphore _node_sem;
+
     uint8_t _driver_index;
 
     uavcan::CanIfaceMgr* _iface_mgr;
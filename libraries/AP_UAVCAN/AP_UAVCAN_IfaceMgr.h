@@ -67,6 +67,9 @@ public:
     int16_t select(CanSelectMasks& inout_masks,
                    const CanFrame* (& pending_tx)[MaxCanIfaces],
                    const MonotonicTime blocking_deadline) override;
+
+    // block until any interface has an event or timeout_us passes
+    void wait_for_event(uint64_t timeout_us) { _event_handle.wait(timeout_us); }
 };
 
 }
@@ -76,6 +76,9 @@ extern AP_Vehicle& vehicle;
  */
 void AP_Vehicle::setup()
 {
+    // time from power on to here, mostly taken by the HAL starting
+    boot_step("HAL");
+
     // load the default values of variables listed in var_info[]
     AP_Param::setup_sketch_defaults();
 
@@ -88,6 +91,7 @@ void AP_Vehicle::setup()
                         (unsigned)hal.util->available_memory());
 
     load_parameters();
+    boot_step("params");
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
     if (AP_BoardConfig::get_sdcard_slowdown() != 0) {
@@ -136,9 +140,11 @@ void AP_Vehicle::setup()
     // call externalAHRS init before init_ardupilot to allow for external sensors
     externalAHRS.init();
 #endif
+    boot_step("serial");
 
     // init_ardupilot is where the vehicle does most of its initialisation.
     init_ardupilot();
+    boot_step("vehicle");
     gcs().send_text(MAV_SEVERITY_INFO, "ArduPilot Ready");
 
 #if !APM_BUILD_TYPE(APM_BUILD_Replay)
@@ -175,7 +181,9 @@ void AP_Vehicle::setup()
 #if GENERATOR_ENABLED
     generator.init();
 #endif
+    boot_step("late");
 
+    print_boot_steps();
 }
 
 void AP_Vehicle::loop()
@@ -332,6 +340,39 @@ void AP_Vehicle::write_notch_log_messages() const
             notches[0], notches[1], notches[2], notches[3]);
 }
 
+void AP_Vehicle::boot_step(const char *name)
+{
+    const uint32_t now_us = AP_HAL::micros();
+    if (num_boot_steps < ARRAY_SIZE(boot_steps)) {
+        boot_steps[num_boot_steps].name = name;
+        boot_steps[num_boot_steps].time_us = now_us - last_boot_step_us;
+        num_boot_steps++;
+    }
+    last_boot_step_us = now_us;
+}
+
+void AP_Vehicle::print_boot_steps() const
+{
+    hal.console->printf("Boot took %ums\n", (unsigned)(last_boot_step_us / 1000));
+    for (uint8_t i = 0; i < num_boot_steps; i++) {
+        hal.console->printf("  %-16s %6ums\n", boot_steps[i].name, (unsigned)(boot_steps[i].time_us / 1000));
+    }
+}
+
+// @LoggerMessage: BOOT
+// @Description: Time taken by each step of the boot
+// @Field: TimeUS: microseconds since system startup
+// @Field: Step: name of the step
+// @Field: Time: time taken by the step
+void AP_Vehicle::write_boot_log_messages() const
+{
+    const uint64_t now = AP_HAL::micros64();
+    for (uint8_t i = 0; i < num_boot_steps; i++) {
+        AP::logger().Write("BOOT", "TimeUS,Step,Time", "s-s", "F-F", "QNI",
+                           now, boot_steps[i].name, boot_steps[i].time_us);
+    }
+}
+
 // run notch update at either loop rate or 200Hz
 void AP_Vehicle::update_dynamic_notch_at_specified_rate()
 {
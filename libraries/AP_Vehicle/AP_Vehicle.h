@@ -47,6 +47,10 @@
 #include <AP_ExternalAHRS/AP_ExternalAHRS.h>
 #include <AP_VideoTX/AP_SmartAudio.h>
 
+#ifndef AP_VEHICLE_MAX_BOOT_STEPS
+#define AP_VEHICLE_MAX_BOOT_STEPS 24
+#endif
+
 class AP_Vehicle : public AP_HAL::HAL::Callbacks {
 
 public:
@@ -212,6 +216,13 @@ public:
 
     // write out harmonic notch log messages
     void write_notch_log_messages() const;
+
+    // record the time taken since the previous step of the boot
+    // against name, which must be a string constant
+    void boot_step(const char *name);
+
+    // write out the time taken by each step of the boot
+    void write_boot_log_messages() const;
     // update the harmonic notch
     virtual void update_dynamic_notch() {};
 
@@ -355,6 +366,17 @@ private:
     static AP_Vehicle *_singleton;
 
     bool done_safety_init;
+
+    // time taken by each step of the boot
+    struct {
+        const char *name;
+        uint32_t time_us;
+    } boot_steps[AP_VEHICLE_MAX_BOOT_STEPS];
+    uint8_t num_boot_steps;
+    uint32_t last_boot_step_us;
+
+    // print the time taken by each step of the boot to the console
+    void print_boot_steps() const;
 };
 
 namespace AP {
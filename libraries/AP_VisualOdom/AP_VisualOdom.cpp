@@ -76,7 +76,7 @@ const AP_Param::GroupInfo AP_VisualOdom::var_info[] = {
 
     // @Param: _DELAY_MS
     // @DisplayName: Visual odometry sensor delay
-    // @Description: Visual odometry sensor delay relative to inertial measurements
+    // @Description: Visual odometry sensor delay relative to inertial measurements. Once the companion computer has answered enough TIMESYNC requests its timestamps are converted using its measured clock offset, and this only needs to cover the time between the camera image and its timestamp
     // @Units: ms
     // @Range: 0 250
     // @User: Advanced
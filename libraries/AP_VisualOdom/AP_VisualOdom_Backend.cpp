@@ -17,9 +17,14 @@
 
 #if HAL_VISUALODOM_ENABLED
 
+#include <AP_AHRS/AP_AHRS.h>
 #include <AP_Logger/AP_Logger.h>
 #include <GCS_MAVLink/GCS.h>
 
+// shortest interval between samples sent to the EKF. This matches the
+// EKF's own limit, so faster input is averaged instead of dropped
+#define VISUALODOM_EKF_INTERVAL_MS 20
+
 extern const AP_HAL::HAL &hal;
 
 /*
@@ -84,4 +89,84 @@ uint32_t AP_VisualOdom_Backend::get_reset_timestamp_ms(uint8_t reset_counter)
     return _reset_timestamp_ms;
 }
 
+/*
+  sensors such as the T265 send 200Hz data, much faster than the EKF
+  fuses it. Rather than the EKF dropping most samples, average them so
+  the EKF gets one sample per fusion interval, timestamped at the mean
+  time of the samples in it. Averaging n samples reduces the noise
+  given to the EKF by sqrt(n), but never below the noise parameters as
+  the samples are far from independent
+ */
+void AP_VisualOdom_Backend::write_ext_nav_data(const Vector3f &pos, const Quaternion &att, float posErr, float angErr, uint32_t time_ms, uint8_t reset_counter)
+{
+    // samples either side of a reset can't be averaged
+    if (_pos_sum.count > 0 && reset_counter != _pos_sum.reset_counter) {
+        _pos_sum.count = 0;
+    }
+
+    if (_pos_sum.count == 0) {
+        _pos_sum.pos.zero();
+        memset(_pos_sum.att, 0, sizeof(_pos_sum.att));
+        _pos_sum.pos_err = 0;
+        _pos_sum.ang_err = 0;
+        _pos_sum.first_ms = time_ms;
+        _pos_sum.dt_ms = 0;
+        _pos_sum.reset_counter = reset_counter;
+    }
+
+    // sum quaternions in the same hemisphere as the first so q and -q
+    // don't cancel
+    const float sign = (_pos_sum.count > 0 &&
+                        _pos_sum.att[0]*att.q1 + _pos_sum.att[1]*att.q2 + _pos_sum.att[2]*att.q3 + _pos_sum.att[3]*att.q4 < 0) ? -1 : 1;
+    _pos_sum.pos += pos;
+    _pos_sum.att[0] += sign * att.q1;
+    _pos_sum.att[1] += sign * att.q2;
+    _pos_sum.att[2] += sign * att.q3;
+    _pos_sum.att[3] += sign * att.q4;
+    _pos_sum.pos_err += posErr;
+    _pos_sum.ang_err += angErr;
+    _pos_sum.dt_ms += MAX(int32_t(time_ms - _pos_sum.first_ms), 0);
+    _pos_sum.count++;
+
+    const uint32_t mean_ms = _pos_sum.first_ms + _pos_sum.dt_ms / _pos_sum.count;
+    if (mean_ms - _pos_sum.last_sent_ms < VISUALODOM_EKF_INTERVAL_MS && _pos_sum.count < UINT8_MAX) {
+        return;
+    }
+
+    const float n = _pos_sum.count;
+    const float noise_scale = 1.0f / sqrtf(n);
+    Quaternion att_mean(_pos_sum.att[0], _pos_sum.att[1], _pos_sum.att[2], _pos_sum.att[3]);
+    att_mean.normalize();
+    AP::ahrs().writeExtNavData(_pos_sum.pos / n,
+                               att_mean,
+                               MAX(_pos_sum.pos_err / n * noise_scale, _frontend.get_pos_noise()),
+                               MAX(_pos_sum.ang_err / n * noise_scale, _frontend.get_yaw_noise()),
+                               mean_ms,
+                               _frontend.get_delay_ms(),
+                               get_reset_timestamp_ms(reset_counter));
+    _pos_sum.last_sent_ms = mean_ms;
+    _pos_sum.count = 0;
+}
+
+void AP_VisualOdom_Backend::write_ext_nav_vel_data(const Vector3f &vel, uint32_t time_ms)
+{
+    if (_vel_sum.count == 0) {
+        _vel_sum.vel.zero();
+        _vel_sum.first_ms = time_ms;
+        _vel_sum.dt_ms = 0;
+    }
+    _vel_sum.vel += vel;
+    _vel_sum.dt_ms += MAX(int32_t(time_ms - _vel_sum.first_ms), 0);
+    _vel_sum.count++;
+
+    const uint32_t mean_ms = _vel_sum.first_ms + _vel_sum.dt_ms / _vel_sum.count;
+    if (mean_ms - _vel_sum.last_sent_ms < VISUALODOM_EKF_INTERVAL_MS && _vel_sum.count < UINT8_MAX) {
+        return;
+    }
+
+    AP::ahrs().writeExtNavVelData(_vel_sum.vel / _vel_sum.count, _frontend.get_vel_noise(), mean_ms, _frontend.get_delay_ms());
+    _vel_sum.last_sent_ms = mean_ms;
+    _vel_sum.count = 0;
+}
+
 #endif
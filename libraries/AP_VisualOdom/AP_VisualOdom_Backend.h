@@ -51,6 +51,14 @@ protected:
     // updates the reset timestamp to the current system time if the reset_counter has changed
     uint32_t get_reset_timestamp_ms(uint8_t reset_counter);
 
+    // average position and attitude samples down to the rate the EKF
+    // accepts them and send them on. Errors are for a single sample
+    void write_ext_nav_data(const Vector3f &pos, const Quaternion &att, float posErr, float angErr, uint32_t time_ms, uint8_t reset_counter);
+
+    // average velocity samples down to the rate the EKF accepts them
+    // and send them on
+    void write_ext_nav_vel_data(const Vector3f &vel, uint32_t time_ms);
+
     // Logging Functions
     void Write_VisualOdom(float time_delta, const Vector3f &angle_delta, const Vector3f &position_delta, float confidence);
     void Write_VisualPosition(uint64_t remote_time_us, uint32_t time_ms, float x, float y, float z, float roll, float pitch, float yaw, float pos_err, float ang_err, uint8_t reset_counter, bool ignored);
@@ -62,6 +70,29 @@ protected:
     // reset counter handling
     uint8_t _last_reset_counter;    // last sensor reset counter received
     uint32_t _reset_timestamp_ms;   // time reset counter was received
+
+private:
+
+    // sum of the samples not yet sent to the EKF
+    struct {
+        Vector3f pos;
+        float att[4];
+        float pos_err;
+        float ang_err;
+        uint32_t first_ms;      // time of the first sample
+        uint32_t dt_ms;         // sum of sample times after first_ms
+        uint32_t last_sent_ms;  // timestamp sent to the EKF last time
+        uint8_t count;
+        uint8_t reset_counter;
+    } _pos_sum;
+
+    struct {
+        Vector3f vel;
+        uint32_t first_ms;
+        uint32_t dt_ms;
+        uint32_t last_sent_ms;
+        uint8_t count;
+    } _vel_sum;
 };
 
 #endif
@@ -55,7 +55,7 @@ void AP_VisualOdom_IntelT265::handle_vision_position_estimate(uint64_t remote_ti
     bool consume = should_consume_sensor_data(true, reset_counter);
     if (consume) {
         // send attitude and position to EKF
-        AP::ahrs().writeExtNavData(pos, att, posErr, angErr, time_ms, _frontend.get_delay_ms(), get_reset_timestamp_ms(reset_counter));
+        write_ext_nav_data(pos, att, posErr, angErr, time_ms, reset_counter);
     }
 
     // calculate euler orientation for logging
@@ -85,7 +85,7 @@ void AP_VisualOdom_IntelT265::handle_vision_speed_estimate(uint64_t remote_time_
     bool consume = should_consume_sensor_data(false, reset_counter);
     if (consume) {
         // send velocity to EKF
-        AP::ahrs().writeExtNavVelData(vel_corrected, _frontend.get_vel_noise(), time_ms, _frontend.get_delay_ms());
+        write_ext_nav_vel_data(vel_corrected, time_ms);
     }
 
     // record time for health monitoring
@@ -149,7 +149,12 @@ void AR_WPNav::update(float dt)
         _oa_destination = _destination;
     }
 
-    update_distance_and_bearing_to_destination();
+    // leg values only change when the origin or destination does
+    if (!_leg.origin.same_latlon_as(_oa_origin) || !_leg.destination.same_latlon_as(_oa_destination)) {
+        update_leg();
+    }
+
+    update_distance_and_bearing_to_destination(current_loc);
 
     // if object avoidance is active check if vehicle should pivot towards destination
     if (_oa_active) {
@@ -205,6 +210,7 @@ bool AR_WPNav::set_desired_location(const struct Location& destination, float ne
     _oa_destination = _destination = destination;
     _orig_and_dest_valid = true;
     _reached_destination = false;
+    update_leg();
     update_distance_and_bearing_to_destination();
 
     // determine if we should pivot immediately
@@ -213,8 +219,7 @@ bool AR_WPNav::set_desired_location(const struct Location& destination, float ne
     // set final desired speed and whether vehicle should pivot
     _desired_speed_final = 0.0f;
     if (!is_equal(next_leg_bearing_cd, AR_WPNAV_HEADING_UNKNOWN)) {
-        const float curr_leg_bearing_cd = _origin.get_bearing_to(_destination);
-        const float turn_angle_cd = wrap_180_cd(next_leg_bearing_cd - curr_leg_bearing_cd);
+        const float turn_angle_cd = wrap_180_cd(next_leg_bearing_cd - _leg.bearing_cd);
         if (fabsf(turn_angle_cd) < 10.0f) {
             // if turning less than 0.1 degrees vehicle can continue at full speed
             // we use 0.1 degrees instead of zero to avoid divide by zero in calcs below
@@ -358,6 +363,12 @@ void AR_WPNav::update_distance_and_bearing_to_destination()
         _oa_wp_bearing_cd = 0.0f;
         return;
     }
+    update_distance_and_bearing_to_destination(current_loc);
+}
+
+// update distance from the given vehicle position to destination
+void AR_WPNav::update_distance_and_bearing_to_destination(const Location &current_loc)
+{
     _distance_to_destination = current_loc.get_distance(_destination);
     _wp_bearing_cd = current_loc.get_bearing_to(_destination);
 
@@ -424,7 +435,7 @@ void AR_WPNav::update_desired_speed(float dt)
     const float turn_angle_rad = fabsf(radians(wp_yaw_diff_cd * 0.01f));
 
     // calculate distance from vehicle to line + wp_overshoot
-    const float line_yaw_diff = wrap_180_cd(_oa_origin.get_bearing_to(_oa_destination) - heading_cd);
+    const float line_yaw_diff = wrap_180_cd(_leg.bearing_cd - heading_cd);
     const float dist_from_line = fabsf(_cross_track_error);
     const bool heading_away = is_positive(line_yaw_diff) == is_positive(_cross_track_error);
     const float wp_overshoot_adj = heading_away ? -dist_from_line : dist_from_line;
@@ -477,20 +488,29 @@ float AR_WPNav::calc_crosstrack_error(const Location& current_loc) const
         return 0.0f;
     }
 
-    // calculate the NE position of destination relative to origin
-    Vector2f dest_from_origin = _oa_origin.get_distance_NE(_oa_destination);
-
     // return distance to origin if length of track is very small
-    if (dest_from_origin.length() < 1.0e-6f) {
+    if (!_leg.direction_valid) {
         return current_loc.get_distance_NE(_oa_destination).length();
     }
 
-    // convert to a vector indicating direction only
-    dest_from_origin.normalize();
-
     // calculate the NE position of the vehicle relative to origin
     const Vector2f veh_from_origin = _oa_origin.get_distance_NE(current_loc);
 
     // calculate distance to target track, for reporting
-    return veh_from_origin % dest_from_origin;
+    return veh_from_origin % _leg.direction;
+}
+
+// update the values that are constant along the leg from the (OA adjusted) origin to destination
+void AR_WPNav::update_leg()
+{
+    _leg.origin = _oa_origin;
+    _leg.destination = _oa_destination;
+    _leg.bearing_cd = _oa_origin.get_bearing_to(_oa_destination);
+
+    // direction of the track for crosstrack error calculations
+    _leg.direction = _oa_origin.get_distance_NE(_oa_destination);
+    _leg.direction_valid = _leg.direction.length() >= 1.0e-6f;
+    if (_leg.direction_valid) {
+        _leg.direction.normalize();
+    }
 }
@@ -91,6 +91,7 @@ private:
 
     // update distance and bearing from vehicle's current position to destination
     void update_distance_and_bearing_to_destination();
+    void update_distance_and_bearing_to_destination(const Location &current_loc);
 
     // calculate steering output to drive along line from origin to destination waypoint
     // relies on update_distance_and_bearing_to_destination being called first
@@ -116,6 +117,9 @@ private:
     // calculate the crosstrack error (does not rely on L1 controller)
     float calc_crosstrack_error(const Location& current_loc) const;
 
+    // update the cached leg values, called whenever _oa_origin or _oa_destination change
+    void update_leg();
+
     // parameters
     AP_Float _speed_max;            // target speed between waypoints in m/s
     AP_Float _speed_min;            // target speed minimum in m/s.  Vehicle will not slow below this speed for corners
@@ -162,4 +166,13 @@ private:
     Location _oa_destination;       // intermediate destination during avoidance
     float _oa_distance_to_destination; // OA (object avoidance) distance from vehicle to _oa_destination in meters
     float _oa_wp_bearing_cd;        // OA adjusted heading to _oa_destination in centi-degrees
+
+    // values that are constant along the leg from _oa_origin to _oa_destination
+    struct {
+        Location origin;            // _oa_origin these values were calculated for
+        Location destination;       // _oa_destination these values were calculated for
+        float bearing_cd;           // bearing from origin to destination in centi-degrees
+        Vector2f direction;         // unit vector from origin to destination
+        bool direction_valid;       // false if the leg is too short to have a direction
+    } _leg;
 };
@@ -18,6 +18,7 @@
 /// @brief	A class to provide the average of a number of samples
 #pragma once
 
+#include <type_traits>
 #include "FilterClass.h"
 #include "FilterWithBuffer.h"
 
@@ -29,7 +30,7 @@ class AverageFilter : public FilterWithBuffer<T,FILTER_SIZE>
 {
 public:
     // constructor
-    AverageFilter() : FilterWithBuffer<T,FILTER_SIZE>(), _num_samples(0) {
+    AverageFilter() : FilterWithBuffer<T,FILTER_SIZE>(), _num_samples(0), _sum(0) {
     };
 
     // apply - Add a new raw value to the filter, retrieve the filtered result
@@ -41,6 +42,9 @@ public:
 protected:
     // the number of samples in the filter, maxes out at size of the filter
     uint8_t        _num_samples;
+
+    // the current sum of samples
+    U              _sum;
 };
 
 // Typedef for convenience (1st argument is the data type, 2nd is a larger datatype to handle overflows, 3rd is buffer size)
@@ -78,21 +82,28 @@ typedef AverageFilter<float,float,5> AverageFilterFloat_Size5;
 template <class T, class U, uint8_t FILTER_SIZE>
 T AverageFilter<T,U,FILTER_SIZE>::        apply(T sample)
 {
-    U        result = 0;
+    // keep a running sum, replacing the oldest sample with the new one.
+    // There is a risk of overflow here that we ignore
+    _sum -= FilterWithBuffer<T,FILTER_SIZE>::samples[FilterWithBuffer<T,FILTER_SIZE>::sample_index];
+    _sum += sample;
 
     // call parent's apply function to get the sample into the array
     FilterWithBuffer<T,FILTER_SIZE>::apply(sample);
 
+    // a floating point sum picks up rounding errors, so add it up again
+    // once per pass through the buffer
+    if (std::is_floating_point<U>::value && FilterWithBuffer<T,FILTER_SIZE>::sample_index == 0) {
+        _sum = 0;
+        for(uint8_t i=0; i<FILTER_SIZE; i++)
+            _sum += FilterWithBuffer<T,FILTER_SIZE>::samples[i];
+    }
+
     // increment the number of samples so far
     _num_samples++;
     if( _num_samples > FILTER_SIZE || _num_samples == 0 )
         _num_samples = FILTER_SIZE;
 
-    // get sum of all values - there is a risk of overflow here that we ignore
-    for(uint8_t i=0; i<FILTER_SIZE; i++)
-        result += FilterWithBuffer<T,FILTER_SIZE>::samples[i];
-
-    return (T)(result / _num_samples);
+    return (T)(_sum / _num_samples);
 }
 
 // reset - clear all samples
@@ -102,8 +113,9 @@ void AverageFilter<T,U,FILTER_SIZE>::        reset()
     // call parent's apply function to get the sample into the array
     FilterWithBuffer<T,FILTER_SIZE>::reset();
 
-    // clear our variable
+    // clear our variables
     _num_samples = 0;
+    _sum = 0;
 }
 
 /*
@@ -130,9 +142,6 @@ public:
 
     // get the current value as a double
     virtual double getd();
-protected:
-    // the current sum of samples
-    U _sum = 0;
 };
 
 template <class T, class U, uint8_t FILTER_SIZE>
@@ -149,8 +158,8 @@ T AverageIntegralFilter<T,U,FILTER_SIZE>::apply(T sample)
         this->_num_samples = FILTER_SIZE;
     }
 
-    _sum -= curr;
-    _sum += sample;
+    this->_sum -= curr;
+    this->_sum += sample;
 
     // don't return the value: caller is forced to call getf() or getd()
     return 0;
@@ -163,7 +172,7 @@ float AverageIntegralFilter<T,U,FILTER_SIZE>::getf()
         return 0.f;
     }
 
-    return (float)_sum / this->_num_samples;
+    return (float)this->_sum / this->_num_samples;
 }
 
 template <class T, class U, uint8_t FILTER_SIZE>
@@ -173,5 +182,5 @@ double AverageIntegralFilter<T,U,FILTER_SIZE>::getd()
         return 0.f;
     }
 
-    return (double)_sum / this->_num_samples;
+    return (double)this->_sum / this->_num_samples;
 }
@@ -7,5 +7,6 @@
 #include "DerivativeFilter.h"
 #include "FilterWithBuffer.h"
 #include "LowPassFilter.h"
+#include "MedianFilter.h"
 #include "ModeFilter.h"
 #include "Butter.h"
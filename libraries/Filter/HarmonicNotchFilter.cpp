@@ -153,6 +153,9 @@ void HarmonicNotchFilter<T>::allocate_filters(uint8_t harmonics, bool double_not
         if (_filters == nullptr) {
             GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate %u bytes for HarmonicNotchFilter", (unsigned int)(_num_filters * sizeof(NotchFilter<T>)));
             _num_filters = 0;
+        } else if (!_bank.allocate(_num_filters)) {
+            // apply() falls back to running the filters one at a time
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate HarmonicNotchFilter bank");
         }
 
     }
@@ -199,6 +202,8 @@ void HarmonicNotchFilter<T>::update(float center_freq_hz)
             }
         }
     }
+
+    update_bank();
 }
 
 /*
@@ -238,6 +243,23 @@ void HarmonicNotchFilter<T>::update(uint8_t num_centers, const float center_freq
             }
         }
     }
+
+    update_bank();
+}
+
+/*
+  copy the coefficients of the enabled filters into the biquad bank
+ */
+template <class T>
+void HarmonicNotchFilter<T>::update_bank()
+{
+    if (!_bank.allocated()) {
+        return;
+    }
+    for (uint8_t i = 0; i < _num_enabled_filters; i++) {
+        _bank.set_stage(i, _filters[i]);
+    }
+    _bank.set_num_stages(_num_enabled_filters);
 }
 
 /*
@@ -250,6 +272,10 @@ T HarmonicNotchFilter<T>::apply(const T &sample)
         return sample;
     }
 
+    if (_bank.allocated()) {
+        return _bank.apply(sample);
+    }
+
     T output = sample;
     for (uint8_t i = 0; i < _num_enabled_filters; i++) {
         output = _filters[i].apply(output);
@@ -270,6 +296,7 @@ void HarmonicNotchFilter<T>::reset()
     for (uint8_t i = 0; i < _num_filters; i++) {
         _filters[i].reset();
     }
+    _bank.reset();
 }
 
 /*
@@ -283,4 +310,7 @@ HarmonicNotchFilterParams::HarmonicNotchFilterParams(void)
 /* 
   instantiate template classes
  */
+// the gyro filter is on the hot path. A section attribute on a template
+// is only honoured on an explicit instantiation
+template __FASTRAMFUNC__ Vector3f HarmonicNotchFilter<Vector3f>::apply(const Vector3f &sample);
 template class HarmonicNotchFilter<Vector3f>;
@@ -18,6 +18,7 @@
 #include <cmath>
 #include <AP_Param/AP_Param.h>
 #include "NotchFilter.h"
+#include "NotchFilterBank.h"
 
 #define HNF_MAX_HARMONICS 8
 #define HNF_MAX_HMNC_BITSET 0xF
@@ -44,8 +45,13 @@ public:
     void reset();
 
 private:
+    // copy the enabled filters' coefficients into the biquad bank
+    void update_bank();
+
     // underlying bank of notch filters
     NotchFilter<T>*  _filters;
+    // biquad bank used to apply the enabled filters in one pass
+    NotchFilterBank _bank;
     // sample frequency for each filter
     float _sample_freq_hz;
     // base double notch bandwidth for each filter
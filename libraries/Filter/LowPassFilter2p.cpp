@@ -9,6 +9,7 @@ template <class T>
 DigitalBiquadFilter<T>::DigitalBiquadFilter() {
   _delay_element_1 = T();
   _delay_element_2 = T();
+  initialised = false;
 }
 
 template <class T>
@@ -119,9 +120,111 @@ void LowPassFilter2p<T>::reset(const T &value) {
 /* 
  * Make an instances
  * Otherwise we have to move the constructor implementations to the header file :P
+ * The Vector3f apply() is the gyro and accel filter so is on the hot
+ * path. A section attribute on a template is only honoured on an
+ * explicit instantiation
  */
+template __FASTRAMFUNC__ Vector3f DigitalBiquadFilter<Vector3f>::apply(const Vector3f &sample, const struct biquad_params &params);
+template __FASTRAMFUNC__ Vector3f LowPassFilter2p<Vector3f>::apply(const Vector3f &sample);
 template class LowPassFilter2p<int>;
 template class LowPassFilter2p<long>;
 template class LowPassFilter2p<float>;
 template class LowPassFilter2p<Vector2f>;
 template class LowPassFilter2p<Vector3f>;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// DigitalBiquadFilterFixed
+////////////////////////////////////////////////////////////////////////////////////////////
+
+DigitalBiquadFilterFixed::DigitalBiquadFilterFixed()
+{
+    reset();
+}
+
+int32_t DigitalBiquadFilterFixed::apply(int32_t sample, const struct biquad_params &params)
+{
+    if (!initialised) {
+        reset(sample);
+    }
+
+    int64_t acc = int64_t(_err) +
+                  int64_t(params.b0) * sample + int64_t(params.b1) * _x1 + int64_t(params.b2) * _x2 -
+                  int64_t(params.a1) * _y1 - int64_t(params.a2) * _y2;
+
+    // arithmetic shift rounds towards minus infinity, the remainder
+    // is always positive and carried into the next sample
+    const int32_t output = int32_t(acc >> COEFF_BITS);
+    _err = int32_t(acc - (int64_t(output) << COEFF_BITS));
+
+    _x2 = _x1;
+    _x1 = sample;
+    _y2 = _y1;
+    _y1 = output;
+
+    return output;
+}
+
+void DigitalBiquadFilterFixed::reset()
+{
+    _x1 = _x2 = _y1 = _y2 = 0;
+    _err = 0;
+    initialised = false;
+}
+
+void DigitalBiquadFilterFixed::reset(int32_t value)
+{
+    // unity DC gain, so the steady state is the value throughout
+    _x1 = _x2 = _y1 = _y2 = value;
+    _err = 0;
+    initialised = true;
+}
+
+void DigitalBiquadFilterFixed::compute_params(float sample_freq, float cutoff_freq, biquad_params &ret)
+{
+    DigitalBiquadFilter<float>::biquad_params fp;
+    DigitalBiquadFilter<float>::compute_params(sample_freq, cutoff_freq, fp);
+
+    ret.cutoff_freq = fp.cutoff_freq;
+    ret.sample_freq = fp.sample_freq;
+    if (!is_positive(ret.cutoff_freq)) {
+        // zero cutoff means pass-thru
+        return;
+    }
+
+    const float scale = float(1UL << COEFF_BITS);
+    ret.a1 = int32_t(roundf(fp.a1 * scale));
+    ret.a2 = int32_t(roundf(fp.a2 * scale));
+    ret.b0 = int32_t(roundf(fp.b0 * scale));
+    ret.b1 = int32_t(roundf(fp.b1 * scale));
+    ret.b2 = int32_t(roundf(fp.b2 * scale));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// LowPassFilter2pFixed
+////////////////////////////////////////////////////////////////////////////////////////////
+
+LowPassFilter2pFixed::LowPassFilter2pFixed()
+{
+    memset(&_params, 0, sizeof(_params));
+}
+
+LowPassFilter2pFixed::LowPassFilter2pFixed(float sample_freq, float cutoff_freq)
+{
+    set_cutoff_frequency(sample_freq, cutoff_freq);
+}
+
+void LowPassFilter2pFixed::set_cutoff_frequency(float sample_freq, float cutoff_freq)
+{
+    DigitalBiquadFilterFixed::compute_params(sample_freq, cutoff_freq, _params);
+}
+
+int32_t LowPassFilter2pFixed::apply(int32_t sample)
+{
+    if (!is_positive(_params.cutoff_freq)) {
+        // zero cutoff means pass-thru
+        return sample;
+    }
+    return _filter.apply(sample, _params);
+}
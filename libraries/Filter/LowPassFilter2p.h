@@ -94,3 +94,62 @@ typedef LowPassFilter2p<long>     LowPassFilter2pLong;
 typedef LowPassFilter2p<float>    LowPassFilter2pFloat;
 typedef LowPassFilter2p<Vector2f> LowPassFilter2pVector2f;
 typedef LowPassFilter2p<Vector3f> LowPassFilter2pVector3f;
+
+/*
+  fixed point second order low pass filter, for targets where float
+  maths is slow or emulated (eg. the IOMCU). Samples are integers and
+  the coefficients are Q2.29. The filter is direct form I so the state
+  stays at the scale of the samples, with the rounding error fed back
+  into the next sample to avoid a DC offset at low cutoff frequencies.
+  Samples must be within +-2^28
+ */
+class DigitalBiquadFilterFixed {
+public:
+    static const uint8_t COEFF_BITS = 29;
+
+    struct biquad_params {
+        float cutoff_freq;
+        float sample_freq;
+        int32_t a1;
+        int32_t a2;
+        int32_t b0;
+        int32_t b1;
+        int32_t b2;
+    };
+
+    CLASS_NO_COPY(DigitalBiquadFilterFixed);
+
+    DigitalBiquadFilterFixed();
+
+    int32_t apply(int32_t sample, const struct biquad_params &params);
+    void reset();
+    void reset(int32_t value);
+    static void compute_params(float sample_freq, float cutoff_freq, biquad_params &ret);
+
+private:
+    int32_t _x1, _x2;
+    int32_t _y1, _y2;
+    int32_t _err;
+    bool initialised;
+};
+
+class LowPassFilter2pFixed {
+public:
+    LowPassFilter2pFixed();
+    // constructor
+    LowPassFilter2pFixed(float sample_freq, float cutoff_freq);
+    // change parameters
+    void set_cutoff_frequency(float sample_freq, float cutoff_freq);
+    // return the cutoff frequency
+    float get_cutoff_freq(void) const { return _params.cutoff_freq; }
+    float get_sample_freq(void) const { return _params.sample_freq; }
+    int32_t apply(int32_t sample);
+    void reset(void) { _filter.reset(); }
+    void reset(int32_t value) { _filter.reset(value); }
+
+    CLASS_NO_COPY(LowPassFilter2pFixed);
+
+private:
+    struct DigitalBiquadFilterFixed::biquad_params _params;
+    DigitalBiquadFilterFixed _filter;
+};
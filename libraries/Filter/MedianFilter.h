@@ -0,0 +1,192 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//
+/// @file	MedianFilter.h
+/// @brief	A class giving the median of the last FILTER_SIZE samples
+///
+/// The samples are kept in a circular buffer in arrival order and
+/// also in two heaps, a max-heap of the lower half and a min-heap of
+/// the upper half, which know where each sample is. A new sample
+/// replaces the oldest in place and is sifted through its heap, so
+/// each sample costs O(log n) rather than the O(n) of re-sorting the
+/// window. Until the window is full the median is of the samples so
+/// far. With an even number of samples the two middle ones are averaged
+#pragma once
+
+#include <inttypes.h>
+#include "FilterClass.h"
+
+template <class T, uint8_t FILTER_SIZE>
+class MedianFilter : public Filter<T>
+{
+    static_assert(FILTER_SIZE > 1, "MedianFilter needs at least two samples");
+
+public:
+    // constructor
+    MedianFilter() {
+        reset();
+    }
+
+    // apply - Add a new raw value to the filter, retrieve the filtered result
+    virtual T apply(T sample) override;
+
+    // reset - clear the filter
+    virtual void reset() override;
+
+    // get - get latest filtered value from filter (equal to the value returned by latest call to apply method)
+    T get() const {
+        return _output;
+    }
+
+    // get filter size
+    uint8_t get_filter_size() const {
+        return FILTER_SIZE;
+    }
+
+private:
+    enum { LOW = 0, HIGH = 1 };
+
+    // true if sample a should be above sample b in heap h
+    bool before(uint8_t h, uint8_t a, uint8_t b) const {
+        return h == LOW ? _samples[a] > _samples[b] : _samples[a] < _samples[b];
+    }
+
+    // put the sample in slot at index i of heap h
+    void place(uint8_t h, uint8_t i, uint8_t slot) {
+        _heap[h][i] = slot;
+        _heap_of[slot] = h;
+        _heap_pos[slot] = i;
+    }
+
+    // restore heap h after the sample at index i has changed
+    void sift(uint8_t h, uint8_t i);
+
+    // swap the tops of the heaps if they are out of order
+    void rebalance();
+
+    T               _samples[FILTER_SIZE];              // samples in arrival order
+    uint8_t         _heap[2][FILTER_SIZE/2+1];          // sample slots of the lower and upper heaps
+    uint8_t         _heap_len[2];                       // number of samples in each heap
+    uint8_t         _heap_of[FILTER_SIZE];              // heap holding each sample slot
+    uint8_t         _heap_pos[FILTER_SIZE];             // index in its heap of each sample slot
+    uint8_t         _sample_index;                      // slot of the next sample
+    uint8_t         _num_samples;                       // number of samples in the window
+    T               _output;
+};
+
+// Typedef for convenience
+typedef MedianFilter<int16_t,5> MedianFilterInt16_Size5;
+typedef MedianFilter<int16_t,9> MedianFilterInt16_Size9;
+typedef MedianFilter<uint16_t,5> MedianFilterUInt16_Size5;
+typedef MedianFilter<uint16_t,9> MedianFilterUInt16_Size9;
+typedef MedianFilter<float,5> MedianFilterFloat_Size5;
+typedef MedianFilter<float,9> MedianFilterFloat_Size9;
+typedef MedianFilter<float,15> MedianFilterFloat_Size15;
+typedef MedianFilter<float,31> MedianFilterFloat_Size31;
+
+template <class T, uint8_t FILTER_SIZE>
+void MedianFilter<T,FILTER_SIZE>::reset()
+{
+    _heap_len[LOW] = 0;
+    _heap_len[HIGH] = 0;
+    _sample_index = 0;
+    _num_samples = 0;
+    _output = 0;
+}
+
+template <class T, uint8_t FILTER_SIZE>
+void MedianFilter<T,FILTER_SIZE>::sift(uint8_t h, uint8_t i)
+{
+    uint8_t *heap = _heap[h];
+    const uint8_t slot = heap[i];
+
+    // move up while above the parent
+    while (i > 0) {
+        const uint8_t parent = (i - 1) / 2;
+        if (!before(h, slot, heap[parent])) {
+            break;
+        }
+        place(h, i, heap[parent]);
+        i = parent;
+    }
+
+    // move down while below a child
+    const uint8_t len = _heap_len[h];
+    while (true) {
+        uint8_t child = 2 * i + 1;
+        if (child >= len) {
+            break;
+        }
+        if (child + 1 < len && before(h, heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!before(h, heap[child], slot)) {
+            break;
+        }
+        place(h, i, heap[child]);
+        i = child;
+    }
+    place(h, i, slot);
+}
+
+/*
+  only one sample changes on each apply, so at most one sample can be
+  on the wrong side of the median and one swap of the tops puts it back
+ */
+template <class T, uint8_t FILTER_SIZE>
+void MedianFilter<T,FILTER_SIZE>::rebalance()
+{
+    if (_heap_len[HIGH] == 0) {
+        return;
+    }
+    const uint8_t low_top = _heap[LOW][0];
+    const uint8_t high_top = _heap[HIGH][0];
+    if (_samples[low_top] > _samples[high_top]) {
+        place(LOW, 0, high_top);
+        place(HIGH, 0, low_top);
+        sift(LOW, 0);
+        sift(HIGH, 0);
+    }
+}
+
+template <class T, uint8_t FILTER_SIZE>
+T MedianFilter<T,FILTER_SIZE>::apply(T sample)
+{
+    const uint8_t slot = _sample_index;
+    _samples[slot] = sample;
+
+    if (_num_samples < FILTER_SIZE) {
+        // add to the heaps, keeping the lower one the same size or one larger
+        const uint8_t h = (_heap_len[LOW] == _heap_len[HIGH]) ? LOW : HIGH;
+        place(h, _heap_len[h]++, slot);
+        _num_samples++;
+    }
+    // the new sample reuses the slot of the oldest
+    sift(_heap_of[slot], _heap_pos[slot]);
+    rebalance();
+
+    _sample_index++;
+    if (_sample_index >= FILTER_SIZE) {
+        _sample_index = 0;
+    }
+
+    const T low = _samples[_heap[LOW][0]];
+    if (_num_samples & 1) {
+        return _output = low;
+    }
+    const T high = _samples[_heap[HIGH][0]];
+    return _output = low + (high - low) / 2;
+}
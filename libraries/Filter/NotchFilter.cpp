@@ -49,6 +49,20 @@ template <class T>
 void NotchFilter<T>::init_with_A_and_Q(float sample_freq_hz, float center_freq_hz, float A, float Q)
 {
     if ((center_freq_hz > 0.0) && (center_freq_hz < 0.5 * sample_freq_hz) && (Q > 0.0)) {
+        // dynamic notches are updated at up to the loop rate, only
+        // recalculate once the center has moved by more than the
+        // hysteresis band from where the coefficients were calculated
+        if (initialised &&
+            is_equal(sample_freq_hz, _sample_freq_hz) &&
+            is_equal(A, _A) &&
+            is_equal(Q, _Q) &&
+            fabsf(center_freq_hz - _center_freq_hz) <= _center_freq_hz * NOTCH_FILTER_FREQ_HYSTERESIS) {
+            return;
+        }
+        _center_freq_hz = center_freq_hz;
+        _sample_freq_hz = sample_freq_hz;
+        _A = A;
+        _Q = Q;
         float omega = 2.0 * M_PI * center_freq_hz / sample_freq_hz;
         float alpha = sinf(omega) / (2 * Q);
         b0 =  1.0 + alpha*sq(A);
@@ -88,6 +102,21 @@ T NotchFilter<T>::apply(const T &sample)
     return output;
 }
 
+template <class T>
+void NotchFilter<T>::get_coefficients(float coeffs[5]) const
+{
+    if (!initialised) {
+        coeffs[0] = 1.0f;
+        coeffs[1] = coeffs[2] = coeffs[3] = coeffs[4] = 0.0f;
+        return;
+    }
+    coeffs[0] = b0 * a0_inv;
+    coeffs[1] = b1 * a0_inv;
+    coeffs[2] = b2 * a0_inv;
+    coeffs[3] = -a1 * a0_inv;
+    coeffs[4] = -a2 * a0_inv;
+}
+
 template <class T>
 void NotchFilter<T>::reset()
 {
@@ -145,5 +174,8 @@ NotchFilterParams::NotchFilterParams(void)
 /* 
    instantiate template classes
  */
+// the gyro filter is on the hot path. A section attribute on a template
+// is only honoured on an explicit instantiation
+template __FASTRAMFUNC__ Vector3f NotchFilter<Vector3f>::apply(const Vector3f &sample);
 template class NotchFilter<float>;
 template class NotchFilter<Vector3f>;
@@ -25,6 +25,10 @@
 #include <inttypes.h>
 #include <AP_Param/AP_Param.h>
 
+// relative change in center frequency below which an initialised
+// filter keeps its existing coefficients
+#define NOTCH_FILTER_FREQ_HYSTERESIS 0.002f
+
 
 template <class T>
 class NotchFilter {
@@ -35,6 +39,10 @@ public:
     T apply(const T &sample);
     void reset();
 
+    // return the biquad coefficients as {b0, b1, b2, -a1, -a2}
+    // normalised by a0, or a pass-through if not initialised
+    void get_coefficients(float coeffs[5]) const;
+
     // calculate attenuation and quality from provided center frequency and bandwidth
     static void calculate_A_and_Q(float center_freq_hz, float bandwidth_hz, float attenuation_dB, float& A, float& Q); 
 
@@ -42,6 +50,8 @@ private:
 
     bool initialised;
     float b0, b1, b2, a1, a2, a0_inv;
+    // inputs the current coefficients were calculated from
+    float _center_freq_hz, _sample_freq_hz, _A, _Q;
     T ntchsig, ntchsig1, ntchsig2, signal2, signal1;
 };
 
@@ -0,0 +1,149 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NotchFilterBank.h"
+
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+  number of state floats per stage. CMSIS uses transposed direct form
+  II with two states per axis. The other implementations use direct
+  form I, matching NotchFilter, with x1, x2, y1 and y2 for each axis,
+  padded to four lanes for NEON
+ */
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+#define NFB_STATE_PER_STAGE 6
+#elif NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_NEON
+#define NFB_STATE_PER_STAGE 16
+#else
+#define NFB_STATE_PER_STAGE 12
+#endif
+
+NotchFilterBank::~NotchFilterBank()
+{
+    delete[] _coeffs;
+    delete[] _state;
+}
+
+/*
+  allocate the coefficient and state arrays
+ */
+bool NotchFilterBank::allocate(uint8_t max_stages)
+{
+    if (_coeffs != nullptr || max_stages == 0) {
+        return false;
+    }
+    _coeffs = new float[max_stages * 5];
+    _state = new float[max_stages * NFB_STATE_PER_STAGE];
+    if (_coeffs == nullptr || _state == nullptr) {
+        delete[] _coeffs;
+        delete[] _state;
+        _coeffs = nullptr;
+        _state = nullptr;
+        return false;
+    }
+    _max_stages = max_stages;
+    _num_stages = 0;
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        arm_biquad_cascade_df2T_init_f32(&_instance[axis], 0, _coeffs, &_state[axis * 2 * max_stages]);
+    }
+#endif
+    return true;
+}
+
+void NotchFilterBank::set_stage(uint8_t stage, const NotchFilter<Vector3f> &filter)
+{
+    if (stage < _max_stages) {
+        filter.get_coefficients(&_coeffs[stage * 5]);
+    }
+}
+
+void NotchFilterBank::set_num_stages(uint8_t num_stages)
+{
+    _num_stages = MIN(num_stages, _max_stages);
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        _instance[axis].numStages = _num_stages;
+    }
+#endif
+}
+
+/*
+  apply a sample to each stage in turn and return the output
+ */
+Vector3f NotchFilterBank::apply(const Vector3f &sample)
+{
+    if (_num_stages == 0) {
+        return sample;
+    }
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+    float in[3] { sample.x, sample.y, sample.z };
+    float out[3];
+    for (uint8_t axis = 0; axis < 3; axis++) {
+        arm_biquad_cascade_df2T_f32(&_instance[axis], &in[axis], &out[axis], 1);
+    }
+    return Vector3f(out[0], out[1], out[2]);
+#elif NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_NEON
+    const float in[4] { sample.x, sample.y, sample.z, 0.0f };
+    float32x4_t x = vld1q_f32(in);
+    for (uint8_t i = 0; i < _num_stages; i++) {
+        const float *c = &_coeffs[i * 5];
+        float *st = &_state[i * NFB_STATE_PER_STAGE];
+        const float32x4_t x1 = vld1q_f32(&st[0]);
+        const float32x4_t x2 = vld1q_f32(&st[4]);
+        const float32x4_t y1 = vld1q_f32(&st[8]);
+        const float32x4_t y2 = vld1q_f32(&st[12]);
+        float32x4_t y = vmulq_n_f32(x, c[0]);
+        y = vmlaq_n_f32(y, x1, c[1]);
+        y = vmlaq_n_f32(y, x2, c[2]);
+        y = vmlaq_n_f32(y, y1, c[3]);
+        y = vmlaq_n_f32(y, y2, c[4]);
+        vst1q_f32(&st[4], x1);
+        vst1q_f32(&st[0], x);
+        vst1q_f32(&st[12], y1);
+        vst1q_f32(&st[8], y);
+        x = y;
+    }
+    float out[4];
+    vst1q_f32(out, x);
+    return Vector3f(out[0], out[1], out[2]);
+#else
+    float x[3] { sample.x, sample.y, sample.z };
+    for (uint8_t i = 0; i < _num_stages; i++) {
+        const float *c = &_coeffs[i * 5];
+        // state is x1[3], x2[3], y1[3], y2[3]
+        float *st = &_state[i * NFB_STATE_PER_STAGE];
+        for (uint8_t axis = 0; axis < 3; axis++) {
+            const float y = c[0]*x[axis] + c[1]*st[axis] + c[2]*st[3+axis] + c[3]*st[6+axis] + c[4]*st[9+axis];
+            st[3+axis] = st[axis];
+            st[axis] = x[axis];
+            st[9+axis] = st[6+axis];
+            st[6+axis] = y;
+            x[axis] = y;
+        }
+    }
+    return Vector3f(x[0], x[1], x[2]);
+#endif
+}
+
+void NotchFilterBank::reset()
+{
+    if (_state != nullptr) {
+        memset(_state, 0, _max_stages * NFB_STATE_PER_STAGE * sizeof(float));
+    }
+}
@@ -0,0 +1,73 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+/*
+  a bank of cascaded biquad stages applied to three-axis samples
+
+  Coefficients are held as one array for all stages so the whole
+  cascade can be run in a single pass, using CMSIS-DSP on ChibiOS,
+  NEON on ARM Linux and plain C++ elsewhere
+ */
+
+#include <AP_HAL/AP_HAL_Boards.h>
+#include <AP_Math/AP_Math.h>
+#include "NotchFilter.h"
+
+#define NOTCH_FILTER_BANK_GENERIC 0
+#define NOTCH_FILTER_BANK_CMSIS   1
+#define NOTCH_FILTER_BANK_NEON    2
+
+#ifndef NOTCH_FILTER_BANK_IMPL
+#if HAL_WITH_DSP && CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
+#define NOTCH_FILTER_BANK_IMPL NOTCH_FILTER_BANK_CMSIS
+#elif CONFIG_HAL_BOARD == HAL_BOARD_LINUX && defined(__ARM_NEON)
+#define NOTCH_FILTER_BANK_IMPL NOTCH_FILTER_BANK_NEON
+#else
+#define NOTCH_FILTER_BANK_IMPL NOTCH_FILTER_BANK_GENERIC
+#endif
+#endif
+
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+#include <arm_math.h>
+#endif
+
+class NotchFilterBank {
+public:
+    ~NotchFilterBank();
+
+    // allocate coefficients and state for up to max_stages stages
+    bool allocate(uint8_t max_stages);
+    // whether allocation succeeded
+    bool allocated() const { return _coeffs != nullptr; }
+    // copy the coefficients of a notch filter into a stage
+    void set_stage(uint8_t stage, const NotchFilter<Vector3f> &filter);
+    // set the number of stages applied, stages beyond this keep their state
+    void set_num_stages(uint8_t num_stages);
+    // apply a sample through all stages in turn
+    Vector3f apply(const Vector3f &sample);
+    // reset the state of all stages
+    void reset();
+
+private:
+    // coefficients for each stage as {b0, b1, b2, -a1, -a2} normalised by a0
+    float *_coeffs;
+    float *_state;
+    uint8_t _max_stages;
+    uint8_t _num_stages;
+#if NOTCH_FILTER_BANK_IMPL == NOTCH_FILTER_BANK_CMSIS
+    arm_biquad_cascade_df2T_instance_f32 _instance[3];
+#endif
+};
@@ -0,0 +1,156 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <Filter/DerivativeFilter.h>
+#include <Filter/HarmonicNotchFilter.h>
+#include <Filter/AverageFilter.h>
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/MedianFilter.h>
+#include <Filter/ModeFilter.h>
+#include <Filter/NotchFilter.h>
+
+/*
+  each iteration applies one sample, so the reported time is the cost
+  per sample. Samples come from a short precomputed table so the
+  signal generation isn't part of the timing
+ */
+#define SAMPLE_RATE_HZ 4000
+#define NUM_SAMPLES 256
+
+static float samples[NUM_SAMPLES];
+
+static void setup_samples()
+{
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        const float t = i / float(SAMPLE_RATE_HZ);
+        samples[i] = sinf(2 * M_PI * 15 * t) + 0.3f * sinf(2 * M_PI * 170 * t);
+    }
+}
+
+static void BM_LowPassFilter2pFloat(benchmark::State& state)
+{
+    setup_samples();
+    LowPassFilter2pFloat filter(SAMPLE_RATE_HZ, 80);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out = filter.apply(samples[i++ % NUM_SAMPLES]);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_LowPassFilter2pVector3f(benchmark::State& state)
+{
+    setup_samples();
+    LowPassFilter2pVector3f filter(SAMPLE_RATE_HZ, 80);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        const float s = samples[i++ % NUM_SAMPLES];
+        Vector3f out = filter.apply(Vector3f(s, -s, 0.5f * s));
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_LowPassFilter2pFixed(benchmark::State& state)
+{
+    setup_samples();
+    LowPassFilter2pFixed filter(SAMPLE_RATE_HZ, 80);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        int32_t out = filter.apply(int32_t(samples[i++ % NUM_SAMPLES] * 8000));
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_NotchFilterVector3f(benchmark::State& state)
+{
+    setup_samples();
+    NotchFilterVector3f filter;
+    filter.init(SAMPLE_RATE_HZ, 170, 40, 30);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        const float s = samples[i++ % NUM_SAMPLES];
+        Vector3f out = filter.apply(Vector3f(s, -s, 0.5f * s));
+        gbenchmark_escape(&out);
+    }
+}
+
+// arguments are the harmonics bitmask and whether to use double notches
+static void BM_HarmonicNotchFilterVector3f(benchmark::State& state)
+{
+    setup_samples();
+    HarmonicNotchFilterVector3f filter;
+    filter.allocate_filters(state.range(0), state.range(1));
+    filter.init(SAMPLE_RATE_HZ, 170, 40, 30);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        const float s = samples[i++ % NUM_SAMPLES];
+        Vector3f out = filter.apply(Vector3f(s, -s, 0.5f * s));
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_ModeFilterFloat_Size5(benchmark::State& state)
+{
+    setup_samples();
+    ModeFilterFloat_Size5 filter(2);
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out = filter.apply(samples[i++ % NUM_SAMPLES]);
+        gbenchmark_escape(&out);
+    }
+}
+
+// median filters of several window sizes, to compare with the mode filter
+template <class F>
+static void BM_MedianFilter(benchmark::State& state)
+{
+    setup_samples();
+    F filter;
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out = filter.apply(samples[i++ % NUM_SAMPLES]);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_AverageFilterFloat_Size5(benchmark::State& state)
+{
+    setup_samples();
+    AverageFilterFloat_Size5 filter;
+    uint16_t i = 0;
+    while (state.KeepRunning()) {
+        float out = filter.apply(samples[i++ % NUM_SAMPLES]);
+        gbenchmark_escape(&out);
+    }
+}
+
+static void BM_DerivativeFilterFloat_Size7(benchmark::State& state)
+{
+    setup_samples();
+    DerivativeFilterFloat_Size7 filter;
+    uint16_t i = 0;
+    uint32_t t_us = 0;
+    while (state.KeepRunning()) {
+        filter.update(samples[i++ % NUM_SAMPLES], t_us);
+        t_us += 1000000 / SAMPLE_RATE_HZ;
+        float out = filter.slope();
+        gbenchmark_escape(&out);
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2pFloat);
+BENCHMARK(BM_LowPassFilter2pVector3f);
+BENCHMARK(BM_LowPassFilter2pFixed);
+BENCHMARK(BM_NotchFilterVector3f);
+BENCHMARK(BM_HarmonicNotchFilterVector3f)
+    ->ArgPair(0x1, false)->ArgPair(0x3, false)->ArgPair(0xF, false)->ArgPair(0xFF, false)
+    ->ArgPair(0x1, true)->ArgPair(0x3, true)->ArgPair(0xF, true)->ArgPair(0xFF, true);
+BENCHMARK(BM_ModeFilterFloat_Size5);
+BENCHMARK_TEMPLATE(BM_MedianFilter, MedianFilterFloat_Size5);
+BENCHMARK_TEMPLATE(BM_MedianFilter, MedianFilterFloat_Size9);
+BENCHMARK_TEMPLATE(BM_MedianFilter, MedianFilterFloat_Size15);
+BENCHMARK_TEMPLATE(BM_MedianFilter, MedianFilterFloat_Size31);
+BENCHMARK(BM_AverageFilterFloat_Size5);
+BENCHMARK(BM_DerivativeFilterFloat_Size7);
+
+BENCHMARK_MAIN();
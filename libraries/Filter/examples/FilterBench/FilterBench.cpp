@@ -0,0 +1,79 @@
+/*
+ *       Example sketch comparing the cost of the float and fixed point
+ *       second order low pass filters, and the notch filter
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/NotchFilter.h>
+
+void setup();
+void loop();
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define SAMPLE_RATE_HZ 4000
+#define NUM_SAMPLES 4000
+
+static LowPassFilter2pFloat lpf_float(SAMPLE_RATE_HZ, 80);
+static LowPassFilter2pVector3f lpf_vector(SAMPLE_RATE_HZ, 80);
+static LowPassFilter2pFixed lpf_fixed(SAMPLE_RATE_HZ, 80);
+static NotchFilterFloat notch_float;
+
+// raw gyro scale samples, generated once so the timing is of the filters alone
+static int16_t samples[NUM_SAMPLES];
+
+void setup()
+{
+    hal.console->printf("ArduPilot filter benchmark\n\n");
+    notch_float.init(SAMPLE_RATE_HZ, 200, 50, 40);
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        const float t = i / float(SAMPLE_RATE_HZ);
+        samples[i] = 8000 * sinf(2 * M_PI * 15 * t) + 3000 * sinf(2 * M_PI * 700 * t);
+    }
+}
+
+static void report(const char *name, uint32_t start_us, float sum)
+{
+    const uint32_t dt_us = AP_HAL::micros() - start_us;
+    hal.console->printf("%-12s %6.3f us/sample (%f)\n", name,
+                        dt_us / float(NUM_SAMPLES), (double)sum);
+}
+
+void loop()
+{
+    // the sums are printed so the filters can't be optimised away
+    uint32_t start_us = AP_HAL::micros();
+    float sum = 0;
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        sum += lpf_float.apply(samples[i]);
+    }
+    report("lpf float", start_us, sum);
+
+    start_us = AP_HAL::micros();
+    sum = 0;
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        const float s = samples[i];
+        sum += lpf_vector.apply(Vector3f(s, s, s)).x;
+    }
+    report("lpf vector3f", start_us, sum);
+
+    start_us = AP_HAL::micros();
+    int32_t isum = 0;
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        isum += lpf_fixed.apply(samples[i]);
+    }
+    report("lpf fixed", start_us, isum);
+
+    start_us = AP_HAL::micros();
+    sum = 0;
+    for (uint16_t i = 0; i < NUM_SAMPLES; i++) {
+        sum += notch_float.apply(samples[i]);
+    }
+    report("notch float", start_us, sum);
+
+    hal.console->printf("\n");
+    hal.scheduler->delay(5000);
+}
+
+AP_HAL_MAIN();
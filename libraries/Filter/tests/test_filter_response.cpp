@@ -0,0 +1,76 @@
+#include <AP_gtest.h>
+
+#include <Filter/HarmonicNotchFilter.h>
+#include <Filter/LowPassFilter2p.h>
+#include <Filter/NotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  frequency response checks. Each filter is fed a sine at the test
+  frequency and the gain is measured once the filter has settled
+ */
+#define SAMPLE_RATE_HZ 1000
+
+template <typename F>
+static float gain_dB(F &filter, float freq_hz)
+{
+    const uint16_t settle = 2 * SAMPLE_RATE_HZ;
+    const uint16_t measure = 2 * SAMPLE_RATE_HZ;
+    float in_sq = 0, out_sq = 0;
+    for (uint16_t n = 0; n < settle + measure; n++) {
+        const float s = sinf(2 * M_PI * freq_hz * n / SAMPLE_RATE_HZ);
+        const Vector3f out = filter.apply(Vector3f(s, s, s));
+        if (n >= settle) {
+            in_sq += s * s;
+            out_sq += out.x * out.x;
+        }
+    }
+    return 10 * log10f(out_sq / in_sq);
+}
+
+TEST(FilterResponseTest, LowPassFilter2p)
+{
+    const float cutoff = 50;
+    LowPassFilter2pVector3f pass(SAMPLE_RATE_HZ, cutoff);
+    EXPECT_NEAR(0, gain_dB(pass, 2), 0.1);
+    LowPassFilter2pVector3f at_cutoff(SAMPLE_RATE_HZ, cutoff);
+    EXPECT_NEAR(-3, gain_dB(at_cutoff, cutoff), 0.5);
+    // second order, so at least -40dB a decade above the cutoff
+    LowPassFilter2pVector3f stop(SAMPLE_RATE_HZ, cutoff);
+    EXPECT_LT(gain_dB(stop, 8 * cutoff), -35);
+}
+
+TEST(FilterResponseTest, NotchFilter)
+{
+    const float center = 120;
+    const float attenuation = 30;
+    NotchFilterVector3f notch;
+    notch.init(SAMPLE_RATE_HZ, center, 40, attenuation);
+    EXPECT_NEAR(-attenuation, gain_dB(notch, center), 2);
+    notch.reset();
+    EXPECT_NEAR(0, gain_dB(notch, 10), 0.5);
+    notch.reset();
+    EXPECT_NEAR(0, gain_dB(notch, 400), 0.5);
+}
+
+// the harmonic notch must attenuate each selected harmonic, with and
+// without double notches
+TEST(FilterResponseTest, HarmonicNotchFilter)
+{
+    const float fundamental = 80;
+    for (const bool double_notch : { false, true }) {
+        HarmonicNotchFilterVector3f filter;
+        // fundamental and third harmonic
+        filter.allocate_filters(0x5, double_notch);
+        filter.init(SAMPLE_RATE_HZ, fundamental, 40, 30);
+        EXPECT_LT(gain_dB(filter, fundamental), -15);
+        filter.reset();
+        EXPECT_LT(gain_dB(filter, 3 * fundamental), -15);
+        filter.reset();
+        // the second harmonic is not selected
+        EXPECT_GT(gain_dB(filter, 2 * fundamental), -3);
+    }
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,50 @@
+#include <AP_gtest.h>
+
+#include <Filter/LowPassFilter2p.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// the fixed point filter must track the float filter to within 0.1%
+// of the signal range on sensor scale integer samples
+TEST(LowPassFilter2pFixedTest, MatchesFloat)
+{
+    const float sample_rate = 4000;
+    const float cutoffs[] { 20, 80, 400 };
+    for (const float cutoff : cutoffs) {
+        LowPassFilter2pFloat ref(sample_rate, cutoff);
+        LowPassFilter2pFixed fixed(sample_rate, cutoff);
+        for (uint16_t n = 0; n < 4000; n++) {
+            const float t = n / sample_rate;
+            const int32_t sample = int32_t(8000 * sinf(2 * M_PI * 15 * t) +
+                                           3000 * sinf(2 * M_PI * 700 * t) + 500);
+            const float expected = ref.apply(sample);
+            EXPECT_NEAR(expected, fixed.apply(sample), 12);
+        }
+    }
+}
+
+// a step must settle on the new value with no rounding offset
+TEST(LowPassFilter2pFixedTest, StepSettles)
+{
+    LowPassFilter2pFixed fixed(4000, 20);
+    fixed.reset(0);
+    int32_t output = 0;
+    for (uint16_t n = 0; n < 4000; n++) {
+        output = fixed.apply(1001);
+    }
+    EXPECT_EQ(1001, output);
+    for (uint16_t n = 0; n < 4000; n++) {
+        output = fixed.apply(-37);
+    }
+    EXPECT_EQ(-37, output);
+}
+
+// a zero cutoff passes samples through
+TEST(LowPassFilter2pFixedTest, PassThrough)
+{
+    LowPassFilter2pFixed fixed(4000, 0);
+    EXPECT_EQ(1234, fixed.apply(1234));
+    EXPECT_EQ(-5, fixed.apply(-5));
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,108 @@
+#include <AP_gtest.h>
+
+#include <Filter/Filter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// median of the n samples in window by sorting, to check against
+static float reference_median(const float *window, uint8_t n)
+{
+    float sorted[31];
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t j = i;
+        while (j > 0 && sorted[j-1] > window[i]) {
+            sorted[j] = sorted[j-1];
+            j--;
+        }
+        sorted[j] = window[i];
+    }
+    if (n & 1) {
+        return sorted[n/2];
+    }
+    return sorted[n/2-1] + (sorted[n/2] - sorted[n/2-1]) / 2;
+}
+
+template <class F>
+static void check_against_sort(F &filt, uint16_t num_samples)
+{
+    const uint8_t size = filt.get_filter_size();
+    float window[31];
+    uint8_t n = 0;
+    uint32_t seed = 1;
+    for (uint16_t i = 0; i < num_samples; i++) {
+        // small range so there are plenty of repeated values
+        seed = seed * 1103515245U + 12345U;
+        const float sample = float((seed >> 16) % 41) - 20;
+        if (n == size) {
+            memmove(&window[0], &window[1], (size-1)*sizeof(float));
+            n--;
+        }
+        window[n++] = sample;
+        const float expected = reference_median(window, n);
+        EXPECT_EQ(expected, filt.apply(sample));
+        EXPECT_EQ(expected, filt.get());
+    }
+}
+
+TEST(MedianFilterTest, MatchesSort)
+{
+    MedianFilterFloat_Size5 filt5;
+    check_against_sort(filt5, 1000);
+    MedianFilter<float,4> filt4;
+    check_against_sort(filt4, 1000);
+    MedianFilterFloat_Size31 filt31;
+    check_against_sort(filt31, 2000);
+}
+
+TEST(MedianFilterTest, RejectsGlitches)
+{
+    MedianFilterInt16_Size5 filt;
+    for (uint8_t i = 0; i < 10; i++) {
+        EXPECT_EQ(100, filt.apply(100));
+    }
+    // two glitches in a row out of five don't get through
+    EXPECT_EQ(100, filt.apply(3000));
+    EXPECT_EQ(100, filt.apply(-3000));
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(100, filt.apply(100));
+    }
+    // a step does once it fills more than half the window
+    EXPECT_EQ(100, filt.apply(200));
+    EXPECT_EQ(100, filt.apply(200));
+    EXPECT_EQ(200, filt.apply(200));
+}
+
+TEST(MedianFilterTest, Reset)
+{
+    MedianFilterUInt16_Size5 filt;
+    for (uint8_t i = 0; i < 7; i++) {
+        filt.apply(500);
+    }
+    filt.reset();
+    EXPECT_EQ(0, filt.get());
+    EXPECT_EQ(20, filt.apply(20));
+    EXPECT_EQ(25, filt.apply(30));
+    EXPECT_EQ(30, filt.apply(40));
+}
+
+// the running sum must give the same result as adding up the buffer
+TEST(AverageFilterTest, RunningSum)
+{
+    AverageFilterInt16_Size5 filt;
+    AverageFilterFloat_Size5 filtf;
+    int16_t window[5] {};
+    uint8_t n = 0;
+    for (uint16_t i = 0; i < 1000; i++) {
+        const int16_t sample = int16_t((i * 37) % 200) - 100;
+        window[i % 5] = sample;
+        n = MIN(n + 1, 5);
+        int32_t sum = 0;
+        for (uint8_t j = 0; j < 5; j++) {
+            sum += window[j];
+        }
+        EXPECT_EQ(int16_t(sum / n), filt.apply(sample));
+        EXPECT_FLOAT_EQ(float(sum) / n, filtf.apply(sample));
+    }
+}
+
+AP_GTEST_MAIN()
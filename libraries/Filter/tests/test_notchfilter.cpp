@@ -0,0 +1,70 @@
+#include <AP_gtest.h>
+
+#include <Filter/NotchFilter.h>
+#include <Filter/NotchFilterBank.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// a bank of stages must give the same output as chaining the notch filters
+TEST(NotchFilterBankTest, MatchesChainedFilters)
+{
+    const float sample_rate = 1000;
+    const float centers[] { 80, 160, 240, 600 };
+    NotchFilterVector3f filters[ARRAY_SIZE(centers)];
+    NotchFilterBank bank;
+    EXPECT_TRUE(bank.allocate(ARRAY_SIZE(centers)));
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(centers); i++) {
+        // the last center is above nyquist so that filter passes through
+        filters[i].init(sample_rate, centers[i], 40, 30);
+        bank.set_stage(i, filters[i]);
+    }
+    bank.set_num_stages(ARRAY_SIZE(centers));
+
+    for (uint16_t n = 0; n < 2000; n++) {
+        const float t = n / sample_rate;
+        const Vector3f sample(sinf(2 * M_PI * 80 * t),
+                              cosf(2 * M_PI * 150 * t),
+                              0.5f * sinf(2 * M_PI * 240 * t) + 0.1f);
+        Vector3f expected = sample;
+        for (auto &f : filters) {
+            expected = f.apply(expected);
+        }
+        const Vector3f output = bank.apply(sample);
+        EXPECT_NEAR(expected.x, output.x, 1.0e-4);
+        EXPECT_NEAR(expected.y, output.y, 1.0e-4);
+        EXPECT_NEAR(expected.z, output.z, 1.0e-4);
+    }
+}
+
+// with no stages the bank is a pass-through
+TEST(NotchFilterBankTest, NoStages)
+{
+    NotchFilterBank bank;
+    EXPECT_TRUE(bank.allocate(2));
+    const Vector3f sample(1, 2, 3);
+    EXPECT_EQ(sample, bank.apply(sample));
+}
+
+// small center frequency moves keep the existing coefficients
+TEST(NotchFilterTest, CenterHysteresis)
+{
+    NotchFilterFloat filter;
+    float A, Q;
+    NotchFilterFloat::calculate_A_and_Q(100, 50, 40, A, Q);
+    filter.init_with_A_and_Q(1000, 100, A, Q);
+    float c0[5], c1[5];
+    filter.get_coefficients(c0);
+
+    filter.init_with_A_and_Q(1000, 100 * (1 + NOTCH_FILTER_FREQ_HYSTERESIS * 0.5f), A, Q);
+    filter.get_coefficients(c1);
+    for (uint8_t i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(c0[i], c1[i]);
+    }
+
+    filter.init_with_A_and_Q(1000, 110, A, Q);
+    filter.get_coefficients(c1);
+    EXPECT_NE(c0[1], c1[1]);
+}
+
+AP_GTEST_MAIN()
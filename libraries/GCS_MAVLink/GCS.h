@@ -12,6 +12,7 @@
 #include <AP_Frsky_Telem/AP_Frsky_Telem.h>
 #include <AP_AdvancedFailsafe/AP_AdvancedFailsafe.h>
 #include <AP_RTC/JitterCorrection.h>
+#include <AP_RTC/ClockSync.h>
 #include <AP_Common/Bitmask.h>
 #include <AP_LTM_Telem/AP_LTM_Telem.h>
 #include <AP_Devo_Telem/AP_Devo_Telem.h>
@@ -27,12 +28,47 @@
 
 #define GCS_DEBUG_SEND_MESSAGE_TIMINGS 0
 
+// number of files that may be open at once over MAVLink FTP
+#ifndef GCS_FTP_MAX_SESSIONS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define GCS_FTP_MAX_SESSIONS 4
+#else
+#define GCS_FTP_MAX_SESSIONS 1
+#endif
+#endif
+
+// size of the per-session read-ahead buffer for FTP downloads, 0 to disable
+#ifndef GCS_FTP_READAHEAD_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define GCS_FTP_READAHEAD_SIZE 4096
+#else
+#define GCS_FTP_READAHEAD_SIZE 0
+#endif
+#endif
+
+// channels with the SERIALn_OPTIONS bit set can parse MAVLink in a
+// thread of their own, queueing messages for the main thread
+#ifndef GCS_MAVLINK_RX_THREAD_ENABLED
+#define GCS_MAVLINK_RX_THREAD_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_300)
+#endif
+
+// messages queued from the receive thread of a channel
+#ifndef GCS_MAVLINK_RX_QUEUE_LEN
+#define GCS_MAVLINK_RX_QUEUE_LEN 8
+#endif
+
 #ifndef HAL_NO_GCS
 
 // macros used to determine if a message will fit in the space available.
 
 void gcs_out_of_space_to_send_count(mavlink_channel_t chan);
 
+/*
+  the lock taken by comm_send_lock(), also held while parsing from a
+  receive thread as parsing and sending share the channel status
+ */
+HAL_Semaphore &comm_chan_lock(mavlink_channel_t chan);
+
 // important note: despite the names, these messages do NOT check to
 // see if the payload will fit in the buffer.  They check to see if
 // the packed message along with any channel overhead will fit.
@@ -450,13 +486,17 @@ protected:
     void send_timesync();
     // returns the time a timesync message was most likely received:
     uint64_t timesync_receive_timestamp_ns() const;
+
+    // time a received packet of packet_len bytes finished arriving,
+    // or 0 if unknown
+    uint64_t receive_time_constraint_us(uint16_t packet_len) const;
     // returns a timestamp suitable for packing into the ts1 field of TIMESYNC:
     uint64_t timesync_timestamp_ns() const;
     void handle_timesync(const mavlink_message_t &msg);
     struct {
         int64_t sent_ts1;
         uint32_t last_sent_ms;
-        const uint16_t interval_ms = 10000;
+        const uint16_t interval_ms = 1000;
     }  _timesync_request;
 
     void handle_statustext(const mavlink_message_t &msg) const;
@@ -533,7 +573,7 @@ protected:
       correct an offboard timestamp in microseconds to a local time
       since boot in milliseconds
      */
-    uint32_t correct_offboard_timestamp_usec_to_ms(uint64_t offboard_usec, uint16_t payload_size);
+    uint32_t correct_offboard_timestamp_usec_to_ms(const mavlink_message_t &msg, uint64_t offboard_usec, uint16_t payload_size);
 
 private:
 
@@ -575,11 +615,36 @@ private:
                                                          // queued send
     uint32_t                    _queued_parameter_send_time_ms;
 
-    // number of extra ms to add to slow things down for the radio
+    // estimate of the time in ms until the send budget has recovered
+    // from sending more than the link can carry
     uint16_t         stream_slowdown_ms;
     // last reported radio buffer percent available
     uint8_t          last_txbuf = 100;
 
+    // per-link transmit budget in bytes. Tokens accumulate at the
+    // estimated link rate and are spent by every message sent. When
+    // the budget runs short, lower priority stream messages are
+    // skipped so that higher priority ones keep their rate
+    enum class SendPriority : uint8_t {
+        HIGH   = 0,
+        NORMAL = 1,
+        LOW    = 2,
+    };
+    struct {
+        int32_t tokens;
+        uint32_t last_update_ms;
+        uint32_t radio_status_ms;  // time of last RADIO_STATUS on this link
+        uint8_t rate_pct = 100;    // percentage of the port bandwidth the radio is keeping up with
+    } send_budget;
+    uint32_t send_budget_bytes_per_second() const;
+    void update_send_budget();
+    bool send_budget_allows(SendPriority priority) const;
+    static SendPriority stream_priority(streams id);
+    static SendPriority ap_message_priority(ap_message id);
+    static Bitmask<MSG_LAST> high_priority_ap_message_ids;
+    static Bitmask<MSG_LAST> low_priority_ap_message_ids;
+    static bool ap_message_priorities_initialised;
+
     // outbound ("deferred message") queue.
 
     // "special" messages such as heartbeat, next_param etc are stored
@@ -754,19 +819,38 @@ private:
         Write,
     };
 
+    // an open file, identified by the session number and the system
+    // and component that opened it
+    struct ftp_session {
+        int fd = -1;
+        FTP_FILE_MODE mode; // work around AP_Filesystem not supporting file modes
+        uint8_t session;
+        uint8_t sysid;
+        uint8_t compid;
+        uint32_t last_activity_ms;
+        // read-ahead buffer for sequential reads, may be nullptr
+        uint8_t *readahead;
+        uint32_t readahead_offset;
+        uint16_t readahead_len;
+    };
+
     struct ftp_state {
         ObjectBuffer<pending_ftp> *requests;
         ObjectBuffer<pending_ftp> *replies;
 
-        // session specific info, currently only support a single session over all links
-        int fd = -1;
-        FTP_FILE_MODE mode; // work around AP_Filesystem not supporting file modes
-        int16_t current_session;
+        struct ftp_session sessions[GCS_FTP_MAX_SESSIONS];
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
     };
     static struct ftp_state ftp;
 
+    static struct ftp_session *ftp_find_session(const struct pending_ftp &request);
+    static struct ftp_session *ftp_open_session(const struct pending_ftp &request, uint32_t now_ms);
+    static void ftp_close_session(struct ftp_session &session);
+    static void ftp_no_session_error(struct pending_ftp &response);
+    static ssize_t ftp_read(struct ftp_session &session, uint32_t offset, uint8_t *data, uint16_t len);
+    static uint16_t ftp_burst_size(mavlink_channel_t chan);
+
     static void ftp_error(struct pending_ftp &response, FTP_ERROR error); // FTP helper method for packing a NAK
     static int gen_dir_entry(char *dest, size_t space, const char * path, const struct dirent * entry); // FTP helper for emitting a dir response
     static void ftp_list_dir(struct pending_ftp &request, struct pending_ftp &response);
@@ -787,7 +871,8 @@ private:
     void handle_vision_position_estimate(const mavlink_message_t &msg);
     void handle_global_vision_position_estimate(const mavlink_message_t &msg);
     void handle_att_pos_mocap(const mavlink_message_t &msg);
-    void handle_common_vision_position_estimate_data(const uint64_t usec,
+    void handle_common_vision_position_estimate_data(const mavlink_message_t &msg,
+                                                     const uint64_t usec,
                                                      const float x,
                                                      const float y,
                                                      const float z,
@@ -798,6 +883,7 @@ private:
                                                      const uint8_t reset_counter,
                                                      const uint16_t payload_size);
     void handle_vision_speed_estimate(const mavlink_message_t &msg);
+    void handle_odometry(const mavlink_message_t &msg);
     void handle_landing_target(const mavlink_message_t &msg);
 
     void lock_channel(const mavlink_channel_t chan, bool lock);
@@ -821,7 +907,34 @@ private:
         bool active;
     } alternative;
 
+#if GCS_MAVLINK_RX_THREAD_ENABLED
+    // parsing in a thread of our own. All messages are still handled
+    // on the main thread, in update_receive()
+    struct rx_packet {
+        mavlink_message_t msg;
+        uint64_t receive_us;
+        uint8_t status_flags;
+    };
+    ObjectBuffer<rx_packet> *rx_queue;
+    HAL_EventHandle rx_event;
+    // held while parsing, so the main thread can take over parsing
+    // for an alternative protocol handler
+    HAL_Semaphore rx_sem;
+    bool start_rx_thread();
+    void rx_thread();
+#endif
+    // receive time of the message being handled when the UART has
+    // moved on since it was parsed, 0 otherwise
+    uint64_t rx_packet_receive_us;
+    void update_receive_parse(uint32_t tstart_us, uint32_t max_time_us);
+    void handle_parsed_packet(const mavlink_status_t &status, const mavlink_message_t &msg, uint32_t now_ms);
+
     JitterCorrection lag_correction;
+
+    // clock of the system sending us timestamped data, from TIMESYNC
+    // exchanges. Used in place of lag_correction once converged
+    ClockSync clock_sync;
+    uint8_t clock_sync_sysid;
     
     // we cache the current location and send it even if the AHRS has
     // no idea where we are:
@@ -79,6 +79,9 @@
 extern const AP_HAL::HAL& hal;
 
 struct GCS_MAVLINK::LastRadioStatus GCS_MAVLINK::last_radio_status;
+Bitmask<MSG_LAST> GCS_MAVLINK::high_priority_ap_message_ids;
+Bitmask<MSG_LAST> GCS_MAVLINK::low_priority_ap_message_ids;
+bool GCS_MAVLINK::ap_message_priorities_initialised;
 uint8_t GCS_MAVLINK::mavlink_active = 0;
 uint8_t GCS_MAVLINK::chan_is_streaming = 0;
 uint32_t GCS_MAVLINK::reserve_param_space_start_ms;
@@ -169,9 +172,110 @@ bool GCS_MAVLINK::init(uint8_t instance)
         status->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
     }
 
+#if GCS_MAVLINK_RX_THREAD_ENABLED
+    if (serial_manager.mavlink_rx_thread(protocol, instance) && !start_rx_thread()) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "MAV%u: parsing on main thread", unsigned(chan));
+    }
+#endif
+
     return true;
 }
 
+#if GCS_MAVLINK_RX_THREAD_ENABLED
+/*
+  start parsing this channel in a thread of its own, for links such as
+  a companion computer where parsing is a large part of the main loop
+ */
+bool GCS_MAVLINK::start_rx_thread()
+{
+    rx_queue = new ObjectBuffer<rx_packet>(GCS_MAVLINK_RX_QUEUE_LEN);
+    if (rx_queue == nullptr || rx_queue->get_size() < GCS_MAVLINK_RX_QUEUE_LEN) {
+        delete rx_queue;
+        rx_queue = nullptr;
+        return false;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&GCS_MAVLINK::rx_thread, void),
+                                      "MAVRX",
+                                      2048, AP_HAL::Scheduler::PRIORITY_UART, 0)) {
+        delete rx_queue;
+        rx_queue = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/*
+  parse bytes as they arrive and queue each message with its receive
+  time. When the queue is full the bytes are left in the UART until
+  the main thread catches up
+ */
+void GCS_MAVLINK::rx_thread()
+{
+    const bool have_event = _port->set_event_handle(&rx_event);
+    rx_packet pkt;
+    mavlink_status_t status;
+    // bytes read from the UART and not yet parsed
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint16_t buf_len = 0;
+    uint16_t buf_ofs = 0;
+
+    while (true) {
+        if (locked() || alternative.handler != nullptr) {
+            // the UART is in use by passthrough or is parsed on the
+            // main thread for an alternative protocol
+            buf_len = buf_ofs = 0;
+            hal.scheduler->delay(5);
+            continue;
+        }
+        if (rx_queue->space() == 0) {
+            // wait for the main thread
+            hal.scheduler->delay(1);
+        } else if (buf_ofs == buf_len && _port->available() == 0) {
+            if (have_event) {
+                rx_event.wait(10000);
+            } else {
+                hal.scheduler->delay(1);
+            }
+        }
+
+        WITH_SEMAPHORE(rx_sem);
+
+        if (locked() || alternative.handler != nullptr) {
+            continue;
+        }
+
+        while (rx_queue->space() > 0) {
+            if (buf_ofs == buf_len) {
+                const uint32_t nbytes = MIN(_port->available(), sizeof(buf));
+                const ssize_t n = nbytes > 0 ? _port->read(buf, nbytes) : 0;
+                if (n <= 0) {
+                    buf_len = buf_ofs = 0;
+                    break;
+                }
+                buf_len = n;
+                buf_ofs = 0;
+            }
+            // the parser shares the channel status with the sender
+            WITH_SEMAPHORE(comm_chan_lock(chan));
+            bool parsed;
+            buf_ofs += mavlink_parse_buffer(chan, &buf[buf_ofs], buf_len - buf_ofs, &pkt.msg, &status, parsed);
+            if (!parsed) {
+                continue;
+            }
+            // the rest of our buffer arrived after the message
+            pkt.receive_us = _port->receive_time_constraint_us(mavlink_frame_len(pkt.msg) + buf_len - buf_ofs);
+            if (pkt.receive_us == 0) {
+                pkt.receive_us = AP_HAL::micros64();
+            }
+            pkt.status_flags = status.flags;
+            if (!rx_queue->push(pkt)) {
+                break;
+            }
+        }
+    }
+}
+#endif // GCS_MAVLINK_RX_THREAD_ENABLED
+
 void GCS_MAVLINK::send_meminfo(void)
 {
     unsigned __brkval = 0;
@@ -678,22 +782,23 @@ void GCS_MAVLINK::handle_radio_status(const mavlink_message_t &msg, bool log_rad
     }
 
     last_txbuf = packet.txbuf;
+    send_budget.radio_status_ms = now;
 
-    // use the state of the transmit buffer in the radio to
-    // control the stream rate, giving us adaptive software
-    // flow control
-    if (packet.txbuf < 20 && stream_slowdown_ms < 2000) {
+    // use the state of the transmit buffer in the radio to scale the
+    // send budget for this link, giving us adaptive software flow
+    // control
+    if (packet.txbuf < 20) {
         // we are very low on space - slow down a lot
-        stream_slowdown_ms += 60;
-    } else if (packet.txbuf < 50 && stream_slowdown_ms < 2000) {
+        send_budget.rate_pct = MAX(send_budget.rate_pct * 7U / 10U, 10U);
+    } else if (packet.txbuf < 50) {
         // we are a bit low on space, slow down slightly
-        stream_slowdown_ms += 20;
-    } else if (packet.txbuf > 95 && stream_slowdown_ms > 200) {
+        send_budget.rate_pct = MAX(send_budget.rate_pct - 5, 10);
+    } else if (packet.txbuf > 95) {
         // the buffer has plenty of space, speed up a lot
-        stream_slowdown_ms -= 40;
-    } else if (packet.txbuf > 90 && stream_slowdown_ms != 0) {
+        send_budget.rate_pct = MIN(send_budget.rate_pct + 10, 100);
+    } else if (packet.txbuf > 90) {
         // the buffer has enough space, speed up a bit
-        stream_slowdown_ms -= 20;
+        send_budget.rate_pct = MIN(send_budget.rate_pct + 5, 100);
     }
 
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
@@ -894,8 +999,6 @@ uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t
 {
     uint32_t interval_ms = deferred.interval_ms;
 
-    interval_ms += stream_slowdown_ms;
-
     // slow most messages down if we're transfering parameters or
     // waypoints:
     if (_queued_parameter) {
@@ -1004,6 +1107,7 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
     void *data = hal.scheduler->disable_interrupts_save();
     uint32_t start_send_message_us = AP_HAL::micros();
 #endif
+    const uint16_t txspace_before = txspace();
     if (!try_send_message(id)) {
         // didn't fit in buffer...
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
@@ -1012,6 +1116,11 @@ bool GCS_MAVLINK::do_try_send_message(const ap_message id)
 #endif
         return false;
     }
+    // charge the bytes queued to the link budget
+    const uint16_t txspace_after = txspace();
+    if (txspace_after < txspace_before) {
+        send_budget.tokens -= txspace_before - txspace_after;
+    }
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     const uint32_t delta_us = AP_HAL::micros() - start_send_message_us;
     hal.scheduler->restore_interrupts(data);
@@ -1074,6 +1183,98 @@ int8_t GCS_MAVLINK::deferred_message_to_send_index(uint16_t now16_ms)
     return next_deferred_message_to_send_cache;
 }
 
+/*
+  estimated number of bytes per second this link can carry
+ */
+uint32_t GCS_MAVLINK::send_budget_bytes_per_second() const
+{
+    return MAX(_port->bw_in_kilobytes_per_second() * 1024U * send_budget.rate_pct / 100U, 1U);
+}
+
+/*
+  add tokens to the send budget for the time since the last update
+ */
+void GCS_MAVLINK::update_send_budget()
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - send_budget.radio_status_ms > 5000) {
+        // no radio reporting its buffer state
+        send_budget.rate_pct = 100;
+    }
+    const uint32_t bytes_per_second = send_budget_bytes_per_second();
+    const uint32_t dt_ms = MIN(now_ms - send_budget.last_update_ms, 1000U);
+    send_budget.last_update_ms = now_ms;
+
+    // allow bursts of up to 200ms of link time
+    const int32_t max_tokens = bytes_per_second / 5;
+    send_budget.tokens = MIN(send_budget.tokens + int32_t(bytes_per_second * dt_ms / 1000U), max_tokens);
+
+    if (send_budget.tokens < 0) {
+        stream_slowdown_ms = MIN(uint32_t(-send_budget.tokens) * 1000U / bytes_per_second, 2000U);
+    } else {
+        stream_slowdown_ms = 0;
+    }
+}
+
+/*
+  return true if the send budget has room for a message of the given
+  priority. Each step down in priority must leave 50ms of link time
+  in reserve for higher priority messages
+ */
+bool GCS_MAVLINK::send_budget_allows(SendPriority priority) const
+{
+    const int32_t reserve = send_budget_bytes_per_second() / 20;
+    return send_budget.tokens > reserve * int32_t(priority);
+}
+
+/*
+  priority of the messages in each stream when the link budget is
+  short
+ */
+GCS_MAVLINK::SendPriority GCS_MAVLINK::stream_priority(streams id)
+{
+    switch (id) {
+    case STREAM_EXTENDED_STATUS:
+    case STREAM_POSITION:
+    case STREAM_EXTRA1:
+        return SendPriority::HIGH;
+    case STREAM_EXTRA3:
+    case STREAM_PARAMS:
+        return SendPriority::LOW;
+    default:
+        return SendPriority::NORMAL;
+    }
+}
+
+/*
+  priority of a message, taken from the highest priority stream it
+  appears in. Messages not in any stream are normal priority
+ */
+GCS_MAVLINK::SendPriority GCS_MAVLINK::ap_message_priority(ap_message id)
+{
+    if (!ap_message_priorities_initialised) {
+        for (uint8_t i=0; all_stream_entries[i].ap_message_ids != nullptr; i++) {
+            const GCS_MAVLINK::stream_entries &entries = all_stream_entries[i];
+            const SendPriority priority = stream_priority(entries.stream_id);
+            for (uint8_t j=0; j<entries.num_ap_message_ids; j++) {
+                if (priority == SendPriority::HIGH) {
+                    high_priority_ap_message_ids.set(entries.ap_message_ids[j]);
+                } else if (priority == SendPriority::LOW) {
+                    low_priority_ap_message_ids.set(entries.ap_message_ids[j]);
+                }
+            }
+        }
+        ap_message_priorities_initialised = true;
+    }
+    if (high_priority_ap_message_ids.get(id)) {
+        return SendPriority::HIGH;
+    }
+    if (low_priority_ap_message_ids.get(id)) {
+        return SendPriority::LOW;
+    }
+    return SendPriority::NORMAL;
+}
+
 void GCS_MAVLINK::update_send()
 {
     if (!hal.scheduler->in_delay_callback()) {
@@ -1092,6 +1293,8 @@ void GCS_MAVLINK::update_send()
     uint32_t retry_deferred_body_start = AP_HAL::micros();
 #endif
 
+    update_send_budget();
+
     const uint32_t start = AP_HAL::millis();
     const uint16_t start16 = start & 0xFFFF;
     while (AP_HAL::millis() - start < 5) { // spend a max of 5ms sending messages.  This should never trigger - out_of_time() should become true
@@ -1156,7 +1359,15 @@ void GCS_MAVLINK::update_send()
 
         ap_message next = next_deferred_bucket_message_to_send(start16);
         if (next != no_message_to_send) {
-            if (!do_try_send_message(next)) {
+            const SendPriority priority = ap_message_priority(next);
+            if (!send_budget_allows(priority)) {
+                if (priority == SendPriority::HIGH) {
+                    // wait for the budget to recover
+                    break;
+                }
+                // skip this message for this pass of the bucket,
+                // leaving the budget for higher priority messages
+            } else if (!do_try_send_message(next)) {
                 break;
             }
             bucket_message_ids_to_send.clear(next);
@@ -1370,6 +1581,7 @@ void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
         // MAVLink2
         mavlink_status_t *cstatus = mavlink_get_channel_status(chan);
         if (cstatus != nullptr) {
+            WITH_SEMAPHORE(comm_chan_lock(chan));
             cstatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
         }
     }
@@ -1384,33 +1596,72 @@ void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
         // e.g. enforce-sysid says we shouldn't look at this packet
         return;
     }
+#ifdef ENABLE_SCRIPTING
+    AP_Scripting *scripting = AP_Scripting::get_singleton();
+    if (scripting != nullptr) {
+        scripting->handle_message_event(msg.msgid);
+    }
+#endif // ENABLE_SCRIPTING
     handleMessage(msg);
 }
 
-void
-GCS_MAVLINK::update_receive(uint32_t max_time_us)
+void GCS_MAVLINK::handle_parsed_packet(const mavlink_status_t &status, const mavlink_message_t &msg, uint32_t now_ms)
 {
-    // do absolutely nothing if we are locked
-    if (locked()) {
-        return;
-    }
+    hal.util->persistent_data.last_mavlink_msgid = msg.msgid;
+    packetReceived(status, msg);
+    gcs_alternative_active[chan] = false;
+    alternative.last_mavlink_ms = now_ms;
+    hal.util->persistent_data.last_mavlink_msgid = 0;
+}
 
-    // receive new packets
+/*
+  parse bytes from the UART on the main thread, handling messages as
+  they complete
+ */
+void GCS_MAVLINK::update_receive_parse(uint32_t tstart_us, uint32_t max_time_us)
+{
     mavlink_message_t msg;
     mavlink_status_t status;
-    uint32_t tstart_us = AP_HAL::micros();
     uint32_t now_ms = AP_HAL::millis();
 
     status.packet_rx_drop_count = 0;
 
+    if (alternative.handler == nullptr) {
+        // parse whole frames from blocks of bytes. The time limit is
+        // only checked between blocks so no bytes are lost
+        uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+        uint32_t nbytes = _port->available();
+        while (nbytes > 0) {
+            const ssize_t n = _port->read(buf, MIN(nbytes, sizeof(buf)));
+            if (n <= 0) {
+                break;
+            }
+            nbytes -= MIN(nbytes, uint32_t(n));
+            uint16_t ofs = 0;
+            while (ofs < n) {
+                bool parsed;
+                ofs += mavlink_parse_buffer(chan, &buf[ofs], n - ofs, &msg, &status, parsed);
+                if (parsed) {
+                    // the rest of our buffer arrived after the message
+                    rx_packet_receive_us = _port->receive_time_constraint_us(mavlink_frame_len(msg) + n - ofs);
+                    handle_parsed_packet(status, msg, now_ms);
+                    rx_packet_receive_us = 0;
+                }
+            }
+            if (AP_HAL::micros() - tstart_us > max_time_us) {
+                break;
+            }
+        }
+        return;
+    }
+
     const uint16_t nbytes = _port->available();
     for (uint16_t i=0; i<nbytes; i++)
     {
         const uint8_t c = (uint8_t)_port->read();
         const uint32_t protocol_timeout = 4000;
         
-        if (alternative.handler &&
-            now_ms - alternative.last_mavlink_ms > protocol_timeout) {
+        if (now_ms - alternative.last_mavlink_ms > protocol_timeout) {
             /*
               we have an alternative protocol handler installed and we
               haven't parsed a MAVLink packet for 4 seconds. Try
@@ -1434,12 +1685,8 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
 
         // Try to get a new message
         if (mavlink_parse_char(chan, c, &msg, &status)) {
-            hal.util->persistent_data.last_mavlink_msgid = msg.msgid;
-            packetReceived(status, msg);
+            handle_parsed_packet(status, msg, now_ms);
             parsed_packet = true;
-            gcs_alternative_active[chan] = false;
-            alternative.last_mavlink_ms = now_ms;
-            hal.util->persistent_data.last_mavlink_msgid = 0;
         }
 
         if (parsed_packet || i % 100 == 0) {
@@ -1449,11 +1696,53 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
             }
         }
     }
+}
+
+void
+GCS_MAVLINK::update_receive(uint32_t max_time_us)
+{
+    // do absolutely nothing if we are locked
+    if (locked()) {
+        return;
+    }
+
+    const uint32_t tstart_us = AP_HAL::micros();
+
+#if GCS_MAVLINK_RX_THREAD_ENABLED
+    if (rx_queue != nullptr) {
+        // handle the messages parsed by the receive thread in place
+        // in the queue
+        mavlink_status_t status {};
+        const uint32_t now_ms = AP_HAL::millis();
+        uint32_t n;
+        const rx_packet *pkt;
+        while ((pkt = rx_queue->readptr(n)) != nullptr) {
+            status.flags = pkt->status_flags;
+            rx_packet_receive_us = pkt->receive_us;
+            handle_parsed_packet(status, pkt->msg, now_ms);
+            rx_packet_receive_us = 0;
+            rx_queue->pop();
+            if (AP_HAL::micros() - tstart_us > max_time_us) {
+                break;
+            }
+        }
+        if (alternative.handler != nullptr) {
+            // alternative protocols are parsed here, the thread
+            // leaves the UART to us
+            WITH_SEMAPHORE(rx_sem);
+            update_receive_parse(tstart_us, max_time_us);
+        }
+    } else
+#endif
+    {
+        update_receive_parse(tstart_us, max_time_us);
+    }
 
     const uint32_t tnow = AP_HAL::millis();
 
-    // send a timesync message every 10 seconds; this is for data
-    // collection purposes
+    // send a timesync message every second; the responses are
+    // logged and track the clock of the system sending us
+    // timestamped data
     if (tnow - _timesync_request.last_sent_ms > _timesync_request.interval_ms && !is_private()) {
         if (HAVE_PAYLOAD_SPACE(chan, TIMESYNC)) {
             send_timesync();
@@ -2849,9 +3138,18 @@ MAV_RESULT GCS_MAVLINK::handle_rc_bind(const mavlink_command_long_t &packet)
     return MAV_RESULT_ACCEPTED;
 }
 
+uint64_t GCS_MAVLINK::receive_time_constraint_us(uint16_t packet_len) const
+{
+    if (rx_packet_receive_us != 0) {
+        // the UART has moved on since the message was parsed
+        return rx_packet_receive_us;
+    }
+    return _port->receive_time_constraint_us(packet_len);
+}
+
 uint64_t GCS_MAVLINK::timesync_receive_timestamp_ns() const
 {
-    uint64_t ret = _port->receive_time_constraint_us(PAYLOAD_SIZE(chan, TIMESYNC));
+    uint64_t ret = receive_time_constraint_us(PAYLOAD_SIZE(chan, TIMESYNC));
     if (ret == 0) {
         ret = AP_HAL::micros64();
     }
@@ -2882,7 +3180,12 @@ void GCS_MAVLINK::handle_timesync(const mavlink_message_t &msg)
             // response to an ancient request...
             return;
         }
-        const uint64_t round_trip_time_us = (timesync_receive_timestamp_ns() - _timesync_request.sent_ts1)*0.001f;
+        const uint64_t receive_time_ns = timesync_receive_timestamp_ns();
+        const uint64_t round_trip_time_us = (receive_time_ns - _timesync_request.sent_ts1)*0.001f;
+        const bool clock_synced = (msg.sysid == clock_sync_sysid);
+        if (clock_synced) {
+            clock_sync.add_exchange(_timesync_request.sent_ts1 / 1000U, receive_time_ns / 1000U, tsync.tc1 / 1000U);
+        }
 #if 0
         gcs().send_text(MAV_SEVERITY_INFO,
                         "timesync response sysid=%u (latency=%fms)",
@@ -2893,13 +3196,15 @@ void GCS_MAVLINK::handle_timesync(const mavlink_message_t &msg)
         if (logger != nullptr) {
             AP::logger().Write(
                 "TSYN",
-                "TimeUS,SysID,RTT",
-                "s-s",
-                "F-F",
-                "QBQ",
+                "TimeUS,SysID,RTT,Off,Drift",
+                "s-ss-",
+                "F-FF-",
+                "QBQqf",
                 AP_HAL::micros64(),
                 msg.sysid,
-                round_trip_time_us
+                round_trip_time_us,
+                clock_synced ? clock_sync.get_offset_usec() : 0,
+                clock_synced ? clock_sync.get_drift_ppm() : 0.0f
                 );
         }
         return;
@@ -3104,7 +3409,7 @@ void GCS_MAVLINK::handle_vision_position_estimate(const mavlink_message_t &msg)
     mavlink_vision_position_estimate_t m;
     mavlink_msg_vision_position_estimate_decode(&msg, &m);
 
-    handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
+    handle_common_vision_position_estimate_data(msg, m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
                                                 PAYLOAD_SIZE(chan, VISION_POSITION_ESTIMATE));
 }
 
@@ -3113,7 +3418,7 @@ void GCS_MAVLINK::handle_global_vision_position_estimate(const mavlink_message_t
     mavlink_global_vision_position_estimate_t m;
     mavlink_msg_global_vision_position_estimate_decode(&msg, &m);
 
-    handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
+    handle_common_vision_position_estimate_data(msg, m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
                                                 PAYLOAD_SIZE(chan, GLOBAL_VISION_POSITION_ESTIMATE));
 }
 
@@ -3123,14 +3428,15 @@ void GCS_MAVLINK::handle_vicon_position_estimate(const mavlink_message_t &msg)
     mavlink_msg_vicon_position_estimate_decode(&msg, &m);
 
     // vicon position estimate does not include reset counter
-    handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, 0,
+    handle_common_vision_position_estimate_data(msg, m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, 0,
                                                 PAYLOAD_SIZE(chan, VICON_POSITION_ESTIMATE));
 }
 
 // there are several messages which all have identical fields in them.
 // This function provides common handling for the data contained in
 // these packets
-void GCS_MAVLINK::handle_common_vision_position_estimate_data(const uint64_t usec,
+void GCS_MAVLINK::handle_common_vision_position_estimate_data(const mavlink_message_t &msg,
+                                                              const uint64_t usec,
                                                               const float x,
                                                               const float y,
                                                               const float z,
@@ -3145,7 +3451,7 @@ void GCS_MAVLINK::handle_common_vision_position_estimate_data(const uint64_t use
     float posErr = 0;
     float angErr = 0;
     // correct offboard timestamp to be in local ms since boot
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(usec, payload_size);
+    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(msg, usec, payload_size);
 
     AP_VisualOdom *visual_odom = AP::visualodom();
     if (visual_odom == nullptr) {
@@ -3168,7 +3474,7 @@ void GCS_MAVLINK::handle_att_pos_mocap(const mavlink_message_t &msg)
     mavlink_msg_att_pos_mocap_decode(&msg, &m);
 
     // correct offboard timestamp to be in local ms since boot
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, ATT_POS_MOCAP));
+    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(msg, m.time_usec, PAYLOAD_SIZE(chan, ATT_POS_MOCAP));
    
     AP_VisualOdom *visual_odom = AP::visualodom();
     if (visual_odom == nullptr) {
@@ -3189,11 +3495,42 @@ void GCS_MAVLINK::handle_vision_speed_estimate(const mavlink_message_t &msg)
     mavlink_vision_speed_estimate_t m;
     mavlink_msg_vision_speed_estimate_decode(&msg, &m);
     const Vector3f vel = {m.x, m.y, m.z};
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(m.usec, PAYLOAD_SIZE(chan, VISION_SPEED_ESTIMATE));
+    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(msg, m.usec, PAYLOAD_SIZE(chan, VISION_SPEED_ESTIMATE));
     visual_odom->handle_vision_speed_estimate(m.usec, timestamp_ms, vel, m.reset_counter);
 #endif
 }
 
+void GCS_MAVLINK::handle_odometry(const mavlink_message_t &msg)
+{
+#if HAL_VISUALODOM_ENABLED
+    AP_VisualOdom *visual_odom = AP::visualodom();
+    if (visual_odom == nullptr) {
+        return;
+    }
+    mavlink_odometry_t m;
+    mavlink_msg_odometry_decode(&msg, &m);
+
+    // only a body frame relative to a local frame is understood
+    if (m.frame_id != MAV_FRAME_LOCAL_FRD || m.child_frame_id != MAV_FRAME_BODY_FRD) {
+        return;
+    }
+    const uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(msg, m.time_usec, PAYLOAD_SIZE(chan, ODOMETRY));
+    if (isnan(m.q[0])) {
+        return;
+    }
+    const Quaternion q(m.q[0], m.q[1], m.q[2], m.q[3]);
+    visual_odom->handle_vision_position_estimate(m.time_usec, timestamp_ms, m.x, m.y, m.z, q, m.reset_counter);
+
+    if (!isnan(m.vx)) {
+        // velocity is in the body frame, the speed estimate is in the local frame
+        Matrix3f rot;
+        q.rotation_matrix(rot);
+        const Vector3f vel = rot * Vector3f(m.vx, m.vy, m.vz);
+        visual_odom->handle_vision_speed_estimate(m.time_usec, timestamp_ms, vel, m.reset_counter);
+    }
+#endif
+}
+
 void GCS_MAVLINK::handle_command_ack(const mavlink_message_t &msg)
 {
     AP_AccelCal *accelcal = AP::ins().get_acal();
@@ -3507,6 +3844,10 @@ void GCS_MAVLINK::handle_common_message(const mavlink_message_t &msg)
         handle_vision_speed_estimate(msg);
         break;
 
+    case MAVLINK_MSG_ID_ODOMETRY:
+        handle_odometry(msg);
+        break;
+
     case MAVLINK_MSG_ID_SYSTEM_TIME:
         handle_system_time_message(msg);
         break;
@@ -4347,7 +4688,7 @@ void GCS_MAVLINK::handle_landing_target(const mavlink_message_t &msg)
     mavlink_landing_target_t m;
     mavlink_msg_landing_target_decode(&msg, &m);
     // correct offboard timestamp
-    const uint32_t corrected_ms = correct_offboard_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, LANDING_TARGET));
+    const uint32_t corrected_ms = correct_offboard_timestamp_usec_to_ms(msg, m.time_usec, PAYLOAD_SIZE(chan, LANDING_TARGET));
     handle_landing_target(m, corrected_ms);
 }
 
@@ -5201,17 +5542,19 @@ bool GCS_MAVLINK::get_default_interval_for_mavlink_message_id(const uint32_t mav
 
 /*
   correct an offboard timestamp in microseconds into a local timestamp
-  since boot in milliseconds. See the JitterCorrection code for details
+  since boot in milliseconds. Once TIMESYNC exchanges with the sender
+  have given its clock offset that is used, otherwise see the
+  JitterCorrection code for details
 
   Return a value in milliseconds since boot (for use by the EKF)
  */
-uint32_t GCS_MAVLINK::correct_offboard_timestamp_usec_to_ms(uint64_t offboard_usec, uint16_t payload_size)
+uint32_t GCS_MAVLINK::correct_offboard_timestamp_usec_to_ms(const mavlink_message_t &msg, uint64_t offboard_usec, uint16_t payload_size)
 {
     uint64_t local_us;
     // if the HAL supports it then constrain the latest possible time
     // the packet could have been sent by the uart receive time and
     // the baudrate and packet size.
-    uint64_t uart_receive_time = _port->receive_time_constraint_us(payload_size);
+    uint64_t uart_receive_time = receive_time_constraint_us(payload_size);
     if (uart_receive_time != 0) {
         local_us = uart_receive_time;
     } else {
@@ -5219,6 +5562,16 @@ uint32_t GCS_MAVLINK::correct_offboard_timestamp_usec_to_ms(uint64_t offboard_us
     }
     uint64_t corrected_us = lag_correction.correct_offboard_timestamp_usec(offboard_usec, local_us);
 
+    if (msg.sysid != clock_sync_sysid && !clock_sync.converged(local_us)) {
+        // follow the clock of whoever is sending us timestamped data
+        clock_sync_sysid = msg.sysid;
+        clock_sync.reset();
+    }
+    if (msg.sysid == clock_sync_sysid && clock_sync.converged(local_us)) {
+        // the message can't have been sent after it arrived
+        corrected_us = MIN(clock_sync.remote_to_local_usec(offboard_usec), local_us);
+    }
+
     return corrected_us / 1000U;
 }
 
@@ -172,6 +172,134 @@ void GCS_MAVLINK::ftp_push_replies(pending_ftp &reply)
     }
 }
 
+/*
+  find the open session for a request
+ */
+struct GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_find_session(const struct pending_ftp &request)
+{
+    for (auto &s : ftp.sessions) {
+        if (s.fd != -1 &&
+            s.session == request.session &&
+            s.sysid == request.sysid &&
+            s.compid == request.compid) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  allocate a session slot for a request, reclaiming a slot that has
+  been idle for longer than the session timeout if needed. The caller
+  opens the file
+ */
+struct GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_open_session(const struct pending_ftp &request, uint32_t now_ms)
+{
+    struct ftp_session *slot = nullptr;
+    for (auto &s : ftp.sessions) {
+        if (s.fd == -1) {
+            slot = &s;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        for (auto &s : ftp.sessions) {
+            if (now_ms - s.last_activity_ms >= FTP_SESSION_TIMEOUT) {
+                // the client has gone away without closing the file
+                ftp_close_session(s);
+                slot = &s;
+                break;
+            }
+        }
+    }
+    if (slot == nullptr) {
+        return nullptr;
+    }
+    slot->session = request.session;
+    slot->sysid = request.sysid;
+    slot->compid = request.compid;
+    slot->last_activity_ms = now_ms;
+    slot->readahead_offset = 0;
+    slot->readahead_len = 0;
+    return slot;
+}
+
+void GCS_MAVLINK::ftp_close_session(struct ftp_session &session)
+{
+    if (session.fd != -1) {
+        AP::FS().close(session.fd);
+        session.fd = -1;
+    }
+    delete[] session.readahead;
+    session.readahead = nullptr;
+    session.readahead_len = 0;
+}
+
+// NAK a request for a session that doesn't exist
+void GCS_MAVLINK::ftp_no_session_error(struct pending_ftp &response)
+{
+    for (const auto &s : ftp.sessions) {
+        if (s.fd != -1) {
+            // there are open files, but not for this session
+            ftp_error(response, FTP_ERROR::InvalidSession);
+            return;
+        }
+    }
+    ftp_error(response, FTP_ERROR::FileNotFound);
+}
+
+/*
+  read from an open file at the given offset, using the session
+  read-ahead buffer if available so that small sequential reads don't
+  each go to the filesystem
+ */
+ssize_t GCS_MAVLINK::ftp_read(struct ftp_session &session, uint32_t offset, uint8_t *data, uint16_t len)
+{
+    if (session.readahead == nullptr) {
+        if (AP::FS().lseek(session.fd, offset, SEEK_SET) == -1) {
+            return -1;
+        }
+        return AP::FS().read(session.fd, data, len);
+    }
+
+    if (offset < session.readahead_offset ||
+        offset + len > session.readahead_offset + session.readahead_len) {
+        // refill the buffer starting at the requested offset
+        session.readahead_len = 0;
+        if (AP::FS().lseek(session.fd, offset, SEEK_SET) == -1) {
+            return -1;
+        }
+        const ssize_t read_bytes = AP::FS().read(session.fd, session.readahead, GCS_FTP_READAHEAD_SIZE);
+        if (read_bytes == -1) {
+            return -1;
+        }
+        session.readahead_offset = offset;
+        session.readahead_len = read_bytes;
+    }
+
+    const uint32_t ofs = offset - session.readahead_offset;
+    if (ofs >= session.readahead_len) {
+        return 0;
+    }
+    const uint16_t n = MIN(uint32_t(len), session.readahead_len - ofs);
+    memcpy(data, &session.readahead[ofs], n);
+    return n;
+}
+
+/*
+  number of packets to send for a burst read. Fast links get a deeper
+  burst so fewer round trips are needed
+ */
+uint16_t GCS_MAVLINK::ftp_burst_size(mavlink_channel_t chan)
+{
+    const GCS_MAVLINK *link = gcs().chan(chan);
+    if (link != nullptr && link->_port != nullptr &&
+        link->_port->bw_in_kilobytes_per_second() >= 200) {
+        return 500;
+    }
+    return 100;
+}
+
 void GCS_MAVLINK::ftp_worker(void) {
     pending_ftp request;
     pending_ftp reply = {};
@@ -210,351 +338,343 @@ void GCS_MAVLINK::ftp_worker(void) {
 
         uint32_t now = AP_HAL::millis();
 
-        // check for session termination
-        if (request.session != ftp.current_session &&
-            (request.opcode == FTP_OP::TerminateSession || request.opcode == FTP_OP::ResetSessions)) {
-            // terminating a different session, just ack
-            reply.opcode = FTP_OP::Ack;
-        } else if (ftp.fd != -1 && request.session != ftp.current_session &&
-                   now - ftp.last_send_ms < FTP_SESSION_TIMEOUT) {
-            // if we have an open file and the session isn't right
-            // then reject. This prevents IO on the wrong file
-            ftp_error(reply, FTP_ERROR::InvalidSession);
-        } else {
-            if (ftp.fd != -1 &&
-                request.session != ftp.current_session &&
-                now - ftp.last_send_ms >= FTP_SESSION_TIMEOUT) {
-                // if a new session appears and the old session has
-                // been idle for more than the timeout then force
-                // close the old session
-                AP::FS().close(ftp.fd);
-                ftp.fd = -1;
-                ftp.current_session = -1;
-            }
-            // dispatch the command as needed
-            switch (request.opcode) {
-                case FTP_OP::None:
-                    reply.opcode = FTP_OP::Ack;
-                    break;
-                case FTP_OP::TerminateSession:
-                case FTP_OP::ResetSessions:
-                    // we already handled this, just listed for completeness
-                    if (ftp.fd != -1) {
-                        AP::FS().close(ftp.fd);
-                        ftp.fd = -1;
-                    }
-                    ftp.current_session = -1;
-                    reply.opcode = FTP_OP::Ack;
-                    break;
-                case FTP_OP::ListDirectory:
-                    ftp_list_dir(request, reply);
-                    break;
-                case FTP_OP::OpenFileRO:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1 && now - ftp.last_send_ms > FTP_SESSION_TIMEOUT) {
-                            // no activity for 3s, assume client has
-                            // timed out receiving open reply, close
-                            // the file
-                            AP::FS().close(ftp.fd);
-                            ftp.fd = -1;
-                            ftp.current_session = -1;
-                        }
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+        struct ftp_session *session = ftp_find_session(request);
+        uint32_t session_idle_ms = 0;
+        if (session != nullptr) {
+            session_idle_ms = now - session->last_activity_ms;
+            session->last_activity_ms = now;
+        }
 
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
+        // dispatch the command as needed
+        switch (request.opcode) {
+            case FTP_OP::None:
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::TerminateSession:
+                if (session != nullptr) {
+                    ftp_close_session(*session);
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ResetSessions:
+                // close all files opened by this system and component
+                for (auto &s : ftp.sessions) {
+                    if (s.fd != -1 && s.sysid == request.sysid && s.compid == request.compid) {
+                        ftp_close_session(s);
+                    }
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ListDirectory:
+                ftp_list_dir(request, reply);
+                break;
+            case FTP_OP::OpenFileRO:
+                {
+                    // only allow one file to be open per session
+                    if (session != nullptr && session_idle_ms > FTP_SESSION_TIMEOUT) {
+                        // no activity for 3s, assume client has
+                        // timed out receiving open reply, close
+                        // the file
+                        ftp_close_session(*session);
+                        session = nullptr;
+                    }
+                    if (session != nullptr) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // get the file size
-                        struct stat st;
-                        if (AP::FS().stat((char *)request.data, &st)) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        const size_t file_size = st.st_size;
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data, 0);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Read;
-                        ftp.current_session = request.session;
+                    // get the file size
+                    struct stat st;
+                    if (AP::FS().stat((char *)request.data, &st)) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    const size_t file_size = st.st_size;
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, (uint32_t)file_size);
+                    session = ftp_open_session(request, now);
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+                        break;
+                    }
 
-                        // provide compatibility with old protocol banner download
-                        if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
-                            ftp.need_banner_send_mask |= 1U<<reply.chan;
-                        }
+                    // actually open the file
+                    session->fd = AP::FS().open((char *)request.data, 0);
+                    if (session->fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::ReadFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
+                    session->mode = FTP_FILE_MODE::Read;
+#if GCS_FTP_READAHEAD_SIZE > 0
+                    // downloads work without read-ahead if we are low on memory
+                    session->readahead = new uint8_t[GCS_FTP_READAHEAD_SIZE];
+#endif
 
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                    reply.opcode = FTP_OP::Ack;
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, (uint32_t)file_size);
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // provide compatibility with old protocol banner download
+                    if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
+                        ftp.need_banner_send_mask |= 1U<<reply.chan;
+                    }
+                    break;
+                }
+            case FTP_OP::ReadFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
+                        break;
+                    }
 
-                        // fill the buffer
-                        const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, request.size);
-                        if (read_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        if (read_bytes == 0) {
-                            ftp_error(reply, FTP_ERROR::EndOfFile);
-                            break;
-                        }
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
-                        reply.size = (uint8_t)read_bytes;
+                    // fill the buffer
+                    const ssize_t read_bytes = ftp_read(*session, request.offset, reply.data, request.size);
+                    if (read_bytes == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    if (read_bytes == 0) {
+                        ftp_error(reply, FTP_ERROR::EndOfFile);
                         break;
                     }
-                case FTP_OP::Ack:
-                case FTP_OP::Nack:
-                    // eat these, we just didn't expect them
-                    continue;
+
+                    reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    reply.size = (uint8_t)read_bytes;
                     break;
-                case FTP_OP::OpenFileWO:
-                case FTP_OP::CreateFile:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                }
+            case FTP_OP::Ack:
+            case FTP_OP::Nack:
+                // eat these, we just didn't expect them
+                continue;
+                break;
+            case FTP_OP::OpenFileWO:
+            case FTP_OP::CreateFile:
+                {
+                    // only allow one file to be open per session
+                    if (session != nullptr) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data,
-                                               (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Write;
-                        ftp.current_session = request.session;
+                    session = ftp_open_session(request, now);
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
+                    // actually open the file
+                    session->fd = AP::FS().open((char *)request.data,
+                                                (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
+                    if (session->fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::WriteFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
+                    session->mode = FTP_FILE_MODE::Write;
 
-                        // must have the file in write mode
-                        if ((ftp.mode != FTP_FILE_MODE::Write)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::WriteFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
+                        break;
+                    }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // must have the file in write mode
+                    if ((session->mode != FTP_FILE_MODE::Write)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        // fill the buffer
-                        const ssize_t write_bytes = AP::FS().write(ftp.fd, request.data, request.size);
-                        if (write_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // seek to requested offset
+                    if (AP::FS().lseek(session->fd, request.offset, SEEK_SET) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
+                    // fill the buffer
+                    const ssize_t write_bytes = AP::FS().write(session->fd, request.data, request.size);
+                    if (write_bytes == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::CreateDirectory:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    break;
+                }
+            case FTP_OP::CreateDirectory:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // actually make the directory
-                        if (AP::FS().mkdir((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        reply.opcode = FTP_OP::Ack;
+                    // actually make the directory
+                    if (AP::FS().mkdir((char *)request.data) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::RemoveDirectory:
-                case FTP_OP::RemoveFile:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::RemoveDirectory:
+            case FTP_OP::RemoveFile:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // remove the file/dir
-                        if (AP::FS().unlink((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        reply.opcode = FTP_OP::Ack;
+                    // remove the file/dir
+                    if (AP::FS().unlink((char *)request.data) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::CalcFileCRC32:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::CalcFileCRC32:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // actually open the file
-                        int fd = AP::FS().open((char *)request.data, O_RDONLY);
-                        if (fd == -1) {
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
+                    // actually open the file
+                    int fd = AP::FS().open((char *)request.data, O_RDONLY);
+                    if (fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+
+                    uint32_t checksum = 0;
+                    ssize_t read_size;
+                    do {
+                        read_size = AP::FS().read(fd, reply.data, sizeof(reply.data));
+                        if (read_size == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
                         }
+                        checksum = crc_crc32(checksum, reply.data, MIN((size_t)read_size, sizeof(reply.data)));
+                    } while (read_size > 0);
 
-                        uint32_t checksum = 0;
-                        ssize_t read_size;
-                        do {
-                            read_size = AP::FS().read(fd, reply.data, sizeof(reply.data));
-                            if (read_size == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-                            checksum = crc_crc32(checksum, reply.data, MIN((size_t)read_size, sizeof(reply.data)));
-                        } while (read_size > 0);
-
-                        AP::FS().close(fd);
-
-                        // reset our scratch area so we don't leak data, and can leverage trimming
-                        memset(reply.data, 0, sizeof(reply.data));
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, checksum);
-                        reply.opcode = FTP_OP::Ack;
+                    AP::FS().close(fd);
+
+                    // reset our scratch area so we don't leak data, and can leverage trimming
+                    memset(reply.data, 0, sizeof(reply.data));
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, checksum);
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::BurstReadFile:
+                {
+                    const uint16_t max_read = (request.size == 0?sizeof(reply.data):request.size);
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
                         break;
                     }
-                case FTP_OP::BurstReadFile:
-                    {
-                        const uint16_t max_read = (request.size == 0?sizeof(reply.data):request.size);
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
 
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
+                    uint32_t read_offset = request.offset;
+                    const uint16_t transfer_size = ftp_burst_size(request.chan);
+                    for (uint16_t i = 0; (i < transfer_size); i++) {
+                        // fill the buffer
+                        const ssize_t read_bytes = ftp_read(*session, read_offset, reply.data, max_read);
+                        if (read_bytes == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
                         }
 
-                        const uint32_t transfer_size = 100;
-                        for (uint32_t i = 0; (i < transfer_size); i++) {
-                            // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, max_read);
-                            if (read_bytes == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-
-                            if (read_bytes != sizeof(reply.data)) {
-                                // don't send any old data
-                                memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
-                            }
-
-                            if (read_bytes == 0) {
-                                ftp_error(reply, FTP_ERROR::EndOfFile);
-                                break;
-                            }
-
-                            reply.opcode = FTP_OP::Ack;
-                            reply.offset = request.offset + i * max_read;
-                            reply.burst_complete = (i == (transfer_size - 1));
-                            reply.size = (uint8_t)read_bytes;
-
-                            ftp_push_replies(reply);
-
-                            if (read_bytes < max_read) {
-                                // ensure the NACK which we send next is at the right offset
-                                reply.offset += read_bytes;
-                            }
-
-                            // prep the reply to be used again
-                            reply.seq_number++;
+                        if (read_bytes != sizeof(reply.data)) {
+                            // don't send any old data
+                            memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
                         }
 
-                        if (reply.opcode != FTP_OP::Nack) {
-                            // prevent a duplicate packet send for
-                            // normal replies of burst reads
-                            skip_push_reply = true;
+                        if (read_bytes == 0) {
+                            ftp_error(reply, FTP_ERROR::EndOfFile);
+                            break;
                         }
-                        break;
+
+                        reply.opcode = FTP_OP::Ack;
+                        reply.offset = read_offset;
+                        reply.burst_complete = (i == (transfer_size - 1));
+                        reply.size = (uint8_t)read_bytes;
+
+                        ftp_push_replies(reply);
+
+                        // ensure the NACK which we send next is at the right offset
+                        read_offset += read_bytes;
+                        reply.offset = read_offset;
+
+                        // prep the reply to be used again
+                        reply.seq_number++;
+                    }
+
+                    if (reply.opcode != FTP_OP::Nack) {
+                        // prevent a duplicate packet send for
+                        // normal replies of burst reads
+                        skip_push_reply = true;
                     }
-                case FTP_OP::TruncateFile:
-                case FTP_OP::Rename:
-                default:
-                    // this was bad data, just nack it
-                    gcs().send_text(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
-                    ftp_error(reply, FTP_ERROR::Fail);
                     break;
-            }
+                }
+            case FTP_OP::TruncateFile:
+            case FTP_OP::Rename:
+            default:
+                // this was bad data, just nack it
+                gcs().send_text(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
+                ftp_error(reply, FTP_ERROR::Fail);
+                break;
         }
+    }
 
         if (!skip_push_reply) {
             ftp_push_replies(reply);
@@ -27,6 +27,30 @@ This provides some support code and variables for MAVLink enabled sketches
 
 extern const AP_HAL::HAL& hal;
 
+/*
+  use our own SHA-256 for signing, which can use the hash unit of the
+  board, in place of the one in the generated headers
+ */
+#include <AP_Math/sha256.h>
+#include <AP_Math/crc.h>
+#define HAVE_MAVLINK_SHA256
+typedef sha256_ctx mavlink_sha256_ctx;
+
+static inline void mavlink_sha256_init(mavlink_sha256_ctx *m)
+{
+    sha256_init(*m);
+}
+
+static inline void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v, uint32_t len)
+{
+    sha256_update(*m, v, len);
+}
+
+static inline void mavlink_sha256_final_48(mavlink_sha256_ctx *m, uint8_t result[6])
+{
+    sha256_final(*m, result, 6);
+}
+
 #ifdef MAVLINK_SEPARATE_HELPERS
 // Shut up warnings about missing declarations; TODO: should be fixed on
 // mavlink/pymavlink project for when MAVLINK_SEPARATE_HELPERS is defined
@@ -39,9 +63,187 @@ extern const AP_HAL::HAL& hal;
 AP_HAL::UARTDriver	*mavlink_comm_port[MAVLINK_COMM_NUM_BUFFERS];
 bool gcs_alternative_active[MAVLINK_COMM_NUM_BUFFERS];
 
+/*
+  find the first MAVLink2 or MAVLink1 start byte
+ */
+static const uint8_t *find_stx(const uint8_t *buf, uint16_t len)
+{
+    const uint8_t *stx = (const uint8_t *)memchr(buf, MAVLINK_STX, len);
+    const uint8_t *stx1 = (const uint8_t *)memchr(buf, MAVLINK_STX_MAVLINK1, stx != nullptr ? stx - buf : len);
+    return stx1 != nullptr ? stx1 : stx;
+}
+
+/*
+  check and decode a whole frame starting with a start byte, giving
+  the same result as mavlink_frame_char() would, then update the
+  channel status the same way
+ */
+static uint8_t parse_frame(mavlink_status_t *status, const uint8_t *frame,
+                           mavlink_message_t *msg, mavlink_status_t *r_status)
+{
+    const bool v1 = frame[0] == MAVLINK_STX_MAVLINK1;
+    const uint8_t header_len = 1 + (v1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN);
+    const uint8_t len = frame[1];
+
+    msg->magic = frame[0];
+    msg->len = len;
+    if (v1) {
+        status->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        msg->incompat_flags = 0;
+        msg->compat_flags = 0;
+        msg->seq = frame[2];
+        msg->sysid = frame[3];
+        msg->compid = frame[4];
+        msg->msgid = frame[5];
+    } else {
+        status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        msg->incompat_flags = frame[2];
+        msg->compat_flags = frame[3];
+        msg->seq = frame[4];
+        msg->sysid = frame[5];
+        msg->compid = frame[6];
+        msg->msgid = frame[7] | (frame[8]<<8) | (uint32_t(frame[9])<<16);
+    }
+
+    const mavlink_msg_entry_t *e = mavlink_get_msg_entry(msg->msgid);
+    const uint8_t crc_extra = e ? e->crc_extra : 0;
+
+    // the CRC covers the header after the start byte and the payload
+    uint16_t crc = crc16_mcrf4xx(0xFFFF, &frame[1], header_len - 1 + len);
+    crc = crc16_mcrf4xx(crc, &crc_extra, 1);
+
+    const uint8_t *payload = &frame[header_len];
+    memcpy(_MAV_PAYLOAD_NON_CONST(msg), payload, len);
+    if (e && len < e->max_msg_len) {
+        // zero-fill truncated MAVLink2 payloads
+        memset(&_MAV_PAYLOAD_NON_CONST(msg)[len], 0, e->max_msg_len - len);
+    }
+    msg->ck[0] = payload[len];
+    msg->ck[1] = payload[len+1];
+    msg->checksum = crc;
+
+    uint8_t result = (msg->ck[0] | (msg->ck[1]<<8)) == crc ? MAVLINK_FRAMING_OK : MAVLINK_FRAMING_BAD_CRC;
+
+    mavlink_signing_t *signing = status->signing;
+    if (msg->incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        memcpy(msg->signature, &payload[len+MAVLINK_NUM_CHECKSUM_BYTES], MAVLINK_SIGNATURE_BLOCK_LEN);
+        if (result == MAVLINK_FRAMING_OK) {
+            bool sig_ok = mavlink_signature_check(signing, status->signing_streams, msg);
+            if (!sig_ok && signing != nullptr &&
+                signing->accept_unsigned_callback != nullptr &&
+                signing->accept_unsigned_callback(status, msg->msgid)) {
+                // accepted via application level override
+                sig_ok = true;
+            }
+            if (!sig_ok) {
+                result = MAVLINK_FRAMING_BAD_SIGNATURE;
+            }
+        }
+    } else if (signing != nullptr && result == MAVLINK_FRAMING_OK &&
+               (signing->accept_unsigned_callback == nullptr ||
+                !signing->accept_unsigned_callback(status, msg->msgid))) {
+        result = MAVLINK_FRAMING_BAD_SIGNATURE;
+    }
+
+    if (result != MAVLINK_FRAMING_OK) {
+        status->parse_error++;
+        return result;
+    }
+
+    status->current_rx_seq = msg->seq;
+    // Initial condition: If no packet has been received so far, drop count is undefined
+    if (status->packet_rx_success_count == 0) {
+        status->packet_rx_drop_count = 0;
+    }
+    status->packet_rx_success_count++;
+
+    if (r_status != nullptr) {
+        r_status->parse_state = status->parse_state;
+        r_status->packet_idx = status->packet_idx;
+        r_status->current_rx_seq = status->current_rx_seq+1;
+        r_status->packet_rx_success_count = status->packet_rx_success_count;
+        r_status->packet_rx_drop_count = status->parse_error;
+        r_status->flags = status->flags;
+    }
+    status->parse_error = 0;
+    return result;
+}
+
+/*
+  parse MAVLink from a buffer, stopping after the first message
+
+  Whole frames in the buffer are found with memchr() and checked with
+  one CRC pass rather than going through the per-byte state machine.
+  A frame cut off by the end of the buffer is fed to
+  mavlink_parse_char(), which holds it in the channel state until the
+  rest arrives
+*/
+uint16_t mavlink_parse_buffer(mavlink_channel_t chan, const uint8_t *buf, uint16_t len,
+                              mavlink_message_t *r_message, mavlink_status_t *r_status, bool &parsed)
+{
+    parsed = false;
+    mavlink_status_t *status = mavlink_get_channel_status(chan);
+    uint16_t ofs = 0;
+
+    while (ofs < len) {
+        if (status->parse_state != MAVLINK_PARSE_STATE_IDLE &&
+            status->parse_state != MAVLINK_PARSE_STATE_UNINIT) {
+            // in the middle of a frame from an earlier buffer
+            if (mavlink_parse_char(chan, buf[ofs++], r_message, r_status)) {
+                parsed = true;
+                return ofs;
+            }
+            continue;
+        }
+
+        const uint8_t *stx = find_stx(&buf[ofs], len - ofs);
+        if (stx == nullptr) {
+            // bytes outside a frame are ignored, as by the state machine
+            return len;
+        }
+        ofs = stx - buf;
+        const uint16_t avail = len - ofs;
+
+        const bool v1 = stx[0] == MAVLINK_STX_MAVLINK1;
+        const uint8_t header_len = 1 + (v1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN);
+        if (!v1 && avail >= 3 && (stx[2] & ~MAVLINK_IFLAG_MASK) != 0) {
+            // unknown incompatible flags end the frame at that byte
+            status->parse_error++;
+            ofs += 3;
+            continue;
+        }
+        uint16_t frame_len = header_len + (avail >= 2 ? stx[1] : 0) + MAVLINK_NUM_CHECKSUM_BYTES;
+        if (!v1 && avail >= 3 && (stx[2] & MAVLINK_IFLAG_SIGNED)) {
+            frame_len += MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+        if (avail < header_len || avail < frame_len) {
+            // the frame continues in the next buffer
+            mavlink_parse_char(chan, buf[ofs++], r_message, r_status);
+            continue;
+        }
+
+        const uint8_t result = parse_frame(status, stx, r_message, r_status);
+        ofs += frame_len;
+        if (result == MAVLINK_FRAMING_OK) {
+            parsed = true;
+            return ofs;
+        }
+    }
+    return len;
+}
+
 // per-channel lock
 static HAL_Semaphore chan_locks[MAVLINK_COMM_NUM_BUFFERS];
 
+// per-channel space reserved in the UART transmit buffer for the
+// packet being sent, protected by chan_locks
+static struct {
+    ByteBuffer::IoVec vec[2];
+    uint8_t n_vec;
+    uint16_t reserved;
+    uint16_t written;
+} chan_reserve[MAVLINK_COMM_NUM_BUFFERS];
+
 mavlink_system_t mavlink_system = {7,1};
 
 // routing table
@@ -97,6 +299,24 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len)
         // an alternative protocol is active
         return;
     }
+    auto &r = chan_reserve[chan];
+    if (r.n_vec != 0 && r.written + len <= r.reserved) {
+        // copy straight into the space reserved in the UART buffer
+        uint16_t ofs = r.written;
+        for (uint8_t i=0; i<r.n_vec && len > 0; i++) {
+            if (ofs >= r.vec[i].len) {
+                ofs -= r.vec[i].len;
+                continue;
+            }
+            const uint16_t n = MIN(uint32_t(len), r.vec[i].len - ofs);
+            memcpy(&r.vec[i].data[ofs], buf, n);
+            buf += n;
+            len -= n;
+            r.written += n;
+            ofs = 0;
+        }
+        return;
+    }
     const size_t written = mavlink_comm_port[chan]->write(buf, len);
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     if (written < len) {
@@ -108,11 +328,31 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len)
 }
 
 /*
-  lock a channel for send
+  lock a channel for send, reserving space for the whole packet in the
+  UART transmit buffer if the driver supports it. The packet is then
+  written in place by comm_send_buffer() and committed in one step by
+  comm_send_unlock(), saving a buffer lock and ring update per packet
+  fragment
  */
-void comm_send_lock(mavlink_channel_t chan)
+void comm_send_lock(mavlink_channel_t chan, uint16_t size)
 {
     chan_locks[(uint8_t)chan].take_blocking();
+    auto &r = chan_reserve[(uint8_t)chan];
+    r.n_vec = 0;
+    r.written = 0;
+    r.reserved = 0;
+    if (!valid_channel(chan) || gcs_alternative_active[chan] || mavlink_comm_port[chan] == nullptr) {
+        return;
+    }
+    r.n_vec = mavlink_comm_port[chan]->write_reserve(r.vec, size);
+    if (r.n_vec != 0) {
+        r.reserved = size;
+    }
+}
+
+HAL_Semaphore &comm_chan_lock(mavlink_channel_t chan)
+{
+    return chan_locks[(uint8_t)chan];
 }
 
 /*
@@ -120,5 +360,11 @@ void comm_send_lock(mavlink_channel_t chan)
  */
 void comm_send_unlock(mavlink_channel_t chan)
 {
+    auto &r = chan_reserve[(uint8_t)chan];
+    if (r.n_vec != 0) {
+        // only the bytes actually written are made available to send
+        mavlink_comm_port[chan]->write_commit(r.written);
+        r.n_vec = 0;
+    }
     chan_locks[(uint8_t)chan].give();
 }
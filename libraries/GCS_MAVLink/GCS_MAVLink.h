@@ -11,7 +11,7 @@
 
 #define MAVLINK_SEND_UART_BYTES(chan, buf, len) comm_send_buffer(chan, buf, len)
 
-#define MAVLINK_START_UART_SEND(chan, size) comm_send_lock(chan)
+#define MAVLINK_START_UART_SEND(chan, size) comm_send_lock(chan, size)
 #define MAVLINK_END_UART_SEND(chan, size) comm_send_unlock(chan)
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -69,8 +69,25 @@ uint16_t comm_get_txspace(mavlink_channel_t chan);
 #define MAVLINK_USE_CONVENIENCE_FUNCTIONS
 #include "include/mavlink/v2.0/ardupilotmega/mavlink.h"
 
-// lock and unlock a channel, for multi-threaded mavlink send
-void comm_send_lock(mavlink_channel_t chan);
+// parse MAVLink from a buffer, returning the number of bytes used. If
+// a message was completed parsed is set and r_message and r_status
+// are filled in as by mavlink_parse_char()
+uint16_t mavlink_parse_buffer(mavlink_channel_t chan, const uint8_t *buf, uint16_t len,
+                              mavlink_message_t *r_message, mavlink_status_t *r_status, bool &parsed);
+
+// bytes a parsed message took on the wire
+static inline uint16_t mavlink_frame_len(const mavlink_message_t &msg)
+{
+    uint16_t len = msg.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+    if (msg.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        len += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return len;
+}
+
+// lock and unlock a channel, for multi-threaded mavlink send. size
+// is the length of the packet about to be sent
+void comm_send_lock(mavlink_channel_t chan, uint16_t size);
 void comm_send_unlock(mavlink_channel_t chan);
 
 #pragma GCC diagnostic pop
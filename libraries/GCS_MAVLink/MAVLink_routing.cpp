@@ -29,6 +29,29 @@ extern const AP_HAL::HAL& hal;
 // constructor
 MAVLink_routing::MAVLink_routing(void) : num_routes(0) {}
 
+/*
+  return the hash table entry for a sysid/compid. If the pair has no
+  routes this is the empty entry where it should be added
+*/
+MAVLink_routing::route_hash_entry &MAVLink_routing::find_route_hash(uint8_t sysid, uint8_t compid)
+{
+    uint16_t idx = ((sysid * 251U) ^ compid) % MAVLINK_ROUTE_HASH_SIZE;
+    // the table is always at least half empty, so this terminates
+    while (route_hash[idx].channel_mask != 0 &&
+           (route_hash[idx].sysid != sysid || route_hash[idx].compid != compid)) {
+        idx = (idx + 1) % MAVLINK_ROUTE_HASH_SIZE;
+    }
+    return route_hash[idx];
+}
+
+/*
+  return the mask of channels on which we have seen sysid/compid
+*/
+uint8_t MAVLink_routing::route_channels(uint8_t sysid, uint8_t compid)
+{
+    return find_route_hash(sysid, compid).channel_mask;
+}
+
 /*
   forward a MAVLink message to the right port. This also
   automatically learns the route for the sender if it is not
@@ -139,41 +162,48 @@ bool MAVLink_routing::check_and_forward(mavlink_channel_t in_channel, const mavl
         return true;
     }
 
-    // forward on any channels matching the targets
-    bool forwarded = false;
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS];
-    memset(sent_to_chan, 0, sizeof(sent_to_chan));
-    for (uint8_t i=0; i<num_routes; i++) {
+    // find the channels matching the targets
+    uint8_t mask;
+    if (broadcast_system) {
+        mask = route_channel_mask;
+    } else if (broadcast_component || !match_system) {
+        mask = sysid_channel_mask[uint8_t(target_system)];
+    } else {
+        mask = route_channels(target_system, target_component);
+    }
 
-        // Skip if channel is private and the target system or component IDs do not match
-        if ((GCS_MAVLINK::is_private(routes[i].channel)) &&
-            (target_system != routes[i].sysid ||
-             target_component != routes[i].compid)) {
-            continue;
+    // only forward on a private channel if the target system and
+    // component IDs match a route on that channel
+    const uint8_t private_mask = GCS_MAVLINK::private_channel_mask();
+    if (mask & private_mask) {
+        uint8_t exact_mask = 0;
+        if (target_system >= 0 && target_component >= 0) {
+            exact_mask = route_channels(target_system, target_component);
         }
+        mask = (mask & ~private_mask) | (mask & exact_mask & private_mask);
+    }
 
-        if (broadcast_system || (target_system == routes[i].sysid &&
-                                 (broadcast_component || 
-                                  target_component == routes[i].compid ||
-                                  !match_system))) {
+    // never send back out the incoming channel
+    mask &= ~(1U<<(in_channel-MAVLINK_COMM_0));
 
-            if (in_channel != routes[i].channel && !sent_to_chan[routes[i].channel]) {
-                
-                if (comm_get_txspace(routes[i].channel) >= ((uint16_t)msg.len) +
-                    GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
+    const bool forwarded = (mask != 0);
+    for (uint8_t i=0; mask != 0 && i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        if (!(mask & (1U<<i))) {
+            continue;
+        }
+        mask &= ~(1U<<i);
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        if (comm_get_txspace(channel) >= ((uint16_t)msg.len) +
+            GCS_MAVLINK::packet_overhead_chan(channel)) {
 #if ROUTING_DEBUG
-                    ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
-                             msg.msgid,
-                             (unsigned)in_channel,
-                             (unsigned)routes[i].channel,
-                             (int)target_system,
-                             (int)target_component);
+            ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
+                     msg.msgid,
+                     (unsigned)in_channel,
+                     (unsigned)channel,
+                     (int)target_system,
+                     (int)target_component);
 #endif
-                    _mavlink_resend_uart(routes[i].channel, &msg);
-                }
-                sent_to_chan[routes[i].channel] = true;
-                forwarded = true;
-            }
+            _mavlink_resend_uart(channel, &msg);
         }
     }
 
@@ -201,29 +231,24 @@ void MAVLink_routing::send_to_components(uint32_t msgid, const char *pkt, uint8_
 
 void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entry_t *entry, const uint8_t pkt_len)
 {
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS] {};
+    // channels on which our system ID has been seen
+    const uint8_t mask = sysid_channel_mask[mavlink_system.sysid];
 
-    // check learned routes
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid != mavlink_system.sysid) {
-            // our system ID hasn't been seen on this link
-            continue;
-        }
-        if (sent_to_chan[routes[i].channel]) {
-            // we've already send it on this link
+    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        if (!(mask & (1U<<i))) {
             continue;
         }
-        if (comm_get_txspace(routes[i].channel) <
-            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        if (comm_get_txspace(channel) <
+            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(channel)) {
             // it doesn't fit on this channel
             continue;
         }
 #if ROUTING_DEBUG
-        ::printf("send msg %u on chan %u sysid=%u compid=%u\n",
+        ::printf("send msg %u on chan %u sysid=%u\n",
                  entry->msgid,
-                 (unsigned)routes[i].channel,
-                 (unsigned)routes[i].sysid,
-                 (unsigned)routes[i].compid);
+                 (unsigned)channel,
+                 (unsigned)mavlink_system.sysid);
 #endif
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         if (entry->max_msg_len > pkt_len) {
@@ -231,13 +256,12 @@ void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entr
                           entry->max_msg_len, pkt_len);
         }
 #endif
-        _mav_finalize_message_chan_send(routes[i].channel,
+        _mav_finalize_message_chan_send(channel,
                                         entry->msgid,
                                         pkt,
                                         entry->min_msg_len,
                                         MIN(entry->max_msg_len, pkt_len),
                                         entry->crc_extra);
-        sent_to_chan[routes[i].channel] = true;
     }
 }
 
@@ -283,17 +307,26 @@ void MAVLink_routing::learn_route(mavlink_channel_t in_channel, const mavlink_me
         // should also process them locally.
         return;
     }
-    for (i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid &&
-            routes[i].compid == msg.compid &&
-            routes[i].channel == in_channel) {
-            if (routes[i].mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+    const uint8_t chan_bit = 1U<<(in_channel-MAVLINK_COMM_0);
+    route_hash_entry &hash_entry = find_route_hash(msg.sysid, msg.compid);
+    if (hash_entry.channel_mask & chan_bit) {
+        // already known
+        if (msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            for (i=0; i<num_routes; i++) {
+                if (routes[i].sysid == msg.sysid &&
+                    routes[i].compid == msg.compid &&
+                    routes[i].channel == in_channel) {
+                    if (routes[i].mavtype == 0) {
+                        routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+                    }
+                    break;
+                }
             }
-            break;
         }
+        return;
     }
-    if (i == num_routes && i<MAVLINK_MAX_ROUTES) {
+    i = num_routes;
+    if (i<MAVLINK_MAX_ROUTES) {
         routes[i].sysid = msg.sysid;
         routes[i].compid = msg.compid;
         routes[i].channel = in_channel;
@@ -301,6 +334,11 @@ void MAVLink_routing::learn_route(mavlink_channel_t in_channel, const mavlink_me
             routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
         }
         num_routes++;
+        hash_entry.sysid = msg.sysid;
+        hash_entry.compid = msg.compid;
+        hash_entry.channel_mask |= chan_bit;
+        sysid_channel_mask[msg.sysid] |= chan_bit;
+        route_channel_mask |= chan_bit;
 #if ROUTING_DEBUG
         ::printf("learned route %u %u via %u\n",
                  (unsigned)msg.sysid,
@@ -328,11 +366,7 @@ void MAVLink_routing::handle_heartbeat(mavlink_channel_t in_channel, const mavli
     mask &= ~no_route_mask;
     
     // mask out channels that are known sources for this sysid/compid
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid && routes[i].compid == msg.compid) {
-            mask &= ~(1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0)));
-        }
-    }
+    mask &= ~route_channels(msg.sysid, msg.compid);
 
     if (mask == 0) {
         // nothing to send to
@@ -6,9 +6,20 @@
 #include <AP_Common/AP_Common.h>
 #include "GCS_MAVLink.h"
 
-// 20 routes should be enough for now. This may need to increase as
-// we make more extensive use of MAVLink forwarding
+// maximum number of learned routes. Boards with more memory allow
+// for larger networks of components behind companion computers
+#ifndef MAVLINK_MAX_ROUTES
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define MAVLINK_MAX_ROUTES 64
+#else
 #define MAVLINK_MAX_ROUTES 20
+#endif
+#endif
+
+// size of the sysid/compid hash table, at least twice the number of routes
+#define MAVLINK_ROUTE_HASH_SIZE (MAVLINK_MAX_ROUTES <= 32 ? 64 : 128)
+static_assert(MAVLINK_ROUTE_HASH_SIZE >= 2*MAVLINK_MAX_ROUTES, "route hash table too small");
+static_assert(MAVLINK_COMM_NUM_BUFFERS <= 8, "channel masks must fit in a uint8_t");
 
 /*
   object to handle MAVLink packet routing
@@ -45,8 +56,7 @@ public:
     bool find_by_mavtype(uint8_t mavtype, uint8_t &sysid, uint8_t &compid, mavlink_channel_t &channel);
 
 private:
-    // a simple linear routing table. We don't expect to have a lot of
-    // routes, so a scalable structure isn't worthwhile yet.
+    // table of learned routes, used for lookups by mavtype
     uint8_t num_routes;
     struct route {
         uint8_t sysid;
@@ -54,6 +64,29 @@ private:
         mavlink_channel_t channel;
         uint8_t mavtype;
     } routes[MAVLINK_MAX_ROUTES];
+
+    /*
+      forwarding caches of channel masks, updated as routes are
+      learned so that routing a message does not need to scan the
+      route table. Routes are never removed, so the hash table uses
+      open addressing with linear probing and no deletion
+     */
+    struct route_hash_entry {
+        uint8_t sysid;
+        uint8_t compid;
+        uint8_t channel_mask;   // zero for an unused entry
+    } route_hash[MAVLINK_ROUTE_HASH_SIZE];
+    // channels with a route to each sysid
+    uint8_t sysid_channel_mask[256];
+    // channels with any route
+    uint8_t route_channel_mask;
+
+    // return the hash table entry for a sysid/compid, or the empty
+    // entry where it would be added
+    route_hash_entry &find_route_hash(uint8_t sysid, uint8_t compid);
+
+    // return the mask of channels with a route to sysid/compid
+    uint8_t route_channels(uint8_t sysid, uint8_t compid);
     
     // a channel mask to block routing as required
     uint8_t no_route_mask;
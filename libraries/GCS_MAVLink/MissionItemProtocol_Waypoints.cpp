@@ -23,6 +23,8 @@
 
 #include "GCS.h"
 
+extern const AP_HAL::HAL& hal;
+
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::append_item(const mavlink_mission_item_int_t &mission_item_int)
 {
     // sanity check for DO_JUMP command
@@ -39,12 +41,50 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::append_item(const mavlink_miss
         }
     }
 
+    if (_new_items != nullptr) {
+        if (cmd.index >= _new_items_count) {
+            return MAV_MISSION_INVALID_SEQUENCE;
+        }
+        _new_items[cmd.index] = cmd;
+        _new_items_received = cmd.index + 1;
+        return MAV_MISSION_ACCEPTED;
+    }
+
     if (!mission.add_cmd(cmd)) {
         return MAV_MISSION_ERROR;
     }
     return MAV_MISSION_ACCEPTED;
 }
 
+MAV_MISSION_RESULT MissionItemProtocol_Waypoints::allocate_receive_resources(const uint16_t count)
+{
+    if (_new_items != nullptr) {
+        // this is an error - the base class should have called
+        // free_upload_resources first
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return MAV_MISSION_ERROR;
+    }
+
+    // single items are written directly.  If we can't spare the
+    // memory to buffer the upload we also fall back to writing each
+    // item to storage as it arrives
+    const uint32_t allocation_size = uint32_t(count) * sizeof(AP_Mission::Mission_Command);
+    if (count > 1 && allocation_size < hal.util->available_memory() / 2) {
+        _new_items = new AP_Mission::Mission_Command[count];
+    }
+    _new_items_count = (_new_items != nullptr) ? count : 0;
+    _new_items_received = 0;
+    return MAV_MISSION_ACCEPTED;
+}
+
+void MissionItemProtocol_Waypoints::free_upload_resources()
+{
+    delete[] _new_items;
+    _new_items = nullptr;
+    _new_items_count = 0;
+    _new_items_received = 0;
+}
+
 bool MissionItemProtocol_Waypoints::clear_all_items()
 {
     return mission.clear();
@@ -52,6 +92,13 @@ bool MissionItemProtocol_Waypoints::clear_all_items()
 
 MAV_MISSION_RESULT MissionItemProtocol_Waypoints::complete(const GCS_MAVLINK &_link)
 {
+    if (_new_items != nullptr) {
+        // write the buffered upload in one go
+        if (_new_items_received != _new_items_count ||
+            !mission.replace_mission(_new_items, _new_items_count)) {
+            return MAV_MISSION_ERROR;
+        }
+    }
     _link.send_text(MAV_SEVERITY_INFO, "Flight plan received");
     AP::logger().Write_EntireMission();
     return MAV_MISSION_ACCEPTED;
@@ -98,6 +145,9 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::get_item(const GCS_MAVLINK &_l
 }
 
 uint16_t MissionItemProtocol_Waypoints::item_count() const {
+    if (_new_items != nullptr) {
+        return _new_items_received;
+    }
     return mission.num_commands();
 }
 
@@ -120,6 +170,13 @@ MAV_MISSION_RESULT MissionItemProtocol_Waypoints::replace_item(const mavlink_mis
             return MAV_MISSION_ERROR;
         }
     }
+    if (_new_items != nullptr) {
+        if (cmd.index >= _new_items_received) {
+            return MAV_MISSION_INVALID_SEQUENCE;
+        }
+        _new_items[cmd.index] = cmd;
+        return MAV_MISSION_ACCEPTED;
+    }
     if (!mission.replace_cmd(cmd.index, cmd)) {
         return MAV_MISSION_ERROR;
     }
@@ -133,6 +190,10 @@ void MissionItemProtocol_Waypoints::timeout()
 
 void MissionItemProtocol_Waypoints::truncate(const mavlink_mission_count_t &packet)
 {
+    if (_new_items != nullptr) {
+        // the buffered upload replaces the whole mission when complete
+        return;
+    }
     // new mission arriving, truncate mission to be the same length
     mission.truncate(packet.count);
 }
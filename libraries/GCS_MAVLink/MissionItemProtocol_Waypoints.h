@@ -41,6 +41,15 @@ protected:
 private:
     AP_Mission &mission;
 
+    // uploads are buffered here when there is memory for them and
+    // written to storage in one go once complete
+    AP_Mission::Mission_Command *_new_items;
+    uint16_t _new_items_count;
+    uint16_t _new_items_received;
+
+    void free_upload_resources() override;
+    MAV_MISSION_RESULT allocate_receive_resources(const uint16_t count) override WARN_IF_UNUSED;
+
     // append_item() is called by the base class to add the supplied
     // item to the end of the list of stored items.
     MAV_MISSION_RESULT append_item(const mavlink_mission_item_int_t &) override WARN_IF_UNUSED;
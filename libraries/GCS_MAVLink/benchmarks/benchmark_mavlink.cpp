@@ -0,0 +1,88 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <GCS_MAVLink/GCS_MAVLink.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// pack and serialise the messages sent most often in a telemetry stream
+static void BM_MAVLinkPackAttitude(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint32_t t = 0;
+
+    while (state.KeepRunning()) {
+        mavlink_msg_attitude_pack(1, 1, &msg, t++, 0.1f, -0.2f, 1.3f, 0.01f, 0.02f, -0.03f);
+        uint16_t len = mavlink_msg_to_send_buffer(buf, &msg);
+        gbenchmark_escape(&len);
+        gbenchmark_escape(buf);
+    }
+}
+
+BENCHMARK(BM_MAVLinkPackAttitude);
+
+static void BM_MAVLinkPackGlobalPositionInt(benchmark::State& state)
+{
+    mavlink_message_t msg;
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint32_t t = 0;
+
+    while (state.KeepRunning()) {
+        mavlink_msg_global_position_int_pack(1, 1, &msg, t++, -353632610, 1491652300, 584000, 10000, 100, -50, 3, 4500);
+        uint16_t len = mavlink_msg_to_send_buffer(buf, &msg);
+        gbenchmark_escape(&len);
+        gbenchmark_escape(buf);
+    }
+}
+
+BENCHMARK(BM_MAVLinkPackGlobalPositionInt);
+
+/*
+  parse a received stream a byte at a time as GCS_MAVLINK does. Each
+  iteration parses one packet of a mix of message types
+ */
+#define PARSE_NUM_PACKETS 32
+
+static void BM_MAVLinkParse(benchmark::State& state)
+{
+    static uint8_t stream[PARSE_NUM_PACKETS * MAVLINK_MAX_PACKET_LEN];
+    uint16_t offsets[PARSE_NUM_PACKETS+1];
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < PARSE_NUM_PACKETS; i++) {
+        mavlink_message_t msg;
+        switch (i % 3) {
+        case 0:
+            mavlink_msg_heartbeat_pack(255, 190, &msg, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, 0);
+            break;
+        case 1:
+            mavlink_msg_rc_channels_override_pack(255, 190, &msg, 1, 1,
+                                                  1500, 1500, 1000, 1500, 0, 0, 0, 0,
+                                                  0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            break;
+        default:
+            mavlink_msg_param_request_read_pack(255, 190, &msg, 1, 1, "SCHED_LOOP_RATE", -1);
+            break;
+        }
+        offsets[i] = len;
+        len += mavlink_msg_to_send_buffer(&stream[len], &msg);
+    }
+    offsets[PARSE_NUM_PACKETS] = len;
+
+    mavlink_message_t msg;
+    mavlink_status_t status;
+    uint8_t i = 0;
+
+    while (state.KeepRunning()) {
+        uint8_t res = 0;
+        for (uint16_t ofs = offsets[i]; ofs < offsets[i+1]; ofs++) {
+            res = mavlink_parse_char(MAVLINK_COMM_0, stream[ofs], &msg, &status);
+        }
+        gbenchmark_escape(&res);
+        i = (i + 1) % PARSE_NUM_PACKETS;
+    }
+}
+
+BENCHMARK(BM_MAVLinkParse);
+
+BENCHMARK_MAIN();
@@ -168,7 +168,7 @@ void Aircraft::update_mag_field_bf()
     float intensity;
     float declination;
     float inclination;
-    AP_Declination::get_mag_field_ef(location.lat * 1e-7f, location.lng * 1e-7f, intensity, declination, inclination);
+    mag_field_cache.get_mag_field_ef(location.lat * 1e-7f, location.lng * 1e-7f, intensity, declination, inclination);
 
     // create a field vector and rotate to the required orientation
     Vector3f mag_ef(1e3f * intensity, 0.0f, 0.0f);
@@ -239,6 +239,11 @@ void Aircraft::adjust_frame_time(float new_rate)
 void Aircraft::sync_frame_time(void)
 {
     frame_counter++;
+    if (lockstep.active()) {
+        // run as fast as the slowest instance in the group
+        lockstep.step(time_now_us);
+        return;
+    }
     uint64_t now = get_wall_time_us();
     uint64_t dt_us = now - last_wall_time_us;
 
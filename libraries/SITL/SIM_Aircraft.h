@@ -23,6 +23,7 @@
 #include "SITL.h"
 #include "SITL_Input.h"
 #include <AP_Terrain/AP_Terrain.h>
+#include <AP_Declination/AP_Declination.h>
 #include "SIM_Sprayer.h"
 #include "SIM_Gripper_Servo.h"
 #include "SIM_Gripper_EPM.h"
@@ -32,6 +33,7 @@
 #include "SIM_I2C.h"
 #include "SIM_Buzzer.h"
 #include "SIM_Battery.h"
+#include "SIM_Lockstep.h"
 #include <Filter/Filter.h>
 
 namespace SITL {
@@ -59,6 +61,14 @@ public:
         instance = _instance;
     }
 
+    /*
+      run in lockstep with the other instances in group, instead of
+      against the wall clock. Must be called after set_instance()
+     */
+    bool enable_lockstep(const char *group, uint8_t num_instances) {
+        return lockstep.init(group, instance, num_instances);
+    }
+
     /*
       set directory for additional files such as aircraft models
      */
@@ -224,6 +234,7 @@ protected:
     const char *autotest_dir;
     const char *frame;
     bool use_time_sync = true;
+    Lockstep lockstep;
     float last_speedup = -1.0f;
     const char *config_ = "";
 
@@ -256,6 +267,7 @@ protected:
 
     /* update body frame magnetic field */
     void update_mag_field_bf(void);
+    AP_Declination::FieldCache mag_field_cache;
 
     /* advance time by deltat in seconds */
     void time_advance();
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <errno.h>
+#include <string.h>
 
 #include <AP_HAL/AP_HAL.h>
 
@@ -40,6 +41,15 @@ Gazebo::Gazebo(const char *frame_str) :
 */
 void Gazebo::set_interface_ports(const char* address, const int port_in, const int port_out)
 {
+    if (strncmp(address, "shm:", 4) == 0) {
+        if (!shm.init(&address[4])) {
+            fprintf(stderr, "Aborting launch...\n");
+            exit(1);
+        }
+        use_shm = true;
+        return;
+    }
+
     // try to bind to a specific port so that if we restart ArduPilot
     // Gazebo keeps sending us packets. Not strictly necessary but
     // useful for debugging
@@ -62,6 +72,11 @@ void Gazebo::set_interface_ports(const char* address, const int port_in, const i
 */
 void Gazebo::send_servos(const struct sitl_input &input)
 {
+    if (use_shm) {
+        shm.send_servos(input.servos, rate_hz, frame_counter++);
+        return;
+    }
+
     servo_packet pkt;
     // should rename servo_command
     // 16 because struct sitl_input.servos is 16 large in SIM_Aircraft.h
@@ -72,6 +87,29 @@ void Gazebo::send_servos(const struct sitl_input &input)
     socket_sitl.sendto(&pkt, sizeof(pkt), _gazebo_address, _gazebo_port);
 }
 
+/*
+  receive an update over shared memory, in the JSON backend's binary
+  state format
+ */
+bool Gazebo::recv_shm(fdm_packet &pkt)
+{
+    SharedMemFDM::state s;
+    if (!shm.recv_state(s, 100)) {
+        return false;
+    }
+    pkt.timestamp = s.timestamp_s;
+    for (uint8_t i=0; i<3; i++) {
+        pkt.imu_angular_velocity_rpy[i] = s.gyro[i];
+        pkt.imu_linear_acceleration_xyz[i] = s.accel_body[i];
+        pkt.velocity_xyz[i] = s.velocity[i];
+        pkt.position_xyz[i] = s.position[i];
+    }
+    for (uint8_t i=0; i<4; i++) {
+        pkt.imu_orientation_quat[i] = s.quaternion[i];
+    }
+    return true;
+}
+
 /*
   receive an update from the FDM
   This is a blocking function
@@ -84,7 +122,7 @@ void Gazebo::recv_fdm(const struct sitl_input &input)
       we re-send the servo packet every 0.1 seconds until we get a
       reply. This allows us to cope with some packet loss to the FDM
      */
-    while (socket_sitl.recv(&pkt, sizeof(pkt), 100) != sizeof(pkt)) {
+    while (use_shm ? !recv_shm(pkt) : socket_sitl.recv(&pkt, sizeof(pkt), 100) != sizeof(pkt)) {
         send_servos(input);
         // Reset the timestamp after a long disconnection, also catch gazebo reset
         if (get_wall_time_us() > last_wall_time_us + GAZEBO_TIMEOUT_US) {
@@ -167,7 +205,9 @@ void Gazebo::update(const struct sitl_input &input)
     time_advance();
     // update magnetic field
     update_mag_field_bf();
-    drain_sockets();
+    if (!use_shm) {
+        drain_sockets();
+    }
 }
 
 }  // namespace SITL
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "SIM_Aircraft.h"
+#include "SIM_SharedMemFDM.h"
 #include <AP_HAL/utility/Socket.h>
 
 namespace SITL {
@@ -63,6 +64,7 @@ private:
     };
 
     void recv_fdm(const struct sitl_input &input);
+    bool recv_shm(fdm_packet &pkt);
     void send_servos(const struct sitl_input &input);
     void drain_sockets();
 
@@ -72,6 +74,11 @@ private:
     const char *_gazebo_address = "127.0.0.1";
     int _gazebo_port = 9002;
     static const uint64_t GAZEBO_TIMEOUT_US = 5000000;
+
+    // shared memory transport, used if the address is shm:NAME
+    SharedMemFDM shm;
+    bool use_shm;
+    uint32_t frame_counter;
 };
 
 }  // namespace SITL
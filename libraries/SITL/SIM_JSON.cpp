@@ -90,6 +90,15 @@ void JSON::set_interface_ports(const char* address, const int port_in, const int
     }
     control_port = port_out;
 
+    if (strncmp(target_ip, "shm:", 4) == 0) {
+        if (!shm.init(&target_ip[4])) {
+            fprintf(stderr, "Aborting launch...\n");
+            exit(1);
+        }
+        use_shm = true;
+        return;
+    }
+
     printf("JSON control interface set to %s:%u\n", target_ip, control_port);
 }
 
@@ -98,6 +107,11 @@ void JSON::set_interface_ports(const char* address, const int port_in, const int
 */
 void JSON::output_servos(const struct sitl_input &input)
 {
+    if (use_shm) {
+        shm.send_servos(input.servos, rate_hz, frame_counter);
+        return;
+    }
+
     servo_packet pkt;
     pkt.frame_rate = rate_hz;
     pkt.frame_count = frame_counter;
@@ -210,10 +224,11 @@ uint16_t JSON::parse_sensors(const char *json)
 }
 
 /*
-    Receive new sensor data from simulator
+    Receive and parse sensor data in JSON format over UDP, returning
+    the fields received or 0 on failure
     This is a blocking function
 */
-void JSON::recv_fdm(const struct sitl_input &input)
+uint16_t JSON::recv_json(const struct sitl_input &input)
 {
     // Receive sensor packet
     ssize_t ret = sock.recv(&sensor_buffer[sensor_buffer_len], sizeof(sensor_buffer)-sensor_buffer_len, UDP_TIMEOUT_MS);
@@ -238,18 +253,74 @@ void JSON::recv_fdm(const struct sitl_input &input)
 
     const uint8_t *p2 = (const uint8_t *)memrchr(sensor_buffer, 0, sensor_buffer_len);
     if (p2 == nullptr || p2 == sensor_buffer) {
-        return;
+        return 0;
     }
 
     const uint8_t *p1 = (const uint8_t *)memrchr(sensor_buffer, 0, p2 - sensor_buffer);
     if (p1 == nullptr) {
-        return;
+        return 0;
     }
 
     const uint16_t received_bitmask = parse_sensors((const char *)(p1+1));
     if (received_bitmask == 0) {
         // did not receve one of the mandatory fields
         printf("Did not contain all mandatory fields\n");
+        return 0;
+    }
+
+    memmove(sensor_buffer, p2, sensor_buffer_len - (p2 - sensor_buffer));
+    sensor_buffer_len = sensor_buffer_len - (p2 - sensor_buffer);
+
+    return received_bitmask;
+}
+
+/*
+    Receive binary sensor data over shared memory, returning the
+    fields received or 0 on failure
+    This is a blocking function
+*/
+uint16_t JSON::recv_shm(const struct sitl_input &input)
+{
+    SharedMemFDM::state s;
+    uint32_t wait_ms = 0;
+    while (!shm.recv_state(s, UDP_TIMEOUT_MS)) {
+        wait_ms += UDP_TIMEOUT_MS;
+        if (wait_ms > 1000) {
+            wait_ms = 0;
+            printf("No shared memory sensor data received, resending servos\n");
+            output_servos(input);
+        }
+    }
+
+    const uint16_t required = TIMESTAMP | GYRO | ACCEL_BODY | POSITION | VELOCITY;
+    if ((s.fields & required) != required) {
+        printf("Did not contain all mandatory fields\n");
+        return 0;
+    }
+
+    state.timestamp_s = s.timestamp_s;
+    state.imu.gyro = Vector3f(s.gyro[0], s.gyro[1], s.gyro[2]);
+    state.imu.accel_body = Vector3f(s.accel_body[0], s.accel_body[1], s.accel_body[2]);
+    state.position = Vector3d(s.position[0], s.position[1], s.position[2]);
+    state.attitude = Vector3f(s.attitude[0], s.attitude[1], s.attitude[2]);
+    state.quaternion = Quaternion(s.quaternion[0], s.quaternion[1], s.quaternion[2], s.quaternion[3]);
+    state.velocity = Vector3f(s.velocity[0], s.velocity[1], s.velocity[2]);
+    memcpy(state.rng, s.rng, sizeof(state.rng));
+    state.wind_vane_apparent.direction = s.windvane_direction;
+    state.wind_vane_apparent.speed = s.windvane_speed;
+    state.airspeed = s.airspeed;
+
+    return s.fields;
+}
+
+/*
+    Receive new sensor data from simulator
+    This is a blocking function
+*/
+void JSON::recv_fdm(const struct sitl_input &input)
+{
+    const uint16_t received_bitmask = use_shm ? recv_shm(input) : recv_json(input);
+    if (received_bitmask == 0) {
         return;
     }
 
@@ -277,9 +348,6 @@ void JSON::recv_fdm(const struct sitl_input &input)
     }
     last_received_bitmask = received_bitmask;
 
-    memmove(sensor_buffer, p2, sensor_buffer_len - (p2 - sensor_buffer));
-    sensor_buffer_len = sensor_buffer_len - (p2 - sensor_buffer);
-
     accel_body = state.imu.accel_body;
     gyro = state.imu.gyro;
     velocity_ef = state.velocity;
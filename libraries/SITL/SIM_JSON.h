@@ -16,6 +16,7 @@
 
 #include <AP_HAL/utility/Socket.h>
 #include "SIM_Aircraft.h"
+#include "SIM_SharedMemFDM.h"
 
 namespace SITL {
 
@@ -51,11 +52,17 @@ private:
 
     SocketAPM sock;
 
+    // shared memory transport, used if the address is shm:NAME
+    SharedMemFDM shm;
+    bool use_shm;
+
     uint32_t frame_counter;
     double last_timestamp_s;
 
     void output_servos(const struct sitl_input &input);
     void recv_fdm(const struct sitl_input &input);
+    uint16_t recv_json(const struct sitl_input &input);
+    uint16_t recv_shm(const struct sitl_input &input);
 
     uint16_t parse_sensors(const char *json);
 
@@ -0,0 +1,210 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  lockstep synchronisation of several SITL instances
+*/
+
+#include "SIM_Lockstep.h"
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace SITL;
+
+// how long to spin before backing off to short sleeps while waiting
+#define LOCKSTEP_SPIN_COUNT 1000
+#define LOCKSTEP_BACKOFF_NS 50000
+
+// how often to check that the instances we are waiting for are alive
+#define LOCKSTEP_ALIVE_CHECK_COUNT 2000
+
+// the group we are in, left on exit
+static Lockstep *lockstep_group;
+
+static void lockstep_atexit(void)
+{
+    if (lockstep_group != nullptr) {
+        lockstep_group->leave();
+    }
+}
+
+bool Lockstep::init(const char *name, uint8_t instance, uint8_t _num_instances)
+{
+    if (_num_instances < 1 || instance >= _num_instances) {
+        ::fprintf(stderr, "lockstep: instance %u out of range for %u instances\n",
+                  unsigned(instance), unsigned(_num_instances));
+        return false;
+    }
+    if (asprintf(&shm_name, "/ap_lockstep_%s", name) == -1) {
+        shm_name = nullptr;
+        return false;
+    }
+    const int fd = shm_open(shm_name, O_RDWR|O_CREAT, 0600);
+    if (fd == -1) {
+        ::fprintf(stderr, "lockstep: shm_open(%s) failed: %s\n", shm_name, strerror(errno));
+        return false;
+    }
+    // all instances size the segment the same way, and new memory
+    // reads as zero
+    if (ftruncate(fd, sizeof(shared_state)) == -1) {
+        ::fprintf(stderr, "lockstep: ftruncate failed: %s\n", strerror(errno));
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(shared_state), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "lockstep: mmap failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    my_instance = instance;
+    num_instances = _num_instances;
+    started = false;
+    shared = (shared_state *)p;
+    shared->instance[my_instance].time_us.store(0);
+    shared->instance[my_instance].pid.store(getpid());
+
+    lockstep_group = this;
+    atexit(lockstep_atexit);
+
+    ::printf("lockstep: instance %u of %u in group %s\n",
+             unsigned(my_instance), unsigned(num_instances), name);
+    return true;
+}
+
+bool Lockstep::instance_alive(uint8_t i) const
+{
+    const pid_t pid = shared->instance[i].pid.load();
+    if (pid == 0) {
+        return false;
+    }
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/*
+  wait for a short while, spinning at first so that a group running
+  on idle cores doesn't pay for a context switch each frame
+ */
+static void lockstep_backoff(uint32_t count)
+{
+    if (count < LOCKSTEP_SPIN_COUNT) {
+        sched_yield();
+        return;
+    }
+    const struct timespec ts { 0, LOCKSTEP_BACKOFF_NS };
+    nanosleep(&ts, nullptr);
+}
+
+/*
+  hold the first frame until every instance has started, a stale
+  segment from an earlier run may still hold pids of dead processes
+ */
+void Lockstep::wait_for_all_joined()
+{
+    bool reported = false;
+    for (uint32_t count=0; ; count++) {
+        uint8_t joined = 0;
+        for (uint8_t i=0; i<num_instances; i++) {
+            if (instance_alive(i)) {
+                joined++;
+            }
+        }
+        if (joined == num_instances) {
+            return;
+        }
+        if (!reported && count > LOCKSTEP_ALIVE_CHECK_COUNT) {
+            ::printf("lockstep: waiting for %u of %u instances\n",
+                     unsigned(num_instances - joined), unsigned(num_instances));
+            reported = true;
+        }
+        lockstep_backoff(count);
+    }
+}
+
+void Lockstep::step(uint64_t time_us)
+{
+    if (shared == nullptr) {
+        return;
+    }
+    if (!started) {
+        wait_for_all_joined();
+        start_time_us = time_us;
+        started = true;
+    }
+    const uint64_t my_time_us = time_us - start_time_us;
+    shared->instance[my_instance].time_us.store(my_time_us);
+
+    for (uint8_t i=0; i<num_instances; i++) {
+        if (i == my_instance) {
+            continue;
+        }
+        for (uint32_t count=0; shared->instance[i].time_us.load() < my_time_us; count++) {
+            int32_t pid = shared->instance[i].pid.load();
+            if (pid == 0) {
+                // it has left, don't wait for it
+                break;
+            }
+            if (count % LOCKSTEP_ALIVE_CHECK_COUNT == LOCKSTEP_ALIVE_CHECK_COUNT-1 && !instance_alive(i)) {
+                // it has crashed, mark it as gone unless it has
+                // been restarted in the meantime
+                shared->instance[i].pid.compare_exchange_strong(pid, 0);
+                break;
+            }
+            lockstep_backoff(count);
+        }
+    }
+}
+
+void Lockstep::leave()
+{
+    if (lockstep_group == this) {
+        lockstep_group = nullptr;
+    }
+    if (shared == nullptr) {
+        return;
+    }
+    shared->instance[my_instance].pid.store(0);
+
+    // the last one out removes the segment
+    bool last = true;
+    for (uint8_t i=0; i<num_instances; i++) {
+        if (instance_alive(i)) {
+            last = false;
+            break;
+        }
+    }
+    munmap(shared, sizeof(shared_state));
+    shared = nullptr;
+    if (last) {
+        shm_unlink(shm_name);
+    }
+    free(shm_name);
+    shm_name = nullptr;
+}
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -0,0 +1,79 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  lockstep synchronisation of several SITL instances. Instances share
+  a small block of shared memory holding the simulation time each has
+  reached, and an instance only advances its physics once every other
+  instance has caught up. This replaces the sleep-based wall clock
+  synchronisation, so a group runs as fast as its slowest member
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef SITL_LOCKSTEP_MAX_INSTANCES
+#define SITL_LOCKSTEP_MAX_INSTANCES 255
+#endif
+
+namespace SITL {
+
+class Lockstep {
+public:
+    ~Lockstep() { leave(); }
+
+    /*
+      join the lockstep group called name as instance, out of
+      num_instances. Returns false if the shared memory can't be set up
+     */
+    bool init(const char *name, uint8_t instance, uint8_t num_instances);
+
+    bool active() const { return shared != nullptr; }
+
+    /*
+      called at the end of each physics frame with the simulation time
+      reached. Returns once all other live instances have reached at
+      least that time
+     */
+    void step(uint64_t time_us);
+
+    // leave the group so the remaining instances don't wait for us
+    void leave();
+
+private:
+    struct shared_state {
+        struct {
+            // simulation time reached, relative to our first frame
+            std::atomic<uint64_t> time_us;
+            // process id of the instance, zero if it has left
+            std::atomic<int32_t> pid;
+        } instance[SITL_LOCKSTEP_MAX_INSTANCES];
+    };
+
+    shared_state *shared = nullptr;
+    char *shm_name = nullptr;
+    uint8_t my_instance;
+    uint8_t num_instances;
+    bool started;
+    uint64_t start_time_us;
+
+    // true if the instance in slot i is still running
+    bool instance_alive(uint8_t i) const;
+    void wait_for_all_joined();
+};
+
+}  // namespace SITL
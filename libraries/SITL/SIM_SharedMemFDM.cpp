@@ -0,0 +1,119 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  shared memory transport between SITL and an external physics backend
+*/
+
+#include "SIM_SharedMemFDM.h"
+
+#include <AP_HAL/AP_HAL.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace SITL;
+
+// how long to spin before backing off to short sleeps while waiting
+#define SHM_SPIN_COUNT 1000
+#define SHM_BACKOFF_NS 20000
+
+// simulated time stands still while we wait, so time out on the wall clock
+static uint32_t wall_clock_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000U + ts.tv_nsec / 1000000U;
+}
+
+SharedMemFDM::~SharedMemFDM()
+{
+    if (shm != nullptr) {
+        munmap(shm, sizeof(layout));
+        shm_unlink(shm_name);
+    }
+    free(shm_name);
+}
+
+bool SharedMemFDM::init(const char *name)
+{
+    if (asprintf(&shm_name, "/%s", name) == -1) {
+        shm_name = nullptr;
+        return false;
+    }
+    const int fd = shm_open(shm_name, O_RDWR|O_CREAT, 0600);
+    if (fd == -1) {
+        ::fprintf(stderr, "SITL: shm_open(%s) failed: %s\n", shm_name, strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(layout)) == -1) {
+        ::fprintf(stderr, "SITL: ftruncate failed: %s\n", strerror(errno));
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(layout), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "SITL: mmap failed: %s\n", strerror(errno));
+        return false;
+    }
+    shm = (layout *)p;
+
+    // carry on from where a previous run left off so a physics
+    // backend that is still attached doesn't see time go backwards
+    seq = shm->servo_seq.load();
+    shm->version = SHM_VERSION;
+    shm->magic = SHM_MAGIC;
+
+    ::printf("SITL: shared memory physics interface /dev/shm%s\n", shm_name);
+    return true;
+}
+
+void SharedMemFDM::send_servos(const uint16_t pwm[16], uint16_t frame_rate, uint32_t frame_count)
+{
+    shm->servos.magic = 18458;
+    shm->servos.frame_rate = frame_rate;
+    shm->servos.frame_count = frame_count;
+    memcpy(shm->servos.pwm, pwm, sizeof(shm->servos.pwm));
+    shm->servo_seq.store(++seq, std::memory_order_release);
+}
+
+bool SharedMemFDM::recv_state(struct state &s, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = wall_clock_ms();
+    for (uint32_t count=0; shm->state_seq.load(std::memory_order_acquire) != seq; count++) {
+        if (count < SHM_SPIN_COUNT) {
+            sched_yield();
+            continue;
+        }
+        if (wall_clock_ms() - start_ms > timeout_ms) {
+            return false;
+        }
+        const struct timespec ts { 0, SHM_BACKOFF_NS };
+        nanosleep(&ts, nullptr);
+    }
+    s = shm->state;
+    return true;
+}
+
+#endif // CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -0,0 +1,91 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  shared memory transport between SITL and an external physics
+  backend. SITL creates a POSIX shared memory segment holding one
+  servo frame and one binary physics state. SITL writes the servos and
+  bumps servo_seq; the physics steps, writes the state and sets
+  state_seq to the servo_seq it answered. This avoids both the socket
+  round trip and text parsing on every frame. See
+  examples/JSON/readme.md for the layout
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#include <AP_Common/AP_Common.h>
+
+namespace SITL {
+
+class SharedMemFDM {
+public:
+    ~SharedMemFDM();
+
+    // physics state, in the same units and frames as the JSON backend
+    struct PACKED state {
+        uint16_t fields;        // bitmask of fields present, in JSON keytable order
+        double timestamp_s;
+        float gyro[3];
+        float accel_body[3];
+        double position[3];
+        float attitude[3];
+        float quaternion[4];
+        float velocity[3];
+        float rng[6];
+        float windvane_direction;
+        float windvane_speed;
+        float airspeed;
+    };
+
+    // create or attach to the segment called name
+    bool init(const char *name);
+
+    // publish a servo frame for the physics to step with
+    void send_servos(const uint16_t pwm[16], uint16_t frame_rate, uint32_t frame_count);
+
+    /*
+      wait up to timeout_ms for the physics to answer the last servo
+      frame. Returns false on timeout
+     */
+    bool recv_state(struct state &s, uint32_t timeout_ms);
+
+private:
+    static const uint32_t SHM_MAGIC = 0x4d535041; // "APSM"
+    static const uint32_t SHM_VERSION = 1;
+
+    struct PACKED servos {
+        uint16_t magic;         // 18458, as for the JSON servo packet
+        uint16_t frame_rate;
+        uint32_t frame_count;
+        uint16_t pwm[16];
+    };
+
+    struct layout {
+        uint32_t magic;
+        uint32_t version;
+        std::atomic<uint32_t> servo_seq;
+        std::atomic<uint32_t> state_seq;
+        struct servos servos;
+        struct state state;
+    };
+
+    layout *shm = nullptr;
+    char *shm_name = nullptr;
+    uint32_t seq;
+};
+
+}  // namespace SITL
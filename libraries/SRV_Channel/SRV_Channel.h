@@ -338,6 +338,9 @@ public:
     // set output value for a function channel as a pwm value
     static void set_output_pwm(SRV_Channel::Aux_servo_function_t function, uint16_t value);
 
+    // set output values for a set of motors as pwm values, indexed by zero-based motor number
+    static void set_output_pwm_motors(const uint16_t *pwm, uint32_t motor_mask);
+
     // set output value for a specific function channel as a pwm value
     static void set_output_pwm_chan(uint8_t chan, uint16_t value);
 
@@ -586,6 +589,9 @@ private:
         int16_t output_scaled;
     } functions[SRV_Channel::k_nr_aux_servo_functions];
 
+    // take the next channel assigned to a function from a cached channel mask
+    static SRV_Channel *next_function_channel(SRV_Channel::Aux_servo_function_t function, SRV_Channel::servo_mask_t &mask);
+
     AP_Int8 auto_trim;
     AP_Int16 default_rate;
     AP_Int8 dshot_rate;
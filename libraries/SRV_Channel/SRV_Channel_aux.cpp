@@ -276,10 +276,29 @@ void SRV_Channels::set_output_pwm(SRV_Channel::Aux_servo_function_t function, ui
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            channels[i].set_output_pwm(value);
-            channels[i].output_ch();
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        c->set_output_pwm(value);
+        c->output_ch();
+    }
+}
+
+/*
+  set radio_out for a set of motors in one call
+ */
+void SRV_Channels::set_output_pwm_motors(const uint16_t *pwm, uint32_t motor_mask)
+{
+    while (motor_mask) {
+        const uint8_t motor = __builtin_ctz(motor_mask);
+        motor_mask &= motor_mask - 1;
+        const SRV_Channel::Aux_servo_function_t function = get_motor_function(motor);
+        if (!function_assigned(function)) {
+            continue;
+        }
+        SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+        while (SRV_Channel *c = next_function_channel(function, mask)) {
+            c->set_output_pwm(pwm[motor]);
+            c->output_ch();
         }
     }
 }
@@ -295,17 +314,16 @@ SRV_Channels::set_output_pwm_trimmed(SRV_Channel::Aux_servo_function_t function,
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            int16_t value2;
-            if (channels[i].get_reversed()) {
-                value2 = 1500 - value + channels[i].get_trim();
-            } else {
-                value2 = value - 1500 + channels[i].get_trim();
-            }
-            channels[i].set_output_pwm(constrain_int16(value2,channels[i].get_output_min(),channels[i].get_output_max()));
-            channels[i].output_ch();
-          }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        int16_t value2;
+        if (c->get_reversed()) {
+            value2 = 1500 - value + c->get_trim();
+        } else {
+            value2 = value - 1500 + c->get_trim();
+        }
+        c->set_output_pwm(constrain_int16(value2,c->get_output_min(),c->get_output_max()));
+        c->output_ch();
     }
 }
 
@@ -335,16 +353,15 @@ SRV_Channels::copy_radio_in_out(SRV_Channel::Aux_servo_function_t function, bool
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function.get() == function) {
-            RC_Channel *c = rc().channel(channels[i].ch_num);
-            if (c == nullptr) {
-                continue;
-            }
-            channels[i].set_output_pwm(c->get_radio_in());
-            if (do_input_output) {
-                channels[i].output_ch();
-            }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *sc = next_function_channel(function, mask)) {
+        RC_Channel *c = rc().channel(sc->ch_num);
+        if (c == nullptr) {
+            continue;
+        }
+        sc->set_output_pwm(c->get_radio_in());
+        if (do_input_output) {
+            sc->output_ch();
         }
     }
 }
@@ -429,18 +446,16 @@ SRV_Channels::set_output_limit(SRV_Channel::Aux_servo_function_t function, SRV_C
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i = 0; i < NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function.get() == function) {
-            uint16_t pwm = c.get_limit_pwm(limit);
-            c.set_output_pwm(pwm);
-            if (c.function.get() == SRV_Channel::k_manual) {
-                RC_Channel *cin = rc().channel(c.ch_num);
-                if (cin != nullptr) {
-                    // in order for output_ch() to work for k_manual we
-                    // also have to override radio_in
-                    cin->set_radio_in(pwm);
-                }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        uint16_t pwm = c->get_limit_pwm(limit);
+        c->set_output_pwm(pwm);
+        if (c->function.get() == SRV_Channel::k_manual) {
+            RC_Channel *cin = rc().channel(c->ch_num);
+            if (cin != nullptr) {
+                // in order for output_ch() to work for k_manual we
+                // also have to override radio_in
+                cin->set_radio_in(pwm);
             }
         }
     }
@@ -519,13 +534,13 @@ bool SRV_Channels::find_channel(SRV_Channel::Aux_servo_function_t function, uint
     if (!function_assigned(function)) {
         return false;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            chan = channels[i].ch_num;
-            return true;
-        }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    const SRV_Channel *c = next_function_channel(function, mask);
+    if (c == nullptr) {
+        return false;
     }
-    return false;
+    chan = c->ch_num;
+    return true;
 }
 
 /*
@@ -573,6 +588,24 @@ uint16_t SRV_Channels::get_output_channel_mask(SRV_Channel::Aux_servo_function_t
     return 0;
 }
 
+/*
+  take the next channel assigned to a function from a cached channel
+  mask, returning nullptr when there are no more
+ */
+SRV_Channel *SRV_Channels::next_function_channel(SRV_Channel::Aux_servo_function_t function, SRV_Channel::servo_mask_t &mask)
+{
+    while (mask) {
+        const uint8_t i = __builtin_ctz(mask);
+        mask &= mask - 1;
+        // the masks are only rebuilt by update_aux_servo_function(),
+        // so skip channels that have been given another function since
+        if (i < NUM_SERVO_CHANNELS && channels[i].function.get() == function) {
+            return &channels[i];
+        }
+    }
+    return nullptr;
+}
+
 
 // set the trim for a function channel to given pwm
 void SRV_Channels::set_trim_to_pwm_for(SRV_Channel::Aux_servo_function_t function, int16_t pwm)
@@ -604,6 +637,7 @@ void SRV_Channels::set_default_function(uint8_t chan, SRV_Channel::Aux_servo_fun
         channels[chan].function.set_default((uint8_t)function);
         if (old != channels[chan].function && channels[chan].function == function) {
             function_mask.set((uint8_t)function);
+            functions[function].channel_mask |= 1U<<chan;
         }
     }
 }
@@ -664,10 +698,9 @@ bool SRV_Channels::get_output_pwm(SRV_Channel::Aux_servo_function_t function, ui
 // set output pwm to trim for the given function
 void SRV_Channels::set_output_to_trim(SRV_Channel::Aux_servo_function_t function)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        if (channels[i].function == function) {
-            channels[i].set_output_pwm(channels[i].servo_trim);
-        }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        c->set_output_pwm(c->servo_trim);
     }
 }
 
@@ -691,11 +724,9 @@ void SRV_Channels::set_output_norm(SRV_Channel::Aux_servo_function_t function, f
     if (!function_assigned(function)) {
         return;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            c.set_output_norm(value);
-        }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        c->set_output_norm(value);
     }
 }
 
@@ -709,23 +740,21 @@ void SRV_Channels::limit_slew_rate(SRV_Channel::Aux_servo_function_t function, f
         // nothing to do
         return;
     }
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            c.calc_pwm(functions[function].output_scaled);
-            uint16_t last_pwm = hal.rcout->read_last_sent(c.ch_num);
-            if (last_pwm == c.get_output_pwm()) {
-                continue;
-            }
-            uint16_t max_change = (c.get_output_max() - c.get_output_min()) * slew_rate * dt * 0.01f;
-            if (max_change == 0 || dt > 1) {
-                // always allow some change. If dt > 1 then assume we
-                // are just starting out, and only allow a small
-                // change for this loop
-                max_change = 1;
-            }
-            c.set_output_pwm(constrain_int16(c.get_output_pwm(), last_pwm-max_change, last_pwm+max_change));
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        c->calc_pwm(functions[function].output_scaled);
+        uint16_t last_pwm = hal.rcout->read_last_sent(c->ch_num);
+        if (last_pwm == c->get_output_pwm()) {
+            continue;
         }
+        uint16_t max_change = (c->get_output_max() - c->get_output_min()) * slew_rate * dt * 0.01f;
+        if (max_change == 0 || dt > 1) {
+            // always allow some change. If dt > 1 then assume we
+            // are just starting out, and only allow a small
+            // change for this loop
+            max_change = 1;
+        }
+        c->set_output_pwm(constrain_int16(c->get_output_pwm(), last_pwm-max_change, last_pwm+max_change));
     }
 }
 
@@ -763,11 +792,9 @@ void SRV_Channels::set_output_min_max(SRV_Channel::Aux_servo_function_t function
 // constrain to output min/max for function
 void SRV_Channels::constrain_pwm(SRV_Channel::Aux_servo_function_t function)
 {
-    for (uint8_t i=0; i<NUM_SERVO_CHANNELS; i++) {
-        SRV_Channel &c = channels[i];
-        if (c.function == function) {
-            c.set_output_pwm(constrain_int16(c.output_pwm, c.servo_min, c.servo_max));
-        }
+    SRV_Channel::servo_mask_t mask = get_output_channel_mask(function);
+    while (SRV_Channel *c = next_function_channel(function, mask)) {
+        c->set_output_pwm(constrain_int16(c->output_pwm, c->servo_min, c->servo_max));
     }
 }
 
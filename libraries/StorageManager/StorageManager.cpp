@@ -146,11 +146,16 @@ void StorageManager::erase(void)
 StorageAccess::StorageAccess(StorageManager::StorageType _type) : 
     type(_type) 
 {
-    // calculate available bytes
+    // calculate available bytes, and find where our areas start so
+    // block access doesn't have to skip over the areas before them
     total_size = 0;
+    first_area = STORAGE_NUM_AREAS;
     for (uint8_t i=0; i<STORAGE_NUM_AREAS; i++) {
         const StorageManager::StorageArea &area = StorageManager::layout[i];
         if (area.type == type) {
+            if (total_size == 0) {
+                first_area = i;
+            }
             total_size += area.length;
         }
     }
@@ -163,7 +168,7 @@ StorageAccess::StorageAccess(StorageManager::StorageType _type) :
 bool StorageAccess::read_block(void *data, uint16_t addr, size_t n) const
 {
     uint8_t *b = (uint8_t *)data;
-    for (uint8_t i=0; i<STORAGE_NUM_AREAS; i++) {
+    for (uint8_t i=first_area; i<STORAGE_NUM_AREAS; i++) {
         const StorageManager::StorageArea &area = StorageManager::layout[i];
         uint16_t length = area.length;
         uint16_t offset = area.offset;
@@ -175,7 +180,7 @@ bool StorageAccess::read_block(void *data, uint16_t addr, size_t n) const
             addr -= length;
             continue;
         }
-        uint8_t count = n;
+        uint16_t count = MIN(n, length);
         if (count+addr > length) {
             // the data crosses a boundary between two areas
             count = length - addr;
@@ -203,7 +208,7 @@ bool StorageAccess::read_block(void *data, uint16_t addr, size_t n) const
 bool StorageAccess::write_block(uint16_t addr, const void *data, size_t n) const
 {
     const uint8_t *b = (const uint8_t *)data;
-    for (uint8_t i=0; i<STORAGE_NUM_AREAS; i++) {
+    for (uint8_t i=first_area; i<STORAGE_NUM_AREAS; i++) {
         const StorageManager::StorageArea &area = StorageManager::layout[i];
         uint16_t length = area.length;
         uint16_t offset = area.offset;
@@ -215,7 +220,7 @@ bool StorageAccess::write_block(uint16_t addr, const void *data, size_t n) const
             addr -= length;
             continue;
         }
-        uint8_t count = n;
+        uint16_t count = MIN(n, length);
         if (count+addr > length) {
             // the data crosses a boundary between two areas
             count = length - addr;
@@ -86,7 +86,9 @@ public:
     // return total size of this accessor
     uint16_t size(void) const { return total_size; }
 
-    // base access via block functions
+    // base access via block functions. A block may be of any length
+    // and may span several areas; each contiguous run is copied in
+    // one HAL call, so prefer one large block to many small ones
     bool read_block(void *dst, uint16_t src, size_t n) const;
     bool write_block(uint16_t dst, const void* src, size_t n) const;    
 
@@ -109,4 +111,5 @@ public:
 private:
     const StorageManager::StorageType type;
     uint16_t total_size;
+    uint8_t first_area;     // index in layout of our first area
 };